@@ -0,0 +1,263 @@
+/**
+ * @file acmatch.c
+ * @author Daniel Starke
+ * @see acmatch.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Aho-Corasick multi-pattern matcher. The pattern trie is built over byte
+ * equivalence classes. Every byte which does not occur in any pattern shares
+ * class 0. The failure links are resolved at compile time which turns the
+ * trie into a complete transition table. Matching therefore performs exactly
+ * one table lookup per input byte without any backtracking. The table holds
+ * the row offset of the next state to avoid a multiplication per byte. The
+ * offset is tagged with `ACM_OUTPUT` if the next state has an output.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "acmatch.h"
+
+
+/**
+ * Transition table tag of states with an output.
+ */
+#define ACM_OUTPUT UINT32_C(0x80000000)
+
+
+/**
+ * Returns the ASCII lower case variant of the given byte if enabled.
+ *
+ * @param[in] m - matcher
+ * @param[in] b - input byte
+ * @return folded byte
+ */
+static uint8_t acm_fold(const tAcMatcher * m, const uint8_t b) {
+	if (m->ignoreCase && b >= 'A' && b <= 'Z') {
+		return (uint8_t)(b - 'A' + 'a');
+	}
+	return b;
+}
+
+
+/**
+ * Drops the compiled automaton.
+ *
+ * @param[in,out] m - matcher
+ */
+static void acm_reset(tAcMatcher * m) {
+	free(m->next);
+	free(m->out);
+	m->next = NULL;
+	m->out = NULL;
+	m->states = 0;
+	m->classes = 0;
+	m->compiled = false;
+	memset(m->classMap, 0, sizeof(m->classMap));
+}
+
+
+/**
+ * Creates a new matcher without patterns.
+ *
+ * @param[in] ignoreCase - match ASCII letters case insensitive?
+ * @return created matcher or `NULL` on error
+ */
+tAcMatcher * acm_create(const bool ignoreCase) {
+	tAcMatcher * m = calloc(1, sizeof(tAcMatcher));
+	if (m == NULL) {
+		return NULL;
+	}
+	m->ignoreCase = ignoreCase;
+	return m;
+}
+
+
+/**
+ * Deletes the given matcher.
+ *
+ * @param[in,out] m - matcher to delete
+ */
+void acm_delete(tAcMatcher * m) {
+	if (m == NULL) {
+		return;
+	}
+	acm_reset(m);
+	free(m->text);
+	free(m->ends);
+	free(m->ids);
+	free(m);
+}
+
+
+/**
+ * Adds the given pattern. Multiple patterns may share the same identifier.
+ * The matcher needs to be compiled again afterwards.
+ *
+ * @param[in,out] m - matcher
+ * @param[in] pattern - pattern bytes
+ * @param[in] len - length of `pattern` in bytes (not 0)
+ * @param[in] id - pattern identifier (less than `ACM_MAX_PATTERNS`)
+ * @return `true` on success, else `false`
+ */
+bool acm_add(tAcMatcher * m, const uint8_t * pattern, const size_t len, const unsigned id) {
+	if (m == NULL || pattern == NULL || len == 0 || id >= ACM_MAX_PATTERNS || len > (ACM_MAX_LENGTH - m->textLen)) {
+		return false;
+	}
+	uint8_t * text = realloc(m->text, m->textLen + len);
+	if (text == NULL) {
+		return false;
+	}
+	m->text = text;
+	size_t * ends = realloc(m->ends, (m->patterns + 1) * sizeof(size_t));
+	if (ends == NULL) {
+		return false;
+	}
+	m->ends = ends;
+	uint8_t * ids = realloc(m->ids, m->patterns + 1);
+	if (ids == NULL) {
+		return false;
+	}
+	m->ids = ids;
+	memcpy(m->text + m->textLen, pattern, len);
+	m->textLen += len;
+	m->ends[m->patterns] = m->textLen;
+	m->ids[m->patterns] = (uint8_t)id;
+	++(m->patterns);
+	acm_reset(m);
+	return true;
+}
+
+
+/**
+ * Compiles the added patterns to a deterministic finite automaton.
+ *
+ * @param[in,out] m - matcher
+ * @return `true` on success, else `false`
+ */
+bool acm_compile(tAcMatcher * m) {
+	if (m == NULL) {
+		return false;
+	}
+	acm_reset(m);
+	uint16_t * trie = NULL;
+	uint16_t * fail = NULL;
+	uint16_t * queue = NULL;
+	/* assign equivalence classes in order of first occurrence; the 256th distinct byte keeps class 0 */
+	m->classes = 1;
+	for (size_t i = 0; i < m->textLen; ++i) {
+		const uint8_t b = acm_fold(m, m->text[i]);
+		if (m->classMap[b] == 0 && m->classes < 256) {
+			m->classMap[b] = (uint8_t)(m->classes++);
+		}
+	}
+	if ( m->ignoreCase ) {
+		for (unsigned b = 'A'; b <= 'Z'; ++b) {
+			m->classMap[b] = m->classMap[b - 'A' + 'a'];
+		}
+	}
+	/* build the trie; 0 denotes a missing edge as no edge leads back to the root */
+	const size_t maxStates = m->textLen + 1;
+	const size_t classes = m->classes;
+	trie = calloc(maxStates * classes, sizeof(uint16_t));
+	m->out = calloc(maxStates, sizeof(uint64_t));
+	fail = calloc(maxStates, sizeof(uint16_t));
+	queue = malloc(maxStates * sizeof(uint16_t));
+	if (trie == NULL || m->out == NULL || fail == NULL || queue == NULL) {
+		goto onError;
+	}
+	m->states = 1;
+	size_t start = 0;
+	for (size_t p = 0; p < m->patterns; ++p) {
+		size_t s = 0;
+		for (size_t i = start; i < m->ends[p]; ++i) {
+			uint16_t * edge = trie + (s * classes) + m->classMap[m->text[i]];
+			if (*edge == 0) {
+				*edge = (uint16_t)(m->states++);
+			}
+			s = *edge;
+		}
+		m->out[s] |= UINT64_C(1) << m->ids[p];
+		start = m->ends[p];
+	}
+	/* resolve failure links in breadth-first order to complete the transitions */
+	size_t head = 0;
+	size_t tail = 0;
+	for (size_t c = 0; c < classes; ++c) {
+		const uint16_t v = trie[c];
+		if (v != 0) {
+			fail[v] = 0;
+			queue[tail++] = v;
+		}
+	}
+	while (head < tail) {
+		const size_t u = queue[head++];
+		uint16_t * row = trie + (u * classes);
+		const uint16_t * failRow = trie + ((size_t)(fail[u]) * classes);
+		for (size_t c = 0; c < classes; ++c) {
+			const uint16_t v = row[c];
+			if (v != 0) {
+				/* trie edge: rows of shallower states are already complete */
+				fail[v] = failRow[c];
+				m->out[v] |= m->out[fail[v]];
+				queue[tail++] = v;
+			} else {
+				row[c] = failRow[c];
+			}
+		}
+	}
+	/* create the tagged row offset transition table */
+	m->next = malloc(m->states * classes * sizeof(uint32_t));
+	if (m->next == NULL) {
+		goto onError;
+	}
+	for (size_t i = 0; i < (m->states * classes); ++i) {
+		const uint16_t v = trie[i];
+		m->next[i] = (uint32_t)(v * classes) | ((m->out[v] != 0) ? ACM_OUTPUT : 0);
+	}
+	uint64_t * out = realloc(m->out, m->states * sizeof(uint64_t));
+	if (out != NULL) {
+		m->out = out;
+	}
+	free(trie);
+	free(fail);
+	free(queue);
+	m->compiled = true;
+	return true;
+onError:
+	free(trie);
+	free(fail);
+	free(queue);
+	acm_reset(m);
+	return false;
+}
+
+
+/**
+ * Feeds the given input chunk to the matcher. Patterns spanning multiple
+ * chunks are found as long as the same state variable is passed for each
+ * chunk.
+ *
+ * @param[in] m - compiled matcher
+ * @param[in,out] state - current matching state; initially `ACM_START`
+ * @param[in] data - input chunk
+ * @param[in] len - length of `data` in bytes
+ * @return identifier mask of the patterns ending within this chunk
+ */
+uint64_t acm_feed(const tAcMatcher * m, uint32_t * state, const uint8_t * data, const size_t len) {
+	if (m == NULL || ( ! m->compiled ) || state == NULL || data == NULL) {
+		return 0;
+	}
+	const uint32_t * next = m->next;
+	const uint8_t * classMap = m->classMap;
+	uint32_t s = (*state < (m->states * m->classes)) ? *state : ACM_START;
+	uint64_t res = 0;
+	for (size_t i = 0; i < len; ++i) {
+		s = next[s + classMap[data[i]]];
+		if ((s & ACM_OUTPUT) != 0) {
+			s &= ~ACM_OUTPUT;
+			res |= m->out[s / m->classes];
+		}
+	}
+	*state = s;
+	return res;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file acmatch.h
+ * @author Daniel Starke
+ * @see acmatch.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __ACMATCH_H__
+#define __ACMATCH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Maximum number of pattern identifiers. Each identifier is one bit of the
+ * match mask.
+ */
+#define ACM_MAX_PATTERNS 64
+
+
+/**
+ * Maximum total length of all patterns in bytes.
+ */
+#define ACM_MAX_LENGTH 65534
+
+
+/**
+ * Initial matching state. The state can be carried over from one call of
+ * `acm_feed()` to the next to match patterns across chunk boundaries.
+ */
+#define ACM_START 0
+
+
+/**
+ * Multi-pattern byte string matcher. The patterns are compiled to a
+ * deterministic finite automaton over byte equivalence classes.
+ */
+typedef struct {
+	bool ignoreCase; /**< match ASCII letters case insensitive? */
+	bool compiled; /**< `acm_compile()` succeeded? */
+	uint8_t classMap[256]; /**< byte to equivalence class map */
+	size_t classes; /**< number of equivalence classes */
+	size_t states; /**< number of automaton states */
+	uint32_t * next; /**< transition table with `classes` entries per state holding the tagged row offset of the next state */
+	uint64_t * out; /**< matching pattern identifier mask per state */
+	uint8_t * text; /**< concatenated added patterns */
+	size_t textLen; /**< number of bytes in `text` */
+	size_t patterns; /**< number of added patterns */
+	size_t * ends; /**< end offset of each pattern in `text` */
+	uint8_t * ids; /**< identifier of each pattern */
+} tAcMatcher;
+
+
+tAcMatcher * acm_create(const bool ignoreCase);
+void acm_delete(tAcMatcher * m);
+bool acm_add(tAcMatcher * m, const uint8_t * pattern, const size_t len, const unsigned id);
+bool acm_compile(tAcMatcher * m);
+uint64_t acm_feed(const tAcMatcher * m, uint32_t * state, const uint8_t * data, const size_t len);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __ACMATCH_H__ */
@@ -0,0 +1,1874 @@
+/**
+ * @file bench.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Native micro benchmarks for the portable container and text primitives.
+ * The results are written as CSV and can be compared against a baseline in
+ * the same format.
+ */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wchar.h>
+#include "acmatch.h"
+#include "crc32.h"
+#include "dcache.h"
+#include "fdigest.h"
+#include "fidx.h"
+#include "htableo.h"
+#include "ini.h"
+#include "sha256.h"
+#include "target.h"
+#include "trigram.h"
+#include "ustrbuf.h"
+#include "utf8.h"
+#include "vector.h"
+#include "wpool.h"
+#ifdef PCF_IS_WIN
+#include <windows.h>
+#else /* not PCF_IS_WIN */
+#include <sched.h>
+#endif /* not PCF_IS_WIN */
+
+
+/**
+ * Number of measurements per benchmark. The fastest one is reported.
+ */
+#define BENCH_REPEAT 9
+
+
+/**
+ * Minimum duration of a single measurement in nanoseconds.
+ */
+#define BENCH_MIN_TIME 20000000
+
+
+/**
+ * Default regression threshold in percent.
+ */
+#define BENCH_THRESHOLD 20.0
+
+
+/**
+ * Number of hash table buckets used for the `hto_*` benchmarks.
+ */
+#define BENCH_HT_BUCKETS 1024
+
+
+/**
+ * Size of the generated text inputs in bytes.
+ */
+#define BENCH_TEXT_SIZE 65536
+
+
+/**
+ * Number of files per directory used for the `fidx_*` benchmarks.
+ */
+#define BENCH_FIDX_DIR_FILES 100
+
+
+/**
+ * First file identifier used for the `fidx_*` benchmarks.
+ */
+#define BENCH_FIDX_FIRST_FILE 1000000
+
+
+/**
+ * File name of the digest cache used for the `dcache_*` benchmarks within the
+ * temporary directory.
+ */
+#define BENCH_DCACHE_FILE "siguwi-bench.cache"
+
+
+/**
+ * Size of the embedded signature within the `fdigest_*` benchmark inputs in
+ * bytes.
+ */
+#define BENCH_SIG_SIZE 8192
+
+
+/**
+ * Number of large and small streams within the `fdigest_msi` benchmark input.
+ */
+#define BENCH_MSI_STREAMS 16
+
+
+/**
+ * Maximum number of hashing threads of the `hash_pool` benchmark. This matches
+ * `HASH_MAX_THREADS` of the application.
+ */
+#define BENCH_POOL_THREADS 8
+
+
+/**
+ * Number of files hashed per iteration of the `hash_pool` benchmark.
+ */
+#define BENCH_POOL_JOBS 32
+
+
+/**
+ * Size of each document within the `tgi_query` benchmark index in bytes.
+ */
+#define BENCH_TGI_DOC_SIZE 4096
+
+
+/**
+ * Maximum benchmark name length including null-terminator.
+ */
+#define BENCH_MAX_NAME 64
+
+
+/**
+ * Single benchmark description.
+ */
+typedef struct tBench {
+	const char * name; /**< benchmark name */
+	size_t size; /**< problem size */
+	bool (* setup)(const struct tBench * b); /**< prepares the input or `NULL` */
+	size_t (* run)(const struct tBench * b, const size_t iterations); /**< returns the number of performed operations */
+	void (* teardown)(void); /**< releases the input or `NULL` */
+} tBench;
+
+
+/**
+ * Single benchmark result.
+ */
+typedef struct {
+	char name[BENCH_MAX_NAME]; /**< benchmark name with problem size */
+	size_t ops; /**< number of operations in the fastest measurement */
+	double nsPerOp; /**< nanoseconds per operation of the fastest measurement */
+} tBenchResult;
+
+
+/**
+ * Single file hashing job of the `hash_pool` benchmark.
+ */
+typedef struct {
+	tWorkItem item; /**< worker pool item (first member) */
+	uint8_t digest[SHA256_SIZE]; /**< computed digest */
+	bool ok; /**< the digest was computed and the input was detected as signed */
+} tBenchPoolJob;
+
+
+/* benchmark input data */
+static tVector * benchVec = NULL;
+static uint32_t * benchKeys = NULL;
+static tHTableO * benchHt = NULL;
+static tUStrBuf * benchSb = NULL;
+static uint8_t * benchText = NULL;
+static wchar_t * benchIni = NULL;
+static wchar_t * benchIniCopy = NULL;
+static size_t benchIniLen = 0;
+static tToken benchTokens[8];
+static tFileIdx * benchIdx = NULL;
+static uint8_t * benchIdxData = NULL;
+static size_t benchIdxLen = 0;
+static tDigestCache * benchCache = NULL;
+static tDigestCacheChar benchCachePath[512];
+static uint8_t * benchFile = NULL;
+static size_t benchFileLen = 0;
+static tFileDigestFormat benchFileFormat = FDF_RAW;
+static tAcMatcher * benchMatcher = NULL;
+static tTrigramIdx * benchTgi = NULL;
+static tWorkPool * benchPool = NULL;
+static tBenchPoolJob benchPoolJobs[BENCH_POOL_JOBS];
+
+/** Prevents that the compiler removes the measured code. */
+static volatile uint64_t benchSink = 0;
+
+
+/**
+ * Returns the current monotonic time.
+ *
+ * @return time in nanoseconds
+ */
+static int64_t benchNow(void) {
+#ifdef PCF_IS_WIN
+	static LARGE_INTEGER freq = {0};
+	LARGE_INTEGER count;
+	if (freq.QuadPart == 0) {
+		QueryPerformanceFrequency(&freq);
+	}
+	QueryPerformanceCounter(&count);
+	return (int64_t)((double)(count.QuadPart) * 1e9 / (double)(freq.QuadPart));
+#else /* not PCF_IS_WIN */
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((int64_t)(ts.tv_sec) * INT64_C(1000000000)) + (int64_t)(ts.tv_nsec);
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Gives up the remaining time slice of the calling thread.
+ */
+static void benchYield(void) {
+#ifdef PCF_IS_WIN
+	SwitchToThread();
+#else /* not PCF_IS_WIN */
+	sched_yield();
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Returns the next value of a deterministic pseudo random number sequence.
+ *
+ * @param[in,out] state - generator state (not 0)
+ * @return next pseudo random number
+ */
+static uint32_t benchRand(uint32_t * state) {
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+
+static void benchWr16(uint8_t * p, const uint16_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+}
+
+
+static void benchWr32(uint8_t * p, const uint32_t v) {
+	benchWr16(p, (uint16_t)v);
+	benchWr16(p + 2, (uint16_t)(v >> 16));
+}
+
+
+/**
+ * Compares two `uint32_t` values. This is compatible with `VectorCompareFunction`.
+ *
+ * @param[in] lhs - left-hand sided value
+ * @param[in] rhs - right-hand sided value
+ * @param[in] options - 1 for ascending, -1 for descending order
+ * @return comparison result
+ */
+static int benchCmpU32(const void * lhs, const void * rhs, const int options) {
+	const uint32_t l = *(const uint32_t *)lhs;
+	const uint32_t r = *(const uint32_t *)rhs;
+	if (l == r) {
+		return 0;
+	}
+	return (l > r) ? options : -options;
+}
+
+
+/**
+ * Clones a `uint32_t` key. This is compatible with `HashFunctionCloneO`.
+ *
+ * @param[in] key - key to clone
+ * @return cloned key or `NULL` on allocation error
+ */
+static void * benchKeyClone(const void * key) {
+	uint32_t * res = malloc(sizeof(uint32_t));
+	if (res != NULL) {
+		*res = *(const uint32_t *)key;
+	}
+	return res;
+}
+
+
+/**
+ * Deletes a `uint32_t` key. This is compatible with `HashFunctionDelO`.
+ *
+ * @param[in] key - key to delete
+ */
+static void benchKeyDelete(const void * key) {
+	free((void *)key);
+}
+
+
+/**
+ * Compares two `uint32_t` keys. This is compatible with `HashFunctionCmpO`.
+ *
+ * @param[in] lhs - left-hand sided key
+ * @param[in] rhs - right-hand sided key
+ * @return 0 if equal, else not 0
+ */
+static int benchKeyCmp(const void * lhs, const void * rhs) {
+	return benchCmpU32(lhs, rhs, 1);
+}
+
+
+/**
+ * Hashes a `uint32_t` key. This is compatible with `HashFunctionHashO`.
+ *
+ * @param[in] key - key to hash
+ * @param[in] limit - hash table size
+ * @return hash value
+ */
+static size_t benchKeyHash(const void * key, const size_t limit) {
+	return (size_t)((*(const uint32_t *)key * UINT32_C(2654435761)) % limit);
+}
+
+
+/**
+ * Sums up the hash table values. This is compatible with `HashVisitorO`.
+ *
+ * @param[in] key - element key
+ * @param[in] data - element value
+ * @param[in,out] param - `uint64_t` sum
+ * @return 1 to continue
+ */
+static int benchKeySum(const void * key, void * data, void * param) {
+	PCF_UNUSED(key);
+	*(uint64_t *)param += *(const uint32_t *)data;
+	return 1;
+}
+
+
+/**
+ * Counts the visited key/value pairs. This is compatible with `IniVisitor`.
+ *
+ * @param[in] group - group name
+ * @param[in] key - key name
+ * @param[in] value - value
+ * @param[in,out] param - `uint64_t` counter
+ * @return `true` to continue
+ */
+static bool benchIniVisit(const tToken * group, const tToken * key, wchar_t * value, void * param) {
+	if (cmpToken(group, L"sign7") == 0 && cmpToken(key, L"signApp") == 0) {
+		*(uint64_t *)param += (uint64_t)(*value);
+	}
+	++(*(uint64_t *)param);
+	return true;
+}
+
+
+/** Releases all benchmark input data. */
+static void benchFree(void) {
+	if (benchVec != NULL) {
+		vec_delete(benchVec);
+		benchVec = NULL;
+	}
+	free(benchKeys);
+	benchKeys = NULL;
+	if (benchHt != NULL) {
+		hto_delete(benchHt);
+		benchHt = NULL;
+	}
+	if (benchSb != NULL) {
+		usb_delete(benchSb);
+		benchSb = NULL;
+	}
+	free(benchText);
+	benchText = NULL;
+	free(benchIni);
+	benchIni = NULL;
+	free(benchIniCopy);
+	benchIniCopy = NULL;
+	benchIniLen = 0;
+	fidx_delete(benchIdx);
+	benchIdx = NULL;
+	free(benchIdxData);
+	benchIdxData = NULL;
+	benchIdxLen = 0;
+	if (benchCache != NULL) {
+		dcache_close(benchCache);
+		benchCache = NULL;
+#ifdef PCF_IS_WIN
+		_wremove(benchCachePath);
+#else /* not PCF_IS_WIN */
+		remove(benchCachePath);
+#endif /* not PCF_IS_WIN */
+	}
+	free(benchFile);
+	benchFile = NULL;
+	benchFileLen = 0;
+	acm_delete(benchMatcher);
+	benchMatcher = NULL;
+	tgi_delete(benchTgi);
+	benchTgi = NULL;
+	wpool_delete(benchPool);
+	benchPool = NULL;
+}
+
+
+/**
+ * Creates a vector with `b->size` pseudo random values and a copy of these.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchVecSetup(const tBench * b) {
+	uint32_t state = 0x12345678;
+	benchVec = vec_create(sizeof(uint32_t));
+	benchKeys = malloc(b->size * sizeof(uint32_t));
+	if (benchVec == NULL || benchKeys == NULL || vec_resize(benchVec, b->size) == 0) {
+		return false;
+	}
+	for (size_t i = 0; i < b->size; ++i) {
+		benchKeys[i] = benchRand(&state);
+		*(uint32_t *)vec_at(benchVec, i) = benchKeys[i];
+	}
+	return true;
+}
+
+
+/**
+ * Creates a hash table with `b->size` elements.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchHtSetup(const tBench * b) {
+	benchHt = hto_create(sizeof(uint32_t), BENCH_HT_BUCKETS, benchKeyClone, benchKeyDelete, benchKeyCmp, benchKeyHash);
+	if (benchHt == NULL) {
+		return false;
+	}
+	for (uint32_t i = 0; i < (uint32_t)(b->size); ++i) {
+		uint32_t * value = hto_addKey(benchHt, &i);
+		if (value == NULL) {
+			return false;
+		}
+		*value = i;
+	}
+	return true;
+}
+
+
+/**
+ * Creates a string buffer with `b->size` characters.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchSbSetup(const tBench * b) {
+	benchSb = usb_create(1024);
+	if (benchSb == NULL) {
+		return false;
+	}
+	for (size_t i = 0; i < b->size; ++i) {
+		if (usb_addC(benchSb, (wchar_t)(L'a' + (i % 26))) == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Creates `BENCH_TEXT_SIZE` bytes of UTF-8 encoded text with mostly ASCII and
+ * some 2, 3 and 4 byte sequences.
+ *
+ * @param[in] b - benchmark (unused)
+ * @return `true` on success, else `false`
+ */
+static bool benchTextSetup(const tBench * b) {
+	static const char * const samples[] = {"Signing ", "file.exe", " ok\r\n", "\xC3\xA4\xC3\xB6\xC3\xBC", "\xE2\x82\xAC", "\xF0\x9F\x94\x91", "0x80092009 ", "SignTool Error: "};
+	PCF_UNUSED(b);
+	uint32_t state = 0x9E3779B9;
+	benchText = malloc(BENCH_TEXT_SIZE);
+	if (benchText == NULL) {
+		return false;
+	}
+	size_t len = 0;
+	while (len < BENCH_TEXT_SIZE) {
+		const char * s = samples[benchRand(&state) % (sizeof(samples) / sizeof(*samples))];
+		const size_t n = strlen(s);
+		if ((len + n) > BENCH_TEXT_SIZE) {
+			memset(benchText + len, ' ', BENCH_TEXT_SIZE - len);
+			break;
+		}
+		memcpy(benchText + len, s, n);
+		len += n;
+	}
+	return true;
+}
+
+
+/**
+ * Creates the signing application output text and a matcher with `b->size`
+ * output rule patterns. Only the first few patterns occur in the text.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchAcmSetup(const tBench * b) {
+	static const char * const patterns[] = {"signtool error", "0x80092009", "timestamp failed", "PIN incorrect", "already signed", "The specified PIN is incorrect", "No certificates were found"};
+	char pattern[48];
+	if ( ! benchTextSetup(b) ) {
+		return false;
+	}
+	benchMatcher = acm_create(true);
+	if (benchMatcher == NULL) {
+		return false;
+	}
+	for (size_t i = 0; i < b->size; ++i) {
+		if (i < (sizeof(patterns) / sizeof(*patterns))) {
+			snprintf(pattern, sizeof(pattern), "%s", patterns[i]);
+		} else {
+			snprintf(pattern, sizeof(pattern), "error %zu occurred", i);
+		}
+		if ( ! acm_add(benchMatcher, (const uint8_t *)pattern, strlen(pattern), (unsigned)(i % ACM_MAX_PATTERNS)) ) {
+			return false;
+		}
+	}
+	return acm_compile(benchMatcher);
+}
+
+
+/**
+ * Creates the signing application output text and a trigram index with
+ * `b->size` overlapping documents taken from it.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchTgiSetup(const tBench * b) {
+	if ( ! benchTextSetup(b) ) {
+		return false;
+	}
+	benchTgi = tgi_create();
+	if (benchTgi == NULL) {
+		return false;
+	}
+	for (size_t i = 0; i < b->size; ++i) {
+		uint32_t state = TGI_START;
+		const size_t offset = (i * 797) % (BENCH_TEXT_SIZE - BENCH_TGI_DOC_SIZE);
+		if ( ! tgi_add(benchTgi, (uint32_t)i, &state, benchText + offset, BENCH_TGI_DOC_SIZE) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Creates an INI file content with `b->size` groups.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchIniSetup(const tBench * b) {
+	benchSb = usb_create(4096);
+	if (benchSb == NULL || usb_add(benchSb, L"; generated configuration\r\n") == 0) {
+		return false;
+	}
+	for (size_t i = 0; i < b->size; ++i) {
+		const int ok = usb_addFmt(benchSb,
+			L"\r\n[sign%u]\r\n"
+			L"# smart card %u\r\n"
+			L"certId = 'c%08X-2a4b-4c6d-8e0f-%012u'\r\n"
+			L"cardName = \"Identity Device (NIST SP 800-73 [PIV])\"\r\n"
+			L"cardReader = Reader %u\r\n"
+			L"signApp = '\"C:\\Program Files (x86)\\Windows Kits\\10\\bin\\x64\\signtool.exe\" sign /fd sha256 /a \"$1\"'\r\n"
+			L"unused%u=value %u   \r\n",
+			(unsigned)i, (unsigned)i, (unsigned)i, (unsigned)i, (unsigned)i, (unsigned)i, (unsigned)i
+		);
+		if (ok == 0) {
+			return false;
+		}
+	}
+	benchIniLen = usb_len(benchSb);
+	benchIni = usb_get(benchSb);
+	benchIniCopy = malloc(benchIniLen * sizeof(wchar_t));
+	usb_delete(benchSb);
+	benchSb = NULL;
+	return benchIni != NULL && benchIniCopy != NULL;
+}
+
+
+/**
+ * Prepares tokens for `cmpToken()` from key names.
+ *
+ * @param[in] b - benchmark (unused)
+ * @return `true` on success, else `false`
+ */
+static bool benchTokenSetup(const tBench * b) {
+	static wchar_t text[] = L"certIdcardNamecardReadersignAppcertIdXsignApcardNamesection";
+	static const size_t lens[] = {6, 8, 10, 7, 7, 6, 8, 7};
+	PCF_UNUSED(b);
+	wchar_t * ptr = text;
+	for (size_t i = 0; i < (sizeof(lens) / sizeof(*lens)); ++i) {
+		benchTokens[i] = (tToken){ptr, lens[i]};
+		ptr += lens[i];
+	}
+	return true;
+}
+
+
+/**
+ * Creates a file identity index with `b->size` signed files in directories of
+ * `BENCH_FIDX_DIR_FILES` files each and its serialized form.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchFidxSetup(const tBench * b) {
+	wchar_t name[32];
+	benchIdx = fidx_create();
+	if (benchIdx == NULL) {
+		return false;
+	}
+	benchIdx->root = 1;
+	const size_t dirs = (b->size / BENCH_FIDX_DIR_FILES) + 1;
+	for (size_t i = 0; i < dirs; ++i) {
+		const int len = swprintf(name, sizeof(name) / sizeof(*name), L"dir%zu", i);
+		if (len <= 0 || fidx_put(benchIdx, (uint64_t)(i + 2), 1, name, (size_t)len, FIDX_DIR) == NULL) {
+			return false;
+		}
+	}
+	for (size_t i = 0; i < b->size; ++i) {
+		const int len = swprintf(name, sizeof(name) / sizeof(*name), L"file%zu.exe", i);
+		tFileIdxEntry * e = (len > 0) ? fidx_put(benchIdx, (uint64_t)(BENCH_FIDX_FIRST_FILE + i), (uint64_t)((i / BENCH_FIDX_DIR_FILES) + 2), name, (size_t)len, FIDX_SIGNED) : NULL;
+		if (e == NULL) {
+			return false;
+		}
+		e->size = (uint64_t)i * 4096;
+		e->time = UINT64_C(134000000000000000) + (uint64_t)i;
+	}
+	benchIdxData = fidx_save(benchIdx, &benchIdxLen);
+	return benchIdxData != NULL;
+}
+
+
+/**
+ * Returns the digest cache key of the given benchmark file.
+ *
+ * @param[in] i - file number
+ * @param[in] mtime - last modification time
+ * @return digest cache key
+ */
+static tDigestKey benchDcacheKey(const size_t i, const uint64_t mtime) {
+	tDigestKey key;
+	memset(&key, 0, sizeof(key));
+	key.volume = 0x1234ABCD;
+	key.id = (uint64_t)(BENCH_FIDX_FIRST_FILE + i);
+	key.size = (uint64_t)i * 4096;
+	key.mtime = mtime;
+	key.ctime = mtime;
+	key.algo = 1;
+	return key;
+}
+
+
+/**
+ * Creates a new digest cache file in the temporary directory with the digests
+ * of `b->size` files.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchDcacheSetup(const tBench * b) {
+	uint8_t digest[SHA256_SIZE];
+#ifdef PCF_IS_WIN
+	wchar_t dir[MAX_PATH + 1];
+	const DWORD len = GetTempPathW(MAX_PATH + 1, dir);
+	if (len == 0 || len > MAX_PATH) {
+		return false;
+	}
+	swprintf(benchCachePath, sizeof(benchCachePath) / sizeof(*benchCachePath), L"%ls%ls", dir, L"" BENCH_DCACHE_FILE);
+	_wremove(benchCachePath);
+#else /* not PCF_IS_WIN */
+	const char * dir = getenv("TMPDIR");
+	snprintf(benchCachePath, sizeof(benchCachePath), "%s/%s", (dir != NULL && *dir != 0) ? dir : "/tmp", BENCH_DCACHE_FILE);
+	remove(benchCachePath);
+#endif /* not PCF_IS_WIN */
+	benchCache = dcache_open(benchCachePath);
+	if (benchCache == NULL) {
+		return false;
+	}
+	for (size_t i = 0; i < b->size; ++i) {
+		const tDigestKey key = benchDcacheKey(i, UINT64_C(134000000000000000) + (uint64_t)i);
+		memset(digest, (int)(i & 0xFF), sizeof(digest));
+		if ( ! dcache_put(benchCache, &key, digest, sizeof(digest)) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Allocates the `fdigest_*` benchmark input with pseudo random content.
+ *
+ * @param[in] len - input size in bytes
+ * @param[in] format - file format of the input
+ * @return `true` on success, else `false`
+ */
+static bool benchFileAlloc(const size_t len, const tFileDigestFormat format) {
+	uint32_t state = 0x2545F491;
+	benchFile = malloc(len);
+	if (benchFile == NULL) {
+		return false;
+	}
+	for (size_t i = 0; i < len; ++i) {
+		benchFile[i] = (uint8_t)benchRand(&state);
+	}
+	benchFileLen = len;
+	benchFileFormat = format;
+	return true;
+}
+
+
+/**
+ * Creates a signed PE32+ image with `b->size` bytes of image data.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchPeSetup(const tBench * b) {
+	if ( ! benchFileAlloc(b->size + BENCH_SIG_SIZE, FDF_PE) ) {
+		return false;
+	}
+	memset(benchFile, 0, 0x200);
+	benchFile[0] = 'M';
+	benchFile[1] = 'Z';
+	benchWr32(benchFile + 0x3C, 0x80);
+	memcpy(benchFile + 0x80, "PE\0\0", 4);
+	benchWr16(benchFile + 0x80 + 20, 240); /* optional header size */
+	benchWr16(benchFile + 0x98, 0x20B); /* PE32+ */
+	benchWr32(benchFile + 0x98 + 108, 16); /* number of data directories */
+	benchWr32(benchFile + 0x98 + 112 + 32, (uint32_t)(b->size)); /* certificate table */
+	benchWr32(benchFile + 0x98 + 112 + 36, BENCH_SIG_SIZE);
+	return true;
+}
+
+
+/**
+ * Creates a signed MSI package (OLE compound document version 3) whose
+ * streams have `b->size` bytes in total. Half of the streams are stored in the
+ * mini stream. The directory entries are not sorted by name.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchMsiSetup(const tBench * b) {
+	static const uint8_t magic[8] = {0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1};
+	const size_t smallLen = 100;
+	const size_t smallSecs = (smallLen + 63) / 64; /* mini sectors per small stream */
+	const size_t largeLen = (b->size - (BENCH_MSI_STREAMS * smallLen)) / BENCH_MSI_STREAMS;
+	const size_t largeSecs = (largeLen + 511) / 512;
+	const size_t sigSecs = BENCH_SIG_SIZE / 512;
+	const size_t miniSecs = (BENCH_MSI_STREAMS * smallSecs * 64 + 511) / 512;
+	const size_t miniFatSecs = (BENCH_MSI_STREAMS * smallSecs * 4 + 511) / 512;
+	const size_t entries = (2 * BENCH_MSI_STREAMS) + 2;
+	const size_t dirSecs = (entries + 3) / 4;
+	const size_t dataSecs = (BENCH_MSI_STREAMS * largeSecs) + sigSecs + miniSecs + miniFatSecs + dirSecs;
+	size_t fatSecs = 1;
+	while ((dataSecs + fatSecs) > (fatSecs * 128)) {
+		++fatSecs;
+	}
+	if (largeLen < 4096 || fatSecs > 109 || ( ! benchFileAlloc(512 * (1 + dataSecs + fatSecs), FDF_MSI) )) {
+		return false;
+	}
+	/* header */
+	memset(benchFile, 0, 512);
+	memcpy(benchFile, magic, sizeof(magic));
+	benchWr16(benchFile + 0x18, 0x3E);
+	benchWr16(benchFile + 0x1A, 3);
+	benchWr16(benchFile + 0x1C, 0xFFFE);
+	benchWr16(benchFile + 0x1E, 9);
+	benchWr16(benchFile + 0x20, 6);
+	benchWr32(benchFile + 0x2C, (uint32_t)fatSecs);
+	benchWr32(benchFile + 0x38, 4096);
+	benchWr32(benchFile + 0x40, (uint32_t)miniFatSecs);
+	benchWr32(benchFile + 0x44, 0xFFFFFFFE);
+	memset(benchFile + 0x4C, 0xFF, 512 - 0x4C);
+	/* sectors are allocated in consecutive chains */
+	uint8_t * fat = benchFile + (512 * (1 + dataSecs));
+	memset(fat, 0xFF, 512 * fatSecs);
+	uint32_t next = 0;
+	uint32_t starts[BENCH_MSI_STREAMS + 4];
+	const size_t counts[BENCH_MSI_STREAMS + 4] = {
+		[BENCH_MSI_STREAMS] = sigSecs,
+		[BENCH_MSI_STREAMS + 1] = miniSecs,
+		[BENCH_MSI_STREAMS + 2] = miniFatSecs,
+		[BENCH_MSI_STREAMS + 3] = dirSecs
+	};
+	for (size_t i = 0; i < (BENCH_MSI_STREAMS + 4); ++i) {
+		const size_t count = (i < BENCH_MSI_STREAMS) ? largeSecs : counts[i];
+		starts[i] = next;
+		for (size_t j = 0; j < count; ++j, ++next) {
+			benchWr32(fat + (4 * next), ((j + 1) < count) ? (next + 1) : 0xFFFFFFFE);
+		}
+	}
+	for (size_t i = 0; i < fatSecs; ++i, ++next) {
+		benchWr32(benchFile + 0x4C + (4 * i), next);
+		benchWr32(fat + (4 * next), 0xFFFFFFFD);
+	}
+	benchWr32(benchFile + 0x30, starts[BENCH_MSI_STREAMS + 3]);
+	benchWr32(benchFile + 0x3C, starts[BENCH_MSI_STREAMS + 2]);
+	/* mini FAT */
+	uint8_t * miniFat = benchFile + (512 * (1 + starts[BENCH_MSI_STREAMS + 2]));
+	memset(miniFat, 0xFF, 512 * miniFatSecs);
+	for (size_t m = 0; m < (BENCH_MSI_STREAMS * smallSecs); ++m) {
+		benchWr32(miniFat + (4 * m), (((m + 1) % smallSecs) != 0) ? (uint32_t)(m + 1) : 0xFFFFFFFE);
+	}
+	/* directory with a degenerated tree of right siblings */
+	uint8_t * dir = benchFile + (512 * (1 + starts[BENCH_MSI_STREAMS + 3]));
+	memset(dir, 0, 512 * dirSecs);
+	for (size_t i = 0; i < entries; ++i) {
+		uint8_t * e = dir + (128 * i);
+		char name[32];
+		if (i == 0) {
+			snprintf(name, sizeof(name), "Root Entry");
+		} else if (i == 1) {
+			snprintf(name, sizeof(name), "\005DigitalSignature");
+		} else if (i < (BENCH_MSI_STREAMS + 2)) {
+			snprintf(name, sizeof(name), "Data%02u", (unsigned)(BENCH_MSI_STREAMS + 1 - i));
+		} else {
+			snprintf(name, sizeof(name), "Meta%02u", (unsigned)(entries - i));
+		}
+		const size_t nameLen = strlen(name);
+		for (size_t j = 0; j < nameLen; ++j) {
+			benchWr16(e + (2 * j), (uint16_t)name[j]);
+		}
+		benchWr16(e + 0x40, (uint16_t)(2 * (nameLen + 1)));
+		benchWr32(e + 0x44, 0xFFFFFFFF);
+		benchWr32(e + 0x48, (i > 0 && (i + 1) < entries) ? (uint32_t)(i + 1) : 0xFFFFFFFF);
+		benchWr32(e + 0x4C, (i == 0) ? 1 : 0xFFFFFFFF);
+		if (i == 0) {
+			e[0x42] = 5;
+			benchWr32(e + 0x74, starts[BENCH_MSI_STREAMS + 1]);
+			benchWr32(e + 0x78, (uint32_t)(BENCH_MSI_STREAMS * smallSecs * 64));
+		} else if (i == 1) {
+			e[0x42] = 2;
+			benchWr32(e + 0x74, starts[BENCH_MSI_STREAMS]);
+			benchWr32(e + 0x78, BENCH_SIG_SIZE);
+		} else if (i < (BENCH_MSI_STREAMS + 2)) {
+			e[0x42] = 2;
+			benchWr32(e + 0x74, starts[i - 2]);
+			benchWr32(e + 0x78, (uint32_t)largeLen);
+		} else {
+			e[0x42] = 2;
+			benchWr32(e + 0x74, (uint32_t)((i - BENCH_MSI_STREAMS - 2) * smallSecs));
+			benchWr32(e + 0x78, (uint32_t)smallLen);
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Creates a signed cabinet with `b->size` bytes of cabinet data.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchCabSetup(const tBench * b) {
+	if ( ! benchFileAlloc(b->size + BENCH_SIG_SIZE, FDF_CAB) ) {
+		return false;
+	}
+	memset(benchFile, 0, 60);
+	memcpy(benchFile, "MSCF", 4);
+	benchWr32(benchFile + 8, (uint32_t)(b->size));
+	benchWr32(benchFile + 16, 60); /* first file entry */
+	benchFile[24] = 3;
+	benchFile[25] = 1;
+	benchWr16(benchFile + 26, 1); /* folders */
+	benchWr16(benchFile + 28, 1); /* files */
+	benchWr16(benchFile + 30, 0x0004); /* reserve present */
+	benchWr16(benchFile + 36, 20);
+	benchWr32(benchFile + 40, 0x00100000);
+	benchWr32(benchFile + 44, (uint32_t)(b->size));
+	benchWr32(benchFile + 48, BENCH_SIG_SIZE);
+	return true;
+}
+
+
+/**
+ * Creates a signed UTF-8 PowerShell script with `b->size` bytes of script text.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchPs1Setup(const tBench * b) {
+	static const char begin[] = "\r\n# SIG # Begin signature block\r\n";
+	static const char end[] = "# SIG # End signature block\r\n";
+	static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	if ( ! benchFileAlloc(b->size + BENCH_SIG_SIZE, FDF_PS1) ) {
+		return false;
+	}
+	size_t len = 0;
+	for (unsigned i = 0; len < b->size; ++i) {
+		char line[80];
+		const int n = snprintf(line, sizeof(line), "Write-Output 'Datei %u signiert \xC3\xA4\xC3\xB6\xC3\xBC \xE2\x82\xAC'\r\n", i);
+		const size_t count = ((size_t)n < (b->size - len)) ? (size_t)n : (b->size - len);
+		memcpy(benchFile + len, line, count);
+		len += count;
+	}
+	memcpy(benchFile + len, begin, sizeof(begin) - 1);
+	len += sizeof(begin) - 1;
+	/* base64 encoded signature lines */
+	const size_t sigEnd = benchFileLen - (sizeof(end) - 1) - 2;
+	for (size_t col = 0; len < sigEnd; ++len, ++col) {
+		if (col == 0) {
+			benchFile[len] = '#';
+		} else if (col == 1) {
+			benchFile[len] = ' ';
+		} else if (col == 66 && (len + 1) < sigEnd) {
+			memcpy(benchFile + len, "\r\n", 2);
+			++len;
+			col = (size_t)-1;
+		} else {
+			benchFile[len] = (uint8_t)base64[benchFile[len] & 63];
+		}
+	}
+	memcpy(benchFile + len, "\r\n", 2);
+	memcpy(benchFile + len + 2, end, sizeof(end) - 1);
+	return true;
+}
+
+
+/**
+ * Hashes the input file for a single `hash_pool` benchmark job. This is called
+ * by the worker threads.
+ *
+ * @param[in,out] item - benchmark job
+ * @param[in,out] param - unused
+ */
+static void benchPoolRun(tWorkItem * item, void * param) {
+	PCF_UNUSED(param);
+	tBenchPoolJob * job = (tBenchPoolJob *)item;
+	unsigned flags = 0;
+	job->ok = fdigest_compute(benchFileFormat, benchFile, benchFileLen, job->digest, &flags) && (flags & FDIGEST_SIGNED) != 0;
+}
+
+
+/**
+ * Creates a signed PE32+ image with `b->size` bytes of image data and starts
+ * the worker threads of the `hash_pool` benchmark.
+ *
+ * @param[in] b - benchmark
+ * @return `true` on success, else `false`
+ */
+static bool benchPoolSetup(const tBench * b) {
+	if ( ! benchPeSetup(b) ) {
+		return false;
+	}
+	benchPool = wpool_create(BENCH_POOL_THREADS, benchPoolRun, NULL, NULL);
+	return benchPool != NULL;
+}
+
+/**
+ * Measures `vec_pushBack()` into a new vector. One operation is one element.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchVecPushBack(const tBench * b, const size_t iterations) {
+	for (size_t it = 0; it < iterations; ++it) {
+		tVector * v = vec_create(sizeof(uint32_t));
+		if (v == NULL) {
+			return 0;
+		}
+		for (size_t i = 0; i < b->size; ++i) {
+			uint32_t * value = vec_pushBack(v);
+			if (value == NULL) {
+				vec_delete(v);
+				return 0;
+			}
+			*value = (uint32_t)i;
+		}
+		benchSink += vec_size(v);
+		vec_delete(v);
+	}
+	return iterations * b->size;
+}
+
+
+/**
+ * Measures `vec_at()` with pseudo random indices.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchVecAt(const tBench * b, const size_t iterations) {
+	uint64_t sum = 0;
+	uint32_t state = 0xCAFEBABE;
+	for (size_t it = 0; it < iterations; ++it) {
+		sum += *(const uint32_t *)vec_at(benchVec, benchRand(&state) % b->size);
+	}
+	benchSink += sum;
+	return iterations;
+}
+
+
+/**
+ * Measures `vec_erase()` in the middle of the vector followed by
+ * `vec_pushBack()` to keep its size.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchVecErase(const tBench * b, const size_t iterations) {
+	for (size_t it = 0; it < iterations; ++it) {
+		/* erase in the middle and re-add at the end to keep the size */
+		vec_erase(benchVec, b->size / 2, 1);
+		uint32_t * value = vec_pushBack(benchVec);
+		if (value == NULL) {
+			return 0;
+		}
+		*value = (uint32_t)it;
+	}
+	benchSink += vec_size(benchVec);
+	return iterations;
+}
+
+
+/**
+ * Measures `vec_mergeSort()` of pseudo random values. One operation is one
+ * element.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchVecMergeSort(const tBench * b, const size_t iterations) {
+	for (size_t it = 0; it < iterations; ++it) {
+		memcpy(vec_at(benchVec, 0), benchKeys, b->size * sizeof(uint32_t));
+		if (vec_mergeSort(benchVec, benchCmpU32, 1) == 0) {
+			return 0;
+		}
+	}
+	benchSink += *(const uint32_t *)vec_at(benchVec, 0);
+	return iterations * b->size;
+}
+
+
+/**
+ * Measures `hto_addKey()` into an empty hash table. One operation is one
+ * element.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchHtoAddKey(const tBench * b, const size_t iterations) {
+	for (size_t it = 0; it < iterations; ++it) {
+		for (uint32_t i = 0; i < (uint32_t)(b->size); ++i) {
+			uint32_t * value = hto_addKey(benchHt, &i);
+			if (value == NULL) {
+				return 0;
+			}
+			*value = i;
+		}
+		benchSink += hto_size(benchHt);
+		hto_clear(benchHt);
+	}
+	return iterations * b->size;
+}
+
+
+/**
+ * Measures `hto_getKey()` with pseudo random existing keys.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchHtoGetKey(const tBench * b, const size_t iterations) {
+	uint64_t sum = 0;
+	uint32_t state = 0xDEADBEEF;
+	for (size_t it = 0; it < iterations; ++it) {
+		const uint32_t key = (uint32_t)(benchRand(&state) % b->size);
+		const uint32_t * value = hto_getKey(benchHt, &key);
+		if (value != NULL) {
+			sum += *value;
+		}
+	}
+	benchSink += sum;
+	return iterations;
+}
+
+
+/**
+ * Measures `hto_delKey()` followed by `hto_addKey()` of the same key to keep
+ * the size.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchHtoDelKey(const tBench * b, const size_t iterations) {
+	uint32_t state = 0x0BADF00D;
+	for (size_t it = 0; it < iterations; ++it) {
+		/* remove and re-add to keep the size */
+		const uint32_t key = (uint32_t)(benchRand(&state) % b->size);
+		hto_delKey(benchHt, &key);
+		uint32_t * value = hto_addKey(benchHt, &key);
+		if (value == NULL) {
+			return 0;
+		}
+		*value = key;
+	}
+	benchSink += hto_size(benchHt);
+	return iterations;
+}
+
+
+/**
+ * Measures `hto_traverse()`. One operation is one element.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchHtoTraverse(const tBench * b, const size_t iterations) {
+	uint64_t sum = 0;
+	for (size_t it = 0; it < iterations; ++it) {
+		hto_traverse(benchHt, benchKeySum, &sum);
+	}
+	benchSink += sum;
+	return iterations * b->size;
+}
+
+
+/**
+ * Measures `usb_add()` with a string of `b->size` characters.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchUsbAdd(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	tUStrBuf * sb = usb_create(1024);
+	if (sb == NULL) {
+		return 0;
+	}
+	for (size_t it = 0; it < iterations; ++it) {
+		if (usb_add(sb, L"SignTool Error: No certificates ") == 0) {
+			usb_delete(sb);
+			return 0;
+		}
+	}
+	benchSink += usb_len(sb);
+	usb_delete(sb);
+	return iterations;
+}
+
+
+/**
+ * Measures `usb_addC()`.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchUsbAddC(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	tUStrBuf * sb = usb_create(1024);
+	if (sb == NULL) {
+		return 0;
+	}
+	for (size_t it = 0; it < iterations; ++it) {
+		if (usb_addC(sb, (wchar_t)(L'a' + (it & 15))) == 0) {
+			usb_delete(sb);
+			return 0;
+		}
+	}
+	benchSink += usb_len(sb);
+	usb_delete(sb);
+	return iterations;
+}
+
+
+/**
+ * Measures `usb_addFmt()` with string, integer and floating point arguments.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchUsbAddFmt(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	tUStrBuf * sb = usb_create(1024);
+	if (sb == NULL) {
+		return 0;
+	}
+	for (size_t it = 0; it < iterations; ++it) {
+		if (usb_addFmt(sb, L"%ls=%u (%.1f ms)\r\n", L"duration", (unsigned)it, 12.5) == 0) {
+			usb_delete(sb);
+			return 0;
+		}
+	}
+	benchSink += usb_len(sb);
+	usb_delete(sb);
+	return iterations;
+}
+
+
+/**
+ * Measures `usb_get()` of a string buffer with `b->size` characters.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchUsbGet(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	for (size_t it = 0; it < iterations; ++it) {
+		wchar_t * str = usb_get(benchSb);
+		if (str == NULL) {
+			return 0;
+		}
+		benchSink += (uint64_t)(*str);
+		free(str);
+	}
+	return iterations;
+}
+
+
+/**
+ * Measures `utf8_parse()`. One operation is one byte.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchUtf8Parse(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	uint64_t sum = 0;
+	for (size_t it = 0; it < iterations; ++it) {
+		tUtf8Ctx ctx = {0};
+		for (size_t i = 0; i < BENCH_TEXT_SIZE; ++i) {
+			const uint32_t cp = utf8_parse(&ctx, benchText[i]);
+			if (cp != UTF8_MORE) {
+				sum += cp;
+			}
+		}
+	}
+	benchSink += sum;
+	return iterations * BENCH_TEXT_SIZE;
+}
+
+
+/**
+ * Measures `crc32Update()`. One operation is one byte.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchCrc32Update(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	uint32_t crc = UINT32_MAX;
+	for (size_t it = 0; it < iterations; ++it) {
+		crc = crc32Update(crc, benchText, BENCH_TEXT_SIZE);
+	}
+	benchSink += crc;
+	return iterations * BENCH_TEXT_SIZE;
+}
+
+
+/**
+ * Measures `sha256Update()`. One operation is one byte.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchSha256Update(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	uint8_t digest[SHA256_SIZE];
+	tSha256 sha;
+	sha256Init(&sha);
+	for (size_t it = 0; it < iterations; ++it) {
+		sha256Update(&sha, benchText, BENCH_TEXT_SIZE);
+	}
+	sha256Final(&sha, digest);
+	benchSink += digest[0];
+	return iterations * BENCH_TEXT_SIZE;
+}
+
+
+/**
+ * Measures `acm_feed()` in read buffer sized chunks. One operation is one byte.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchAcmFeed(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	uint64_t matched = 0;
+	for (size_t it = 0; it < iterations; ++it) {
+		uint32_t state = ACM_START;
+		for (size_t i = 0; i < BENCH_TEXT_SIZE; i += 4096) {
+			matched |= acm_feed(benchMatcher, &state, benchText + i, 4096);
+		}
+	}
+	if ((matched & 3) != 3) {
+		return 0;
+	}
+	benchSink += matched;
+	return iterations * BENCH_TEXT_SIZE;
+}
+
+
+/**
+ * Measures `tgi_add()` by indexing the text split into `b->size` documents
+ * in read buffer sized chunks. One operation is one byte.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchTgiAdd(const tBench * b, const size_t iterations) {
+	const size_t docSize = BENCH_TEXT_SIZE / b->size;
+	uint64_t sum = 0;
+	for (size_t it = 0; it < iterations; ++it) {
+		tTrigramIdx * idx = tgi_create();
+		if (idx == NULL) {
+			return 0;
+		}
+		for (size_t d = 0; d < b->size; ++d) {
+			uint32_t state = TGI_START;
+			for (size_t i = 0; i < docSize; i += 4096) {
+				const size_t len = ((docSize - i) < 4096) ? (docSize - i) : 4096;
+				if ( ! tgi_add(idx, (uint32_t)d, &state, benchText + (d * docSize) + i, len) ) {
+					tgi_delete(idx);
+					return 0;
+				}
+			}
+		}
+		sum += idx->count;
+		tgi_delete(idx);
+	}
+	benchSink += sum;
+	return iterations * b->size * docSize;
+}
+
+
+/**
+ * Measures `tgi_query()` with frequent, rare and missing queries.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchTgiQuery(const tBench * b, const size_t iterations) {
+	static const char * const queries[] = {"SignTool Error: file.exe", "0x80092009", "timestamp failed"};
+	PCF_UNUSED(b);
+	uint64_t sum = 0;
+	const size_t queryCount = sizeof(queries) / sizeof(*queries);
+	for (size_t it = 0; it < iterations; ++it) {
+		const char * query = queries[it % queryCount];
+		uint32_t * docs;
+		size_t count;
+		if ( ! tgi_query(benchTgi, (const uint8_t *)query, strlen(query), &docs, &count) ) {
+			return 0;
+		}
+		sum += count;
+		free(docs);
+	}
+	if (sum == 0) {
+		return 0;
+	}
+	benchSink += sum;
+	return iterations;
+}
+
+
+/**
+ * Measures `cmpToken()` with matching and non-matching tokens.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchCmpToken(const tBench * b, const size_t iterations) {
+	static const wchar_t * const keys[] = {L"certId", L"cardName", L"cardReader", L"signApp"};
+	PCF_UNUSED(b);
+	uint64_t sum = 0;
+	const size_t tokenCount = sizeof(benchTokens) / sizeof(*benchTokens);
+	const size_t keyCount = sizeof(keys) / sizeof(*keys);
+	for (size_t it = 0; it < iterations; ++it) {
+		sum += (uint64_t)(cmpToken(benchTokens + (it % tokenCount), keys[(it / tokenCount) % keyCount]) == 0);
+	}
+	benchSink += sum;
+	return iterations;
+}
+
+
+/**
+ * Measures `fidx_get()` and `fidx_changed()` with pseudo random existing
+ * files.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchFidxGet(const tBench * b, const size_t iterations) {
+	uint64_t sum = 0;
+	uint32_t state = 0xDEADBEEF;
+	for (size_t it = 0; it < iterations; ++it) {
+		const size_t i = (size_t)(benchRand(&state) % b->size);
+		const tFileIdxEntry * e = fidx_get(benchIdx, (uint64_t)(BENCH_FIDX_FIRST_FILE + i));
+		sum += (uint64_t)fidx_changed(e, (uint64_t)i * 4096, UINT64_C(134000000000000000) + (uint64_t)i);
+	}
+	benchSink += sum;
+	return iterations;
+}
+
+
+/**
+ * Measures `fidx_path()` with pseudo random existing files.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchFidxPath(const tBench * b, const size_t iterations) {
+	wchar_t path[64];
+	uint64_t sum = 0;
+	uint32_t state = 0xDEADBEEF;
+	for (size_t it = 0; it < iterations; ++it) {
+		const size_t i = (size_t)(benchRand(&state) % b->size);
+		sum += fidx_path(benchIdx, fidx_get(benchIdx, (uint64_t)(BENCH_FIDX_FIRST_FILE + i)), L'/', path, sizeof(path) / sizeof(*path));
+	}
+	benchSink += sum;
+	return iterations;
+}
+
+
+/**
+ * Measures `fidx_save()`. One operation is one entry.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchFidxSave(const tBench * b, const size_t iterations) {
+	for (size_t it = 0; it < iterations; ++it) {
+		size_t len = 0;
+		uint8_t * data = fidx_save(benchIdx, &len);
+		if (data == NULL) {
+			return 0;
+		}
+		benchSink += len;
+		free(data);
+	}
+	return iterations * b->size;
+}
+
+
+/**
+ * Measures `fidx_load()`. One operation is one entry.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchFidxLoad(const tBench * b, const size_t iterations) {
+	for (size_t it = 0; it < iterations; ++it) {
+		if ( ! fidx_load(benchIdx, benchIdxData, benchIdxLen) ) {
+			return 0;
+		}
+		benchSink += benchIdx->count;
+	}
+	return iterations * b->size;
+}
+
+
+/**
+ * Measures `dcache_get()` with pseudo random existing and changed files. Every
+ * fourth lookup is a miss.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchDcacheGet(const tBench * b, const size_t iterations) {
+	uint8_t digest[SHA256_SIZE];
+	uint64_t sum = 0;
+	uint32_t state = 0xDEADBEEF;
+	for (size_t it = 0; it < iterations; ++it) {
+		const size_t i = (size_t)(benchRand(&state) % b->size);
+		const tDigestKey key = benchDcacheKey(i, UINT64_C(134000000000000000) + (uint64_t)i + (uint64_t)((it & 3) == 0));
+		sum += dcache_get(benchCache, &key, digest, sizeof(digest));
+	}
+	benchSink += sum;
+	return iterations;
+}
+
+
+/**
+ * Measures `dcache_put()` with pseudo random changed files. This includes the
+ * amortized growth and compaction of the value area.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchDcachePut(const tBench * b, const size_t iterations) {
+	static uint64_t mtime = UINT64_C(135000000000000000);
+	uint8_t digest[SHA256_SIZE];
+	uint32_t state = 0x0BADF00D;
+	memset(digest, 0x5A, sizeof(digest));
+	for (size_t it = 0; it < iterations; ++it) {
+		const size_t i = (size_t)(benchRand(&state) % b->size);
+		const tDigestKey key = benchDcacheKey(i, mtime++);
+		if ( ! dcache_put(benchCache, &key, digest, sizeof(digest)) ) {
+			return 0;
+		}
+	}
+	benchSink += dcache_count(benchCache);
+	return iterations;
+}
+
+
+/**
+ * Measures `fdigest_compute()` with the prepared input. One operation is one
+ * byte.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchFdigestCompute(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	uint8_t digest[SHA256_SIZE];
+	unsigned flags;
+	for (size_t it = 0; it < iterations; ++it) {
+		if (( ! fdigest_compute(benchFileFormat, benchFile, benchFileLen, digest, &flags) ) || (flags & FDIGEST_SIGNED) == 0) {
+			return 0;
+		}
+		benchSink += digest[0];
+	}
+	return iterations * benchFileLen;
+}
+
+
+/**
+ * Measures the parallel file hashing of the application. `BENCH_POOL_JOBS`
+ * files are hashed by the worker thread pool per iteration. One operation is
+ * one byte.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchHashPool(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	for (size_t it = 0; it < iterations; ++it) {
+		for (size_t i = 0; i < BENCH_POOL_JOBS; ++i) {
+			benchPoolJobs[i].ok = false;
+			if ( ! wpool_push(benchPool, &(benchPoolJobs[i].item)) ) {
+				return 0;
+			}
+		}
+		for (size_t pending = BENCH_POOL_JOBS; pending > 0; ) {
+			tWorkItem * item = wpool_done(benchPool);
+			if (item == NULL) {
+				benchYield();
+				continue;
+			}
+			for (; item != NULL; item = item->next, --pending) {
+				const tBenchPoolJob * job = (const tBenchPoolJob *)item;
+				if ( ! job->ok ) {
+					return 0;
+				}
+				benchSink += job->digest[0];
+			}
+		}
+	}
+	return iterations * BENCH_POOL_JOBS * benchFileLen;
+}
+
+
+/**
+ * Measures `ini_parse()` with `b->size` groups. One operation is one
+ * character.
+ *
+ * @param[in] b - benchmark
+ * @param[in] iterations - number of iterations
+ * @return number of operations or 0 on error
+ */
+static size_t benchIniParse(const tBench * b, const size_t iterations) {
+	PCF_UNUSED(b);
+	uint64_t count = 0;
+	for (size_t it = 0; it < iterations; ++it) {
+		/* the parser modifies its input */
+		memcpy(benchIniCopy, benchIni, benchIniLen * sizeof(wchar_t));
+		if (ini_parse(benchIniCopy, benchIniLen, benchIniVisit, &count, NULL) != INI_OK) {
+			return 0;
+		}
+	}
+	benchSink += count;
+	return iterations * benchIniLen;
+}
+
+
+/**
+ * List of all benchmarks. Per byte and per element benchmarks are normalized
+ * to this unit.
+ */
+static const tBench benches[] = {
+	{"vec_pushBack", 1000, NULL, benchVecPushBack, NULL},
+	{"vec_pushBack", 100000, NULL, benchVecPushBack, NULL},
+	{"vec_at", 1000, benchVecSetup, benchVecAt, benchFree},
+	{"vec_at", 1000000, benchVecSetup, benchVecAt, benchFree},
+	{"vec_erase", 1000, benchVecSetup, benchVecErase, benchFree},
+	{"vec_erase", 100000, benchVecSetup, benchVecErase, benchFree},
+	{"vec_mergeSort", 1000, benchVecSetup, benchVecMergeSort, benchFree},
+	{"vec_mergeSort", 100000, benchVecSetup, benchVecMergeSort, benchFree},
+	{"hto_addKey", 100, benchHtSetup, benchHtoAddKey, benchFree},
+	{"hto_addKey", 1000, benchHtSetup, benchHtoAddKey, benchFree},
+	{"hto_addKey", 10000, benchHtSetup, benchHtoAddKey, benchFree},
+	{"hto_getKey", 100, benchHtSetup, benchHtoGetKey, benchFree},
+	{"hto_getKey", 1000, benchHtSetup, benchHtoGetKey, benchFree},
+	{"hto_getKey", 10000, benchHtSetup, benchHtoGetKey, benchFree},
+	{"hto_delKey", 100, benchHtSetup, benchHtoDelKey, benchFree},
+	{"hto_delKey", 1000, benchHtSetup, benchHtoDelKey, benchFree},
+	{"hto_delKey", 10000, benchHtSetup, benchHtoDelKey, benchFree},
+	{"hto_traverse", 100, benchHtSetup, benchHtoTraverse, benchFree},
+	{"hto_traverse", 1000, benchHtSetup, benchHtoTraverse, benchFree},
+	{"hto_traverse", 10000, benchHtSetup, benchHtoTraverse, benchFree},
+	{"usb_add", 32, NULL, benchUsbAdd, NULL},
+	{"usb_addC", 1, NULL, benchUsbAddC, NULL},
+	{"usb_addFmt", 1, NULL, benchUsbAddFmt, NULL},
+	{"usb_get", 100, benchSbSetup, benchUsbGet, benchFree},
+	{"usb_get", 100000, benchSbSetup, benchUsbGet, benchFree},
+	{"utf8_parse", BENCH_TEXT_SIZE, benchTextSetup, benchUtf8Parse, benchFree},
+	{"crc32Update", BENCH_TEXT_SIZE, benchTextSetup, benchCrc32Update, benchFree},
+	{"sha256Update", BENCH_TEXT_SIZE, benchTextSetup, benchSha256Update, benchFree},
+	{"acm_feed", 8, benchAcmSetup, benchAcmFeed, benchFree},
+	{"acm_feed", 64, benchAcmSetup, benchAcmFeed, benchFree},
+	{"tgi_add", 64, benchTextSetup, benchTgiAdd, benchFree},
+	{"tgi_query", 1000, benchTgiSetup, benchTgiQuery, benchFree},
+	{"cmpToken", 8, benchTokenSetup, benchCmpToken, NULL},
+	{"ini_parse", 1, benchIniSetup, benchIniParse, benchFree},
+	{"ini_parse", 100, benchIniSetup, benchIniParse, benchFree},
+	{"fidx_get", 50000, benchFidxSetup, benchFidxGet, benchFree},
+	{"fidx_path", 50000, benchFidxSetup, benchFidxPath, benchFree},
+	{"fidx_save", 50000, benchFidxSetup, benchFidxSave, benchFree},
+	{"fidx_load", 50000, benchFidxSetup, benchFidxLoad, benchFree},
+	{"dcache_get", 100000, benchDcacheSetup, benchDcacheGet, benchFree},
+	{"dcache_put", 100000, benchDcacheSetup, benchDcachePut, benchFree},
+	{"fdigest_pe", 1048576, benchPeSetup, benchFdigestCompute, benchFree},
+	{"fdigest_msi", 1048576, benchMsiSetup, benchFdigestCompute, benchFree},
+	{"fdigest_cab", 1048576, benchCabSetup, benchFdigestCompute, benchFree},
+	{"fdigest_ps1", 1048576, benchPs1Setup, benchFdigestCompute, benchFree},
+	{"hash_pool", 1048576, benchPoolSetup, benchHashPool, benchFree},
+};
+
+
+/**
+ * Runs a single benchmark. The number of iterations is increased until a
+ * measurement takes at least `BENCH_MIN_TIME`. The fastest of `BENCH_REPEAT`
+ * measurements is returned.
+ *
+ * @param[in] b - benchmark to run
+ * @param[in,out] res - benchmark result with the name already set
+ * @return `true` on success, else `false`
+ */
+static bool benchRun(const tBench * b, tBenchResult * res) {
+	res->ops = 0;
+	res->nsPerOp = 0.0;
+	bool ok = (b->setup == NULL) || b->setup(b);
+	size_t iterations = 1;
+	for (int r = 0; ok && r < BENCH_REPEAT; ) {
+		const int64_t start = benchNow();
+		const size_t ops = b->run(b, iterations);
+		const int64_t elapsed = benchNow() - start;
+		if (ops == 0) {
+			ok = false;
+			break;
+		}
+		if (elapsed < BENCH_MIN_TIME) {
+			/* calibrate */
+			const double scale = (elapsed > 0) ? ((double)BENCH_MIN_TIME * 1.2 / (double)elapsed) : 100.0;
+			iterations = (size_t)((double)iterations * ((scale > 100.0) ? 100.0 : (scale < 2.0) ? 2.0 : scale));
+			continue;
+		}
+		const double nsPerOp = (double)elapsed / (double)ops;
+		if (res->ops == 0 || nsPerOp < res->nsPerOp) {
+			res->ops = ops;
+			res->nsPerOp = nsPerOp;
+		}
+		++r;
+	}
+	if (b->teardown != NULL) {
+		b->teardown();
+	}
+	return ok;
+}
+
+
+/**
+ * Reads benchmark results from the given CSV file.
+ *
+ * @param[in] path - CSV file path
+ * @return vector of `tBenchResult` or `NULL` on error
+ */
+static tVector * benchReadCsv(const char * path) {
+	FILE * fp = fopen(path, "r");
+	if (fp == NULL) {
+		return NULL;
+	}
+	tVector * v = vec_create(sizeof(tBenchResult));
+	char line[256];
+	while (v != NULL && fgets(line, (int)sizeof(line), fp) != NULL) {
+		tBenchResult r;
+		memset(&r, 0, sizeof(r));
+		if (sscanf(line, "%63[^,],%zu,%lf", r.name, &(r.ops), &(r.nsPerOp)) != 3) {
+			continue; /* header or malformed line */
+		}
+		tBenchResult * item = vec_pushBack(v);
+		if (item == NULL) {
+			vec_delete(v);
+			v = NULL;
+			break;
+		}
+		*item = r;
+	}
+	fclose(fp);
+	return v;
+}
+
+
+/**
+ * Writes the command-line help to standard error.
+ *
+ * @param[in] name - program name
+ */
+static void benchHelp(const char * name) {
+	fprintf(stderr,
+		"%s [options]\n"
+		"\n"
+		"Runs the micro benchmarks and writes the results as CSV.\n"
+		"\n"
+		"-b, --baseline <file>\n"
+		"      Compare the results against this CSV file.\n"
+		"-f, --filter <text>\n"
+		"      Run only benchmarks whose name contains this text.\n"
+		"-h, --help\n"
+		"      Print short usage instruction.\n"
+		"-o, --output <file>\n"
+		"      Write the results to this file instead of standard output.\n"
+		"-t, --threshold <percent>\n"
+		"      Regression threshold compared to the baseline. Default: %.0f\n"
+		"\n"
+		"The exit code is 1 if a benchmark is slower than the baseline by more than\n"
+		"the threshold, 2 on error and 0 otherwise.\n",
+		name,
+		BENCH_THRESHOLD
+	);
+}
+
+
+/**
+ * Main entry point.
+ *
+ * @param[in] argc - number of command-line arguments
+ * @param[in] argv - command-line arguments
+ * @return 0 on success, 1 on regression, 2 on error
+ */
+int main(int argc, char ** argv) {
+	const char * baselinePath = NULL;
+	const char * filter = NULL;
+	const char * outputPath = NULL;
+	double threshold = BENCH_THRESHOLD;
+	for (int i = 1; i < argc; ++i) {
+		const char * arg = argv[i];
+		const char * value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+			benchHelp(argv[0]);
+			return EXIT_SUCCESS;
+		} else if (value == NULL) {
+			fprintf(stderr, "Error: Invalid or incomplete argument \"%s\".\n", arg);
+			return 2;
+		} else if (strcmp(arg, "-b") == 0 || strcmp(arg, "--baseline") == 0) {
+			baselinePath = value;
+		} else if (strcmp(arg, "-f") == 0 || strcmp(arg, "--filter") == 0) {
+			filter = value;
+		} else if (strcmp(arg, "-o") == 0 || strcmp(arg, "--output") == 0) {
+			outputPath = value;
+		} else if (strcmp(arg, "-t") == 0 || strcmp(arg, "--threshold") == 0) {
+			char * end = NULL;
+			threshold = strtod(value, &end);
+			if (end == value || *end != 0 || threshold < 0.0) {
+				fprintf(stderr, "Error: Invalid threshold \"%s\".\n", value);
+				return 2;
+			}
+		} else {
+			fprintf(stderr, "Error: Invalid or incomplete argument \"%s\".\n", arg);
+			return 2;
+		}
+		++i;
+	}
+	tVector * baseline = NULL;
+	if (baselinePath != NULL) {
+		baseline = benchReadCsv(baselinePath);
+		if (baseline == NULL) {
+			fprintf(stderr, "Error: Failed to read baseline \"%s\".\n", baselinePath);
+			return 2;
+		}
+	}
+	FILE * out = stdout;
+	if (outputPath != NULL) {
+		out = fopen(outputPath, "w");
+		if (out == NULL) {
+			fprintf(stderr, "Error: Failed to create \"%s\".\n", outputPath);
+			vec_delete(baseline);
+			return 2;
+		}
+	}
+	int res = EXIT_SUCCESS;
+	size_t regressions = 0;
+	fprintf(out, "name,ops,nsPerOp\n");
+	for (size_t i = 0; i < (sizeof(benches) / sizeof(*benches)); ++i) {
+		const tBench * b = benches + i;
+		tBenchResult r;
+		snprintf(r.name, sizeof(r.name), "%s/%zu", b->name, b->size);
+		if (filter != NULL && strstr(r.name, filter) == NULL) {
+			continue;
+		}
+		if ( ! benchRun(b, &r) ) {
+			fprintf(stderr, "%-24s failed\n", r.name);
+			res = 2;
+			continue;
+		}
+		fprintf(out, "%s,%zu,%.3f\n", r.name, r.ops, r.nsPerOp);
+		fflush(out);
+		/* compare with baseline */
+		const tBenchResult * base = NULL;
+		for (size_t j = 0; baseline != NULL && j < vec_size(baseline); ++j) {
+			const tBenchResult * item = vec_at(baseline, j);
+			if (strcmp(item->name, r.name) == 0) {
+				base = item;
+				break;
+			}
+		}
+		if (base != NULL && base->nsPerOp > 0.0) {
+			const double change = ((r.nsPerOp / base->nsPerOp) - 1.0) * 100.0;
+			const bool regression = change > threshold;
+			if ( regression ) {
+				++regressions;
+			}
+			fprintf(stderr, "%-24s %12.3f ns/op %+8.1f %%%s\n", r.name, r.nsPerOp, change, regression ? "  REGRESSION" : "");
+		} else {
+			fprintf(stderr, "%-24s %12.3f ns/op\n", r.name, r.nsPerOp);
+		}
+	}
+	if (regressions > 0) {
+		fprintf(stderr, "%zu benchmark%s slower than the baseline by more than %.1f %%.\n", regressions, (regressions > 1) ? "s" : "", threshold);
+		if (res == EXIT_SUCCESS) {
+			res = 1;
+		}
+	}
+	if (out != stdout) {
+		fclose(out);
+	}
+	vec_delete(baseline);
+	return res;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file benchutil.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Utility functions shared by the Windows benchmark tools.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <windows.h>
+#include "benchutil.h"
+#include "histogram.h"
+
+
+/**
+ * Returns the current timestamp.
+ *
+ * @return timestamp in milliseconds
+ */
+double bu_now(void) {
+	static LARGE_INTEGER freq = {0};
+	LARGE_INTEGER now;
+	if (freq.QuadPart == 0) {
+		QueryPerformanceFrequency(&freq);
+	}
+	QueryPerformanceCounter(&now);
+	return ((double)(now.QuadPart) * 1000.0) / (double)(freq.QuadPart);
+}
+
+
+/**
+ * Outputs the percentiles of the given values. The values are recorded with
+ * microsecond resolution in a `tHistogram` which limits the relative error to
+ * `1 / HIST_SUB_BUCKETS`.
+ *
+ * @param[in] name - value name
+ * @param[in] values - values in milliseconds
+ * @param[in] count - number of values
+ */
+void bu_printDist(const char * name, const double * values, const size_t count) {
+	static const double quantiles[] = {0.50, 0.90, 0.95, 0.99, 1.0};
+	static tHistogram hist;
+	hist_clear(&hist);
+	for (size_t i = 0; i < count; ++i) {
+		hist_add(&hist, (values[i] > 0.0) ? (uint64_t)llround(values[i] * 1000.0) : 0);
+	}
+	printf("  %-22s %8zu", name, count);
+	for (size_t q = 0; q < (sizeof(quantiles) / sizeof(*quantiles)); ++q) {
+		if (count > 0) {
+			printf(" %12.3f", (double)hist_quantile(&hist, quantiles[q]) / 1000.0);
+		} else {
+			printf(" %12s", "-");
+		}
+	}
+	printf("\n");
+}
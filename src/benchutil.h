@@ -0,0 +1,28 @@
+/**
+ * @file benchutil.h
+ * @author Daniel Starke
+ * @see benchutil.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __BENCHUTIL_H__
+#define __BENCHUTIL_H__
+
+#include <stddef.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+double bu_now(void);
+void bu_printDist(const char * name, const double * values, const size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __BENCHUTIL_H__ */
@@ -1,38 +1,146 @@
 APPS = siguwi
 COMMA = ,
 
-siguwi_version = 1.3.0
+siguwi_version = 1.4.0
 siguwi_version_nums = $(subst .,$(COMMA),$(siguwi_version)),0
-siguwi_version_date = 2025-10-21
+siguwi_version_date = 2026-10-18
 siguwi_author = Daniel Starke
 
 CPPMETAFLAGS = '-DSIGUWI_VERSION="$(siguwi_version) ($(siguwi_version_date))"' '-DSIGUWI_VERSION_NUMS=$(siguwi_version_nums)' '-DSIGUWI_AUTHOR="$(siguwi_author)"'
 CPPFLAGS += $(CPPMETAFLAGS)
 
 siguwi_obj = \
+	acmatch \
 	argpus \
+	crc32 \
+	dcache \
+	fdigest \
+	fidx \
 	getopt \
+	histogram \
 	htableo \
+	ini \
+	lqueue \
+	lz \
+	procusage \
+	replay \
+	sha256 \
+	siguwi-archive \
 	siguwi-config \
+	siguwi-engine \
+	siguwi-hash \
+	siguwi-http \
 	siguwi-ini \
+	siguwi-log \
 	siguwi-main \
+	siguwi-match \
+	siguwi-pipe \
 	siguwi-process \
+	siguwi-record \
 	siguwi-registry \
+	siguwi-remote \
+	siguwi-report \
+	siguwi-scan \
+	siguwi-search \
+	siguwi-shell \
+	siguwi-store \
 	siguwi-translate \
 	rcwstr \
+	trace \
+	trigram \
 	ustrbuf \
 	utf8 \
 	vector \
+	wpool \
+	zip \
+
+bench_obj = \
+	acmatch \
+	bench \
+	crc32 \
+	dcache \
+	fdigest \
+	fidx \
+	htableo \
+	ini \
+	sha256 \
+	trigram \
+	ustrbuf \
+	utf8 \
+	vector \
+	wpool \
+
+replay_obj = \
+	crc32 \
+	histogram \
+	lz \
+	procusage \
+	replay \
+	replayer \
+	ustrbuf \
+	utf8 \
+	vector \
+
+test_obj = \
+	crc32 \
+	dcache \
+	fdigest \
+	lqueue \
+	sha256 \
+	test \
+	zip \
+
+harness_obj = \
+	argpus \
+	benchutil \
+	getopt \
+	harness \
+	histogram \
+	procusage \
+	ustrbuf \
+
+harness_lib = \
+	libpsapi \
+	libshlwapi \
+
+startbench_obj = \
+	argpus \
+	benchutil \
+	getopt \
+	histogram \
+	startbench \
+
+startbench_lib = \
+	libshlwapi \
+
+httpbench_obj = \
+	argpus \
+	benchutil \
+	getopt \
+	histogram \
+	httpbench \
+
+httpbench_lib = \
+	libshlwapi \
+	libws2_32 \
+
+BENCHEXT = $(if $(filter Windows_NT,$(OS)),.exe,)
+BENCH_THREAD_LIB = $(if $(filter Windows_NT,$(OS)),,-pthread)
 
 siguwi_lib = \
+	libole32 \
+	libuuid \
+
+# only needed by the processing window; delay-loaded to keep IPC clients small (see `delay-*.def`)
+siguwi_delay_lib = \
 	libcomctl32 \
 	libcredui \
 	libcrypt32 \
-	libole32 \
+	libiphlpapi \
 	libpsapi \
-	librpcrt4 \
 	libshlwapi \
 	libwinscard \
+	libws2_32 \
 
 all: $(DSTDIR) $(APPS:%=$(DSTDIR)/%$(BINEXT))
 
@@ -48,10 +156,107 @@ clean:
 	$(RM) -r $(DSTDIR)/*.manifest
 	$(RM) -r $(DSTDIR)/*.map
 	$(RM) -r $(DSTDIR)/*$(OBJEXT)
+	$(RM) -r $(DSTDIR)/*.gcda
+	$(RM) -r $(DSTDIR)/*.def
+	$(RM) -r $(DSTDIR)/bench
+	$(RM) -r $(DSTDIR)/lib
+
+$(DSTDIR)/siguwi$(BINEXT): $(addprefix $(DSTDIR)/,$(addsuffix $(OBJEXT),$(siguwi_obj))) $(siguwi_delay_lib:%=$(DSTDIR)/%-delay$(LIBEXT)) | $(DSTDIR)/resource$(OBJEXT)
+	$(AR) rs $(DSTDIR)/siguwi.a $(filter %$(OBJEXT),$+)
+	$(LD) $(LDFLAGS) $(GUI_LDFLAGS) -Wl,-Map,$(DSTDIR)/siguwi.map -o $@ $(DSTDIR)/siguwi.a $(siguwi_delay_lib:%=$(DSTDIR)/%-delay$(LIBEXT)) $(siguwi_lib:lib%=-l%) $(DSTDIR)/resource$(OBJEXT)
+
+# embeddable signing engine library (see `siguwi-engine.h`)
+.PHONY: lib
+lib: $(DSTDIR) $(DSTDIR)/libsiguwi$(LIBEXT)
+
+$(DSTDIR)/libsiguwi$(LIBEXT): $(siguwi_obj:%=$(DSTDIR)/lib/%$(OBJEXT))
+	$(RM) $@
+	$(AR) rs $@ $+
+
+# delay-load import libraries
+$(DSTDIR)/lib%-delay$(LIBEXT): $(SRCDIR)/delay-%.def | $(DSTDIR)
+	$(DELAY_DEF_FILTER) $< >$(DSTDIR)/delay-$*.def
+	$(DLLTOOL) $(DLLTOOLFLAGS) -d $(DSTDIR)/delay-$*.def -y $@
+
+# end-to-end throughput harness (needs `HARNESS=1`)
+.PHONY: harness
+harness: $(DSTDIR) $(DSTDIR)/siguwi$(BINEXT) $(DSTDIR)/harness$(BINEXT) $(DSTDIR)/harness-signer$(BINEXT)
+
+$(DSTDIR)/harness$(BINEXT): $(addprefix $(DSTDIR)/,$(addsuffix $(OBJEXT),$(harness_obj)))
+	$(LD) $(LDFLAGS) -o $@ $+ $(harness_lib:lib%=-l%)
+
+$(DSTDIR)/harness-signer$(BINEXT): $(DSTDIR)/harness-signer$(OBJEXT)
+	$(LD) $(filter-out -municode,$(LDFLAGS)) -o $@ $+
+
+# IPC client start latency benchmark
+.PHONY: startbench
+startbench: $(DSTDIR) $(DSTDIR)/siguwi$(BINEXT) $(DSTDIR)/startbench$(BINEXT)
+	$(DSTDIR)/startbench
+
+$(DSTDIR)/startbench$(BINEXT): $(addprefix $(DSTDIR)/,$(addsuffix $(OBJEXT),$(startbench_obj)))
+	$(LD) $(LDFLAGS) -o $@ $+ $(startbench_lib:lib%=-l%)
+
+# loopback HTTP front end benchmark
+.PHONY: httpbench
+httpbench: $(DSTDIR) $(DSTDIR)/siguwi$(BINEXT) $(DSTDIR)/httpbench$(BINEXT)
+	$(DSTDIR)/httpbench
+
+$(DSTDIR)/httpbench$(BINEXT): $(addprefix $(DSTDIR)/,$(addsuffix $(OBJEXT),$(httpbench_obj)))
+	$(LD) $(LDFLAGS) -o $@ $+ $(httpbench_lib:lib%=-l%)
+
+# native micro benchmarks
+.PHONY: bench
+bench: $(DSTDIR)/bench/siguwi-bench$(BENCHEXT)
+	$< -b $(SRCDIR)/bench-baseline.csv -t $(BENCH_THRESHOLD) -o $(DSTDIR)/bench/bench.csv
+
+.PHONY: bench-baseline
+bench-baseline: $(DSTDIR)/bench/siguwi-bench$(BENCHEXT)
+	$< -o $(SRCDIR)/bench-baseline.csv
+
+$(DSTDIR)/bench/siguwi-bench$(BENCHEXT): $(bench_obj:%=$(DSTDIR)/bench/%$(OBJEXT))
+	$(HOSTCC) $(PGO_LDFLAGS) -o $@ $+ $(BENCH_THREAD_LIB)
+
+# native replay of recorded signing sessions
+.PHONY: replay
+replay: $(DSTDIR)/bench/siguwi-replay$(BENCHEXT)
+
+$(DSTDIR)/bench/siguwi-replay$(BENCHEXT): $(replay_obj:%=$(DSTDIR)/bench/%$(OBJEXT))
+	$(HOSTCC) $(PGO_LDFLAGS) -o $@ $+ -lm
+
+# native tests
+.PHONY: test
+test: $(DSTDIR)/bench/siguwi-test$(BENCHEXT)
+	$< -d $(SRCDIR)/test
+
+$(DSTDIR)/bench/siguwi-test$(BENCHEXT): $(test_obj:%=$(DSTDIR)/bench/%$(OBJEXT))
+	$(HOSTCC) $(PGO_LDFLAGS) -o $@ $+
 
-$(DSTDIR)/siguwi$(BINEXT): $(addprefix $(DSTDIR)/,$(addsuffix $(OBJEXT),$(siguwi_obj))) | $(DSTDIR)/resource$(OBJEXT)
-	$(AR) rs $(DSTDIR)/siguwi.a $+
-	$(LD) $(LDFLAGS) -Wl,-Map,$(DSTDIR)/siguwi.map -o $@ $(DSTDIR)/siguwi.a $(siguwi_lib:lib%=-l%) $(DSTDIR)/resource$(OBJEXT)
+# profile-guided optimization (instrumented build, training run and optimized rebuild)
+# The profiles (*.gcda) are kept next to the object files until `make clean`.
+.PHONY: pgo
+pgo: $(DSTDIR)
+	$(RM) $(DSTDIR)/*$(OBJEXT) $(DSTDIR)/*$(BINEXT) $(DSTDIR)/*.gcda
+	$(MAKE) PGO=gen HARNESS=1 harness
+	$(DSTDIR)/harness $(PGO_HARNESS_ARGS)
+	$(RM) $(DSTDIR)/*$(OBJEXT) $(DSTDIR)/*$(BINEXT)
+	$(MAKE) PGO=use all
+
+.PHONY: pgo-native
+pgo-native:
+	$(RM) $(DSTDIR)/bench/*$(OBJEXT) $(DSTDIR)/bench/siguwi-*$(BENCHEXT) $(DSTDIR)/bench/*.gcda
+	$(MAKE) PGO=gen $(DSTDIR)/bench/siguwi-bench$(BENCHEXT) $(DSTDIR)/bench/siguwi-replay$(BENCHEXT)
+	$(DSTDIR)/bench/siguwi-bench$(BENCHEXT) -o $(DSTDIR)/bench/pgo-train.csv
+	$(if $(PGO_TRACE),$(DSTDIR)/bench/siguwi-replay$(BENCHEXT) -s 0 $(PGO_TRACE))
+	$(RM) $(DSTDIR)/bench/*$(OBJEXT) $(DSTDIR)/bench/siguwi-*$(BENCHEXT)
+	$(MAKE) PGO=use $(DSTDIR)/bench/siguwi-bench$(BENCHEXT) $(DSTDIR)/bench/siguwi-replay$(BENCHEXT)
+
+$(DSTDIR)/bench/%$(OBJEXT): $(SRCDIR)/%$(CEXT)
+	mkdir -p "$(dir $@)"
+	$(HOSTCC) $(CWFLAGS) -I$(SRCDIR) $(BENCH_CFLAGS) -o $@ -c $<
+
+$(DSTDIR)/lib/%$(OBJEXT): $(SRCDIR)/%$(CEXT)
+	mkdir -p "$(dir $@)"
+	$(CC) $(CWFLAGS) $(CPPFLAGS) $(CFLAGS) -DSIGUWI_LIBRARY -ffat-lto-objects -o $@ -c $<
 
 $(DSTDIR)/%$(OBJEXT): $(SRCDIR)/%$(CEXT)
 	mkdir -p "$(dir $@)"
@@ -68,45 +273,216 @@ $(DSTDIR)/%$(OBJEXT): $(SRCDIR)/%$(RCEXT) |$(SRCDIR)/siguwi.exe.manifest
 	$(WINDRES) $@.ii $@
 
 # dependencies
+$(DSTDIR)/bench/acmatch$(OBJEXT): \
+	$(SRCDIR)/acmatch.h
+$(DSTDIR)/bench/bench$(OBJEXT): \
+	$(SRCDIR)/acmatch.h \
+	$(SRCDIR)/crc32.h \
+	$(SRCDIR)/dcache.h \
+	$(SRCDIR)/fdigest.h \
+	$(SRCDIR)/fidx.h \
+	$(SRCDIR)/htableo.h \
+	$(SRCDIR)/ini.h \
+	$(SRCDIR)/sha256.h \
+	$(SRCDIR)/target.h \
+	$(SRCDIR)/trigram.h \
+	$(SRCDIR)/ustrbuf.h \
+	$(SRCDIR)/utf8.h \
+	$(SRCDIR)/vector.h \
+	$(SRCDIR)/wpool.h
+$(DSTDIR)/bench/crc32$(OBJEXT): \
+	$(SRCDIR)/crc32.h
+$(DSTDIR)/bench/dcache$(OBJEXT): \
+	$(SRCDIR)/dcache.h \
+	$(SRCDIR)/target.h
+$(DSTDIR)/bench/fdigest$(OBJEXT): \
+	$(SRCDIR)/fdigest.h \
+	$(SRCDIR)/sha256.h
+$(DSTDIR)/bench/fidx$(OBJEXT): \
+	$(SRCDIR)/crc32.h \
+	$(SRCDIR)/fidx.h
+$(DSTDIR)/bench/histogram$(OBJEXT): \
+	$(SRCDIR)/histogram.h
+$(DSTDIR)/bench/htableo$(OBJEXT): \
+	$(SRCDIR)/htableo.h
+$(DSTDIR)/bench/ini$(OBJEXT): \
+	$(SRCDIR)/ini.h
+$(DSTDIR)/bench/lqueue$(OBJEXT): \
+	$(SRCDIR)/lqueue.h
+$(DSTDIR)/bench/lz$(OBJEXT): \
+	$(SRCDIR)/lz.h
+$(DSTDIR)/bench/procusage$(OBJEXT): \
+	$(SRCDIR)/procusage.h \
+	$(SRCDIR)/target.h
+$(DSTDIR)/bench/replay$(OBJEXT): \
+	$(SRCDIR)/replay.h
+$(DSTDIR)/bench/replayer$(OBJEXT): \
+	$(SRCDIR)/crc32.h \
+	$(SRCDIR)/histogram.h \
+	$(SRCDIR)/lz.h \
+	$(SRCDIR)/procusage.h \
+	$(SRCDIR)/replay.h \
+	$(SRCDIR)/target.h \
+	$(SRCDIR)/ustrbuf.h \
+	$(SRCDIR)/utf8.h \
+	$(SRCDIR)/vector.h
+$(DSTDIR)/bench/sha256$(OBJEXT): \
+	$(SRCDIR)/sha256.h
+$(DSTDIR)/bench/test$(OBJEXT): \
+	$(SRCDIR)/dcache.h \
+	$(SRCDIR)/fdigest.h \
+	$(SRCDIR)/lqueue.h \
+	$(SRCDIR)/sha256.h \
+	$(SRCDIR)/target.h \
+	$(SRCDIR)/zip.h
+$(DSTDIR)/bench/trigram$(OBJEXT): \
+	$(SRCDIR)/trigram.h
+$(DSTDIR)/bench/ustrbuf$(OBJEXT): \
+	$(SRCDIR)/strbuf.i \
+	$(SRCDIR)/target.h \
+	$(SRCDIR)/ustrbuf.h
+$(DSTDIR)/bench/utf8$(OBJEXT): \
+	$(SRCDIR)/utf8.h
+$(DSTDIR)/bench/vector$(OBJEXT): \
+	$(SRCDIR)/vector.h
+$(DSTDIR)/bench/wpool$(OBJEXT): \
+	$(SRCDIR)/target.h \
+	$(SRCDIR)/wpool.h
+$(DSTDIR)/bench/zip$(OBJEXT): \
+	$(SRCDIR)/crc32.h \
+	$(SRCDIR)/target.h \
+	$(SRCDIR)/zip.h
+$(DSTDIR)/acmatch$(OBJEXT): \
+	$(SRCDIR)/acmatch.h
 $(DSTDIR)/argpus$(OBJEXT): \
 	$(SRCDIR)/argp.h \
 	$(SRCDIR)/argp.i \
 	$(SRCDIR)/argpus.h \
 	$(SRCDIR)/getopt.h \
 	$(SRCDIR)/target.h
+$(DSTDIR)/benchutil$(OBJEXT): \
+	$(SRCDIR)/benchutil.h \
+	$(SRCDIR)/histogram.h
+$(DSTDIR)/crc32$(OBJEXT): \
+	$(SRCDIR)/crc32.h
+$(DSTDIR)/dcache$(OBJEXT): \
+	$(SRCDIR)/dcache.h \
+	$(SRCDIR)/target.h
+$(DSTDIR)/fdigest$(OBJEXT): \
+	$(SRCDIR)/fdigest.h \
+	$(SRCDIR)/sha256.h
+$(DSTDIR)/fidx$(OBJEXT): \
+	$(SRCDIR)/crc32.h \
+	$(SRCDIR)/fidx.h
 $(DSTDIR)/getopt$(OBJEXT): \
 	$(SRCDIR)/argp.h \
 	$(SRCDIR)/argpus.h \
 	$(SRCDIR)/getopt.h
+$(DSTDIR)/harness$(OBJEXT): \
+	$(SRCDIR)/benchutil.h \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/harness-signer$(OBJEXT): \
+	$(SRCDIR)/target.h
+$(DSTDIR)/histogram$(OBJEXT): \
+	$(SRCDIR)/histogram.h
 $(DSTDIR)/htableo$(OBJEXT): \
 	$(SRCDIR)/htableo.h
+$(DSTDIR)/httpbench$(OBJEXT): \
+	$(SRCDIR)/benchutil.h \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/ini$(OBJEXT): \
+	$(SRCDIR)/ini.h
+$(DSTDIR)/lqueue$(OBJEXT): \
+	$(SRCDIR)/lqueue.h
+$(DSTDIR)/lz$(OBJEXT): \
+	$(SRCDIR)/lz.h
+$(DSTDIR)/procusage$(OBJEXT): \
+	$(SRCDIR)/procusage.h \
+	$(SRCDIR)/target.h
+$(DSTDIR)/replay$(OBJEXT): \
+	$(SRCDIR)/replay.h
 $(DSTDIR)/rcwstr$(OBJEXT): \
 	$(SRCDIR)/rcwstr.h
 $(DSTDIR)/resource$(OBJEXT): \
 	$(SRCDIR)/resource.h
+$(DSTDIR)/sha256$(OBJEXT): \
+	$(SRCDIR)/sha256.h
 $(SRCDIR)/siguwi.h: \
+	$(SRCDIR)/acmatch.h \
 	$(SRCDIR)/argp.h \
 	$(SRCDIR)/argpus.h \
+	$(SRCDIR)/crc32.h \
+	$(SRCDIR)/dcache.h \
+	$(SRCDIR)/fdigest.h \
+	$(SRCDIR)/fidx.h \
 	$(SRCDIR)/getopt.h \
+	$(SRCDIR)/histogram.h \
 	$(SRCDIR)/htableo.h \
+	$(SRCDIR)/ini.h \
+	$(SRCDIR)/lqueue.h \
+	$(SRCDIR)/lz.h \
+	$(SRCDIR)/procusage.h \
 	$(SRCDIR)/rcwstr.h \
+	$(SRCDIR)/replay.h \
 	$(SRCDIR)/resource.h \
+	$(SRCDIR)/sha256.h \
 	$(SRCDIR)/target.h \
+	$(SRCDIR)/trace.h \
+	$(SRCDIR)/trigram.h \
 	$(SRCDIR)/ustrbuf.h \
 	$(SRCDIR)/utf8.h \
-	$(SRCDIR)/vector.h
+	$(SRCDIR)/vector.h \
+	$(SRCDIR)/wpool.h \
+	$(SRCDIR)/zip.h
+$(DSTDIR)/siguwi-archive$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
 $(DSTDIR)/siguwi-config$(OBJEXT): \
 	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-engine$(OBJEXT): \
+	$(SRCDIR)/siguwi-engine.h \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-hash$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-http$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
 $(DSTDIR)/siguwi-ini$(OBJEXT): \
 	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-log$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
 $(DSTDIR)/siguwi-main$(OBJEXT): \
 	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-match$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-pipe$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
 $(DSTDIR)/siguwi-process$(OBJEXT): \
 	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-record$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
 $(DSTDIR)/siguwi-registry$(OBJEXT): \
 	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-remote$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-report$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-scan$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-search$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-shell$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/siguwi-store$(OBJEXT): \
+	$(SRCDIR)/siguwi.h
 $(DSTDIR)/siguwi-translate$(OBJEXT): \
 	$(SRCDIR)/siguwi.h
+$(DSTDIR)/startbench$(OBJEXT): \
+	$(SRCDIR)/benchutil.h \
+	$(SRCDIR)/siguwi.h
+$(DSTDIR)/trace$(OBJEXT): \
+	$(SRCDIR)/target.h \
+	$(SRCDIR)/trace.h
+$(DSTDIR)/trigram$(OBJEXT): \
+	$(SRCDIR)/trigram.h
 $(DSTDIR)/ustrbuf$(OBJEXT): \
 	$(SRCDIR)/strbuf.i \
 	$(SRCDIR)/target.h \
@@ -115,3 +491,10 @@ $(DSTDIR)/utf8$(OBJEXT): \
 	$(SRCDIR)/utf8.h
 $(DSTDIR)/vector$(OBJEXT): \
 	$(SRCDIR)/vector.h
+$(DSTDIR)/wpool$(OBJEXT): \
+	$(SRCDIR)/target.h \
+	$(SRCDIR)/wpool.h
+$(DSTDIR)/zip$(OBJEXT): \
+	$(SRCDIR)/crc32.h \
+	$(SRCDIR)/target.h \
+	$(SRCDIR)/zip.h
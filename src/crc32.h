@@ -0,0 +1,31 @@
+/**
+ * @file crc32.h
+ * @author Daniel Starke
+ * @see crc32.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __CRC32_H__
+#define __CRC32_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+extern const uint32_t crc32Table[];
+
+
+uint32_t crc32Update(uint32_t seed, const void * data, const size_t len);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __CRC32_H__ */
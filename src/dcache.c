@@ -0,0 +1,599 @@
+/**
+ * @file dcache.c
+ * @author Daniel Starke
+ * @see dcache.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Persistent digest cache keyed by file identity. The cache file is memory
+ * mapped and consists of a header, an open addressing hash index and an
+ * append-only value area. Each file identity and digest algorithm occupies a
+ * single slot. Replacing its digest appends the new value and leaves the old
+ * one as dead bytes until the next compaction. Numbers are stored in native
+ * byte order as the cache is local to the machine. The file is locked
+ * exclusively while open.
+ */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* for `flock()` */
+#endif /* not _WIN32 and not _DEFAULT_SOURCE */
+#include <stdlib.h>
+#include <string.h>
+#include "dcache.h"
+#ifdef PCF_IS_WIN
+#include <windows.h>
+#else /* not PCF_IS_WIN */
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* not PCF_IS_WIN */
+
+
+/**
+ * Digest cache file header.
+ */
+typedef struct {
+	char magic[8]; /**< `DCACHE_MAGIC` */
+	uint64_t capacity; /**< number of slots (power of two) */
+	uint64_t count; /**< number of used slots */
+	uint64_t valueSize; /**< size of the value area in bytes */
+	uint64_t valueEnd; /**< used bytes of the value area */
+	uint64_t dead; /**< bytes of replaced values within the value area */
+	uint64_t generation; /**< incremented each time the cache is opened */
+	uint64_t reserved; /**< always zero */
+} tDigestCacheHeader;
+
+
+/**
+ * Digest cache hash index slot.
+ */
+typedef struct {
+	uint64_t volume; /**< volume or device identifier */
+	uint64_t id; /**< file identifier */
+	uint64_t size; /**< file size in bytes */
+	uint64_t mtime; /**< last modification time */
+	uint64_t ctime; /**< last change time */
+	uint32_t algo; /**< digest algorithm identifier */
+	uint32_t len; /**< digest size in bytes (0 for an empty slot) */
+	uint64_t offset; /**< digest offset within the value area */
+	uint64_t used; /**< generation of the last access */
+} tDigestCacheSlot;
+
+
+/**
+ * Digest cache handle.
+ */
+struct tDigestCache {
+#ifdef PCF_IS_WIN
+	HANDLE hFile; /**< cache file */
+	HANDLE hMap; /**< file mapping or `NULL` */
+#else /* not PCF_IS_WIN */
+	int fd; /**< cache file */
+#endif /* not PCF_IS_WIN */
+	uint8_t * base; /**< mapped file content or `NULL` */
+	size_t size; /**< mapped size in bytes */
+	tDigestCacheHeader * hdr; /**< points to `base` */
+	tDigestCacheSlot * slots; /**< points into `base` after the header */
+	uint8_t * values; /**< points into `base` after the slots */
+};
+
+
+/**
+ * Returns the value area size in bytes occupied by a digest of the given size.
+ *
+ * @param[in] len - digest size in bytes
+ * @return aligned size in bytes
+ */
+static uint64_t dcache_align(const size_t len) {
+	return ((uint64_t)len + 7) & ~(uint64_t)7;
+}
+
+
+/**
+ * Returns the hash index slot of the given file identity and digest
+ * algorithm.
+ *
+ * @param[in] key - digest cache key
+ * @param[in] capacity - number of slots (power of two)
+ * @return slot index
+ */
+static size_t dcache_hash(const tDigestKey * key, const uint64_t capacity) {
+	uint64_t h = key->id ^ (key->volume * UINT64_C(0x9E3779B97F4A7C15)) ^ ((uint64_t)(key->algo) << 56);
+	/* finalizer of SplitMix64 */
+	h = (h ^ (h >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+	h = (h ^ (h >> 27)) * UINT64_C(0x94D049BB133111EB);
+	h ^= h >> 31;
+	return (size_t)(h & (capacity - 1));
+}
+
+
+/**
+ * Releases the current file mapping.
+ *
+ * @param[in,out] cache - digest cache
+ */
+static void dcache_unmap(tDigestCache * cache) {
+	if (cache->base != NULL) {
+#ifdef PCF_IS_WIN
+		UnmapViewOfFile(cache->base);
+#else /* not PCF_IS_WIN */
+		munmap(cache->base, cache->size);
+#endif /* not PCF_IS_WIN */
+	}
+#ifdef PCF_IS_WIN
+	if (cache->hMap != NULL) {
+		CloseHandle(cache->hMap);
+		cache->hMap = NULL;
+	}
+#endif /* PCF_IS_WIN */
+	cache->base = NULL;
+	cache->size = 0;
+	cache->hdr = NULL;
+	cache->slots = NULL;
+	cache->values = NULL;
+}
+
+
+/**
+ * Sets the size of the cache file. Bytes beyond the previous end are zero.
+ * The file needs to be unmapped.
+ *
+ * @param[in,out] cache - digest cache
+ * @param[in] size - new file size in bytes
+ * @return `true` on success, else `false`
+ */
+static bool dcache_resize(tDigestCache * cache, const uint64_t size) {
+#ifdef PCF_IS_WIN
+	LARGE_INTEGER pos;
+	pos.QuadPart = (LONGLONG)size;
+	return SetFilePointerEx(cache->hFile, pos, NULL, FILE_BEGIN) && SetEndOfFile(cache->hFile);
+#else /* not PCF_IS_WIN */
+	return ftruncate(cache->fd, (off_t)size) == 0;
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Maps the given number of bytes of the cache file. The file is extended if
+ * needed. The header and slot pointers are only set if the file is large
+ * enough to hold the header.
+ *
+ * @param[in,out] cache - digest cache
+ * @param[in] size - file size in bytes
+ * @return `true` on success, else `false`
+ */
+static bool dcache_map(tDigestCache * cache, const uint64_t size) {
+	dcache_unmap(cache);
+	if (size == 0 || size > SIZE_MAX) {
+		return false;
+	}
+#ifdef PCF_IS_WIN
+	LARGE_INTEGER current;
+	if (( ! GetFileSizeEx(cache->hFile, &current) ) || ((uint64_t)(current.QuadPart) < size && ( ! dcache_resize(cache, size) ))) {
+		return false;
+	}
+	cache->hMap = CreateFileMappingW(cache->hFile, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, NULL);
+	if (cache->hMap == NULL) {
+		return false;
+	}
+	cache->base = MapViewOfFile(cache->hMap, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, (SIZE_T)size);
+	if (cache->base == NULL) {
+		dcache_unmap(cache);
+		return false;
+	}
+#else /* not PCF_IS_WIN */
+	struct stat st;
+	if (fstat(cache->fd, &st) != 0 || ((uint64_t)(st.st_size) < size && ( ! dcache_resize(cache, size) ))) {
+		return false;
+	}
+	void * base = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+	if (base == MAP_FAILED) {
+		return false;
+	}
+	cache->base = (uint8_t *)base;
+#endif /* not PCF_IS_WIN */
+	cache->size = (size_t)size;
+	if (cache->size >= sizeof(tDigestCacheHeader)) {
+		cache->hdr = (tDigestCacheHeader *)(cache->base);
+		cache->slots = (tDigestCacheSlot *)(cache->base + sizeof(tDigestCacheHeader));
+	}
+	return true;
+}
+
+
+/**
+ * Returns the size of the cache file.
+ *
+ * @param[in] cache - digest cache
+ * @return file size in bytes or `UINT64_MAX` on error
+ */
+static uint64_t dcache_fileSize(const tDigestCache * cache) {
+#ifdef PCF_IS_WIN
+	LARGE_INTEGER size;
+	return GetFileSizeEx(cache->hFile, &size) ? (uint64_t)(size.QuadPart) : UINT64_MAX;
+#else /* not PCF_IS_WIN */
+	struct stat st;
+	return (fstat(cache->fd, &st) == 0) ? (uint64_t)(st.st_size) : UINT64_MAX;
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Checks whether the mapped cache file is consistent. Each used slot needs to
+ * reference a value within the used value area and the number of used slots
+ * needs to match the header. The latter ensures that an empty slot exists.
+ *
+ * @param[in,out] cache - digest cache
+ * @return `true` if valid, else `false`
+ */
+static bool dcache_valid(tDigestCache * cache) {
+	const tDigestCacheHeader * hdr = cache->hdr;
+	if (hdr == NULL || memcmp(hdr->magic, DCACHE_MAGIC, sizeof(hdr->magic)) != 0) {
+		return false;
+	}
+	if (hdr->capacity < DCACHE_MIN_CAPACITY || (hdr->capacity & (hdr->capacity - 1)) != 0 || hdr->count >= hdr->capacity) {
+		return false;
+	}
+	if (hdr->capacity > ((SIZE_MAX - sizeof(tDigestCacheHeader)) / sizeof(tDigestCacheSlot))) {
+		return false;
+	}
+	const uint64_t valueStart = sizeof(tDigestCacheHeader) + (hdr->capacity * sizeof(tDigestCacheSlot));
+	if (hdr->valueEnd > hdr->valueSize || hdr->dead > hdr->valueEnd || (valueStart + hdr->valueSize) != (uint64_t)(cache->size)) {
+		return false;
+	}
+	uint64_t used = 0;
+	for (uint64_t i = 0; i < hdr->capacity; ++i) {
+		const tDigestCacheSlot * s = cache->slots + i;
+		if (s->len == 0) {
+			continue;
+		}
+		if (s->len > DCACHE_MAX_DIGEST || s->len > hdr->valueEnd || s->offset > (hdr->valueEnd - s->len)) {
+			return false;
+		}
+		++used;
+	}
+	if (used != hdr->count) {
+		return false;
+	}
+	cache->values = cache->base + valueStart;
+	return true;
+}
+
+
+/**
+ * Creates an empty cache file with the given number of slots and value area
+ * size in the mapped file.
+ *
+ * @param[in,out] cache - digest cache
+ * @param[in] capacity - number of slots (power of two)
+ * @param[in] valueSize - value area size in bytes
+ * @param[in] generation - current generation
+ * @return `true` on success, else `false`
+ */
+static bool dcache_init(tDigestCache * cache, const uint64_t capacity, const uint64_t valueSize, const uint64_t generation) {
+	dcache_unmap(cache);
+	/* truncating first ensures that all slots are zero */
+	const uint64_t size = sizeof(tDigestCacheHeader) + (capacity * sizeof(tDigestCacheSlot)) + valueSize;
+	if (( ! dcache_resize(cache, 0) ) || ( ! dcache_map(cache, size) )) {
+		return false;
+	}
+	tDigestCacheHeader * hdr = cache->hdr;
+	hdr->capacity = capacity;
+	hdr->count = 0;
+	hdr->valueSize = valueSize;
+	hdr->valueEnd = 0;
+	hdr->dead = 0;
+	hdr->generation = generation;
+	hdr->reserved = 0;
+	cache->values = cache->base + sizeof(tDigestCacheHeader) + (capacity * sizeof(tDigestCacheSlot));
+	return true;
+}
+
+
+/**
+ * Finds the slot of the given file identity and digest algorithm or the empty
+ * slot where it belongs to.
+ *
+ * @param[in] cache - digest cache
+ * @param[in] key - digest cache key
+ * @return slot
+ */
+static tDigestCacheSlot * dcache_find(const tDigestCache * cache, const tDigestKey * key) {
+	const uint64_t mask = cache->hdr->capacity - 1;
+	/* the load factor is kept below 1 so an empty slot always exists */
+	for (size_t i = dcache_hash(key, cache->hdr->capacity); ; i = (size_t)((i + 1) & mask)) {
+		tDigestCacheSlot * s = cache->slots + i;
+		if (s->len == 0 || (s->id == key->id && s->volume == key->volume && s->algo == key->algo)) {
+			return s;
+		}
+	}
+}
+
+
+/**
+ * Writes the given digest into the given slot. The value area needs to have
+ * enough space left.
+ *
+ * @param[in,out] cache - digest cache
+ * @param[in,out] s - target slot
+ * @param[in] key - digest cache key
+ * @param[in] digest - digest
+ * @param[in] len - digest size in bytes
+ * @param[in] used - generation of the last access
+ */
+static void dcache_store(tDigestCache * cache, tDigestCacheSlot * s, const tDigestKey * key, const uint8_t * digest, const size_t len, const uint64_t used) {
+	tDigestCacheHeader * hdr = cache->hdr;
+	const uint64_t offset = hdr->valueEnd;
+	/* the value is written before the slot references it */
+	memcpy(cache->values + offset, digest, len);
+	hdr->valueEnd += dcache_align(len);
+	if (s->len == 0) {
+		++(hdr->count);
+	} else {
+		hdr->dead += dcache_align(s->len);
+		s->len = 0;
+	}
+	s->volume = key->volume;
+	s->id = key->id;
+	s->size = key->size;
+	s->mtime = key->mtime;
+	s->ctime = key->ctime;
+	s->algo = key->algo;
+	s->offset = offset;
+	s->used = used;
+	s->len = (uint32_t)len;
+}
+
+
+/**
+ * Rebuilds the cache file with the given number of slots. Only live entries
+ * which were used within the last `DCACHE_MAX_AGE` generations are kept.
+ * The cache file is left empty on error.
+ *
+ * @param[in,out] cache - digest cache
+ * @param[in] capacity - minimum number of slots (power of two)
+ * @return `true` on success, else `false`
+ */
+static bool dcache_rebuild(tDigestCache * cache, uint64_t capacity) {
+	tDigestCacheHeader * hdr = cache->hdr;
+	const uint64_t generation = hdr->generation;
+	size_t live = 0;
+	uint64_t liveBytes = 0;
+	for (uint64_t i = 0; i < hdr->capacity; ++i) {
+		const tDigestCacheSlot * s = cache->slots + i;
+		if (s->len > 0 && (generation - s->used) <= DCACHE_MAX_AGE) {
+			++live;
+			liveBytes += dcache_align(s->len);
+		}
+	}
+	/* keep a copy of the live entries while the file is recreated */
+	tDigestCacheSlot * slots = (live > 0) ? malloc(live * sizeof(tDigestCacheSlot)) : NULL;
+	uint8_t * values = (live > 0) ? malloc((size_t)liveBytes) : NULL;
+	if (live > 0 && (slots == NULL || values == NULL)) {
+		free(slots);
+		free(values);
+		return false;
+	}
+	size_t n = 0;
+	uint64_t pos = 0;
+	for (uint64_t i = 0; i < hdr->capacity && n < live; ++i) {
+		const tDigestCacheSlot * s = cache->slots + i;
+		if (s->len > 0 && (generation - s->used) <= DCACHE_MAX_AGE) {
+			slots[n] = *s;
+			slots[n].offset = pos;
+			memcpy(values + pos, cache->values + s->offset, s->len);
+			pos += dcache_align(s->len);
+			++n;
+		}
+	}
+	while ((uint64_t)(live * 2) >= capacity) {
+		capacity *= 2;
+	}
+	const uint64_t valueSize = ((liveBytes / DCACHE_PAGE_SIZE) + 1) * DCACHE_PAGE_SIZE;
+	bool res = dcache_init(cache, capacity, valueSize, generation);
+	if ( res ) {
+		tDigestKey key;
+		for (size_t i = 0; i < live; ++i) {
+			const tDigestCacheSlot * s = slots + i;
+			key.volume = s->volume;
+			key.id = s->id;
+			key.size = s->size;
+			key.mtime = s->mtime;
+			key.ctime = s->ctime;
+			key.algo = s->algo;
+			dcache_store(cache, dcache_find(cache, &key), &key, values + s->offset, s->len, s->used);
+		}
+		memcpy(cache->hdr->magic, DCACHE_MAGIC, sizeof(cache->hdr->magic));
+	}
+	free(slots);
+	free(values);
+	return res;
+}
+
+
+/**
+ * Opens the digest cache at the given path. It is created if it does not
+ * exist and recreated empty if it is invalid. The file stays locked until the
+ * cache is closed.
+ *
+ * @param[in] path - cache file path
+ * @return digest cache or `NULL` on error or if locked by another process
+ */
+tDigestCache * dcache_open(const tDigestCacheChar * path) {
+	if (path == NULL) {
+		return NULL;
+	}
+	tDigestCache * cache = calloc(1, sizeof(tDigestCache));
+	if (cache == NULL) {
+		return NULL;
+	}
+#ifdef PCF_IS_WIN
+	cache->hFile = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (cache->hFile == INVALID_HANDLE_VALUE) {
+		free(cache);
+		return NULL;
+	}
+#else /* not PCF_IS_WIN */
+	cache->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (cache->fd < 0) {
+		free(cache);
+		return NULL;
+	}
+	if (flock(cache->fd, LOCK_EX | LOCK_NB) != 0) {
+		close(cache->fd);
+		free(cache);
+		return NULL;
+	}
+#endif /* not PCF_IS_WIN */
+	const uint64_t size = dcache_fileSize(cache);
+	bool res = size != UINT64_MAX && size >= sizeof(tDigestCacheHeader) && dcache_map(cache, size) && dcache_valid(cache);
+	if ( res ) {
+		++(cache->hdr->generation);
+	} else {
+		res = dcache_init(cache, DCACHE_MIN_CAPACITY, DCACHE_PAGE_SIZE, 1);
+		if ( res ) {
+			memcpy(cache->hdr->magic, DCACHE_MAGIC, sizeof(cache->hdr->magic));
+		}
+	}
+	if ( ! res ) {
+		dcache_close(cache);
+		return NULL;
+	}
+	return cache;
+}
+
+
+/**
+ * Closes the given digest cache and writes back all changes.
+ *
+ * @param[in,out] cache - digest cache
+ */
+void dcache_close(tDigestCache * cache) {
+	if (cache == NULL) {
+		return;
+	}
+	if (cache->base != NULL) {
+#ifdef PCF_IS_WIN
+		FlushViewOfFile(cache->base, 0);
+#else /* not PCF_IS_WIN */
+		msync(cache->base, cache->size, MS_ASYNC);
+#endif /* not PCF_IS_WIN */
+	}
+	dcache_unmap(cache);
+#ifdef PCF_IS_WIN
+	CloseHandle(cache->hFile);
+#else /* not PCF_IS_WIN */
+	close(cache->fd);
+#endif /* not PCF_IS_WIN */
+	free(cache);
+}
+
+
+/**
+ * Looks up the digest of the given file state.
+ *
+ * @param[in,out] cache - digest cache
+ * @param[in] key - digest cache key
+ * @param[out] digest - receives the digest
+ * @param[in] len - size of `digest` in bytes
+ * @return digest size in bytes or 0 if not found or `len` is too small
+ */
+size_t dcache_get(tDigestCache * cache, const tDigestKey * key, uint8_t * digest, const size_t len) {
+	if (cache == NULL || cache->hdr == NULL || key == NULL || digest == NULL) {
+		return 0;
+	}
+	tDigestCacheSlot * s = dcache_find(cache, key);
+	if (s->len == 0 || s->size != key->size || s->mtime != key->mtime || s->ctime != key->ctime) {
+		return 0;
+	}
+	if (s->len > len || s->len > cache->hdr->valueEnd || s->offset > (cache->hdr->valueEnd - s->len)) {
+		return 0;
+	}
+	memcpy(digest, cache->values + s->offset, s->len);
+	s->used = cache->hdr->generation;
+	return (size_t)(s->len);
+}
+
+
+/**
+ * Stores the digest of the given file state. A previous digest of the same
+ * file identity and digest algorithm is replaced.
+ *
+ * @param[in,out] cache - digest cache
+ * @param[in] key - digest cache key
+ * @param[in] digest - digest
+ * @param[in] len - digest size in bytes (up to `DCACHE_MAX_DIGEST`)
+ * @return `true` on success, else `false`
+ */
+bool dcache_put(tDigestCache * cache, const tDigestKey * key, const uint8_t * digest, const size_t len) {
+	if (cache == NULL || cache->hdr == NULL || key == NULL || key->algo == 0 || digest == NULL || len == 0 || len > DCACHE_MAX_DIGEST) {
+		return false;
+	}
+	tDigestCacheSlot * s = dcache_find(cache, key);
+	if (s->len == len && s->size == key->size && s->mtime == key->mtime && s->ctime == key->ctime && s->len <= cache->hdr->valueEnd && s->offset <= (cache->hdr->valueEnd - s->len) && memcmp(cache->values + s->offset, digest, len) == 0) {
+		/* unchanged */
+		s->used = cache->hdr->generation;
+		return true;
+	}
+	tDigestCacheHeader * hdr = cache->hdr;
+	/* keep the load factor at or below 50% */
+	if (((hdr->count + 1) * 2) > hdr->capacity && ( ! dcache_rebuild(cache, hdr->capacity * 2) )) {
+		return false;
+	}
+	hdr = cache->hdr;
+	if ((hdr->valueEnd + dcache_align(len)) > hdr->valueSize) {
+		if ((hdr->dead * 2) > hdr->valueSize) {
+			/* reclaim replaced values */
+			if ( ! dcache_rebuild(cache, hdr->capacity) ) {
+				return false;
+			}
+		} else {
+			/* append new pages; growing geometrically amortizes the remapping */
+			const uint64_t oldSize = (uint64_t)(cache->size);
+			const uint64_t grow = ((hdr->valueSize / 2 / DCACHE_PAGE_SIZE) + 1) * DCACHE_PAGE_SIZE;
+			const uint64_t valueSize = hdr->valueSize + grow;
+			if ( ! dcache_map(cache, oldSize + grow) ) {
+				if ( dcache_map(cache, oldSize) ) {
+					dcache_valid(cache);
+				}
+				return false;
+			}
+			cache->hdr->valueSize = valueSize;
+			if ( ! dcache_valid(cache) ) {
+				return false;
+			}
+		}
+	}
+	dcache_store(cache, dcache_find(cache, key), key, digest, len, cache->hdr->generation);
+	return true;
+}
+
+
+/**
+ * Compacts the given digest cache. Replaced digests and entries which were
+ * not used within the last `DCACHE_MAX_AGE` generations are removed.
+ *
+ * @param[in,out] cache - digest cache
+ * @return `true` on success, else `false`
+ */
+bool dcache_compact(tDigestCache * cache) {
+	if (cache == NULL || cache->hdr == NULL) {
+		return false;
+	}
+	return dcache_rebuild(cache, DCACHE_MIN_CAPACITY);
+}
+
+
+/**
+ * Returns the number of entries in the given digest cache.
+ *
+ * @param[in] cache - digest cache
+ * @return number of entries
+ */
+size_t dcache_count(const tDigestCache * cache) {
+	if (cache == NULL || cache->hdr == NULL) {
+		return 0;
+	}
+	return (size_t)(cache->hdr->count);
+}
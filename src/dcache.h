@@ -0,0 +1,97 @@
+/**
+ * @file dcache.h
+ * @author Daniel Starke
+ * @see dcache.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __DCACHE_H__
+#define __DCACHE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+#include "target.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Digest cache file magic.
+ */
+#define DCACHE_MAGIC "SIGUWID1"
+
+
+/**
+ * Maximum digest size in bytes.
+ */
+#define DCACHE_MAX_DIGEST 64
+
+
+/**
+ * Granularity in bytes by which the value area grows.
+ */
+#define DCACHE_PAGE_SIZE 65536
+
+
+/**
+ * Minimum number of hash index slots.
+ */
+#define DCACHE_MIN_CAPACITY 1024
+
+
+/**
+ * Number of times the cache can be opened without using an entry before it
+ * is dropped by the next compaction.
+ */
+#define DCACHE_MAX_AGE 64
+
+
+/**
+ * Character type of digest cache file paths.
+ */
+#ifdef PCF_IS_WIN
+typedef wchar_t tDigestCacheChar;
+#else /* not PCF_IS_WIN */
+typedef char tDigestCacheChar;
+#endif /* not PCF_IS_WIN */
+
+
+/**
+ * Digest cache key. A file with the same identity, size and times is assumed
+ * to have the same content.
+ */
+typedef struct {
+	uint64_t volume; /**< volume or device identifier */
+	uint64_t id; /**< file identifier or inode number */
+	uint64_t size; /**< file size in bytes */
+	uint64_t mtime; /**< last modification time */
+	uint64_t ctime; /**< last change time */
+	uint32_t algo; /**< digest algorithm identifier (not 0) */
+} tDigestKey;
+
+
+/**
+ * Opaque digest cache handle.
+ */
+typedef struct tDigestCache tDigestCache;
+
+
+tDigestCache * dcache_open(const tDigestCacheChar * path);
+void dcache_close(tDigestCache * cache);
+size_t dcache_get(tDigestCache * cache, const tDigestKey * key, uint8_t * digest, const size_t len);
+bool dcache_put(tDigestCache * cache, const tDigestKey * key, const uint8_t * digest, const size_t len);
+bool dcache_compact(tDigestCache * cache);
+size_t dcache_count(const tDigestCache * cache);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __DCACHE_H__ */
@@ -0,0 +1,826 @@
+/**
+ * @file fdigest.c
+ * @author Daniel Starke
+ * @see fdigest.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Format-aware SHA-256 file digests over a single memory block, usually a
+ * mapped file. The signable formats skip the same parts Authenticode skips:
+ * - PE images: checksum, certificate table directory entry and certificate
+ *   table.
+ * - MSI packages: the streams of each OLE compound document storage are
+ *   hashed in name order followed by the class ID of the storage. The
+ *   signature streams of the root storage are skipped.
+ * - Cabinets: signature offset and size of the header reserve and the
+ *   signature itself.
+ * - PowerShell scripts: the text is hashed as UTF-16LE regardless of its
+ *   encoding up to the line break before the signature block. Invalid UTF-8
+ *   bytes are mapped to lone low surrogates to keep distinct input distinct.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "fdigest.h"
+
+
+/* PE image layout */
+#define FDIGEST_PE_LFANEW 0x3C
+#define FDIGEST_PE_OPT_LEN 20 /* optional header size offset relative to the PE signature */
+#define FDIGEST_PE_OPT 24 /* optional header offset relative to the PE signature */
+#define FDIGEST_PE_CHECKSUM 64 /* relative to the optional header */
+#define FDIGEST_PE_CERT_DIR 4 /* data directory index of the certificate table */
+
+/* OLE compound document layout */
+#define FDIGEST_OLE_HEADER 512
+#define FDIGEST_OLE_DIFAT_LEN 109
+#define FDIGEST_OLE_ENTRY_LEN 128
+#define FDIGEST_OLE_MAXREGSECT UINT32_C(0xFFFFFFFA)
+#define FDIGEST_OLE_ENDOFCHAIN UINT32_C(0xFFFFFFFE)
+#define FDIGEST_OLE_NOSTREAM UINT32_C(0xFFFFFFFF)
+#define FDIGEST_OLE_STORAGE 1
+#define FDIGEST_OLE_STREAM 2
+#define FDIGEST_OLE_ROOT 5
+
+/* cabinet layout */
+#define FDIGEST_CAB_HEADER_LEN 36
+#define FDIGEST_CAB_RESERVE_PRESENT 0x0004
+#define FDIGEST_CAB_SIG_RESERVE 20 /* header reserve size of signed cabinets */
+
+/** PowerShell signature block start line. */
+#define FDIGEST_PS1_BEGIN "# SIG # Begin signature block"
+/** PowerShell signature block end line. */
+#define FDIGEST_PS1_END "# SIG # End signature block"
+/** UTF-16LE output buffer size in bytes. */
+#define FDIGEST_PS1_BUF 4096
+
+
+/**
+ * OLE compound document parser state.
+ */
+typedef struct {
+	const uint8_t * data; /**< file content */
+	size_t len; /**< file size in bytes */
+	tSha256 * sha; /**< hashing context */
+	unsigned * flags; /**< result flags */
+	bool v3; /**< major version 3 (only the lower 32 bits of the stream sizes are valid) */
+	size_t secSize; /**< sector size in bytes */
+	size_t miniSize; /**< mini sector size in bytes */
+	uint64_t miniCutoff; /**< streams smaller than this are stored in the mini stream */
+	size_t sectors; /**< number of (partial) sectors in the file */
+	uint32_t * fat; /**< FAT sectors */
+	size_t fatCount; /**< number of FAT sectors */
+	uint32_t * miniFat; /**< mini FAT sectors */
+	size_t miniFatCount; /**< number of mini FAT sectors */
+	uint32_t * miniStream; /**< mini stream sectors */
+	size_t miniStreamCount; /**< number of mini stream sectors */
+	uint32_t * dir; /**< directory sectors */
+	size_t dirCount; /**< number of directory sectors */
+	size_t entries; /**< number of directory entries */
+	uint8_t * visited; /**< directory entries already reached */
+} tFdigestOle;
+
+
+/**
+ * PowerShell script text encodings.
+ */
+typedef enum {
+	FDIGEST_UTF8, /**< UTF-8 with or without BOM, ANSI */
+	FDIGEST_UTF16LE, /**< UTF-16LE with BOM */
+	FDIGEST_UTF16BE /**< UTF-16BE with BOM */
+} tFdigestEncoding;
+
+
+static uint16_t fdigestRd16(const uint8_t * p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+
+static uint32_t fdigestRd32(const uint8_t * p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+static uint64_t fdigestRd64(const uint8_t * p) {
+	return (uint64_t)fdigestRd32(p) | ((uint64_t)fdigestRd32(p + 4) << 32);
+}
+
+
+/**
+ * Hashes the given byte range.
+ *
+ * @param[in,out] sha - hashing context
+ * @param[in] data - file content
+ * @param[in] start - start offset
+ * @param[in] end - end offset (exclusive)
+ */
+static void fdigestRange(tSha256 * sha, const uint8_t * data, const size_t start, const size_t end) {
+	if (start < end) {
+		sha256Update(sha, data + start, end - start);
+	}
+}
+
+
+/**
+ * Hashes a PE image. The certificate table needs to follow the directory
+ * entries.
+ *
+ * @param[in,out] sha - hashing context
+ * @param[in] data - file content
+ * @param[in] len - file size in bytes
+ * @param[out] flags - result flags
+ * @return `true` on success, else `false` if not a valid PE image
+ */
+static bool fdigestPe(tSha256 * sha, const uint8_t * data, const size_t len, unsigned * flags) {
+	if (len < 64 || data[0] != 'M' || data[1] != 'Z') {
+		return false;
+	}
+	const size_t pe = (size_t)fdigestRd32(data + FDIGEST_PE_LFANEW);
+	if (pe > len - FDIGEST_PE_OPT || memcmp(data + pe, "PE\0\0", 4) != 0) {
+		return false;
+	}
+	const size_t opt = pe + FDIGEST_PE_OPT;
+	const size_t optLen = (size_t)fdigestRd16(data + pe + FDIGEST_PE_OPT_LEN);
+	if (optLen < 2 || optLen > len - opt) {
+		return false;
+	}
+	size_t count, dirs;
+	switch (fdigestRd16(data + opt)) {
+	case 0x10B: /* PE32 */
+		count = opt + 92;
+		dirs = opt + 96;
+		break;
+	case 0x20B: /* PE32+ */
+		count = opt + 108;
+		dirs = opt + 112;
+		break;
+	default:
+		return false;
+	}
+	const size_t checksum = opt + FDIGEST_PE_CHECKSUM;
+	const size_t certDir = dirs + (FDIGEST_PE_CERT_DIR * 8);
+	if ((certDir + 8 - opt) > optLen || fdigestRd32(data + count) <= FDIGEST_PE_CERT_DIR) {
+		return false;
+	}
+	size_t certStart = len;
+	size_t certEnd = len;
+	const size_t certOffset = (size_t)fdigestRd32(data + certDir);
+	const size_t certSize = (size_t)fdigestRd32(data + certDir + 4);
+	if (certSize > 0) {
+		if (certOffset < (certDir + 8) || certOffset > len || certSize > (len - certOffset)) {
+			return false;
+		}
+		certStart = certOffset;
+		certEnd = certOffset + certSize;
+		*flags |= FDIGEST_SIGNED;
+	}
+	fdigestRange(sha, data, 0, checksum);
+	fdigestRange(sha, data, checksum + 4, certDir);
+	fdigestRange(sha, data, certDir + 8, certStart);
+	fdigestRange(sha, data, certEnd, len);
+	return true;
+}
+
+
+/**
+ * Returns the given range within a sector of the OLE compound document.
+ *
+ * @param[in] ole - parser state
+ * @param[in] sector - sector number
+ * @param[in] offset - offset within the sector
+ * @param[in] n - number of bytes
+ * @return pointer to the data or `NULL` if out of range
+ */
+static const uint8_t * fdigestOleAt(const tFdigestOle * ole, const uint32_t sector, const size_t offset, const size_t n) {
+	if (sector >= FDIGEST_OLE_MAXREGSECT || (size_t)sector >= ole->sectors || (offset + n) > ole->secSize) {
+		return NULL;
+	}
+	const size_t pos = (((size_t)sector + 1) * ole->secSize) + offset;
+	if (pos > ole->len || n > (ole->len - pos)) {
+		return NULL;
+	}
+	return ole->data + pos;
+}
+
+
+/**
+ * Retrieves the successor of the given sector from an allocation table.
+ *
+ * @param[in] ole - parser state
+ * @param[in] table - allocation table sectors
+ * @param[in] count - number of allocation table sectors
+ * @param[in] sector - sector number
+ * @param[out] next - receives the next sector number
+ * @return `true` on success, else `false`
+ */
+static bool fdigestOleNext(const tFdigestOle * ole, const uint32_t * table, const size_t count, const uint32_t sector, uint32_t * next) {
+	const size_t perSector = ole->secSize / 4;
+	const size_t i = (size_t)sector / perSector;
+	if (i >= count) {
+		return false;
+	}
+	const uint8_t * p = fdigestOleAt(ole, table[i], ((size_t)sector % perSector) * 4, 4);
+	if (p == NULL) {
+		return false;
+	}
+	*next = fdigestRd32(p);
+	return true;
+}
+
+
+/**
+ * Collects the sectors of the given FAT chain.
+ *
+ * @param[in] ole - parser state
+ * @param[in] start - first sector
+ * @param[out] count - receives the number of sectors
+ * @param[out] chain - receives the allocated sector array (may be `NULL` for empty chains)
+ * @return `true` on success, else `false`
+ */
+static bool fdigestOleChain(const tFdigestOle * ole, uint32_t start, size_t * count, uint32_t ** chain) {
+	size_t n = 0, cap = 0;
+	uint32_t * res = NULL;
+	while (start != FDIGEST_OLE_ENDOFCHAIN) {
+		if (start >= FDIGEST_OLE_MAXREGSECT || n >= ole->sectors) {
+			/* invalid sector or loop */
+			free(res);
+			return false;
+		}
+		if (n >= cap) {
+			cap = (cap > 0) ? (cap * 2) : 16;
+			uint32_t * newRes = (uint32_t *)realloc(res, cap * sizeof(uint32_t));
+			if (newRes == NULL) {
+				free(res);
+				return false;
+			}
+			res = newRes;
+		}
+		res[n++] = start;
+		if ( ! fdigestOleNext(ole, ole->fat, ole->fatCount, start, &start) ) {
+			free(res);
+			return false;
+		}
+	}
+	*count = n;
+	*chain = res;
+	return true;
+}
+
+
+/**
+ * Collects the FAT sectors from the header and the DIFAT chain.
+ *
+ * @param[in,out] ole - parser state
+ * @return `true` on success, else `false`
+ */
+static bool fdigestOleFat(tFdigestOle * ole) {
+	const size_t count = (size_t)fdigestRd32(ole->data + 0x2C);
+	if (count == 0 || count > ole->sectors) {
+		return false;
+	}
+	ole->fat = (uint32_t *)malloc(count * sizeof(uint32_t));
+	if (ole->fat == NULL) {
+		return false;
+	}
+	size_t n = 0;
+	for (; n < count && n < FDIGEST_OLE_DIFAT_LEN; ++n) {
+		ole->fat[n] = fdigestRd32(ole->data + 0x4C + (4 * n));
+	}
+	const size_t perSector = (ole->secSize / 4) - 1;
+	uint32_t sector = fdigestRd32(ole->data + 0x44);
+	for (size_t steps = 0; n < count; ++steps) {
+		const uint8_t * p = fdigestOleAt(ole, sector, 0, ole->secSize);
+		if (p == NULL || steps >= ole->sectors) {
+			return false;
+		}
+		for (size_t i = 0; n < count && i < perSector; ++i) {
+			ole->fat[n++] = fdigestRd32(p + (4 * i));
+		}
+		sector = fdigestRd32(p + (4 * perSector));
+	}
+	ole->fatCount = count;
+	return true;
+}
+
+
+/**
+ * Returns the given directory entry.
+ *
+ * @param[in] ole - parser state
+ * @param[in] id - directory entry identifier
+ * @return pointer to the entry or `NULL` if out of range
+ */
+static const uint8_t * fdigestOleEntry(const tFdigestOle * ole, const uint32_t id) {
+	const size_t perSector = ole->secSize / FDIGEST_OLE_ENTRY_LEN;
+	if ((size_t)id >= ole->entries) {
+		return NULL;
+	}
+	return fdigestOleAt(ole, ole->dir[(size_t)id / perSector], ((size_t)id % perSector) * FDIGEST_OLE_ENTRY_LEN, FDIGEST_OLE_ENTRY_LEN);
+}
+
+
+/**
+ * Returns the name length of the given directory entry without terminator.
+ *
+ * @param[in] entry - directory entry
+ * @return name length in bytes
+ */
+static size_t fdigestOleNameLen(const uint8_t * entry) {
+	const size_t len = (size_t)fdigestRd16(entry + 0x40);
+	return (len >= 2 && len <= 64) ? (len - 2) : 0;
+}
+
+
+/**
+ * Compares the names of two directory entries by their raw UTF-16LE bytes.
+ * Shorter names come first on equal prefixes.
+ *
+ * @param[in] lhs - left-hand side directory entry pointer
+ * @param[in] rhs - right-hand side directory entry pointer
+ * @return <0 if lhs < rhs, 0 if equal, >0 if lhs > rhs
+ */
+static int fdigestOleCmp(const void * lhs, const void * rhs) {
+	const uint8_t * l = *(const uint8_t * const *)lhs;
+	const uint8_t * r = *(const uint8_t * const *)rhs;
+	const size_t lLen = fdigestOleNameLen(l);
+	const size_t rLen = fdigestOleNameLen(r);
+	const int res = memcmp(l, r, (lLen < rLen) ? lLen : rLen);
+	if (res != 0) {
+		return res;
+	}
+	return (lLen < rLen) ? -1 : (lLen > rLen) ? 1 : 0;
+}
+
+
+/**
+ * Checks whether the given directory entry is a signature stream.
+ *
+ * @param[in] entry - directory entry
+ * @return `true` if a signature stream, else `false`
+ */
+static bool fdigestOleIsSignature(const uint8_t * entry) {
+	static const char * const names[] = {
+		"\005DigitalSignature",
+		"\005MsiDigitalSignatureEx"
+	};
+	const size_t len = fdigestOleNameLen(entry) / 2;
+	for (size_t i = 0; i < sizeof(names) / sizeof(*names); ++i) {
+		const char * name = names[i];
+		size_t j = 0;
+		for (; j < len && name[j] != 0 && fdigestRd16(entry + (2 * j)) == (uint16_t)(uint8_t)name[j]; ++j);
+		if (j == len && name[j] == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Hashes the content of the given stream.
+ *
+ * @param[in,out] ole - parser state
+ * @param[in] sector - first (mini) sector
+ * @param[in] size - stream size in bytes
+ * @return `true` on success, else `false`
+ */
+static bool fdigestOleStream(tFdigestOle * ole, uint32_t sector, uint64_t size) {
+	const bool mini = size < ole->miniCutoff;
+	const size_t unit = mini ? ole->miniSize : ole->secSize;
+	/* the size limit bounds the loop below even for cyclic chains */
+	if (size > (uint64_t)(mini ? (ole->miniStreamCount * ole->secSize) : ole->len)) {
+		return false;
+	}
+	while (size > 0) {
+		const size_t n = (size < (uint64_t)unit) ? (size_t)size : unit;
+		const uint8_t * p;
+		if ( mini ) {
+			if (sector >= FDIGEST_OLE_MAXREGSECT) {
+				return false;
+			}
+			const size_t offset = (size_t)sector * ole->miniSize;
+			const size_t i = offset / ole->secSize;
+			p = (i < ole->miniStreamCount) ? fdigestOleAt(ole, ole->miniStream[i], offset % ole->secSize, n) : NULL;
+		} else {
+			p = fdigestOleAt(ole, sector, 0, n);
+		}
+		if (p == NULL) {
+			return false;
+		}
+		sha256Update(ole->sha, p, n);
+		size -= (uint64_t)n;
+		if (size > 0) {
+			const bool ok = mini ? fdigestOleNext(ole, ole->miniFat, ole->miniFatCount, sector, &sector) : fdigestOleNext(ole, ole->fat, ole->fatCount, sector, &sector);
+			if ( ! ok ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Hashes the given storage recursively. Its children are hashed in name
+ * order, followed by the class ID of the storage.
+ *
+ * @param[in,out] ole - parser state
+ * @param[in] storage - directory entry of the storage
+ * @param[in] depth - nesting level (0 for the root storage)
+ * @return `true` on success, else `false`
+ */
+static bool fdigestOleStorage(tFdigestOle * ole, const uint8_t * storage, const size_t depth) {
+	if (depth > FDIGEST_MAX_DEPTH) {
+		return false;
+	}
+	/* each entry is visited at most once; this bounds both arrays */
+	const uint8_t ** children = (const uint8_t **)malloc(ole->entries * sizeof(uint8_t *));
+	uint32_t * stack = (uint32_t *)malloc(((2 * ole->entries) + 1) * sizeof(uint32_t));
+	bool res = children != NULL && stack != NULL;
+	size_t count = 0, top = 0;
+	if ( res ) {
+		stack[top++] = fdigestRd32(storage + 0x4C);
+	}
+	while (res && top > 0) {
+		const uint32_t id = stack[--top];
+		if (id == FDIGEST_OLE_NOSTREAM) {
+			continue;
+		}
+		const uint8_t * entry = fdigestOleEntry(ole, id);
+		if (entry == NULL || ole->visited[id] != 0) {
+			res = false;
+			break;
+		}
+		ole->visited[id] = 1;
+		children[count++] = entry;
+		stack[top++] = fdigestRd32(entry + 0x44);
+		stack[top++] = fdigestRd32(entry + 0x48);
+	}
+	free(stack);
+	if ( res ) {
+		qsort(children, count, sizeof(*children), fdigestOleCmp);
+	}
+	for (size_t i = 0; res && i < count; ++i) {
+		const uint8_t * entry = children[i];
+		switch (entry[0x42]) {
+		case FDIGEST_OLE_STREAM:
+			if (depth == 0 && fdigestOleIsSignature(entry)) {
+				*(ole->flags) |= FDIGEST_SIGNED;
+			} else {
+				const uint64_t size = fdigestRd64(entry + 0x78);
+				res = fdigestOleStream(ole, fdigestRd32(entry + 0x74), ole->v3 ? (size & UINT64_C(0xFFFFFFFF)) : size);
+			}
+			break;
+		case FDIGEST_OLE_STORAGE:
+			res = fdigestOleStorage(ole, entry, depth + 1);
+			break;
+		default:
+			break;
+		}
+	}
+	free((void *)children);
+	if ( res ) {
+		sha256Update(ole->sha, storage + 0x50, 16);
+	}
+	return res;
+}
+
+
+/**
+ * Hashes an OLE compound document like an MSI package.
+ *
+ * @param[in,out] sha - hashing context
+ * @param[in] data - file content
+ * @param[in] len - file size in bytes
+ * @param[out] flags - result flags
+ * @return `true` on success, else `false` if not a valid compound document
+ */
+static bool fdigestMsi(tSha256 * sha, const uint8_t * data, const size_t len, unsigned * flags) {
+	static const uint8_t magic[8] = {0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1};
+	if (len < FDIGEST_OLE_HEADER || memcmp(data, magic, sizeof(magic)) != 0) {
+		return false;
+	}
+	const uint16_t major = fdigestRd16(data + 0x1A);
+	const uint16_t shift = fdigestRd16(data + 0x1E);
+	if ((( ! (major == 3 && shift == 9) ) && ( ! (major == 4 && shift == 12) )) || fdigestRd16(data + 0x20) != 6) {
+		return false;
+	}
+	tFdigestOle ole;
+	memset(&ole, 0, sizeof(ole));
+	ole.data = data;
+	ole.len = len;
+	ole.sha = sha;
+	ole.flags = flags;
+	ole.v3 = major == 3;
+	ole.secSize = (size_t)1 << shift;
+	ole.miniSize = 64;
+	ole.miniCutoff = (uint64_t)fdigestRd32(data + 0x38);
+	if (len <= ole.secSize) {
+		return false;
+	}
+	ole.sectors = (len - 1) / ole.secSize;
+	bool res = fdigestOleFat(&ole)
+		&& fdigestOleChain(&ole, fdigestRd32(data + 0x30), &(ole.dirCount), &(ole.dir))
+		&& fdigestOleChain(&ole, fdigestRd32(data + 0x3C), &(ole.miniFatCount), &(ole.miniFat));
+	const uint8_t * root = NULL;
+	if ( res ) {
+		ole.entries = ole.dirCount * (ole.secSize / FDIGEST_OLE_ENTRY_LEN);
+		root = fdigestOleEntry(&ole, 0);
+		res = root != NULL && root[0x42] == FDIGEST_OLE_ROOT;
+	}
+	if ( res ) {
+		ole.visited = (uint8_t *)calloc(ole.entries, 1);
+		res = ole.visited != NULL && fdigestOleChain(&ole, fdigestRd32(root + 0x74), &(ole.miniStreamCount), &(ole.miniStream));
+	}
+	if ( res ) {
+		ole.visited[0] = 1;
+		res = fdigestOleStorage(&ole, root, 0);
+	}
+	free(ole.visited);
+	free(ole.miniStream);
+	free(ole.miniFat);
+	free(ole.dir);
+	free(ole.fat);
+	return res;
+}
+
+
+/**
+ * Hashes a cabinet. Only the signature fields of the Authenticode header
+ * reserve and the signature it refers to are skipped.
+ *
+ * @param[in,out] sha - hashing context
+ * @param[in] data - file content
+ * @param[in] len - file size in bytes
+ * @param[out] flags - result flags
+ * @return `true` on success, else `false` if not a valid cabinet
+ */
+static bool fdigestCab(tSha256 * sha, const uint8_t * data, const size_t len, unsigned * flags) {
+	if (len < FDIGEST_CAB_HEADER_LEN || memcmp(data, "MSCF", 4) != 0) {
+		return false;
+	}
+	const uint16_t cabFlags = fdigestRd16(data + 30);
+	const size_t reserve = FDIGEST_CAB_HEADER_LEN + 4;
+	if ((cabFlags & FDIGEST_CAB_RESERVE_PRESENT) == 0 || len < (reserve + FDIGEST_CAB_SIG_RESERVE) || fdigestRd16(data + FDIGEST_CAB_HEADER_LEN) != FDIGEST_CAB_SIG_RESERVE) {
+		/* no signature reserve */
+		fdigestRange(sha, data, 0, len);
+		return true;
+	}
+	/* reserve: 4 bytes marker, 4 bytes signature offset, 4 bytes signature size, 8 bytes zero */
+	size_t sigStart = len;
+	size_t sigEnd = len;
+	const size_t sigOffset = (size_t)fdigestRd32(data + reserve + 4);
+	const size_t sigSize = (size_t)fdigestRd32(data + reserve + 8);
+	if (sigSize > 0) {
+		if (sigOffset < (reserve + FDIGEST_CAB_SIG_RESERVE) || sigOffset > len || sigSize > (len - sigOffset)) {
+			return false;
+		}
+		sigStart = sigOffset;
+		sigEnd = sigOffset + sigSize;
+		*flags |= FDIGEST_SIGNED;
+	}
+	fdigestRange(sha, data, 0, reserve + 4);
+	fdigestRange(sha, data, reserve + 12, sigStart);
+	fdigestRange(sha, data, sigEnd, len);
+	return true;
+}
+
+
+/**
+ * Returns the code unit at the given script offset.
+ *
+ * @param[in] data - file content
+ * @param[in] pos - byte offset
+ * @param[in] enc - text encoding
+ * @return code unit
+ */
+static uint16_t fdigestPs1Unit(const uint8_t * data, const size_t pos, const tFdigestEncoding enc) {
+	switch (enc) {
+	case FDIGEST_UTF16LE: return (uint16_t)(data[pos] | (data[pos + 1] << 8));
+	case FDIGEST_UTF16BE: return (uint16_t)((data[pos] << 8) | data[pos + 1]);
+	default: return data[pos];
+	}
+}
+
+
+/**
+ * Checks whether the given ASCII line starts at the given script offset.
+ *
+ * @param[in] data - file content
+ * @param[in] pos - byte offset
+ * @param[in] end - end offset of the text
+ * @param[in] enc - text encoding
+ * @param[in] line - ASCII line to compare with
+ * @return `true` if found, else `false`
+ */
+static bool fdigestPs1Match(const uint8_t * data, size_t pos, const size_t end, const tFdigestEncoding enc, const char * line) {
+	const size_t unit = (enc == FDIGEST_UTF8) ? 1 : 2;
+	for (; *line != 0; ++line, pos += unit) {
+		if ((end - pos) < unit || fdigestPs1Unit(data, pos, enc) != (uint16_t)(uint8_t)*line) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Finds the signature block at the end of the given script.
+ *
+ * @param[in] data - file content
+ * @param[in] start - start offset of the text after the BOM
+ * @param[in] len - file size in bytes
+ * @param[in] enc - text encoding
+ * @return end offset of the text without signature block and the line break before it
+ */
+static size_t fdigestPs1Block(const uint8_t * data, const size_t start, const size_t len, const tFdigestEncoding enc) {
+	const size_t unit = (enc == FDIGEST_UTF8) ? 1 : 2;
+	const size_t lineLen = (sizeof(FDIGEST_PS1_BEGIN) - 1) * unit;
+	if ((len - start) < lineLen) {
+		return len;
+	}
+	/* search backwards as the block is the last part of the file */
+	for (size_t pos = start + (((len - start - lineLen) / unit) * unit); ; pos -= unit) {
+		const bool lineStart = pos == start || fdigestPs1Unit(data, pos - unit, enc) == '\n';
+		if (lineStart && fdigestPs1Match(data, pos, len, enc, FDIGEST_PS1_BEGIN)) {
+			bool found = false;
+			for (size_t i = pos + lineLen; ( ! found ) && (len - i) >= unit; i += unit) {
+				found = fdigestPs1Unit(data, i - unit, enc) == '\n' && fdigestPs1Match(data, i, len, enc, FDIGEST_PS1_END);
+			}
+			if ( ! found ) {
+				return len;
+			}
+			if (pos > start && fdigestPs1Unit(data, pos - unit, enc) == '\n') {
+				pos -= unit;
+				if (pos > start && fdigestPs1Unit(data, pos - unit, enc) == '\r') {
+					pos -= unit;
+				}
+			}
+			return pos;
+		}
+		if (pos < (start + unit)) {
+			break;
+		}
+	}
+	return len;
+}
+
+
+/**
+ * Decodes a single strictly valid UTF-8 sequence.
+ *
+ * @param[in] p - input bytes
+ * @param[in] n - number of input bytes
+ * @param[out] cp - receives the code point
+ * @return sequence length or 0 if invalid
+ */
+static size_t fdigestUtf8(const uint8_t * p, const size_t n, uint32_t * cp) {
+	const uint8_t b = p[0];
+	size_t len;
+	uint8_t lo = 0x80, hi = 0xBF;
+	if (b < 0x80) {
+		*cp = b;
+		return 1;
+	} else if (b >= 0xC2 && b <= 0xDF) {
+		len = 2;
+		*cp = b & 0x1F;
+	} else if (b >= 0xE0 && b <= 0xEF) {
+		len = 3;
+		*cp = b & 0x0F;
+		if (b == 0xE0) {
+			lo = 0xA0; /* overlong */
+		} else if (b == 0xED) {
+			hi = 0x9F; /* surrogates */
+		}
+	} else if (b >= 0xF0 && b <= 0xF4) {
+		len = 4;
+		*cp = b & 0x07;
+		if (b == 0xF0) {
+			lo = 0x90; /* overlong */
+		} else if (b == 0xF4) {
+			hi = 0x8F; /* above U+10FFFF */
+		}
+	} else {
+		return 0;
+	}
+	if (n < len || p[1] < lo || p[1] > hi) {
+		return 0;
+	}
+	for (size_t i = 1; i < len; ++i) {
+		if ((p[i] & 0xC0) != 0x80) {
+			return 0;
+		}
+		*cp = (*cp << 6) | (uint32_t)(p[i] & 0x3F);
+	}
+	return len;
+}
+
+
+/**
+ * Hashes a PowerShell script as UTF-16LE text without signature block.
+ *
+ * @param[in,out] sha - hashing context
+ * @param[in] data - file content
+ * @param[in] len - file size in bytes
+ * @param[out] flags - result flags
+ * @return `true` on success, else `false` on allocation error
+ */
+static bool fdigestPs1(tSha256 * sha, const uint8_t * data, const size_t len, unsigned * flags) {
+	tFdigestEncoding enc = FDIGEST_UTF8;
+	size_t pos = 0;
+	if (len >= 2 && data[0] == 0xFF && data[1] == 0xFE) {
+		enc = FDIGEST_UTF16LE;
+		pos = 2;
+	} else if (len >= 2 && data[0] == 0xFE && data[1] == 0xFF) {
+		enc = FDIGEST_UTF16BE;
+		pos = 2;
+	} else if (len >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+		pos = 3;
+	}
+	const size_t end = fdigestPs1Block(data, pos, len, enc);
+	if (end < len) {
+		*flags |= FDIGEST_SIGNED;
+	}
+	uint8_t * buf = (uint8_t *)malloc(FDIGEST_PS1_BUF);
+	if (buf == NULL) {
+		return false;
+	}
+	size_t n = 0;
+	while (pos < end) {
+		uint32_t cp;
+		if (enc == FDIGEST_UTF8) {
+			const size_t seq = fdigestUtf8(data + pos, end - pos, &cp);
+			if (seq == 0) {
+				/* keep invalid bytes distinguishable */
+				cp = 0xDC00 | data[pos];
+				++pos;
+			} else {
+				pos += seq;
+			}
+		} else if ((end - pos) < 2) {
+			cp = 0xDC00 | data[pos];
+			++pos;
+		} else {
+			cp = fdigestPs1Unit(data, pos, enc);
+			pos += 2;
+		}
+		if (cp > 0xFFFF) {
+			const uint32_t hi = 0xD800 | ((cp - 0x10000) >> 10);
+			buf[n++] = (uint8_t)hi;
+			buf[n++] = (uint8_t)(hi >> 8);
+			cp = 0xDC00 | (cp & 0x3FF);
+		}
+		buf[n++] = (uint8_t)cp;
+		buf[n++] = (uint8_t)(cp >> 8);
+		if (n > (FDIGEST_PS1_BUF - 4)) {
+			sha256Update(sha, buf, n);
+			n = 0;
+		}
+	}
+	sha256Update(sha, buf, n);
+	free(buf);
+	return true;
+}
+
+
+/**
+ * Computes the SHA-256 digest of the given file content according to its
+ * format.
+ *
+ * @param[in] format - file format
+ * @param[in] data - file content (may be `NULL` if `len` is 0)
+ * @param[in] len - file size in bytes
+ * @param[out] digest - receives `SHA256_SIZE` bytes
+ * @param[out] flags - receives the result flags (e.g. `FDIGEST_SIGNED`) or `NULL`
+ * @return `true` on success, else `false` if the content does not match the format
+ */
+bool fdigest_compute(const tFileDigestFormat format, const uint8_t * data, const size_t len, uint8_t * digest, unsigned * flags) {
+	static const uint8_t empty[1] = {0};
+	unsigned resFlags = 0;
+	tSha256 sha;
+	bool res;
+	if ((data == NULL && len > 0) || digest == NULL) {
+		return false;
+	}
+	if (data == NULL) {
+		data = empty;
+	}
+	sha256Init(&sha);
+	switch (format) {
+	case FDF_RAW:
+		fdigestRange(&sha, data, 0, len);
+		res = true;
+		break;
+	case FDF_PE: res = fdigestPe(&sha, data, len, &resFlags); break;
+	case FDF_MSI: res = fdigestMsi(&sha, data, len, &resFlags); break;
+	case FDF_CAB: res = fdigestCab(&sha, data, len, &resFlags); break;
+	case FDF_PS1: res = fdigestPs1(&sha, data, len, &resFlags); break;
+	default: res = false; break;
+	}
+	if ( res ) {
+		sha256Final(&sha, digest);
+		if (flags != NULL) {
+			*flags = resFlags;
+		}
+	}
+	return res;
+}
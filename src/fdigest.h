@@ -0,0 +1,55 @@
+/**
+ * @file fdigest.h
+ * @author Daniel Starke
+ * @see fdigest.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __FDIGEST_H__
+#define __FDIGEST_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sha256.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Result flag set if the file contains an embedded signature.
+ */
+#define FDIGEST_SIGNED 1
+
+
+/**
+ * Maximum storage nesting level within OLE compound documents.
+ */
+#define FDIGEST_MAX_DEPTH 32
+
+
+/**
+ * Supported file formats. The digest of the signable formats excludes the
+ * embedded signature. It remains the same if a file is signed again.
+ */
+typedef enum {
+	FDF_RAW, /**< whole file content */
+	FDF_PE, /**< PE image without checksum, certificate table entry and certificate table */
+	FDF_MSI, /**< OLE compound document streams in name order without signature streams */
+	FDF_CAB, /**< cabinet without signature reserve fields and signature */
+	FDF_PS1 /**< PowerShell script text as UTF-16LE without signature block */
+} tFileDigestFormat;
+
+
+bool fdigest_compute(const tFileDigestFormat format, const uint8_t * data, const size_t len, uint8_t * digest, unsigned * flags);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __FDIGEST_H__ */
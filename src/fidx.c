@@ -0,0 +1,506 @@
+/**
+ * @file fidx.c
+ * @author Daniel Starke
+ * @see fidx.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Persistent file identity index for incremental directory tree scans. The
+ * serialized form starts with `FIDX_MAGIC` followed by the volume, root,
+ * journal, journal position and entry count. Each entry consists of its
+ * identifier, parent identifier, flags, size, time, name length and name
+ * characters followed by the raw digest if `FIDX_DIGEST` is set. All numbers
+ * are encoded as unsigned LEB128 variable length integers. The CRC-32 of all
+ * previous bytes follows in little endian order.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "crc32.h"
+#include "fidx.h"
+
+
+/**
+ * Flags which are persisted.
+ */
+#define FIDX_PERSISTENT_FLAGS (FIDX_DIR | FIDX_SIGNED | FIDX_DIGEST)
+
+
+/**
+ * Maximum encoded size of a single number in bytes.
+ */
+#define FIDX_MAX_VAR_SIZE 10
+
+
+/**
+ * Writes the given unsigned number as variable length integer.
+ *
+ * @param[in,out] buf - output buffer
+ * @param[in] value - value to write
+ * @return number of bytes written
+ */
+static size_t fidx_putVar(uint8_t * buf, uint64_t value) {
+	size_t n = 0;
+	while (value >= 0x80) {
+		buf[n++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	buf[n++] = (uint8_t)value;
+	return n;
+}
+
+
+/**
+ * Reads a variable length integer.
+ *
+ * @param[in] buf - input buffer
+ * @param[in] len - number of bytes in `buf`
+ * @param[in,out] pos - current read position; updated on success
+ * @param[out] value - receives the read value
+ * @return `true` on success, else `false` if incomplete or invalid
+ */
+static bool fidx_getVar(const uint8_t * buf, const size_t len, size_t * pos, uint64_t * value) {
+	uint64_t res = 0;
+	for (size_t n = 0; (*pos + n) < len && n < FIDX_MAX_VAR_SIZE; ++n) {
+		const uint8_t b = buf[*pos + n];
+		res |= (uint64_t)(b & 0x7F) << (7 * n);
+		if ((b & 0x80) == 0) {
+			*value = res;
+			*pos += n + 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Returns the home slot of the given file identifier.
+ *
+ * @param[in] idx - index
+ * @param[in] id - file identifier
+ * @return slot index
+ */
+static size_t fidx_home(const tFileIdx * idx, const uint64_t id) {
+	/* Fibonacci hashing; the identifiers are often sequential */
+	return (size_t)((id * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (idx->capacity - 1);
+}
+
+
+/**
+ * Returns the slot index of the given file identifier.
+ *
+ * @param[in] idx - index
+ * @param[in] id - file identifier
+ * @return slot index or `SIZE_MAX` if not found
+ */
+static size_t fidx_find(const tFileIdx * idx, const uint64_t id) {
+	if (idx->capacity == 0 || id == 0) {
+		return SIZE_MAX;
+	}
+	const size_t mask = idx->capacity - 1;
+	for (size_t i = fidx_home(idx, id); idx->slots[i].id != 0; i = (i + 1) & mask) {
+		if (idx->slots[i].id == id) {
+			return i;
+		}
+	}
+	return SIZE_MAX;
+}
+
+
+/**
+ * Resizes the hash table to the given capacity.
+ *
+ * @param[in,out] idx - index
+ * @param[in] capacity - new capacity (power of two larger than `idx->count`)
+ * @return `true` on success, else `false`
+ */
+static bool fidx_rehash(tFileIdx * idx, const size_t capacity) {
+	tFileIdxEntry * slots = calloc(capacity, sizeof(tFileIdxEntry));
+	if (slots == NULL) {
+		return false;
+	}
+	tFileIdxEntry * oldSlots = idx->slots;
+	const size_t oldCapacity = idx->capacity;
+	idx->slots = slots;
+	idx->capacity = capacity;
+	const size_t mask = capacity - 1;
+	for (size_t i = 0; i < oldCapacity; ++i) {
+		if (oldSlots[i].id == 0) {
+			continue;
+		}
+		size_t j = fidx_home(idx, oldSlots[i].id);
+		while (slots[j].id != 0) {
+			j = (j + 1) & mask;
+		}
+		slots[j] = oldSlots[i];
+	}
+	free(oldSlots);
+	return true;
+}
+
+
+/**
+ * Creates a new empty file identity index.
+ *
+ * @return new index or `NULL` on allocation error
+ */
+tFileIdx * fidx_create(void) {
+	return calloc(1, sizeof(tFileIdx));
+}
+
+
+/**
+ * Removes all entries and resets the header fields of the given index.
+ *
+ * @param[in,out] idx - index
+ */
+void fidx_clear(tFileIdx * idx) {
+	if (idx == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < idx->capacity; ++i) {
+		if (idx->slots[i].id != 0) {
+			free(idx->slots[i].name);
+		}
+	}
+	free(idx->slots);
+	memset(idx, 0, sizeof(*idx));
+}
+
+
+/**
+ * Deletes the given index.
+ *
+ * @param[in,out] idx - index
+ */
+void fidx_delete(tFileIdx * idx) {
+	if (idx == NULL) {
+		return;
+	}
+	fidx_clear(idx);
+	free(idx);
+}
+
+
+/**
+ * Returns the entry with the given file identifier.
+ *
+ * @param[in] idx - index
+ * @param[in] id - file identifier
+ * @return entry or `NULL` if not found
+ * @remarks The returned pointer is invalidated by `fidx_put()` and `fidx_remove()`.
+ */
+tFileIdxEntry * fidx_get(const tFileIdx * idx, const uint64_t id) {
+	if (idx == NULL) {
+		return NULL;
+	}
+	const size_t i = fidx_find(idx, id);
+	return (i != SIZE_MAX) ? idx->slots + i : NULL;
+}
+
+
+/**
+ * Adds or updates the entry with the given file identifier. The entry is marked
+ * as seen by the current walk generation. Size, time and the signed state of
+ * existing entries are kept.
+ *
+ * @param[in,out] idx - index
+ * @param[in] id - file identifier (not 0)
+ * @param[in] parent - file identifier of the parent directory
+ * @param[in] name - file name
+ * @param[in] nameLen - length of `name` in number of characters
+ * @param[in] flags - flags to set
+ * @return entry or `NULL` on error
+ * @remarks The returned pointer is invalidated by `fidx_put()` and `fidx_remove()`.
+ */
+tFileIdxEntry * fidx_put(tFileIdx * idx, const uint64_t id, const uint64_t parent, const wchar_t * name, const size_t nameLen, const uint32_t flags) {
+	if (idx == NULL || id == 0 || name == NULL) {
+		return NULL;
+	}
+	size_t i = fidx_find(idx, id);
+	if (i == SIZE_MAX) {
+		if (((idx->count + 1) * 4) > (idx->capacity * 3) && ( ! fidx_rehash(idx, (idx->capacity > 0) ? idx->capacity * 2 : 64) )) {
+			return NULL;
+		}
+		const size_t mask = idx->capacity - 1;
+		for (i = fidx_home(idx, id); idx->slots[i].id != 0; i = (i + 1) & mask);
+		tFileIdxEntry * e = idx->slots + i;
+		e->name = malloc((nameLen + 1) * sizeof(wchar_t));
+		if (e->name == NULL) {
+			return NULL;
+		}
+		memcpy(e->name, name, nameLen * sizeof(wchar_t));
+		e->name[nameLen] = 0;
+		e->id = id;
+		e->parent = parent;
+		e->size = 0;
+		e->time = 0;
+		e->flags = flags;
+		e->mark = idx->mark;
+		memset(e->digest, 0, sizeof(e->digest));
+		++(idx->count);
+		return e;
+	}
+	tFileIdxEntry * e = idx->slots + i;
+	if (wcsncmp(e->name, name, nameLen) != 0 || e->name[nameLen] != 0) {
+		wchar_t * newName = malloc((nameLen + 1) * sizeof(wchar_t));
+		if (newName == NULL) {
+			return NULL;
+		}
+		memcpy(newName, name, nameLen * sizeof(wchar_t));
+		newName[nameLen] = 0;
+		free(e->name);
+		e->name = newName;
+	}
+	e->parent = parent;
+	e->flags |= flags;
+	e->mark = idx->mark;
+	return e;
+}
+
+
+/**
+ * Removes the entry with the given file identifier. Entries within a removed
+ * directory are kept but their path can no longer be resolved until the
+ * directory is added again or they are removed by `fidx_sweep()`.
+ *
+ * @param[in,out] idx - index
+ * @param[in] id - file identifier
+ * @return `true` if removed, else `false` if not found
+ */
+bool fidx_remove(tFileIdx * idx, const uint64_t id) {
+	if (idx == NULL) {
+		return false;
+	}
+	size_t i = fidx_find(idx, id);
+	if (i == SIZE_MAX) {
+		return false;
+	}
+	free(idx->slots[i].name);
+	/* backward shift deletion keeps all probe sequences intact without tombstones */
+	const size_t mask = idx->capacity - 1;
+	for (size_t j = (i + 1) & mask; idx->slots[j].id != 0; j = (j + 1) & mask) {
+		const size_t k = fidx_home(idx, idx->slots[j].id);
+		const bool movable = (j > i) ? (k <= i || k > j) : (k <= i && k > j);
+		if ( movable ) {
+			idx->slots[i] = idx->slots[j];
+			i = j;
+		}
+	}
+	memset(idx->slots + i, 0, sizeof(tFileIdxEntry));
+	--(idx->count);
+	return true;
+}
+
+
+/**
+ * Removes all entries which were not seen by the current walk generation. A
+ * new generation is started by incrementing `idx->mark` before the walk.
+ *
+ * @param[in,out] idx - index
+ * @return number of removed entries
+ */
+size_t fidx_sweep(tFileIdx * idx) {
+	if (idx == NULL) {
+		return 0;
+	}
+	size_t res = 0;
+	for (size_t i = 0; i < idx->capacity; ++i) {
+		/* removal may move another entry into this slot */
+		while (idx->slots[i].id != 0 && idx->slots[i].mark != idx->mark) {
+			fidx_remove(idx, idx->slots[i].id);
+			++res;
+		}
+	}
+	return res;
+}
+
+
+/**
+ * Resolves the path of the given entry relative to the root directory.
+ *
+ * @param[in] idx - index
+ * @param[in] entry - entry to resolve
+ * @param[in] sep - path separator
+ * @param[out] buf - output buffer
+ * @param[in] len - size of `buf` in number of characters
+ * @return path length in number of characters without null-terminator or 0 if
+ * the path could not be resolved or does not fit into `buf`
+ */
+size_t fidx_path(const tFileIdx * idx, const tFileIdxEntry * entry, const wchar_t sep, wchar_t * buf, const size_t len) {
+	if (idx == NULL || entry == NULL || buf == NULL || len == 0) {
+		return 0;
+	}
+	const tFileIdxEntry * chain[FIDX_MAX_DEPTH];
+	size_t depth = 0;
+	size_t total = 0;
+	for (const tFileIdxEntry * e = entry; ; e = fidx_get(idx, e->parent)) {
+		if (e == NULL || depth >= FIDX_MAX_DEPTH) {
+			return 0;
+		}
+		chain[depth++] = e;
+		total += wcslen(e->name) + 1;
+		if (e->parent == idx->root) {
+			break;
+		}
+	}
+	if (total > len) {
+		return 0;
+	}
+	size_t pos = 0;
+	while (depth-- > 0) {
+		const size_t n = wcslen(chain[depth]->name);
+		memcpy(buf + pos, chain[depth]->name, n * sizeof(wchar_t));
+		pos += n;
+		buf[pos++] = (depth > 0) ? sep : 0;
+	}
+	return pos - 1;
+}
+
+
+/**
+ * Checks whether the given file changed since it was signed successfully.
+ *
+ * @param[in] entry - entry to check
+ * @param[in] size - current file size in bytes
+ * @param[in] time - current last modification time
+ * @return `true` if changed or never signed, else `false`
+ */
+bool fidx_changed(const tFileIdxEntry * entry, const uint64_t size, const uint64_t time) {
+	if (entry == NULL || (entry->flags & FIDX_SIGNED) == 0) {
+		return true;
+	}
+	return entry->size != size || entry->time != time;
+}
+
+
+/**
+ * Serializes the given index.
+ *
+ * @param[in] idx - index
+ * @param[out] len - receives the number of bytes in the returned buffer
+ * @return new buffer (to be freed by the caller) or `NULL` on allocation error
+ */
+uint8_t * fidx_save(const tFileIdx * idx, size_t * len) {
+	if (idx == NULL || len == NULL) {
+		return NULL;
+	}
+	size_t size = sizeof(FIDX_MAGIC) - 1 + (5 * FIDX_MAX_VAR_SIZE) + 4;
+	for (size_t i = 0; i < idx->capacity; ++i) {
+		if (idx->slots[i].id != 0) {
+			size += (6 * FIDX_MAX_VAR_SIZE) + (wcslen(idx->slots[i].name) * 5) + FIDX_DIGEST_SIZE;
+		}
+	}
+	uint8_t * buf = malloc(size);
+	if (buf == NULL) {
+		return NULL;
+	}
+	size_t pos = sizeof(FIDX_MAGIC) - 1;
+	memcpy(buf, FIDX_MAGIC, pos);
+	pos += fidx_putVar(buf + pos, idx->volume);
+	pos += fidx_putVar(buf + pos, idx->root);
+	pos += fidx_putVar(buf + pos, idx->journal);
+	pos += fidx_putVar(buf + pos, idx->usn);
+	pos += fidx_putVar(buf + pos, (uint64_t)(idx->count));
+	for (size_t i = 0; i < idx->capacity; ++i) {
+		const tFileIdxEntry * e = idx->slots + i;
+		if (e->id == 0) {
+			continue;
+		}
+		const size_t nameLen = wcslen(e->name);
+		pos += fidx_putVar(buf + pos, e->id);
+		pos += fidx_putVar(buf + pos, e->parent);
+		pos += fidx_putVar(buf + pos, (uint64_t)(e->flags & FIDX_PERSISTENT_FLAGS));
+		pos += fidx_putVar(buf + pos, e->size);
+		pos += fidx_putVar(buf + pos, e->time);
+		pos += fidx_putVar(buf + pos, (uint64_t)nameLen);
+		for (size_t n = 0; n < nameLen; ++n) {
+			pos += fidx_putVar(buf + pos, (uint64_t)(e->name[n]));
+		}
+		if ((e->flags & FIDX_DIGEST) != 0) {
+			memcpy(buf + pos, e->digest, FIDX_DIGEST_SIZE);
+			pos += FIDX_DIGEST_SIZE;
+		}
+	}
+	const uint32_t crc = crc32Update(UINT32_MAX, buf, pos) ^ UINT32_MAX;
+	for (size_t n = 0; n < 4; ++n) {
+		buf[pos++] = (uint8_t)(crc >> (8 * n));
+	}
+	*len = pos;
+	return buf;
+}
+
+
+/**
+ * Replaces the content of the given index with the serialized index. The
+ * index is left empty on error.
+ *
+ * @param[in,out] idx - index
+ * @param[in] buf - serialized index
+ * @param[in] len - number of bytes in `buf`
+ * @return `true` on success, else `false` on invalid data or allocation error
+ */
+bool fidx_load(tFileIdx * idx, const uint8_t * buf, const size_t len) {
+	if (idx == NULL) {
+		return false;
+	}
+	fidx_clear(idx);
+	const size_t magicLen = sizeof(FIDX_MAGIC) - 1;
+	if (buf == NULL || len < (magicLen + 4) || memcmp(buf, FIDX_MAGIC, magicLen) != 0) {
+		return false;
+	}
+	const size_t end = len - 4;
+	uint32_t crc = 0;
+	for (size_t n = 0; n < 4; ++n) {
+		crc |= (uint32_t)(buf[end + n]) << (8 * n);
+	}
+	if ((crc32Update(UINT32_MAX, buf, end) ^ UINT32_MAX) != crc) {
+		return false;
+	}
+	size_t pos = magicLen;
+	uint64_t count = 0;
+	if (( ! fidx_getVar(buf, end, &pos, &(idx->volume)) ) || ( ! fidx_getVar(buf, end, &pos, &(idx->root)) ) || ( ! fidx_getVar(buf, end, &pos, &(idx->journal)) ) || ( ! fidx_getVar(buf, end, &pos, &(idx->usn)) ) || ( ! fidx_getVar(buf, end, &pos, &count) ) || count > (end - pos)) {
+		fidx_clear(idx);
+		return false;
+	}
+	wchar_t * name = NULL;
+	size_t nameCap = 0;
+	bool res = true;
+	for (uint64_t i = 0; i < count && res; ++i) {
+		uint64_t id = 0, parent = 0, flags = 0, size = 0, time = 0, nameLen = 0;
+		res = fidx_getVar(buf, end, &pos, &id) && fidx_getVar(buf, end, &pos, &parent) && fidx_getVar(buf, end, &pos, &flags) && fidx_getVar(buf, end, &pos, &size) && fidx_getVar(buf, end, &pos, &time) && fidx_getVar(buf, end, &pos, &nameLen) && nameLen <= (end - pos);
+		if (res && (size_t)nameLen >= nameCap) {
+			wchar_t * newName = realloc(name, ((size_t)nameLen + 1) * sizeof(wchar_t));
+			res = newName != NULL;
+			if ( res ) {
+				name = newName;
+				nameCap = (size_t)nameLen + 1;
+			}
+		}
+		for (uint64_t n = 0; n < nameLen && res; ++n) {
+			uint64_t ch;
+			res = fidx_getVar(buf, end, &pos, &ch) && ch <= WCHAR_MAX;
+			name[n] = res ? (wchar_t)ch : 0;
+		}
+		const bool hasDigest = (flags & FIDX_DIGEST) != 0;
+		res = res && (( ! hasDigest ) || FIDX_DIGEST_SIZE <= (end - pos));
+		if ( res ) {
+			tFileIdxEntry * e = fidx_put(idx, id, parent, name, (size_t)nameLen, (uint32_t)(flags & FIDX_PERSISTENT_FLAGS));
+			res = e != NULL;
+			if ( res ) {
+				e->size = size;
+				e->time = time;
+				if ( hasDigest ) {
+					memcpy(e->digest, buf + pos, FIDX_DIGEST_SIZE);
+					pos += FIDX_DIGEST_SIZE;
+				}
+			}
+		}
+	}
+	free(name);
+	if (( ! res ) || pos != end) {
+		fidx_clear(idx);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file fidx.h
+ * @author Daniel Starke
+ * @see fidx.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __FIDX_H__
+#define __FIDX_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * File identity index file magic.
+ */
+#define FIDX_MAGIC "SIGUWII1"
+
+
+/**
+ * Maximum directory depth resolved by `fidx_path()`.
+ */
+#define FIDX_MAX_DEPTH 1024
+
+
+/**
+ * Size of the recorded file content digest in bytes.
+ */
+#define FIDX_DIGEST_SIZE 32
+
+
+/**
+ * File identity index entry flags.
+ */
+typedef enum {
+	FIDX_DIR = 1, /**< entry is a directory */
+	FIDX_SIGNED = 2, /**< `size` and `time` hold the state after the last successful signing */
+	FIDX_CANDIDATE = 4, /**< entry needs to be checked (not persisted) */
+	FIDX_QUEUED = 8, /**< file is queued for signing (not persisted) */
+	FIDX_DIGEST = 16 /**< `digest` holds the content digest of the signed file */
+} tFileIdxFlag;
+
+
+/**
+ * Single file identity index entry.
+ */
+typedef struct {
+	uint64_t id; /**< file identifier (0 for an empty slot) */
+	uint64_t parent; /**< file identifier of the parent directory */
+	uint64_t size; /**< file size in bytes */
+	uint64_t time; /**< last modification time */
+	wchar_t * name; /**< file name */
+	uint32_t flags; /**< combination of `tFileIdxFlag` */
+	uint32_t mark; /**< walk generation which saw this entry last */
+	uint8_t digest[FIDX_DIGEST_SIZE]; /**< content digest after the last successful signing */
+} tFileIdxEntry;
+
+
+/**
+ * File identity index of a directory tree. Entries are stored in an open
+ * addressing hash table keyed by their file identifier. The path of an entry
+ * is given by the chain of parent directories up to `root`.
+ */
+typedef struct {
+	uint64_t volume; /**< volume identifier */
+	uint64_t root; /**< file identifier of the root directory */
+	uint64_t journal; /**< change journal identifier or 0 */
+	uint64_t usn; /**< next change journal position to read */
+	uint32_t mark; /**< current walk generation */
+	size_t count; /**< number of entries */
+	size_t capacity; /**< number of slots (power of two or 0) */
+	tFileIdxEntry * slots; /**< hash table slots */
+} tFileIdx;
+
+
+tFileIdx * fidx_create(void);
+void fidx_clear(tFileIdx * idx);
+void fidx_delete(tFileIdx * idx);
+tFileIdxEntry * fidx_get(const tFileIdx * idx, const uint64_t id);
+tFileIdxEntry * fidx_put(tFileIdx * idx, const uint64_t id, const uint64_t parent, const wchar_t * name, const size_t nameLen, const uint32_t flags);
+bool fidx_remove(tFileIdx * idx, const uint64_t id);
+size_t fidx_sweep(tFileIdx * idx);
+size_t fidx_path(const tFileIdx * idx, const tFileIdxEntry * entry, const wchar_t sep, wchar_t * buf, const size_t len);
+bool fidx_changed(const tFileIdxEntry * entry, const uint64_t size, const uint64_t time);
+uint8_t * fidx_save(const tFileIdx * idx, size_t * len);
+bool fidx_load(tFileIdx * idx, const uint8_t * buf, const size_t len);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __FIDX_H__ */
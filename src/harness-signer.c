@@ -0,0 +1,502 @@
+/**
+ * @file harness-signer.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Fake signing application for the end-to-end throughput harness. It can be
+ * used as `signApp` in place of osslsigncode. The PIN is read from the
+ * standard input, the signing latency follows a configurable distribution and
+ * a configurable amount of progress output is written in chunks spread over
+ * that latency. Nothing is signed.
+ */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "target.h"
+#ifdef PCF_IS_WIN
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else /* not PCF_IS_WIN */
+#include <unistd.h>
+#endif /* not PCF_IS_WIN */
+
+
+/**
+ * Maximum PIN length in bytes.
+ */
+#define SIGNER_MAX_PIN 256
+
+
+/**
+ * Exit code for a simulated signing failure.
+ */
+#define SIGNER_EXIT_FAIL 1
+
+
+/**
+ * Exit code for a wrong or missing PIN.
+ */
+#define SIGNER_EXIT_PIN 2
+
+
+/**
+ * Exit code for invalid command-line arguments.
+ */
+#define SIGNER_EXIT_USAGE 3
+
+
+/**
+ * Latency distributions.
+ */
+typedef enum {
+	SLD_FIXED, /**< always `a` milliseconds */
+	SLD_UNIFORM, /**< uniform within [`a`, `b`] milliseconds */
+	SLD_EXP, /**< exponential with a mean of `a` milliseconds */
+	SLD_LOGNORMAL /**< log-normal with a median of `a` milliseconds and the shape `b` */
+} tSignerDist;
+
+
+/**
+ * Output encodings.
+ */
+typedef enum {
+	SOE_ASCII, /**< 7-bit ASCII only */
+	SOE_UTF8, /**< UTF-8 with multi-byte characters */
+	SOE_LATIN1, /**< ISO-8859-1 as produced by applications using the ANSI code page */
+	SOE_UTF16 /**< UTF-16 little endian */
+} tSignerEnc;
+
+
+/**
+ * Fake signer configuration.
+ */
+typedef struct {
+	tSignerDist dist;
+	double a;
+	double b;
+	size_t bytes; /**< total output volume in bytes */
+	size_t chunk; /**< output chunk size in bytes */
+	tSignerEnc enc;
+	double failRate; /**< probability of a failure within [0, 1] */
+	const char * pin; /**< expected PIN or `NULL` to accept any non-empty PIN */
+	uint64_t seed;
+} tSignerConfig;
+
+
+/**
+ * Random number generator state (xorshift64*).
+ */
+static uint64_t signerRng = 0;
+
+
+/**
+ * Returns the next uniformly distributed random number in [0, 1).
+ *
+ * @return random number
+ */
+static double signerRand(void) {
+	signerRng ^= signerRng >> 12;
+	signerRng ^= signerRng << 25;
+	signerRng ^= signerRng >> 27;
+	return (double)((signerRng * UINT64_C(2685821657736338717)) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+/**
+ * Returns the next standard normal distributed random number.
+ *
+ * @return random number
+ */
+static double signerRandNormal(void) {
+	/* Box-Muller transformation */
+	const double u1 = 1.0 - signerRand(); /* (0, 1] */
+	const double u2 = signerRand();
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * 3.14159265358979323846 * u2);
+}
+
+
+/**
+ * Returns a random signing latency according to the given configuration.
+ *
+ * @param[in] c - configuration
+ * @return latency in milliseconds
+ */
+static double signerLatency(const tSignerConfig * c) {
+	double res = 0.0;
+	switch (c->dist) {
+	case SLD_FIXED:
+		res = c->a;
+		break;
+	case SLD_UNIFORM:
+		res = c->a + ((c->b - c->a) * signerRand());
+		break;
+	case SLD_EXP:
+		res = -c->a * log(1.0 - signerRand());
+		break;
+	case SLD_LOGNORMAL:
+		res = c->a * exp(c->b * signerRandNormal());
+		break;
+	}
+	return (res > 0.0) ? res : 0.0;
+}
+
+
+/**
+ * Sleeps for the given duration.
+ *
+ * @param[in] ms - duration in milliseconds
+ */
+static void signerSleep(const double ms) {
+	if (ms <= 0.0) {
+		return;
+	}
+#ifdef PCF_IS_WIN
+	Sleep((DWORD)(ms + 0.5));
+#else /* not PCF_IS_WIN */
+	struct timespec ts;
+	ts.tv_sec = (time_t)(ms / 1000.0);
+	ts.tv_nsec = (long)((ms - ((double)(ts.tv_sec) * 1000.0)) * 1000000.0);
+	while (nanosleep(&ts, &ts) != 0);
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Appends the given Unicode code point in the configured encoding.
+ *
+ * @param[in,out] buf - output buffer
+ * @param[in,out] len - number of bytes in `buf`
+ * @param[in] enc - output encoding
+ * @param[in] cp - Unicode code point from the Basic Multilingual Plane
+ * @remarks `buf` needs to have room for at least 3 more bytes.
+ */
+static void signerPutChar(uint8_t * buf, size_t * len, const tSignerEnc enc, const uint32_t cp) {
+	switch (enc) {
+	case SOE_ASCII:
+		buf[(*len)++] = (uint8_t)((cp < 0x80) ? cp : '?');
+		break;
+	case SOE_UTF8:
+		if (cp < 0x80) {
+			buf[(*len)++] = (uint8_t)cp;
+		} else if (cp < 0x800) {
+			buf[(*len)++] = (uint8_t)(0xC0 | (cp >> 6));
+			buf[(*len)++] = (uint8_t)(0x80 | (cp & 0x3F));
+		} else {
+			buf[(*len)++] = (uint8_t)(0xE0 | (cp >> 12));
+			buf[(*len)++] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+			buf[(*len)++] = (uint8_t)(0x80 | (cp & 0x3F));
+		}
+		break;
+	case SOE_LATIN1:
+		buf[(*len)++] = (uint8_t)((cp < 0x100) ? cp : '?');
+		break;
+	case SOE_UTF16:
+		buf[(*len)++] = (uint8_t)(cp & 0xFF);
+		buf[(*len)++] = (uint8_t)(cp >> 8);
+		break;
+	}
+}
+
+
+/**
+ * Creates the progress output for the given file. The line layout resembles
+ * the one of osslsigncode with filler characters to reach the configured
+ * output volume.
+ *
+ * @param[in] c - configuration
+ * @param[in] path - file to sign
+ * @param[in] ok - create the output of a successful run?
+ * @param[out] len - receives the output size in bytes
+ * @return allocated output buffer or `NULL` on allocation error
+ */
+static uint8_t * signerOutput(const tSignerConfig * c, const char * path, const bool ok, size_t * len) {
+	static const uint32_t filler[] = {
+		'S', 'i', 'g', 'n', 'a', 't', 'u', 'r', 'e', ' ', 0xE4, 0xF6, 0xFC, ' ', 0x20AC, ' ', 0x2713, ' '
+	};
+	char head[64];
+	const char * const tail = ok ? "Succeeded\n" : "Failed: simulated signing error\n";
+	const size_t pathLen = strlen(path);
+	/* a line starts below `c->bytes` and has at most `lineMax` bytes */
+	const size_t lineMax = (2 * (sizeof(head) + pathLen + 3)) + (3 * 48);
+	uint8_t * buf = malloc(c->bytes + lineMax + (2 * strlen(tail)));
+	if (buf == NULL) {
+		return NULL;
+	}
+	size_t n = 0;
+	for (size_t line = 1; n < c->bytes; ++line) {
+		const int headLen = snprintf(head, sizeof(head), "[%zu] ", line);
+		for (int i = 0; i < headLen; ++i) {
+			signerPutChar(buf, &n, c->enc, (uint32_t)(uint8_t)(head[i]));
+		}
+		for (size_t i = 0; i < pathLen; ++i) {
+			signerPutChar(buf, &n, c->enc, (uint32_t)(uint8_t)(path[i]));
+		}
+		signerPutChar(buf, &n, c->enc, ':');
+		signerPutChar(buf, &n, c->enc, ' ');
+		for (size_t i = 0; i < 48 && n < c->bytes; ++i) {
+			signerPutChar(buf, &n, c->enc, filler[i % (sizeof(filler) / sizeof(*filler))]);
+		}
+		signerPutChar(buf, &n, c->enc, '\n');
+	}
+	for (const char * ptr = tail; *ptr != 0; ++ptr) {
+		signerPutChar(buf, &n, c->enc, (uint32_t)(uint8_t)(*ptr));
+	}
+	*len = n;
+	return buf;
+}
+
+
+/**
+ * Reads the PIN from the standard input. The signing application receives it
+ * without line break. Reading stops at the first line break or end of input.
+ *
+ * @param[out] buf - receives the null-terminated PIN
+ * @param[in] size - size of `buf` in bytes
+ * @return `true` if a non-empty PIN was read, else `false`
+ */
+static bool signerReadPin(char * buf, const size_t size) {
+	size_t n = 0;
+	int ch;
+	while ((n + 1) < size && (ch = fgetc(stdin)) != EOF && ch != '\n' && ch != '\r') {
+		buf[n++] = (char)ch;
+	}
+	buf[n] = 0;
+	return n > 0;
+}
+
+
+/**
+ * Parses the given latency distribution specification.
+ *
+ * @param[in] spec - specification in the format `name:a[:b]`
+ * @param[in,out] c - configuration to update
+ * @return `true` on success, else `false`
+ */
+static bool signerParseDist(const char * spec, tSignerConfig * c) {
+	static const struct {
+		const char * name;
+		tSignerDist dist;
+		int params;
+	} dists[] = {
+		{"fixed",     SLD_FIXED,     1},
+		{"uniform",   SLD_UNIFORM,   2},
+		{"exp",       SLD_EXP,       1},
+		{"lognormal", SLD_LOGNORMAL, 2}
+	};
+	const char * sep = strchr(spec, ':');
+	if (sep == NULL) {
+		return false;
+	}
+	for (size_t i = 0; i < (sizeof(dists) / sizeof(*dists)); ++i) {
+		if (strlen(dists[i].name) != (size_t)(sep - spec) || strncmp(spec, dists[i].name, (size_t)(sep - spec)) != 0) {
+			continue;
+		}
+		char * end = NULL;
+		c->dist = dists[i].dist;
+		c->a = strtod(sep + 1, &end);
+		if (end == sep + 1 || c->a < 0.0) {
+			return false;
+		}
+		c->b = 0.0;
+		if (dists[i].params > 1) {
+			if (*end != ':') {
+				return false;
+			}
+			const char * second = end + 1;
+			c->b = strtod(second, &end);
+			if (end == second || c->b < 0.0 || (c->dist == SLD_UNIFORM && c->b < c->a)) {
+				return false;
+			}
+		}
+		return *end == 0;
+	}
+	return false;
+}
+
+
+/**
+ * Parses the given unsigned number.
+ *
+ * @param[in] str - string to parse
+ * @param[out] value - receives the parsed value
+ * @return `true` on success, else `false`
+ */
+static bool signerParseSize(const char * str, size_t * value) {
+	char * end = NULL;
+	const unsigned long long res = strtoull(str, &end, 10);
+	if (end == str || *end != 0 || *str == '-') {
+		return false;
+	}
+	*value = (size_t)res;
+	return true;
+}
+
+
+/**
+ * Outputs the usage help.
+ *
+ * @param[in] name - program name
+ */
+static void signerHelp(const char * name) {
+	printf(
+		"%s [options] <file>\n"
+		"\n"
+		"Fake signing application for the siguwi throughput harness. Reads the PIN\n"
+		"from the standard input, waits for a random latency while writing progress\n"
+		"output and leaves the file unchanged.\n"
+		"\n"
+		"-b, --bytes <n>\n"
+		"      Output volume in bytes. Default: 256\n"
+		"-c, --chunk <n>\n"
+		"      Output chunk size in bytes. Default: 4096\n"
+		"-d, --delay <dist>\n"
+		"      Signing latency distribution in milliseconds. Default: fixed:0\n"
+		"      fixed:<ms>, uniform:<min>:<max>, exp:<mean>, lognormal:<median>:<sigma>\n"
+		"-e, --encoding <enc>\n"
+		"      Output encoding. One of ascii, utf8, latin1 and utf16. Default: utf8\n"
+		"-f, --fail <rate>\n"
+		"      Probability of a simulated signing failure within [0, 1]. Default: 0\n"
+		"-h, --help\n"
+		"      Print this usage text.\n"
+		"-p, --pin <pin>\n"
+		"      Expected PIN. Any non-empty PIN is accepted by default.\n"
+		"-s, --seed <n>\n"
+		"      Random number generator seed. Default: derived from time and process\n"
+		"\n"
+		"Exit codes: 0 success, %i simulated failure, %i PIN error, %i usage error\n",
+		name, SIGNER_EXIT_FAIL, SIGNER_EXIT_PIN, SIGNER_EXIT_USAGE
+	);
+}
+
+
+/**
+ * Main entry point.
+ *
+ * @param[in] argc - number of command-line arguments
+ * @param[in] argv - command-line arguments
+ * @return exit code
+ */
+int main(int argc, char ** argv) {
+	tSignerConfig c = {SLD_FIXED, 0.0, 0.0, 256, 4096, SOE_UTF8, 0.0, NULL, 0};
+	const char * path = NULL;
+	bool hasSeed = false;
+	for (int i = 1; i < argc; ++i) {
+		const char * arg = argv[i];
+		const char * value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+			signerHelp(argv[0]);
+			return EXIT_SUCCESS;
+		} else if (*arg != '-' && path == NULL) {
+			path = arg;
+			continue;
+		} else if (value == NULL) {
+			fprintf(stderr, "Error: Invalid or incomplete argument \"%s\".\n", arg);
+			return SIGNER_EXIT_USAGE;
+		} else if (strcmp(arg, "-b") == 0 || strcmp(arg, "--bytes") == 0) {
+			if ( ! signerParseSize(value, &(c.bytes)) ) {
+				fprintf(stderr, "Error: Invalid output volume \"%s\".\n", value);
+				return SIGNER_EXIT_USAGE;
+			}
+		} else if (strcmp(arg, "-c") == 0 || strcmp(arg, "--chunk") == 0) {
+			if ( ! signerParseSize(value, &(c.chunk)) || c.chunk == 0 ) {
+				fprintf(stderr, "Error: Invalid chunk size \"%s\".\n", value);
+				return SIGNER_EXIT_USAGE;
+			}
+		} else if (strcmp(arg, "-d") == 0 || strcmp(arg, "--delay") == 0) {
+			if ( ! signerParseDist(value, &c) ) {
+				fprintf(stderr, "Error: Invalid latency distribution \"%s\".\n", value);
+				return SIGNER_EXIT_USAGE;
+			}
+		} else if (strcmp(arg, "-e") == 0 || strcmp(arg, "--encoding") == 0) {
+			static const char * const encs[] = {"ascii", "utf8", "latin1", "utf16"};
+			size_t e = 0;
+			for (; e < (sizeof(encs) / sizeof(*encs)) && strcmp(value, encs[e]) != 0; ++e);
+			if (e >= (sizeof(encs) / sizeof(*encs))) {
+				fprintf(stderr, "Error: Invalid encoding \"%s\".\n", value);
+				return SIGNER_EXIT_USAGE;
+			}
+			c.enc = (tSignerEnc)e;
+		} else if (strcmp(arg, "-f") == 0 || strcmp(arg, "--fail") == 0) {
+			char * end = NULL;
+			c.failRate = strtod(value, &end);
+			if (end == value || *end != 0 || c.failRate < 0.0 || c.failRate > 1.0) {
+				fprintf(stderr, "Error: Invalid failure rate \"%s\".\n", value);
+				return SIGNER_EXIT_USAGE;
+			}
+		} else if (strcmp(arg, "-p") == 0 || strcmp(arg, "--pin") == 0) {
+			c.pin = value;
+		} else if (strcmp(arg, "-s") == 0 || strcmp(arg, "--seed") == 0) {
+			size_t seed;
+			if ( ! signerParseSize(value, &seed) ) {
+				fprintf(stderr, "Error: Invalid seed \"%s\".\n", value);
+				return SIGNER_EXIT_USAGE;
+			}
+			c.seed = (uint64_t)seed;
+			hasSeed = true;
+		} else {
+			fprintf(stderr, "Error: Invalid or incomplete argument \"%s\".\n", arg);
+			return SIGNER_EXIT_USAGE;
+		}
+		++i;
+	}
+	if (path == NULL) {
+		fprintf(stderr, "Error: Missing file argument.\n");
+		return SIGNER_EXIT_USAGE;
+	}
+#ifdef PCF_IS_WIN
+	_setmode(_fileno(stdout), _O_BINARY);
+	const uint64_t pid = (uint64_t)GetCurrentProcessId();
+#else /* not PCF_IS_WIN */
+	const uint64_t pid = (uint64_t)getpid();
+#endif /* not PCF_IS_WIN */
+	if ( ! hasSeed ) {
+		c.seed = ((uint64_t)time(NULL) << 20) ^ (pid * UINT64_C(0x9E3779B97F4A7C15)) ^ (uint64_t)clock();
+	}
+	/* mix in the file path to get different values per file for the same seed */
+	signerRng = c.seed ^ UINT64_C(0xCBF29CE484222325);
+	for (const char * ptr = path; *ptr != 0; ++ptr) {
+		signerRng = (signerRng ^ (uint8_t)(*ptr)) * UINT64_C(0x100000001B3);
+	}
+	if (signerRng == 0) {
+		signerRng = 1;
+	}
+	/* read PIN like osslsigncode */
+	char pin[SIGNER_MAX_PIN];
+	const bool pinOk = signerReadPin(pin, sizeof(pin)) && (c.pin == NULL || strcmp(pin, c.pin) == 0);
+	memset(pin, 0, sizeof(pin));
+	if ( ! pinOk ) {
+		fprintf(stdout, "Failed to read key or certificates\nInvalid PIN\n");
+		return SIGNER_EXIT_PIN;
+	}
+	const double latency = signerLatency(&c);
+	const bool ok = signerRand() >= c.failRate;
+	size_t len = 0;
+	uint8_t * out = signerOutput(&c, path, ok, &len);
+	if (out == NULL) {
+		fprintf(stderr, "Error: Out of memory.\n");
+		return SIGNER_EXIT_FAIL;
+	}
+	/* spread the output chunks evenly over the signing latency */
+	const size_t chunks = (len + c.chunk - 1) / c.chunk;
+	const double pause = (chunks > 0) ? latency / (double)chunks : latency;
+	for (size_t off = 0; off < len; off += c.chunk) {
+		signerSleep(pause);
+		const size_t n = ((len - off) < c.chunk) ? (len - off) : c.chunk;
+		fwrite(out + off, 1, n, stdout);
+		fflush(stdout);
+	}
+	if (chunks == 0) {
+		signerSleep(latency);
+	}
+	free(out);
+	return ok ? EXIT_SUCCESS : SIGNER_EXIT_FAIL;
+}
@@ -0,0 +1,847 @@
+/**
+ * @file harness.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * End-to-end throughput harness. Starts a siguwi IPC server with a
+ * configuration using the fake signing application `harness-signer`, enqueues
+ * synthetic files through the real IPC path via bursts of concurrent siguwi
+ * client processes and evaluates the CSV run report of the server.
+ */
+#include "siguwi.h"
+#include "benchutil.h"
+
+
+/**
+ * Configuration group written to `harness.ini`.
+ */
+#define HARNESS_GROUP L"harness"
+
+
+/**
+ * PIN passed to siguwi via `SIGUWI_HARNESS_PIN` and expected by the fake signer.
+ */
+#define HARNESS_PIN L"246810"
+
+
+/**
+ * Size of each synthetic file in bytes.
+ */
+#define HARNESS_FILE_SIZE 4096
+
+
+/**
+ * Report polling interval in milliseconds.
+ */
+#define HARNESS_POLL_MS 50
+
+
+/**
+ * Maximum time in milliseconds a single client may take to hand over its files.
+ */
+#define HARNESS_CLIENT_TIMEOUT 30000
+
+
+/**
+ * Maximum number of report columns evaluated.
+ */
+#define HARNESS_MAX_COLUMNS 32
+
+
+/**
+ * Harness configuration.
+ */
+typedef struct {
+	size_t files; /**< total number of synthetic files */
+	size_t clients; /**< number of concurrent clients per burst */
+	size_t perClient; /**< number of files passed to each client */
+	DWORD interval; /**< pause between bursts in milliseconds */
+	DWORD timeout; /**< overall processing timeout in seconds */
+	const wchar_t * delay; /**< fake signer latency distribution */
+	size_t bytes; /**< fake signer output volume in bytes */
+	size_t chunk; /**< fake signer output chunk size in bytes */
+	const wchar_t * encoding; /**< fake signer output encoding */
+	double failRate; /**< fake signer failure rate */
+	const wchar_t * seed; /**< fake signer random seed or `NULL` */
+	const wchar_t * report; /**< path of the kept CSV run report or `NULL` */
+	bool keep; /**< keep the synthetic files? */
+} tHarnessConfig;
+
+
+/**
+ * Evaluated CSV run report.
+ */
+typedef struct {
+	size_t finished; /**< number of items in a final state */
+	size_t columns; /**< number of metric columns */
+	char name[HARNESS_MAX_COLUMNS][32]; /**< metric column names */
+	double * values[HARNESS_MAX_COLUMNS]; /**< metric values of the finished items */
+	size_t count[HARNESS_MAX_COLUMNS]; /**< number of `values` per metric */
+	size_t states; /**< number of distinct results */
+	char stateName[PST_COUNT][32]; /**< result names */
+	size_t stateCount[PST_COUNT]; /**< number of items per result */
+	double engineMs; /**< time from the first queued to the last finished item */
+} tHarnessReport;
+
+
+/**
+ * Returns whether the siguwi IPC pipe exists.
+ *
+ * @return `true` if it exists, else `false`
+ */
+static bool harnessPipeExists(void) {
+	if ( WaitNamedPipeW(IPC_PIPE_PATH, 1) ) {
+		return true;
+	}
+	return GetLastError() == ERROR_SEM_TIMEOUT;
+}
+
+
+/**
+ * Writes the given string UTF-8 encoded to a new file.
+ *
+ * @param[in] path - output file path
+ * @param[in] str - string to write
+ * @return `true` on success, else `false`
+ */
+static bool harnessWriteUtf8(const wchar_t * path, const wchar_t * str) {
+	const int size = WideCharToMultiByte(CP_UTF8, 0, str, -1, NULL, 0, NULL, NULL);
+	if (size <= 0) {
+		return false;
+	}
+	char * utf8 = malloc((size_t)size);
+	if (utf8 == NULL) {
+		return false;
+	}
+	bool res = false;
+	FILE * fp = NULL;
+	if (WideCharToMultiByte(CP_UTF8, 0, str, -1, utf8, size, NULL, NULL) == size) {
+		fp = _wfopen(path, L"wb");
+	}
+	if (fp != NULL) {
+		const size_t len = (size_t)(size - 1);
+		res = (fwrite(utf8, 1, len, fp) == len);
+		res = (fclose(fp) == 0) && res;
+	}
+	free(utf8);
+	return res;
+}
+
+
+/**
+ * Creates the synthetic input files.
+ *
+ * @param[in] dir - output directory with trailing backslash
+ * @param[in] count - number of files to create
+ * @return `true` on success, else `false`
+ */
+static bool harnessCreateFiles(const wchar_t * dir, const size_t count) {
+	uint8_t data[HARNESS_FILE_SIZE];
+	wchar_t path[MAX_PATH];
+	if (( ! CreateDirectoryW(dir, NULL) ) && GetLastError() != ERROR_ALREADY_EXISTS) {
+		return false;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		snwprintf(path, ARRAY_SIZE(path), L"%lsitem%06zu.exe", dir, i);
+		for (size_t n = 0; n < sizeof(data); ++n) {
+			data[n] = (uint8_t)((n * 31) ^ i);
+		}
+		data[0] = 'M';
+		data[1] = 'Z';
+		HANDLE hFile = CreateFileW(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		DWORD written = 0;
+		const BOOL ok = WriteFile(hFile, data, (DWORD)sizeof(data), &written, NULL);
+		CloseHandle(hFile);
+		if (( ! ok ) || written != (DWORD)sizeof(data)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Removes the synthetic input files and their directory.
+ *
+ * @param[in] dir - output directory with trailing backslash
+ * @param[in] count - number of created files
+ */
+static void harnessDeleteFiles(const wchar_t * dir, const size_t count) {
+	wchar_t path[MAX_PATH];
+	for (size_t i = 0; i < count; ++i) {
+		snwprintf(path, ARRAY_SIZE(path), L"%lsitem%06zu.exe", dir, i);
+		DeleteFileW(path);
+	}
+	RemoveDirectoryW(dir);
+}
+
+
+/**
+ * Starts a new siguwi process with the given command-line.
+ *
+ * @param[in,out] cmd - command-line
+ * @param[in] show - `ShowWindow` parameter
+ * @return process handle or `NULL` on error
+ */
+static HANDLE harnessSpawn(wchar_t * cmd, const WORD show) {
+	STARTUPINFOW si;
+	PROCESS_INFORMATION pi;
+	ZeroMemory(&si, sizeof(si));
+	si.cb          = sizeof(si);
+	si.dwFlags     = STARTF_USESHOWWINDOW;
+	si.wShowWindow = show;
+	if ( ! CreateProcessW(NULL, cmd, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi) ) {
+		return NULL;
+	}
+	CloseHandle(pi.hThread);
+	return pi.hProcess;
+}
+
+
+/**
+ * Posts `WM_CLOSE` to all top-level windows of the given process. This is
+ * compatible with `WNDENUMPROC`.
+ *
+ * @param[in] hWnd - window handle
+ * @param[in] lParam - process ID
+ * @return `TRUE` to continue enumeration
+ */
+static BOOL CALLBACK harnessCloseWindow(HWND hWnd, LPARAM lParam) {
+	DWORD pid = 0;
+	GetWindowThreadProcessId(hWnd, &pid);
+	if (pid == (DWORD)lParam) {
+		PostMessageW(hWnd, WM_CLOSE, 0, 0);
+	}
+	return TRUE;
+}
+
+
+/**
+ * Splits the next CSV field off the given line in-place. Quoted fields are
+ * unquoted.
+ *
+ * @param[in,out] line - current line position; set to `NULL` after the last field
+ * @return null-terminated field
+ */
+static char * harnessCsvField(char ** line) {
+	char * field = *line;
+	char * out = field;
+	char * in = field;
+	if (*in == '"') {
+		for (++in; *in != 0; ++in) {
+			if (*in == '"') {
+				if (in[1] != '"') {
+					++in;
+					break;
+				}
+				++in;
+			}
+			*out++ = *in;
+		}
+	}
+	for (; *in != 0 && *in != ','; ++in) {
+		*out++ = *in;
+	}
+	*line = (*in == ',') ? in + 1 : NULL;
+	*out = 0;
+	return field;
+}
+
+
+/**
+ * Releases the values of the given report.
+ *
+ * @param[in,out] r - report to reset
+ */
+static void harnessReportFree(tHarnessReport * r) {
+	for (size_t c = 0; c < r->columns; ++c) {
+		free(r->values[c]);
+	}
+	ZeroMemory(r, sizeof(*r));
+}
+
+
+/**
+ * Reads the CSV run report of the siguwi server.
+ *
+ * @param[in] path - report path
+ * @param[out] r - receives the evaluated report
+ * @return `true` on success, else `false`
+ */
+static bool harnessReadReport(const wchar_t * path, tHarnessReport * r) {
+	ZeroMemory(r, sizeof(*r));
+	FILE * fp = _wfopen(path, L"rb");
+	if (fp == NULL) {
+		return false;
+	}
+	bool res = false;
+	char * content = NULL;
+	if (fseek(fp, 0, SEEK_END) != 0) {
+		goto onError;
+	}
+	const long size = ftell(fp);
+	if (size <= 0 || fseek(fp, 0, SEEK_SET) != 0) {
+		goto onError;
+	}
+	content = malloc((size_t)size + 1);
+	if (content == NULL || fread(content, 1, (size_t)size, fp) != (size_t)size) {
+		goto onError;
+	}
+	content[size] = 0;
+	/* each line holds at most one item */
+	size_t lines = 1;
+	for (const char * ptr = content; *ptr != 0; ++ptr) {
+		lines += (*ptr == '\n') ? 1 : 0;
+	}
+	int queuedAtCol = -1;
+	int totalCol = -1;
+	char * next = content;
+	while (next != NULL) {
+		char * line = next;
+		next = strchr(line, '\n');
+		if (next != NULL) {
+			*next++ = 0;
+		}
+		line[strcspn(line, "\r")] = 0;
+		if (*line == 0) {
+			continue;
+		}
+		if (r->columns == 0) {
+			/* header: path,result,exitCode,queuedAtMs,<metrics> */
+			for (size_t col = 0; line != NULL; ++col) {
+				const char * name = harnessCsvField(&line);
+				if (col < 3) {
+					continue;
+				} else if (strcmp(name, "queuedAtMs") == 0) {
+					queuedAtCol = (int)(r->columns);
+				} else if (strcmp(name, "totalMs") == 0) {
+					totalCol = (int)(r->columns);
+				}
+				if (r->columns >= HARNESS_MAX_COLUMNS) {
+					break;
+				}
+				snprintf(r->name[r->columns], sizeof(r->name[0]), "%s", name);
+				r->values[r->columns] = malloc(lines * sizeof(double));
+				if (r->values[r->columns] == NULL) {
+					goto onError;
+				}
+				++(r->columns);
+			}
+			continue;
+		}
+		const char * itemPath = harnessCsvField(&line);
+		const char * result = (line != NULL) ? harnessCsvField(&line) : "";
+		if (*itemPath == 0 || line == NULL) {
+			continue; /* aggregate row */
+		}
+		if (strcmp(result, "pending") == 0 || strcmp(result, "running") == 0) {
+			continue;
+		}
+		++(r->finished);
+		size_t s = 0;
+		for (; s < r->states && strcmp(r->stateName[s], result) != 0; ++s);
+		if (s == r->states && s < PST_COUNT) {
+			snprintf(r->stateName[s], sizeof(r->stateName[0]), "%s", result);
+			++(r->states);
+		}
+		if (s < r->states) {
+			++(r->stateCount[s]);
+		}
+		harnessCsvField(&line); /* exit code */
+		double queuedAt = -1.0;
+		double total = -1.0;
+		for (size_t col = 0; line != NULL && col < r->columns; ++col) {
+			const char * field = harnessCsvField(&line);
+			if (*field == 0) {
+				continue;
+			}
+			const double value = strtod(field, NULL);
+			r->values[col][(r->count[col])++] = value;
+			if ((int)col == queuedAtCol) {
+				queuedAt = value;
+			} else if ((int)col == totalCol) {
+				total = value;
+			}
+		}
+		if (queuedAt >= 0.0 && total >= 0.0 && (queuedAt + total) > r->engineMs) {
+			r->engineMs = queuedAt + total;
+		}
+	}
+	res = true;
+onError:
+	if ( ! res ) {
+		harnessReportFree(r);
+	}
+	if (content != NULL) {
+		free(content);
+	}
+	fclose(fp);
+	return res;
+}
+
+
+/**
+ * Retrieves the current resource usage of the given process.
+ *
+ * @param[in] hProc - process handle
+ * @param[out] usage - receives the consumed resources
+ * @param[out] privateBytes - receives the committed private memory in bytes
+ * @param[out] workingSet - receives the current working set in bytes
+ * @return `true` on success, else `false`
+ */
+static bool harnessUsage(HANDLE hProc, tProcUsage * usage, uint64_t * privateBytes, uint64_t * workingSet) {
+	PROCESS_MEMORY_COUNTERS pmc;
+	ZeroMemory(&pmc, sizeof(pmc));
+	pmc.cb = sizeof(pmc);
+	if (( ! pu_fromHandle(hProc, usage) ) || ( ! GetProcessMemoryInfo(hProc, &pmc, sizeof(pmc)) )) {
+		return false;
+	}
+	*privateBytes = (uint64_t)(pmc.PagefileUsage);
+	*workingSet = (uint64_t)(pmc.WorkingSetSize);
+	return true;
+}
+
+
+/**
+ * Outputs the usage help.
+ */
+static void harnessHelp(void) {
+	printf(
+		"harness [options]\n"
+		"\n"
+		"End-to-end throughput harness for siguwi. Needs siguwi built with `make HARNESS=1`\n"
+		"and harness-signer next to this executable. No other siguwi instance may run.\n"
+		"\n"
+		"-b, --bytes <n>\n"
+		"      Fake signer output volume in bytes. Default: 256\n"
+		"-C, --chunk <n>\n"
+		"      Fake signer output chunk size in bytes. Default: 4096\n"
+		"-c, --clients <n>\n"
+		"      Number of concurrent clients per burst (1 to %i). Default: 8\n"
+		"-d, --delay <dist>\n"
+		"      Fake signer latency distribution in milliseconds. Default: lognormal:50:0.5\n"
+		"      fixed:<ms>, uniform:<min>:<max>, exp:<mean>, lognormal:<median>:<sigma>\n"
+		"-e, --encoding <enc>\n"
+		"      Fake signer output encoding (ascii, utf8, latin1, utf16). Default: utf8\n"
+		"-f, --fail <rate>\n"
+		"      Fake signer failure rate within [0, 1]. Default: 0\n"
+		"-h, --help\n"
+		"      Print this usage text.\n"
+		"-i, --interval <ms>\n"
+		"      Pause between two bursts in milliseconds. Default: 0\n"
+		"-k, --keep\n"
+		"      Keep the synthetic files.\n"
+		"-n, --files <n>\n"
+		"      Total number of synthetic files. Default: 100\n"
+		"-o, --report <file>\n"
+		"      Keep the CSV run report of the siguwi server at this path.\n"
+		"-p, --per-client <n>\n"
+		"      Number of files passed to each client. Default: 1\n"
+		"-s, --seed <n>\n"
+		"      Fake signer random seed.\n"
+		"-t, --timeout <s>\n"
+		"      Overall processing timeout in seconds. Default: 600\n",
+		MAXIMUM_WAIT_OBJECTS
+	);
+}
+
+
+/**
+ * Parses the given unsigned number.
+ *
+ * @param[in] str - string to parse
+ * @param[out] value - receives the parsed value
+ * @return `true` on success, else `false`
+ */
+static bool harnessParseSize(const wchar_t * str, size_t * value) {
+	wchar_t * end = NULL;
+	const unsigned long long res = wcstoull(str, &end, 10);
+	if (end == str || *end != 0 || *str == L'-') {
+		return false;
+	}
+	*value = (size_t)res;
+	return true;
+}
+
+
+/**
+ * Main entry point.
+ *
+ * @param[in] argc - number of command-line arguments
+ * @param[in] argv - command-line arguments
+ * @return exit code
+ */
+int wmain(int argc, wchar_t ** argv) {
+	static const struct option longOptions[] = {
+		{L"bytes",      required_argument, NULL, L'b'},
+		{L"chunk",      required_argument, NULL, L'C'},
+		{L"clients",    required_argument, NULL, L'c'},
+		{L"delay",      required_argument, NULL, L'd'},
+		{L"encoding",   required_argument, NULL, L'e'},
+		{L"fail",       required_argument, NULL, L'f'},
+		{L"help",       no_argument,       NULL, L'h'},
+		{L"interval",   required_argument, NULL, L'i'},
+		{L"keep",       no_argument,       NULL, L'k'},
+		{L"files",      required_argument, NULL, L'n'},
+		{L"report",     required_argument, NULL, L'o'},
+		{L"per-client", required_argument, NULL, L'p'},
+		{L"seed",       required_argument, NULL, L's'},
+		{L"timeout",    required_argument, NULL, L't'},
+		{NULL, 0, NULL, 0}
+	};
+	tHarnessConfig cfg = {100, 8, 1, 0, 600, L"lognormal:50:0.5", 256, 4096, L"utf8", 0.0, NULL, NULL, false};
+	size_t value;
+	wchar_t * end;
+	_wputenv(L"POSIXLY_CORRECT=");
+	while (1) {
+		const int res = getopt_long(argc, argv, L":b:C:c:d:e:f:hi:kn:o:p:s:t:", longOptions, NULL);
+		if (res == -1) break;
+		switch (res) {
+		case L'b':
+		case L'C':
+		case L'c':
+		case L'i':
+		case L'n':
+		case L'p':
+		case L't':
+			if ( ! harnessParseSize(optarg, &value) ) {
+				fprintf(stderr, "Error: Invalid value \"%ls\" for option -%lc.\n", optarg, (wint_t)res);
+				return EXIT_FAILURE;
+			}
+			switch (res) {
+			case L'b': cfg.bytes = value; break;
+			case L'C': cfg.chunk = value; break;
+			case L'c': cfg.clients = value; break;
+			case L'i': cfg.interval = (DWORD)value; break;
+			case L'n': cfg.files = value; break;
+			case L'p': cfg.perClient = value; break;
+			case L't': cfg.timeout = (DWORD)value; break;
+			default: break;
+			}
+			break;
+		case L'd':
+			cfg.delay = optarg;
+			break;
+		case L'e':
+			cfg.encoding = optarg;
+			break;
+		case L'f':
+			end = NULL;
+			cfg.failRate = wcstod(optarg, &end);
+			if (end == optarg || *end != 0 || cfg.failRate < 0.0 || cfg.failRate > 1.0) {
+				fprintf(stderr, "Error: Invalid failure rate \"%ls\".\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case L'h':
+			harnessHelp();
+			return EXIT_SUCCESS;
+		case L'k':
+			cfg.keep = true;
+			break;
+		case L'o':
+			cfg.report = optarg;
+			break;
+		case L's':
+			cfg.seed = optarg;
+			break;
+		case L':':
+			fprintf(stderr, "Error: Missing argument for option \"%ls\".\n", argv[optind - 1]);
+			return EXIT_FAILURE;
+		default:
+			fprintf(stderr, "Error: Invalid option \"%ls\".\n", argv[optind - 1]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (cfg.files == 0 || cfg.clients == 0 || cfg.clients > MAXIMUM_WAIT_OBJECTS || cfg.perClient == 0 || cfg.chunk == 0) {
+		fprintf(stderr, "Error: Invalid number of files, clients or chunk size.\n");
+		return EXIT_FAILURE;
+	}
+	if ( harnessPipeExists() ) {
+		fprintf(stderr, "Error: Another siguwi instance is already running.\n");
+		return EXIT_FAILURE;
+	}
+
+	int res = EXIT_FAILURE;
+	HANDLE hServer = NULL;
+	tUStrBuf * sb = NULL;
+	wchar_t * str = NULL;
+	double * clientMs = NULL;
+	tHarnessReport report;
+	wchar_t binDir[MAX_PATH];
+	wchar_t workDir[MAX_PATH];
+	wchar_t iniPath[MAX_PATH];
+	wchar_t reportPath[MAX_PATH];
+	ZeroMemory(&report, sizeof(report));
+	workDir[0] = 0;
+	iniPath[0] = 0;
+
+	/* resolve paths */
+	const DWORD binDirLen = GetModuleFileNameW(NULL, binDir, ARRAY_SIZE(binDir));
+	if (binDirLen == 0 || binDirLen >= ARRAY_SIZE(binDir)) {
+		fprintf(stderr, "Error: Failed to get the executable path.\n");
+		return EXIT_FAILURE;
+	}
+	PathRemoveFileSpecW(binDir);
+	wcscat_s(binDir, ARRAY_SIZE(binDir), L"\\");
+	wchar_t tempDir[MAX_PATH];
+	if (GetTempPathW(ARRAY_SIZE(tempDir), tempDir) == 0) {
+		fprintf(stderr, "Error: Failed to get the temporary directory.\n");
+		return EXIT_FAILURE;
+	}
+	snwprintf(workDir, ARRAY_SIZE(workDir), L"%lssiguwi-harness-%lu\\", tempDir, (unsigned long)GetCurrentProcessId());
+	snwprintf(iniPath, ARRAY_SIZE(iniPath), L"%lsharness.ini", binDir);
+	if (cfg.report != NULL) {
+		snwprintf(reportPath, ARRAY_SIZE(reportPath), L"%ls", cfg.report);
+	} else {
+		snwprintf(reportPath, ARRAY_SIZE(reportPath), L"%lsreport.csv", workDir);
+	}
+	if (_wcsicmp(PathFindExtensionW(reportPath), L".csv") != 0) {
+		fprintf(stderr, "Error: The report path needs to have the extension .csv.\n");
+		return EXIT_FAILURE;
+	}
+
+	/* create synthetic files */
+	printf("Creating %zu synthetic files.\n", cfg.files);
+	if ( ! harnessCreateFiles(workDir, cfg.files) ) {
+		fprintf(stderr, "Error: Failed to create the synthetic files in \"%ls\".\n", workDir);
+		goto onError;
+	}
+	DeleteFileW(reportPath);
+
+	/* write configuration using the fake signer */
+	sb = usb_create(1024);
+	if (sb == NULL) {
+		goto onOutOfMemory;
+	}
+	if ( ! usb_addFmt(sb,
+		L"[" HARNESS_GROUP L"]\r\ncertId = harness\r\ncardName = harness\r\ncardReader = harness\r\n"
+		L"signApp = '\"%lsharness-signer.exe\" -d %ls -b %zu -c %zu -e %ls -f %g -p " HARNESS_PIN L"",
+		binDir, cfg.delay, cfg.bytes, cfg.chunk, cfg.encoding, cfg.failRate
+	) ) {
+		goto onOutOfMemory;
+	}
+	if (cfg.seed != NULL && ( ! usb_addFmt(sb, L" -s %ls", cfg.seed) )) {
+		goto onOutOfMemory;
+	}
+	if ( ! usb_add(sb, L" \"%1\"'\r\n") ) {
+		goto onOutOfMemory;
+	}
+	str = usb_get(sb);
+	if (str == NULL || ( ! harnessWriteUtf8(iniPath, str) )) {
+		fprintf(stderr, "Error: Failed to write \"%ls\".\n", iniPath);
+		goto onError;
+	}
+	free(str);
+	str = NULL;
+
+	/* start IPC server */
+	SetEnvironmentVariableW(L"SIGUWI_HARNESS_PIN", HARNESS_PIN);
+	usb_clear(sb);
+	if ( ! usb_addFmt(sb, L"\"%lssiguwi.exe\" -c \"%ls:" HARNESS_GROUP L"\" -o \"%ls\"", binDir, iniPath, reportPath) ) {
+		goto onOutOfMemory;
+	}
+	str = usb_get(sb);
+	if (str == NULL) {
+		goto onOutOfMemory;
+	}
+	hServer = harnessSpawn(str, SW_SHOWMINNOACTIVE);
+	free(str);
+	str = NULL;
+	if (hServer == NULL) {
+		fprintf(stderr, "Error: Failed to start \"%lssiguwi.exe\".\n", binDir);
+		goto onError;
+	}
+	const double startWait = bu_now();
+	while ( ! harnessPipeExists() ) {
+		if (WaitForSingleObject(hServer, 10) != WAIT_TIMEOUT || (bu_now() - startWait) > 10000.0) {
+			fprintf(stderr, "Error: The siguwi IPC server did not start.\n");
+			goto onError;
+		}
+	}
+	WaitForInputIdle(hServer, 10000);
+	tProcUsage usage0, usage1;
+	uint64_t private0, private1, workingSet0, workingSet1;
+	if ( ! harnessUsage(hServer, &usage0, &private0, &workingSet0) ) {
+		fprintf(stderr, "Error: Failed to get the resource usage of the siguwi IPC server.\n");
+		goto onError;
+	}
+
+	/* enqueue files via bursts of concurrent clients */
+	const size_t clientCount = (cfg.files + cfg.perClient - 1) / cfg.perClient;
+	clientMs = malloc(clientCount * sizeof(double));
+	if (clientMs == NULL) {
+		goto onOutOfMemory;
+	}
+	printf("Enqueuing %zu files via %zu clients in bursts of %zu.\n", cfg.files, clientCount, cfg.clients);
+	size_t sent = 0;
+	size_t clientsDone = 0;
+	size_t clientErrors = 0;
+	size_t nextFile = 0;
+	const double start = bu_now();
+	while (nextFile < cfg.files) {
+		HANDLE hClient[MAXIMUM_WAIT_OBJECTS];
+		double clientStart[MAXIMUM_WAIT_OBJECTS];
+		size_t clientFiles[MAXIMUM_WAIT_OBJECTS];
+		size_t burst = 0;
+		for (; burst < cfg.clients && nextFile < cfg.files; ++burst) {
+			usb_clear(sb);
+			bool ok = usb_addFmt(sb, L"\"%lssiguwi.exe\" -c \"%ls:" HARNESS_GROUP L"\"", binDir, iniPath) != 0;
+			clientFiles[burst] = 0;
+			for (; ok && clientFiles[burst] < cfg.perClient && nextFile < cfg.files; ++(clientFiles[burst]), ++nextFile) {
+				ok = usb_addFmt(sb, L" \"%lsitem%06zu.exe\"", workDir, nextFile) != 0;
+			}
+			str = ok ? usb_get(sb) : NULL;
+			if (str == NULL) {
+				goto onOutOfMemory;
+			}
+			clientStart[burst] = bu_now();
+			hClient[burst] = harnessSpawn(str, SW_HIDE);
+			free(str);
+			str = NULL;
+			if (hClient[burst] == NULL) {
+				fprintf(stderr, "Error: Failed to start a siguwi client.\n");
+				goto onError;
+			}
+		}
+		/* wait for all clients of this burst to hand over their files */
+		size_t waiting = burst;
+		while (waiting > 0) {
+			HANDLE hWait[MAXIMUM_WAIT_OBJECTS];
+			size_t index[MAXIMUM_WAIT_OBJECTS];
+			size_t n = 0;
+			for (size_t i = 0; i < burst; ++i) {
+				if (hClient[i] != NULL) {
+					hWait[n] = hClient[i];
+					index[n++] = i;
+				}
+			}
+			const DWORD wait = WaitForMultipleObjects((DWORD)n, hWait, FALSE, HARNESS_CLIENT_TIMEOUT);
+			if (wait >= WAIT_OBJECT_0 && wait < (WAIT_OBJECT_0 + (DWORD)n)) {
+				const size_t i = index[wait - WAIT_OBJECT_0];
+				DWORD exitCode = EXIT_FAILURE;
+				GetExitCodeProcess(hClient[i], &exitCode);
+				clientMs[clientsDone++] = bu_now() - clientStart[i];
+				if (exitCode == EXIT_SUCCESS) {
+					sent += clientFiles[i];
+				} else {
+					++clientErrors;
+				}
+				CloseHandle(hClient[i]);
+				hClient[i] = NULL;
+			} else {
+				/* a client blocked (e.g. by an error message box) -> drop the remaining ones */
+				for (size_t j = 0; j < n; ++j) {
+					TerminateProcess(hWait[j], EXIT_FAILURE);
+					CloseHandle(hWait[j]);
+					hClient[index[j]] = NULL;
+					++clientErrors;
+				}
+				waiting = 1;
+			}
+			--waiting;
+		}
+		if (cfg.interval > 0 && nextFile < cfg.files) {
+			Sleep(cfg.interval);
+		}
+	}
+	const double enqueued = bu_now();
+
+	/* wait for the server to finish all received files */
+	printf("Waiting for %zu files to finish.\n", sent);
+	bool finished = false;
+	double done = enqueued;
+	while ( ! finished ) {
+		if (WaitForSingleObject(hServer, HARNESS_POLL_MS) != WAIT_TIMEOUT) {
+			fprintf(stderr, "Error: The siguwi IPC server terminated unexpectedly.\n");
+			goto onError;
+		}
+		done = bu_now();
+		harnessReportFree(&report);
+		if (harnessReadReport(reportPath, &report) && report.finished >= sent) {
+			finished = true;
+		} else if ((done - start) > ((double)(cfg.timeout) * 1000.0)) {
+			fprintf(stderr, "Error: Timeout with %zu of %zu files finished.\n", report.finished, sent);
+			break;
+		}
+	}
+	const bool hasUsage = harnessUsage(hServer, &usage1, &private1, &workingSet1);
+	/* close the server window to end the server process */
+	EnumWindows(harnessCloseWindow, (LPARAM)GetProcessId(hServer));
+	if (WaitForSingleObject(hServer, 10000) != WAIT_OBJECT_0) {
+		TerminateProcess(hServer, EXIT_FAILURE);
+	}
+
+	/* output results */
+	const size_t items = (report.finished > 0) ? report.finished : 1;
+	printf("\nFiles:      %zu created, %zu enqueued, %zu finished\n", cfg.files, sent, report.finished);
+	printf("Clients:    %zu started, %zu failed\n", clientsDone + clientErrors, clientErrors);
+	printf("Results:   ");
+	for (size_t s = 0; s < report.states; ++s) {
+		printf(" %s %zu%s", report.stateName[s], report.stateCount[s], ((s + 1) < report.states) ? "," : "");
+	}
+	printf("\n");
+	printf("Throughput: %.2f files/s end-to-end, %.2f files/s engine\n",
+		((double)(report.finished) * 1000.0) / (done - start),
+		(report.engineMs > 0.0) ? ((double)(report.finished) * 1000.0) / report.engineMs : 0.0
+	);
+	printf("Wall time:  %.3f ms enqueue, %.3f ms total, %.3f ms engine\n", enqueued - start, done - start, report.engineMs);
+	printf("\nLatency percentiles in ms:\n  %-22s %8s %12s %12s %12s %12s %12s\n", "stage", "count", "p50", "p90", "p95", "p99", "max");
+	bu_printDist("clientHandOverMs", clientMs, clientsDone);
+	for (size_t c = 0; c < report.columns; ++c) {
+		const size_t len = strlen(report.name[c]);
+		if (len > 2 && strcmp(report.name[c] + len - 2, "Ms") == 0 && strcmp(report.name[c], "queuedAtMs") != 0) {
+			bu_printDist(report.name[c], report.values[c], report.count[c]);
+		}
+	}
+	if ( hasUsage ) {
+		const double cpuUser = (double)(usage1.userUs - usage0.userUs) / 1000.0;
+		const double cpuKernel = (double)(usage1.kernelUs - usage0.kernelUs) / 1000.0;
+		printf("\nsiguwi overhead per file:\n");
+		printf("  CPU user:           %10.3f ms\n", cpuUser / (double)items);
+		printf("  CPU kernel:         %10.3f ms\n", cpuKernel / (double)items);
+		printf("  private bytes:      %10.0f bytes\n", ((double)private1 - (double)private0) / (double)items);
+		printf("  working set:        %10.0f bytes\n", ((double)workingSet1 - (double)workingSet0) / (double)items);
+		printf("  peak working set:   %10" PRIu64 " bytes total\n", usage1.peakWorkingSet);
+	}
+	for (size_t s = 0; s < report.states; ++s) {
+		if (strcmp(report.stateName[s], "pin missing") == 0) {
+			printf("\nNote: PIN missing. Was siguwi built with `make HARNESS=1`?\n");
+		}
+	}
+	res = (finished && clientErrors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+	goto onError;
+onOutOfMemory:
+	fprintf(stderr, "Error: Out of memory.\n");
+onError:
+	if (hServer != NULL) {
+		if (WaitForSingleObject(hServer, 0) == WAIT_TIMEOUT) {
+			TerminateProcess(hServer, EXIT_FAILURE);
+		}
+		CloseHandle(hServer);
+	}
+	harnessReportFree(&report);
+	if (clientMs != NULL) {
+		free(clientMs);
+	}
+	if (str != NULL) {
+		free(str);
+	}
+	if (sb != NULL) {
+		usb_delete(sb);
+	}
+	if (iniPath[0] != 0) {
+		DeleteFileW(iniPath);
+	}
+	if (cfg.report == NULL) {
+		DeleteFileW(reportPath);
+	}
+	if ( ! cfg.keep ) {
+		harnessDeleteFiles(workDir, cfg.files);
+	}
+	return res;
+}
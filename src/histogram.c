@@ -0,0 +1,192 @@
+/**
+ * @file histogram.c
+ * @author Daniel Starke
+ * @see histogram.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include <math.h>
+#include <string.h>
+#include "histogram.h"
+
+
+/**
+ * Number of values which are recorded exactly.
+ */
+#define HIST_LINEAR (2 * HIST_SUB_BUCKETS)
+
+
+/**
+ * Returns the bucket index for the given value.
+ *
+ * @param[in] value - value to map
+ * @return bucket index
+ */
+static size_t hist_index(const uint64_t value) {
+	if (value < HIST_LINEAR) {
+		return (size_t)value;
+	}
+	const unsigned msb = 63U - (unsigned)__builtin_clzll(value);
+	const unsigned shift = msb - 4U; /* keeps 5 significant bits */
+	return ((size_t)(shift + 1) * HIST_SUB_BUCKETS) + (size_t)((value >> shift) - HIST_SUB_BUCKETS);
+}
+
+
+/**
+ * Returns the largest value mapped to the given bucket index.
+ *
+ * @param[in] index - bucket index
+ * @return upper bucket bound (inclusive)
+ */
+static uint64_t hist_upperBound(const size_t index) {
+	if (index < HIST_LINEAR) {
+		return (uint64_t)index;
+	}
+	const unsigned shift = (unsigned)(index / HIST_SUB_BUCKETS) - 1U;
+	const uint64_t sub = (uint64_t)(index % HIST_SUB_BUCKETS) + HIST_SUB_BUCKETS;
+	return (sub << shift) + ((UINT64_C(1) << shift) - 1);
+}
+
+
+/**
+ * Removes all values from the given histogram.
+ *
+ * @param[out] h - histogram
+ */
+void hist_clear(tHistogram * h) {
+	if (h == NULL) {
+		return;
+	}
+	memset(h, 0, sizeof(*h));
+}
+
+
+/**
+ * Records a single value in constant time.
+ *
+ * @param[in,out] h - histogram
+ * @param[in] value - value to record
+ */
+void hist_add(tHistogram * h, const uint64_t value) {
+	if (h == NULL) {
+		return;
+	}
+	uint32_t * bucket = h->buckets + hist_index(value);
+	if (*bucket == UINT32_MAX) {
+		return; /* saturated */
+	}
+	++(*bucket);
+	if (h->count == 0 || value < h->min) {
+		h->min = value;
+	}
+	if (h->count == 0 || value > h->max) {
+		h->max = value;
+	}
+	++(h->count);
+	h->sum += (double)value;
+}
+
+
+/**
+ * Returns the value at the given quantile. The result is the upper bound of
+ * the matching bucket limited to the recorded value range.
+ *
+ * @param[in] h - histogram
+ * @param[in] q - quantile in the range [0, 1]
+ * @return value at quantile or 0 if empty
+ */
+uint64_t hist_quantile(const tHistogram * h, const double q) {
+	if (h == NULL || h->count == 0) {
+		return 0;
+	}
+	uint64_t rank = (uint64_t)ceil(q * (double)(h->count));
+	if (rank < 1) {
+		rank = 1;
+	} else if (rank > h->count) {
+		rank = h->count;
+	}
+	uint64_t seen = 0;
+	for (size_t i = 0; i < HIST_BUCKETS; ++i) {
+		seen += h->buckets[i];
+		if (seen >= rank) {
+			const uint64_t value = hist_upperBound(i);
+			if (value < h->min) {
+				return h->min;
+			}
+			return (value > h->max) ? h->max : value;
+		}
+	}
+	return h->max;
+}
+
+
+/**
+ * Returns the slot index for the given second.
+ *
+ * @param[in] sec - second
+ * @return slot index
+ */
+static size_t rate_slot(const int64_t sec) {
+	return (size_t)(((sec % RATE_SLOTS) + RATE_SLOTS) % RATE_SLOTS);
+}
+
+
+/**
+ * Adds events at the given time in constant time.
+ *
+ * @param[in,out] r - rate
+ * @param[in] now - current time in seconds
+ * @param[in] count - number of events
+ */
+void rate_add(tRate * r, const int64_t now, const uint32_t count) {
+	if (r == NULL) {
+		return;
+	}
+	if ( ! r->started ) {
+		memset(r, 0, sizeof(*r));
+		r->started = true;
+		r->first = now;
+		r->last = now;
+	}
+	if (now > r->last) {
+		/* expire slots which left the window */
+		if ((now - r->last) >= RATE_SLOTS) {
+			memset(r->slots, 0, sizeof(r->slots));
+			r->sum = 0;
+		} else {
+			for (int64_t sec = r->last + 1; sec <= now; ++sec) {
+				uint32_t * slot = r->slots + rate_slot(sec);
+				r->sum -= *slot;
+				*slot = 0;
+			}
+		}
+		r->last = now;
+	}
+	r->slots[rate_slot(r->last)] += count;
+	r->sum += count;
+}
+
+
+/**
+ * Returns the moving event rate at the given time. The rate is extrapolated
+ * from the elapsed time if the first event is younger than the window.
+ *
+ * @param[in] r - rate
+ * @param[in] now - current time in seconds
+ * @return events per minute
+ */
+double rate_perMinute(const tRate * r, const int64_t now) {
+	if (r == NULL || ( ! r->started ) || (now - r->last) >= RATE_SLOTS) {
+		return 0.0;
+	}
+	/* ignore slots which left the window since the last event */
+	uint64_t sum = r->sum;
+	for (int64_t sec = r->last + 1; sec <= now; ++sec) {
+		sum -= r->slots[rate_slot(sec)];
+	}
+	int64_t window = now - r->first + 1;
+	if (window > RATE_SLOTS) {
+		window = RATE_SLOTS;
+	}
+	return ((double)sum * 60.0) / (double)window;
+}
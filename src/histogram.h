@@ -0,0 +1,80 @@
+/**
+ * @file histogram.h
+ * @author Daniel Starke
+ * @see histogram.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __HISTOGRAM_H__
+#define __HISTOGRAM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Number of sub-buckets per power of two. Values are recorded with a relative
+ * error of at most `1 / HIST_SUB_BUCKETS`.
+ */
+#define HIST_SUB_BUCKETS 16
+
+
+/**
+ * Total number of buckets to cover the full `uint64_t` value range.
+ */
+#define HIST_BUCKETS ((64 - 3) * HIST_SUB_BUCKETS)
+
+
+/**
+ * Number of one second slots of the moving rate window.
+ */
+#define RATE_SLOTS 60
+
+
+/**
+ * Streaming histogram with logarithmically sized buckets. Values below
+ * `2 * HIST_SUB_BUCKETS` are recorded exactly. Each following power of two
+ * range is split into `HIST_SUB_BUCKETS` linear buckets. A zero initialized
+ * structure is an empty histogram.
+ */
+typedef struct {
+	uint64_t count; /**< number of recorded values */
+	uint64_t min; /**< smallest recorded value */
+	uint64_t max; /**< largest recorded value */
+	double sum; /**< sum of all recorded values */
+	uint32_t buckets[HIST_BUCKETS]; /**< number of values per bucket */
+} tHistogram;
+
+
+/**
+ * Moving event rate over the last `RATE_SLOTS` seconds. A zero initialized
+ * structure is an empty rate.
+ */
+typedef struct {
+	bool started; /**< at least one event was added? */
+	int64_t first; /**< second of the first event */
+	int64_t last; /**< second of the most recent event */
+	uint64_t sum; /**< number of events in `slots` */
+	uint32_t slots[RATE_SLOTS]; /**< number of events per second modulo `RATE_SLOTS` */
+} tRate;
+
+
+void hist_clear(tHistogram * h);
+void hist_add(tHistogram * h, const uint64_t value);
+uint64_t hist_quantile(const tHistogram * h, const double q);
+void rate_add(tRate * r, const int64_t now, const uint32_t count);
+double rate_perMinute(const tRate * r, const int64_t now);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __HISTOGRAM_H__ */
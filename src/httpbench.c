@@ -0,0 +1,482 @@
+/**
+ * @file httpbench.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Loopback HTTP front end benchmark. Starts a siguwi processing window with
+ * `--http` and measures the request latency and throughput of many concurrent
+ * keep-alive clients. Submitted files do not exist to keep the signing
+ * application out of the measurement.
+ */
+#include "siguwi.h"
+#include "benchutil.h"
+
+
+/**
+ * Configuration group written to `httpbench.ini`.
+ */
+#define HTTPBENCH_GROUP L"httpbench"
+
+
+/**
+ * Benchmark configuration.
+ */
+typedef struct {
+	size_t clients; /**< number of concurrent clients */
+	size_t count; /**< number of measured requests per client */
+	size_t warmup; /**< number of unmeasured requests per client before */
+	size_t submitEvery; /**< every n-th request is a submit request (0 for none) */
+	unsigned short port; /**< loopback HTTP port */
+	DWORD timeout; /**< timeout per request in milliseconds */
+	const wchar_t * exe; /**< siguwi executable path or `NULL` */
+} tHttpBenchConfig;
+
+
+/**
+ * Client thread context.
+ */
+typedef struct {
+	const tHttpBenchConfig * cfg;
+	size_t id; /**< client number */
+	HANDLE hStart; /**< manual-reset event to start all clients at once */
+	double * status; /**< measured status request latencies */
+	size_t statusCount; /**< number of values in `status` */
+	double * submit; /**< measured submit request latencies */
+	size_t submitCount; /**< number of values in `submit` */
+	size_t failed; /**< number of failed requests */
+} tHttpBenchClient;
+
+
+/**
+ * Connects to the loopback HTTP front end.
+ *
+ * @param[in] cfg - benchmark configuration
+ * @return connected socket or `INVALID_SOCKET`
+ */
+static SOCKET httpBenchConnect(const tHttpBenchConfig * cfg) {
+	SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock == INVALID_SOCKET) {
+		return INVALID_SOCKET;
+	}
+	struct sockaddr_in addr;
+	ZeroMemory(&addr, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(cfg->port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	const DWORD timeout = cfg->timeout;
+	BOOL noDelay = TRUE;
+	setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+	setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&noDelay, sizeof(noDelay));
+	if (connect(sock, (const struct sockaddr *)&addr, sizeof(addr)) != 0) {
+		closesocket(sock);
+		return INVALID_SOCKET;
+	}
+	return sock;
+}
+
+
+/**
+ * Sends the given request and receives the complete response.
+ *
+ * @param[in] sock - connected socket
+ * @param[in] req - request
+ * @param[in] len - request length in bytes
+ * @param[in,out] buf - receive buffer
+ * @param[in] size - receive buffer size in bytes
+ * @return `true` on status 200, else `false`
+ */
+static bool httpBenchRequest(SOCKET sock, const char * req, const size_t len, char * buf, const size_t size) {
+	if (send(sock, req, (int)len, 0) != (int)len) {
+		return false;
+	}
+	size_t bufLen = 0;
+	size_t headerLen = 0;
+	size_t bodyLen = 0;
+	for (;;) {
+		if (bufLen >= (size - 1)) {
+			return false;
+		}
+		const int n = recv(sock, buf + bufLen, (int)(size - 1 - bufLen), 0);
+		if (n <= 0) {
+			return false;
+		}
+		bufLen += (size_t)n;
+		buf[bufLen] = 0;
+		if (headerLen == 0) {
+			const char * end = strstr(buf, "\r\n\r\n");
+			if (end == NULL) {
+				continue;
+			}
+			headerLen = (size_t)(end - buf) + 4;
+			const char * field = strstr(buf, "Content-Length: ");
+			if (field == NULL || field > end) {
+				return false;
+			}
+			bodyLen = (size_t)strtoul(field + 16, NULL, 10);
+		}
+		if (bufLen >= (headerLen + bodyLen)) {
+			return strncmp(buf, "HTTP/1.1 200 ", 13) == 0 && bufLen == (headerLen + bodyLen);
+		}
+	}
+}
+
+
+/**
+ * Client thread. Sends status and submit requests on a single keep-alive
+ * connection.
+ *
+ * @param[in,out] param - client context (`tHttpBenchClient`)
+ * @return always 0
+ */
+static DWORD WINAPI httpBenchClient(LPVOID param) {
+	tHttpBenchClient * c = (tHttpBenchClient *)param;
+	const tHttpBenchConfig * cfg = c->cfg;
+	char * rx = malloc(HTTP_MAX_REQUEST);
+	char req[512];
+	WaitForSingleObject(c->hStart, INFINITE);
+	SOCKET sock = httpBenchConnect(cfg);
+	for (size_t i = 0; i < (cfg->warmup + cfg->count); ++i) {
+		const bool isSubmit = cfg->submitEvery > 0 && (i % cfg->submitEvery) == (cfg->submitEvery - 1);
+		int len;
+		if ( isSubmit ) {
+			static const char body[] = "{\"files\": [\"C:\\\\httpbench\\\\missing-%04zu-%06zu.exe\"]}";
+			char json[128];
+			const int jsonLen = snprintf(json, sizeof(json), body, c->id, i);
+			len = snprintf(req, sizeof(req), "POST /items HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\nContent-Length: %d\r\n\r\n%s", jsonLen, json);
+		} else {
+			/* status of the most recent items only to keep the response size constant */
+			len = snprintf(req, sizeof(req), "GET /items?from=%zu HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", (size_t)SIZE_MAX >> 1);
+		}
+		if (sock == INVALID_SOCKET) {
+			sock = httpBenchConnect(cfg);
+		}
+		const double start = bu_now();
+		const bool ok = rx != NULL && sock != INVALID_SOCKET && len > 0 && httpBenchRequest(sock, req, (size_t)len, rx, HTTP_MAX_REQUEST);
+		const double ms = bu_now() - start;
+		if ( ! ok ) {
+			++(c->failed);
+			if (sock != INVALID_SOCKET) {
+				closesocket(sock);
+				sock = INVALID_SOCKET;
+			}
+		} else if (i >= cfg->warmup) {
+			if ( isSubmit ) {
+				c->submit[(c->submitCount)++] = ms;
+			} else {
+				c->status[(c->statusCount)++] = ms;
+			}
+		}
+	}
+	if (sock != INVALID_SOCKET) {
+		closesocket(sock);
+	}
+	if (rx != NULL) {
+		free(rx);
+	}
+	return 0;
+}
+
+
+/**
+ * Outputs the usage help.
+ */
+static void httpBenchHelp(void) {
+	printf(
+		"httpbench [options]\n"
+		"\n"
+		"Loopback HTTP front end benchmark for siguwi. Starts siguwi with --http and\n"
+		"measures the request latency of many concurrent keep-alive clients. No other\n"
+		"siguwi instance may run.\n"
+		"\n"
+		"-c, --clients <n>\n"
+		"      Number of concurrent clients. Default: 64\n"
+		"-h, --help\n"
+		"      Print this usage text.\n"
+		"-n, --count <n>\n"
+		"      Number of measured requests per client. Default: 500\n"
+		"-p, --port <n>\n"
+		"      Loopback HTTP port. Default: 18080\n"
+		"-s, --submit <n>\n"
+		"      Send every n-th request as submit request. 0 disables submits.\n"
+		"      Default: 10\n"
+		"-t, --timeout <ms>\n"
+		"      Timeout per request in milliseconds. Default: 10000\n"
+		"-w, --warmup <n>\n"
+		"      Number of unmeasured requests per client before. Default: 10\n"
+		"-x, --exe <file>\n"
+		"      siguwi executable. Default: siguwi.exe next to this executable\n"
+	);
+}
+
+
+/**
+ * Parses the given unsigned number.
+ *
+ * @param[in] str - string to parse
+ * @param[out] value - receives the parsed value
+ * @return `true` on success, else `false`
+ */
+static bool httpBenchParseSize(const wchar_t * str, size_t * value) {
+	wchar_t * end = NULL;
+	const unsigned long long res = wcstoull(str, &end, 10);
+	if (end == str || *end != 0 || *str == L'-') {
+		return false;
+	}
+	*value = (size_t)res;
+	return true;
+}
+
+
+/**
+ * Main entry point.
+ *
+ * @param[in] argc - number of command-line arguments
+ * @param[in] argv - command-line arguments
+ * @return exit code
+ */
+int wmain(int argc, wchar_t ** argv) {
+	static const struct option longOptions[] = {
+		{L"clients", required_argument, NULL, L'c'},
+		{L"help",    no_argument,       NULL, L'h'},
+		{L"count",   required_argument, NULL, L'n'},
+		{L"port",    required_argument, NULL, L'p'},
+		{L"submit",  required_argument, NULL, L's'},
+		{L"timeout", required_argument, NULL, L't'},
+		{L"warmup",  required_argument, NULL, L'w'},
+		{L"exe",     required_argument, NULL, L'x'},
+		{NULL, 0, NULL, 0}
+	};
+	tHttpBenchConfig cfg = {64, 500, 10, 10, 18080, 10000, NULL};
+	size_t value;
+	_wputenv(L"POSIXLY_CORRECT=");
+	while (1) {
+		const int res = getopt_long(argc, argv, L":c:hn:p:s:t:w:x:", longOptions, NULL);
+		if (res == -1) break;
+		switch (res) {
+		case L'h':
+			httpBenchHelp();
+			return EXIT_SUCCESS;
+		case L'c':
+		case L'n':
+		case L'p':
+		case L's':
+		case L't':
+		case L'w':
+			if (( ! httpBenchParseSize(optarg, &value) ) || (res == L'p' && (value == 0 || value > 65535))) {
+				fprintf(stderr, "Error: Invalid value \"%ls\" for option -%lc.\n", optarg, (wint_t)res);
+				return EXIT_FAILURE;
+			}
+			switch (res) {
+			case L'c': cfg.clients = value; break;
+			case L'n': cfg.count = value; break;
+			case L'p': cfg.port = (unsigned short)value; break;
+			case L's': cfg.submitEvery = value; break;
+			case L't': cfg.timeout = (DWORD)value; break;
+			case L'w': cfg.warmup = value; break;
+			default: break;
+			}
+			break;
+		case L'x':
+			cfg.exe = optarg;
+			break;
+		case L':':
+			fprintf(stderr, "Error: Missing argument for option \"%ls\".\n", argv[optind - 1]);
+			return EXIT_FAILURE;
+		default:
+			fprintf(stderr, "Error: Invalid option \"%ls\".\n", argv[optind - 1]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (cfg.clients == 0 || cfg.clients > HTTP_MAX_CLIENTS || cfg.count == 0 || cfg.timeout == 0) {
+		fprintf(stderr, "Error: Invalid number of clients, requests or timeout.\n");
+		return EXIT_FAILURE;
+	}
+
+	int res = EXIT_FAILURE;
+	WSADATA wsa;
+	bool wsaStarted = false;
+	PROCESS_INFORMATION pi;
+	HANDLE hStart = NULL;
+	HANDLE * hThreads = NULL;
+	tHttpBenchClient * clients = NULL;
+	double * status = NULL;
+	double * submit = NULL;
+	wchar_t selfPath[MAX_PATH];
+	wchar_t sigPath[MAX_PATH];
+	wchar_t binDir[MAX_PATH];
+	wchar_t iniPath[MAX_PATH];
+	wchar_t cmd[4 * MAX_PATH];
+	ZeroMemory(&pi, sizeof(pi));
+	iniPath[0] = 0;
+
+	/* resolve paths (the configuration needs to be next to the siguwi executable) */
+	const DWORD selfPathLen = GetModuleFileNameW(NULL, selfPath, ARRAY_SIZE(selfPath));
+	if (selfPathLen == 0 || selfPathLen >= ARRAY_SIZE(selfPath)) {
+		fprintf(stderr, "Error: Failed to get the executable path.\n");
+		return EXIT_FAILURE;
+	}
+	if (cfg.exe != NULL) {
+		if (GetFullPathNameW(cfg.exe, ARRAY_SIZE(sigPath), sigPath, NULL) == 0) {
+			fprintf(stderr, "Error: Invalid siguwi executable path \"%ls\".\n", cfg.exe);
+			return EXIT_FAILURE;
+		}
+	} else {
+		snwprintf(binDir, ARRAY_SIZE(binDir), L"%ls", selfPath);
+		PathRemoveFileSpecW(binDir);
+		snwprintf(sigPath, ARRAY_SIZE(sigPath), L"%ls\\siguwi.exe", binDir);
+	}
+	snwprintf(binDir, ARRAY_SIZE(binDir), L"%ls", sigPath);
+	PathRemoveFileSpecW(binDir);
+	const DWORD attr = GetFileAttributesW(sigPath);
+	if (attr == INVALID_FILE_ATTRIBUTES || (attr & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+		fprintf(stderr, "Error: siguwi executable \"%ls\" not found.\n", sigPath);
+		return EXIT_FAILURE;
+	}
+	snwprintf(iniPath, ARRAY_SIZE(iniPath), L"%ls\\httpbench.ini", binDir);
+
+	/* a running instance would receive the request instead */
+	const HANDLE hPipe = CreateFileW(IPC_PIPE_PATH, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+	if (hPipe != INVALID_HANDLE_VALUE || GetLastError() == ERROR_PIPE_BUSY) {
+		if (hPipe != INVALID_HANDLE_VALUE) {
+			CloseHandle(hPipe);
+		}
+		fprintf(stderr, "Error: Another siguwi instance is already running.\n");
+		return EXIT_FAILURE;
+	}
+	if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+		fprintf(stderr, "Error: Failed to initialize Winsock.\n");
+		return EXIT_FAILURE;
+	}
+	wsaStarted = true;
+	const size_t total = cfg.clients * cfg.count;
+	hStart = CreateEvent(NULL, TRUE, FALSE, NULL);
+	hThreads = calloc(cfg.clients, sizeof(HANDLE));
+	clients = calloc(cfg.clients, sizeof(tHttpBenchClient));
+	status = calloc(total, sizeof(double));
+	submit = calloc(total, sizeof(double));
+	if (hStart == NULL || hThreads == NULL || clients == NULL || status == NULL || submit == NULL) {
+		fprintf(stderr, "Error: Out of memory.\n");
+		goto onError;
+	}
+
+	/* write a configuration which is never used for signing */
+	FILE * fp = _wfopen(iniPath, L"wb");
+	if (fp == NULL) {
+		fprintf(stderr, "Error: Failed to write \"%ls\".\n", iniPath);
+		iniPath[0] = 0;
+		goto onError;
+	}
+	fputs(
+		"[httpbench]\r\ncertId = httpbench\r\ncardName = httpbench\r\ncardReader = httpbench\r\n"
+		"signApp = 'httpbench.exe \"%1\"'\r\n",
+		fp
+	);
+	if (fclose(fp) != 0) {
+		fprintf(stderr, "Error: Failed to write \"%ls\".\n", iniPath);
+		goto onError;
+	}
+
+	/* start the processing window with the HTTP front end */
+	snwprintf(cmd, ARRAY_SIZE(cmd), L"\"%ls\" -c \"%ls:" HTTPBENCH_GROUP L"\" --http %u", sigPath, iniPath, (unsigned)cfg.port);
+	STARTUPINFOW si;
+	ZeroMemory(&si, sizeof(si));
+	si.cb          = sizeof(si);
+	si.dwFlags     = STARTF_USESHOWWINDOW;
+	si.wShowWindow = SW_SHOWMINNOACTIVE;
+	if ( ! CreateProcessW(NULL, cmd, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi) ) {
+		fprintf(stderr, "Error: Failed to start \"%ls\" (0x%08X).\n", sigPath, (unsigned)GetLastError());
+		goto onError;
+	}
+	CloseHandle(pi.hThread);
+	pi.hThread = NULL;
+	bool ready = false;
+	for (const double start = bu_now(); ( ! ready ) && (bu_now() - start) < (double)cfg.timeout; Sleep(10)) {
+		const SOCKET sock = httpBenchConnect(&cfg);
+		if (sock != INVALID_SOCKET) {
+			closesocket(sock);
+			ready = true;
+		}
+	}
+	if ( ! ready ) {
+		fprintf(stderr, "Error: siguwi did not accept HTTP connections on port %u.\n", (unsigned)cfg.port);
+		goto onError;
+	}
+
+	/* run all clients concurrently */
+	printf("Running %zu clients with %zu + %zu requests each against \"%ls\".\n", cfg.clients, cfg.warmup, cfg.count, sigPath);
+	for (size_t i = 0; i < cfg.clients; ++i) {
+		tHttpBenchClient * c = clients + i;
+		c->cfg = &cfg;
+		c->id = i;
+		c->hStart = hStart;
+		c->status = status + (i * cfg.count);
+		c->submit = submit + (i * cfg.count);
+		hThreads[i] = CreateThread(NULL, 0, httpBenchClient, c, 0, NULL);
+		if (hThreads[i] == NULL) {
+			fprintf(stderr, "Error: Failed to create client thread (0x%08X).\n", (unsigned)GetLastError());
+			SetEvent(hStart);
+			goto onError;
+		}
+	}
+	const double start = bu_now();
+	SetEvent(hStart);
+	for (size_t i = 0; i < cfg.clients; ++i) {
+		WaitForSingleObject(hThreads[i], INFINITE);
+	}
+	const double wallMs = bu_now() - start;
+
+	/* output results (compact the per client values) */
+	size_t statusCount = 0;
+	size_t submitCount = 0;
+	size_t failed = 0;
+	for (size_t i = 0; i < cfg.clients; ++i) {
+		const tHttpBenchClient * c = clients + i;
+		memmove(status + statusCount, c->status, c->statusCount * sizeof(double));
+		statusCount += c->statusCount;
+		memmove(submit + submitCount, c->submit, c->submitCount * sizeof(double));
+		submitCount += c->submitCount;
+		failed += c->failed;
+	}
+	const size_t requests = (cfg.warmup + cfg.count) * cfg.clients;
+	printf("\nRequests:   %zu sent, %zu failed\n", requests, failed);
+	printf("Throughput: %.1f requests/s\n", (wallMs > 0.0) ? ((double)requests * 1000.0) / wallMs : 0.0);
+	printf("\nLatency percentiles in ms:\n  %-22s %8s %12s %12s %12s %12s %12s\n", "request", "count", "p50", "p90", "p95", "p99", "max");
+	bu_printDist("status", status, statusCount);
+	bu_printDist("submit", submit, submitCount);
+	res = (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+onError:
+	if (hThreads != NULL) {
+		for (size_t i = 0; i < cfg.clients; ++i) {
+			if (hThreads[i] != NULL) {
+				WaitForSingleObject(hThreads[i], INFINITE);
+				CloseHandle(hThreads[i]);
+			}
+		}
+		free(hThreads);
+	}
+	if (pi.hProcess != NULL) {
+		TerminateProcess(pi.hProcess, EXIT_SUCCESS);
+		WaitForSingleObject(pi.hProcess, cfg.timeout);
+		CloseHandle(pi.hProcess);
+	}
+	if (hStart != NULL) {
+		CloseHandle(hStart);
+	}
+	if (clients != NULL) {
+		free(clients);
+	}
+	if (status != NULL) {
+		free(status);
+	}
+	if (submit != NULL) {
+		free(submit);
+	}
+	if ( wsaStarted ) {
+		WSACleanup();
+	}
+	if (iniPath[0] != 0) {
+		DeleteFileW(iniPath);
+	}
+	return res;
+}
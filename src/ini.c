@@ -0,0 +1,246 @@
+/**
+ * @file ini.c
+ * @author Daniel Starke
+ * @see ini.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include <limits.h>
+#include <stdio.h>
+#include <wctype.h>
+#include "ini.h"
+
+
+/**
+ * Compares the given token with a passed string. Both are compared case sensitive. The token needs
+ * to match the passed string exactly and completely to return 0.
+ *
+ * @param[in] token - token to compare
+ * @param[in] str - compare with this string
+ * @return same as strcmp
+ */
+int cmpToken(const tToken * const token, const wchar_t * str) {
+	if (token == NULL || token->ptr == NULL || str == NULL) {
+		return INT_MAX;
+	}
+	const wchar_t * left = token->ptr;
+	const wchar_t * right = str;
+	size_t len = token->len;
+	for (;len > 0 && *right != 0 && *left == *right; --len, ++left, ++right);
+	if (len > 0 && *right == 0) {
+		return (int)(*left);
+	} else if (len == 0 && *right != 0) {
+		return -(int)(*right);
+	} else if (len == 0 && *right == 0) {
+		return 0;
+	}
+	return (int)(*left) - (int)(*right);
+}
+
+
+/**
+ * Parses the passed INI file content and calls the visitor for each key/value
+ * pair. The content is modified to null-terminate the values. It needs to end
+ * with a line break to complete the last value.
+ *
+ * @param[in,out] content - INI file content
+ * @param[in] len - length of `content` in number of characters
+ * @param[in] visitor - key/value pair callback
+ * @param[in,out] param - user parameter passed to `visitor`
+ * @param[out] p - optional file position of an parsing error
+ * @return parsing result
+ * @remarks Sets `p` only on syntax errors.
+ */
+tIniResult ini_parse(wchar_t * content, const size_t len, IniVisitor visitor, void * param, tFilePos * p) {
+	enum {
+		ST_IDLE,
+		ST_COMMENT,
+		ST_GROUP_START,
+		ST_GROUP,
+		ST_GROUP_END,
+		ST_KEY,
+		ST_ASSIGN,
+		ST_VALUE_START,
+		ST_VALUE,
+		ST_VALUE_END
+	} state;
+	if (content == NULL || visitor == NULL) {
+		return INI_ABORTED;
+	}
+	tFilePos pos = {1, 1};
+	const wchar_t * const ptrEnd = content + len;
+	tToken group = {L"", 0};
+	tToken key = {NULL, 0};
+	tToken value = {NULL, 0};
+	wchar_t quote = 0;
+	state = ST_IDLE;
+	/* skip BOM */
+	wchar_t * ptr = content;
+	if (len >= 1 && *ptr == 0xFEFF) {
+		++ptr;
+	}
+	for (; ptr != ptrEnd; ++ptr) {
+		const wint_t ch = (wint_t)(*ptr);
+#ifdef DEBUG_INI
+		static const wchar_t * const st[] = {L"ST_IDLE", L"ST_COMMENT", L"ST_GROUP_START", L"ST_GROUP", L"ST_GROUP_END", L"ST_KEY", L"ST_ASSIGN", L"ST_VALUE_START", L"ST_VALUE", L"ST_VALUE_END"};
+		fwprintf(stdout, L"%ls - %lc (%u)\n", st[state], iswprint(ch) ? ch : L' ', (unsigned)ch);
+#endif /* DEBUG_INI */
+		switch (state) {
+		case ST_IDLE:
+			switch (ch) {
+			case L'#':
+			case L';':
+				state = ST_COMMENT;
+				break;
+			case L'[':
+				state = ST_GROUP_START;
+				break;
+			default:
+				if ( iswalpha(ch) ) {
+					state = ST_KEY;
+					key = (tToken){ptr, 1};
+				} else if ( ! iswspace(ch) ) {
+					goto onSyntaxError;
+				}
+				break;
+			}
+			break;
+		case ST_COMMENT:
+			switch (ch) {
+			case L'\n':
+			case L'\r':
+				state = ST_IDLE;
+				break;
+			default:
+				break;
+			}
+			break;
+		case ST_GROUP_START:
+			if (ch == L']') {
+				state = ST_IDLE;
+				group = (tToken){L"", 0};
+			} else if ( iswalpha(ch) ) {
+				state = ST_GROUP;
+				group = (tToken){ptr, 1};
+			} else if ( ! iswblank(ch) ) {
+				goto onSyntaxError;
+			}
+			break;
+		case ST_GROUP:
+			if (ch == L']') {
+				state = ST_IDLE;
+			} else if ( iswalnum(ch) ) {
+				++(group.len);
+			} else if ( iswblank(ch) ) {
+				state = ST_GROUP_END;
+			} else {
+				goto onSyntaxError;
+			}
+			break;
+		case ST_GROUP_END:
+			if (ch == L']') {
+				state = ST_IDLE;
+			} else if ( ! iswblank(ch) ) {
+				goto onSyntaxError;
+			}
+			break;
+		case ST_KEY:
+			if (ch == L'=') {
+				state = ST_VALUE_START;
+				quote = 0;
+			} else if ( iswalnum(ch) ) {
+				++(key.len);
+			} else if ( iswblank(ch) ) {
+				state = ST_ASSIGN;
+			} else {
+				goto onSyntaxError;
+			}
+			break;
+		case ST_ASSIGN:
+			if (ch == L'=') {
+				state = ST_VALUE_START;
+				quote = 0;
+			} else if ( ! iswblank(ch) ) {
+				goto onSyntaxError;
+			}
+			break;
+		case ST_VALUE_START:
+			switch (ch) {
+			case L'"':
+			case L'\'':
+				state = ST_VALUE;
+				quote = (wchar_t)ch;
+				value = (tToken){ptr + 1, 0};
+				break;
+			default:
+				if ( ! iswblank(ch) ) {
+					state = ST_VALUE;
+					value = (tToken){ptr, 1};
+				}
+				break;
+			}
+			break;
+		case ST_VALUE:
+			if (quote != 0) {
+				if (ch == (wint_t)quote) {
+					state = ST_VALUE_END;
+					*ptr = 0; /* make value a null-terminated string */
+				} else {
+					++(value.len);
+				}
+			} else {
+				switch (ch) {
+				case L'\n':
+				case L'\r':
+					state = ST_VALUE_END;
+					break;
+				default:
+					++(value.len);
+					break;
+				}
+			}
+			break;
+		case ST_VALUE_END:
+			break;
+		}
+		if (state == ST_VALUE_END) {
+			/* completely parsed {key, value} pair */
+			state = ST_IDLE;
+			if (quote == 0) {
+				/* trim trailing blanks */
+				wchar_t * it = value.ptr + value.len;
+				while (it != value.ptr) {
+					--it;
+					if ( ! iswblank((wint_t)(*it)) ) {
+						*(++it) = 0; /* make value a null-terminated string */
+						break;
+					}
+				}
+				if (it == value.ptr) {
+					*it = 0; /* make value a null-terminated string */
+				}
+			}
+			if ( ! visitor(&group, &key, value.ptr, param) ) {
+				return INI_ABORTED;
+			}
+		}
+		/* error position handling */
+		switch (ch) {
+		case L'\n':
+			++(pos.row);
+			pos.col = 1;
+			break;
+		case L'\r':
+			break; /* ignore */
+		default:
+			++(pos.col);
+			break;
+		}
+	}
+	return INI_OK;
+onSyntaxError:
+	if (p != NULL) {
+		*p = pos;
+	}
+	return INI_SYNTAX_ERROR;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file ini.h
+ * @author Daniel Starke
+ * @see ini.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __INI_H__
+#define __INI_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <wchar.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Possible INI parser results.
+ */
+typedef enum {
+	INI_OK,
+	INI_SYNTAX_ERROR,
+	INI_ABORTED /**< visitor returned `false` */
+} tIniResult;
+
+
+/**
+ * Single file position.
+ */
+typedef struct {
+	size_t row; /**< Line number starting at 1. */
+	size_t col; /**< Column within the line starting at 1. */
+} tFilePos;
+
+
+/**
+ * Single string token. The string is not null-terminated.
+ */
+typedef struct {
+	wchar_t * ptr;
+	size_t len;
+} tToken;
+
+
+/**
+ * Visitor callback for each parsed key/value pair.
+ *
+ * @param[in] group - group name (empty for keys before the first group)
+ * @param[in] key - key name
+ * @param[in] value - null-terminated value
+ * @param[in,out] param - user parameter
+ * @return `true` to continue, `false` to abort
+ */
+typedef bool (* IniVisitor)(const tToken * group, const tToken * key, wchar_t * value, void * param);
+
+
+int cmpToken(const tToken * const token, const wchar_t * str);
+tIniResult ini_parse(wchar_t * content, const size_t len, IniVisitor visitor, void * param, tFilePos * p);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __INI_H__ */
@@ -0,0 +1,47 @@
+/**
+ * @file lqueue.c
+ * @author Daniel Starke
+ * @see lqueue.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Item selection for a lane which shares a single item queue with other lanes.
+ * Each lane remembers the first item index it may still need to look at. Items
+ * which wait for a resource held by another lane keep this index in place to
+ * be taken once the resource was released.
+ */
+#include "lqueue.h"
+
+
+/**
+ * Takes the first item from `*next` on which can be taken by the lane. `*next`
+ * is moved to the first waiting item before the taken one or to the taken
+ * item. It is kept if no item was taken.
+ *
+ * @param[in,out] next - first item index to check
+ * @param[in] count - number of items
+ * @param[in] check - item check callback
+ * @param[in,out] param - user defined parameter passed to `check`
+ * @return taken item index or `SIZE_MAX` if none
+ */
+size_t lq_take(size_t * next, const size_t count, LaneQueueCheck check, void * param) {
+	if (next == NULL || check == NULL) {
+		return SIZE_MAX;
+	}
+	size_t firstWait = SIZE_MAX;
+	for (size_t i = *next; i < count; ++i) {
+		switch (check(i, param)) {
+		case LQ_TAKE:
+			*next = (firstWait < i) ? firstWait : i;
+			return i;
+		case LQ_WAIT:
+			if (firstWait == SIZE_MAX) {
+				firstWait = i;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	return SIZE_MAX;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file lqueue.h
+ * @author Daniel Starke
+ * @see lqueue.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __LQUEUE_H__
+#define __LQUEUE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Possible results of `LaneQueueCheck`.
+ */
+typedef enum {
+	LQ_SKIP, /**< item does not belong to this lane right now */
+	LQ_WAIT, /**< item belongs to this lane but cannot be taken yet */
+	LQ_TAKE /**< item can be taken by this lane */
+} tLaneQueueCheck;
+
+
+/**
+ * Checks whether the given item can be taken by the lane.
+ *
+ * @param[in] i - item index
+ * @param[in,out] param - user defined parameter
+ * @return check result
+ */
+typedef tLaneQueueCheck (* LaneQueueCheck)(const size_t i, void * param);
+
+
+size_t lq_take(size_t * next, const size_t count, LaneQueueCheck check, void * param);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __LQUEUE_H__ */
@@ -0,0 +1,251 @@
+/**
+ * @file lz.c
+ * @author Daniel Starke
+ * @see lz.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Fast LZ77 block codec. The output uses the LZ4 block format, i.e. a sequence
+ * of tokens with literal and match lengths in the high and low nibble,
+ * followed by the length extensions, the literals and a 16-bit little endian
+ * match offset.
+ */
+#include <string.h>
+#include "lz.h"
+
+
+/**
+ * Minimum match length.
+ */
+#define LZ_MIN_MATCH 4
+
+
+/**
+ * Number of bits for the match finder hash table index.
+ */
+#define LZ_HASH_BITS 12
+
+
+/**
+ * Number of bytes at the end which are always encoded as literals.
+ */
+#define LZ_LAST_LITERALS 5
+
+
+/**
+ * A match may not start within this number of bytes before the end.
+ */
+#define LZ_MF_LIMIT 12
+
+
+/**
+ * Maximum match offset.
+ */
+#define LZ_MAX_OFFSET 65535
+
+
+/**
+ * Reads 32 bits from the given unaligned address.
+ *
+ * @param[in] ptr - source address
+ * @return read value
+ */
+static uint32_t lz_read32(const uint8_t * ptr) {
+	uint32_t res;
+	memcpy(&res, ptr, sizeof(res));
+	return res;
+}
+
+
+/**
+ * Returns the hash table index for the given 4-byte sequence.
+ *
+ * @param[in] seq - byte sequence
+ * @return hash table index
+ */
+static size_t lz_hash(const uint32_t seq) {
+	return (size_t)((seq * UINT32_C(2654435761)) >> (32 - LZ_HASH_BITS));
+}
+
+
+/**
+ * Writes a length extension.
+ *
+ * @param[in,out] op - output pointer
+ * @param[in] len - remaining length above 15
+ * @return updated output pointer
+ */
+static uint8_t * lz_writeLen(uint8_t * op, size_t len) {
+	for (; len >= 255; len -= 255) {
+		*op++ = 255;
+	}
+	*op++ = (uint8_t)len;
+	return op;
+}
+
+
+/**
+ * Writes a single sequence of literals followed by an optional match.
+ *
+ * @param[in,out] op - output pointer
+ * @param[in] end - end of output buffer
+ * @param[in] lit - literals
+ * @param[in] litLen - number of literals
+ * @param[in] offset - match offset or 0 for the last sequence
+ * @param[in] matchLen - match length (at least `LZ_MIN_MATCH` if `offset` is not 0)
+ * @return updated output pointer or `NULL` if the output buffer is too small
+ */
+static uint8_t * lz_writeSeq(uint8_t * op, const uint8_t * end, const uint8_t * lit, const size_t litLen, const size_t offset, const size_t matchLen) {
+	const size_t mlCode = (offset != 0) ? (matchLen - LZ_MIN_MATCH) : 0;
+	const size_t need = 1 + (litLen / 255) + 1 + litLen + 2 + (mlCode / 255) + 1;
+	if (need > (size_t)(end - op)) {
+		return NULL;
+	}
+	uint8_t * token = op++;
+	*token = (uint8_t)(((litLen >= 15) ? 15 : litLen) << 4);
+	if (litLen >= 15) {
+		op = lz_writeLen(op, litLen - 15);
+	}
+	memcpy(op, lit, litLen);
+	op += litLen;
+	if (offset == 0) {
+		return op;
+	}
+	*op++ = (uint8_t)(offset & 0xFF);
+	*op++ = (uint8_t)(offset >> 8);
+	*token = (uint8_t)(*token | ((mlCode >= 15) ? 15 : mlCode));
+	if (mlCode >= 15) {
+		op = lz_writeLen(op, mlCode - 15);
+	}
+	return op;
+}
+
+
+/**
+ * Compresses the given data. The output buffer should have at least
+ * `LZ_BOUND(srcLen)` bytes.
+ *
+ * @param[in] src - input data
+ * @param[in] srcLen - input size in bytes
+ * @param[out] dst - output buffer
+ * @param[in] dstCap - output buffer size in bytes
+ * @param[out] dstLen - receives the compressed size in bytes
+ * @return `true` on success, else `false` if the output buffer is too small
+ */
+bool lz_compress(const void * src, const size_t srcLen, void * dst, const size_t dstCap, size_t * dstLen) {
+	if ((src == NULL && srcLen > 0) || dst == NULL || dstLen == NULL) {
+		return false;
+	}
+	const uint8_t * in = (const uint8_t *)src;
+	uint8_t * op = (uint8_t *)dst;
+	const uint8_t * end = op + dstCap;
+	size_t ip = 0;
+	size_t anchor = 0;
+	if (srcLen > LZ_MF_LIMIT) {
+		uint32_t table[1 << LZ_HASH_BITS]; /* position + 1 or 0 */
+		memset(table, 0, sizeof(table));
+		const size_t limit = srcLen - LZ_MF_LIMIT;
+		const size_t matchLimit = srcLen - LZ_LAST_LITERALS;
+		while (ip < limit) {
+			const uint32_t seq = lz_read32(in + ip);
+			const size_t h = lz_hash(seq);
+			const size_t ref = (size_t)(table[h]);
+			table[h] = (uint32_t)(ip + 1);
+			if (ref == 0 || (ip - (ref - 1)) > LZ_MAX_OFFSET || lz_read32(in + ref - 1) != seq) {
+				++ip;
+				continue;
+			}
+			const size_t match = ref - 1;
+			size_t len = LZ_MIN_MATCH;
+			while ((ip + len) < matchLimit && in[match + len] == in[ip + len]) {
+				++len;
+			}
+			op = lz_writeSeq(op, end, in + anchor, ip - anchor, ip - match, len);
+			if (op == NULL) {
+				return false;
+			}
+			ip += len;
+			anchor = ip;
+		}
+	}
+	op = lz_writeSeq(op, end, in + anchor, srcLen - anchor, 0, 0);
+	if (op == NULL) {
+		return false;
+	}
+	*dstLen = (size_t)(op - (uint8_t *)dst);
+	return true;
+}
+
+
+/**
+ * Decompresses the given data.
+ *
+ * @param[in] src - compressed data
+ * @param[in] srcLen - compressed size in bytes
+ * @param[out] dst - output buffer
+ * @param[in] dstCap - output buffer size in bytes
+ * @param[out] dstLen - receives the decompressed size in bytes
+ * @return `true` on success, else `false` on malformed input or if the output buffer is too small
+ */
+bool lz_decompress(const void * src, const size_t srcLen, void * dst, const size_t dstCap, size_t * dstLen) {
+	if (src == NULL || dst == NULL || dstLen == NULL) {
+		return false;
+	}
+	const uint8_t * in = (const uint8_t *)src;
+	uint8_t * out = (uint8_t *)dst;
+	size_t ip = 0;
+	size_t op = 0;
+	while (ip < srcLen) {
+		const uint8_t token = in[ip++];
+		size_t litLen = (size_t)(token >> 4);
+		if (litLen == 15) {
+			uint8_t b;
+			do {
+				if (ip >= srcLen) {
+					return false;
+				}
+				b = in[ip++];
+				litLen += b;
+			} while (b == 255);
+		}
+		if (litLen > (srcLen - ip) || litLen > (dstCap - op)) {
+			return false;
+		}
+		memcpy(out + op, in + ip, litLen);
+		ip += litLen;
+		op += litLen;
+		if (ip == srcLen) {
+			/* last sequence has no match */
+			break;
+		}
+		if ((srcLen - ip) < 2) {
+			return false;
+		}
+		const size_t offset = (size_t)(in[ip]) | ((size_t)(in[ip + 1]) << 8);
+		ip += 2;
+		if (offset == 0 || offset > op) {
+			return false;
+		}
+		size_t matchLen = (size_t)(token & 0x0F);
+		if (matchLen == 15) {
+			uint8_t b;
+			do {
+				if (ip >= srcLen) {
+					return false;
+				}
+				b = in[ip++];
+				matchLen += b;
+			} while (b == 255);
+		}
+		matchLen += LZ_MIN_MATCH;
+		if (matchLen > (dstCap - op)) {
+			return false;
+		}
+		/* byte wise as source and destination may overlap */
+		for (size_t i = 0; i < matchLen; ++i, ++op) {
+			out[op] = out[op - offset];
+		}
+	}
+	*dstLen = op;
+	return true;
+}
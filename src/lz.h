@@ -0,0 +1,39 @@
+/**
+ * @file lz.h
+ * @author Daniel Starke
+ * @see lz.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __LZ_H__
+#define __LZ_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Returns the maximum compressed size for the given input size.
+ *
+ * @param[in] n - input size in bytes
+ * @return maximum compressed size in bytes
+ */
+#define LZ_BOUND(n) ((n) + ((n) / 255) + 16)
+
+
+bool lz_compress(const void * src, const size_t srcLen, void * dst, const size_t dstCap, size_t * dstLen);
+bool lz_decompress(const void * src, const size_t srcLen, void * dst, const size_t dstCap, size_t * dstLen);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __LZ_H__ */
@@ -0,0 +1,155 @@
+/**
+ * @file procusage.c
+ * @author Daniel Starke
+ * @see procusage.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* for `wait4()` */
+#endif /* not _WIN32 and not _DEFAULT_SOURCE */
+#include <stddef.h>
+#include <string.h>
+#include "procusage.h"
+#ifdef PCF_IS_WIN
+#include <psapi.h>
+#else /* not PCF_IS_WIN */
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#endif /* not PCF_IS_WIN */
+
+
+#ifdef PCF_IS_WIN
+/**
+ * Converts the given `FILETIME` duration to microseconds.
+ *
+ * @param[in] ft - duration in 100ns units
+ * @return microseconds
+ */
+static uint64_t pu_fileTimeToUs(const FILETIME * ft) {
+	return ((((uint64_t)(ft->dwHighDateTime)) << 32) | (uint64_t)(ft->dwLowDateTime)) / 10;
+}
+
+
+/**
+ * Retrieves the consumed resources of the given process. This needs to be
+ * called after the process terminated and before its handle gets closed.
+ *
+ * @param[in] hProc - process handle with `PROCESS_QUERY_INFORMATION` and `PROCESS_VM_READ` access rights
+ * @param[out] usage - receives the consumed resources
+ * @return `true` on success, else `false` with `usage` being partially filled
+ */
+bool pu_fromHandle(HANDLE hProc, tProcUsage * usage) {
+	if (hProc == NULL || hProc == INVALID_HANDLE_VALUE || usage == NULL) {
+		return false;
+	}
+	bool res = true;
+	FILETIME creation, exitTime, kernel, user;
+	PROCESS_MEMORY_COUNTERS pmc;
+	IO_COUNTERS io;
+	memset(usage, 0, sizeof(*usage));
+	if ( GetProcessTimes(hProc, &creation, &exitTime, &kernel, &user) ) {
+		usage->userUs = pu_fileTimeToUs(&user);
+		usage->kernelUs = pu_fileTimeToUs(&kernel);
+	} else {
+		res = false;
+	}
+	memset(&pmc, 0, sizeof(pmc));
+	pmc.cb = sizeof(pmc);
+	if ( GetProcessMemoryInfo(hProc, &pmc, sizeof(pmc)) ) {
+		usage->peakWorkingSet = (uint64_t)(pmc.PeakWorkingSetSize);
+	} else {
+		res = false;
+	}
+	if ( GetProcessIoCounters(hProc, &io) ) {
+		usage->readBytes = (uint64_t)(io.ReadTransferCount);
+		usage->writeBytes = (uint64_t)(io.WriteTransferCount);
+		usage->readOps = (uint64_t)(io.ReadOperationCount);
+		usage->writeOps = (uint64_t)(io.WriteOperationCount);
+	} else {
+		res = false;
+	}
+	return res;
+}
+#else /* not PCF_IS_WIN */
+/**
+ * Reads the I/O counters of the given process from `/proc/<pid>/io`.
+ *
+ * @param[in] pid - process ID
+ * @param[in,out] usage - receives the I/O counters
+ * @return `true` on success, else `false`
+ */
+static bool pu_readProcIo(const pid_t pid, tProcUsage * usage) {
+	char path[64];
+	char line[128];
+	snprintf(path, sizeof(path), "/proc/%ld/io", (long)pid);
+	FILE * fp = fopen(path, "r");
+	if (fp == NULL) {
+		return false;
+	}
+	size_t found = 0;
+	while (fgets(line, (int)sizeof(line), fp) != NULL) {
+		static const struct {
+			const char * key;
+			size_t offset;
+		} fields[] = {
+			{"rchar: ", offsetof(tProcUsage, readBytes)},
+			{"wchar: ", offsetof(tProcUsage, writeBytes)},
+			{"syscr: ", offsetof(tProcUsage, readOps)},
+			{"syscw: ", offsetof(tProcUsage, writeOps)}
+		};
+		for (size_t i = 0; i < sizeof(fields) / sizeof(*fields); ++i) {
+			const size_t keyLen = strlen(fields[i].key);
+			if (strncmp(line, fields[i].key, keyLen) == 0) {
+				uint64_t * value = (uint64_t *)((uint8_t *)usage + fields[i].offset);
+				if (sscanf(line + keyLen, "%" SCNu64, value) == 1) {
+					++found;
+				}
+				break;
+			}
+		}
+	}
+	fclose(fp);
+	return found == 4;
+}
+
+
+/**
+ * Waits for the termination of the given child process, reaps it and
+ * retrieves its consumed resources.
+ *
+ * @param[in] pid - child process ID
+ * @param[out] status - receives the exit status as returned by `wait4()` (may be `NULL`)
+ * @param[out] usage - receives the consumed resources
+ * @return `true` on success, else `false` with `usage` being partially filled
+ * @remarks The I/O counters are read while the child is a zombie process.
+ */
+bool pu_wait(const pid_t pid, int * status, tProcUsage * usage) {
+	if (pid <= 0 || usage == NULL) {
+		return false;
+	}
+	bool res = true;
+	siginfo_t info;
+	struct rusage ru;
+	int st = 0;
+	memset(usage, 0, sizeof(*usage));
+	/* wait without reaping to keep `/proc/<pid>/io` accessible */
+	memset(&info, 0, sizeof(info));
+	if (waitid(P_PID, (id_t)pid, &info, WEXITED | WNOWAIT) != 0 || ( ! pu_readProcIo(pid, usage) )) {
+		res = false;
+	}
+	memset(&ru, 0, sizeof(ru));
+	if (wait4(pid, &st, 0, &ru) != pid) {
+		return false;
+	}
+	if (status != NULL) {
+		*status = st;
+	}
+	usage->userUs = ((uint64_t)(ru.ru_utime.tv_sec) * 1000000) + (uint64_t)(ru.ru_utime.tv_usec);
+	usage->kernelUs = ((uint64_t)(ru.ru_stime.tv_sec) * 1000000) + (uint64_t)(ru.ru_stime.tv_usec);
+	usage->peakWorkingSet = (uint64_t)(ru.ru_maxrss) * 1024; /* given in KiB */
+	return res;
+}
+#endif /* not PCF_IS_WIN */
@@ -0,0 +1,52 @@
+/**
+ * @file procusage.h
+ * @author Daniel Starke
+ * @see procusage.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __PROCUSAGE_H__
+#define __PROCUSAGE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "target.h"
+#ifdef PCF_IS_WIN
+#include <windows.h>
+#else /* not PCF_IS_WIN */
+#include <sys/types.h>
+#endif /* not PCF_IS_WIN */
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Resources consumed by a terminated child process.
+ */
+typedef struct {
+	uint64_t userUs; /**< user mode CPU time in microseconds */
+	uint64_t kernelUs; /**< kernel mode CPU time in microseconds */
+	uint64_t peakWorkingSet; /**< peak working set (resident set) size in bytes */
+	uint64_t readBytes; /**< number of bytes read */
+	uint64_t writeBytes; /**< number of bytes written */
+	uint64_t readOps; /**< number of read operations */
+	uint64_t writeOps; /**< number of write operations */
+} tProcUsage;
+
+
+#ifdef PCF_IS_WIN
+bool pu_fromHandle(HANDLE hProc, tProcUsage * usage);
+#else /* not PCF_IS_WIN */
+bool pu_wait(const pid_t pid, int * status, tProcUsage * usage);
+#endif /* not PCF_IS_WIN */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __PROCUSAGE_H__ */
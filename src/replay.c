@@ -0,0 +1,133 @@
+/**
+ * @file replay.c
+ * @author Daniel Starke
+ * @see replay.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Compact replay trace encoding. A trace file starts with `RPL_MAGIC` followed
+ * by events. Each event consists of its type byte, the time since the previous
+ * event in microseconds and the fields used by its type. All numbers are
+ * encoded as unsigned LEB128 variable length integers.
+ */
+#include "replay.h"
+
+
+/**
+ * Field usage per event type. Bit 0: item, bit 1: value, bit 2: value2.
+ */
+static const uint8_t rpl_fields[RPL_COUNT] = {
+	/* invalid */     0,
+	/* RPL_REQUEST */ 2,
+	/* RPL_ITEM */    1,
+	/* RPL_SPAWN */   1,
+	/* RPL_OUTPUT */  3,
+	/* RPL_EXIT */    7
+};
+
+
+/**
+ * Writes the given unsigned number as variable length integer.
+ *
+ * @param[in,out] buf - output buffer
+ * @param[in] value - value to write
+ * @return number of bytes written
+ */
+static size_t rpl_putVar(uint8_t * buf, uint64_t value) {
+	size_t n = 0;
+	while (value >= 0x80) {
+		buf[n++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	buf[n++] = (uint8_t)value;
+	return n;
+}
+
+
+/**
+ * Reads a variable length integer.
+ *
+ * @param[in] buf - input buffer
+ * @param[in] len - number of bytes in `buf`
+ * @param[out] value - receives the read value
+ * @return number of bytes read or 0 if incomplete or invalid
+ */
+static size_t rpl_getVar(const uint8_t * buf, const size_t len, uint64_t * value) {
+	uint64_t res = 0;
+	for (size_t n = 0; n < len && n < 10; ++n) {
+		res |= (uint64_t)(buf[n] & 0x7F) << (7 * n);
+		if ((buf[n] & 0x80) == 0) {
+			*value = res;
+			return n + 1;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * Encodes the given event.
+ *
+ * @param[out] buf - output buffer with at least `RPL_MAX_EVENT_SIZE` bytes
+ * @param[in,out] last - time of the previous event; updated to the time of `ev`
+ * @param[in] ev - event to encode
+ * @return number of bytes written or 0 on invalid event
+ */
+size_t rpl_encode(uint8_t * buf, uint64_t * last, const tReplayEvent * ev) {
+	if (buf == NULL || last == NULL || ev == NULL || ev->type <= 0 || ev->type >= RPL_COUNT) {
+		return 0;
+	}
+	const uint8_t fields = rpl_fields[ev->type];
+	size_t n = 0;
+	buf[n++] = (uint8_t)(ev->type);
+	n += rpl_putVar(buf + n, (ev->time > *last) ? ev->time - *last : 0);
+	if ((fields & 1) != 0) {
+		n += rpl_putVar(buf + n, ev->item);
+	}
+	if ((fields & 2) != 0) {
+		n += rpl_putVar(buf + n, ev->value);
+	}
+	if ((fields & 4) != 0) {
+		n += rpl_putVar(buf + n, ev->value2);
+	}
+	if (ev->time > *last) {
+		*last = ev->time;
+	}
+	return n;
+}
+
+
+/**
+ * Decodes the next event.
+ *
+ * @param[in] buf - input buffer
+ * @param[in] len - number of bytes in `buf`
+ * @param[in,out] last - time of the previous event; updated to the time of `ev`
+ * @param[out] ev - receives the decoded event
+ * @return number of bytes read or 0 if incomplete or invalid
+ */
+size_t rpl_decode(const uint8_t * buf, const size_t len, uint64_t * last, tReplayEvent * ev) {
+	if (buf == NULL || len < 2 || last == NULL || ev == NULL || buf[0] == 0 || buf[0] >= RPL_COUNT) {
+		return 0;
+	}
+	uint64_t values[4] = {0, 0, 0, 0};
+	const uint8_t fields = (uint8_t)((rpl_fields[buf[0]] << 1) | 1); /* bit 0: time */
+	size_t n = 1;
+	for (size_t i = 0; i < 4; ++i) {
+		if ((fields & (1 << i)) == 0) {
+			continue;
+		}
+		const size_t used = rpl_getVar(buf + n, len - n, values + i);
+		if (used == 0 || (i > 0 && values[i] > UINT32_MAX)) {
+			return 0;
+		}
+		n += used;
+	}
+	ev->type = (tReplayType)(buf[0]);
+	ev->time = *last + values[0];
+	ev->item = (uint32_t)(values[1]);
+	ev->value = (uint32_t)(values[2]);
+	ev->value2 = (uint32_t)(values[3]);
+	*last = ev->time;
+	return n;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file replay.h
+ * @author Daniel Starke
+ * @see replay.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Replay trace file magic.
+ */
+#define RPL_MAGIC "SIGUWIR1"
+
+
+/**
+ * Maximum encoded size of a single event in bytes.
+ */
+#define RPL_MAX_EVENT_SIZE 32
+
+
+/**
+ * Replay trace event types.
+ */
+typedef enum {
+	RPL_REQUEST = 1, /**< new request; value: `tReplaySource` */
+	RPL_ITEM, /**< item was queued */
+	RPL_SPAWN, /**< signing application was created */
+	RPL_OUTPUT, /**< signing application output was received; value: chunk size in bytes */
+	RPL_EXIT, /**< item finished; value: exit code or `UINT32_MAX`, value2: processing state */
+	RPL_COUNT /**< number of event types + 1 (not a type) */
+} tReplayType;
+
+
+/**
+ * Replay trace request sources.
+ */
+typedef enum {
+	RPS_COMMAND_LINE, /**< files passed on the command-line */
+	RPS_IPC, /**< files passed by an IPC client */
+	RPS_DROP, /**< files dropped onto the process window */
+	RPS_HTTP /**< files passed by a loopback HTTP client */
+} tReplaySource;
+
+
+/**
+ * Single replay trace event.
+ */
+typedef struct {
+	tReplayType type;
+	uint64_t time; /**< microseconds since the start of the recording */
+	uint32_t item; /**< item index */
+	uint32_t value;
+	uint32_t value2;
+} tReplayEvent;
+
+
+size_t rpl_encode(uint8_t * buf, uint64_t * last, const tReplayEvent * ev);
+size_t rpl_decode(const uint8_t * buf, const size_t len, uint64_t * last, tReplayEvent * ev);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __REPLAY_H__ */
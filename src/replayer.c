@@ -0,0 +1,769 @@
+/**
+ * @file replayer.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Replays a trace recorded with `siguwi --record` against a native model of
+ * the single lane processing engine. Each recorded item is re-queued at its
+ * recorded time and processed by a stub child which reproduces the recorded
+ * output chunk sizes, chunk timings and exit code. The engine side decodes and
+ * stores the output like the real one to measure its per item overhead.
+ */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* for `usleep()` and `readlink()` */
+#endif
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wchar.h>
+#include "crc32.h"
+#include "histogram.h"
+#include "lz.h"
+#include "procusage.h"
+#include "replay.h"
+#include "target.h"
+#include "ustrbuf.h"
+#include "utf8.h"
+#include "vector.h"
+#ifndef PCF_IS_WIN
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif /* not PCF_IS_WIN */
+
+
+#ifndef PCF_IS_WIN
+/**
+ * Read buffer size for the stub child output. Same as the engine.
+ */
+#define REPLAY_READ_SIZE (4*1024)
+
+
+/**
+ * Maximum number of output characters per item. Same as the engine.
+ */
+#define REPLAY_MAX_OUTPUT (1024*1024)
+
+
+/**
+ * Recorded output chunk.
+ */
+typedef struct {
+	uint64_t offset; /**< microseconds since spawn */
+	uint32_t size; /**< number of bytes */
+} tReplayChunk;
+
+
+/**
+ * Recorded item.
+ */
+typedef struct {
+	bool queued; /**< `RPL_ITEM` was seen */
+	bool spawned; /**< `RPL_SPAWN` was seen */
+	bool exited; /**< `RPL_EXIT` was seen */
+	uint64_t queueTime; /**< microseconds since the start of the recording */
+	uint64_t spawnTime; /**< microseconds since the start of the recording */
+	uint64_t exitTime; /**< microseconds since the start of the recording */
+	uint32_t exitCode; /**< recorded exit code or `UINT32_MAX` */
+	uint32_t state; /**< recorded final processing state */
+	uint64_t bytes; /**< total output bytes */
+	tVector * chunks; /**< output chunks (`tReplayChunk`) */
+} tReplayItem;
+
+
+/**
+ * Replay statistics of a single item in microseconds.
+ */
+typedef struct {
+	uint32_t item;
+	int exitCode;
+	uint64_t queueWait;
+	uint64_t spawn;
+	uint64_t firstOutput;
+	uint64_t childRuntime;
+	uint64_t finish;
+	uint64_t total;
+	uint64_t bytes;
+	uint64_t chunks;
+} tReplayResult;
+
+
+/**
+ * Replayed stage histograms.
+ */
+enum {
+	RST_QUEUE_WAIT,
+	RST_SPAWN,
+	RST_FIRST_OUTPUT,
+	RST_CHILD_RUNTIME,
+	RST_FINISH,
+	RST_TOTAL,
+	RST_COUNT
+};
+
+
+/** Replayed stage names. */
+static const char * const replayStageName[RST_COUNT] = {
+	"queueWait",
+	"spawn",
+	"firstOutput",
+	"childRuntime",
+	"finish",
+	"total"
+};
+
+
+/** Prevents that the compiler removes the output hashing. */
+static volatile uint32_t replaySink = 0;
+
+
+/**
+ * Returns the current monotonic time.
+ *
+ * @return time in microseconds
+ */
+static uint64_t replayNow(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)(ts.tv_sec) * UINT64_C(1000000)) + (uint64_t)(ts.tv_nsec / 1000);
+}
+
+
+/**
+ * Sleeps until the given monotonic time.
+ *
+ * @param[in] until - time in microseconds
+ */
+static void replaySleepUntil(const uint64_t until) {
+	for (uint64_t now = replayNow(); now < until; now = replayNow()) {
+		const uint64_t rem = until - now;
+		usleep((useconds_t)((rem > 1000000) ? 1000000 : rem));
+	}
+}
+
+
+/**
+ * Reads exactly the given number of bytes.
+ *
+ * @param[in] fd - file descriptor
+ * @param[out] buf - output buffer
+ * @param[in] len - number of bytes to read
+ * @return `true` on success, else `false`
+ */
+static bool replayReadAll(const int fd, void * buf, const size_t len) {
+	size_t pos = 0;
+	while (pos < len) {
+		const ssize_t n = read(fd, (uint8_t *)buf + pos, len - pos);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n <= 0) {
+			return false;
+		}
+		pos += (size_t)n;
+	}
+	return true;
+}
+
+
+/**
+ * Writes exactly the given number of bytes.
+ *
+ * @param[in] fd - file descriptor
+ * @param[in] buf - data to write
+ * @param[in] len - number of bytes to write
+ * @return `true` on success, else `false`
+ */
+static bool replayWriteAll(const int fd, const void * buf, const size_t len) {
+	size_t pos = 0;
+	while (pos < len) {
+		const ssize_t n = write(fd, (const uint8_t *)buf + pos, len - pos);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n <= 0) {
+			return false;
+		}
+		pos += (size_t)n;
+	}
+	return true;
+}
+
+
+/**
+ * Stub child entry point. Reads the I/O pattern from standard input and
+ * reproduces it on standard output. The pattern consists of the exit code,
+ * the number of chunks and the chunks (`tReplayChunk`) in host byte order.
+ *
+ * @return exit code to reproduce
+ */
+static int replayChild(void) {
+	static const char line[] = "Replayed signing application output line.\n";
+	int32_t exitCode;
+	uint32_t count;
+	if ( ! replayReadAll(STDIN_FILENO, &exitCode, sizeof(exitCode)) || ! replayReadAll(STDIN_FILENO, &count, sizeof(count)) ) {
+		return 126;
+	}
+	tReplayChunk * chunks = (count > 0) ? malloc(count * sizeof(tReplayChunk)) : NULL;
+	if (count > 0 && (chunks == NULL || ( ! replayReadAll(STDIN_FILENO, chunks, count * sizeof(tReplayChunk)) ))) {
+		free(chunks);
+		return 126;
+	}
+	close(STDIN_FILENO);
+	uint8_t * buf = malloc(REPLAY_READ_SIZE);
+	if (buf == NULL) {
+		free(chunks);
+		return 126;
+	}
+	for (size_t i = 0; i < REPLAY_READ_SIZE; ++i) {
+		buf[i] = (uint8_t)line[i % (sizeof(line) - 1)];
+	}
+	const uint64_t start = replayNow();
+	for (uint32_t i = 0; i < count; ++i) {
+		replaySleepUntil(start + chunks[i].offset);
+		for (uint32_t rem = chunks[i].size; rem > 0; ) {
+			const uint32_t n = (rem > REPLAY_READ_SIZE) ? REPLAY_READ_SIZE : rem;
+			if ( ! replayWriteAll(STDOUT_FILENO, buf, n) ) {
+				free(buf);
+				free(chunks);
+				return 126;
+			}
+			rem -= n;
+		}
+	}
+	free(buf);
+	free(chunks);
+	return (int)exitCode;
+}
+
+
+/**
+ * Releases the given item list.
+ *
+ * @param[in,out] items - recorded items or `NULL`
+ */
+static void replayFree(tVector * items) {
+	if (items == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < vec_size(items); ++i) {
+		tReplayItem * item = vec_at(items, i);
+		vec_delete(item->chunks);
+	}
+	vec_delete(items);
+}
+
+
+/**
+ * Returns the recorded item with the given index. The list is extended as
+ * needed.
+ *
+ * @param[in,out] items - recorded items
+ * @param[in] index - item index
+ * @return item or `NULL` on allocation error
+ */
+static tReplayItem * replayItem(tVector * items, const uint32_t index) {
+	while (vec_size(items) <= (size_t)index) {
+		tReplayItem * item = vec_pushBack(items);
+		if (item == NULL) {
+			return NULL;
+		}
+		memset(item, 0, sizeof(*item));
+		item->exitCode = UINT32_MAX;
+	}
+	return vec_at(items, (size_t)index);
+}
+
+
+/**
+ * Reads the given trace file.
+ *
+ * @param[in] path - trace file path
+ * @param[out] requests - receives the number of requests per source (4 entries)
+ * @param[out] duration - receives the recorded duration in microseconds
+ * @return recorded items or `NULL` on error
+ */
+static tVector * replayRead(const char * path, size_t * requests, uint64_t * duration) {
+	FILE * fp = fopen(path, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "Error: Failed to open \"%s\".\n", path);
+		return NULL;
+	}
+	tVector * items = vec_create(sizeof(tReplayItem));
+	uint8_t buf[4096];
+	size_t len = fread(buf, 1, sizeof(buf), fp);
+	if (items == NULL || len < 8 || memcmp(buf, RPL_MAGIC, 8) != 0) {
+		fprintf(stderr, "Error: \"%s\" is not a replay trace.\n", path);
+		goto onError;
+	}
+	size_t pos = 8;
+	uint64_t last = 0;
+	bool eof = false;
+	for (;;) {
+		if ( ! eof && (len - pos) < RPL_MAX_EVENT_SIZE ) {
+			memmove(buf, buf + pos, len - pos);
+			len -= pos;
+			pos = 0;
+			const size_t n = fread(buf + len, 1, sizeof(buf) - len, fp);
+			len += n;
+			eof = (n == 0);
+		}
+		if (pos >= len) {
+			break;
+		}
+		tReplayEvent ev;
+		const size_t used = rpl_decode(buf + pos, len - pos, &last, &ev);
+		if (used == 0) {
+			/* a truncated event at the end stems from an aborted recording */
+			if ( ! eof ) {
+				fprintf(stderr, "Error: Invalid event at offset %zu in \"%s\".\n", pos, path);
+				goto onError;
+			}
+			break;
+		}
+		pos += used;
+		*duration = ev.time;
+		if (ev.type == RPL_REQUEST) {
+			if (ev.value < 4) {
+				++(requests[ev.value]);
+			}
+			continue;
+		}
+		tReplayItem * item = replayItem(items, ev.item);
+		if (item == NULL) {
+			fprintf(stderr, "Error: Out of memory.\n");
+			goto onError;
+		}
+		switch (ev.type) {
+		case RPL_ITEM:
+			item->queued = true;
+			item->queueTime = ev.time;
+			break;
+		case RPL_SPAWN:
+			item->spawned = true;
+			item->spawnTime = ev.time;
+			break;
+		case RPL_OUTPUT:
+			if ( item->spawned ) {
+				if (item->chunks == NULL) {
+					item->chunks = vec_create(sizeof(tReplayChunk));
+				}
+				tReplayChunk * chunk = (item->chunks != NULL) ? vec_pushBack(item->chunks) : NULL;
+				if (chunk == NULL) {
+					fprintf(stderr, "Error: Out of memory.\n");
+					goto onError;
+				}
+				chunk->offset = ev.time - item->spawnTime;
+				chunk->size = ev.value;
+				item->bytes += ev.value;
+			}
+			break;
+		case RPL_EXIT:
+			item->exited = true;
+			item->exitTime = ev.time;
+			item->exitCode = ev.value;
+			item->state = ev.value2;
+			break;
+		default:
+			break;
+		}
+	}
+	fclose(fp);
+	return items;
+onError:
+	fclose(fp);
+	replayFree(items);
+	return NULL;
+}
+
+
+/**
+ * Writes a summary of the recorded trace to standard output.
+ *
+ * @param[in] items - recorded items
+ * @param[in] requests - number of requests per source
+ * @param[in] duration - recorded duration in microseconds
+ */
+static void replayInfo(tVector * items, const size_t * requests, const uint64_t duration) {
+	tHistogram arrival, chunkSize, runtime;
+	memset(&arrival, 0, sizeof(arrival));
+	memset(&chunkSize, 0, sizeof(chunkSize));
+	memset(&runtime, 0, sizeof(runtime));
+	size_t queued = 0, spawned = 0, failed = 0;
+	uint64_t chunks = 0, tiny = 0, bytes = 0, prev = 0;
+	for (size_t i = 0; i < vec_size(items); ++i) {
+		const tReplayItem * item = vec_at(items, i);
+		if ( ! item->queued ) {
+			continue;
+		}
+		if (queued > 0) {
+			hist_add(&arrival, item->queueTime - prev);
+		}
+		prev = item->queueTime;
+		++queued;
+		if ( ! item->spawned ) {
+			continue;
+		}
+		++spawned;
+		if (item->exitCode != 0) {
+			++failed;
+		}
+		if ( item->exited ) {
+			hist_add(&runtime, item->exitTime - item->spawnTime);
+		}
+		for (size_t j = 0; item->chunks != NULL && j < vec_size(item->chunks); ++j) {
+			const tReplayChunk * chunk = vec_at(item->chunks, j);
+			hist_add(&chunkSize, chunk->size);
+			tiny += (chunk->size <= 1) ? 1 : 0;
+			++chunks;
+		}
+		bytes += item->bytes;
+	}
+	printf("duration:      %.3f s\n", (double)duration / 1e6);
+	printf("requests:      %zu command-line, %zu IPC, %zu drop, %zu HTTP\n", requests[RPS_COMMAND_LINE], requests[RPS_IPC], requests[RPS_DROP], requests[RPS_HTTP]);
+	printf("items:         %zu queued, %zu spawned, %zu failed\n", queued, spawned, failed);
+	printf("output:        %" PRIu64 " bytes in %" PRIu64 " chunks (%" PRIu64 " of at most 1 byte)\n", bytes, chunks, tiny);
+	printf("%-14s %10s %10s %10s %10s\n", "", "p50", "p90", "p99", "max");
+	printf("%-14s %10.3f %10.3f %10.3f %10.3f\n", "arrival ms",
+		(double)hist_quantile(&arrival, 0.5) / 1e3, (double)hist_quantile(&arrival, 0.9) / 1e3,
+		(double)hist_quantile(&arrival, 0.99) / 1e3, (double)(arrival.max) / 1e3
+	);
+	printf("%-14s %10.3f %10.3f %10.3f %10.3f\n", "runtime ms",
+		(double)hist_quantile(&runtime, 0.5) / 1e3, (double)hist_quantile(&runtime, 0.9) / 1e3,
+		(double)hist_quantile(&runtime, 0.99) / 1e3, (double)(runtime.max) / 1e3
+	);
+	printf("%-14s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n", "chunk bytes",
+		hist_quantile(&chunkSize, 0.5), hist_quantile(&chunkSize, 0.9), hist_quantile(&chunkSize, 0.99), chunkSize.max
+	);
+}
+
+
+/**
+ * Decodes the given output chunk like the engine does.
+ *
+ * @param[in,out] utf8 - UTF-8 decoder state
+ * @param[in,out] output - decoded output
+ * @param[in,out] outputLen - number of decoded characters
+ * @param[in,out] lastChr - last decoded character
+ * @param[in] ptr - output chunk
+ * @param[in] len - number of bytes in `ptr`
+ */
+static void replayDecode(tUtf8Ctx * utf8, tUStrBuf * output, size_t * outputLen, uint32_t * lastChr, const uint8_t * ptr, const size_t len) {
+	for (size_t i = 0; i < len && *outputLen < REPLAY_MAX_OUTPUT; ++i) {
+		uint32_t cp = utf8_parse(utf8, ptr[i]);
+		if (cp == UTF8_MORE) {
+			continue;
+		}
+		if (cp > 0x10FFFF) {
+			cp = UTF8_ERROR;
+		}
+		if (cp == L'\n' && *lastChr != L'\r') {
+			usb_addC(output, L'\r');
+		}
+		if (cp != 0) {
+			usb_addC(output, (wchar_t)cp);
+		}
+		*lastChr = cp;
+		++(*outputLen);
+	}
+}
+
+
+/**
+ * Processes a single recorded item with a stub child.
+ *
+ * @param[in] self - path to this executable
+ * @param[in] item - recorded item
+ * @param[in] speed - time scale divisor or 0 to remove all delays
+ * @param[in] arrival - replayed queue time in microseconds
+ * @param[out] res - receives the replay statistics
+ * @return `true` on success, else `false`
+ */
+static bool replayProcess(const char * self, const tReplayItem * item, const double speed, const uint64_t arrival, tReplayResult * res) {
+	int pipeIn[2], pipeOut[2];
+	const uint64_t start = replayNow();
+	res->queueWait = (start > arrival) ? start - arrival : 0;
+	if (pipe(pipeIn) != 0) {
+		return false;
+	}
+	if (pipe(pipeOut) != 0) {
+		close(pipeIn[0]);
+		close(pipeIn[1]);
+		return false;
+	}
+	const pid_t pid = fork();
+	if (pid == 0) {
+		dup2(pipeIn[0], STDIN_FILENO);
+		dup2(pipeOut[1], STDOUT_FILENO);
+		close(pipeIn[0]);
+		close(pipeIn[1]);
+		close(pipeOut[0]);
+		close(pipeOut[1]);
+		execl(self, self, "--child", (char *)NULL);
+		_exit(127);
+	}
+	close(pipeIn[0]);
+	close(pipeOut[1]);
+	if (pid < 0) {
+		close(pipeIn[1]);
+		close(pipeOut[0]);
+		return false;
+	}
+	const uint64_t spawned = replayNow();
+	res->spawn = spawned - start;
+	/* pass the I/O pattern */
+	const size_t count = (item->chunks != NULL) ? vec_size(item->chunks) : 0;
+	const int32_t exitCode = (item->exitCode == UINT32_MAX) ? 1 : (int32_t)(item->exitCode & 0xFF);
+	const uint32_t count32 = (uint32_t)count;
+	bool ok = replayWriteAll(pipeIn[1], &exitCode, sizeof(exitCode)) && replayWriteAll(pipeIn[1], &count32, sizeof(count32));
+	for (size_t i = 0; ok && i < count; ++i) {
+		tReplayChunk chunk = *(const tReplayChunk *)vec_at(item->chunks, i);
+		chunk.offset = (speed > 0.0) ? (uint64_t)((double)(chunk.offset) / speed) : 0;
+		ok = replayWriteAll(pipeIn[1], &chunk, sizeof(chunk));
+	}
+	close(pipeIn[1]);
+	/* read and decode the output like the engine */
+	tUStrBuf * output = usb_create(4096);
+	tUtf8Ctx utf8;
+	memset(&utf8, 0, sizeof(utf8));
+	size_t outputLen = 0;
+	uint32_t lastChr = 0;
+	uint8_t buf[REPLAY_READ_SIZE];
+	res->firstOutput = 0;
+	res->bytes = 0;
+	res->chunks = 0;
+	for (;;) {
+		const ssize_t n = read(pipeOut[0], buf, sizeof(buf));
+		if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n <= 0) {
+			break;
+		}
+		if (res->chunks == 0) {
+			res->firstOutput = replayNow() - spawned;
+		}
+		++(res->chunks);
+		res->bytes += (uint64_t)n;
+		if (output != NULL) {
+			replayDecode(&utf8, output, &outputLen, &lastChr, buf, (size_t)n);
+		}
+	}
+	close(pipeOut[0]);
+	const uint64_t eof = replayNow();
+	int status = 0;
+	tProcUsage usage;
+	if ( ! pu_wait(pid, &status, &usage) ) {
+		ok = false;
+	}
+	const uint64_t exited = replayNow();
+	res->childRuntime = exited - spawned;
+	res->exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+	if (res->exitCode != exitCode) {
+		ok = false;
+	}
+	/* store the output like the engine */
+	if (output != NULL) {
+		const wchar_t * str = usb_get(output);
+		const size_t rawSize = usb_len(output) * sizeof(wchar_t);
+		const size_t bound = LZ_BOUND(rawSize);
+		uint8_t * comp = malloc(bound);
+		size_t compLen = 0;
+		if (comp != NULL && str != NULL) {
+			lz_compress(str, rawSize, comp, bound, &compLen);
+			replaySink ^= crc32Update(UINT32_MAX, str, rawSize) ^ UINT32_MAX;
+		}
+		free(comp);
+		usb_delete(output);
+	}
+	const uint64_t done = replayNow();
+	res->finish = done - ((eof > exited) ? eof : exited);
+	res->total = done - arrival;
+	return ok;
+}
+
+
+/**
+ * Writes the command-line help to standard error.
+ *
+ * @param[in] name - program name
+ */
+static void replayHelp(const char * name) {
+	fprintf(stderr,
+		"%s [options] <trace>\n"
+		"\n"
+		"Replays a trace recorded with `siguwi --record` using stub signing\n"
+		"applications which reproduce the recorded output chunks, timings and exit\n"
+		"codes.\n"
+		"\n"
+		"-h, --help\n"
+		"      Print short usage instruction.\n"
+		"-i, --info\n"
+		"      Print a summary of the trace without replaying it.\n"
+		"-o, --output <file>\n"
+		"      Write the per item results as CSV to this file.\n"
+		"-s, --speed <factor>\n"
+		"      Replay faster (>1) or slower (<1). 0 removes all delays. Default: 1\n",
+		name
+	);
+}
+
+
+/**
+ * Main entry point.
+ *
+ * @param[in] argc - number of command-line arguments
+ * @param[in] argv - command-line arguments
+ * @return 0 on success, 1 if the replay deviated from the trace, 2 on error
+ */
+int main(int argc, char ** argv) {
+	const char * tracePath = NULL;
+	const char * outputPath = NULL;
+	bool info = false;
+	double speed = 1.0;
+	if (argc == 2 && strcmp(argv[1], "--child") == 0) {
+		return replayChild();
+	}
+	for (int i = 1; i < argc; ++i) {
+		const char * arg = argv[i];
+		const char * value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+			replayHelp(argv[0]);
+			return EXIT_SUCCESS;
+		} else if (strcmp(arg, "-i") == 0 || strcmp(arg, "--info") == 0) {
+			info = true;
+			continue;
+		} else if (arg[0] != '-' && tracePath == NULL) {
+			tracePath = arg;
+			continue;
+		} else if (value == NULL) {
+			fprintf(stderr, "Error: Invalid or incomplete argument \"%s\".\n", arg);
+			return 2;
+		} else if (strcmp(arg, "-o") == 0 || strcmp(arg, "--output") == 0) {
+			outputPath = value;
+		} else if (strcmp(arg, "-s") == 0 || strcmp(arg, "--speed") == 0) {
+			char * end = NULL;
+			speed = strtod(value, &end);
+			if (end == value || *end != 0 || speed < 0.0) {
+				fprintf(stderr, "Error: Invalid speed \"%s\".\n", value);
+				return 2;
+			}
+		} else {
+			fprintf(stderr, "Error: Invalid or incomplete argument \"%s\".\n", arg);
+			return 2;
+		}
+		++i;
+	}
+	if (tracePath == NULL) {
+		replayHelp(argv[0]);
+		return 2;
+	}
+	size_t requests[4] = {0, 0, 0, 0};
+	uint64_t duration = 0;
+	tVector * items = replayRead(tracePath, requests, &duration);
+	if (items == NULL) {
+		return 2;
+	}
+	if ( info ) {
+		replayInfo(items, requests, duration);
+		replayFree(items);
+		return EXIT_SUCCESS;
+	}
+	char self[4096];
+	const ssize_t selfLen = readlink("/proc/self/exe", self, sizeof(self) - 1);
+	if (selfLen > 0) {
+		self[selfLen] = 0;
+	} else {
+		snprintf(self, sizeof(self), "%s", argv[0]);
+	}
+	FILE * out = NULL;
+	if (outputPath != NULL) {
+		out = fopen(outputPath, "w");
+		if (out == NULL) {
+			fprintf(stderr, "Error: Failed to create \"%s\".\n", outputPath);
+			replayFree(items);
+			return 2;
+		}
+		fprintf(out, "item,exitCode,queueWaitMs,spawnMs,firstOutputMs,childRuntimeMs,finishMs,totalMs,bytes,chunks\n");
+	}
+	signal(SIGPIPE, SIG_IGN);
+	/* replay in queue order on a single lane like the engine */
+	tHistogram hist[RST_COUNT];
+	memset(hist, 0, sizeof(hist));
+	size_t done = 0, deviations = 0;
+	uint64_t bytes = 0, lastDone = 0;
+	struct rusage ruStart, ruEnd;
+	getrusage(RUSAGE_SELF, &ruStart);
+	const uint64_t t0 = replayNow();
+	for (size_t i = 0; i < vec_size(items); ++i) {
+		const tReplayItem * item = vec_at(items, i);
+		if ( ! item->queued || ! item->spawned ) {
+			continue;
+		}
+		const uint64_t arrival = t0 + ((speed > 0.0) ? (uint64_t)((double)(item->queueTime) / speed) : 0);
+		replaySleepUntil(arrival);
+		tReplayResult r;
+		memset(&r, 0, sizeof(r));
+		r.item = (uint32_t)i;
+		if ( ! replayProcess(self, item, speed, arrival, &r) ) {
+			++deviations;
+		}
+		lastDone = replayNow();
+		++done;
+		bytes += r.bytes;
+		const uint64_t values[RST_COUNT] = {r.queueWait, r.spawn, r.firstOutput, r.childRuntime, r.finish, r.total};
+		for (size_t s = 0; s < RST_COUNT; ++s) {
+			hist_add(hist + s, values[s]);
+		}
+		if (out != NULL) {
+			fprintf(out, "%" PRIu32 ",%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%" PRIu64 ",%" PRIu64 "\n",
+				r.item, r.exitCode,
+				(double)(r.queueWait) / 1e3, (double)(r.spawn) / 1e3, (double)(r.firstOutput) / 1e3,
+				(double)(r.childRuntime) / 1e3, (double)(r.finish) / 1e3, (double)(r.total) / 1e3,
+				r.bytes, r.chunks
+			);
+		}
+	}
+	getrusage(RUSAGE_SELF, &ruEnd);
+	if (out != NULL) {
+		fclose(out);
+	}
+	replayFree(items);
+	/* report */
+	const double elapsed = (double)(lastDone - t0) / 1e6;
+	const double cpuUs =
+		((double)(ruEnd.ru_utime.tv_sec - ruStart.ru_utime.tv_sec) * 1e6 + (double)(ruEnd.ru_utime.tv_usec - ruStart.ru_utime.tv_usec)) +
+		((double)(ruEnd.ru_stime.tv_sec - ruStart.ru_stime.tv_sec) * 1e6 + (double)(ruEnd.ru_stime.tv_usec - ruStart.ru_stime.tv_usec));
+	printf("items:         %zu replayed, %zu deviating\n", done, deviations);
+	printf("output:        %" PRIu64 " bytes\n", bytes);
+	printf("duration:      %.3f s (recorded %.3f s)\n", elapsed, (double)duration / 1e6);
+	printf("throughput:    %.2f items/s\n", (elapsed > 0.0) ? (double)done / elapsed : 0.0);
+	printf("engine CPU:    %.1f us/item\n", (done > 0) ? cpuUs / (double)done : 0.0);
+	printf("%-14s %10s %10s %10s %10s\n", "ms", "p50", "p90", "p99", "max");
+	for (size_t s = 0; s < RST_COUNT; ++s) {
+		printf("%-14s %10.3f %10.3f %10.3f %10.3f\n", replayStageName[s],
+			(double)hist_quantile(hist + s, 0.5) / 1e3, (double)hist_quantile(hist + s, 0.9) / 1e3,
+			(double)hist_quantile(hist + s, 0.99) / 1e3, (double)(hist[s].max) / 1e3
+		);
+	}
+	return (deviations > 0) ? 1 : EXIT_SUCCESS;
+}
+#else /* PCF_IS_WIN */
+/**
+ * Main entry point.
+ *
+ * @param[in] argc - number of command-line arguments
+ * @param[in] argv - command-line arguments
+ * @return always 2
+ */
+int main(int argc, char ** argv) {
+	(void)argc;
+	(void)argv;
+	fprintf(stderr, "Error: The replayer requires a POSIX system.\n");
+	return 2;
+}
+#endif /* PCF_IS_WIN */
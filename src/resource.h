@@ -2,7 +2,7 @@
  * @file resource.h
  * @author Daniel Starke
  * @date 2025-06-19
- * @version 2025-07-20
+ * @version 2026-10-18
  */
 #ifndef __RESOURCE_H__
 #define __RESOURCE_H__
@@ -13,12 +13,16 @@
 #endif
 
 
-#define IDI_APP_ICON     101
-#define IDC_CONFIG_CBOX  102
-#define IDC_CONFIG_VIEW  103
-#define IDC_SAVE_AS      104
-#define IDC_PROCESS_LIST 201
-#define IDC_PROCESS_INFO 202
+#define IDI_APP_ICON       101
+#define IDC_CONFIG_CBOX    102
+#define IDC_CONFIG_VIEW    103
+#define IDC_SAVE_AS        104
+#define IDC_PROCESS_LIST   201
+#define IDC_PROCESS_INFO   202
+#define IDC_PROCESS_STATUS 203
+#define IDC_PROCESS_SEARCH 204
+#define IDM_PROCESS_REPORT 208 /* system menu IDs need the lower 4 bits to be zero */
+#define IDM_PROCESS_TIMES  224
 
 
 #endif /* __RESOURCE_H__ */
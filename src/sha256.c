@@ -0,0 +1,227 @@
+/**
+ * @file sha256.c
+ * @author Daniel Starke
+ * @see sha256.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Streaming SHA-256 implementation according to FIPS 180-4 and HMAC-SHA256
+ * according to RFC 2104.
+ */
+#include <string.h>
+#include "sha256.h"
+
+
+/**
+ * SHA-256 round constants.
+ */
+static const uint32_t sha256K[64] = {
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+	0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+	0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+	0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+	0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+	0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+
+/** Rotates the given 32-bit value right by `n` bits. */
+#define SHA256_ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+
+/**
+ * Hashes the given number of complete 64 byte blocks.
+ *
+ * @param[in,out] state - intermediate hash value
+ * @param[in] data - input blocks
+ * @param[in] blocks - number of blocks in `data`
+ */
+static void sha256Blocks(uint32_t * state, const uint8_t * data, size_t blocks) {
+	uint32_t w[64];
+	for (; blocks > 0; --blocks, data += 64) {
+		for (size_t i = 0; i < 16; ++i) {
+			w[i] = ((uint32_t)(data[4 * i]) << 24) | ((uint32_t)(data[(4 * i) + 1]) << 16) | ((uint32_t)(data[(4 * i) + 2]) << 8) | (uint32_t)(data[(4 * i) + 3]);
+		}
+		for (size_t i = 16; i < 64; ++i) {
+			const uint32_t s0 = SHA256_ROR(w[i - 15], 7) ^ SHA256_ROR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			const uint32_t s1 = SHA256_ROR(w[i - 2], 17) ^ SHA256_ROR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+		uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+		for (size_t i = 0; i < 64; ++i) {
+			const uint32_t t1 = h + (SHA256_ROR(e, 6) ^ SHA256_ROR(e, 11) ^ SHA256_ROR(e, 25)) + ((e & f) ^ (~e & g)) + sha256K[i] + w[i];
+			const uint32_t t2 = (SHA256_ROR(a, 2) ^ SHA256_ROR(a, 13) ^ SHA256_ROR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+}
+
+
+/**
+ * Initializes the given SHA-256 hashing context.
+ *
+ * @param[out] ctx - hashing context
+ */
+void sha256Init(tSha256 * ctx) {
+	static const uint32_t init[8] = {
+		0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+	};
+	if (ctx == NULL) {
+		return;
+	}
+	memcpy(ctx->state, init, sizeof(init));
+	ctx->length = 0;
+	ctx->bufLen = 0;
+}
+
+
+/**
+ * Adds the given data to the SHA-256 hashing context.
+ *
+ * @param[in,out] ctx - hashing context
+ * @param[in] data - data to hash
+ * @param[in] len - size of `data` in bytes
+ */
+void sha256Update(tSha256 * ctx, const void * data, size_t len) {
+	if (ctx == NULL || data == NULL || len == 0) {
+		return;
+	}
+	const uint8_t * ptr = (const uint8_t *)data;
+	ctx->length += (uint64_t)len;
+	if (ctx->bufLen > 0) {
+		const size_t n = (len < (64 - ctx->bufLen)) ? len : (64 - ctx->bufLen);
+		memcpy(ctx->buf + ctx->bufLen, ptr, n);
+		ctx->bufLen += n;
+		ptr += n;
+		len -= n;
+		if (ctx->bufLen < 64) {
+			return;
+		}
+		sha256Blocks(ctx->state, ctx->buf, 1);
+		ctx->bufLen = 0;
+	}
+	/* hash complete blocks directly from the input */
+	sha256Blocks(ctx->state, ptr, len / 64);
+	ptr += len & ~(size_t)63;
+	len &= 63;
+	memcpy(ctx->buf, ptr, len);
+	ctx->bufLen = len;
+}
+
+
+/**
+ * Finishes the SHA-256 hashing context and returns the digest. The context
+ * needs to be initialized again before it can be reused.
+ *
+ * @param[in,out] ctx - hashing context
+ * @param[out] digest - receives `SHA256_SIZE` bytes
+ */
+void sha256Final(tSha256 * ctx, uint8_t * digest) {
+	if (ctx == NULL || digest == NULL) {
+		return;
+	}
+	const uint64_t bits = ctx->length * 8;
+	ctx->buf[ctx->bufLen++] = 0x80;
+	if (ctx->bufLen > 56) {
+		memset(ctx->buf + ctx->bufLen, 0, 64 - ctx->bufLen);
+		sha256Blocks(ctx->state, ctx->buf, 1);
+		ctx->bufLen = 0;
+	}
+	memset(ctx->buf + ctx->bufLen, 0, 56 - ctx->bufLen);
+	for (size_t i = 0; i < 8; ++i) {
+		ctx->buf[56 + i] = (uint8_t)(bits >> (56 - (8 * i)));
+	}
+	sha256Blocks(ctx->state, ctx->buf, 1);
+	for (size_t i = 0; i < 8; ++i) {
+		digest[4 * i] = (uint8_t)(ctx->state[i] >> 24);
+		digest[(4 * i) + 1] = (uint8_t)(ctx->state[i] >> 16);
+		digest[(4 * i) + 2] = (uint8_t)(ctx->state[i] >> 8);
+		digest[(4 * i) + 3] = (uint8_t)(ctx->state[i]);
+	}
+}
+
+
+/**
+ * Initializes the given HMAC-SHA256 context with the passed key.
+ *
+ * @param[out] ctx - authentication context
+ * @param[in] key - secret key
+ * @param[in] len - length of `key` in bytes
+ */
+void hmacSha256Init(tHmacSha256 * ctx, const void * key, size_t len) {
+	if (ctx == NULL || (key == NULL && len > 0)) {
+		return;
+	}
+	uint8_t pad[64];
+	memset(pad, 0, sizeof(pad));
+	if (len > sizeof(pad)) {
+		/* long keys are hashed first */
+		sha256Init(&(ctx->inner));
+		sha256Update(&(ctx->inner), key, len);
+		sha256Final(&(ctx->inner), pad);
+	} else if (len > 0) {
+		memcpy(pad, key, len);
+	}
+	for (size_t i = 0; i < sizeof(pad); ++i) {
+		pad[i] ^= 0x36;
+	}
+	sha256Init(&(ctx->inner));
+	sha256Update(&(ctx->inner), pad, sizeof(pad));
+	for (size_t i = 0; i < sizeof(pad); ++i) {
+		pad[i] ^= 0x36 ^ 0x5C;
+	}
+	sha256Init(&(ctx->outer));
+	sha256Update(&(ctx->outer), pad, sizeof(pad));
+	memset(pad, 0, sizeof(pad));
+}
+
+
+/**
+ * Adds the given data to the authenticated message.
+ *
+ * @param[in,out] ctx - authentication context
+ * @param[in] data - input data
+ * @param[in] len - length of `data` in bytes
+ */
+void hmacSha256Update(tHmacSha256 * ctx, const void * data, size_t len) {
+	if (ctx == NULL) {
+		return;
+	}
+	sha256Update(&(ctx->inner), data, len);
+}
+
+
+/**
+ * Finishes the HMAC-SHA256 context and returns the message authentication
+ * code. The context needs to be initialized again before it can be reused.
+ *
+ * @param[in,out] ctx - authentication context
+ * @param[out] digest - receives `SHA256_SIZE` bytes
+ */
+void hmacSha256Final(tHmacSha256 * ctx, uint8_t * digest) {
+	if (ctx == NULL || digest == NULL) {
+		return;
+	}
+	uint8_t inner[SHA256_SIZE];
+	sha256Final(&(ctx->inner), inner);
+	sha256Update(&(ctx->outer), inner, sizeof(inner));
+	sha256Final(&(ctx->outer), digest);
+}
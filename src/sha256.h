@@ -0,0 +1,59 @@
+/**
+ * @file sha256.h
+ * @author Daniel Starke
+ * @see sha256.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __SHA256_H__
+#define __SHA256_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * SHA-256 digest size in bytes.
+ */
+#define SHA256_SIZE 32
+
+
+/**
+ * SHA-256 hashing context.
+ */
+typedef struct {
+	uint32_t state[8]; /**< intermediate hash value */
+	uint64_t length; /**< number of hashed bytes */
+	uint8_t buf[64]; /**< incomplete block */
+	size_t bufLen; /**< bytes in `buf` */
+} tSha256;
+
+
+
+/**
+ * HMAC-SHA256 message authentication context.
+ */
+typedef struct {
+	tSha256 inner; /**< hash of the inner padded key and the message */
+	tSha256 outer; /**< hash of the outer padded key */
+} tHmacSha256;
+
+void sha256Init(tSha256 * ctx);
+void sha256Update(tSha256 * ctx, const void * data, size_t len);
+void sha256Final(tSha256 * ctx, uint8_t * digest);
+void hmacSha256Init(tHmacSha256 * ctx, const void * key, size_t len);
+void hmacSha256Update(tHmacSha256 * ctx, const void * data, size_t len);
+void hmacSha256Final(tHmacSha256 * ctx, uint8_t * digest);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __SHA256_H__ */
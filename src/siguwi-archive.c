@@ -0,0 +1,632 @@
+/**
+ * @file siguwi-archive.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Replacement callback context for `zip_rewrite()`.
+ */
+typedef struct {
+	tArchive * archive;
+	size_t next; /**< next candidate index in `archive->entries` */
+	FILE * fp; /**< currently opened replacement file or `NULL` */
+} tArchiveRewrite;
+
+
+/**
+ * Returns the directory of the given extracted entry within the temporary
+ * archive directory.
+ *
+ * @param[in] a - archive
+ * @param[in] index - entry index within the archive
+ * @param[out] buf - output buffer
+ * @param[in] len - output buffer size in number of characters
+ */
+static void archiveEntryDir(const tArchive * a, const size_t index, wchar_t * buf, const size_t len) {
+	snwprintf(buf, len, L"%s%zu", a->tmpDir, index);
+	buf[len - 1] = 0;
+}
+
+
+/**
+ * Removes all extracted entries and the temporary archive directory.
+ *
+ * @param[in,out] a - archive
+ */
+static void archiveCleanup(tArchive * a) {
+	wchar_t dir[MAX_PATH + 1];
+	if (a->entries != NULL) {
+		const size_t count = vec_size(a->entries);
+		for (size_t i = 0; i < count; ++i) {
+			tArchiveEntry * e = vec_at(a->entries, i);
+			if (e->path != NULL) {
+				DeleteFileW(e->path);
+				wStrDelete(&(e->path));
+			}
+			archiveEntryDir(a, e->index, dir, ARRAY_SIZE(dir));
+			RemoveDirectoryW(dir);
+		}
+		vec_clear(a->entries);
+	}
+	if (a->tmpDir != NULL) {
+		RemoveDirectoryW(a->tmpDir);
+		wStrDelete(&(a->tmpDir));
+	}
+}
+
+
+/**
+ * Creates a new unique temporary directory for the extracted entries of the
+ * given archive.
+ *
+ * @param[in,out] a - archive
+ * @return `true` on success, else `false`
+ */
+static bool archiveCreateTmpDir(tArchive * a) {
+	static unsigned serial = 0;
+	wchar_t tmp[MAX_PATH + 1];
+	wchar_t dir[MAX_PATH + 1];
+	const DWORD len = GetTempPathW(MAX_PATH + 1, tmp);
+	if (len == 0 || len > MAX_PATH) {
+		return false;
+	}
+	for (unsigned i = 0; i < 100; ++i) {
+		snwprintf(dir, ARRAY_SIZE(dir), L"%ssiguwi-%lu-%u", tmp, (unsigned long)GetCurrentProcessId(), ++serial);
+		dir[MAX_PATH] = 0;
+		if ( CreateDirectoryW(dir, NULL) ) {
+			wcscat_s(dir, ARRAY_SIZE(dir), L"\\");
+			a->tmpDir = wcsdup(dir);
+			return a->tmpDir != NULL;
+		}
+		if (GetLastError() != ERROR_ALREADY_EXISTS) {
+			break;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Extracts the given archive entry to its own directory within the temporary
+ * archive directory. The extracted file keeps the entry file name.
+ *
+ * @param[in,out] a - archive
+ * @param[in,out] z - opened archive
+ * @param[in] index - entry index
+ * @param[in] name - entry file name
+ * @return `true` on success, else `false`
+ */
+static bool archiveExtract(tArchive * a, tZip * z, const size_t index, const wchar_t * name) {
+	wchar_t dir[MAX_PATH + 1];
+	archiveEntryDir(a, index, dir, ARRAY_SIZE(dir));
+	if ( ! CreateDirectoryW(dir, NULL) ) {
+		return false;
+	}
+	tArchiveEntry * e = vec_pushBack(a->entries);
+	if (e == NULL) {
+		RemoveDirectoryW(dir);
+		return false;
+	}
+	e->index = index;
+	e->path = malloc((wcslen(dir) + wcslen(name) + 2) * sizeof(wchar_t));
+	if (e->path == NULL) {
+		return false;
+	}
+	wcscpy(e->path, dir);
+	wcscat(e->path, L"\\");
+	wcscat(e->path, name);
+	FILE * fp = _wfopen(e->path, L"wb");
+	if (fp == NULL) {
+		return false;
+	}
+	const bool res = zip_extract(z, index, fp);
+	return (fclose(fp) == 0) && res;
+}
+
+
+/**
+ * Passes the signed file of the given entry to `zip_rewrite()`. This is
+ * compatible with `ZipReplaceCallback`.
+ *
+ * @param[in] entry - archive entry (unused)
+ * @param[in] i - entry index
+ * @param[in,out] param - `tArchiveRewrite` context
+ * @return signed file or `NULL` to copy the entry verbatim
+ */
+static FILE * archiveReplace(const tZipEntry * entry, const size_t i, void * param) {
+	PCF_UNUSED(entry);
+	tArchiveRewrite * rw = (tArchiveRewrite *)param;
+	if (rw->fp != NULL) {
+		fclose(rw->fp);
+		rw->fp = NULL;
+	}
+	tArchiveEntry * e = vec_at(rw->archive->entries, rw->next);
+	if (e == NULL || e->index != i) {
+		return NULL;
+	}
+	++(rw->next);
+	rw->fp = _wfopen(e->path, L"rb");
+	if (rw->fp == NULL) {
+		/* the entry is copied verbatim -> mark the rewrite as failed */
+		rw->archive->failed = SIZE_MAX;
+	}
+	return rw->fp;
+}
+
+
+/**
+ * Writes the archive back with all signed entries. The compressed data of all
+ * other entries is copied verbatim. The archive is replaced atomically.
+ *
+ * @param[in,out] a - archive
+ * @return `true` on success, else `false` with the error code in `GetLastError()`
+ */
+static bool archiveRewrite(tArchive * a) {
+	const size_t len = wcslen(a->path) + 8;
+	wchar_t * tmpPath = malloc(len * sizeof(wchar_t));
+	tArchiveRewrite rw = {a, 0, NULL};
+	FILE * in = NULL;
+	FILE * out = NULL;
+	tZip * z = NULL;
+	bool res = false;
+	DWORD err = ERROR_WRITE_FAULT;
+	if (tmpPath == NULL) {
+		SetLastError(ERROR_OUTOFMEMORY);
+		return false;
+	}
+	snwprintf(tmpPath, len, L"%s.siguwi", a->path);
+	tmpPath[len - 1] = 0;
+	in = _wfopen(a->path, L"rb");
+	if (in == NULL) {
+		err = ERROR_OPEN_FAILED;
+		goto onError;
+	}
+	z = zip_open(in);
+	if (z == NULL) {
+		err = ERROR_BAD_FORMAT;
+		goto onError;
+	}
+	out = _wfopen(tmpPath, L"w+b");
+	if (out == NULL) {
+		err = ERROR_OPEN_FAILED;
+		goto onError;
+	}
+	res = zip_rewrite(z, out, archiveReplace, &rw) && rw.next == vec_size(a->entries) && a->failed == 0;
+	if (rw.fp != NULL) {
+		fclose(rw.fp);
+	}
+	res = (fclose(out) == 0) && res;
+	out = NULL;
+	zip_close(z);
+	z = NULL;
+	fclose(in);
+	in = NULL;
+	if ( res ) {
+		res = MoveFileExW(tmpPath, a->path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+		err = GetLastError();
+	}
+onError:
+	if (out != NULL) {
+		fclose(out);
+	}
+	zip_close(z);
+	if (in != NULL) {
+		fclose(in);
+	}
+	if ( ! res ) {
+		DeleteFileW(tmpPath);
+	}
+	free(tmpPath);
+	if ( ! res ) {
+		SetLastError(err);
+	}
+	return res;
+}
+
+
+/**
+ * Extracts the entries of the given archive which are signable by their file
+ * extension. Only these entries are decompressed. This is called by the archive
+ * thread.
+ *
+ * @param[in,out] a - archive
+ * @return `true` on success, else `false`
+ */
+static bool archiveExtractAll(tArchive * a) {
+	FILE * fp = NULL;
+	tZip * z = NULL;
+	wchar_t * name = NULL;
+	bool res = false;
+	fp = _wfopen(a->path, L"rb");
+	if (fp == NULL) {
+		goto onError;
+	}
+	z = zip_open(fp);
+	if (z == NULL || ( ! archiveCreateTmpDir(a) )) {
+		goto onError;
+	}
+	for (size_t i = 0; i < z->count; ++i) {
+		const tZipEntry * e = z->entries + i;
+		if ( zip_isEncrypted(e) ) {
+			continue;
+		}
+		const UINT cp = ((e->flags & 0x0800) != 0) ? CP_UTF8 : 437;
+		const int len = MultiByteToWideChar(cp, 0, e->name, -1, NULL, 0);
+		if (len <= 0) {
+			continue;
+		}
+		name = malloc((size_t)len * sizeof(wchar_t));
+		if (name == NULL || MultiByteToWideChar(cp, 0, e->name, -1, name, len) != len) {
+			goto onError;
+		}
+		const wchar_t * fileName = wFileName(name);
+		if (*fileName != 0 && regIsSignable(fileName) && ( ! archiveExtract(a, z, i, fileName) )) {
+			goto onError;
+		}
+		wStrDelete(&name);
+	}
+	res = true;
+onError:
+	wStrDelete(&name);
+	zip_close(z);
+	if (fp != NULL) {
+		fclose(fp);
+	}
+	return res;
+}
+
+
+/**
+ * Runs the given archive job. This is called by the archive thread.
+ *
+ * @param[in,out] job - archive job
+ */
+static void archiveRun(tArchiveJob * job) {
+	tArchive * a = job->archive;
+	switch (job->kind) {
+	case AJK_EXTRACT:
+		TRACE_BEGIN("archive", "archiveExtract");
+		job->res = archiveExtractAll(a);
+		if ( ! job->res ) {
+			archiveCleanup(a);
+		}
+		TRACE_END("archive", "archiveExtract");
+		break;
+	case AJK_REWRITE:
+		TRACE_BEGIN("archive", "archiveRewrite");
+		job->res = archiveRewrite(a);
+		job->err = GetLastError();
+		archiveCleanup(a);
+		TRACE_END("archive", "archiveRewrite");
+		break;
+	case AJK_CLEANUP:
+		archiveCleanup(a);
+		job->res = true;
+		break;
+	}
+}
+
+
+/**
+ * Archive thread. Jobs are taken from the queue and moved to the list of
+ * finished jobs which is handled by the process window thread.
+ *
+ * @param[in,out] param - archive pool
+ * @return always 0
+ */
+static DWORD WINAPI archiveThread(LPVOID param) {
+	tArchivePool * pool = (tArchivePool *)param;
+	trace_setThreadName("archive");
+	EnterCriticalSection(&(pool->lock));
+	for (;;) {
+		while (( ! pool->stop ) && pool->queue == NULL) {
+			SleepConditionVariableCS(&(pool->wake), &(pool->lock), INFINITE);
+		}
+		if ( pool->stop ) {
+			break;
+		}
+		tArchiveJob * job = pool->queue;
+		pool->queue = job->next;
+		if (pool->queue == NULL) {
+			pool->queueTail = NULL;
+		}
+		LeaveCriticalSection(&(pool->lock));
+		archiveRun(job);
+		EnterCriticalSection(&(pool->lock));
+		job->next = pool->done;
+		pool->done = job;
+		SetEvent(pool->hDone);
+	}
+	LeaveCriticalSection(&(pool->lock));
+	return 0;
+}
+
+
+/**
+ * Starts the archive thread of the given pool if not done already.
+ *
+ * @param[in,out] pool - archive pool
+ * @return `true` on success, else `false`
+ */
+static bool archiveStart(tArchivePool * pool) {
+	if ( pool->started ) {
+		return pool->hThread != NULL;
+	}
+	pool->hDone = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (pool->hDone == NULL) {
+		return false;
+	}
+	InitializeCriticalSection(&(pool->lock));
+	InitializeConditionVariable(&(pool->wake));
+	pool->started = true;
+	pool->hThread = CreateThread(NULL, 0, archiveThread, pool, 0, NULL);
+	return pool->hThread != NULL;
+}
+
+
+/**
+ * Frees the given archive job and releases its references.
+ *
+ * @param[in,out] job - archive job
+ */
+static void archiveJobFree(tArchiveJob * job) {
+	archiveRelease(job->archive);
+	rcIniConfigBaseDelete(job->config);
+	rws_release(&(job->signApp));
+	free(job);
+}
+
+
+/**
+ * Queues a new job for the given archive on the archive thread.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in] kind - job kind
+ * @param[in,out] a - archive
+ * @param[in,out] c - INI configuration base to sign the extracted entries with or `NULL`
+ * @param[in,out] signApp - code signing application command-line or `NULL`
+ * @return `true` on success, else `false`
+ */
+static bool archiveQueue(tIpcWndCtx * ctx, const tArchiveJobKind kind, tArchive * a, tRcIniConfigBase * c, tRcWStr * signApp) {
+	tArchivePool * pool = &(ctx->archive);
+	if ( ! archiveStart(pool) ) {
+		return false;
+	}
+	tArchiveJob * job = calloc(1, sizeof(tArchiveJob));
+	if (job == NULL) {
+		return false;
+	}
+	job->kind = kind;
+	job->archive = archiveAquire(a);
+	job->config = (c != NULL) ? rcIniConfigBaseClone(c) : NULL;
+	job->signApp = rws_aquire(signApp);
+	EnterCriticalSection(&(pool->lock));
+	if (pool->queueTail != NULL) {
+		pool->queueTail->next = job;
+	} else {
+		pool->queue = job;
+	}
+	pool->queueTail = job;
+	LeaveCriticalSection(&(pool->lock));
+	WakeConditionVariable(&(pool->wake));
+	return true;
+}
+
+
+/**
+ * Writes the archive back with the signed entries unless any of them failed.
+ * The extracted entries are removed in both cases. This is done by the archive
+ * thread.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] a - archive
+ */
+static void archiveFinish(tIpcWndCtx * ctx, tArchive * a) {
+	TRACE_BEGIN("archive", "archiveFinish");
+	if (a->failed > 0) {
+		processNotify(ctx, NULL, L"archiveFinish", errStr[ERR_ARCHIVE_FAILED], a->failed, a->path);
+	}
+	if ( ! archiveQueue(ctx, (a->failed > 0) ? AJK_CLEANUP : AJK_REWRITE, a, NULL, NULL) ) {
+		if (a->failed == 0) {
+			processNotify(ctx, NULL, L"archiveFinish", errStr[ERR_UPDATE_ARCHIVE], (DWORD)ERROR_OUTOFMEMORY, a->path);
+		}
+		/* the extracted entries are removed once the archive is released */
+	}
+	TRACE_END("archive", "archiveFinish");
+}
+
+
+/**
+ * Adds the signable entries of the given archive to the internal process list
+ * once they were extracted by the archive thread. The archive is written back
+ * with the signed entries once all of them finished.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in] c - INI configuration base
+ * @param[in] signApp - code signing application command-line
+ * @param[in] path - path to the archive (can be relative)
+ * @return `true` on success, else `false` after adding a non-modal notification
+ * @remarks Extraction errors are reported via non-modal notification by `archiveComplete()`.
+ */
+bool archiveAddFile(tIpcWndCtx * ctx, tRcIniConfigBase * c, tRcWStr * signApp, const wchar_t * path) {
+	if (ctx == NULL || c == NULL || signApp == NULL || path == NULL) {
+		return false;
+	}
+	TRACE_BEGIN("archive", "archiveAddFile");
+	tArchive * a = calloc(1, sizeof(tArchive));
+	if (a == NULL) {
+		processNotify(ctx, NULL, L"archiveAddFile", L"%s\n%s", errStr[ERR_OUT_OF_MEMORY], path);
+		TRACE_END("archive", "archiveAddFile");
+		return false;
+	}
+	a->refCount = 1;
+	a->path = wcsdup(path);
+	a->entries = vec_create(sizeof(tArchiveEntry));
+	if (a->path == NULL || a->entries == NULL || ( ! wToFullPath(&(a->path), true) ) || ( ! archiveQueue(ctx, AJK_EXTRACT, a, c, signApp) )) {
+		processNotify(ctx, NULL, L"archiveAddFile", errStr[ERR_READ_ARCHIVE], (a->path != NULL) ? a->path : path);
+		archiveRelease(a);
+		TRACE_END("archive", "archiveAddFile");
+		return false;
+	}
+	archiveRelease(a);
+	TRACE_END("archive", "archiveAddFile");
+	return true;
+}
+
+
+/**
+ * Adds the extracted entries of the given finished extraction job to the
+ * internal process list.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] job - finished `AJK_EXTRACT` job
+ */
+static void archiveExtracted(tIpcWndCtx * ctx, tArchiveJob * job) {
+	tArchive * a = job->archive;
+	if ( ! job->res ) {
+		processNotify(ctx, NULL, L"archiveAddFile", errStr[ERR_READ_ARCHIVE], a->path);
+		return;
+	}
+	const size_t count = vec_size(a->entries);
+	if (count == 0) {
+		processNotify(ctx, NULL, L"archiveAddFile", errStr[ERR_ARCHIVE_EMPTY], a->path);
+		return;
+	}
+	/* sign the extracted entries through the normal queue */
+	a->pending = count;
+	for (size_t i = 0; i < count; ++i) {
+		const tArchiveEntry * e = vec_at(a->entries, i);
+		if ( ! processAddFile(ctx, job->config, job->signApp, e->path, a, NULL) ) {
+			++(a->failed);
+			if (--(a->pending) == 0) {
+				archiveFinish(ctx, a);
+			}
+		}
+	}
+}
+
+
+/**
+ * Accounts the given finished archive entry item. The archive is written back
+ * with the signed entries after the last one finished. It is left unchanged if
+ * any of its entries failed.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] item - finished item
+ */
+void archiveItemDone(tIpcWndCtx * ctx, tProcCtx * item) {
+	if (ctx == NULL || item == NULL || item->archive == NULL) {
+		return;
+	}
+	tArchive * a = item->archive;
+	if (item->state != PST_OK) {
+		++(a->failed);
+	}
+	if (a->pending > 0 && --(a->pending) == 0) {
+		archiveFinish(ctx, a);
+	}
+}
+
+
+/**
+ * Increments the reference counter of the given archive.
+ *
+ * @param[in,out] archive - archive
+ * @return same archive
+ */
+tArchive * archiveAquire(tArchive * archive) {
+	if (archive == NULL) {
+		return NULL;
+	}
+	InterlockedIncrement(&(archive->refCount));
+	return archive;
+}
+
+
+/**
+ * Decrements the reference counter of the given archive and frees it if no
+ * longer referenced. Extracted entries are removed.
+ *
+ * @param[in,out] archive - archive
+ */
+void archiveRelease(tArchive * archive) {
+	if (archive == NULL) {
+		return;
+	}
+	if (InterlockedDecrement(&(archive->refCount)) == 0) {
+		archiveCleanup(archive);
+		vec_delete(archive->entries);
+		wStrDelete(&(archive->path));
+		free(archive);
+	}
+}
+
+
+/**
+ * Handles all finished archive jobs. This is called by the process window
+ * thread once `hDone` was signaled.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void archiveComplete(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ( ! ctx->archive.started )) {
+		return;
+	}
+	tArchivePool * pool = &(ctx->archive);
+	EnterCriticalSection(&(pool->lock));
+	tArchiveJob * job = pool->done;
+	pool->done = NULL;
+	LeaveCriticalSection(&(pool->lock));
+	while (job != NULL) {
+		tArchiveJob * next = job->next;
+		if (job->kind == AJK_EXTRACT) {
+			archiveExtracted(ctx, job);
+		} else if (job->kind == AJK_REWRITE && ( ! job->res )) {
+			processNotify(ctx, NULL, L"archiveFinish", errStr[ERR_UPDATE_ARCHIVE], job->err, job->archive->path);
+		}
+		archiveJobFree(job);
+		job = next;
+	}
+}
+
+
+/**
+ * Stops the archive thread after its current job. Queued and finished jobs are
+ * dropped. Their archives are left unchanged.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void archiveDelete(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ( ! ctx->archive.started )) {
+		return;
+	}
+	tArchivePool * pool = &(ctx->archive);
+	EnterCriticalSection(&(pool->lock));
+	pool->stop = true;
+	LeaveCriticalSection(&(pool->lock));
+	WakeAllConditionVariable(&(pool->wake));
+	if (pool->hThread != NULL) {
+		WaitForSingleObject(pool->hThread, INFINITE);
+		CloseHandle(pool->hThread);
+		pool->hThread = NULL;
+	}
+	/* the thread is gone; no locking needed anymore */
+	tArchiveJob * lists[2] = {pool->queue, pool->done};
+	pool->queue = NULL;
+	pool->queueTail = NULL;
+	pool->done = NULL;
+	for (size_t i = 0; i < ARRAY_SIZE(lists); ++i) {
+		for (tArchiveJob * job = lists[i], * next; job != NULL; job = next) {
+			next = job->next;
+			archiveJobFree(job);
+		}
+	}
+	DeleteCriticalSection(&(pool->lock));
+	CloseHandle(pool->hDone);
+	pool->hDone = NULL;
+	pool->started = false;
+}
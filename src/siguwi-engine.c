@@ -0,0 +1,1022 @@
+/**
+ * @file siguwi-engine.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+#include "siguwi-engine.h"
+
+
+_Static_assert((int)SIGUWI_STATE_PENDING == (int)PST_IDLE && (int)SIGUWI_STATE_CANCELLED == (int)PST_CANCELLED, "tSiguwiState and tProcState are out of sync");
+
+
+/**
+ * Signing queue context.
+ */
+struct tSiguwiEngine {
+	tSiguwiEngineConfig cb; /**< callbacks and user pointer (strings are not kept) */
+	tIniConfig cfg; /**< parsed INI configuration */
+	tRcIniConfigBase * cfgBase; /**< created from `cfg` to assign it to the items */
+	CRITICAL_SECTION lock; /**< guards all fields up to `hWorker` */
+	tVector * queue; /**< pending items (`tProcCtx`) in submission order */
+	bool stop; /**< worker shall terminate? */
+	bool cancelRun; /**< cancel the running item? */
+	void * runTag; /**< tag of the running item */
+	bool running; /**< an item is being processed? */
+	HANDLE hWake; /**< auto-reset event to wake up the worker */
+	HANDLE hIdle; /**< manual-reset event set while no item is pending or running */
+	HANDLE hWorker; /**< worker thread handle */
+	/* worker thread only */
+	tHTableO * pins; /**< config (`tRcIniConfigBase`) to pin (`DATA_BLOB`) map */
+	tPipePool pipes; /**< pre-created pipes for the next signing processes */
+	tProcCtx proc; /**< running item */
+	tProcLane lane; /**< signing process of `proc` */
+};
+
+
+/**
+ * Takes a pre-created pipe set, gets the cached or prompted PIN and starts the
+ * signing application of the given item. The PIN is passed either as command-line
+ * argument or via standard input. The child process output pipe is returned in
+ * `hRead`.
+ *
+ * @param[in,out] pipes - pipe pool
+ * @param[in,out] pins - config (`tRcIniConfigBase`) to pin (`DATA_BLOB`) map
+ * @param[in,out] proc - item to start
+ * @param[in] parent - owner window of the PIN prompt
+ * @param[in] workDir - working directory of the signing application or `NULL`
+ * @param[out] hProc - receives the signing process handle
+ * @param[out] hRead - receives the signing process output pipe handle
+ * @return `PST_RUNNING` on success, else the final item state with the error code in `GetLastError()`
+ */
+tProcState engineSpawn(tPipePool * pipes, tHTableO * pins, tProcCtx * proc, HWND parent, const wchar_t * workDir, HANDLE * hProc, HANDLE * hRead) {
+	if (pipes == NULL || pins == NULL || proc == NULL || proc->config == NULL || proc->signApp == NULL || hProc == NULL || hRead == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return PST_FAIL;
+	}
+	tProcState newState = PST_BROKEN_PIPE;
+	DWORD err;
+	PROCESS_INFORMATION pi;
+	STARTUPINFO si;
+	tPipeSet set;
+	tUStrBuf * cmdBuf = NULL;
+	wchar_t * cmd = NULL;
+	*hProc = NULL;
+	*hRead = INVALID_HANDLE_VALUE;
+	DATA_BLOB * pin = NULL;
+	DATA_BLOB rawPin;
+	char * utf8Pin = NULL;
+	ZeroMemory(&rawPin, sizeof(rawPin));
+	/* take pre-created output and input pipes (no blocking wait) */
+	if ( ! pipePoolTake(pipes, &set) ) {
+		return newState;
+	}
+	reportStamp(proc, PSG_PIPE);
+	/* get and cache pin */
+	newState = PST_PIN_WRONG;
+	pin = hto_addKey(pins, proc->config);
+	if (pin == NULL) {
+		goto onError;
+	}
+	if (pin->pbData == NULL) {
+		if ( ! iniConfigGetPin(proc->config->cert, parent, pin) ) {
+			newState = PST_PIN_MISSING;
+			goto onError;
+		}
+		if (pin->pbData == NULL) {
+			goto onError;
+		}
+	}
+	/* decode pin */
+	if ( ! CryptUnprotectData(pin, NULL, NULL, NULL, NULL, 0, &rawPin) ) {
+		goto onError;
+	}
+	if (rawPin.pbData == NULL || rawPin.cbData < 2 || *(const wchar_t *)(rawPin.pbData + rawPin.cbData - 2) != 0) {
+		goto onError;
+	}
+	reportStamp(proc, PSG_PIN);
+	/* build complete command-line */
+	newState = PST_FAIL;
+	cmdBuf = usb_create(1024);
+	if (cmdBuf == NULL) {
+		goto onError;
+	}
+	bool esc = false;
+	bool hasPinArg = false;
+	for (const wchar_t * ptr = proc->signApp->ptr; *ptr != 0; ++ptr) {
+		if ( esc ) {
+			esc = false;
+			switch (*ptr) {
+			case L'1':
+				if (usb_add(cmdBuf, proc->path) == 0) {
+					goto onError;
+				}
+				continue;
+			case L'2':
+				if (usb_add(cmdBuf, (const wchar_t *)(rawPin.pbData)) <= 0) {
+					goto onError;
+				}
+				hasPinArg = true;
+				continue;
+			default:
+				break;
+			}
+		} else if (*ptr == L'%') {
+			esc = true;
+			continue;
+		}
+		if (usb_addC(cmdBuf, *ptr) == 0) {
+			goto onError;
+		}
+	}
+	if ( hasPinArg ) {
+		/* free pin */
+		SecureZeroMemory(rawPin.pbData, rawPin.cbData);
+		LocalFree(rawPin.pbData);
+		ZeroMemory(&rawPin, sizeof(rawPin));
+	}
+	/* get complete command-line as string */
+	cmd = usb_get(cmdBuf);
+	if (cmd == NULL) {
+		goto onError;
+	}
+	usb_wipe(cmdBuf);
+	usb_delete(cmdBuf);
+	cmdBuf = NULL;
+	/* create child process */
+	ZeroMemory(&si, sizeof(si));
+	si.cb          = sizeof(si);
+	si.dwFlags     = STARTF_USESHOWWINDOW | STARTF_USESTDHANDLES;
+	si.wShowWindow = SW_HIDE;
+	si.hStdInput   = set.hInRead;
+	si.hStdOutput  = set.hOutWrite;
+	si.hStdError   = set.hOutWrite;
+	/* only the process ends of this pipe set are inherited */
+	if ( ! (SetHandleInformation(set.hInRead, HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT) && SetHandleInformation(set.hOutWrite, HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT)) ) {
+		goto onError;
+	}
+	if ( ! CreateProcessW(NULL, cmd, NULL, NULL, TRUE, 0, NULL, workDir, &si, &pi) ) {
+		newState = PST_APP_NOT_FOUND;
+		goto onError;
+	}
+	reportStamp(proc, PSG_SPAWN);
+	/* free used command-line string */
+	SecureZeroMemory(cmd, wcslen(cmd) * sizeof(wchar_t));
+	free(cmd);
+	cmd = NULL;
+	/* close handles that got passed to the child process */
+	closeHandlePtr(&(set.hInRead), INVALID_HANDLE_VALUE);
+	closeHandlePtr(&(set.hOutWrite), INVALID_HANDLE_VALUE);
+	closeHandlePtr(&(pi.hThread), NULL);
+	*hProc = pi.hProcess;
+	/* pass UTF-8 pin */
+	if ( ! hasPinArg ) {
+		newState = PST_PIN_MISSING;
+		utf8Pin = wToUtf8((const wchar_t *)(rawPin.pbData));
+		if (utf8Pin == NULL) {
+			goto onError;
+		}
+		const DWORD utf8Len = (DWORD)strlen(utf8Pin);
+		DWORD bytesWritten;
+		if (WriteFile(set.hInWrite, utf8Pin, utf8Len, &bytesWritten, NULL) == 0 || bytesWritten != utf8Len) {
+			goto onError;
+		}
+		FlushFileBuffers(set.hInWrite);
+		/* free UTF-8 pin */
+		SecureZeroMemory(utf8Pin, strlen(utf8Pin));
+		free(utf8Pin);
+		utf8Pin = NULL;
+		/* free pin */
+		SecureZeroMemory(rawPin.pbData, rawPin.cbData);
+		LocalFree(rawPin.pbData);
+		ZeroMemory(&rawPin, sizeof(rawPin));
+	}
+	closeHandlePtr(&(set.hInWrite), INVALID_HANDLE_VALUE);
+	*hRead = set.hOutRead;
+	return PST_RUNNING;
+onError:
+	err = GetLastError();
+	if (utf8Pin != NULL) {
+		SecureZeroMemory(utf8Pin, strlen(utf8Pin));
+		free(utf8Pin);
+	}
+	closeHandlePtr(hProc, NULL);
+	if (cmd != NULL) {
+		SecureZeroMemory(cmd, wcslen(cmd) * sizeof(wchar_t));
+		free(cmd);
+	}
+	if (cmdBuf != NULL) {
+		usb_wipe(cmdBuf);
+		usb_delete(cmdBuf);
+	}
+	if (rawPin.pbData != NULL) {
+		SecureZeroMemory(rawPin.pbData, rawPin.cbData);
+		LocalFree(rawPin.pbData);
+	}
+	pipeSetClose(&set);
+	SetLastError(err);
+	return newState;
+}
+
+
+/**
+ * Decodes the given UTF-8 signing application output chunk and appends it to
+ * the item output with CR/LF line endings. The output is truncated after
+ * `PROCESS_MAX_OUTPUT` Unicode code points.
+ *
+ * @param[in,out] utf8 - UTF-8 parsing context
+ * @param[in,out] output - item output
+ * @param[in,out] outputLen - current length of `output` in number of Unicode code points
+ * @param[in,out] lastChr - most recent Unicode code point added to `output`
+ * @param[in] data - output chunk
+ * @param[in] len - length of `data` in bytes
+ * @return `true` if characters were added, else `false`
+ */
+bool engineDecodeOutput(tUtf8Ctx * utf8, tUStrBuf * output, size_t * outputLen, uint32_t * lastChr, const uint8_t * data, const size_t len) {
+	if (utf8 == NULL || output == NULL || outputLen == NULL || lastChr == NULL || data == NULL) {
+		return false;
+	}
+	bool added = false;
+	for (size_t i = 0; i < len && *outputLen < PROCESS_MAX_OUTPUT; ++i) {
+		uint32_t cp = utf8_parse(utf8, data[i]);
+		if (cp == UTF8_MORE) {
+			continue;
+		}
+		if (cp > 0x10FFFF) {
+			cp = UTF8_ERROR;
+		}
+		if (cp < 0x10000) {
+			/* direct encoding */
+			if (cp == L'\n' && *lastChr != L'\r') {
+				/* fix line ending */
+				usb_addC(output, L'\r');
+			}
+			if (cp != 0) {
+				usb_addC(output, (wchar_t)cp);
+			}
+		} else {
+			/* surrogate pair encoding */
+			const uint32_t sp = (uint32_t)(cp - 0x10000);
+			usb_addC(output, (wchar_t)((sp >> 10) + 0xD800));
+			usb_addC(output, (wchar_t)((sp & 0x3FF) + 0xDC00));
+		}
+		*lastChr = cp;
+		++(*outputLen);
+		added = true;
+	}
+	if (added && *outputLen >= PROCESS_MAX_OUTPUT) {
+		usb_add(output,
+			L"\r\n--------------------------------------------------------------------------------"
+			"\r\nThe output has been truncated here."
+		);
+	}
+	return added;
+}
+
+
+/**
+ * Returns the current line time of the given item. The line time list is
+ * created if missing.
+ *
+ * @param[in,out] proc - item
+ * @param[out] stamp - time since `PSG_SPAWN` in microseconds
+ * @return `true` on success, else `false`
+ */
+static bool engineLineTime(tProcCtx * proc, uint32_t * stamp) {
+	if (proc->lineTimes == NULL) {
+		proc->lineTimes = vec_create(sizeof(uint32_t));
+		if (proc->lineTimes == NULL) {
+			return false;
+		}
+	}
+	const double us = (proc->stamp[PSG_SPAWN] != 0) ? reportTicksToMs(reportTicks() - proc->stamp[PSG_SPAWN]) * 1000.0 : 0.0;
+	*stamp = (us <= 0.0) ? 0 : ((us >= (double)UINT32_MAX) ? UINT32_MAX : (uint32_t)us);
+	return true;
+}
+
+
+/**
+ * Records the start time of each item output line that begins within the
+ * given raw output chunk. The time is relative to `PSG_SPAWN` and the same for
+ * all lines of the chunk. This needs to be called before the chunk is passed
+ * to `engineDecodeOutput()`.
+ *
+ * @param[in,out] proc - item of the running signing application
+ * @param[in] outputLen - current item output length in number of Unicode code points
+ * @param[in] lastChr - most recent Unicode code point added to the item output
+ * @param[in] data - output chunk
+ * @param[in] len - length of `data` in bytes
+ */
+void engineStampLines(tProcCtx * proc, const size_t outputLen, const uint32_t lastChr, const uint8_t * data, const size_t len) {
+	uint32_t stamp;
+	if (proc == NULL || data == NULL || len == 0 || outputLen >= PROCESS_MAX_OUTPUT || ( ! engineLineTime(proc, &stamp) )) {
+		return;
+	}
+	const uint8_t * ptr = data;
+	const uint8_t * endPtr = data + len;
+	if (outputLen > 0 && lastChr != L'\n') {
+		/* continue the current line */
+		ptr = memchr(ptr, '\n', len);
+		ptr = (ptr != NULL) ? ptr + 1 : endPtr;
+	}
+	while (ptr < endPtr) {
+		uint32_t * item = vec_pushBack(proc->lineTimes);
+		if (item == NULL) {
+			return;
+		}
+		*item = stamp;
+		ptr = memchr(ptr, '\n', (size_t)(endPtr - ptr));
+		ptr = (ptr != NULL) ? ptr + 1 : endPtr;
+	}
+}
+
+
+/**
+ * Records the start time of each item output line that begins within the text
+ * appended to the item output by siguwi itself, like notes and signing step
+ * headers. This keeps the line times in sync with the output lines.
+ *
+ * @param[in,out] proc - item
+ * @param[in] from - item output length in characters before the text was appended
+ */
+void engineStampAppended(tProcCtx * proc, const size_t from) {
+	uint32_t stamp;
+	if (proc == NULL || proc->output == NULL || from >= PROCESS_MAX_OUTPUT || usb_len(proc->output) <= from || ( ! engineLineTime(proc, &stamp) )) {
+		return;
+	}
+	wchar_t * str = usb_get(proc->output);
+	if (str == NULL) {
+		return;
+	}
+	const wchar_t * ptr = str + from;
+	if (from > 0 && ptr[-1] != L'\n') {
+		/* continue the current line */
+		ptr = wcschr(ptr, L'\n');
+		ptr = (ptr != NULL) ? ptr + 1 : NULL;
+	}
+	while (ptr != NULL && *ptr != 0) {
+		uint32_t * item = vec_pushBack(proc->lineTimes);
+		if (item == NULL) {
+			break;
+		}
+		*item = stamp;
+		ptr = wcschr(ptr, L'\n');
+		ptr = (ptr != NULL) ? ptr + 1 : NULL;
+	}
+	free(str);
+}
+
+
+/**
+ * Waits for the signing process termination and records its resource usage
+ * and exit code within the given item. A failure note is appended to the item
+ * output for non-zero exit codes. The process handle remains open.
+ *
+ * @param[in] hProc - signing process handle
+ * @param[in,out] proc - associated item
+ * @return `true` if the signing application succeeded, else `false`
+ * @remarks `proc->hasExitCode` is `false` if waiting failed with the error code in `GetLastError()`.
+ */
+bool engineReap(HANDLE hProc, tProcCtx * proc) {
+	if (hProc == NULL || proc == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return false;
+	}
+	if (WaitForSingleObject(hProc, INFINITE) == WAIT_FAILED) {
+		return false;
+	}
+	reportStamp(proc, PSG_EXIT);
+	proc->hasUsage = pu_fromHandle(hProc, &(proc->usage));
+	DWORD dwExitCode;
+	if ( ! GetExitCodeProcess(hProc, &dwExitCode) ) {
+		return false;
+	}
+	proc->exitCode = dwExitCode;
+	proc->hasExitCode = true;
+	if (dwExitCode != 0) {
+		if (proc->output != NULL) {
+			const size_t from = usb_len(proc->output);
+			usb_addFmt(
+				proc->output,
+				L"\r\n--------------------------------------------------------------------------------"
+				"\r\nCommand failed with exit code %" PRIu32 ".",
+				(uint32_t)dwExitCode
+			);
+			engineStampAppended(proc, from);
+		}
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Starts the signing application of the current item of the given lane and
+ * resets the output parsing state. Following signing steps of a chain keep the
+ * processing stages of the first one and continue its output.
+ *
+ * @param[in,out] pipes - pipe pool
+ * @param[in,out] pins - config (`tRcIniConfigBase`) to pin (`DATA_BLOB`) map
+ * @param[in,out] lane - signing process lane with the item to start
+ * @param[in] parent - owner window of the PIN prompt
+ * @param[in] workDir - working directory of the signing application or `NULL`
+ * @return `PST_RUNNING` on success, else the final item state with the error code in `GetLastError()`
+ */
+tProcState engineLaneStart(tPipePool * pipes, tHTableO * pins, tProcLane * lane, HWND parent, const wchar_t * workDir) {
+	if (lane == NULL || lane->proc == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return PST_FAIL;
+	}
+	tProcCtx * proc = lane->proc;
+	int64_t stamp[PSG_COUNT];
+	memcpy(stamp, proc->stamp, sizeof(stamp));
+	reportStamp(proc, PSG_START);
+	const tProcState newState = engineSpawn(pipes, pins, proc, parent, workDir, &(lane->hProc), &(lane->hProcRead));
+	const DWORD err = GetLastError();
+	if (proc->step > 0) {
+		/* report the whole signing chain */
+		memcpy(proc->stamp, stamp, sizeof(stamp));
+	}
+	if (newState != PST_RUNNING) {
+		SetLastError(err);
+		return newState;
+	}
+	ZeroMemory(&(lane->utf8), sizeof(lane->utf8));
+	if (proc->step > 0) {
+		/* continue the output of the previous signing steps */
+		lane->outputLen = (proc->output != NULL) ? usb_len(proc->output) : 0;
+		lane->lastChar = L'\n';
+	} else {
+		lane->outputLen = 0;
+		lane->lastChar = 0;
+	}
+	lane->matchState = ACM_START;
+	lane->searchState = TGI_START;
+	proc->matched = 0;
+	proc->hasExitCode = false;
+	return PST_RUNNING;
+}
+
+
+/**
+ * Starts an asynchronous read operation on the output pipe of the signing
+ * process of the given lane.
+ *
+ * @param[in,out] lane - signing process lane
+ * @param[in] onRead - completion routine which receives `lane->ovProcRead`
+ * @return `true` on success, else `false`
+ */
+bool engineLaneRead(tProcLane * lane, LPOVERLAPPED_COMPLETION_ROUTINE onRead) {
+	if (lane == NULL || lane->proc == NULL) {
+		return false;
+	}
+	ZeroMemory(&(lane->ovProcRead), sizeof(lane->ovProcRead));
+	return ReadFileEx(lane->hProcRead, lane->procBuf, (DWORD)sizeof(lane->procBuf), &(lane->ovProcRead), onRead) != 0;
+}
+
+
+/**
+ * Passes the given number of bytes received in `lane->procBuf` to the output
+ * rules, line times and output of the current item of the given lane.
+ *
+ * @param[in,out] lane - signing process lane
+ * @param[in] len - number of bytes received
+ * @return `true` if characters were added to the item output, else `false`
+ */
+bool engineLaneOutput(tProcLane * lane, const size_t len) {
+	if (lane == NULL || lane->proc == NULL || lane->proc->output == NULL) {
+		return false;
+	}
+	tProcCtx * proc = lane->proc;
+	if (proc->stamp[PSG_OUTPUT] == 0) {
+		reportStamp(proc, PSG_OUTPUT);
+	}
+	matchOutput(proc, &(lane->matchState), lane->procBuf, len);
+	engineStampLines(proc, lane->outputLen, lane->lastChar, lane->procBuf, len);
+	return engineDecodeOutput(&(lane->utf8), proc->output, &(lane->outputLen), &(lane->lastChar), lane->procBuf, len);
+}
+
+
+/**
+ * Waits for the signing process of the given lane, closes its handles and
+ * applies the output rules to the current item. The resource usage of all
+ * signing steps is added up.
+ *
+ * @param[in,out] lane - signing process lane
+ * @return final state of the signing step
+ * @remarks `lane->proc->hasExitCode` is `false` if waiting failed with the error code in `GetLastError()`.
+ */
+tProcState engineLaneFinish(tProcLane * lane) {
+	if (lane == NULL || lane->proc == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return PST_FAIL;
+	}
+	tProcCtx * proc = lane->proc;
+	const bool hadUsage = proc->hasUsage;
+	const tProcUsage usage = proc->usage;
+	const bool reaped = engineReap(lane->hProc, proc);
+	const DWORD err = GetLastError();
+	if (hadUsage && proc->hasUsage) {
+		proc->usage.userUs += usage.userUs;
+		proc->usage.kernelUs += usage.kernelUs;
+		proc->usage.peakWorkingSet = (usage.peakWorkingSet > proc->usage.peakWorkingSet) ? usage.peakWorkingSet : proc->usage.peakWorkingSet;
+		proc->usage.readBytes += usage.readBytes;
+		proc->usage.writeBytes += usage.writeBytes;
+		proc->usage.readOps += usage.readOps;
+		proc->usage.writeOps += usage.writeOps;
+	}
+	closeHandlePtr(&(lane->hProc), NULL);
+	closeHandlePtr(&(lane->hProcRead), INVALID_HANDLE_VALUE);
+	const tProcState state = matchApply(proc, reaped ? PST_OK : PST_FAIL);
+	SetLastError(err);
+	return state;
+}
+
+
+/**
+ * Passes the current item of the given lane on to the next signing step of its
+ * configuration chain. The item output is continued by the next step.
+ *
+ * @param[in,out] lane - signing process lane which finished the current signing step of its item successfully
+ * @return `true` if passed on, `false` if this was the last signing step
+ */
+bool engineLaneAdvance(tProcLane * lane) {
+	if (lane == NULL || lane->proc == NULL) {
+		return false;
+	}
+	tProcCtx * proc = lane->proc;
+	tRcIniConfigBase * next = proc->config->next;
+	if (next == NULL || proc->config->nextSignApp == NULL || (proc->step + 1) >= MAX_CHAIN_STEPS) {
+		return false;
+	}
+	size_t steps = proc->step + 2;
+	for (const tRcIniConfigBase * c = next->next; c != NULL; c = c->next) {
+		++steps;
+	}
+	tRcWStr * signApp = rws_aquire(proc->config->nextSignApp);
+	rcIniConfigBaseClone(next);
+	rcIniConfigBaseDelete(proc->config);
+	rws_release(&(proc->signApp));
+	proc->config = next;
+	proc->signApp = signApp;
+	++(proc->step);
+	if (proc->output != NULL) {
+		/* appended notes do not end with a line break */
+		const size_t from = usb_len(proc->output);
+		wchar_t * str = (from > 0) ? usb_get(proc->output) : NULL;
+		const bool lineStart = (from == 0 || (str != NULL && str[from - 1] == L'\n'));
+		free(str);
+		usb_addFmt(proc->output, L"%s--------------------------------------------------------------------------------\r\nSigning step %zu of %zu (%s):\r\n", lineStart ? L"" : L"\r\n", proc->step + 1, steps, next->name);
+		engineStampAppended(proc, from);
+	}
+	return true;
+}
+
+
+/**
+ * Reports a state change of the given item.
+ *
+ * @param[in,out] e - engine
+ * @param[in,out] item - item
+ * @param[in] state - new state
+ */
+static void engineSetState(tSiguwiEngine * e, tProcCtx * item, const tProcState state) {
+	item->state = state;
+	if (e->cb.onProgress != NULL) {
+		e->cb.onProgress(e->cb.user, item->tag, (tSiguwiState)state);
+	}
+}
+
+
+/**
+ * Finishes the given item with the passed final state, reports it and frees
+ * its resources.
+ *
+ * @param[in,out] e - engine
+ * @param[in,out] item - item
+ * @param[in] state - final state
+ */
+static void engineComplete(tSiguwiEngine * e, tProcCtx * item, const tProcState state) {
+	engineSetState(e, item, state);
+	reportStamp(item, PSG_DONE);
+	if (e->cb.onComplete != NULL) {
+		tSiguwiResult res;
+		ZeroMemory(&res, sizeof(res));
+		wchar_t * output = (item->output != NULL) ? usb_get(item->output) : NULL;
+		res.path = item->path;
+		res.state = (tSiguwiState)state;
+		res.stateName = procStateStr[state];
+		res.hasExitCode = item->hasExitCode;
+		res.exitCode = (uint32_t)(item->exitCode);
+		if (item->stamp[PSG_START] != 0) {
+			res.queueMs = reportTicksToMs(item->stamp[PSG_START] - item->stamp[PSG_QUEUED]);
+		}
+		res.durationMs = reportTicksToMs(item->stamp[PSG_DONE] - item->stamp[PSG_QUEUED]);
+		res.output = (output != NULL) ? output : L"";
+		e->cb.onComplete(e->cb.user, item->tag, &res);
+		free(output);
+	}
+	procCtxDelete(0, item, NULL);
+	ZeroMemory(item, sizeof(*item));
+}
+
+
+static void CALLBACK engineHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytesTransfered, LPOVERLAPPED lpOverlapped);
+static void engineStart(tSiguwiEngine * e);
+
+
+/**
+ * Marks the running item as done.
+ *
+ * @param[in,out] e - engine
+ */
+static void engineDone(tSiguwiEngine * e) {
+	EnterCriticalSection(&(e->lock));
+	e->running = false;
+	e->runTag = NULL;
+	e->cancelRun = false;
+	LeaveCriticalSection(&(e->lock));
+}
+
+
+/**
+ * Waits for the running signing process and completes its item or starts the
+ * next signing step of its configuration chain.
+ *
+ * @param[in,out] e - engine
+ */
+static void engineFinish(tSiguwiEngine * e) {
+	tProcState state = engineLaneFinish(&(e->lane));
+	EnterCriticalSection(&(e->lock));
+	if ( e->cancelRun ) {
+		state = PST_CANCELLED;
+	}
+	LeaveCriticalSection(&(e->lock));
+	if (state == PST_OK && engineLaneAdvance(&(e->lane))) {
+		engineStart(e);
+		return;
+	}
+	engineComplete(e, &(e->proc), state);
+	engineDone(e);
+}
+
+
+/**
+ * Handles the read complete event from the signing process output pipe.
+ *
+ * @param[in] dwErrorCode - I/O completion status
+ * @param[in] dwNumberOfBytesTransfered - number of bytes transferred or zero on error
+ * @param[in] lpOverlapped - pointer to the OVERLAPPED structure specified by the asynchronous I/O function
+ */
+static void CALLBACK engineHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytesTransfered, LPOVERLAPPED lpOverlapped) {
+	if (lpOverlapped == NULL) {
+		return;
+	}
+	tSiguwiEngine * e = CONTAINER_OF(lpOverlapped, tSiguwiEngine, lane.ovProcRead);
+	if (dwErrorCode != 0 || dwNumberOfBytesTransfered == 0) {
+		/* child process terminated */
+		engineFinish(e);
+		return;
+	}
+	const size_t oldLen = usb_len(e->proc.output);
+	if (engineLaneOutput(&(e->lane), (size_t)dwNumberOfBytesTransfered) && e->cb.onOutput != NULL) {
+		wchar_t * output = usb_get(e->proc.output);
+		if (output != NULL) {
+			e->cb.onOutput(e->cb.user, e->proc.tag, output + oldLen, usb_len(e->proc.output) - oldLen);
+			free(output);
+		}
+	}
+	if ( ! engineLaneRead(&(e->lane), engineHandleReadComplete) ) {
+		engineFinish(e);
+	}
+}
+
+
+/**
+ * Starts processing the current signing step of the running item. The item is
+ * completed on error.
+ *
+ * @param[in,out] e - engine
+ */
+static void engineStart(tSiguwiEngine * e) {
+	tProcCtx * proc = &(e->proc);
+	if ( ! wFileExists(proc->path) ) {
+		engineComplete(e, proc, PST_FILE_NOT_FOUND);
+		engineDone(e);
+		return;
+	}
+	e->lane.proc = proc;
+	const tProcState state = engineLaneStart(&(e->pipes), e->pins, &(e->lane), e->cb.parent, NULL);
+	if (state != PST_RUNNING) {
+		engineComplete(e, proc, state);
+		engineDone(e);
+		return;
+	}
+	engineSetState(e, proc, PST_RUNNING);
+	if ( ! engineLaneRead(&(e->lane), engineHandleReadComplete) ) {
+		engineFinish(e);
+		return;
+	}
+	/* prepare the pipes of the next items while the signing application runs */
+	pipePoolFill(&(e->pipes));
+}
+
+
+/**
+ * Worker thread processing the queued items one after another. Signing
+ * process output is read via I/O completion routines while waiting alertable.
+ *
+ * @param[in,out] param - engine
+ * @return thread exit code
+ */
+static DWORD WINAPI engineWorker(LPVOID param) {
+	tSiguwiEngine * e = (tSiguwiEngine *)param;
+	for (;;) {
+		bool start = false;
+		bool cancelled = false;
+		bool terminate = false;
+		EnterCriticalSection(&(e->lock));
+		if ( e->running ) {
+			terminate = e->cancelRun;
+		} else if (vec_size(e->queue) > 0) {
+			tProcCtx * item = vec_at(e->queue, 0);
+			e->proc = *item;
+			vec_erase(e->queue, 0, 1);
+			cancelled = (e->proc.state == PST_CANCELLED);
+			e->proc.state = PST_IDLE;
+			e->running = true;
+			e->runTag = e->proc.tag;
+			e->cancelRun = false;
+			start = true;
+		} else if ( e->stop ) {
+			LeaveCriticalSection(&(e->lock));
+			break;
+		} else {
+			SetEvent(e->hIdle);
+		}
+		LeaveCriticalSection(&(e->lock));
+		if ( cancelled ) {
+			engineComplete(e, &(e->proc), PST_CANCELLED);
+			engineDone(e);
+			continue;
+		} else if ( start ) {
+			engineStart(e);
+			continue;
+		}
+		if (terminate && e->lane.hProc != NULL) {
+			/* the pending read completes with an error afterwards */
+			TerminateProcess(e->lane.hProc, EXIT_FAILURE);
+		}
+		WaitForSingleObjectEx(e->hWake, INFINITE, TRUE);
+	}
+	return 0;
+}
+
+
+/**
+ * Creates a new signing queue for the given configuration. The configuration
+ * is loaded once. A worker thread processes the submitted files in order.
+ *
+ * @param[in] config - engine configuration
+ * @return engine handle or `NULL` on error with the error code in `GetLastError()`
+ */
+tSiguwiEngine * siguwi_engine_create(const tSiguwiEngineConfig * config) {
+	if (config == NULL || config->configUrl == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return NULL;
+	}
+	tSiguwiEngine * e = (tSiguwiEngine *)calloc(1, sizeof(tSiguwiEngine));
+	if (e == NULL) {
+		SetLastError(ERROR_OUTOFMEMORY);
+		return NULL;
+	}
+	DWORD err = ERROR_OUTOFMEMORY;
+	e->cb = *config;
+	e->cb.configUrl = NULL;
+	e->cb.configGroup = NULL;
+	e->lane.hProcRead = INVALID_HANDLE_VALUE;
+	InitializeCriticalSection(&(e->lock));
+	/* load configuration file */
+	tFilePos errPos;
+	ZeroMemory(&errPos, sizeof(errPos));
+	if ( ! iniConfigParse(config->configUrl, (config->configGroup != NULL) ? config->configGroup : DEFAULT_CONFIG_GROUP, &(e->cfg), &errPos) ) {
+		err = ERROR_BAD_CONFIGURATION;
+		goto onError;
+	}
+	if (e->cfg.cert->certId == NULL || e->cfg.cert->cardName == NULL || e->cfg.cert->cardReader == NULL || e->cfg.signApp == NULL) {
+		err = ERROR_BAD_CONFIGURATION;
+		goto onError;
+	}
+	/* deduce cryptographic service provider */
+	e->cfg.cert->certProv = getCspFromCardNameW(e->cfg.cert->cardName);
+	if (e->cfg.cert->certProv == NULL) {
+		err = ERROR_NOT_FOUND;
+		goto onError;
+	}
+	e->cfgBase = rcIniConfigBaseCreate(e->cfg.cert, e->cfg.match);
+	e->queue = vec_create(sizeof(tProcCtx));
+	e->pins = hto_create(
+		sizeof(DATA_BLOB),
+		8,
+		(HashFunctionCloneO)rcIniConfigBaseClone,
+		(HashFunctionDelO)rcIniConfigBaseDelete,
+		(HashFunctionCmpO)rcIniConfigBaseCmp,
+		(HashFunctionHashO)rcIniConfigBaseHash
+	);
+	if (e->cfgBase == NULL || e->queue == NULL || e->pins == NULL) {
+		goto onError;
+	}
+	if ( ! iniConfigChain(config->configUrl, e->cfgBase, e->cfg.chain) ) {
+		err = ERROR_BAD_CONFIGURATION;
+		goto onError;
+	}
+	if ( ! pipePoolInit(&(e->pipes)) ) {
+		err = GetLastError();
+		goto onError;
+	}
+	e->hWake = CreateEvent(NULL, FALSE, FALSE, NULL);
+	e->hIdle = CreateEvent(NULL, TRUE, TRUE, NULL);
+	if (e->hWake == NULL || e->hIdle == NULL) {
+		err = GetLastError();
+		goto onError;
+	}
+	e->hWorker = CreateThread(NULL, 0, engineWorker, e, 0, NULL);
+	if (e->hWorker == NULL) {
+		err = GetLastError();
+		goto onError;
+	}
+	return e;
+onError:
+	siguwi_engine_delete(e);
+	SetLastError(err);
+	return NULL;
+}
+
+
+/**
+ * Adds the given file to the end of the signing queue.
+ *
+ * @param[in,out] engine - engine
+ * @param[in] path - path to the file to sign (can be relative)
+ * @param[in] tag - user tag passed to the callbacks of this file
+ * @return `true` on success, else `false` with the error code in `GetLastError()`
+ */
+bool siguwi_engine_submit(tSiguwiEngine * engine, const wchar_t * path, void * tag) {
+	if (engine == NULL || path == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return false;
+	}
+	tProcCtx item;
+	ZeroMemory(&item, sizeof(item));
+	reportStamp(&item, PSG_QUEUED);
+	item.state = PST_IDLE;
+	item.tag = tag;
+	item.config = rcIniConfigBaseClone(engine->cfgBase);
+	item.signApp = rws_aquire(engine->cfg.signApp);
+	item.path = wcsdup(path);
+	item.output = usb_create(4096);
+	wToFullPath(&(item.path), true);
+	if (item.path == NULL || item.output == NULL) {
+		procCtxDelete(0, &item, NULL);
+		SetLastError(ERROR_OUTOFMEMORY);
+		return false;
+	}
+	EnterCriticalSection(&(engine->lock));
+	tProcCtx * ptr = engine->stop ? NULL : vec_pushBack(engine->queue);
+	if (ptr != NULL) {
+		*ptr = item;
+		ResetEvent(engine->hIdle);
+	}
+	LeaveCriticalSection(&(engine->lock));
+	if (ptr == NULL) {
+		procCtxDelete(0, &item, NULL);
+		SetLastError(ERROR_OUTOFMEMORY);
+		return false;
+	}
+	SetEvent(engine->hWake);
+	return true;
+}
+
+
+/**
+ * Cancels all pending or running files with the given tag. Running signing
+ * applications are terminated. The cancelled files are still completed via
+ * callback.
+ *
+ * @param[in,out] engine - engine
+ * @param[in] tag - user tag passed to `siguwi_engine_submit()`
+ * @return `true` if at least one file was cancelled, else `false`
+ */
+bool siguwi_engine_cancel(tSiguwiEngine * engine, void * tag) {
+	if (engine == NULL) {
+		return false;
+	}
+	bool res = false;
+	EnterCriticalSection(&(engine->lock));
+	const size_t count = vec_size(engine->queue);
+	for (size_t i = 0; i < count; ++i) {
+		tProcCtx * item = vec_at(engine->queue, i);
+		if (item->tag == tag) {
+			item->state = PST_CANCELLED;
+			res = true;
+		}
+	}
+	if (engine->running && engine->runTag == tag) {
+		engine->cancelRun = true;
+		res = true;
+	}
+	LeaveCriticalSection(&(engine->lock));
+	if ( res ) {
+		SetEvent(engine->hWake);
+	}
+	return res;
+}
+
+
+/**
+ * Cancels all pending and running files.
+ *
+ * @param[in,out] engine - engine
+ * @return `true` if at least one file was cancelled, else `false`
+ */
+bool siguwi_engine_cancel_all(tSiguwiEngine * engine) {
+	if (engine == NULL) {
+		return false;
+	}
+	bool res = false;
+	EnterCriticalSection(&(engine->lock));
+	const size_t count = vec_size(engine->queue);
+	for (size_t i = 0; i < count; ++i) {
+		tProcCtx * item = vec_at(engine->queue, i);
+		item->state = PST_CANCELLED;
+		res = true;
+	}
+	if ( engine->running ) {
+		engine->cancelRun = true;
+		res = true;
+	}
+	LeaveCriticalSection(&(engine->lock));
+	if ( res ) {
+		SetEvent(engine->hWake);
+	}
+	return res;
+}
+
+
+/**
+ * Waits until all submitted files have been completed.
+ *
+ * @param[in,out] engine - engine
+ * @param[in] timeout - timeout in milliseconds or `INFINITE`
+ * @return `true` if the queue is empty, else `false` on timeout or error
+ */
+bool siguwi_engine_drain(tSiguwiEngine * engine, const DWORD timeout) {
+	if (engine == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return false;
+	}
+	return WaitForSingleObject(engine->hIdle, timeout) == WAIT_OBJECT_0;
+}
+
+
+/**
+ * Cancels all pending and running files, waits for the worker thread and frees
+ * the given engine.
+ *
+ * @param[in,out] engine - engine
+ */
+void siguwi_engine_delete(tSiguwiEngine * engine) {
+	if (engine == NULL) {
+		return;
+	}
+	if (engine->hWorker != NULL) {
+		siguwi_engine_cancel_all(engine);
+		EnterCriticalSection(&(engine->lock));
+		engine->stop = true;
+		LeaveCriticalSection(&(engine->lock));
+		SetEvent(engine->hWake);
+		WaitForSingleObject(engine->hWorker, INFINITE);
+		CloseHandle(engine->hWorker);
+	}
+	closeHandlePtr(&(engine->hWake), NULL);
+	closeHandlePtr(&(engine->hIdle), NULL);
+	if (engine->queue != NULL) {
+		vec_traverse(engine->queue, (VectorVisitor)procCtxDelete, NULL);
+		vec_delete(engine->queue);
+	}
+	if (engine->pins != NULL) {
+		hto_traverse(engine->pins, (HashVisitorO)pinBlobDelete, NULL);
+		hto_delete(engine->pins);
+	}
+	pipePoolDelete(&(engine->pipes));
+	wStrDelete(&(engine->cfg.cert->certProv));
+	wStrDelete(&(engine->cfg.cert->certId));
+	wStrDelete(&(engine->cfg.cert->cardName));
+	wStrDelete(&(engine->cfg.cert->cardReader));
+	rws_release(&(engine->cfg.signApp));
+	wStrDelete(&(engine->cfg.match));
+	wStrDelete(&(engine->cfg.chain));
+	rcIniConfigBaseDelete(engine->cfgBase);
+	DeleteCriticalSection(&(engine->lock));
+	free(engine);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file siguwi-engine.h
+ * @author Daniel Starke
+ * @see siguwi-engine.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Embeddable signing queue. Link against `libsiguwi.a` and the system
+ * libraries listed in the README.
+ */
+#ifndef __SIGUWI_ENGINE_H__
+#define __SIGUWI_ENGINE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+#include <windows.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Processing states of a submitted file. All states after
+ * `SIGUWI_STATE_RUNNING` are final.
+ */
+typedef enum {
+	SIGUWI_STATE_PENDING, /**< queued */
+	SIGUWI_STATE_RUNNING, /**< signing application is running */
+	SIGUWI_STATE_OK, /**< signed successfully */
+	SIGUWI_STATE_FAIL, /**< signing application failed */
+	SIGUWI_STATE_FILE_NOT_FOUND, /**< the file does not exist */
+	SIGUWI_STATE_BROKEN_PIPE, /**< failed to set up the signing application pipes */
+	SIGUWI_STATE_APP_NOT_FOUND, /**< failed to start the signing application */
+	SIGUWI_STATE_PIN_MISSING, /**< no PIN was entered */
+	SIGUWI_STATE_PIN_WRONG, /**< the PIN could not be used */
+	SIGUWI_STATE_CANCELLED /**< cancelled via `siguwi_engine_cancel()` */
+} tSiguwiState;
+
+
+/**
+ * Result of a single file. All pointers are only valid during the callback.
+ */
+typedef struct {
+	const wchar_t * path; /**< absolute file path */
+	tSiguwiState state; /**< final state */
+	const wchar_t * stateName; /**< final state as text */
+	bool hasExitCode; /**< `exitCode` is valid */
+	uint32_t exitCode; /**< exit code of the signing application */
+	double queueMs; /**< time from submission to start in milliseconds */
+	double durationMs; /**< time from submission to completion in milliseconds */
+	const wchar_t * output; /**< complete output of the signing application */
+} tSiguwiResult;
+
+
+/**
+ * Called for each state change of a file.
+ *
+ * @param[in] user - `tSiguwiEngineConfig::user`
+ * @param[in] tag - tag passed to `siguwi_engine_submit()`
+ * @param[in] state - new state
+ */
+typedef void (* SiguwiProgressCallback)(void * user, void * tag, const tSiguwiState state);
+
+
+/**
+ * Called for each chunk of decoded signing application output.
+ *
+ * @param[in] user - `tSiguwiEngineConfig::user`
+ * @param[in] tag - tag passed to `siguwi_engine_submit()`
+ * @param[in] text - output text (not null-terminated)
+ * @param[in] len - length of `text` in number of characters
+ */
+typedef void (* SiguwiOutputCallback)(void * user, void * tag, const wchar_t * text, const size_t len);
+
+
+/**
+ * Called once for each file after it reached a final state.
+ *
+ * @param[in] user - `tSiguwiEngineConfig::user`
+ * @param[in] tag - tag passed to `siguwi_engine_submit()`
+ * @param[in] result - file result
+ */
+typedef void (* SiguwiCompleteCallback)(void * user, void * tag, const tSiguwiResult * result);
+
+
+/**
+ * Engine configuration. All callbacks are optional and are called from the
+ * engine worker thread. They shall not call `siguwi_engine_drain()` or
+ * `siguwi_engine_delete()`.
+ */
+typedef struct {
+	const wchar_t * configUrl; /**< INI configuration file path */
+	const wchar_t * configGroup; /**< INI section name or `NULL` for the default one */
+	HWND parent; /**< owner window of the PIN prompt or `NULL` */
+	SiguwiProgressCallback onProgress; /**< state change callback or `NULL` */
+	SiguwiOutputCallback onOutput; /**< output callback or `NULL` */
+	SiguwiCompleteCallback onComplete; /**< completion callback or `NULL` */
+	void * user; /**< user pointer passed to all callbacks */
+} tSiguwiEngineConfig;
+
+
+/**
+ * Opaque signing queue handle.
+ */
+typedef struct tSiguwiEngine tSiguwiEngine;
+
+
+tSiguwiEngine * siguwi_engine_create(const tSiguwiEngineConfig * config);
+bool siguwi_engine_submit(tSiguwiEngine * engine, const wchar_t * path, void * tag);
+bool siguwi_engine_cancel(tSiguwiEngine * engine, void * tag);
+bool siguwi_engine_cancel_all(tSiguwiEngine * engine);
+bool siguwi_engine_drain(tSiguwiEngine * engine, const DWORD timeout);
+void siguwi_engine_delete(tSiguwiEngine * engine);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __SIGUWI_ENGINE_H__ */
@@ -0,0 +1,346 @@
+/**
+ * @file siguwi-hash.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Size of a digest cache value: digest followed by the `FDIGEST_*` flags.
+ */
+#define HASH_VALUE_SIZE (SHA256_SIZE + 1)
+
+
+/**
+ * Format-aware digest algorithm per file extension. Files with other
+ * extensions are hashed as a whole.
+ */
+static const struct {
+	const wchar_t * ext;
+	tHashAlgo algo;
+	tFileDigestFormat format;
+} hashFormats[] = {
+	{L".exe", HA_PE_SHA256,  FDF_PE},
+	{L".dll", HA_PE_SHA256,  FDF_PE},
+	{L".msi", HA_MSI_SHA256, FDF_MSI},
+	{L".cab", HA_CAB_SHA256, FDF_CAB},
+	{L".ps1", HA_PS1_SHA256, FDF_PS1}
+};
+
+
+/**
+ * Returns the digest algorithm for the given file.
+ *
+ * @param[in] path - file path
+ * @return digest algorithm
+ */
+static tHashAlgo hashAlgo(const wchar_t * path) {
+	const wchar_t * ext = wcsrchr(path, L'.');
+	if (ext != NULL && wcschr(ext, L'\\') == NULL && wcschr(ext, L'/') == NULL) {
+		for (size_t i = 0; i < ARRAY_SIZE(hashFormats); ++i) {
+			if (_wcsicmp(ext, hashFormats[i].ext) == 0) {
+				return hashFormats[i].algo;
+			}
+		}
+	}
+	return HA_FILE_SHA256;
+}
+
+
+/**
+ * Returns the file format which is hashed by the given digest algorithm.
+ *
+ * @param[in] algo - digest algorithm
+ * @return file format
+ */
+static tFileDigestFormat hashFormat(const uint32_t algo) {
+	for (size_t i = 0; i < ARRAY_SIZE(hashFormats); ++i) {
+		if ((uint32_t)(hashFormats[i].algo) == algo) {
+			return hashFormats[i].format;
+		}
+	}
+	return FDF_RAW;
+}
+
+
+/**
+ * Retrieves the digest cache key of the given open file.
+ *
+ * @param[in] hFile - file handle
+ * @param[out] key - receives the file state
+ * @return `true` on success, else `false`
+ */
+static bool hashKey(HANDLE hFile, tDigestKey * key) {
+	BY_HANDLE_FILE_INFORMATION info;
+	FILE_BASIC_INFO basic;
+	if (( ! GetFileInformationByHandle(hFile, &info) ) || ( ! GetFileInformationByHandleEx(hFile, FileBasicInfo, &basic, sizeof(basic)) )) {
+		return false;
+	}
+	if ((info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+		SetLastError(ERROR_DIRECTORY);
+		return false;
+	}
+	key->volume = (uint64_t)(info.dwVolumeSerialNumber);
+	key->id = ((uint64_t)(info.nFileIndexHigh) << 32) | (uint64_t)(info.nFileIndexLow);
+	key->size = ((uint64_t)(info.nFileSizeHigh) << 32) | (uint64_t)(info.nFileSizeLow);
+	key->mtime = (uint64_t)(basic.LastWriteTime.QuadPart);
+	key->ctime = (uint64_t)(basic.ChangeTime.QuadPart);
+	return true;
+}
+
+
+/**
+ * Hashes the file of the given job according to its format. The file is mapped
+ * into memory as a whole and only hashed if it still matches the state at
+ * request time. Writers are locked out while hashing.
+ *
+ * @param[in,out] job - hashing job
+ * @return `true` on success, else `false`
+ */
+static bool hashFile(tHashJob * job) {
+	tDigestKey key;
+	unsigned flags = 0;
+	const HANDLE hFile = CreateFileW(job->path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	const tDigestKey * expected = &(job->key);
+	bool res = hashKey(hFile, &key) && key.volume == expected->volume && key.id == expected->id && key.size == expected->size && key.mtime == expected->mtime && key.ctime == expected->ctime && key.size <= SIZE_MAX;
+	if ( res ) {
+		const HANDLE hMap = (key.size > 0) ? CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+		const uint8_t * data = (hMap != NULL) ? MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, (SIZE_T)(key.size)) : NULL;
+		res = (key.size == 0 || data != NULL) && fdigest_compute(hashFormat(expected->algo), data, (size_t)(key.size), job->digest, &flags);
+		if (data != NULL) {
+			UnmapViewOfFile(data);
+		}
+		if (hMap != NULL) {
+			CloseHandle(hMap);
+		}
+	}
+	job->isSigned = (flags & FDIGEST_SIGNED) != 0;
+	CloseHandle(hFile);
+	return res;
+}
+
+
+/**
+ * Hashes the file of the given job. This is called by the hashing threads.
+ *
+ * @param[in,out] item - hashing job
+ * @param[in,out] param - hashing pool
+ */
+static void hashRun(tWorkItem * item, void * param) {
+	PCF_UNUSED(param);
+	tHashJob * job = CONTAINER_OF(item, tHashJob, item);
+	trace_setThreadName("hash");
+	TRACE_BEGIN("hash", "hashFile");
+	job->state = hashFile(job) ? HJS_OK : HJS_FAILED;
+	TRACE_END("hash", "hashFile");
+}
+
+
+/**
+ * Signals the process window thread that a hashing job finished.
+ *
+ * @param[in,out] param - hashing pool
+ */
+static void hashNotify(void * param) {
+	SetEvent(((tHashPool *)param)->hDone);
+}
+
+
+/**
+ * Starts the hashing threads of the given pool if not done already. One
+ * thread per logical processor is started up to `HASH_MAX_THREADS`.
+ *
+ * @param[in,out] pool - hashing pool
+ * @return `true` on success, else `false`
+ */
+static bool hashStart(tHashPool * pool) {
+	if ( pool->started ) {
+		return pool->threads != NULL;
+	}
+	pool->started = true;
+	pool->hDone = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (pool->hDone == NULL) {
+		return false;
+	}
+	pool->threads = wpool_create(HASH_MAX_THREADS, hashRun, hashNotify, pool);
+	return pool->threads != NULL;
+}
+
+
+/**
+ * Frees the given hashing job. The directory tree reference is released by
+ * `scanHashed()`.
+ *
+ * @param[in,out] job - hashing job
+ */
+static void hashFree(tHashJob * job) {
+	rcIniConfigBaseDelete(job->config);
+	rws_release(&(job->signApp));
+	wStrDelete(&(job->path));
+	free(job);
+}
+
+
+/**
+ * Completes the given finished hashing job and frees it. Successfully
+ * computed digests are added to the digest cache.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] job - finished hashing job
+ */
+static void hashFinish(tIpcWndCtx * ctx, tHashJob * job) {
+	if (job->state == HJS_OK) {
+		uint8_t value[HASH_VALUE_SIZE];
+		memcpy(value, job->digest, SHA256_SIZE);
+		value[SHA256_SIZE] = (uint8_t)(job->isSigned ? FDIGEST_SIGNED : 0);
+		if ( ! dcache_put(ctx->hash.cache, &(job->key), value, sizeof(value)) ) {
+			TRACE_INSTANT("hash", "cacheFull", 1);
+		}
+	}
+	scanHashed(ctx, job);
+	hashFree(job);
+}
+
+
+/**
+ * Retrieves the digest cache key of the given file. The digest algorithm is
+ * selected by the file extension.
+ *
+ * @param[in] path - file path
+ * @param[out] key - receives the file state
+ * @return `true` on success, else `false`
+ */
+bool hashIdentity(const wchar_t * path, tDigestKey * key) {
+	if (path == NULL || key == NULL) {
+		return false;
+	}
+	const HANDLE hFile = CreateFileW(path, FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, 0, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	memset(key, 0, sizeof(*key));
+	const bool res = hashKey(hFile, key);
+	const DWORD err = GetLastError();
+	key->algo = (uint32_t)hashAlgo(path);
+	CloseHandle(hFile);
+	SetLastError(err);
+	return res;
+}
+
+
+/**
+ * Requests the content digest of the given file of a scanned directory tree.
+ * The digest cache is checked first. The file is hashed by the hashing pool
+ * on a miss. `scanHashed()` is called with the result in both cases. This may
+ * happen before this function returns.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in] path - file path
+ * @param[in] key - file state as returned by `hashIdentity()`
+ * @param[in,out] tree - scanned directory tree of the file
+ * @param[in] entry - file identity index entry identifier
+ * @param[in,out] c - INI configuration base to sign the file with if it changed or `NULL` to record its digest
+ * @param[in,out] signApp - code signing application command-line or `NULL`
+ * @return `true` on success, else `false` if the request was not added
+ */
+bool hashRequest(tIpcWndCtx * ctx, const wchar_t * path, const tDigestKey * key, tTreeScan * tree, const uint64_t entry, tRcIniConfigBase * c, tRcWStr * signApp) {
+	if (ctx == NULL || path == NULL || key == NULL || tree == NULL) {
+		return false;
+	}
+	tHashPool * pool = &(ctx->hash);
+	if ( ! pool->cacheOpened ) {
+		/* the cache is optional; it is locked while another process uses it */
+		wchar_t cachePath[MAX_PATH + 1];
+		pool->cacheOpened = true;
+		if ( wLocalDataPath(HASH_CACHE_FILE, cachePath, ARRAY_SIZE(cachePath)) ) {
+			pool->cache = dcache_open(cachePath);
+		}
+	}
+	tHashJob * job = calloc(1, sizeof(tHashJob));
+	if (job == NULL) {
+		return false;
+	}
+	job->path = wcsdup(path);
+	if (job->path == NULL) {
+		free(job);
+		return false;
+	}
+	job->key = *key;
+	job->entry = entry;
+	job->tree = scanAquire(tree);
+	job->config = (c != NULL) ? rcIniConfigBaseClone(c) : NULL;
+	job->signApp = rws_aquire(signApp);
+	uint8_t value[HASH_VALUE_SIZE];
+	if (dcache_get(pool->cache, key, value, sizeof(value)) == sizeof(value)) {
+		TRACE_INSTANT("hash", "cacheHit", 1);
+		memcpy(job->digest, value, SHA256_SIZE);
+		job->isSigned = (value[SHA256_SIZE] & FDIGEST_SIGNED) != 0;
+		job->state = HJS_OK;
+		scanHashed(ctx, job);
+		hashFree(job);
+		return true;
+	}
+	if ( ! hashStart(pool) ) {
+		scanRelease(job->tree);
+		hashFree(job);
+		return false;
+	}
+	job->state = HJS_PENDING;
+	return wpool_push(pool->threads, &(job->item));
+}
+
+
+/**
+ * Completes all finished hashing jobs. This is called by the process window
+ * thread once `hDone` was signaled.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void hashComplete(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->hash.threads == NULL) {
+		return;
+	}
+	for (tWorkItem * item = wpool_done(ctx->hash.threads), * next; item != NULL; item = next) {
+		next = item->next;
+		hashFinish(ctx, CONTAINER_OF(item, tHashJob, item));
+	}
+}
+
+
+/**
+ * Stops the hashing threads and closes the digest cache. Queued jobs are
+ * cancelled. Finished digests are still recorded but no files are added to
+ * the process list anymore.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void hashDelete(tIpcWndCtx * ctx) {
+	if (ctx == NULL) {
+		return;
+	}
+	tHashPool * pool = &(ctx->hash);
+	if ( pool->started ) {
+		for (tWorkItem * item = wpool_delete(pool->threads), * next; item != NULL; item = next) {
+			next = item->next;
+			tHashJob * job = CONTAINER_OF(item, tHashJob, item);
+			if (job->config != NULL || job->state != HJS_OK) {
+				/* do not sign anything while shutting down */
+				job->state = HJS_CANCELLED;
+			}
+			hashFinish(ctx, job);
+		}
+		pool->threads = NULL;
+		if (pool->hDone != NULL) {
+			CloseHandle(pool->hDone);
+			pool->hDone = NULL;
+		}
+		pool->started = false;
+	}
+	dcache_close(pool->cache);
+	pool->cache = NULL;
+}
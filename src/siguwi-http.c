@@ -0,0 +1,1687 @@
+/**
+ * @file siguwi-http.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Parsed HTTP request. All pointers point into the receive buffer of the
+ * connection and are not null-terminated.
+ */
+typedef struct {
+	const char * method;
+	size_t methodLen;
+	const char * path; /**< request target without query */
+	size_t pathLen;
+	const char * query; /**< query without leading `?` or `NULL` */
+	size_t queryLen;
+	const char * type; /**< `Content-Type` value or `NULL` */
+	size_t typeLen;
+	const char * auth; /**< `X-Siguwi-Auth` value or `NULL` */
+	size_t authLen;
+	const char * body;
+	size_t bodyLen;
+	bool keepAlive;
+} tHttpRequest;
+
+
+/**
+ * JSON request body parsing context.
+ */
+typedef struct {
+	const wchar_t * ptr; /**< current parsing position */
+	const wchar_t * end; /**< end of the body */
+} tHttpJson;
+
+
+static bool httpRecv(tHttpConn * conn);
+static void httpProcess(tHttpConn * conn);
+
+
+/**
+ * Returns the reason phrase for the given HTTP status code.
+ *
+ * @param[in] status - HTTP status code
+ * @return reason phrase
+ */
+static const char * httpStatusStr(const unsigned status) {
+	switch (status) {
+	case 200: return "OK";
+	case 400: return "Bad Request";
+	case 401: return "Unauthorized";
+	case 403: return "Forbidden";
+	case 404: return "Not Found";
+	case 405: return "Method Not Allowed";
+	case 409: return "Conflict";
+	case 413: return "Content Too Large";
+	case 415: return "Unsupported Media Type";
+	case 501: return "Not Implemented";
+	case 503: return "Service Unavailable";
+	default: break;
+	}
+	return "Internal Server Error";
+}
+
+
+/**
+ * Returns the process window context of the given connection.
+ *
+ * @param[in] conn - connection
+ * @return process window context
+ */
+static tIpcWndCtx * httpCtx(const tHttpConn * conn) {
+	return CONTAINER_OF(conn->server, tIpcWndCtx, http);
+}
+
+
+/**
+ * Frees the given connection. The socket needs to be closed before.
+ *
+ * @param[in,out] conn - connection
+ */
+static void httpConnDelete(tHttpConn * conn) {
+	if (conn->in != NULL) {
+		free(conn->in);
+	}
+	if (conn->out != NULL) {
+		free(conn->out);
+	}
+	free(conn);
+}
+
+
+/**
+ * Closes the given connection and removes it from the connection list. It is
+ * freed once the pending asynchronous operation was aborted.
+ *
+ * @param[in,out] conn - connection
+ */
+static void httpClose(tHttpConn * conn) {
+	if (conn->state == HCS_CLOSED) {
+		return;
+	}
+	tVector * conns = conn->server->conns;
+	const size_t count = vec_size(conns);
+	for (size_t i = 0; i < count; ++i) {
+		if (*((tHttpConn **)vec_at(conns, i)) == conn) {
+			vec_erase(conns, i, 1);
+			break;
+		}
+	}
+	conn->state = HCS_CLOSED;
+	if (conn->sock != INVALID_SOCKET) {
+		closesocket(conn->sock);
+		conn->sock = INVALID_SOCKET;
+	}
+	if ( conn->busy ) {
+		++(conn->server->closing);
+	} else {
+		httpConnDelete(conn);
+	}
+}
+
+
+/**
+ * Handles the send complete event of a connection.
+ *
+ * @param[in] dwError - I/O completion status
+ * @param[in] cbTransferred - number of bytes transferred
+ * @param[in] lpOverlapped - pointer to the `WSAOVERLAPPED` structure of the connection
+ * @param[in] dwFlags - completion flags (unused)
+ */
+static void CALLBACK httpSendComplete(DWORD dwError, DWORD cbTransferred, LPWSAOVERLAPPED lpOverlapped, DWORD dwFlags) {
+	PCF_UNUSED(dwFlags);
+	tHttpConn * conn = CONTAINER_OF(lpOverlapped, tHttpConn, ov);
+	conn->busy = false;
+	if (conn->state == HCS_CLOSED) {
+		--(conn->server->closing);
+		httpConnDelete(conn);
+		return;
+	}
+	if (dwError != 0) {
+		httpClose(conn);
+		return;
+	}
+	conn->outPos += (size_t)cbTransferred;
+	if (conn->outPos < conn->outLen) {
+		/* partial send */
+		WSABUF buf = {(ULONG)(conn->outLen - conn->outPos), conn->out + conn->outPos};
+		ZeroMemory(&(conn->ov), sizeof(conn->ov));
+		conn->busy = true;
+		if (WSASend(conn->sock, &buf, 1, NULL, 0, &(conn->ov), httpSendComplete) != 0 && WSAGetLastError() != WSA_IO_PENDING) {
+			conn->busy = false;
+			httpClose(conn);
+		}
+		return;
+	}
+	free(conn->out);
+	conn->out = NULL;
+	conn->outLen = 0;
+	conn->outPos = 0;
+	/* remove the answered request from the receive buffer */
+	conn->inLen -= conn->reqLen;
+	if (conn->inLen > 0) {
+		memmove(conn->in, conn->in + conn->reqLen, conn->inLen);
+	}
+	conn->reqLen = 0;
+	if ( ! conn->keepAlive ) {
+		httpClose(conn);
+		return;
+	}
+	conn->state = HCS_READ;
+	if (conn->inLen > 0) {
+		/* pipelined request */
+		httpProcess(conn);
+	} else if ( ! httpRecv(conn) ) {
+		httpClose(conn);
+	}
+}
+
+
+/**
+ * Sends the given response on the connection. The connection continues with
+ * the next request afterwards or is closed if `keepAlive` is not set. Responses
+ * to signed requests are signed with the shared agent key.
+ *
+ * @param[in,out] conn - connection
+ * @param[in] status - HTTP status code
+ * @param[in] type - content type
+ * @param[in] body - response body
+ * @param[in] len - response body length in bytes
+ */
+static void httpRespond(tHttpConn * conn, const unsigned status, const char * type, const char * body, const size_t len) {
+	char header[384];
+	char mac[(2 * SHA256_SIZE) + 1] = {0};
+	if (conn->server->key != NULL && conn->reqMac[0] != 0) {
+		char statusStr[16];
+		snprintf(statusStr, sizeof(statusStr), "%u", status);
+		const char * parts[] = {conn->reqMac, statusStr, body};
+		const size_t lens[] = {strlen(conn->reqMac), strlen(statusStr), len};
+		httpAuthMac(conn->server->key, conn->server->keyLen, parts, lens, ARRAY_SIZE(parts), mac);
+	}
+	const int headerLen = snprintf(header, sizeof(header),
+		"HTTP/1.1 %u %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nCache-Control: no-store\r\nConnection: %s\r\n%s%s%s\r\n",
+		status, httpStatusStr(status), type, len, conn->keepAlive ? "keep-alive" : "close",
+		(mac[0] != 0) ? "X-Siguwi-Auth: " : "", mac, (mac[0] != 0) ? "\r\n" : ""
+	);
+	if (headerLen <= 0 || (size_t)headerLen >= sizeof(header)) {
+		httpClose(conn);
+		return;
+	}
+	conn->out = malloc((size_t)headerLen + len);
+	if (conn->out == NULL) {
+		httpClose(conn);
+		return;
+	}
+	memcpy(conn->out, header, (size_t)headerLen);
+	if (len > 0) {
+		memcpy(conn->out + headerLen, body, len);
+	}
+	conn->outLen = (size_t)headerLen + len;
+	conn->outPos = 0;
+	conn->state = HCS_WRITE;
+	WSABUF buf = {(ULONG)(conn->outLen), conn->out};
+	ZeroMemory(&(conn->ov), sizeof(conn->ov));
+	conn->busy = true;
+	if (WSASend(conn->sock, &buf, 1, NULL, 0, &(conn->ov), httpSendComplete) != 0 && WSAGetLastError() != WSA_IO_PENDING) {
+		conn->busy = false;
+		httpClose(conn);
+	}
+}
+
+
+/**
+ * Sends the given string buffer as UTF-8 encoded response.
+ *
+ * @param[in,out] conn - connection
+ * @param[in] status - HTTP status code
+ * @param[in] type - content type
+ * @param[in] sb - response body or `NULL` on allocation error
+ */
+static void httpRespondStr(tHttpConn * conn, const unsigned status, const char * type, tUStrBuf * sb) {
+	wchar_t * str = (sb != NULL) ? usb_get(sb) : NULL;
+	char * utf8 = wToUtf8(str);
+	if (str != NULL) {
+		free(str);
+	}
+	if (sb != NULL) {
+		usb_delete(sb);
+	}
+	if (utf8 == NULL) {
+		conn->keepAlive = false;
+		httpRespond(conn, 500, "text/plain; charset=utf-8", NULL, 0);
+		return;
+	}
+	httpRespond(conn, status, type, utf8, strlen(utf8));
+	free(utf8);
+}
+
+
+/**
+ * Sends a JSON error response with the given message.
+ *
+ * @param[in,out] conn - connection
+ * @param[in] status - HTTP status code
+ * @param[in] msg - error message
+ */
+static void httpRespondError(tHttpConn * conn, const unsigned status, const wchar_t * msg) {
+	tUStrBuf * sb = usb_create(256);
+	if (sb != NULL) {
+		usb_add(sb, L"{\"error\": ");
+		reportAddJsonStr(sb, msg);
+		usb_add(sb, L"}\n");
+	}
+	httpRespondStr(conn, status, "application/json; charset=utf-8", sb);
+}
+
+
+/**
+ * Adds the status of the given item as JSON object.
+ *
+ * @param[in,out] sb - output string buffer
+ * @param[in] ctx - Window/IPC context
+ * @param[in] i - item index
+ */
+static void httpAddItem(tUStrBuf * sb, const tIpcWndCtx * ctx, const size_t i) {
+	const tProcCtx * item = vec_at(ctx->v, i);
+	usb_addFmt(sb, L"{\"id\": %zu, \"path\": ", i);
+	reportAddJsonStr(sb, item->path);
+	usb_add(sb, L", \"result\": ");
+	reportAddJsonStr(sb, procStateStr[item->state]);
+	usb_addFmt(sb, L", \"done\": %s", (item->state != PST_IDLE && item->state != PST_RUNNING) ? L"true" : L"false");
+	if ( item->hasExitCode ) {
+		usb_addFmt(sb, L", \"exitCode\": %" PRIu32 L"}", (uint32_t)(item->exitCode));
+	} else {
+		usb_add(sb, L", \"exitCode\": null}");
+	}
+}
+
+
+/**
+ * Sends the status of all items starting at the given index.
+ *
+ * @param[in,out] conn - connection
+ * @param[in] from - first item index
+ */
+static void httpRespondItems(tHttpConn * conn, const size_t from) {
+	const tIpcWndCtx * ctx = httpCtx(conn);
+	const size_t count = vec_size(ctx->v);
+	tUStrBuf * sb = usb_create(4096);
+	if (sb != NULL) {
+		usb_add(sb, L"{\"session\": \"");
+		usb_add(sb, conn->server->session);
+		usb_addFmt(sb, L"\", \"seq\": %" PRIu64 L", \"count\": %zu, \"pending\": %zu, \"items\": [", conn->server->seq, count, ctx->stateCount[PST_IDLE] + ctx->stateCount[PST_RUNNING]);
+		for (size_t i = from; i < count; ++i) {
+			usb_add(sb, (i > from) ? L",\n\t" : L"\n\t");
+			httpAddItem(sb, ctx, i);
+		}
+		usb_add(sb, (from < count) ? L"\n]}\n" : L"]}\n");
+	}
+	httpRespondStr(conn, 200, "application/json; charset=utf-8", sb);
+}
+
+
+/**
+ * Finds the given header field in the given request header line.
+ *
+ * @param[in] line - header line
+ * @param[in] len - header line length
+ * @param[in] name - lower case field name
+ * @param[out] value - receives the field value
+ * @param[out] valueLen - receives the field value length
+ * @return `true` if matching, else `false`
+ */
+static bool httpHeaderField(const char * line, const size_t len, const char * name, const char ** value, size_t * valueLen) {
+	const size_t nameLen = strlen(name);
+	if (len <= nameLen || line[nameLen] != ':' || _strnicmp(line, name, nameLen) != 0) {
+		return false;
+	}
+	const char * start = line + nameLen + 1;
+	const char * end = line + len;
+	for (; start < end && (*start == ' ' || *start == '\t'); ++start);
+	for (; end > start && (end[-1] == ' ' || end[-1] == '\t'); --end);
+	*value = start;
+	*valueLen = (size_t)(end - start);
+	return true;
+}
+
+
+/**
+ * Checks whether the given string contains the given token (case-insensitive).
+ *
+ * @param[in] str - string to search
+ * @param[in] len - string length
+ * @param[in] token - lower case token
+ * @return `true` if found, else `false`
+ */
+static bool httpHasToken(const char * str, const size_t len, const char * token) {
+	const size_t tokenLen = strlen(token);
+	for (size_t i = 0; i + tokenLen <= len; ++i) {
+		if (_strnicmp(str + i, token, tokenLen) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Checks whether the given `Host` header value names the loopback interface.
+ * This rejects requests of web pages which resolve their own host name to the
+ * loopback address.
+ *
+ * @param[in] host - host header value
+ * @param[in] len - host header value length
+ * @return `true` if valid, else `false`
+ */
+static bool httpIsLoopbackHost(const char * host, const size_t len) {
+	static const char * names[] = {"127.0.0.1", "localhost", "[::1]"};
+	size_t nameLen = len;
+	const char * colon = memchr(host, ':', len);
+	if (colon != NULL && *host != '[') {
+		nameLen = (size_t)(colon - host);
+	} else if (*host == '[') {
+		const char * bracket = memchr(host, ']', len);
+		nameLen = (bracket != NULL) ? (size_t)(bracket - host + 1) : len;
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(names); ++i) {
+		if (strlen(names[i]) == nameLen && _strnicmp(host, names[i], nameLen) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Parses the next complete request in the given buffer.
+ *
+ * @param[in] buf - receive buffer
+ * @param[in] len - bytes in `buf`
+ * @param[in] anyHost - accept any `Host` header value (signed requests only)?
+ * @param[out] req - receives the parsed request
+ * @param[out] status - receives the HTTP error status code or 0
+ * @return request length in bytes or 0 if incomplete or on error (see `status`)
+ */
+static size_t httpParse(const char * buf, const size_t len, const bool anyHost, tHttpRequest * req, unsigned * status) {
+	ZeroMemory(req, sizeof(*req));
+	*status = 0;
+	/* find end of header */
+	size_t headerLen = 0;
+	for (size_t i = 3; i < len; ++i) {
+		if (buf[i] == '\n' && buf[i - 1] == '\r' && buf[i - 2] == '\n' && buf[i - 3] == '\r') {
+			headerLen = i + 1;
+			break;
+		}
+	}
+	if (headerLen == 0) {
+		return 0; /* need more data */
+	}
+	/* request line */
+	const char * line = buf;
+	const char * lineEnd = memchr(line, '\r', headerLen);
+	const char * sp1 = memchr(line, ' ', (size_t)(lineEnd - line));
+	const char * sp2 = (sp1 != NULL) ? memchr(sp1 + 1, ' ', (size_t)(lineEnd - sp1 - 1)) : NULL;
+	if (sp2 == NULL || (lineEnd - sp2 - 1) != 8 || memcmp(sp2 + 1, "HTTP/1.", 7) != 0 || (sp2[8] != '0' && sp2[8] != '1')) {
+		*status = 400;
+		return 0;
+	}
+	const bool http10 = (sp2[8] == '0');
+	req->method = line;
+	req->methodLen = (size_t)(sp1 - line);
+	req->path = sp1 + 1;
+	req->pathLen = (size_t)(sp2 - sp1 - 1);
+	const char * query = memchr(req->path, '?', req->pathLen);
+	if (query != NULL) {
+		req->query = query + 1;
+		req->queryLen = (size_t)(req->path + req->pathLen - req->query);
+		req->pathLen = (size_t)(query - req->path);
+	}
+	/* header fields */
+	bool hasHost = false;
+	bool keepAlive = false;
+	bool close = false;
+	size_t bodyLen = 0;
+	for (line = lineEnd + 2; line < buf + headerLen - 2; line = lineEnd + 2) {
+		lineEnd = memchr(line, '\r', (size_t)(buf + headerLen - line));
+		const size_t lineLen = (size_t)(lineEnd - line);
+		const char * value;
+		size_t valueLen;
+		if ( httpHeaderField(line, lineLen, "content-length", &value, &valueLen) ) {
+			bodyLen = 0;
+			if (valueLen == 0 || valueLen > 9) {
+				*status = (valueLen > 9) ? 413 : 400;
+				return 0;
+			}
+			for (size_t i = 0; i < valueLen; ++i) {
+				if (value[i] < '0' || value[i] > '9') {
+					*status = 400;
+					return 0;
+				}
+				bodyLen = (bodyLen * 10) + (size_t)(value[i] - '0');
+			}
+		} else if ( httpHeaderField(line, lineLen, "connection", &value, &valueLen) ) {
+			close = close || httpHasToken(value, valueLen, "close");
+			keepAlive = keepAlive || httpHasToken(value, valueLen, "keep-alive");
+		} else if ( httpHeaderField(line, lineLen, "content-type", &value, &valueLen) ) {
+			req->type = value;
+			req->typeLen = valueLen;
+		} else if ( httpHeaderField(line, lineLen, "host", &value, &valueLen) ) {
+			hasHost = true;
+			if (( ! anyHost ) && ( ! httpIsLoopbackHost(value, valueLen) )) {
+				*status = 403;
+				return 0;
+			}
+		} else if ( httpHeaderField(line, lineLen, "x-siguwi-auth", &value, &valueLen) ) {
+			req->auth = value;
+			req->authLen = valueLen;
+		} else if ( httpHeaderField(line, lineLen, "origin", &value, &valueLen) ) {
+			/* no cross-origin requests from web browsers */
+			*status = 403;
+			return 0;
+		} else if ( httpHeaderField(line, lineLen, "transfer-encoding", &value, &valueLen) ) {
+			*status = 501;
+			return 0;
+		}
+	}
+	if (( ! http10 ) && ( ! hasHost )) {
+		*status = 400;
+		return 0;
+	}
+	req->keepAlive = http10 ? (keepAlive && ( ! close )) : ( ! close );
+	if (bodyLen > HTTP_MAX_REQUEST || (headerLen + bodyLen) > HTTP_MAX_REQUEST) {
+		*status = 413;
+		return 0;
+	}
+	if ((headerLen + bodyLen) > len) {
+		return 0; /* need more data */
+	}
+	req->body = buf + headerLen;
+	req->bodyLen = bodyLen;
+	return headerLen + bodyLen;
+}
+
+
+/**
+ * Returns the value of the given numeric query parameter.
+ *
+ * @param[in] req - request
+ * @param[in] name - parameter name
+ * @param[in] def - default value
+ * @return parameter value or `def` if missing or invalid
+ */
+static uint64_t httpQueryNum(const tHttpRequest * req, const char * name, const uint64_t def) {
+	const size_t nameLen = strlen(name);
+	const char * ptr = req->query;
+	const char * end = req->query + req->queryLen;
+	while (ptr != NULL && ptr < end) {
+		const char * next = memchr(ptr, '&', (size_t)(end - ptr));
+		const char * paramEnd = (next != NULL) ? next : end;
+		if ((size_t)(paramEnd - ptr) > nameLen && ptr[nameLen] == '=' && memcmp(ptr, name, nameLen) == 0) {
+			uint64_t value = 0;
+			const char * it = ptr + nameLen + 1;
+			if (it == paramEnd || (paramEnd - it) > 19) {
+				return def;
+			}
+			for (; it < paramEnd; ++it) {
+				if (*it < '0' || *it > '9') {
+					return def;
+				}
+				value = (value * 10) + (uint64_t)(*it - '0');
+			}
+			return value;
+		}
+		ptr = (next != NULL) ? next + 1 : NULL;
+	}
+	return def;
+}
+
+
+/**
+ * Skips white-space in the JSON request body.
+ *
+ * @param[in,out] j - JSON parsing context
+ */
+static void httpJsonSkipWs(tHttpJson * j) {
+	for (; j->ptr < j->end && (*(j->ptr) == L' ' || *(j->ptr) == L'\t' || *(j->ptr) == L'\r' || *(j->ptr) == L'\n'); ++(j->ptr));
+}
+
+
+/**
+ * Consumes the given character after optional white-space.
+ *
+ * @param[in,out] j - JSON parsing context
+ * @param[in] c - expected character
+ * @return `true` if consumed, else `false`
+ */
+static bool httpJsonExpect(tHttpJson * j, const wchar_t c) {
+	httpJsonSkipWs(j);
+	if (j->ptr < j->end && *(j->ptr) == c) {
+		++(j->ptr);
+		return true;
+	}
+	return false;
+}
+
+
+/**
+ * Parses a JSON string.
+ *
+ * @param[in,out] j - JSON parsing context
+ * @return newly allocated string or `NULL` on error
+ */
+static wchar_t * httpJsonString(tHttpJson * j) {
+	if ( ! httpJsonExpect(j, L'"') ) {
+		return NULL;
+	}
+	/* unescaped strings are never longer */
+	wchar_t * res = malloc((size_t)(j->end - j->ptr + 1) * sizeof(wchar_t));
+	if (res == NULL) {
+		return NULL;
+	}
+	size_t n = 0;
+	while (j->ptr < j->end && *(j->ptr) != L'"') {
+		wchar_t c = *(j->ptr)++;
+		if (c < 0x20) {
+			goto onError;
+		}
+		if (c == L'\\') {
+			if (j->ptr >= j->end) {
+				goto onError;
+			}
+			c = *(j->ptr)++;
+			switch (c) {
+			case L'"':
+			case L'\\':
+			case L'/': break;
+			case L'b': c = L'\b'; break;
+			case L'f': c = L'\f'; break;
+			case L'n': c = L'\n'; break;
+			case L'r': c = L'\r'; break;
+			case L't': c = L'\t'; break;
+			case L'u':
+				if ((j->end - j->ptr) < 4) {
+					goto onError;
+				}
+				c = 0;
+				for (size_t i = 0; i < 4; ++i) {
+					const wchar_t h = *(j->ptr)++;
+					c = (wchar_t)(c << 4);
+					if (h >= L'0' && h <= L'9') {
+						c = (wchar_t)(c | (h - L'0'));
+					} else if (h >= L'a' && h <= L'f') {
+						c = (wchar_t)(c | (h - L'a' + 10));
+					} else if (h >= L'A' && h <= L'F') {
+						c = (wchar_t)(c | (h - L'A' + 10));
+					} else {
+						goto onError;
+					}
+				}
+				/* an embedded NUL would end the decoded string early */
+				if (c == 0) {
+					goto onError;
+				}
+				break;
+			default:
+				goto onError;
+			}
+		}
+		res[n++] = c;
+	}
+	if (j->ptr >= j->end) {
+		goto onError;
+	}
+	++(j->ptr);
+	res[n] = 0;
+	return res;
+onError:
+	free(res);
+	return NULL;
+}
+
+
+/**
+ * Parses the JSON body of a submit request. The expected format is
+ * `{"config": "section", "files": ["path", ...]}` whereas `config` is optional.
+ *
+ * @param[in] body - UTF-16 request body
+ * @param[in] len - request body length in number of characters
+ * @param[out] section - receives the configuration section or `NULL`
+ * @param[in,out] files - receives the file paths (`wchar_t *`)
+ * @return `true` on success, else `false`
+ */
+static bool httpParseSubmit(const wchar_t * body, const size_t len, wchar_t ** section, tVector * files) {
+	tHttpJson j = {body, body + len};
+	bool hasFiles = false;
+	*section = NULL;
+	if ( ! httpJsonExpect(&j, L'{') ) {
+		return false;
+	}
+	if ( ! httpJsonExpect(&j, L'}') ) {
+		do {
+			wchar_t * key = httpJsonString(&j);
+			if (key == NULL || ( ! httpJsonExpect(&j, L':') )) {
+				wStrDelete(&key);
+				return false;
+			}
+			if (wcscmp(key, L"config") == 0 && *section == NULL) {
+				*section = httpJsonString(&j);
+				if (*section == NULL) {
+					wStrDelete(&key);
+					return false;
+				}
+			} else if (wcscmp(key, L"files") == 0 && ( ! hasFiles )) {
+				hasFiles = true;
+				if ( ! httpJsonExpect(&j, L'[') ) {
+					wStrDelete(&key);
+					return false;
+				}
+				if ( ! httpJsonExpect(&j, L']') ) {
+					do {
+						wchar_t * file = httpJsonString(&j);
+						wchar_t ** item = (file != NULL) ? vec_pushBack(files) : NULL;
+						if (item == NULL) {
+							wStrDelete(&file);
+							wStrDelete(&key);
+							return false;
+						}
+						*item = file;
+					} while ( httpJsonExpect(&j, L',') );
+					if ( ! httpJsonExpect(&j, L']') ) {
+						wStrDelete(&key);
+						return false;
+					}
+				}
+			} else {
+				wStrDelete(&key);
+				return false;
+			}
+			wStrDelete(&key);
+		} while ( httpJsonExpect(&j, L',') );
+		if ( ! httpJsonExpect(&j, L'}') ) {
+			return false;
+		}
+	}
+	httpJsonSkipWs(&j);
+	return hasFiles && j.ptr == j.end;
+}
+
+
+/**
+ * Handles a submit request by adding the given files with the given
+ * configuration section to the process list.
+ *
+ * @param[in,out] conn - connection
+ * @param[in] req - request
+ */
+static void httpSubmit(tHttpConn * conn, const tHttpRequest * req) {
+	tIpcWndCtx * ctx = httpCtx(conn);
+	wchar_t * body = NULL;
+	wchar_t * section = NULL;
+	tVector * files = NULL;
+	tRcIniConfigBase * cfgBase = NULL;
+	tIniConfig cfg;
+	ZeroMemory(&cfg, sizeof(cfg));
+	if (req->type == NULL || req->typeLen < 16 || _strnicmp(req->type, "application/json", 16) != 0) {
+		httpRespondError(conn, 415, L"Expected application/json request body.");
+		return;
+	}
+	/* parse request body */
+	const int len = (req->bodyLen > 0) ? MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, req->body, (int)(req->bodyLen), NULL, 0) : 0;
+	body = (len > 0) ? malloc((size_t)len * sizeof(wchar_t)) : NULL;
+	files = vec_create(sizeof(wchar_t *));
+	if (body == NULL || files == NULL) {
+		httpRespondError(conn, (len > 0) ? 500 : 400, (len > 0) ? errStr[ERR_OUT_OF_MEMORY] : L"Invalid request body.");
+		goto onError;
+	}
+	MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, req->body, (int)(req->bodyLen), body, len);
+	if ( ! httpParseSubmit(body, (size_t)len, &section, files) ) {
+		httpRespondError(conn, 400, L"Invalid request body. Expected {\"config\": \"section\", \"files\": [\"path\", ...]}.");
+		goto onError;
+	}
+	const size_t count = vec_size(files);
+	for (size_t i = 0; i < count; ++i) {
+		const wchar_t * file = *((wchar_t **)vec_at(files, i));
+		if (*file == 0 || PathIsRelativeW(file)) {
+			httpRespondError(conn, 400, L"File paths need to be absolute.");
+			goto onError;
+		}
+	}
+	/* resolve configuration */
+	tRcIniConfigBase * c = ctx->cmdlCfg;
+	tRcWStr * signApp = ctx->cmdlSignApp;
+	if (section != NULL) {
+		tFilePos errPos;
+		ZeroMemory(&errPos, sizeof(errPos));
+		if ( ! iniConfigParse(ctx->http.configUrl, section, &cfg, &errPos) ) {
+			httpRespondError(conn, 400, errStr[lastErr]);
+			goto onError;
+		}
+		if (cfg.cert->certId == NULL || cfg.cert->cardName == NULL || cfg.cert->cardReader == NULL || cfg.signApp == NULL) {
+			httpRespondError(conn, 400, L"Incomplete configuration section.");
+			goto onError;
+		}
+		cfg.cert->certProv = getCspFromCardNameW(cfg.cert->cardName);
+		if (cfg.cert->certProv == NULL) {
+			httpRespondError(conn, 400, errStr[ERR_GET_CSP]);
+			goto onError;
+		}
+		cfgBase = rcIniConfigBaseCreate(cfg.cert, cfg.match);
+		if (cfgBase == NULL) {
+			httpRespondError(conn, 500, errStr[ERR_OUT_OF_MEMORY]);
+			goto onError;
+		}
+		if ( ! iniConfigChain(ctx->http.configUrl, cfgBase, cfg.chain) ) {
+			httpRespondError(conn, (lastErr == ERR_OUT_OF_MEMORY) ? 500 : 400, errStr[lastErr]);
+			goto onError;
+		}
+		c = cfgBase;
+		signApp = cfg.signApp;
+	}
+	/* add files (errors are reported by `processAddFile()` and do not affect following files) */
+	const size_t first = vec_size(ctx->v);
+	recordEvent(ctx->rec, RPL_REQUEST, 0, RPS_HTTP, 0);
+	for (size_t i = 0; i < count; ++i) {
+		processAddFile(ctx, c, signApp, *((wchar_t **)vec_at(files, i)), NULL, NULL);
+	}
+	httpRespondItems(conn, first);
+onError:
+	rcIniConfigBaseDelete(cfgBase);
+	wStrDelete(&(cfg.cert->certProv));
+	wStrDelete(&(cfg.cert->certId));
+	wStrDelete(&(cfg.cert->cardName));
+	wStrDelete(&(cfg.cert->cardReader));
+	rws_release(&(cfg.signApp));
+	wStrDelete(&(cfg.match));
+	wStrDelete(&(cfg.chain));
+	shellFilesDelete(files);
+	wStrDelete(&section);
+	wStrDelete(&body);
+}
+
+
+/**
+ * Returns the value of the given hex digit.
+ *
+ * @param[in] c - hex digit
+ * @return digit value or -1 if invalid
+ */
+static int httpHexValue(const char c) {
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	} else if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	} else if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+
+/**
+ * Verifies the signature of the given request with the shared agent key. The
+ * `X-Siguwi-Auth` header holds the request nonce and the HMAC-SHA256 of the
+ * method, request target, nonce and body. Requests outside the accepted time
+ * window and replayed nonces are rejected. The request MAC is kept to sign the
+ * response.
+ *
+ * @param[in,out] conn - connection
+ * @param[in] req - request
+ * @return `true` if authentic, else `false`
+ */
+static bool httpAuthCheck(tHttpConn * conn, const tHttpRequest * req) {
+	tHttpServer * server = conn->server;
+	if (req->auth == NULL || req->authLen != (AGENT_NONCE_LEN + 1 + (2 * SHA256_SIZE)) || req->auth[AGENT_NONCE_LEN] != ':') {
+		return false;
+	}
+	uint64_t time = 0;
+	for (size_t i = 0; i < AGENT_NONCE_LEN; ++i) {
+		const int v = httpHexValue(req->auth[i]);
+		if (v < 0) {
+			return false;
+		}
+		if (i < 16) {
+			time = (time << 4) | (uint64_t)v;
+		}
+	}
+	const uint64_t now = httpAuthTime();
+	if (time <= server->nonceFloor || ((time > now) ? (time - now) : (now - time)) > AGENT_AUTH_WINDOW) {
+		return false;
+	}
+	const size_t targetLen = (req->query != NULL) ? (size_t)(req->query + req->queryLen - req->path) : req->pathLen;
+	const char * parts[] = {req->method, req->path, req->auth, req->body};
+	const size_t lens[] = {req->methodLen, targetLen, AGENT_NONCE_LEN, req->bodyLen};
+	char mac[(2 * SHA256_SIZE) + 1];
+	httpAuthMac(server->key, server->keyLen, parts, lens, ARRAY_SIZE(parts), mac);
+	if ( ! httpAuthEqual(mac, req->auth + AGENT_NONCE_LEN + 1, 2 * SHA256_SIZE) ) {
+		return false;
+	}
+	/* reject replayed requests; older requests than the evicted nonces are rejected by time */
+	for (size_t i = 0; i < AGENT_AUTH_NONCES; ++i) {
+		if (memcmp(server->nonces + (i * AGENT_NONCE_LEN), req->auth, AGENT_NONCE_LEN) == 0) {
+			return false;
+		}
+	}
+	char * slot = server->nonces + (server->nonceNext * AGENT_NONCE_LEN);
+	if (*slot != 0) {
+		uint64_t evicted = 0;
+		for (size_t i = 0; i < 16; ++i) {
+			evicted = (evicted << 4) | (uint64_t)httpHexValue(slot[i]);
+		}
+		if (evicted > server->nonceFloor) {
+			server->nonceFloor = evicted;
+		}
+	}
+	memcpy(slot, req->auth, AGENT_NONCE_LEN);
+	server->nonceNext = (server->nonceNext + 1) % AGENT_AUTH_NONCES;
+	memcpy(conn->reqMac, mac, sizeof(mac));
+	return true;
+}
+
+
+/**
+ * Returns the directory receiving uploaded files. It is created on first use.
+ *
+ * @param[in,out] server - HTTP server context
+ * @return directory path with trailing backslash or `NULL` on error
+ */
+static const wchar_t * httpSpoolDir(tHttpServer * server) {
+	if (server->spoolDir != NULL) {
+		return server->spoolDir;
+	}
+	wchar_t buf[MAX_PATH + 1];
+	const DWORD len = GetTempPathW(ARRAY_SIZE(buf), buf);
+	if (len == 0 || len >= ARRAY_SIZE(buf) || wcscat_s(buf, ARRAY_SIZE(buf), AGENT_SPOOL_DIR) != 0) {
+		return NULL;
+	}
+	if (CreateDirectoryW(buf, NULL) == 0 && GetLastError() != ERROR_ALREADY_EXISTS) {
+		return NULL;
+	}
+	if (wcscat_s(buf, ARRAY_SIZE(buf), L"\\") != 0) {
+		return NULL;
+	}
+	server->spoolDir = wcsdup(buf);
+	return server->spoolDir;
+}
+
+
+/**
+ * Deletes the uploaded files which did not change for `AGENT_SPOOL_EXPIRY`
+ * milliseconds. Files in use are kept.
+ *
+ * @param[in] dir - spool directory with trailing backslash
+ */
+static void httpSpoolExpire(const wchar_t * dir) {
+	wchar_t path[MAX_PATH + 130];
+	if (wcscpy_s(path, ARRAY_SIZE(path), dir) != 0 || wcscat_s(path, ARRAY_SIZE(path), L"*") != 0) {
+		return;
+	}
+	wchar_t * name = path + wcslen(dir);
+	const size_t nameSize = ARRAY_SIZE(path) - wcslen(dir);
+	WIN32_FIND_DATAW fd;
+	HANDLE hFind = FindFirstFileW(path, &fd);
+	if (hFind == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	FILETIME ft;
+	GetSystemTimeAsFileTime(&ft);
+	const uint64_t now = ((uint64_t)(ft.dwHighDateTime) << 32) | (uint64_t)(ft.dwLowDateTime);
+	do {
+		const uint64_t changed = ((uint64_t)(fd.ftLastWriteTime.dwHighDateTime) << 32) | (uint64_t)(fd.ftLastWriteTime.dwLowDateTime);
+		/* file times are in 100ns units */
+		if ((fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0 || changed > now || (now - changed) < (uint64_t)AGENT_SPOOL_EXPIRY * 10000) {
+			continue;
+		}
+		if (wcscpy_s(name, nameSize, fd.cFileName) == 0) {
+			DeleteFileW(path);
+		}
+	} while ( FindNextFileW(hFind, &fd) );
+	FindClose(hFind);
+}
+
+
+/**
+ * Handles a file transfer request of the coordinator. Files are uploaded in
+ * chunks with `PUT /files/<name>?offset=<n>` to be signed by path, downloaded
+ * in chunks with `GET /files/<name>?offset=<n>` and removed with
+ * `DELETE /files/<name>`. A chunk shorter than `AGENT_CHUNK_SIZE` marks the
+ * end of the file. Uploads beyond `AGENT_MAX_UPLOAD` bytes are rejected.
+ * Starting an upload deletes expired files of earlier uploads.
+ *
+ * @param[in,out] conn - connection
+ * @param[in] req - request
+ * @param[in] name - file name within the spool directory
+ * @param[in] nameLen - length of `name`
+ */
+static void httpFiles(tHttpConn * conn, const tHttpRequest * req, const char * name, const size_t nameLen) {
+	bool valid = (nameLen > 0 && nameLen <= 128 && *name != '.');
+	for (size_t i = 0; valid && i < nameLen; ++i) {
+		const char c = name[i];
+		valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-';
+	}
+	if ( ! valid ) {
+		httpRespondError(conn, 404, L"File not found.");
+		return;
+	}
+	const wchar_t * dir = httpSpoolDir(conn->server);
+	wchar_t path[MAX_PATH + 130];
+	if (dir == NULL || wcslen(dir) >= MAX_PATH) {
+		httpRespondError(conn, 500, errStr[ERR_CREATE_FILE]);
+		return;
+	}
+	wcscpy_s(path, ARRAY_SIZE(path), dir);
+	wchar_t * ptr = path + wcslen(path);
+	for (size_t i = 0; i < nameLen; ++i) {
+		*ptr++ = (wchar_t)name[i];
+	}
+	*ptr = 0;
+	const uint64_t offset = httpQueryNum(req, "offset", 0);
+	LARGE_INTEGER pos;
+	pos.QuadPart = (LONGLONG)((offset < (uint64_t)INT64_MAX) ? offset : (uint64_t)INT64_MAX);
+	if (req->methodLen == 3 && memcmp(req->method, "PUT", 3) == 0) {
+		if (req->type == NULL || req->typeLen < 24 || _strnicmp(req->type, "application/octet-stream", 24) != 0) {
+			httpRespondError(conn, 415, L"Expected application/octet-stream request body.");
+			return;
+		}
+		if (offset > AGENT_MAX_UPLOAD || (uint64_t)(req->bodyLen) > (AGENT_MAX_UPLOAD - offset)) {
+			/* drop the partial upload */
+			DeleteFileW(path);
+			httpRespondError(conn, 413, L"File too large.");
+			return;
+		}
+		if (offset == 0) {
+			httpSpoolExpire(dir);
+		}
+		/* chunks are appended in order; offset 0 starts a new upload */
+		HANDLE hFile = CreateFileW(path, GENERIC_WRITE, 0, NULL, (offset == 0) ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			httpRespondError(conn, (offset == 0) ? 500 : 409, (offset == 0) ? errStr[ERR_CREATE_FILE] : L"Unknown upload.");
+			return;
+		}
+		LARGE_INTEGER size;
+		DWORD written = 0;
+		const bool inOrder = GetFileSizeEx(hFile, &size) && size.QuadPart == pos.QuadPart;
+		const bool ok = inOrder && SetFilePointerEx(hFile, pos, NULL, FILE_BEGIN) && (req->bodyLen == 0 || (WriteFile(hFile, req->body, (DWORD)(req->bodyLen), &written, NULL) && (size_t)written == req->bodyLen));
+		CloseHandle(hFile);
+		if ( ! ok ) {
+			httpRespondError(conn, inOrder ? 500 : 409, inOrder ? errStr[ERR_CREATE_FILE] : L"Unexpected upload offset.");
+			return;
+		}
+		tUStrBuf * sb = usb_create(512);
+		if (sb != NULL) {
+			usb_add(sb, L"{\"path\": ");
+			reportAddJsonStr(sb, path);
+			usb_addFmt(sb, L", \"size\": %" PRIu64 L"}\n", offset + (uint64_t)(req->bodyLen));
+		}
+		httpRespondStr(conn, 200, "application/json; charset=utf-8", sb);
+	} else if (req->methodLen == 3 && memcmp(req->method, "GET", 3) == 0) {
+		HANDLE hFile = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			httpRespondError(conn, 404, L"File not found.");
+			return;
+		}
+		char * buf = malloc(AGENT_CHUNK_SIZE);
+		DWORD got = 0;
+		const bool ok = buf != NULL && SetFilePointerEx(hFile, pos, NULL, FILE_BEGIN) && ReadFile(hFile, buf, AGENT_CHUNK_SIZE, &got, NULL);
+		CloseHandle(hFile);
+		if ( ok ) {
+			httpRespond(conn, 200, "application/octet-stream", buf, (size_t)got);
+		} else {
+			httpRespondError(conn, 500, errStr[ERR_READ_FILE]);
+		}
+		if (buf != NULL) {
+			free(buf);
+		}
+	} else if (req->methodLen == 6 && memcmp(req->method, "DELETE", 6) == 0) {
+		if ( DeleteFileW(path) ) {
+			httpRespond(conn, 200, "application/json; charset=utf-8", "{}\n", 3);
+		} else {
+			httpRespondError(conn, 404, L"File not found.");
+		}
+	} else {
+		httpRespondError(conn, 405, L"Method not allowed.");
+	}
+}
+
+
+/**
+ * Handles the given request. The request may be kept pending in case of a
+ * long-poll status request.
+ *
+ * @param[in,out] conn - connection
+ * @param[in] req - request
+ */
+static void httpHandle(tHttpConn * conn, const tHttpRequest * req) {
+	const tIpcWndCtx * ctx = httpCtx(conn);
+	const bool isGet = (req->methodLen == 3 && memcmp(req->method, "GET", 3) == 0);
+	const bool isPost = (req->methodLen == 4 && memcmp(req->method, "POST", 4) == 0);
+	if (req->pathLen == 6 && memcmp(req->path, "/items", 6) == 0) {
+		if ( isPost ) {
+			httpSubmit(conn, req);
+		} else if ( isGet ) {
+			/* status of all items from `from` on, optionally waiting for changes after `since` */
+			const uint64_t from = httpQueryNum(req, "from", 0);
+			const uint64_t since = httpQueryNum(req, "since", UINT64_MAX);
+			const uint64_t wait = httpQueryNum(req, "wait", 0);
+			conn->waitFrom = (from < (uint64_t)SIZE_MAX) ? (size_t)from : SIZE_MAX;
+			if (wait > 0 && since != UINT64_MAX && since >= conn->server->seq) {
+				conn->state = HCS_WAIT;
+				conn->waitSeq = since;
+				conn->deadline = GetTickCount64() + ((wait < HTTP_MAX_WAIT) ? wait : HTTP_MAX_WAIT);
+			} else {
+				httpRespondItems(conn, conn->waitFrom);
+			}
+		} else {
+			httpRespondError(conn, 405, L"Method not allowed.");
+		}
+		return;
+	}
+	if (req->pathLen > 7 && memcmp(req->path, "/items/", 7) == 0) {
+		/* single item status or output */
+		const char * ptr = req->path + 7;
+		const char * end = req->path + req->pathLen;
+		size_t i = 0;
+		bool valid = (ptr < end && *ptr >= '0' && *ptr <= '9');
+		for (; valid && ptr < end && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+			valid = (i <= ((SIZE_MAX - 9) / 10));
+			i = (i * 10) + (size_t)(*ptr - '0');
+		}
+		const bool output = (end - ptr) == 7 && memcmp(ptr, "/output", 7) == 0;
+		if (( ! valid ) || (ptr != end && ( ! output )) || i >= vec_size(ctx->v)) {
+			httpRespondError(conn, 404, L"Item not found.");
+		} else if ( ! isGet ) {
+			httpRespondError(conn, 405, L"Method not allowed.");
+		} else if ( output ) {
+			wchar_t * str = outputGet(vec_at(ctx->v, i));
+			char * utf8 = wToUtf8((str != NULL) ? str : L"");
+			if (str != NULL) {
+				free(str);
+			}
+			if (utf8 == NULL) {
+				httpRespondError(conn, 500, errStr[ERR_OUT_OF_MEMORY]);
+			} else {
+				httpRespond(conn, 200, "text/plain; charset=utf-8", utf8, strlen(utf8));
+				free(utf8);
+			}
+		} else {
+			tUStrBuf * sb = usb_create(1024);
+			if (sb != NULL) {
+				httpAddItem(sb, ctx, i);
+				usb_addC(sb, L'\n');
+			}
+			httpRespondStr(conn, 200, "application/json; charset=utf-8", sb);
+		}
+		return;
+	}
+	if (ctx->http.key != NULL && req->pathLen > 7 && memcmp(req->path, "/files/", 7) == 0) {
+		/* file transfer of the coordinator */
+		httpFiles(conn, req, req->path + 7, req->pathLen - 7);
+		return;
+	}
+	httpRespondError(conn, 404, L"Not found.");
+}
+
+
+/**
+ * Handles the next request in the receive buffer of the given connection or
+ * continues receiving if it is incomplete.
+ *
+ * @param[in,out] conn - connection
+ */
+static void httpProcess(tHttpConn * conn) {
+	tHttpRequest req;
+	unsigned status;
+	const bool signedOnly = (conn->server->key != NULL);
+	conn->reqMac[0] = 0;
+	const size_t reqLen = httpParse(conn->in, conn->inLen, signedOnly, &req, &status);
+	if (reqLen == 0) {
+		if (status == 0 && conn->inLen < HTTP_MAX_REQUEST) {
+			if ( ! httpRecv(conn) ) {
+				httpClose(conn);
+			}
+			return;
+		}
+		/* invalid or too large request -> respond and close */
+		conn->keepAlive = false;
+		conn->inLen = 0;
+		conn->reqLen = 0;
+		httpRespondError(conn, (status != 0) ? status : 413, L"Invalid or too large request.");
+		return;
+	}
+	/* the request is removed from the receive buffer once answered as `req` points into it */
+	TRACE_BEGIN("http", "request");
+	conn->keepAlive = req.keepAlive;
+	conn->reqLen = reqLen;
+	if (signedOnly && ( ! httpAuthCheck(conn, &req) )) {
+		httpRespondError(conn, 401, L"Missing or invalid request signature.");
+	} else {
+		httpHandle(conn, &req);
+	}
+	TRACE_END("http", "request");
+}
+
+
+/**
+ * Handles the receive complete event of a connection.
+ *
+ * @param[in] dwError - I/O completion status
+ * @param[in] cbTransferred - number of bytes transferred or zero if closed
+ * @param[in] lpOverlapped - pointer to the `WSAOVERLAPPED` structure of the connection
+ * @param[in] dwFlags - completion flags (unused)
+ */
+static void CALLBACK httpRecvComplete(DWORD dwError, DWORD cbTransferred, LPWSAOVERLAPPED lpOverlapped, DWORD dwFlags) {
+	PCF_UNUSED(dwFlags);
+	tHttpConn * conn = CONTAINER_OF(lpOverlapped, tHttpConn, ov);
+	conn->busy = false;
+	if (conn->state == HCS_CLOSED) {
+		--(conn->server->closing);
+		httpConnDelete(conn);
+		return;
+	}
+	if (dwError != 0 || cbTransferred == 0) {
+		/* client connection lost */
+		httpClose(conn);
+		return;
+	}
+	conn->inLen += (size_t)cbTransferred;
+	httpProcess(conn);
+}
+
+
+/**
+ * Starts an asynchronous receive operation on the given connection.
+ *
+ * @param[in,out] conn - connection
+ * @return `true` on success, else `false`
+ */
+static bool httpRecv(tHttpConn * conn) {
+	WSABUF buf = {(ULONG)(HTTP_MAX_REQUEST - conn->inLen), conn->in + conn->inLen};
+	DWORD flags = 0;
+	ZeroMemory(&(conn->ov), sizeof(conn->ov));
+	conn->state = HCS_READ;
+	conn->deadline = GetTickCount64() + HTTP_IDLE_TIMEOUT;
+	conn->busy = true;
+	if (WSARecv(conn->sock, &buf, 1, NULL, &flags, &(conn->ov), httpRecvComplete) != 0 && WSAGetLastError() != WSA_IO_PENDING) {
+		conn->busy = false;
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * Returns the user of the given process token.
+ *
+ * @param[in] hProc - process handle with `PROCESS_QUERY_LIMITED_INFORMATION` access
+ * @return allocated token user or `NULL` on error; free with `free()`
+ */
+static TOKEN_USER * httpTokenUser(HANDLE hProc) {
+	HANDLE hToken = NULL;
+	TOKEN_USER * user = NULL;
+	DWORD size = 0;
+	if ( ! OpenProcessToken(hProc, TOKEN_QUERY, &hToken) ) {
+		return NULL;
+	}
+	if (GetTokenInformation(hToken, TokenUser, NULL, 0, &size) || GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+		goto onError;
+	}
+	user = (TOKEN_USER *)malloc(size);
+	if (user != NULL && ( ! GetTokenInformation(hToken, TokenUser, user, size, &size) )) {
+		free(user);
+		user = NULL;
+	}
+onError:
+	CloseHandle(hToken);
+	return user;
+}
+
+
+/**
+ * Checks whether the process on the other end of the given loopback
+ * connection runs as the same user as this process. The owning process is
+ * looked up in the TCP connection table.
+ *
+ * @param[in] server - HTTP server context
+ * @param[in] peer - client address
+ * @return `true` if owned by the same user, else `false`
+ */
+static bool httpIsSameUser(const tHttpServer * server, const struct sockaddr_in * peer) {
+	MIB_TCPTABLE_OWNER_PID * table = NULL;
+	DWORD size = 0;
+	DWORD pid = 0;
+	bool found = false;
+	bool res = false;
+	if (server->user == NULL || peer->sin_family != AF_INET) {
+		return false;
+	}
+	for (int retry = 0; retry < 4; ++retry) {
+		const DWORD err = GetExtendedTcpTable(table, &size, FALSE, AF_INET, TCP_TABLE_OWNER_PID_CONNECTIONS, 0);
+		if (err == NO_ERROR) {
+			break;
+		}
+		free(table);
+		table = NULL;
+		if (err != ERROR_INSUFFICIENT_BUFFER) {
+			return false;
+		}
+		table = (MIB_TCPTABLE_OWNER_PID *)malloc(size);
+		if (table == NULL) {
+			return false;
+		}
+	}
+	if (table == NULL) {
+		return false;
+	}
+	for (DWORD i = 0; i < table->dwNumEntries; ++i) {
+		const MIB_TCPROW_OWNER_PID * row = table->table + i;
+		/* ports are given in network byte order within the lower 16 bits */
+		if (row->dwLocalAddr == peer->sin_addr.s_addr && (u_short)(row->dwLocalPort) == peer->sin_port && (u_short)(row->dwRemotePort) == htons(server->port)) {
+			pid = row->dwOwningPid;
+			found = true;
+			break;
+		}
+	}
+	free(table);
+	if ( ! found ) {
+		return false;
+	}
+	if (pid == GetCurrentProcessId()) {
+		return true;
+	}
+	const HANDLE hProc = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+	if (hProc == NULL) {
+		return false;
+	}
+	TOKEN_USER * user = httpTokenUser(hProc);
+	res = (user != NULL && EqualSid(user->User.Sid, server->user->User.Sid));
+	free(user);
+	CloseHandle(hProc);
+	return res;
+}
+
+
+/**
+ * Starts listening for HTTP requests on the given port. Only loopback requests
+ * from processes of the same user are served without a shared agent key. With
+ * a key all interfaces are served but only requests signed with the key are
+ * accepted (agent mode).
+ *
+ * @param[in,out] server - HTTP server context
+ * @param[in] port - TCP port
+ * @param[in] configUrl - INI file with the selectable configuration sections
+ * @param[in] key - shared agent key or `NULL`
+ * @param[in] keyLen - length of `key` in bytes
+ * @return `true` on success, else `false` with the error code in `GetLastError()`
+ */
+bool httpCreate(tHttpServer * server, const unsigned short port, const wchar_t * configUrl, const uint8_t * key, const size_t keyLen) {
+	if (server == NULL || configUrl == NULL || (key != NULL && keyLen == 0)) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return false;
+	}
+	WSADATA wsa;
+	int err = WSAStartup(MAKEWORD(2, 2), &wsa);
+	if (err != 0) {
+		SetLastError((DWORD)err);
+		return false;
+	}
+	server->started = true;
+	server->configUrl = wcsdup(configUrl);
+	server->conns = vec_create(sizeof(tHttpConn *));
+	if (server->configUrl == NULL || server->conns == NULL) {
+		SetLastError(ERROR_OUTOFMEMORY);
+		return false;
+	}
+	if (key != NULL) {
+		server->key = malloc(keyLen);
+		server->keyLen = keyLen;
+		server->nonces = calloc(AGENT_AUTH_NONCES, AGENT_NONCE_LEN);
+		if (server->key == NULL || server->nonces == NULL) {
+			httpDelete(server);
+			SetLastError(ERROR_OUTOFMEMORY);
+			return false;
+		}
+		memcpy(server->key, key, keyLen);
+	}
+	server->port = port;
+	/* unique per process on this host; changes if the agent restarts */
+	swprintf(server->session, ARRAY_SIZE(server->session), L"%016" PRIx64 L"%08" PRIx32, httpAuthTime(), (uint32_t)GetCurrentProcessId());
+	if (key == NULL) {
+		server->user = httpTokenUser(GetCurrentProcess());
+		if (server->user == NULL) {
+			err = (int)GetLastError();
+			httpDelete(server);
+			SetLastError((DWORD)err);
+			return false;
+		}
+	}
+	server->sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (server->sock == INVALID_SOCKET) {
+		goto onError;
+	}
+	/* no other process may bind the same port */
+	BOOL exclusive = TRUE;
+	setsockopt(server->sock, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, (const char *)&exclusive, sizeof(exclusive));
+	struct sockaddr_in addr;
+	ZeroMemory(&addr, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl((key != NULL) ? INADDR_ANY : INADDR_LOOPBACK);
+	if (bind(server->sock, (const struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(server->sock, SOMAXCONN) != 0) {
+		goto onError;
+	}
+	server->hAccept = WSACreateEvent();
+	if (server->hAccept == WSA_INVALID_EVENT) {
+		server->hAccept = NULL;
+		goto onError;
+	}
+	if (WSAEventSelect(server->sock, server->hAccept, FD_ACCEPT) != 0) {
+		goto onError;
+	}
+	return true;
+onError:
+	err = WSAGetLastError();
+	httpDelete(server);
+	SetLastError((DWORD)err);
+	return false;
+}
+
+
+/**
+ * Accepts all pending HTTP connections. Called once `http.hAccept` was
+ * signaled.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void httpAccept(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->http.sock == INVALID_SOCKET) {
+		return;
+	}
+	tHttpServer * server = &(ctx->http);
+	WSANETWORKEVENTS events;
+	WSAEnumNetworkEvents(server->sock, server->hAccept, &events);
+	for (;;) {
+		struct sockaddr_in peer;
+		int peerLen = (int)sizeof(peer);
+		SOCKET sock = accept(server->sock, (struct sockaddr *)&peer, &peerLen);
+		if (sock == INVALID_SOCKET) {
+			break; /* `WSAEWOULDBLOCK` */
+		}
+		if (server->key == NULL && ( ! httpIsSameUser(server, &peer) )) {
+			/* other users may not sign with the PINs cached by this process */
+			TRACE_INSTANT("http", "reject", 1);
+			closesocket(sock);
+			continue;
+		}
+		/* accepted sockets inherit the event selection -> revert to blocking overlapped I/O */
+		u_long nonBlocking = 0;
+		WSAEventSelect(sock, NULL, 0);
+		ioctlsocket(sock, FIONBIO, &nonBlocking);
+		BOOL noDelay = TRUE;
+		setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&noDelay, sizeof(noDelay));
+		if (vec_size(server->conns) >= HTTP_MAX_CLIENTS) {
+			closesocket(sock);
+			continue;
+		}
+		tHttpConn * conn = calloc(1, sizeof(tHttpConn));
+		tHttpConn ** item = NULL;
+		if (conn != NULL) {
+			conn->server = server;
+			conn->sock = sock;
+			conn->in = malloc(HTTP_MAX_REQUEST);
+			item = (conn->in != NULL) ? vec_pushBack(server->conns) : NULL;
+		}
+		if (item == NULL) {
+			closesocket(sock);
+			if (conn != NULL) {
+				httpConnDelete(conn);
+			}
+			continue;
+		}
+		*item = conn;
+		TRACE_INSTANT("http", "accept", vec_size(server->conns));
+		if ( ! httpRecv(conn) ) {
+			httpClose(conn);
+		}
+	}
+}
+
+
+/**
+ * Signals a change of the item list or an item state. Pending long-poll status
+ * requests are answered.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void httpNotify(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->http.conns == NULL) {
+		return;
+	}
+	tHttpServer * server = &(ctx->http);
+	++(server->seq);
+	for (size_t i = 0; i < vec_size(server->conns); ++i) {
+		tHttpConn * conn = *((tHttpConn **)vec_at(server->conns, i));
+		if (conn->state == HCS_WAIT && conn->waitSeq < server->seq) {
+			/* may remove the connection on error */
+			const size_t count = vec_size(server->conns);
+			httpRespondItems(conn, conn->waitFrom);
+			if (vec_size(server->conns) < count) {
+				--i;
+			}
+		}
+	}
+}
+
+
+/**
+ * Returns the time until the next long-poll or idle connection expires.
+ *
+ * @param[in] server - HTTP server context
+ * @return timeout in milliseconds or `INFINITE`
+ */
+DWORD httpTimeout(const tHttpServer * server) {
+	if (server == NULL || server->conns == NULL) {
+		return INFINITE;
+	}
+	const ULONGLONG now = GetTickCount64();
+	ULONGLONG next = ULLONG_MAX;
+	const size_t count = vec_size(server->conns);
+	for (size_t i = 0; i < count; ++i) {
+		const tHttpConn * conn = *((tHttpConn **)vec_at(server->conns, i));
+		if ((conn->state == HCS_WAIT || conn->state == HCS_READ) && conn->deadline < next) {
+			next = conn->deadline;
+		}
+	}
+	if (next == ULLONG_MAX) {
+		return INFINITE;
+	}
+	return (next > now) ? (DWORD)(next - now) : 0;
+}
+
+
+/**
+ * Answers expired long-poll status requests and closes idle connections.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void httpExpire(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->http.conns == NULL) {
+		return;
+	}
+	tHttpServer * server = &(ctx->http);
+	const ULONGLONG now = GetTickCount64();
+	for (size_t i = 0; i < vec_size(server->conns); ++i) {
+		tHttpConn * conn = *((tHttpConn **)vec_at(server->conns, i));
+		if (conn->deadline > now || (conn->state != HCS_WAIT && conn->state != HCS_READ)) {
+			continue;
+		}
+		const size_t count = vec_size(server->conns);
+		if (conn->state == HCS_WAIT) {
+			/* no changes within the requested time */
+			httpRespondItems(conn, conn->waitFrom);
+		} else {
+			httpClose(conn);
+		}
+		if (vec_size(server->conns) < count) {
+			--i;
+		}
+	}
+}
+
+
+/**
+ * Closes all connections and the listening socket.
+ *
+ * @param[in,out] server - HTTP server context
+ */
+void httpDelete(tHttpServer * server) {
+	if (server == NULL) {
+		return;
+	}
+	if (server->conns != NULL) {
+		while (vec_size(server->conns) > 0) {
+			httpClose(*((tHttpConn **)vec_back(server->conns)));
+		}
+		vec_delete(server->conns);
+		server->conns = NULL;
+		/* let the aborted operations complete to free their connections */
+		for (size_t i = 0; server->closing > 0 && i < 100; ++i) {
+			SleepEx(10, TRUE);
+		}
+	}
+	if (server->sock != INVALID_SOCKET) {
+		closesocket(server->sock);
+		server->sock = INVALID_SOCKET;
+	}
+	if (server->hAccept != NULL) {
+		WSACloseEvent(server->hAccept);
+		server->hAccept = NULL;
+	}
+	wStrDelete(&(server->configUrl));
+	wStrDelete(&(server->spoolDir));
+	if (server->key != NULL) {
+		SecureZeroMemory(server->key, server->keyLen);
+		free(server->key);
+		server->key = NULL;
+		server->keyLen = 0;
+	}
+	if (server->nonces != NULL) {
+		free(server->nonces);
+		server->nonces = NULL;
+	}
+	if (server->user != NULL) {
+		free(server->user);
+		server->user = NULL;
+	}
+	if ( server->started ) {
+		WSACleanup();
+		server->started = false;
+	}
+}
+
+
+/**
+ * Loads the shared agent key from the given file. Leading and trailing
+ * white-space is ignored.
+ *
+ * @param[in] path - key file path
+ * @param[out] key - receives the allocated key; free with `free()`
+ * @param[out] len - receives the key length in bytes
+ * @return `true` on success, else `false` if the file could not be read or holds less than `AGENT_KEY_MIN` bytes
+ */
+bool httpKeyLoad(const wchar_t * path, uint8_t ** key, size_t * len) {
+	if (path == NULL || key == NULL || len == NULL) {
+		return false;
+	}
+	*key = NULL;
+	*len = 0;
+	HANDLE hFile = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	uint8_t * buf = malloc(AGENT_KEY_MAX);
+	DWORD got = 0;
+	const bool ok = buf != NULL && ReadFile(hFile, buf, AGENT_KEY_MAX, &got, NULL);
+	CloseHandle(hFile);
+	if ( ! ok ) {
+		if (buf != NULL) {
+			free(buf);
+		}
+		return false;
+	}
+	size_t start = 0;
+	size_t end = (size_t)got;
+	for (; start < end && (buf[start] == ' ' || buf[start] == '\t' || buf[start] == '\r' || buf[start] == '\n'); ++start);
+	for (; end > start && (buf[end - 1] == ' ' || buf[end - 1] == '\t' || buf[end - 1] == '\r' || buf[end - 1] == '\n'); --end);
+	if ((end - start) < AGENT_KEY_MIN) {
+		SecureZeroMemory(buf, AGENT_KEY_MAX);
+		free(buf);
+		return false;
+	}
+	memmove(buf, buf + start, end - start);
+	*key = buf;
+	*len = end - start;
+	return true;
+}
+
+
+/**
+ * Returns the current time for signed agent requests.
+ *
+ * @return milliseconds since 1970-01-01 UTC
+ */
+uint64_t httpAuthTime(void) {
+	FILETIME ft;
+	GetSystemTimeAsFileTime(&ft);
+	const uint64_t t = ((uint64_t)(ft.dwHighDateTime) << 32) | (uint64_t)(ft.dwLowDateTime);
+	return (t - UINT64_C(116444736000000000)) / 10000;
+}
+
+
+/**
+ * Computes the HMAC-SHA256 of the given parts joined by line feeds.
+ *
+ * @param[in] key - shared agent key
+ * @param[in] keyLen - length of `key` in bytes
+ * @param[in] parts - message parts
+ * @param[in] lens - length of each message part in bytes
+ * @param[in] count - number of message parts
+ * @param[out] hex - receives the MAC as null-terminated lower case hex string (`2 * SHA256_SIZE + 1` bytes)
+ */
+void httpAuthMac(const uint8_t * key, const size_t keyLen, const char * const * parts, const size_t * lens, const size_t count, char * hex) {
+	static const char digits[] = "0123456789abcdef";
+	tHmacSha256 mac;
+	uint8_t digest[SHA256_SIZE];
+	hmacSha256Init(&mac, key, keyLen);
+	for (size_t i = 0; i < count; ++i) {
+		if (i > 0) {
+			hmacSha256Update(&mac, "\n", 1);
+		}
+		hmacSha256Update(&mac, parts[i], lens[i]);
+	}
+	hmacSha256Final(&mac, digest);
+	for (size_t i = 0; i < SHA256_SIZE; ++i) {
+		hex[2 * i] = digits[digest[i] >> 4];
+		hex[(2 * i) + 1] = digits[digest[i] & 0x0F];
+	}
+	hex[2 * SHA256_SIZE] = 0;
+}
+
+
+/**
+ * Compares the given MACs in constant time.
+ *
+ * @param[in] lhs - left-hand side MAC
+ * @param[in] rhs - right-hand side MAC
+ * @param[in] len - length of both MACs
+ * @return `true` if equal, else `false`
+ */
+bool httpAuthEqual(const char * lhs, const char * rhs, const size_t len) {
+	unsigned diff = 0;
+	for (size_t i = 0; i < len; ++i) {
+		diff |= (unsigned)((unsigned char)lhs[i] ^ (unsigned char)rhs[i]);
+	}
+	return diff == 0;
+}
@@ -2,7 +2,7 @@
  * @file siguwi-ini.c
  * @author Daniel Starke
  * @date 2025-07-04
- * @version 2025-09-17
+ * @version 2026-10-18
  */
 #include "siguwi.h"
 
@@ -26,6 +26,81 @@ typedef struct _KERB_SMARTCARD_CSP_INFO {
 #endif /* _MSC_VER */
 
 
+/**
+ * Releases the fields of the given INI configuration.
+ *
+ * @param[in,out] c - INI configuration
+ */
+static void iniConfigClear(tIniConfig * c) {
+	wStrDelete(&(c->cert->certProv));
+	wStrDelete(&(c->cert->certId));
+	wStrDelete(&(c->cert->cardName));
+	wStrDelete(&(c->cert->cardReader));
+	rws_release(&(c->signApp));
+	wStrDelete(&(c->match));
+	wStrDelete(&(c->chain));
+}
+
+
+/**
+ * INI configuration parsing context.
+ */
+typedef struct {
+	const wchar_t * section;
+	tIniConfig * c;
+} tIniConfigParseCtx;
+
+
+/**
+ * Assigns a single parsed key/value pair to the configuration. This is
+ * compatible with `IniVisitor`.
+ *
+ * @param[in] group - group name
+ * @param[in] key - key name
+ * @param[in] value - null-terminated value
+ * @param[in,out] param - parsing context (`tIniConfigParseCtx`)
+ * @return `true` to continue, `false` to abort
+ * @remarks Sets `lastErr` on error.
+ */
+static bool iniConfigAssign(const tToken * group, const tToken * key, wchar_t * value, void * param) {
+	tIniConfigParseCtx * ctx = param;
+	tIniConfig * c = ctx->c;
+	if (cmpToken(group, ctx->section) != 0) {
+		return true;
+	}
+	wchar_t ** k = NULL;
+	if (cmpToken(key, L"certId") == 0) {
+		k = &(c->cert->certId);
+	} else if (cmpToken(key, L"cardName") == 0) {
+		k = &(c->cert->cardName);
+	} else if (cmpToken(key, L"cardReader") == 0) {
+		k = &(c->cert->cardReader);
+	} else if (cmpToken(key, L"signApp") == 0) {
+		rws_release(&(c->signApp));
+		c->signApp = rws_create(value);
+		if (c->signApp == NULL) {
+			lastErr = ERR_OUT_OF_MEMORY;
+			return false;
+		}
+	} else if (cmpToken(key, L"match") == 0) {
+		if ( ! matchRuleAdd(&(c->match), value) ) {
+			return false;
+		}
+	} else if (cmpToken(key, L"chain") == 0) {
+		k = &(c->chain);
+	} /* else: ignore other keys */
+	if (k != NULL) {
+		wStrDelete(k);
+		*k = wcsdup(value);
+		if (*k == NULL) {
+			lastErr = ERR_OUT_OF_MEMORY;
+			return false;
+		}
+	}
+	return true;
+}
+
+
 /**
  * Parses the passed INI file with the given section and fills the configuration
  * structure.
@@ -38,18 +113,6 @@ typedef struct _KERB_SMARTCARD_CSP_INFO {
  * @remarks Sets `lastErr` and `p` on error accordingly.
  */
 bool iniConfigParse(const wchar_t * file, const wchar_t * section, tIniConfig * c, tFilePos * p) {
-	enum {
-		ST_IDLE,
-		ST_COMMENT,
-		ST_GROUP_START,
-		ST_GROUP,
-		ST_GROUP_END,
-		ST_KEY,
-		ST_ASSIGN,
-		ST_VALUE_START,
-		ST_VALUE,
-		ST_VALUE_END
-	} state;
 	if (file == NULL || section == NULL || c == NULL) {
 		lastErr = ERR_INVALID_ARG;
 		return false;
@@ -57,7 +120,6 @@ bool iniConfigParse(const wchar_t * file, const wchar_t * section, tIniConfig *
 	FILE * fp = NULL;
 	wchar_t * content = NULL;
 	bool res = false;
-	tFilePos pos = {1, 1};
 	/* open the INI file */
 	fp = _wfopen(file, L"rt, ccs=UTF-8");
 	if (fp == NULL) {
@@ -104,207 +166,19 @@ bool iniConfigParse(const wchar_t * file, const wchar_t * section, tIniConfig *
 		content[len++] = (wchar_t)((wc != WEOF) ? wc : L'\r');
 	} while (wc != WEOF);
 	/* parse the content */
-	const wchar_t * const ptrEnd = content + len;
-	tToken group = {L"", 0};
-	tToken key = {NULL, 0};
-	tToken value = {NULL, 0};
-	wchar_t quote = 0;
-	state = ST_IDLE;
 #ifdef DEBUG_INI
 	AllocConsole();
 	freopen("CONOUT$", "w", stdout);
 #endif /* DEBUG_INI */
-	/* skip BOM */
-	wchar_t * ptr = content;
-	if (len >= 1 && *ptr == 0xFEFF) {
-		++ptr;
-	}
-	for (; ptr != ptrEnd; ++ptr) {
-		const wint_t ch = *ptr;
-#ifdef DEBUG_INI
-		static const wchar_t * const st[] = {L"ST_IDLE", L"ST_COMMENT", L"ST_GROUP_START", L"ST_GROUP", L"ST_GROUP_END", L"ST_KEY", L"ST_ASSIGN", L"ST_VALUE_START", L"ST_VALUE", L"ST_VALUE_END"};
-		fwprintf(stdout, L"%s - %c (%u)\n", st[state], iswprint(ch) ? ch : L' ', ch);
-#endif /* DEBUG_INI */
-		switch (state) {
-		case ST_IDLE:
-			switch (ch) {
-			case L'#':
-			case L';':
-				state = ST_COMMENT;
-				break;
-			case L'[':
-				state = ST_GROUP_START;
-				break;
-			default:
-				if ( iswalpha(ch) ) {
-					state = ST_KEY;
-					key = (tToken){ptr, 1};
-				} else if ( ! iswspace(ch) ) {
-					lastErr = ERR_SYNTAX_ERROR;
-					goto onError;
-				}
-				break;
-			}
-			break;
-		case ST_COMMENT:
-			switch (ch) {
-			case L'\n':
-			case L'\r':
-				state = ST_IDLE;
-				break;
-			default:
-				break;
-			}
-			break;
-		case ST_GROUP_START:
-			if (ch == L']') {
-				state = ST_IDLE;
-				group = (tToken){L"", 0};
-			} else if ( iswalpha(ch) ) {
-				state = ST_GROUP;
-				group = (tToken){ptr, 1};
-			} else if ( ! iswblank(ch) ) {
-				lastErr = ERR_SYNTAX_ERROR;
-				goto onError;
-			}
-			break;
-		case ST_GROUP:
-			if (ch == L']') {
-				state = ST_IDLE;
-			} else if ( iswalnum(ch) ) {
-				++(group.len);
-			} else if ( iswblank(ch) ) {
-				state = ST_GROUP_END;
-			} else {
-				lastErr = ERR_SYNTAX_ERROR;
-				goto onError;
-			}
-			break;
-		case ST_GROUP_END:
-			if (ch == L']') {
-				state = ST_IDLE;
-			} else if ( ! iswblank(ch) ) {
-				lastErr = ERR_SYNTAX_ERROR;
-				goto onError;
-			}
-			break;
-		case ST_KEY:
-			if (ch == L'=') {
-				state = ST_VALUE_START;
-				quote = 0;
-			} else if ( iswalnum(ch) ) {
-				++(key.len);
-			} else if ( iswblank(ch) ) {
-				state = ST_ASSIGN;
-			} else {
-				lastErr = ERR_SYNTAX_ERROR;
-				goto onError;
-			}
-			break;
-		case ST_ASSIGN:
-			if (ch == L'=') {
-				state = ST_VALUE_START;
-				quote = 0;
-			} else if ( ! iswblank(ch) ) {
-				lastErr = ERR_SYNTAX_ERROR;
-				goto onError;
-			}
-			break;
-		case ST_VALUE_START:
-			switch (ch) {
-			case L'"':
-			case L'\'':
-				state = ST_VALUE;
-				quote = ch;
-				value = (tToken){ptr + 1, 0};
-				break;
-			default:
-				if ( ! iswblank(ch) ) {
-					state = ST_VALUE;
-					value = (tToken){ptr, 1};
-				}
-				break;
-			}
-			break;
-		case ST_VALUE:
-			if (quote != 0) {
-				if (ch == quote) {
-					state = ST_VALUE_END;
-					*ptr = 0; /* make value a null-terminated string */
-				} else {
-					++(value.len);
-				}
-			} else {
-				switch (ch) {
-				case L'\n':
-				case L'\r':
-					state = ST_VALUE_END;
-					break;
-				default:
-					++(value.len);
-					break;
-				}
-			}
-			break;
-		case ST_VALUE_END:
-			break;
-		}
-		if (state == ST_VALUE_END) {
-			/* completely parsed {key, value} pair */
-			state = ST_IDLE;
-			if (quote == 0) {
-				/* trim trailing blanks */
-				wchar_t * it = value.ptr + value.len;
-				while (it != value.ptr) {
-					--it;
-					if ( ! iswblank(*it) ) {
-						*(++it) = 0; /* make value a null-terminated string */
-						break;
-					}
-				}
-				if (it == value.ptr) {
-					*it = 0; /* make value a null-terminated string */
-				}
-			}
-			/* assign configuration string */
-			if (cmpToken(&group, section) == 0) {
-				wchar_t ** k = NULL;
-				if (cmpToken(&key, L"certId") == 0) {
-					k = &(c->cert->certId);
-				} else if (cmpToken(&key, L"cardName") == 0) {
-					k = &(c->cert->cardName);
-				} else if (cmpToken(&key, L"cardReader") == 0) {
-					k = &(c->cert->cardReader);
-				} else if (cmpToken(&key, L"signApp") == 0) {
-					rws_release(&(c->signApp));
-					c->signApp = rws_create(value.ptr);
-					if (c->signApp == NULL) {
-						lastErr = ERR_OUT_OF_MEMORY;
-						goto onError;
-					}
-				} /* else: ignore other keys */
-				if (k != NULL) {
-					wStrDelete(k);
-					*k = wcsdup(value.ptr);
-					if (*k == NULL) {
-						lastErr = ERR_OUT_OF_MEMORY;
-						goto onError;
-					}
-				}
-			}
-		}
-		/* error position handling */
-		switch (ch) {
-		case L'\n':
-			++(pos.row);
-			pos.col = 1;
-			break;
-		case L'\r':
-			break; /* ignore */
-		default:
-			++(pos.col);
-			break;
-		}
+	tIniConfigParseCtx ctx = {section, c};
+	switch (ini_parse(content, len, iniConfigAssign, &ctx, p)) {
+	case INI_OK:
+		break;
+	case INI_SYNTAX_ERROR:
+		lastErr = ERR_SYNTAX_ERROR;
+		goto onError;
+	case INI_ABORTED:
+		goto onError; /* `lastErr` was set by `iniConfigAssign()` */
 	}
 	lastErr = ERR_SUCCESS;
 	res = true;
@@ -313,9 +187,86 @@ onError:
 		fclose(fp);
 	}
 	wStrDelete(&content);
-	if (lastErr == ERR_SYNTAX_ERROR && p != NULL) {
-		*p = pos;
+	return res;
+}
+
+
+/**
+ * Appends the signing steps of the given INI sections to the passed
+ * configuration. Each section needs its own `certId`, `cardName`, `cardReader`
+ * and `signApp` key. Their `chain` keys are ignored.
+ *
+ * @param[in] file - INI file path
+ * @param[in,out] c - configuration of the first signing step without any following steps
+ * @param[in] chain - comma separated INI sections or `NULL`
+ * @return `true` on success, else `false`
+ * @remarks Sets `lastErr` on error.
+ */
+bool iniConfigChain(const wchar_t * file, tRcIniConfigBase * c, const wchar_t * chain) {
+	if (c == NULL || c->next != NULL || (chain != NULL && *chain != 0 && file == NULL)) {
+		lastErr = ERR_INVALID_ARG;
+		return false;
 	}
+	tIniConfig cfg;
+	ZeroMemory(&cfg, sizeof(cfg));
+	wchar_t * section = NULL;
+	tRcIniConfigBase * last = c;
+	size_t steps = 1;
+	bool res = false;
+	for (const wchar_t * ptr = chain; ptr != NULL && *ptr != 0; ) {
+		/* next section name */
+		const wchar_t * sep = wcschr(ptr, L',');
+		const wchar_t * end = (sep != NULL) ? sep : ptr + wcslen(ptr);
+		const wchar_t * nextPtr = (sep != NULL) ? sep + 1 : end;
+		for (; ptr < end && iswspace(*ptr); ++ptr);
+		for (; end > ptr && iswspace(end[-1]); --end);
+		if (ptr == end || (++steps) > MAX_CHAIN_STEPS) {
+			lastErr = ERR_CHAIN;
+			goto onError;
+		}
+		section = malloc((size_t)(end - ptr + 1) * sizeof(wchar_t));
+		if (section == NULL) {
+			lastErr = ERR_OUT_OF_MEMORY;
+			goto onError;
+		}
+		wmemcpy(section, ptr, (size_t)(end - ptr));
+		section[end - ptr] = 0;
+		ptr = nextPtr;
+		/* its signing step */
+		if ( ! iniConfigParse(file, section, &cfg, NULL) ) {
+			goto onError;
+		}
+		if (cfg.cert->certId == NULL || cfg.cert->cardName == NULL || cfg.cert->cardReader == NULL || cfg.signApp == NULL) {
+			lastErr = ERR_CHAIN;
+			goto onError;
+		}
+		cfg.cert->certProv = getCspFromCardNameW(cfg.cert->cardName);
+		if (cfg.cert->certProv == NULL) {
+			lastErr = ERR_GET_CSP;
+			goto onError;
+		}
+		tRcIniConfigBase * step = rcIniConfigBaseCreate(cfg.cert, cfg.match);
+		if (step == NULL) {
+			lastErr = ERR_OUT_OF_MEMORY;
+			goto onError;
+		}
+		step->name = section;
+		section = NULL;
+		last->nextSignApp = rws_aquire(cfg.signApp);
+		last->next = step;
+		last = step;
+		iniConfigClear(&cfg);
+	}
+	lastErr = ERR_SUCCESS;
+	res = true;
+onError:
+	if ( ! res ) {
+		rcIniConfigBaseDelete(c->next);
+		c->next = NULL;
+		rws_release(&(c->nextSignApp));
+	}
+	iniConfigClear(&cfg);
+	wStrDelete(&section);
 	return res;
 }
 
@@ -409,6 +360,16 @@ bool iniConfigGetPin(const tIniConfigBase * c, HWND parent, DATA_BLOB * pin) {
 		return res;
 	}
 	ZeroMemory(pin, sizeof(*pin));
+#ifdef SIGUWI_HARNESS
+	/* non-interactive PIN for the end-to-end throughput harness */
+	wchar_t * harnessPin = _wgetenv(L"SIGUWI_HARNESS_PIN");
+	if (harnessPin != NULL) {
+		DATA_BLOB harnessBlob;
+		harnessBlob.pbData = (BYTE *)harnessPin;
+		harnessBlob.cbData = (DWORD)((wcslen(harnessPin) + 1) * sizeof(wchar_t)); /* including null-termination character */
+		return CryptProtectData(&harnessBlob, NULL, NULL, NULL, NULL, 0, pin) != FALSE;
+	}
+#endif /* SIGUWI_HARNESS */
 	DWORD cardStatus = 0;
 	if ( ! iniConfigGetCardStatus(c, &cardStatus) ) {
 		return res;
@@ -543,9 +504,10 @@ onError:
  * Create the given INI base configuration.
  *
  * @param[in] c - input configuration
+ * @param[in] match - line feed separated output rules or `NULL`
  * @return created configuration or `NULL` on error
  */
-tRcIniConfigBase * rcIniConfigBaseCreate(const tIniConfigBase * c) {
+tRcIniConfigBase * rcIniConfigBaseCreate(const tIniConfigBase * c, const wchar_t * match) {
 	if (c == NULL) {
 		return NULL;
 	}
@@ -558,7 +520,11 @@ tRcIniConfigBase * rcIniConfigBaseCreate(const tIniConfigBase * c) {
 	res->cert->certId = wcsdup(c->certId);
 	res->cert->cardName = wcsdup(c->cardName);
 	res->cert->cardReader = wcsdup(c->cardReader);
-	if (res->cert->certProv == NULL || res->cert->certId == NULL || res->cert->cardName == NULL || res->cert->cardReader == NULL) {
+	if (match != NULL && *match != 0) {
+		res->rules = matchRulesCreate(match);
+	}
+	if (res->cert->certProv == NULL || res->cert->certId == NULL || res->cert->cardName == NULL || res->cert->cardReader == NULL || (match != NULL && *match != 0 && res->rules == NULL)) {
+		matchRulesDelete(res->rules);
 		wStrDelete(&(res->cert->certProv));
 		wStrDelete(&(res->cert->certId));
 		wStrDelete(&(res->cert->cardName));
@@ -650,6 +616,10 @@ void rcIniConfigBaseDelete(tRcIniConfigBase * c) {
 		wStrDelete(&(c->cert->certId));
 		wStrDelete(&(c->cert->cardName));
 		wStrDelete(&(c->cert->cardReader));
+		matchRulesDelete(c->rules);
+		wStrDelete(&(c->name));
+		rws_release(&(c->nextSignApp));
+		rcIniConfigBaseDelete(c->next);
 		free(c);
 	}
 }
@@ -0,0 +1,536 @@
+/**
+ * @file siguwi-log.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Returns the current UTC time.
+ *
+ * @return time in `FILETIME` units
+ */
+static int64_t sessionLogTime(void) {
+	FILETIME ft;
+	GetSystemTimeAsFileTime(&ft);
+	return (int64_t)((((uint64_t)(ft.dwHighDateTime)) << 32) | (uint64_t)(ft.dwLowDateTime));
+}
+
+
+/**
+ * Calculates the CRC-32 checksum of the given data.
+ *
+ * @param[in] data - data pointer
+ * @param[in] len - bytes to hash
+ * @return CRC-32 checksum
+ */
+static uint32_t sessionLogCrc(const void * data, const size_t len) {
+	return crc32Update(UINT32_MAX, data, len) ^ UINT32_MAX;
+}
+
+
+/**
+ * Records the given writer thread error. Only the first one is reported.
+ *
+ * @param[in,out] log - session log
+ * @param[in] err - Win32 error code
+ */
+static void sessionLogSetError(tSessionLog * log, const DWORD err) {
+	if ( log->failed ) {
+		return;
+	}
+	log->failed = true;
+	atomic_store_explicit(&(log->error), (unsigned)((err != 0) ? err : ERROR_WRITE_FAULT), memory_order_release);
+}
+
+
+/**
+ * Copies data from the queue at the given position.
+ *
+ * @param[in] log - session log
+ * @param[in] pos - total queue position
+ * @param[out] dst - destination buffer
+ * @param[in] len - number of bytes to copy
+ */
+static void sessionLogQueueRead(const tSessionLog * log, const size_t pos, void * dst, const size_t len) {
+	const size_t offset = pos & (SESSION_LOG_QUEUE_SIZE - 1);
+	const size_t first = PCF_MIN(len, (size_t)SESSION_LOG_QUEUE_SIZE - offset);
+	memcpy(dst, log->queue + offset, first);
+	memcpy((uint8_t *)dst + first, log->queue, len - first);
+}
+
+
+/**
+ * Copies data to the queue at the given position.
+ *
+ * @param[in,out] log - session log
+ * @param[in] pos - total queue position
+ * @param[in] src - source buffer
+ * @param[in] len - number of bytes to copy
+ */
+static void sessionLogQueueWrite(tSessionLog * log, const size_t pos, const void * src, const size_t len) {
+	const size_t offset = pos & (SESSION_LOG_QUEUE_SIZE - 1);
+	const size_t first = PCF_MIN(len, (size_t)SESSION_LOG_QUEUE_SIZE - offset);
+	memcpy(log->queue + offset, src, first);
+	memcpy(log->queue, (const uint8_t *)src + first, len - first);
+}
+
+
+/**
+ * Returns the number of bytes needed in the queue for a record with the given
+ * payload size.
+ *
+ * @param[in] len - payload size in bytes
+ * @return record size in bytes
+ */
+static size_t sessionLogRecordSize(const size_t len) {
+	return sizeof(tSessionLogRecord) + len;
+}
+
+
+/**
+ * Adds a single record to the queue. The caller needs to ensure that there is
+ * enough space.
+ *
+ * @param[in,out] log - session log
+ * @param[in] type - record type
+ * @param[in] item - item index
+ * @param[in] data - payload
+ * @param[in] len - payload size in bytes
+ */
+static void sessionLogPushRecord(tSessionLog * log, const tSessionLogType type, const size_t item, const void * data, const size_t len) {
+	const size_t head = atomic_load_explicit(&(log->head), memory_order_relaxed);
+	tSessionLogRecord rec;
+	ZeroMemory(&rec, sizeof(rec));
+	rec.size = (uint32_t)len;
+	rec.type = (uint16_t)type;
+	rec.item = (item < UINT32_MAX) ? (uint32_t)item : UINT32_MAX;
+	rec.time = sessionLogTime();
+	sessionLogQueueWrite(log, head, &rec, sizeof(rec));
+	if (len > 0) {
+		sessionLogQueueWrite(log, head + sizeof(rec), data, len);
+	}
+	atomic_store_explicit(&(log->head), head + sessionLogRecordSize(len), memory_order_release);
+}
+
+
+/**
+ * Adds a single record to the queue. This never blocks. Records which do not
+ * fit are counted and logged as `SLT_DROPPED` record in front of the next one
+ * which fits.
+ *
+ * @param[in,out] log - session log
+ * @param[in] type - record type
+ * @param[in] item - item index
+ * @param[in] data - payload
+ * @param[in] len - payload size in bytes
+ */
+static void sessionLogPush(tSessionLog * log, const tSessionLogType type, const size_t item, const void * data, const size_t len) {
+	const size_t total = sessionLogRecordSize(len);
+	const size_t extra = (log->dropped > 0) ? sessionLogRecordSize(sizeof(uint64_t)) : 0;
+	const size_t used = atomic_load_explicit(&(log->head), memory_order_relaxed) - atomic_load_explicit(&(log->tail), memory_order_acquire);
+	if (total > SESSION_LOG_BUFFER_SIZE || (used + extra + total) > SESSION_LOG_QUEUE_SIZE) {
+		++(log->dropped);
+		SetEvent(log->hWake);
+		return;
+	}
+	if (log->dropped > 0) {
+		const uint64_t dropped = log->dropped;
+		sessionLogPushRecord(log, SLT_DROPPED, SIZE_MAX, &dropped, sizeof(dropped));
+		log->dropped = 0;
+	}
+	sessionLogPushRecord(log, type, item, data, len);
+	if ((used + extra + total) >= (SESSION_LOG_QUEUE_SIZE / 4) && used < (SESSION_LOG_QUEUE_SIZE / 4)) {
+		/* drain early to keep enough space for bursts */
+		SetEvent(log->hWake);
+	}
+}
+
+
+/**
+ * Writes the buffered data to the current log file.
+ *
+ * @param[in,out] log - session log
+ */
+static void sessionLogFlush(tSessionLog * log) {
+	size_t pos = 0;
+	while (pos < log->bufLen && log->hFile != INVALID_HANDLE_VALUE) {
+		DWORD written = 0;
+		if ( ! WriteFile(log->hFile, log->buf + pos, (DWORD)(log->bufLen - pos), &written, NULL) || written == 0 ) {
+			sessionLogSetError(log, GetLastError());
+			break;
+		}
+		pos += (size_t)written;
+	}
+	log->bufLen = 0;
+	log->lastFlush = GetTickCount64();
+}
+
+
+/**
+ * Appends the given data to the write buffer.
+ *
+ * @param[in,out] log - session log
+ * @param[in] data - data to append
+ * @param[in] len - number of bytes (at most `SESSION_LOG_BUFFER_SIZE`)
+ */
+static void sessionLogAppend(tSessionLog * log, const void * data, const size_t len) {
+	if ((log->bufLen + len) > SESSION_LOG_BUFFER_SIZE) {
+		sessionLogFlush(log);
+	}
+	memcpy(log->buf + log->bufLen, data, len);
+	log->bufLen += len;
+	log->offset += len;
+}
+
+
+/**
+ * Opens the next log file and removes the oldest one if the number of files
+ * exceeds `SESSION_LOG_MAX_FILES`.
+ *
+ * @param[in,out] log - session log
+ * @return `true` on success, else `false`
+ */
+static bool sessionLogOpen(tSessionLog * log) {
+	const size_t len = wcslen(log->prefix) + 16;
+	wchar_t * path = malloc(len * sizeof(wchar_t));
+	if (path == NULL) {
+		SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+		return false;
+	}
+	if (log->part >= SESSION_LOG_MAX_FILES) {
+		snwprintf(path, len, L"%s-%03u.slog", log->prefix, log->part - SESSION_LOG_MAX_FILES);
+		DeleteFileW(path);
+	}
+	snwprintf(path, len, L"%s-%03u.slog", log->prefix, log->part);
+	log->hFile = CreateFileW(path, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	free(path);
+	if (log->hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	vec_clear(log->index);
+	if (log->seen != NULL) {
+		ZeroMemory(log->seen, log->seenSize);
+	}
+	log->offset = 0;
+	log->bufLen = 0;
+	sessionLogAppend(log, SESSION_LOG_MAGIC, 8);
+	return true;
+}
+
+
+/**
+ * Writes the item index and trailer and closes the current log file.
+ *
+ * @param[in,out] log - session log
+ */
+static void sessionLogClose(tSessionLog * log) {
+	if (log->hFile == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	const size_t count = vec_size(log->index);
+	const size_t len = count * sizeof(tSessionLogIndex);
+	tSessionLogTrailer trailer;
+	tSessionLogRecord rec;
+	ZeroMemory(&trailer, sizeof(trailer));
+	ZeroMemory(&rec, sizeof(rec));
+	trailer.offset = log->offset;
+	memcpy(trailer.magic, SESSION_LOG_INDEX_MAGIC, sizeof(trailer.magic));
+	rec.size = (uint32_t)len;
+	rec.type = SLT_INDEX;
+	rec.item = UINT32_MAX;
+	rec.crc = sessionLogCrc(vec_at(log->index, 0), len);
+	rec.time = sessionLogTime();
+	sessionLogAppend(log, &rec, sizeof(rec));
+	for (size_t i = 0; i < count; ++i) {
+		sessionLogAppend(log, vec_at(log->index, i), sizeof(tSessionLogIndex));
+	}
+	sessionLogAppend(log, &trailer, sizeof(trailer));
+	sessionLogFlush(log);
+	closeHandlePtr(&(log->hFile), INVALID_HANDLE_VALUE);
+}
+
+
+/**
+ * Adds the given item to the index of the current log file if not yet done.
+ *
+ * @param[in,out] log - session log
+ * @param[in] item - item index
+ */
+static void sessionLogIndexItem(tSessionLog * log, const uint32_t item) {
+	if (item == UINT32_MAX) {
+		return;
+	}
+	const size_t byte = (size_t)(item / 8);
+	const uint8_t bit = (uint8_t)(1U << (item % 8));
+	if (byte >= log->seenSize) {
+		const size_t newSize = PCF_MAX(byte + 1, log->seenSize * 2);
+		uint8_t * seen = realloc(log->seen, newSize);
+		if (seen == NULL) {
+			return;
+		}
+		ZeroMemory(seen + log->seenSize, newSize - log->seenSize);
+		log->seen = seen;
+		log->seenSize = newSize;
+	}
+	if ((log->seen[byte] & bit) != 0) {
+		return;
+	}
+	tSessionLogIndex * entry = vec_pushBack(log->index);
+	if (entry != NULL) {
+		entry->item = item;
+		entry->reserved = 0;
+		entry->offset = log->offset;
+		log->seen[byte] = (uint8_t)(log->seen[byte] | bit);
+	}
+}
+
+
+/**
+ * Moves all queued records to the log files.
+ *
+ * @param[in,out] log - session log
+ */
+static void sessionLogDrain(tSessionLog * log) {
+	const size_t head = atomic_load_explicit(&(log->head), memory_order_acquire);
+	size_t tail = atomic_load_explicit(&(log->tail), memory_order_relaxed);
+	while (tail != head) {
+		tSessionLogRecord rec;
+		sessionLogQueueRead(log, tail, &rec, sizeof(rec));
+		const size_t total = sizeof(rec) + (size_t)(rec.size);
+		/* rotate to keep each file within the size cap */
+		if (log->hFile != INVALID_HANDLE_VALUE && (log->offset + total) > SESSION_LOG_MAX_FILE_SIZE && log->offset > 8) {
+			sessionLogClose(log);
+			++(log->part);
+			if ( ! sessionLogOpen(log) ) {
+				sessionLogSetError(log, GetLastError());
+			}
+		}
+		if (log->hFile != INVALID_HANDLE_VALUE) {
+			if ((log->bufLen + total) > SESSION_LOG_BUFFER_SIZE) {
+				sessionLogFlush(log);
+			}
+			sessionLogIndexItem(log, rec.item);
+			/* copy the payload directly into the write buffer */
+			uint8_t * payload = log->buf + log->bufLen + sizeof(rec);
+			sessionLogQueueRead(log, tail + sizeof(rec), payload, (size_t)(rec.size));
+			rec.crc = sessionLogCrc(payload, (size_t)(rec.size));
+			memcpy(log->buf + log->bufLen, &rec, sizeof(rec));
+			log->bufLen += total;
+			log->offset += total;
+		} /* else: discard */
+		tail += total;
+		atomic_store_explicit(&(log->tail), tail, memory_order_release);
+	}
+}
+
+
+/**
+ * Session log writer thread. It wakes up periodically or if the queue runs
+ * full, moves the queued records to the write buffer and writes it out in
+ * large sequential appends.
+ *
+ * @param[in,out] param - session log
+ * @return thread exit code
+ */
+static DWORD WINAPI sessionLogThread(LPVOID param) {
+	tSessionLog * log = (tSessionLog *)param;
+	trace_setThreadName("log");
+	for (;;) {
+		WaitForSingleObject(log->hWake, SESSION_LOG_FLUSH_INTERVAL);
+		/* the producer adds no records after setting `stop` */
+		const bool stop = atomic_load_explicit(&(log->stop), memory_order_acquire);
+		TRACE_BEGIN("log", "drain");
+		sessionLogDrain(log);
+		if ( stop ) {
+			TRACE_END("log", "drain");
+			break;
+		}
+		if (log->bufLen >= (SESSION_LOG_BUFFER_SIZE / 2) || (GetTickCount64() - log->lastFlush) >= SESSION_LOG_FLUSH_INTERVAL) {
+			sessionLogFlush(log);
+		}
+		TRACE_END("log", "drain");
+	}
+	sessionLogClose(log);
+	return 0;
+}
+
+
+/**
+ * Frees all resources of the given session log. The writer thread needs to be
+ * finished already.
+ *
+ * @param[in,out] log - session log
+ */
+static void sessionLogFree(tSessionLog * log) {
+	closeHandlePtr(&(log->hFile), INVALID_HANDLE_VALUE);
+	closeHandlePtr(&(log->hWake), NULL);
+	closeHandlePtr(&(log->hThread), NULL);
+	wStrDelete(&(log->prefix));
+	if (log->index != NULL) {
+		vec_delete(log->index);
+	}
+	free(log->seen);
+	free(log->buf);
+	free(log->queue);
+	free(log);
+}
+
+
+/**
+ * Creates a new session log in the given directory and starts its writer
+ * thread. The files are named `siguwi-<date>-<time>-<pid>-<part>.slog`. Each
+ * one starts with `SESSION_LOG_MAGIC` followed by framed records
+ * (`tSessionLogRecord`). A properly closed file ends with an `SLT_INDEX`
+ * record and a `tSessionLogTrailer`.
+ *
+ * @param[in] dir - output directory
+ * @return session log or `NULL` on error with the error code in `GetLastError()`
+ */
+tSessionLog * sessionLogCreate(const wchar_t * dir) {
+	if (dir == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return NULL;
+	}
+	DWORD err = ERROR_NOT_ENOUGH_MEMORY;
+	tSessionLog * log = calloc(1, sizeof(tSessionLog));
+	if (log == NULL) {
+		SetLastError(err);
+		return NULL;
+	}
+	log->hFile = INVALID_HANDLE_VALUE;
+	atomic_init(&(log->stop), false);
+	atomic_init(&(log->error), 0);
+	atomic_init(&(log->head), 0);
+	atomic_init(&(log->tail), 0);
+	log->queue = malloc(SESSION_LOG_QUEUE_SIZE);
+	log->buf = malloc(SESSION_LOG_BUFFER_SIZE);
+	log->index = vec_create(sizeof(tSessionLogIndex));
+	const size_t len = wcslen(dir) + 64;
+	log->prefix = malloc(len * sizeof(wchar_t));
+	if (log->queue == NULL || log->buf == NULL || log->index == NULL || log->prefix == NULL) {
+		goto onError;
+	}
+	SYSTEMTIME st;
+	GetLocalTime(&st);
+	const size_t dirLen = wcslen(dir);
+	const bool needSep = dirLen > 0 && dir[dirLen - 1] != L'\\' && dir[dirLen - 1] != L'/';
+	snwprintf(log->prefix, len, L"%s%ssiguwi-%04u%02u%02u-%02u%02u%02u-%lu", dir, needSep ? L"\\" : L"",
+		(unsigned)st.wYear, (unsigned)st.wMonth, (unsigned)st.wDay, (unsigned)st.wHour, (unsigned)st.wMinute, (unsigned)st.wSecond,
+		(unsigned long)GetCurrentProcessId()
+	);
+	log->prefix[len - 1] = 0;
+	if ( ! wToFullPath(&(log->prefix), true) ) {
+		goto onError;
+	}
+	log->hWake = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (log->hWake == NULL || ( ! sessionLogOpen(log) )) {
+		err = GetLastError();
+		goto onError;
+	}
+	static const char session[] = "siguwi " SIGUWI_VERSION;
+	sessionLogPush(log, SLT_SESSION, SIZE_MAX, session, sizeof(session) - 1);
+	log->lastFlush = GetTickCount64();
+	log->hThread = CreateThread(NULL, 0, sessionLogThread, log, 0, NULL);
+	if (log->hThread == NULL) {
+		err = GetLastError();
+		goto onError;
+	}
+	return log;
+onError:
+	sessionLogFree(log);
+	SetLastError(err);
+	return NULL;
+}
+
+
+/**
+ * Logs a newly added item.
+ *
+ * @param[in,out] log - session log or `NULL`
+ * @param[in] item - item index
+ * @param[in] path - file path
+ */
+void sessionLogItem(tSessionLog * log, const size_t item, const wchar_t * path) {
+	if (log == NULL || path == NULL) {
+		return;
+	}
+	char * utf8 = wToUtf8(path);
+	if (utf8 == NULL) {
+		++(log->dropped);
+		return;
+	}
+	sessionLogPush(log, SLT_ITEM, item, utf8, strlen(utf8));
+	free(utf8);
+}
+
+
+/**
+ * Logs a chunk of signing application output as received.
+ *
+ * @param[in,out] log - session log or `NULL`
+ * @param[in] item - item index
+ * @param[in] data - output data
+ * @param[in] len - number of bytes in `data`
+ */
+void sessionLogOutput(tSessionLog * log, const size_t item, const void * data, const size_t len) {
+	if (log == NULL || data == NULL || len == 0) {
+		return;
+	}
+	sessionLogPush(log, SLT_OUTPUT, item, data, len);
+}
+
+
+/**
+ * Logs the current processing state of the given item.
+ *
+ * @param[in,out] log - session log or `NULL`
+ * @param[in] item - item index
+ * @param[in] proc - process item
+ */
+void sessionLogState(tSessionLog * log, const size_t item, const tProcCtx * proc) {
+	if (log == NULL || proc == NULL) {
+		return;
+	}
+	const uint32_t data[2] = {
+		(uint32_t)(proc->state),
+		proc->hasExitCode ? (uint32_t)(proc->exitCode) : UINT32_MAX
+	};
+	sessionLogPush(log, SLT_STATE, item, data, sizeof(data));
+}
+
+
+/**
+ * Returns and clears the writer thread error. Only the first error is
+ * reported.
+ *
+ * @param[in,out] log - session log or `NULL`
+ * @return Win32 error code or 0
+ */
+DWORD sessionLogGetError(tSessionLog * log) {
+	if (log == NULL) {
+		return 0;
+	}
+	return (DWORD)atomic_exchange_explicit(&(log->error), 0, memory_order_acquire);
+}
+
+
+/**
+ * Finishes the writer thread after all queued records were written, closes the
+ * current log file and frees the session log.
+ *
+ * @param[in,out] log - session log or `NULL`
+ */
+void sessionLogDelete(tSessionLog * log) {
+	if (log == NULL) {
+		return;
+	}
+	if (log->hThread != NULL) {
+		atomic_store_explicit(&(log->stop), true, memory_order_release);
+		SetEvent(log->hWake);
+		WaitForSingleObject(log->hThread, INFINITE);
+	}
+	sessionLogFree(log);
+}
@@ -2,7 +2,7 @@
  * @file siguwi-main.c
  * @author Daniel Starke
  * @date 2025-06-14
- * @version 2025-10-21
+ * @version 2026-10-18
  */
 #include "siguwi.h"
 
@@ -66,7 +66,31 @@ const wchar_t * const errStr[] = {
 	/* ERR_GET_STD_HANDLE */   L"Failed to get standard I/O handle.",
 	/* ERR_INVALID_REG_VERB */ L"Invalid static shell context menu item verb string \"%s\" given.",
 	/* ERR_INIT_COM */         L"Failed to initialize COM (0x%08X).",
-	/* ERR_FILE_NOT_FOUND */   L"File not found:\n%s"
+	/* ERR_FILE_NOT_FOUND */   L"File not found:\n%s",
+	/* ERR_START_PROCESS */    L"Failed to start the signing application (%s, 0x%08X).",
+	/* ERR_WAIT_PROCESS */     L"Failed to wait for the signing application (0x%08X).",
+	/* ERR_IPC_DISABLED */     L"Stopped accepting signing requests from other instances.",
+	/* ERR_TRACE_DISABLED */   L"Tracing support was not enabled at build time.",
+	/* ERR_SESSION_LOG */      L"Failed to write the session log (0x%08X).",
+	/* ERR_RECORD */           L"Failed to write the replay trace (0x%08X).",
+	/* ERR_DROP_TARGET */      L"Failed to receive the selected files from the shell (0x%08X).",
+	/* ERR_READ_ARCHIVE */     L"Failed to extract the files to sign from the archive:\n%s",
+	/* ERR_ARCHIVE_EMPTY */    L"No files to sign found in the archive:\n%s",
+	/* ERR_ARCHIVE_FAILED */   L"Archive left unchanged as %zu of its files failed:\n%s",
+	/* ERR_UPDATE_ARCHIVE */   L"Failed to update the archive (0x%08X):\n%s",
+	/* ERR_HTTP_PORT */        L"Invalid HTTP port '%s'.",
+	/* ERR_HTTP_LISTEN */      L"Failed to listen for HTTP requests on port %u (0x%08X).",
+	/* ERR_SCAN_TREE */        L"Failed to scan the directory tree (0x%08X):\n%s",
+	/* ERR_TREE_UNCHANGED */   L"No changed files to sign found in the directory tree:\n%s",
+	/* ERR_SAVE_INDEX */       L"Failed to save the file index of the directory tree (0x%08X):\n%s",
+	/* ERR_MATCH_RULE */       L"Invalid or too many output rules. Expected up to 64 \"match\" entries of the form \"state:pattern\".",
+	/* ERR_AGENT_SPEC */       L"Invalid agent '%s'. Expected up to 32 agents of the form host:port or host:port,upload.",
+	/* ERR_AGENT_KEY */        L"Failed to read the agent key. Expected 16 to 4096 bytes in:\n%s",
+	/* ERR_AGENT_NO_KEY */     L"Agents require a shared key (--key).",
+	/* ERR_AGENT_START */      L"Failed to start the agent connections (0x%08X).",
+	/* ERR_AGENT_DOWN */       L"Agent %s is unreachable (%s). Files it signs by path wait for it. Others are passed on to the other agents.",
+	/* ERR_AGENT_FAILED */     L"Failed to sign the file on agent %s (%s):\n%s",
+	/* ERR_CHAIN */            L"Invalid signing chain. Expected up to 3 comma separated \"chain\" sections with certId, cardName, cardReader and signApp each."
 };
 
 
@@ -82,49 +106,12 @@ wchar_t * const procStateStr[] = {
 	/* PST_BROKEN_PIPE */       L"broken pipe",
 	/* PST_APP_NOT_FOUND */     L"app not found",
 	/* PST_PIN_MISSING */       L"pin missing",
-	/* PST_PIN_WRONG */         L"pin wrong"
-};
-
-
-/**
- * Look-up table for CRC32 hashing.
- */
-const uint32_t crc32Table[] = {
-	0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
-	0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
-	0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
-	0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
-	0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
-	0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
-	0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
-	0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
-	0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
-	0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
-	0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
-	0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
-	0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
-	0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
-	0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
-	0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
-	0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
-	0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
-	0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
-	0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
-	0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
-	0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
-	0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
-	0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
-	0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
-	0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
-	0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
-	0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
-	0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
-	0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
-	0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
-	0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+	/* PST_PIN_WRONG */         L"pin wrong",
+	/* PST_CANCELLED */         L"cancelled"
 };
 
 
+#ifndef SIGUWI_LIBRARY
 /**
  * Main entry point.
  *
@@ -141,16 +128,35 @@ int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE hInstPrev, LPWSTR cmdline, int
 	wchar_t ** argv, ** enpv, * configUrl, * oldConfigUrl, * regEntry;
 	wchar_t configPath[MAX_PATH];
 	wchar_t * configGroup;
+	wchar_t * report;
+	wchar_t * trace;
+	wchar_t * logDir;
+	wchar_t * record;
+	wchar_t * dropClsid;
+	wchar_t * keyPath;
+	unsigned short httpPort;
+	uint8_t * key = NULL;
+	size_t keyLen = 0;
+	tVector * agents = NULL;
+	tVector * files = NULL;
 	tRegMode regMode;
 	int argc, si = 0;
 	if (__wgetmainargs(&argc, &argv, &enpv, 1 /* enable globbing */, &si) != 0) {
 		return EXIT_FAILURE;
 	}
 	static const struct option longOptions[] = {
+		{L"agent",      required_argument, NULL, L'a'},
 		{L"config",     required_argument, NULL, L'c'},
+		{L"drop-target", required_argument, NULL, L'D'},
 		{L"help",       no_argument,       NULL, L'h'},
+		{L"http",       required_argument, NULL, L'H'},
+		{L"key",        required_argument, NULL, L'k'},
 		{L"list",       no_argument,       NULL, L'l'},
+		{L"log",        required_argument, NULL, L'L'},
+		{L"record",     required_argument, NULL, L'R'},
+		{L"report",     required_argument, NULL, L'o'},
 		{L"register",   required_argument, NULL, L'r'},
+		{L"trace",      required_argument, NULL, L'T'},
 		{L"translate",  no_argument,       NULL, L't'},
 		{L"unregister", required_argument, NULL, L'u'},
 		{L"version",    no_argument,       NULL, L'v'},
@@ -173,6 +179,11 @@ int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE hInstPrev, LPWSTR cmdline, int
 	_wputenv(L"JAVA_TOOL_OPTIONS=-Dfile.encoding=UTF-8 -Dsun.jnu.encoding=UTF-8");
 	SetProcessPreferredUILanguages(MUI_LANGUAGE_NAME, L"en-US\0", NULL);
 
+	/* COM appends `-Embedding` when starting the shell drop target */
+	if (argc > 1 && (_wcsicmp(argv[argc - 1], L"-Embedding") == 0 || _wcsicmp(argv[argc - 1], L"/Embedding") == 0)) {
+		--argc;
+	}
+
 	if (argc <= 1) {
 		return showConfigs(cmdshow);
 	}
@@ -181,26 +192,85 @@ int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE hInstPrev, LPWSTR cmdline, int
 	configGroup = NULL;
 	oldConfigUrl = NULL;
 	regEntry = NULL;
+	report = NULL;
+	trace = NULL;
+	logDir = NULL;
+	record = NULL;
+	dropClsid = NULL;
+	keyPath = NULL;
+	httpPort = 0;
 	regMode = RM_NONE;
 	while (1) {
-		const int res = getopt_long(argc, argv, L":c:hlvr:tu:", longOptions, NULL);
+		const int res = getopt_long(argc, argv, L":a:c:D:hH:k:lL:o:vr:R:tT:u:", longOptions, NULL);
 		if (res == -1) break;
 		switch (res) {
+		case L'a': {
+			wchar_t * host = NULL;
+			unsigned short port;
+			bool upload;
+			const bool valid = remoteParseSpec(optarg, &host, &port, &upload) && (agents == NULL || vec_size(agents) < REMOTE_MAX_AGENTS);
+			wStrDelete(&host);
+			if ( ! valid ) {
+				showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (command-line)", errStr[ERR_AGENT_SPEC], optarg);
+				return EXIT_FAILURE;
+			}
+			if (agents == NULL) {
+				agents = vec_create(sizeof(wchar_t *));
+			}
+			wchar_t ** spec = (agents != NULL) ? vec_pushBack(agents) : NULL;
+			if (spec == NULL) {
+				MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (command-line)", MB_OK | MB_ICONERROR);
+				return EXIT_FAILURE;
+			}
+			*spec = optarg;
+			} break;
 		case L'c':
 			configUrl = optarg;
 			break;
+		case L'D':
+			dropClsid = optarg;
+			break;
 		case L'h':
 			showHelp();
 			return EXIT_SUCCESS;
+		case L'H': {
+			wchar_t * end = NULL;
+			const unsigned long port = wcstoul(optarg, &end, 10);
+			if (end == optarg || *end != 0 || port == 0 || port > 65535) {
+				showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (command-line)", errStr[ERR_HTTP_PORT], optarg);
+				return EXIT_FAILURE;
+			}
+			httpPort = (unsigned short)port;
+			} break;
+		case L'k':
+			keyPath = optarg;
+			break;
 		case L'l':
 			return showConfigs(cmdshow);
+		case L'L':
+			logDir = optarg;
+			break;
+		case L'o':
+			report = optarg;
+			break;
 		case L'r':
 			regMode = RM_REGISTER;
 			regEntry = optarg;
 			break;
+		case L'R':
+			record = optarg;
+			break;
 		case L't':
 			return translateIo();
 			break;
+		case L'T':
+#ifdef SIGUWI_TRACE
+			trace = optarg;
+			break;
+#else /* not SIGUWI_TRACE */
+			MessageBoxW(NULL, errStr[ERR_TRACE_DISABLED], L"Error (command-line)", MB_OK | MB_ICONERROR);
+			return EXIT_FAILURE;
+#endif /* not SIGUWI_TRACE */
 		case L'u':
 			regMode = RM_UNREGISTER;
 			regEntry = optarg;
@@ -225,6 +295,18 @@ int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE hInstPrev, LPWSTR cmdline, int
 		}
 	}
 	int res = EXIT_FAILURE;
+	if (agents != NULL && keyPath == NULL) {
+		MessageBoxW(NULL, errStr[ERR_AGENT_NO_KEY], L"Error (command-line)", MB_OK | MB_ICONERROR);
+		return EXIT_FAILURE;
+	}
+	if (keyPath != NULL && ( ! httpKeyLoad(keyPath, &key, &keyLen) )) {
+		showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (command-line)", errStr[ERR_AGENT_KEY], keyPath);
+		return EXIT_FAILURE;
+	}
+	if (trace != NULL && ( ! trace_start(0) )) {
+		MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (command-line)", MB_OK | MB_ICONERROR);
+		return EXIT_FAILURE;
+	}
 
 	/* get executable directory */
 	{
@@ -284,6 +366,9 @@ int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE hInstPrev, LPWSTR cmdline, int
 		goto onError;
 	}
 
+	tIniConfig config;
+	ZeroMemory(&config, sizeof(config));
+
 	/* un-/register context menu entry in registry */
 	switch (regMode) {
 	case RM_NONE:
@@ -294,10 +379,34 @@ int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE hInstPrev, LPWSTR cmdline, int
 		goto onError;
 	}
 
+	/* collect the files to process */
+	files = vec_create(sizeof(wchar_t *));
+	if (files == NULL) {
+		MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (command-line)", MB_OK | MB_ICONERROR);
+		goto onError;
+	}
+	if (dropClsid != NULL) {
+		/* receive all selected files of a multi-select shell invocation */
+		if ( ! shellDropTarget(dropClsid, files) ) {
+			showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (command-line)", errStr[ERR_DROP_TARGET], GetLastError());
+			goto onError;
+		}
+	} else {
+		for (int i = optind; i < argc; ++i) {
+			if ( ! shellFilesAdd(files, argv[i]) ) {
+				MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (command-line)", MB_OK | MB_ICONERROR);
+				goto onError;
+			}
+		}
+		if (report == NULL && logDir == NULL && record == NULL && trace == NULL && httpPort == 0 && key == NULL && ( ! shellCoalesce(configUrl, configGroup, files) )) {
+			/* passed on to a concurrent invocation with the same configuration */
+			res = EXIT_SUCCESS;
+			goto onError;
+		}
+	}
+
 	/* load configuration file */
-	tIniConfig config;
 	tFilePos errPos;
-	ZeroMemory(&config, sizeof(config));
 	ZeroMemory(&errPos, sizeof(errPos));
 	if ( ! iniConfigParse(configUrl, configGroup, &config, &errPos) ) {
 		if (lastErr == ERR_SYNTAX_ERROR) {
@@ -329,21 +438,57 @@ int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE hInstPrev, LPWSTR cmdline, int
 		MessageBoxW(NULL, errStr[ERR_GET_CSP], L"Error (showProcess)", MB_OK | MB_ICONERROR);
 		goto onError;
 	}
+	/* check the signing chain */
+	if (config.chain != NULL) {
+		tRcIniConfigBase * chain = rcIniConfigBaseCreate(config.cert, NULL);
+		if (chain == NULL) {
+			MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (INI file)", MB_OK | MB_ICONERROR);
+			goto onError;
+		}
+		const bool validChain = iniConfigChain(configUrl, chain, config.chain);
+		rcIniConfigBaseDelete(chain);
+		if ( ! validChain ) {
+			showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (INI file)", L"%s: %s", configUrl, errStr[lastErr]);
+			goto onError;
+		}
+	}
 	/* process given file list */
-	res = showProcess(&config, cmdshow, argc - optind, argv + optind);
+	res = showProcess(&config, configUrl, report, logDir, record, httpPort, key, keyLen, agents, cmdshow, (int)vec_size(files), (wchar_t **)vec_at(files, 0));
 onError:
+	shellFilesDelete(files);
+	if (agents != NULL) {
+		vec_delete(agents);
+	}
+	if (key != NULL) {
+		SecureZeroMemory(key, keyLen);
+		free(key);
+	}
 	wStrDelete(&(config.cert->certProv));
 	wStrDelete(&(config.cert->certId));
 	wStrDelete(&(config.cert->cardName));
 	wStrDelete(&(config.cert->cardReader));
 	rws_release(&(config.signApp));
+	wStrDelete(&(config.match));
+	wStrDelete(&(config.chain));
 	if (oldConfigUrl != configUrl) {
 		wStrDelete(&configUrl);
 	}
 	wStrDelete(&exeDir);
 	wStrDelete(&exePath);
+	if (trace != NULL) {
+		FILE * fp = _wfopen(trace, L"wb");
+		if (fp == NULL || ( ! trace_write(fp) )) {
+			showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (trace)", L"%s\n%s", errStr[ERR_CREATE_FILE], trace);
+			res = EXIT_FAILURE;
+		}
+		if (fp != NULL) {
+			fclose(fp);
+		}
+		trace_stop();
+	}
 	return res;
 }
+#endif /* not SIGUWI_LIBRARY */
 
 
 /**
@@ -525,6 +670,43 @@ bool wFileExists(const wchar_t * path) {
 }
 
 
+/**
+ * Checks if the given path is an existing directory.
+ *
+ * @param[in] path - path to check
+ * @return `true` if existing directory path, else `false`
+ */
+bool wDirExists(const wchar_t * path) {
+	const DWORD attr = GetFileAttributesW(path);
+	return attr != INVALID_FILE_ATTRIBUTES && (attr & FILE_ATTRIBUTE_DIRECTORY) != 0;
+}
+
+
+/**
+ * Returns the path of the given file within the `siguwi` directory of the
+ * local application data directory. The directory is created if missing.
+ *
+ * @param[in] name - file name
+ * @param[out] buf - output buffer
+ * @param[in] len - output buffer size in number of characters
+ * @return `true` on success, else `false`
+ */
+bool wLocalDataPath(const wchar_t * name, wchar_t * buf, const size_t len) {
+	wchar_t dir[MAX_PATH + 1];
+	if (name == NULL || buf == NULL || len == 0) {
+		return false;
+	}
+	if (SHGetFolderPathW(NULL, CSIDL_LOCAL_APPDATA | CSIDL_FLAG_CREATE, NULL, SHGFP_TYPE_CURRENT, dir) != S_OK) {
+		return false;
+	}
+	if (wcscat_s(dir, ARRAY_SIZE(dir), L"\\siguwi") != 0 || (( ! CreateDirectoryW(dir, NULL) ) && GetLastError() != ERROR_ALREADY_EXISTS)) {
+		return false;
+	}
+	const int n = snwprintf(buf, len, L"%s\\%s", dir, name);
+	return n > 0 && (size_t)n < len;
+}
+
+
 /**
  * Deletes the given wide-character string if set and resets it.
  *
@@ -590,53 +772,6 @@ wchar_t * siguwi_wcsdup(const wchar_t * str) {
 #endif /* not NDEBUG */
 
 
-/**
- * Hashes the given data with the passed seed.
- * The updated seed is returned.
- *
- * @param[in] seed - seed to update
- * @param[in] data - data pointer
- * @param[in] len - bytes to hash
- * @return updated seed
- */
-inline uint32_t crc32Update(uint32_t seed, const void * data, const size_t len) {
-	const uint8_t * ptr = data;
-	for (size_t i = 0; i < len; ++i) {
-		seed = crc32Table[(*ptr ^ seed) & 0xFF] ^ (seed >> 8);
-		++ptr;
-	}
-	return seed;
-}
-
-
-/**
- * Compares the given token with a passed string. Both are compared case sensitive. The token needs
- * to match the passed string exactly and completely to return 0.
- *
- * @param[in] token - token to compare
- * @param[in] str - compare with this string
- * @return same as strcmp
- */
-int cmpToken(const tToken * const token, const wchar_t * str) {
-	if (token == NULL || token->ptr == NULL || str == NULL) {
-		lastErr = ERR_INVALID_ARG;
-		return INT_MAX;
-	}
-	const unsigned short * left = (const unsigned short *)(token->ptr);
-	const unsigned short * right = (const unsigned short *)str;
-	size_t len = token->len;
-	for (;len > 0 && *right != 0 && *left == *right; --len, ++left, ++right);
-	if (len > 0 && *right == 0) {
-		return *left;
-	} else if (len == 0 && *right != 0) {
-		return -(*right);
-	} else if (len == 0 && *right == 0) {
-		return 0;
-	}
-	return *left - *right;
-}
-
-
 /**
  * Returns the current screen DPI.
  *
@@ -757,29 +892,62 @@ void closeHandlePtr(HANDLE * h, const HANDLE r) {
  * Show the help for this application as modal window.
  */
 void showHelp(void) {
-	wchar_t buf[1024];
+	wchar_t buf[4096];
 	snwprintf(buf, ARRAY_SIZE(buf),
-		L"siguwi [-c file[:section]] [--] [files ...]\n"
+		L"siguwi [-c file[:section]] [-H port] [-k file [-a agent ...]] [-L dir] [-o file] [-R file] [-T file] [--] [files ...]\n"
 		L"siguwi [-c file[:section]] -r verb[:text]\n"
 		L"siguwi [-c file[:section]] -u verb\n"
 		L"siguwi [-hltv]\n"
 		"\n"
+		"-a, --agent host:port[,upload]\n"
+		"\tPass all files to the given siguwi agent instead of\n"
+		"\tsigning them locally. Can be given multiple times.\n"
+		"\tFiles are uploaded to the agent with ',upload' and\n"
+		"\topened by their path otherwise. Requires --key.\n"
 		"-c, --config file[:section]\n"
 		"\tSpecify the configuration file. Can be following\n"
 		"\tby a section name if separated by a colon (':').\n"
+		"-D, --drop-target clsid\n"
+		"\tReceive the selected files from the shell. This is\n"
+		"\tused by the registered context menu entry.\n"
 		"-l, --list\n"
 		"\tList possible configurations.\n"
+		"-L, --log dir\n"
+		"\tWrite a session log with the output of all files\n"
+		"\tto the given directory.\n"
 		"-h, --help\n"
 		"\tShow short usage instruction.\n"
+		"-H, --http port\n"
+		"\tAccept signing requests via HTTP/JSON on the given\n"
+		"\tport of 127.0.0.1 or of all interfaces with --key.\n"
+		"\tRequests may select other sections of the\n"
+		"\tconfiguration file.\n"
+		"-k, --key file\n"
+		"\tAuthenticate requests with the shared key in the\n"
+		"\tgiven file. Run standalone and accept signed HTTP\n"
+		"\trequests from other hosts as agent with --http.\n"
+		"-o, --report file\n"
+		"\tWrite a run report with per file timings and\n"
+		"\taggregates at the end of each batch. The format is\n"
+		"\tCSV for .csv files and JSON otherwise.\n"
 		"-r, --register verb[:text]\n"
 		"\tAdd a shell context menu entry via registry for:\n"
 		"\t- executable files (.exe)\n"
 		"\t- shared libraries (.dll)\n"
 		"\t- PowerShell scripts (.ps1)\n"
+		"\t- Windows Installer packages (.msi)\n"
+		"\t- cabinet files (.cab)\n"
+		"\t- NuGet, VSIX and ZIP packages (.nupkg, .vsix, .zip)\n"
 		"\tSpecify the unique registry verb and an optional menu\n"
 		"\tstring separated by a colon (':').\n"
+		"-R, --record file\n"
+		"\tRecord request, output and exit timings to a compact\n"
+		"\treplay trace for siguwi-replay.\n"
 		"-t, --translate\n"
 		"\tTranslate standard input data from ACP to UTF-8.\n"
+		"-T, --trace file\n"
+		"\tWrite a Chrome trace event file on exit. Requires a\n"
+		"\tbuild with TRACE=1.\n"
 		"-u, --unregister verb\n"
 		"\tRemove the shell context menu entry with the given\n"
 		"\tverb from the registry.\n"
@@ -0,0 +1,215 @@
+/**
+ * @file siguwi-match.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Splits the given output rule of the form `state:pattern`. The state is
+ * one of the final item states except `cancelled`. An empty state only flags
+ * the item.
+ *
+ * @param[in] rule - rule string
+ * @param[in] len - length of `rule` in number of characters
+ * @param[out] state - receives the item state or `PST_IDLE` for an empty state
+ * @param[out] pattern - receives the pattern offset within `rule`
+ * @return `true` on success, else `false` if the rule is invalid
+ */
+static bool matchRuleSplit(const wchar_t * rule, const size_t len, tProcState * state, size_t * pattern) {
+	const wchar_t * sep = wmemchr(rule, L':', len);
+	if (sep == NULL || (size_t)(sep - rule + 1) >= len) {
+		return false;
+	}
+	const size_t stateLen = (size_t)(sep - rule);
+	*pattern = stateLen + 1;
+	if (stateLen == 0) {
+		*state = PST_IDLE;
+		return true;
+	}
+	for (int s = PST_OK; s < PST_CANCELLED; ++s) {
+		if (wcslen(procStateStr[s]) == stateLen && wcsncmp(procStateStr[s], rule, stateLen) == 0) {
+			*state = (tProcState)s;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Validates the given output rule and appends it to the passed rule list.
+ *
+ * @param[in,out] rules - line feed separated rule list or `NULL`
+ * @param[in] rule - rule to add
+ * @return `true` on success, else `false`
+ * @remarks Sets `lastErr` on error.
+ */
+bool matchRuleAdd(wchar_t ** rules, const wchar_t * rule) {
+	if (rules == NULL || rule == NULL) {
+		lastErr = ERR_INVALID_ARG;
+		return false;
+	}
+	tProcState state;
+	size_t pattern;
+	const size_t len = wcslen(rule);
+	size_t count = 0;
+	const size_t oldLen = (*rules != NULL) ? wcslen(*rules) : 0;
+	for (size_t i = 0; i < oldLen; ++i) {
+		if ((*rules)[i] == L'\n') {
+			++count;
+		}
+	}
+	if (*rules != NULL) {
+		++count;
+	}
+	if (count >= ACM_MAX_PATTERNS || wcschr(rule, L'\n') != NULL || ( ! matchRuleSplit(rule, len, &state, &pattern) )) {
+		lastErr = ERR_MATCH_RULE;
+		return false;
+	}
+	const size_t sepLen = (*rules != NULL) ? 1 : 0;
+	wchar_t * res = realloc(*rules, (oldLen + sepLen + len + 1) * sizeof(wchar_t));
+	if (res == NULL) {
+		lastErr = ERR_OUT_OF_MEMORY;
+		return false;
+	}
+	if (sepLen > 0) {
+		res[oldLen] = L'\n';
+	}
+	wmemcpy(res + oldLen + sepLen, rule, len + 1);
+	*rules = res;
+	return true;
+}
+
+
+/**
+ * Compiles the given output rule list.
+ *
+ * @param[in] rules - line feed separated rule list
+ * @return compiled rules or `NULL` on error
+ */
+tMatchRules * matchRulesCreate(const wchar_t * rules) {
+	if (rules == NULL) {
+		return NULL;
+	}
+	tMatchRules * res = calloc(1, sizeof(tMatchRules));
+	if (res == NULL) {
+		return NULL;
+	}
+	char * utf8 = NULL;
+	res->m = acm_create(true);
+	if (res->m == NULL) {
+		goto onError;
+	}
+	for (const wchar_t * rule = rules; *rule != 0;) {
+		const wchar_t * end = wcschr(rule, L'\n');
+		const size_t len = (end != NULL) ? (size_t)(end - rule) : wcslen(rule);
+		size_t pattern;
+		if (res->count >= ACM_MAX_PATTERNS || ( ! matchRuleSplit(rule, len, res->state + res->count, &pattern) )) {
+			goto onError;
+		}
+		wchar_t * str = malloc((len - pattern + 1) * sizeof(wchar_t));
+		if (str == NULL) {
+			goto onError;
+		}
+		wmemcpy(str, rule + pattern, len - pattern);
+		str[len - pattern] = 0;
+		res->pattern[res->count] = str;
+		utf8 = wToUtf8(str);
+		if (utf8 == NULL || ( ! acm_add(res->m, (const uint8_t *)utf8, strlen(utf8), (unsigned)(res->count)) )) {
+			goto onError;
+		}
+		free(utf8);
+		utf8 = NULL;
+		++(res->count);
+		rule += (end != NULL) ? len + 1 : len;
+	}
+	if ( ! acm_compile(res->m) ) {
+		goto onError;
+	}
+	return res;
+onError:
+	free(utf8);
+	matchRulesDelete(res);
+	return NULL;
+}
+
+
+/**
+ * Deletes the given compiled output rules.
+ *
+ * @param[in,out] rules - rules to delete
+ */
+void matchRulesDelete(tMatchRules * rules) {
+	if (rules == NULL) {
+		return;
+	}
+	acm_delete(rules->m);
+	for (size_t i = 0; i < ACM_MAX_PATTERNS; ++i) {
+		wStrDelete(&(rules->pattern[i]));
+	}
+	free(rules);
+}
+
+
+/**
+ * Matches the output rules of the given item against the next raw output
+ * chunk of its signing application. Matches spanning multiple chunks are
+ * found as well. The whole output is matched even if the item output is
+ * truncated.
+ *
+ * @param[in,out] item - item of the running signing application
+ * @param[in,out] state - matching state; `ACM_START` for the first chunk
+ * @param[in] data - output chunk
+ * @param[in] len - length of `data` in bytes
+ */
+void matchOutput(tProcCtx * item, uint32_t * state, const uint8_t * data, const size_t len) {
+	if (item == NULL || item->config == NULL || item->config->rules == NULL) {
+		return;
+	}
+	item->matched |= acm_feed(item->config->rules->m, state, data, len);
+}
+
+
+/**
+ * Applies the matched output rules of the given item. A note about each
+ * matched rule is appended to the item output. The state of the first
+ * matched rule with a state replaces the given final state if it was derived
+ * from the exit code.
+ *
+ * @param[in,out] item - finished item
+ * @param[in] state - final item state from the exit code
+ * @return final item state
+ */
+tProcState matchApply(tProcCtx * item, const tProcState state) {
+	if (item == NULL || item->matched == 0 || item->config == NULL || item->config->rules == NULL) {
+		return state;
+	}
+	const tMatchRules * rules = item->config->rules;
+	tProcState res = state;
+	bool replaced = ! (state == PST_OK || state == PST_FAIL);
+	bool first = true;
+	const size_t from = (item->output != NULL) ? usb_len(item->output) : 0;
+	for (size_t i = 0; i < rules->count; ++i) {
+		if ((item->matched & (UINT64_C(1) << i)) == 0) {
+			continue;
+		}
+		if (item->output != NULL) {
+			usb_addFmt(
+				item->output,
+				L"%s\r\nOutput rule \"%s\" matched.",
+				first ? L"\r\n--------------------------------------------------------------------------------" : L"",
+				rules->pattern[i]
+			);
+			first = false;
+		}
+		if (( ! replaced ) && rules->state[i] != PST_IDLE) {
+			res = rules->state[i];
+			replaced = true;
+		}
+	}
+	engineStampAppended(item, from);
+	return res;
+}
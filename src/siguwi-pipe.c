@@ -0,0 +1,202 @@
+/**
+ * @file siguwi-pipe.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Resets the given pipe set to unset handles.
+ *
+ * @param[out] set - pipe set
+ */
+static void pipeSetInit(tPipeSet * set) {
+	set->hOutRead = INVALID_HANDLE_VALUE;
+	set->hOutWrite = INVALID_HANDLE_VALUE;
+	set->hInRead = INVALID_HANDLE_VALUE;
+	set->hInWrite = INVALID_HANDLE_VALUE;
+}
+
+
+/**
+ * Creates a new set of connected child process pipes. Both output pipe ends
+ * are opened by this process. Hence, the connection completes while opening
+ * the child process end and no wait is needed. All handles are created
+ * non-inheritable.
+ *
+ * @param[in,out] pool - pipe pool
+ * @param[out] set - receives the pipe set
+ * @return `true` on success, else `false` with the error code in `GetLastError()`
+ */
+static bool pipeSetCreate(tPipePool * pool, tPipeSet * set) {
+	wchar_t pipeName[128];
+	OVERLAPPED ovConn;
+	ULONG pid = 0;
+	DWORD n = 0;
+	DWORD err = ERROR_SUCCESS;
+	pipeSetInit(set);
+	ZeroMemory(&ovConn, sizeof(ovConn));
+	ovConn.hEvent = pool->hEvent;
+	ResetEvent(pool->hEvent);
+	snwprintf(pipeName, ARRAY_SIZE(pipeName), L"%s%lu", pool->prefix, ++(pool->serial));
+	/* create named pipe to read the process output */
+	set->hOutRead = CreateNamedPipeW(pipeName, PIPE_ACCESS_INBOUND | FILE_FLAG_FIRST_PIPE_INSTANCE | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, MAX_CONFIG_STR_LEN, MAX_CONFIG_STR_LEN, 0, NULL);
+	if (set->hOutRead == INVALID_HANDLE_VALUE) {
+		goto onError;
+	}
+	/* start connecting our end */
+	if ( ! ConnectNamedPipe(set->hOutRead, &ovConn) ) {
+		err = GetLastError();
+		if (err != ERROR_IO_PENDING && err != ERROR_PIPE_CONNECTED) {
+			goto onError;
+		}
+	}
+	/* create child process end of the pipe */
+	set->hOutWrite = CreateFileW(pipeName, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+	if (set->hOutWrite == INVALID_HANDLE_VALUE) {
+		if (err == ERROR_IO_PENDING) {
+			CancelIo(set->hOutRead);
+			GetOverlappedResult(set->hOutRead, &ovConn, &n, TRUE);
+		}
+		goto onError;
+	}
+	/* the pending connect completed while opening the other end unless someone else connected first */
+	if (err == ERROR_IO_PENDING && ( ! GetOverlappedResult(set->hOutRead, &ovConn, &n, FALSE) )) {
+		if (GetLastError() == ERROR_IO_INCOMPLETE) {
+			CancelIo(set->hOutRead);
+			GetOverlappedResult(set->hOutRead, &ovConn, &n, TRUE);
+			SetLastError(ERROR_PIPE_BUSY);
+		}
+		goto onError;
+	}
+	/* check if we are really connected with ourself */
+	if ( ! GetNamedPipeClientProcessId(set->hOutRead, &pid) ) {
+		goto onError;
+	}
+	if ((ULONG)GetCurrentProcessId() != pid) {
+		SetLastError(ERROR_ACCESS_DENIED);
+		goto onError; /* we got hijacked */
+	}
+	if ( ! GetNamedPipeClientProcessId(set->hOutWrite, &pid) ) {
+		goto onError;
+	}
+	if ((ULONG)GetCurrentProcessId() != pid) {
+		SetLastError(ERROR_ACCESS_DENIED);
+		goto onError; /* we got hijacked */
+	}
+	/* create anonymous pipe to write to the process input */
+	if ( ! CreatePipe(&(set->hInRead), &(set->hInWrite), NULL, 0) ) {
+		goto onError;
+	}
+	return true;
+onError:
+	err = GetLastError();
+	pipeSetClose(set);
+	SetLastError(err);
+	return false;
+}
+
+
+/**
+ * Initializes the given child process pipe pool. The pipe names are unique
+ * per pool and not guessable in advance.
+ *
+ * @param[out] pool - pipe pool
+ * @return `true` on success, else `false` with the error code in `GetLastError()`
+ */
+bool pipePoolInit(tPipePool * pool) {
+	if (pool == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return false;
+	}
+	ZeroMemory(pool, sizeof(*pool));
+	GUID guid;
+	wchar_t guidStr[40];
+	if (CoCreateGuid(&guid) != S_OK || StringFromGUID2(&guid, guidStr, (int)ARRAY_SIZE(guidStr)) == 0) {
+		SetLastError(ERROR_INVALID_FUNCTION);
+		return false;
+	}
+	snwprintf(pool->prefix, ARRAY_SIZE(pool->prefix), L"\\\\.\\pipe\\siguwi-read-%s-", guidStr);
+	pool->hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	return pool->hEvent != NULL;
+}
+
+
+/**
+ * Creates pipe sets until the pool holds `PIPE_POOL_SIZE` sets. This is meant
+ * to be called while a signing application runs to keep the next start fast.
+ *
+ * @param[in,out] pool - pipe pool
+ * @return `true` on success, else `false` with the error code in `GetLastError()`
+ */
+bool pipePoolFill(tPipePool * pool) {
+	if (pool == NULL || pool->hEvent == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return false;
+	}
+	while (pool->count < PIPE_POOL_SIZE) {
+		if ( ! pipeSetCreate(pool, pool->set + pool->count) ) {
+			return false;
+		}
+		++(pool->count);
+	}
+	return true;
+}
+
+
+/**
+ * Takes a ready pipe set from the pool. A new one is created if the pool is
+ * empty. The caller owns the returned handles.
+ *
+ * @param[in,out] pool - pipe pool
+ * @param[out] set - receives the pipe set
+ * @return `true` on success, else `false` with the error code in `GetLastError()`
+ */
+bool pipePoolTake(tPipePool * pool, tPipeSet * set) {
+	if (pool == NULL || set == NULL || pool->hEvent == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return false;
+	}
+	if (pool->count == 0) {
+		return pipeSetCreate(pool, set);
+	}
+	--(pool->count);
+	*set = pool->set[pool->count];
+	pipeSetInit(pool->set + pool->count);
+	return true;
+}
+
+
+/**
+ * Closes all handles of the given pipe set.
+ *
+ * @param[in,out] set - pipe set
+ */
+void pipeSetClose(tPipeSet * set) {
+	if (set == NULL) {
+		return;
+	}
+	closeHandlePtr(&(set->hOutRead), INVALID_HANDLE_VALUE);
+	closeHandlePtr(&(set->hOutWrite), INVALID_HANDLE_VALUE);
+	closeHandlePtr(&(set->hInRead), INVALID_HANDLE_VALUE);
+	closeHandlePtr(&(set->hInWrite), INVALID_HANDLE_VALUE);
+}
+
+
+/**
+ * Closes all pooled pipe sets and frees the pool resources.
+ *
+ * @param[in,out] pool - pipe pool
+ */
+void pipePoolDelete(tPipePool * pool) {
+	if (pool == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < pool->count; ++i) {
+		pipeSetClose(pool->set + i);
+	}
+	pool->count = 0;
+	closeHandlePtr(&(pool->hEvent), NULL);
+}
@@ -2,7 +2,7 @@
  * @file siguwi-process.c
  * @author Daniel Starke
  * @date 2025-06-25
- * @version 2025-10-21
+ * @version 2026-10-18
  */
 #include "siguwi.h"
 
@@ -54,6 +54,16 @@ int procCtxDelete(const size_t index, tProcCtx * data, void * param) {
 		usb_delete(data->output);
 		data->output = NULL;
 	}
+	outputBlobDelete(data->blob);
+	data->blob = NULL;
+	archiveRelease(data->archive);
+	data->archive = NULL;
+	if (data->lineTimes != NULL) {
+		vec_delete(data->lineTimes);
+		data->lineTimes = NULL;
+	}
+	scanRelease(data->tree);
+	data->tree = NULL;
 	return 1;
 }
 
@@ -63,11 +73,12 @@ int procCtxDelete(const size_t index, tProcCtx * data, void * param) {
  *
  * @param[in] hPipe - piper handle
  * @param[in] c - INI configuration
+ * @param[in] configUrl - INI file to resolve the signing chain of `c` or `NULL`
  * @param[in] argc - number of files to sign
  * @param[in] argv - list of files to sign
  * @return `true` on success, else `false`
  */
-bool ipcSendReqToServer(HANDLE hPipe, const tIniConfig * c, int argc, wchar_t ** argv) {
+bool ipcSendReqToServer(HANDLE hPipe, const tIniConfig * c, const wchar_t * configUrl, int argc, wchar_t ** argv) {
 	if (hPipe == INVALID_HANDLE_VALUE || c == NULL || argc == 0 || argv == 0 || argv[0] == NULL) {
 		SetLastError(ERROR_INVALID_HANDLE);
 		return false;
@@ -83,6 +94,16 @@ bool ipcSendReqToServer(HANDLE hPipe, const tIniConfig * c, int argc, wchar_t **
 	res = res && WriteFile(hPipe, c->cert->cardReader, bytesToWrite, &bytesWritten, NULL) && bytesWritten >= bytesToWrite;
 	bytesToWrite = (DWORD)((wcslen(c->signApp->ptr) + 1) * sizeof(wchar_t));
 	res = res && WriteFile(hPipe, c->signApp->ptr, bytesToWrite, &bytesWritten, NULL) && bytesWritten >= bytesToWrite;
+	const wchar_t * match = (c->match != NULL) ? c->match : L"";
+	bytesToWrite = (DWORD)((wcslen(match) + 1) * sizeof(wchar_t));
+	res = res && WriteFile(hPipe, match, bytesToWrite, &bytesWritten, NULL) && bytesWritten >= bytesToWrite;
+	/* transmit signing chain */
+	const wchar_t * chain = (c->chain != NULL && configUrl != NULL) ? c->chain : L"";
+	const wchar_t * chainFile = (*chain != 0) ? configUrl : L"";
+	bytesToWrite = (DWORD)((wcslen(chainFile) + 1) * sizeof(wchar_t));
+	res = res && WriteFile(hPipe, chainFile, bytesToWrite, &bytesWritten, NULL) && bytesWritten >= bytesToWrite;
+	bytesToWrite = (DWORD)((wcslen(chain) + 1) * sizeof(wchar_t));
+	res = res && WriteFile(hPipe, chain, bytesToWrite, &bytesWritten, NULL) && bytesWritten >= bytesToWrite;
 	/* transmit file list */
 	for (int i = 0; i < argc; ++i) {
 		wchar_t * path = argv[i];
@@ -102,7 +123,7 @@ bool ipcSendReqToServer(HANDLE hPipe, const tIniConfig * c, int argc, wchar_t **
  *
  * @param[in,out] ctx - IPC context
  * @return `true` on success, else `false`
- * @remarks Shows an message box on error.
+ * @remarks Adds a non-modal notification on error.
  */
 bool ipcListen(tIpcWndCtx * ctx) {
 	if (ctx == NULL) {
@@ -118,11 +139,12 @@ bool ipcListen(tIpcWndCtx * ctx) {
 	rws_release(&(ctx->cfg.signApp));
 	rcIniConfigBaseDelete(ctx->cfgBase);
 	ctx->cfgBase = NULL;
+	wStrDelete(&(ctx->cfgUrl));
 	/* start listening for clients */
 	BOOL res = ConnectNamedPipe(ctx->hPipe, &(ctx->ovClient));
 	DWORD err = GetLastError();
 	if (( ! res ) && err != ERROR_IO_PENDING && err != ERROR_PIPE_CONNECTED) {
-		showFmtMsg(ctx->hWnd, MB_OK | MB_ICONERROR, L"Error (ipcListen)", errStr[ERR_ASYNC_LISTEN], err);
+		processNotify(ctx, NULL, L"ipcListen", errStr[ERR_ASYNC_LISTEN], err);
 		return false;
 	} else if (err == ERROR_PIPE_CONNECTED) {
 		return ipcReadAsync(ctx);
@@ -132,6 +154,26 @@ bool ipcListen(tIpcWndCtx * ctx) {
 }
 
 
+/**
+ * Drops the current IPC client and starts listening for the next one.
+ * Stops accepting IPC clients if this fails to keep processing the already
+ * queued items.
+ *
+ * @param[in,out] ctx - IPC context
+ */
+void ipcRestart(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->hPipe == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	DisconnectNamedPipe(ctx->hPipe);
+	if ( ! ipcListen(ctx) ) {
+		processNotify(ctx, NULL, L"ipcRestart", L"%s", errStr[ERR_IPC_DISABLED]);
+		ctx->waitForClient = false;
+		closeHandlePtr(&(ctx->hPipe), INVALID_HANDLE_VALUE);
+	}
+}
+
+
 /**
  * Checks whether the connected peer of the given named pipe has the same image
  * path as this application.
@@ -168,7 +210,7 @@ onError:
  *
  * @param[in,out] ctx - IPC context
  * @return `true` on success, else `false`
- * @remarks Shows an message box on error.
+ * @remarks Adds a non-modal notification on error.
  */
 bool ipcReadAsync(tIpcWndCtx * ctx) {
 	if (ctx == NULL) {
@@ -179,7 +221,7 @@ bool ipcReadAsync(tIpcWndCtx * ctx) {
 	if ( ! ReadFileEx(ctx->hPipe, ctx->buf + ctx->bufLen, (DWORD)(sizeof(ctx->buf) - ctx->bufLen), &(ctx->ovRead), ipcHandleReadComplete) ) {
 		const DWORD err = GetLastError();
 		if (err != ERROR_BROKEN_PIPE) {
-			showFmtMsg(ctx->hWnd, MB_OK | MB_ICONERROR, L"Error (ipcReadAsync)", errStr[ERR_ASYNC_READ], err);
+			processNotify(ctx, NULL, L"ipcReadAsync", errStr[ERR_ASYNC_READ], err);
 		}
 		return false;
 	}
@@ -196,11 +238,11 @@ bool ipcReadAsync(tIpcWndCtx * ctx) {
  */
 void CALLBACK ipcHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytesTransfered, LPOVERLAPPED lpOverlapped) {
 	if (lpOverlapped == NULL) {
-		MessageBoxW(NULL, errStr[ERR_INVALID_ARG], L"Error (ipcHandleReadComplete)", MB_OK | MB_ICONERROR);
 		return;
 	}
 	tIpcWndCtx * ctx = CONTAINER_OF(lpOverlapped, tIpcWndCtx, ovRead);
 	wchar_t * file = NULL;
+	TRACE_BEGIN("ipc", "receive");
 	if (dwErrorCode == 0 && dwNumberOfBytesTransfered > 0) {
 		ctx->bufLen += (size_t)dwNumberOfBytesTransfered;
 		/* handle data received in `ctx->buf` */
@@ -228,13 +270,32 @@ void CALLBACK ipcHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytesTran
 				field = &(ctx->cfg.cert->cardReader);
 				break;
 			case IST_SIGN_APP:
-				ctx->state = IST_FILE;
-				ctx->cfg.cert->certProv = getCspFromCardNameW(ctx->cfg.cert->cardName);
-				ctx->cfgBase = rcIniConfigBaseCreate(ctx->cfg.cert);
+				ctx->state = IST_MATCH;
 				ctx->cfg.signApp = rws_create(start);
-				if (ctx->cfg.cert->certProv == NULL || ctx->cfgBase == NULL || ctx->cfg.signApp == NULL) {
-					MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (ipcHandleReadComplete)", MB_OK | MB_ICONERROR);
-					goto onError;
+				if (ctx->cfg.signApp == NULL) {
+					processNotify(ctx, NULL, L"ipcHandleReadComplete", L"%s", errStr[ERR_OUT_OF_MEMORY]);
+					goto onProtocolError;
+				}
+				break;
+			case IST_MATCH:
+				ctx->state = IST_CONFIG_FILE;
+				recordEvent(ctx->rec, RPL_REQUEST, 0, RPS_IPC, 0);
+				ctx->cfg.cert->certProv = getCspFromCardNameW(ctx->cfg.cert->cardName);
+				ctx->cfgBase = rcIniConfigBaseCreate(ctx->cfg.cert, start);
+				if (ctx->cfg.cert->certProv == NULL || ctx->cfgBase == NULL) {
+					processNotify(ctx, NULL, L"ipcHandleReadComplete", L"%s", errStr[ERR_OUT_OF_MEMORY]);
+					goto onProtocolError;
+				}
+				break;
+			case IST_CONFIG_FILE:
+				ctx->state = IST_CHAIN;
+				field = &(ctx->cfgUrl);
+				break;
+			case IST_CHAIN:
+				ctx->state = IST_FILE;
+				if (*start != 0 && ( ! iniConfigChain(ctx->cfgUrl, ctx->cfgBase, start) )) {
+					processNotify(ctx, NULL, L"ipcHandleReadComplete", L"%s: %s", ctx->cfgUrl, errStr[lastErr]);
+					goto onProtocolError;
 				}
 				break;
 			case IST_FILE:
@@ -255,14 +316,12 @@ void CALLBACK ipcHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytesTran
 				continue;
 			}
 			if (*field == NULL) {
-				MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (ipcHandleReadComplete)", MB_OK | MB_ICONERROR);
-				goto onError;
+				processNotify(ctx, NULL, L"ipcHandleReadComplete", L"%s", errStr[ERR_OUT_OF_MEMORY]);
+				goto onProtocolError;
 			}
 			if (file != NULL) {
-				/* add file */
-				if ( ! processAddFile(ctx, ctx->cfgBase, ctx->cfg.signApp, file) ) {
-					goto onError;
-				}
+				/* add file (errors are reported by `processAddFile()` and do not affect following files) */
+				processAddFile(ctx, ctx->cfgBase, ctx->cfg.signApp, file, NULL, NULL);
 			}
 		}
 		/* read next chunk */
@@ -274,280 +333,178 @@ void CALLBACK ipcHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytesTran
 		goto onProtocolError;
 	}
 	wStrDelete(&file);
+	TRACE_END("ipc", "receive");
 	return;
 onProtocolError:
 	wStrDelete(&file);
-	DisconnectNamedPipe(ctx->hPipe);
-	if ( ! ipcListen(ctx) ) {
-		goto onError;
-	}
-	return;
-onError:
-	wStrDelete(&file);
-	closeHandlePtr(&(ctx->hPipe), INVALID_HANDLE_VALUE);
+	ipcRestart(ctx);
+	TRACE_END("ipc", "receive");
 }
 
 
 /**
- * Starts processing the currently selected item.
+ * Returns the process context of the given lane.
  *
- * @param[in,out] ctx - process context
- * @return `true` if started successfully, else `false`
+ * @param[in] lane - signing process lane
+ * @return process context
  */
-bool processStart(tIpcWndCtx * ctx) {
-	if (ctx == NULL  || ctx->proc == NULL || ctx->proc->config == NULL || ctx->proc->signApp == NULL || ctx->proc->state != PST_IDLE) {
-		return false;
-	}
-	tProcState newState = PST_FAIL;
-	/* build read pipe name */
-	GUID guid;
-	CoCreateGuid(&guid);
-	wchar_t pipeName[128];
-	RPC_WSTR guidStr;
-	if (UuidToStringW(&guid, &guidStr) != RPC_S_OK) {
-		goto onEarlyError;
-	}
-	newState = PST_BROKEN_PIPE;
-	snwprintf(pipeName, ARRAY_SIZE(pipeName), L"\\\\.\\pipe\\siguwi-read-%s", guidStr);
-	RpcStringFreeW(&guidStr);
-	/* create named pipe to reading process output */
-	ULONG pid = 0;
-	OVERLAPPED ovConn;
-	PROCESS_INFORMATION pi;
-	STARTUPINFO si;
-	SECURITY_ATTRIBUTES sa = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
-	HANDLE hPipeWrite = INVALID_HANDLE_VALUE;
-	HANDLE hPipeInRead = INVALID_HANDLE_VALUE;
-	HANDLE hPipeInWrite = INVALID_HANDLE_VALUE;
-	tUStrBuf * cmdBuf = NULL;
-	wchar_t * cmd = NULL;
-	ctx->hProc = NULL;
-	ctx->hProcRead = INVALID_HANDLE_VALUE;
-	DATA_BLOB * pin = NULL;
-	DATA_BLOB rawPin;
-	char * utf8Pin = NULL;
-	ZeroMemory(&ovConn, sizeof(ovConn));
-	ZeroMemory(&rawPin, sizeof(rawPin));
-	ctx->hProcRead = CreateNamedPipeW(pipeName, PIPE_ACCESS_INBOUND | FILE_FLAG_FIRST_PIPE_INSTANCE | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, MAX_CONFIG_STR_LEN, MAX_CONFIG_STR_LEN, 0, NULL);
-	if (ctx->hProcRead == INVALID_HANDLE_VALUE) {
-		goto onEarlyError;
-	}
-	/* start connecting our end */
-	ovConn.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-	if ( ! ConnectNamedPipe(ctx->hProcRead, &ovConn) ) {
-		const DWORD err = GetLastError();
-		if (err == ERROR_PIPE_CONNECTED) {
-			SetEvent(ovConn.hEvent);
-		} else if (err != ERROR_IO_PENDING) {
-			goto onError;
-		}
-	}
-	/* create child process end of the pipe */
-	hPipeWrite = CreateFile(pipeName, GENERIC_WRITE, 0, &sa, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
-	if (hPipeWrite == INVALID_HANDLE_VALUE) {
-		goto onError;
-	}
-	/* wait for both ends to connect */
-	if (WaitForSingleObject(ovConn.hEvent, INFINITE) == WAIT_FAILED) {
-		goto onError;
-	}
-	closeHandlePtr(&(ovConn.hEvent), INVALID_HANDLE_VALUE);
-	/* check if we are really connected with ourself */
-	if ( ! GetNamedPipeClientProcessId(ctx->hProcRead, &pid) ) {
-		goto onError;
-	}
-	if ((ULONG)GetCurrentProcessId() != pid) {
-		goto onError; /* we got hijacked */
-	}
-	if ( ! GetNamedPipeClientProcessId(hPipeWrite, &pid) ) {
-		goto onError;
-	}
-	if ((ULONG)GetCurrentProcessId() != pid) {
-		goto onError; /* we got hijacked */
-	}
-	/* create anonymous pipe to write to the process input */
-	if ( ! CreatePipe(&hPipeInRead, &hPipeInWrite, &sa, 0) ) {
-		goto onError;
-	}
-	SetHandleInformation(ctx->hProcRead, HANDLE_FLAG_INHERIT, 0);
-	SetHandleInformation(hPipeInWrite, HANDLE_FLAG_INHERIT, 0);
-	/* get and cache pin */
-	newState = PST_PIN_WRONG;
-	pin = hto_addKey(ctx->h, ctx->proc->config);
-	if (pin == NULL) {
-		goto onError;
-	}
-	if (pin->pbData == NULL) {
-		if ( ! iniConfigGetPin(ctx->proc->config->cert, ctx->hWnd, pin) ) {
-			newState = PST_PIN_MISSING;
-			goto onError;
-		}
-		if (pin->pbData == NULL) {
-			goto onError;
-		}
-	}
-	/* decode pin */
-	if ( ! CryptUnprotectData(pin, NULL, NULL, NULL, NULL, 0, &rawPin) ) {
-		goto onError;
-	}
-	if (rawPin.pbData == NULL || rawPin.cbData < 2 || *(const wchar_t *)(rawPin.pbData + rawPin.cbData - 2) != 0) {
-		goto onError;
-	}
-	/* build complete command-line */
-	newState = PST_FAIL;
-	cmdBuf = usb_create(1024);
-	if (cmdBuf == NULL) {
-		goto onError;
-	}
-	bool esc = false;
-	bool hasPinArg = false;
-	for (const wchar_t * ptr = ctx->proc->signApp->ptr; *ptr != 0; ++ptr) {
-		if ( esc ) {
-			esc = false;
-			switch (*ptr) {
-			case L'1':
-				if (usb_add(cmdBuf, ctx->proc->path) == 0) {
-					goto onError;
-				}
-				continue;
-			case L'2':
-				if (usb_add(cmdBuf, (const wchar_t *)(rawPin.pbData)) <= 0) {
-					goto onError;
-				}
-				hasPinArg = true;
-				continue;
-			default:
-				break;
-			}
-		} else if (*ptr == L'%') {
-			esc = true;
+static tIpcWndCtx * processLaneCtx(tProcLane * lane) {
+	return CONTAINER_OF(lane - lane->step, tIpcWndCtx, lanes);
+}
+
+
+/**
+ * Checks whether the token of the given item is used by an item running in
+ * another lane. Signing steps on the same token are not run concurrently.
+ *
+ * @param[in] ctx - process context
+ * @param[in] lane - lane to start the item in
+ * @param[in] proc - item to start
+ * @return `true` if the token is busy, else `false`
+ */
+static bool processTokenBusy(const tIpcWndCtx * ctx, const tProcLane * lane, const tProcCtx * proc) {
+	for (size_t k = 0; k < MAX_CHAIN_STEPS; ++k) {
+		const tProcLane * other = ctx->lanes + k;
+		if (other == lane || other->proc == NULL || other->proc->state != PST_RUNNING) {
 			continue;
 		}
-		if (usb_addC(cmdBuf, *ptr) == 0) {
-			goto onError;
+		if (wcscmp(other->proc->config->cert->cardReader, proc->config->cert->cardReader) == 0) {
+			return true;
 		}
 	}
-	if ( hasPinArg ) {
-		/* free pin */
-		SecureZeroMemory(rawPin.pbData, rawPin.cbData);
-		LocalFree(rawPin.pbData);
-		ZeroMemory(&rawPin, sizeof(rawPin));
+	return false;
+}
+
+
+/**
+ * Passes the current item of the given lane on to the next signing step of its
+ * configuration chain. The item output is continued by the next step.
+ *
+ * @param[in,out] ctx - process context
+ * @param[in,out] lane - lane which finished the current signing step of its item successfully
+ * @return `true` if passed on, `false` if this was the last signing step
+ */
+static bool processAdvance(tIpcWndCtx * ctx, tProcLane * lane) {
+	if ( ! engineLaneAdvance(lane) ) {
+		return false;
 	}
-	/* get complete command-line as string */
-	cmd = usb_get(cmdBuf);
-	if (cmd == NULL) {
-		goto onError;
+	tProcCtx * proc = lane->proc;
+	processSetState(ctx, proc, PST_IDLE);
+	tProcLane * nextLane = ctx->lanes + proc->step;
+	if (lane->vi < nextLane->next) {
+		nextLane->next = lane->vi;
 	}
-	usb_wipe(cmdBuf);
-	usb_delete(cmdBuf);
-	cmdBuf = NULL;
-	/* create child process */
-	ZeroMemory(&si, sizeof(si));
-	si.cb          = sizeof(si);
-	si.dwFlags     = STARTF_USESHOWWINDOW | STARTF_USESTDHANDLES;
-	si.wShowWindow = SW_HIDE;
-	si.hStdInput   = hPipeInRead;
-	si.hStdOutput  = hPipeWrite;
-	si.hStdError   = hPipeWrite;
-	if ( ! CreateProcessW(NULL, cmd, NULL, NULL, TRUE, 0, NULL, exeDir, &si, &pi) ) {
-		newState = PST_APP_NOT_FOUND;
-		goto onError;
+	return true;
+}
+
+
+/**
+ * Starts processing the currently selected item of the given lane. Following
+ * signing steps keep the processing stages of the first one.
+ *
+ * @param[in,out] ctx - process context
+ * @param[in,out] lane - signing process lane
+ * @return `true` if started successfully, else `false`
+ */
+bool processStart(tIpcWndCtx * ctx, tProcLane * lane) {
+	if (ctx == NULL || lane == NULL || lane->proc == NULL || lane->proc->config == NULL || lane->proc->signApp == NULL || lane->proc->state != PST_IDLE) {
+		return false;
 	}
-	/* free used command-line string */
-	SecureZeroMemory(cmd, wcslen(cmd) * sizeof(wchar_t));
-	free(cmd);
-	cmd = NULL;
-	/* close handles that got passed to the child process */
-	closeHandlePtr(&hPipeInRead, INVALID_HANDLE_VALUE);
-	closeHandlePtr(&hPipeWrite, INVALID_HANDLE_VALUE);
-	closeHandlePtr(&(pi.hThread), NULL);
-	ctx->hProc = pi.hProcess;
-	/* pass UTF-8 pin */
-	if ( ! hasPinArg ) {
-		newState = PST_PIN_MISSING;
-		utf8Pin = wToUtf8((const wchar_t *)(rawPin.pbData));
-		if (utf8Pin == NULL) {
-			goto onError;
-		}
-		const DWORD utf8Len = (DWORD)strlen(utf8Pin);
-		DWORD bytesWritten;
-		if (WriteFile(hPipeInWrite, utf8Pin, utf8Len, &bytesWritten, NULL) == 0 || bytesWritten != utf8Len) {
-			goto onError;
-		}
-		FlushFileBuffers(hPipeInWrite);
-		/* free UTF-8 pin */
-		SecureZeroMemory(utf8Pin, strlen(utf8Pin));
-		free(utf8Pin);
-		utf8Pin = NULL;
-		/* free pin */
-		SecureZeroMemory(rawPin.pbData, rawPin.cbData);
-		LocalFree(rawPin.pbData);
-		ZeroMemory(&rawPin, sizeof(rawPin));
-	}
-	closeHandlePtr(&hPipeInWrite, INVALID_HANDLE_VALUE);
-	ZeroMemory(&(ctx->utf8), sizeof(ctx->utf8));
-	ctx->outputLen = 0;
-	ctx->lastChar = 0;
-	ctx->proc->state = PST_RUNNING;
-	if ( ! processReadAsync(ctx) ) {
-		processFinish(ctx);
+	tProcCtx * proc = lane->proc;
+	TRACE_BEGIN("process", "processStart");
+	const tProcState newState = engineLaneStart(&(ctx->pipes), ctx->h, lane, ctx->hWnd, exeDir);
+	if (newState != PST_RUNNING) {
+		const DWORD err = GetLastError();
+		processSetState(ctx, proc, newState);
+		processNotify(ctx, proc, L"processStart", errStr[ERR_START_PROCESS], procStateStr[newState], err);
+		TRACE_END("process", "processStart");
+		return false;
+	}
+	TRACE_INSTANT("process", "spawn", GetProcessId(lane->hProc));
+	recordEvent(ctx->rec, RPL_SPAWN, lane->vi, 0, 0);
+	processSetState(ctx, proc, PST_RUNNING);
+	TRACE_END("process", "processStart");
+	if ( ! processReadAsync(lane) ) {
+		processFinish(ctx, lane);
 		return processNext(ctx);
 	}
+	/* prepare the pipes of the next items while the signing application runs */
+	pipePoolFill(&(ctx->pipes));
 	return true;
-onError:
-	if (utf8Pin != NULL) {
-		SecureZeroMemory(utf8Pin, strlen(utf8Pin));
-		free(utf8Pin);
-	}
-	closeHandlePtr(&(ctx->hProc), NULL);
-	if (cmd != NULL) {
-		SecureZeroMemory(cmd, wcslen(cmd) * sizeof(wchar_t));
-		free(cmd);
-	}
-	if (cmdBuf != NULL) {
-		usb_wipe(cmdBuf);
-		usb_delete(cmdBuf);
-	}
-	if (rawPin.pbData != NULL) {
-		SecureZeroMemory(rawPin.pbData, rawPin.cbData);
-		LocalFree(rawPin.pbData);
-	}
-	closeHandlePtr(&hPipeInWrite, INVALID_HANDLE_VALUE);
-	closeHandlePtr(&hPipeInRead, INVALID_HANDLE_VALUE);
-	closeHandlePtr(&(ovConn.hEvent), INVALID_HANDLE_VALUE);
-	closeHandlePtr(&(ctx->hProcRead), INVALID_HANDLE_VALUE);
-	closeHandlePtr(&hPipeWrite, INVALID_HANDLE_VALUE);
-onEarlyError:
-	ctx->proc->state = newState;
-	return false;
 }
 
 
 /**
- * Select next item in queue and start processing it.
+ * Lane queue check for `processNext`.
+ */
+typedef struct {
+	tIpcWndCtx * ctx; /**< process context */
+	tProcLane * lane; /**< lane to start the item in */
+} tProcNextCheck;
+
+
+/**
+ * Checks whether the given item can be started in the lane of `param`. Items
+ * at the signing step of the lane wait while their token is busy.
+ *
+ * @param[in] i - item index
+ * @param[in,out] param - `tProcNextCheck`
+ * @return check result
+ */
+static tLaneQueueCheck processNextCheck(const size_t i, void * param) {
+	const tProcNextCheck * check = (const tProcNextCheck *)param;
+	const tProcCtx * proc = vec_at(check->ctx->v, i);
+	if (proc == NULL || proc->state != PST_IDLE || proc->step != check->lane->step) {
+		return LQ_SKIP;
+	}
+	return processTokenBusy(check->ctx, check->lane, proc) ? LQ_WAIT : LQ_TAKE;
+}
+
+
+/**
+ * Selects the next item in queue for each idle lane and starts processing it.
+ * A lane only takes items at its signing step whose token is not busy in
+ * another lane. Skipped items with a busy token are checked again later.
+ * A coordinator passes all pending items to its agents instead.
  *
  * @param[in,out] ctx - process context
  * @return `true` if started successfully, else `false`
  */
 bool processNext(tIpcWndCtx * ctx) {
-	if (ctx == NULL || ctx->v == NULL || (ctx->proc != NULL && ctx->proc->state == PST_RUNNING)) {
+	if (ctx == NULL || ctx->v == NULL) {
 		return false;
 	}
-	const size_t count = vec_size(ctx->v);
-	for (size_t i = ctx->vi; i < count; ++i) {
-		tProcCtx * proc = vec_at(ctx->v, i);
-		if (proc == NULL) {
-			return false;
+	bool res = false;
+	if (ctx->remote.count > 0) {
+		/* coordinator: the agents sign the files */
+		res = remoteDispatch(ctx);
+	} else {
+		/* later signing steps first to finish started items early */
+		for (size_t k = MAX_CHAIN_STEPS; k-- > 0; ) {
+			tProcLane * lane = ctx->lanes + k;
+			if (lane->proc != NULL && lane->proc->state == PST_RUNNING) {
+				continue;
+			}
+			tProcNextCheck check = {ctx, lane};
+			const size_t i = lq_take(&(lane->next), vec_size(ctx->v), processNextCheck, &check);
+			if (i == SIZE_MAX) {
+				continue;
+			}
+			lane->proc = vec_at(ctx->v, i);
+			lane->vi = i;
+			TRACE_INSTANT("process", "dispatch", i);
+			res = processStart(ctx, lane) || res;
+			processUpdateItem(ctx, lane->vi);
 		}
-		if (proc->state != PST_IDLE) {
-			continue;
+	}
+	processUpdateStatus(ctx);
+	if (ctx->stateCount[PST_IDLE] == 0 && ctx->stateCount[PST_RUNNING] == 0 && ctx->reportDirty && ctx->reportPath != NULL) {
+		/* batch end */
+		ctx->reportDirty = false;
+		if ( ! reportWrite(ctx, ctx->reportPath) ) {
+			processNotify(ctx, NULL, L"processNext", L"%s\n%s", errStr[ERR_CREATE_FILE], ctx->reportPath);
 		}
-		ctx->proc = proc;
-		ctx->vi = i;
-		break;
 	}
-	const bool res = processStart(ctx);
-	processUpdateItem(ctx, ctx->vi);
 	return res;
 }
 
@@ -555,18 +512,11 @@ bool processNext(tIpcWndCtx * ctx) {
 /**
  * Starts an asynchronous read operation on the open named pipe from the started process.
  *
- * @param[in,out] ctx - process context
+ * @param[in,out] lane - signing process lane
  * @return `true` on success, else `false`
  */
-bool processReadAsync(tIpcWndCtx * ctx) {
-	if (ctx == NULL || ctx->proc == NULL) {
-		return false;
-	}
-	ZeroMemory(&(ctx->ovProcRead), sizeof(ctx->ovProcRead));
-	if ( ! ReadFileEx(ctx->hProcRead, ctx->procBuf, (DWORD)sizeof(ctx->procBuf), &(ctx->ovProcRead), processHandleReadComplete) ) {
-		return false;
-	}
-	return true;
+bool processReadAsync(tProcLane * lane) {
+	return engineLaneRead(lane, processHandleReadComplete);
 }
 
 
@@ -581,54 +531,19 @@ void CALLBACK processHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytes
 	if (lpOverlapped == NULL) {
 		return;
 	}
-	tIpcWndCtx * ctx = CONTAINER_OF(lpOverlapped, tIpcWndCtx, ovProcRead);
-	if (dwErrorCode == 0 && dwNumberOfBytesTransfered > 0 && ctx->proc && ctx->proc->output) {
-		/* handle data received in `ctx->procBuf` */
-		const uint8_t * ptr = ctx->procBuf;
-		tUtf8Ctx * utf8 = &(ctx->utf8);
-		tUStrBuf * output = ctx->proc->output;
-		size_t * outputLen = &(ctx->outputLen);
-		uint32_t * lastChr = &(ctx->lastChar);
-		bool added = false;
-		for (DWORD i = 0; i < dwNumberOfBytesTransfered && *outputLen < PROCESS_MAX_OUTPUT; ++i) {
-			uint32_t cp = utf8_parse(utf8, ptr[i]);
-			if (cp == UTF8_MORE) {
-				continue;
-			}
-			if (cp > 0x10FFFF) {
-				cp = UTF8_ERROR;
-			}
-			if (cp < 0x10000) {
-				/* direct encoding */
-				if (cp == L'\n' && *lastChr != L'\r') {
-					/* fix line ending */
-					usb_addC(output, L'\r');
-				}
-				if (cp != 0) {
-					usb_addC(output, (wchar_t)cp);
-				}
-			} else {
-				/* surrogate pair encoding */
-				const uint32_t sp = (uint32_t)(cp - 0x10000);
-				usb_addC(output, (wchar_t)((sp >> 10) + 0xD800));
-				usb_addC(output, (wchar_t)((sp & 0x3FF) + 0xDC00));
-			}
-			*lastChr = cp;
-			++(*outputLen);
-			added = true;
-		}
-		/* update process list and output widget */
-		if ( added ) {
-			if (*outputLen >= PROCESS_MAX_OUTPUT) {
-				usb_add(output,
-					L"\r\n--------------------------------------------------------------------------------"
-					"\r\nThe output has been truncated here."
-				);
-			}
-			processUpdateItem(ctx, ctx->vi);
+	tProcLane * lane = CONTAINER_OF(lpOverlapped, tProcLane, ovProcRead);
+	tIpcWndCtx * ctx = processLaneCtx(lane);
+	if (dwErrorCode == 0 && dwNumberOfBytesTransfered > 0 && lane->proc && lane->proc->output) {
+		TRACE_INSTANT("process", "output", dwNumberOfBytesTransfered);
+		sessionLogOutput(ctx->log, lane->vi, lane->procBuf, (size_t)dwNumberOfBytesTransfered);
+		recordEvent(ctx->rec, RPL_OUTPUT, lane->vi, (uint32_t)dwNumberOfBytesTransfered, 0);
+		searchOutput(ctx, lane->vi, &(lane->searchState), lane->procBuf, (size_t)dwNumberOfBytesTransfered);
+		/* handle data received in `lane->procBuf` and update process list and output widget */
+		if ( engineLaneOutput(lane, (size_t)dwNumberOfBytesTransfered) ) {
+			processUpdateItem(ctx, lane->vi);
 		}
 		/* read next chunk */
-		if ( ! processReadAsync(ctx) ) {
+		if ( ! processReadAsync(lane) ) {
 			goto onError;
 		}
 	} else {
@@ -637,45 +552,45 @@ void CALLBACK processHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytes
 	}
 	return;
 onError:
-	processFinish(ctx);
+	processFinish(ctx, lane);
 	processNext(ctx);
 }
 
 
 /**
- * Waits for the child process termination and updates the process item status.
+ * Waits for the child process termination, records its resource usage, closes
+ * its handles and updates the process item status. An item with a following
+ * signing step is passed on to it instead of finishing. The resource usage of
+ * all signing steps is added up.
  *
  * @param[in,out] ctx - process context
+ * @param[in,out] lane - signing process lane
  * @return `true` on success, else `false`
  */
-bool processFinish(tIpcWndCtx * ctx) {
-	if (ctx == NULL || ctx->proc == NULL) {
+bool processFinish(tIpcWndCtx * ctx, tProcLane * lane) {
+	if (ctx == NULL || lane == NULL || lane->proc == NULL) {
 		return false;
 	}
-	if (WaitForSingleObject(ctx->hProc, INFINITE) == WAIT_FAILED) {
-		goto onError;
-	}
-	DWORD dwExitCode;
-	if ( ! GetExitCodeProcess(ctx->hProc, &dwExitCode) ) {
-		goto onError;
-	}
-	if (dwExitCode != 0) {
-		usb_addFmt(
-			ctx->proc->output,
-			L"\r\n--------------------------------------------------------------------------------"
-			"\r\nCommand failed with exit code %" PRIu32 ".",
-			(uint32_t)dwExitCode
-		);
-		goto onError;
-	}
-	ctx->proc->state = PST_OK;
-	ctx->proc = NULL;
-	processUpdateItem(ctx, ctx->vi);
-	return true;
-onError:
-	ctx->proc->state = PST_FAIL;
-	processUpdateItem(ctx, ctx->vi);
-	return false;
+	tProcCtx * proc = lane->proc;
+	TRACE_BEGIN("process", "processFinish");
+	const size_t appendFrom = (proc->output != NULL) ? usb_len(proc->output) : 0;
+	const tProcState state = engineLaneFinish(lane);
+	const bool reaped = proc->hasExitCode && proc->exitCode == 0;
+	if ( ! proc->hasExitCode ) {
+		processNotify(ctx, proc, L"processFinish", errStr[ERR_WAIT_PROCESS], GetLastError());
+	}
+	const bool advanced = (state == PST_OK) && processAdvance(ctx, lane);
+	/* exit code note, output rule matches and next signing step header; before the output is stored */
+	searchAppended(ctx, lane->vi, appendFrom);
+	if ( ! advanced ) {
+		processSetState(ctx, proc, state);
+	}
+	lane->proc = NULL;
+	processUpdateItem(ctx, lane->vi);
+	processUpdateStatus(ctx);
+	searchRefresh(ctx);
+	TRACE_END("process", "processFinish");
+	return reaped;
 }
 
 
@@ -687,55 +602,97 @@ onError:
  * @param[in] c - INI configuration base
  * @param[in] signApp - code signing application command-line
  * @param[in] path - path to the file to add (can be relative)
- * @return `true` on success, else `false` after showing an error message
+ * @param[in,out] archive - archive of the extracted file or `NULL`
+ * @param[in,out] tree - scanned directory tree of the file or `NULL`
+ * @return `true` on success, else `false` after adding a non-modal notification
+ * @remarks Archives are passed to `archiveAddFile()` and directories to
+ * `scanAddTree()` if `archive` and `tree` are `NULL`.
  */
-bool processAddFile(tIpcWndCtx * ctx, tRcIniConfigBase * c, tRcWStr * signApp, const wchar_t * path) {
-	if (ctx == NULL || c == NULL || signApp == NULL || path == NULL) {
-		showFmtMsg(ctx->hWnd, MB_OK | MB_ICONERROR, L"Error (processAddFile)", L"%s", errStr[ERR_INVALID_ARG]);
+bool processAddFile(tIpcWndCtx * ctx, tRcIniConfigBase * c, tRcWStr * signApp, const wchar_t * path, tArchive * archive, tTreeScan * tree) {
+	if (ctx == NULL) {
 		return false;
 	}
+	if (c == NULL || signApp == NULL || path == NULL) {
+		processNotify(ctx, NULL, L"processAddFile", L"%s", errStr[ERR_INVALID_ARG]);
+		return false;
+	}
+	if (archive == NULL && tree == NULL) {
+		if ( regIsArchive(path) ) {
+			return archiveAddFile(ctx, c, signApp, path);
+		}
+		if ( wDirExists(path) ) {
+			return scanAddTree(ctx, c, signApp, path);
+		}
+	}
 	tProcCtx * item = vec_pushBack(ctx->v);
-	if (ctx->proc != NULL) {
-		/* pointer may have been invalidated -> update it */
-		ctx->proc = vec_at(ctx->v, ctx->vi);
+	for (size_t k = 0; k < MAX_CHAIN_STEPS; ++k) {
+		if (ctx->lanes[k].proc != NULL) {
+			/* pointer may have been invalidated -> update it */
+			ctx->lanes[k].proc = vec_at(ctx->v, ctx->lanes[k].vi);
+		}
 	}
 	if (item == NULL) {
-		showFmtMsg(ctx->hWnd, MB_OK | MB_ICONERROR, L"Error (processAddFile)", L"%s", errStr[ERR_OUT_OF_MEMORY]);
+		processNotify(ctx, NULL, L"processAddFile", L"%s", errStr[ERR_OUT_OF_MEMORY]);
 		return false;
 	}
+	ZeroMemory(item, sizeof(*item));
+	reportStamp(item, PSG_QUEUED);
 	item->state = PST_IDLE;
 	item->config = rcIniConfigBaseClone(c);
 	item->signApp = rws_aquire(signApp);
 	item->path = wcsdup(path);
 	item->output = usb_create(4096);
+	item->archive = archiveAquire(archive);
+	item->tree = scanAquire(tree);
 	wToFullPath(&(item->path), true);
-	if (item->path == NULL) {
-		showFmtMsg(ctx->hWnd, MB_OK | MB_ICONERROR, L"Error (processAddFile)", L"%s", errStr[ERR_OUT_OF_MEMORY]);
+	if (item->path == NULL || item->output == NULL || ( ! processAddItem(ctx, item) )) {
+		processNotify(ctx, NULL, L"processAddFile", L"%s\n%s", errStr[ERR_OUT_OF_MEMORY], path);
+		/* remove incomplete item to keep the list view and vector indices in sync */
+		procCtxDelete(vec_size(ctx->v) - 1, item, NULL);
+		vec_popBack(ctx->v);
 		return false;
 	}
+	++(ctx->stateCount[PST_IDLE]);
+	TRACE_ASYNC_BEGIN("item", "item", item->stamp[PSG_QUEUED]);
+	sessionLogItem(ctx->log, vec_size(ctx->v) - 1, item->path);
+	recordEvent(ctx->rec, RPL_ITEM, vec_size(ctx->v) - 1, 0, 0);
 	if ( ! wFileExists(item->path) ) {
-		item->state = PST_FILE_NOT_FOUND;
-	}
-	if ( ! processAddItem(ctx, item) ) {
-		showFmtMsg(ctx->hWnd, MB_OK | MB_ICONERROR, L"Error (processAddFile)", L"%s", errStr[ERR_OUT_OF_MEMORY]);
-		return false;
+		processSetState(ctx, item, PST_FILE_NOT_FOUND);
+		processNotify(ctx, item, L"processAddFile", errStr[ERR_FILE_NOT_FOUND], item->path);
+		processUpdateItem(ctx, vec_size(ctx->v) - 1);
 	}
+	httpNotify(ctx);
 	processNext(ctx);
 	return true;
 }
 
 
 /**
- * Adds a new item to the process list widget.
+ * Returns the index of the given item within the process list.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[in] item - process item
+ * @return item index or `SIZE_MAX` if not found
+ */
+static size_t processItemIndex(const tIpcWndCtx * ctx, const tProcCtx * item) {
+	const tProcCtx * first = vec_at(ctx->v, 0);
+	if (first == NULL || item < first) {
+		return SIZE_MAX;
+	}
+	return (size_t)(item - first);
+}
+
+
+/**
+ * Inserts a row for the given item at the end of the process list widget. The
+ * row parameter holds the item index.
  *
  * @param[in] ctx - Window/IPC context
  * @param[in] item - item to add
+ * @param[in] i - item index
  * @return `true` on success, else `false`
  */
-bool processAddItem(const tIpcWndCtx * ctx, const tProcCtx * item) {
-	if (ctx == NULL || item == NULL) {
-		return false;
-	}
+static bool processInsertRow(const tIpcWndCtx * ctx, const tProcCtx * item, const size_t i) {
 	const int count = ListView_GetItemCount(ctx->hList);
 	LVITEMW lvi;
 	ZeroMemory(&lvi, sizeof(lvi));
@@ -743,7 +700,7 @@ bool processAddItem(const tIpcWndCtx * ctx, const tProcCtx * item) {
 	lvi.iItem = count;
 	lvi.iSubItem = PCI_FILE;
 	lvi.pszText = wFileName(item->path);
-	lvi.lParam = (LPARAM)item;
+	lvi.lParam = (LPARAM)i;
 	if (ListView_InsertItem(ctx->hList, &lvi) < 0) {
 		return false;
 	}
@@ -759,6 +716,146 @@ bool processAddItem(const tIpcWndCtx * ctx, const tProcCtx * item) {
 }
 
 
+/**
+ * Adds a new item to the process list widget. The item is not shown while the
+ * item list is filtered by an output search query as it has no output yet.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[in] item - item to add
+ * @return `true` on success, else `false`
+ */
+bool processAddItem(const tIpcWndCtx * ctx, const tProcCtx * item) {
+	if (ctx == NULL || item == NULL) {
+		return false;
+	}
+	const size_t i = processItemIndex(ctx, item);
+	if (i == SIZE_MAX) {
+		return false;
+	}
+	if (ctx->searchQuery != NULL) {
+		return true;
+	}
+	return processInsertRow(ctx, item, i);
+}
+
+
+/**
+ * Returns the process list widget row of the item with the given index.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[in] i - item index
+ * @return row or -1 if the item is not shown
+ */
+int processItemRow(const tIpcWndCtx * ctx, const size_t i) {
+	if (ctx == NULL || ctx->hList == NULL || i > INT_MAX) {
+		return -1;
+	}
+	if (ctx->searchQuery == NULL) {
+		return (i < (size_t)ListView_GetItemCount(ctx->hList)) ? (int)i : -1;
+	}
+	LVFINDINFOW lvfi;
+	ZeroMemory(&lvfi, sizeof(lvfi));
+	lvfi.flags = LVFI_PARAM;
+	lvfi.lParam = (LPARAM)i;
+	return ListView_FindItem(ctx->hList, -1, &lvfi);
+}
+
+
+/**
+ * Returns the index of the item shown in the given process list widget row.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[in] row - process list widget row
+ * @return item index or -1 if the row does not exist
+ */
+static int processRowItem(const tIpcWndCtx * ctx, const int row) {
+	if (row < 0) {
+		return -1;
+	}
+	LVITEMW lvi;
+	ZeroMemory(&lvi, sizeof(lvi));
+	lvi.mask = LVIF_PARAM;
+	lvi.iItem = row;
+	if ( ! ListView_GetItem(ctx->hList, &lvi) ) {
+		return -1;
+	}
+	return (int)(lvi.lParam);
+}
+
+
+/**
+ * Shows only the items flagged in the given list within the process list
+ * widget. The selected item remains selected if it is still shown.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in] hits - one flag per item or `NULL` to show all items
+ */
+void processFilterList(tIpcWndCtx * ctx, const uint8_t * hits) {
+	if (ctx == NULL || ctx->hList == NULL || ctx->v == NULL) {
+		return;
+	}
+	const int selList = ctx->selList;
+	const size_t count = vec_size(ctx->v);
+	SendMessageW(ctx->hList, WM_SETREDRAW, FALSE, 0);
+	ListView_DeleteAllItems(ctx->hList);
+	ctx->selList = -1;
+	for (size_t i = 0; i < count; ++i) {
+		if (hits == NULL || hits[i] != 0) {
+			const tProcCtx * item = vec_at(ctx->v, i);
+			if ( processInsertRow(ctx, item, i) ) {
+				processUpdateItem(ctx, i);
+			}
+		}
+	}
+	SendMessageW(ctx->hList, WM_SETREDRAW, TRUE, 0);
+	const int row = (selList >= 0) ? processItemRow(ctx, (size_t)selList) : -1;
+	if (row >= 0) {
+		ListView_SetItemState(ctx->hList, row, LVIS_SELECTED | LVIS_FOCUSED, LVIS_SELECTED | LVIS_FOCUSED);
+		ListView_EnsureVisible(ctx->hList, row, FALSE);
+	} else {
+		processUpdateNotes(ctx);
+	}
+	InvalidateRect(ctx->hList, NULL, TRUE);
+}
+
+
+/**
+ * Changes the processing state of the given item and keeps the per state item
+ * counters up-to-date. Final states record the done timestamp for the run
+ * report and move the item output to the compressed output store.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] item - item to modify
+ * @param[in] state - new processing state
+ */
+void processSetState(tIpcWndCtx * ctx, tProcCtx * item, const tProcState state) {
+	if (ctx == NULL || item == NULL || item->state == state) {
+		return;
+	}
+	if (ctx->stateCount[item->state] > 0) {
+		--(ctx->stateCount[item->state]);
+	}
+	++(ctx->stateCount[state]);
+	item->state = state;
+	sessionLogState(ctx->log, processItemIndex(ctx, item), item);
+	if (state != PST_IDLE && state != PST_RUNNING) {
+		reportStamp(item, PSG_DONE);
+		reportLiveAdd(ctx, item);
+		recordEvent(ctx->rec, RPL_EXIT, processItemIndex(ctx, item), item->hasExitCode ? (uint32_t)(item->exitCode) : UINT32_MAX, (uint32_t)state);
+		ctx->reportDirty = true;
+		outputStore(ctx->outputs, item);
+		TRACE_ASYNC_END("item", "item", item->stamp[PSG_QUEUED]);
+		if (item->archive != NULL) {
+			archiveItemDone(ctx, item);
+		}
+		if (item->tree != NULL) {
+			scanItemDone(ctx, item);
+		}
+	}
+	httpNotify(ctx);
+}
+
+
 /**
  * Adds the given file that was dragged to the process window to the process list.
  *
@@ -779,7 +876,7 @@ void processDragFile(tIpcWndCtx * ctx, HDROP hDrop, UINT i, wchar_t * buf, size_
 	}
 	if (DragQueryFileW(hDrop, i, ptr, n + 1) == n) {
 		ptr[n] = 0;
-		processAddFile(ctx, ctx->cmdlCfg, ctx->cmdlSignApp, ptr);
+		processAddFile(ctx, ctx->cmdlCfg, ctx->cmdlSignApp, ptr, NULL, NULL);
 	}
 	if (ptr != buf) {
 		free(ptr);
@@ -788,8 +885,31 @@ void processDragFile(tIpcWndCtx * ctx, HDROP hDrop, UINT i, wchar_t * buf, size_
 
 
 /**
- * Updates the result column in the process list widget for the item with the
- * given index.
+ * Formats the given number of bytes with a binary unit prefix.
+ *
+ * @param[out] buf - output buffer
+ * @param[in] len - output buffer size in number of characters
+ * @param[in] bytes - number of bytes
+ */
+static void processFmtBytes(wchar_t * buf, const size_t len, const uint64_t bytes) {
+	static const wchar_t * const units[] = {L"B", L"KiB", L"MiB", L"GiB", L"TiB"};
+	double value = (double)bytes;
+	size_t unit = 0;
+	for (; value >= 1024.0 && unit < (ARRAY_SIZE(units) - 1); ++unit) {
+		value /= 1024.0;
+	}
+	if (unit == 0) {
+		snwprintf(buf, len, L"%" PRIu64 L" B", bytes);
+	} else {
+		snwprintf(buf, len, L"%.1f %s", value, units[unit]);
+	}
+	buf[len - 1] = 0;
+}
+
+
+/**
+ * Updates the result and resource usage columns in the process list widget for
+ * the item with the given index.
  *
  * @param[in] ctx - Window/IPC context
  * @param[in] i - item index
@@ -803,10 +923,48 @@ bool processUpdateItem(const tIpcWndCtx * ctx, const size_t i) {
 	if (item == NULL) {
 		return false;
 	}
-	ListView_SetItemText(ctx->hList, (int)i, PCI_RESULT, procStateStr[item->state]);
+	const int row = processItemRow(ctx, i);
+	if (row >= 0) {
+		ListView_SetItemText(ctx->hList, row, PCI_RESULT, procStateStr[item->state]);
+	}
+	if (row >= 0 && item->hasUsage) {
+		wchar_t buf[64], readBuf[24], writeBuf[24];
+		const tProcUsage * u = &(item->usage);
+		snwprintf(buf, ARRAY_SIZE(buf), L"%.2f s", (double)(u->userUs + u->kernelUs) / 1000000.0);
+		buf[ARRAY_SIZE(buf) - 1] = 0;
+		ListView_SetItemText(ctx->hList, row, PCI_CPU, buf);
+		processFmtBytes(buf, ARRAY_SIZE(buf), u->peakWorkingSet);
+		ListView_SetItemText(ctx->hList, row, PCI_MEMORY, buf);
+		processFmtBytes(readBuf, ARRAY_SIZE(readBuf), u->readBytes);
+		processFmtBytes(writeBuf, ARRAY_SIZE(writeBuf), u->writeBytes);
+		snwprintf(buf, ARRAY_SIZE(buf), L"R %s / W %s", readBuf, writeBuf);
+		buf[ARRAY_SIZE(buf) - 1] = 0;
+		ListView_SetItemText(ctx->hList, row, PCI_IO, buf);
+	}
 	if (ctx->selList == (int)i) {
 		/* update output */
-		wchar_t * str = usb_get(item->output);
+		wchar_t * str = outputGet(item);
+		if (str != NULL && ctx->showLineTimes) {
+			wchar_t * stamped = outputAddLineTimes(item, str);
+			if (stamped != NULL) {
+				free(str);
+				str = stamped;
+			}
+		}
+		if (str != NULL && item->state != PST_OK && item->blob != NULL && item->blob->failures > 1) {
+			/* group failures with the same output */
+			tUStrBuf * sb = usb_create(4096);
+			if (sb != NULL && usb_addFmt(sb, L"This error \x00D7 %zu files\r\n\r\n", item->blob->failures) > 0 && usb_add(sb, str) > 0) {
+				wchar_t * grouped = usb_get(sb);
+				if (grouped != NULL) {
+					free(str);
+					str = grouped;
+				}
+			}
+			if (sb != NULL) {
+				usb_delete(sb);
+			}
+		}
 		if (str != NULL) {
 			const int oldLen = GetWindowTextLengthW(ctx->hInfo);
 			DWORD oldStart, oldEnd;
@@ -815,7 +973,7 @@ bool processUpdateItem(const tIpcWndCtx * ctx, const size_t i) {
 			SendMessageW(ctx->hInfo, WM_SETREDRAW, FALSE, 0);
 			SetWindowTextW(ctx->hInfo, str);
 			SendMessageW(ctx->hInfo, WM_SETREDRAW, TRUE, 0);
-			if (wasAtEnd && ctx->proc != NULL && i == ctx->vi) {
+			if (wasAtEnd && item->state == PST_RUNNING) {
 				const int newLen = GetWindowTextLengthW(ctx->hInfo);
 				SendMessageW(ctx->hInfo, EM_SETSEL, (WPARAM)newLen, (LPARAM)newLen);
 				SendMessageW(ctx->hInfo, EM_SCROLLCARET, 0, 0);
@@ -830,6 +988,257 @@ bool processUpdateItem(const tIpcWndCtx * ctx, const size_t i) {
 }
 
 
+/**
+ * Updates the processing summary in the status bar of the process window.
+ *
+ * @param[in] ctx - Window/IPC context
+ */
+void processUpdateStatus(const tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->hStatus == NULL || ctx->v == NULL) {
+		return;
+	}
+	const size_t total = vec_size(ctx->v);
+	const size_t pending = ctx->stateCount[PST_IDLE];
+	const size_t running = ctx->stateCount[PST_RUNNING];
+	const size_t succeeded = ctx->stateCount[PST_OK];
+	const size_t failed = total - PCF_MIN(total, pending + running + succeeded);
+	wchar_t buf[256];
+	if (ctx->searchQuery != NULL) {
+		snwprintf(buf, ARRAY_SIZE(buf), L"%zu of %zu files match: %zu pending, %zu running, %zu succeeded, %zu failed", ctx->searchHits, total, pending, running, succeeded, failed);
+	} else {
+		snwprintf(buf, ARRAY_SIZE(buf), L"%zu files: %zu pending, %zu running, %zu succeeded, %zu failed", total, pending, running, succeeded, failed);
+	}
+	buf[ARRAY_SIZE(buf) - 1] = 0;
+	SendMessageW(ctx->hStatus, SB_SETTEXTW, 0, (LPARAM)buf);
+	if (ctx->noteCount > 0) {
+		snwprintf(buf, ARRAY_SIZE(buf), L"%zu notification%s: %s", ctx->noteCount, (ctx->noteCount > 1) ? L"s" : L"", ctx->lastNote);
+		buf[ARRAY_SIZE(buf) - 1] = 0;
+		SendMessageW(ctx->hStatus, SB_SETTEXTW, 2, (LPARAM)buf);
+	} else {
+		SendMessageW(ctx->hStatus, SB_SETTEXTW, 2, (LPARAM)L"No notifications");
+	}
+	reportLiveFormat(ctx, buf, ARRAY_SIZE(buf));
+	SendMessageW(ctx->hStatus, SB_SETTEXTW, 1, (LPARAM)buf);
+}
+
+
+/**
+ * Shows the notification log in the output widget if no item is selected.
+ *
+ * @param[in] ctx - Window/IPC context
+ */
+void processUpdateNotes(const tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->hInfo == NULL || ctx->selList >= 0) {
+		return;
+	}
+	wchar_t * str = NULL;
+	const size_t count = (ctx->notes != NULL) ? vec_size(ctx->notes) : 0;
+	tUStrBuf * sb = (count > 0) ? usb_create(4096) : NULL;
+	if (sb != NULL) {
+		for (size_t i = 0; i < count; ++i) {
+			usb_add(sb, *((wchar_t **)vec_at(ctx->notes, i)));
+		}
+		str = usb_get(sb);
+		usb_delete(sb);
+	}
+	SendMessageW(ctx->hInfo, WM_SETREDRAW, FALSE, 0);
+	SetWindowTextW(ctx->hInfo, (str != NULL) ? str : L"");
+	SendMessageW(ctx->hInfo, WM_SETREDRAW, TRUE, 0);
+	const int newLen = GetWindowTextLengthW(ctx->hInfo);
+	SendMessageW(ctx->hInfo, EM_SETSEL, (WPARAM)newLen, (LPARAM)newLen);
+	SendMessageW(ctx->hInfo, EM_SCROLLCARET, 0, 0);
+	InvalidateRect(ctx->hInfo, NULL, TRUE);
+	if (str != NULL) {
+		free(str);
+	}
+}
+
+
+/**
+ * Appends the given notification to the output widget if it shows the
+ * notification log. This avoids setting the whole log for each notification.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[in] dropped - oldest notification which was dropped from the log or `NULL`
+ * @param[in] note - new notification
+ */
+static void processAppendNote(const tIpcWndCtx * ctx, const wchar_t * dropped, const wchar_t * note) {
+	if (ctx->hInfo == NULL || ctx->selList >= 0) {
+		return;
+	}
+	SendMessageW(ctx->hInfo, WM_SETREDRAW, FALSE, 0);
+	if (dropped != NULL) {
+		SendMessageW(ctx->hInfo, EM_SETSEL, 0, (LPARAM)wcslen(dropped));
+		SendMessageW(ctx->hInfo, EM_REPLACESEL, FALSE, (LPARAM)L"");
+	}
+	const int len = GetWindowTextLengthW(ctx->hInfo);
+	SendMessageW(ctx->hInfo, EM_SETSEL, (WPARAM)len, (LPARAM)len);
+	SendMessageW(ctx->hInfo, EM_REPLACESEL, FALSE, (LPARAM)note);
+	SendMessageW(ctx->hInfo, WM_SETREDRAW, TRUE, 0);
+	SendMessageW(ctx->hInfo, EM_SCROLLCARET, 0, 0);
+	InvalidateRect(ctx->hInfo, NULL, TRUE);
+}
+
+
+/**
+ * Adds the given string to the string buffer while converting single line feeds
+ * to carriage return and line feed pairs as needed by the output widget.
+ *
+ * @param[in,out] sb - string buffer
+ * @param[in] str - string to add
+ */
+static void processAddText(tUStrBuf * sb, const wchar_t * str) {
+	wchar_t last = 0;
+	for (; *str != 0; ++str) {
+		if (*str == L'\n' && last != L'\r') {
+			usb_addC(sb, L'\r');
+		}
+		usb_addC(sb, *str);
+		last = *str;
+	}
+}
+
+
+/**
+ * Reports a runtime error without blocking the processing. The message is
+ * added to the notification log, the status bar and the log of the given item.
+ * Modal message boxes are reserved for startup errors.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] item - related item or `NULL`
+ * @param[in] title - message source
+ * @param[in] fmt - format string
+ * @param[in] ... - format arguments
+ */
+void processNotify(tIpcWndCtx * ctx, tProcCtx * item, const wchar_t * title, const wchar_t * fmt, ...) {
+	if (ctx == NULL || title == NULL || fmt == NULL) {
+		return;
+	}
+	/* format message */
+	wchar_t * msg = NULL;
+	tUStrBuf * sb = usb_create(256);
+	if (sb == NULL) {
+		return;
+	}
+	va_list ap;
+	va_start(ap, fmt);
+	const int ok = usb_addFmtVar(sb, fmt, ap);
+	va_end(ap);
+	if (ok > 0) {
+		msg = usb_get(sb);
+	}
+	usb_delete(sb);
+	if (msg == NULL) {
+		return;
+	}
+	/* add to notification log */
+	wchar_t * note = NULL;
+	wchar_t * dropped = NULL;
+	if (ctx->notes == NULL) {
+		ctx->notes = vec_create(sizeof(wchar_t *));
+	}
+	sb = (ctx->notes != NULL) ? usb_create(256) : NULL;
+	if (sb != NULL) {
+		SYSTEMTIME st;
+		GetLocalTime(&st);
+		usb_addFmt(sb, L"[%02u:%02u:%02u] %s: ", (unsigned)st.wHour, (unsigned)st.wMinute, (unsigned)st.wSecond, title);
+		processAddText(sb, msg);
+		usb_add(sb, L"\r\n");
+		note = usb_get(sb);
+		usb_delete(sb);
+	}
+	wchar_t ** slot = (note != NULL) ? vec_pushBack(ctx->notes) : NULL;
+	if (slot != NULL) {
+		*slot = note;
+		if (vec_size(ctx->notes) > PROCESS_MAX_NOTES) {
+			dropped = *((wchar_t **)vec_at(ctx->notes, 0));
+			vec_erase(ctx->notes, 0, 1);
+		}
+		processAppendNote(ctx, dropped, note);
+	} else if (note != NULL) {
+		free(note);
+	}
+	if (dropped != NULL) {
+		free(dropped);
+	}
+	++(ctx->noteCount);
+	/* add to item log */
+	const bool stored = (item != NULL && item->blob != NULL);
+	if (item != NULL && outputRestore(ctx->outputs, item)) {
+		const size_t appendFrom = usb_len(item->output);
+		usb_add(item->output, L"\r\n--------------------------------------------------------------------------------\r\n");
+		processAddText(item->output, msg);
+		engineStampAppended(item, appendFrom);
+		searchAppended(ctx, processItemIndex(ctx, item), appendFrom);
+		if ( stored ) {
+			outputStore(ctx->outputs, item);
+		}
+	}
+	/* single line version for the status bar */
+	size_t n = 0;
+	for (const wchar_t * ptr = msg; *ptr != 0 && n < (ARRAY_SIZE(ctx->lastNote) - 1); ++ptr) {
+		if (*ptr == L'\r') {
+			continue;
+		}
+		ctx->lastNote[n++] = (*ptr == L'\n') ? L' ' : *ptr;
+	}
+	ctx->lastNote[n] = 0;
+	free(msg);
+	processUpdateStatus(ctx);
+}
+
+
+/**
+ * Asks the user for an output file and writes the run report to it.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void processSaveReport(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->hWnd == NULL) {
+		return;
+	}
+	wchar_t szFile[MAX_PATH];
+	OPENFILENAMEW ofn;
+	ZeroMemory(szFile, sizeof(szFile));
+	ZeroMemory(&ofn, sizeof(ofn));
+	ofn.lStructSize = sizeof(ofn);
+	ofn.hwndOwner = ctx->hWnd;
+	ofn.lpstrFile = szFile;
+	ofn.nMaxFile = ARRAY_SIZE(szFile);
+	ofn.lpstrFilter = L"JSON File (*.json)\0*.json\0CSV File (*.csv)\0*.csv\0All Files (*.*)\0*.*\0";
+	ofn.nFilterIndex = 1;
+	ofn.Flags = OFN_OVERWRITEPROMPT;
+	if (GetSaveFileNameW(&ofn) != TRUE) {
+		return;
+	}
+	if (ofn.nFilterIndex < 3 && PathFindExtensionW(szFile)[0] == 0) {
+		/* append missing file extension */
+		wcscat_s(szFile, ARRAY_SIZE(szFile), (ofn.nFilterIndex == 1) ? L".json" : L".csv");
+	}
+	if ( ! reportWrite(ctx, szFile) ) {
+		processNotify(ctx, NULL, L"processSaveReport", L"%s\n%s", errStr[ERR_CREATE_FILE], szFile);
+	}
+}
+
+
+/**
+ * Returns the client area height of the process window without the status bar.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @return usable client area height in pixels
+ */
+static int processClientHeight(const tIpcWndCtx * ctx) {
+	RECT rect;
+	GetClientRect(ctx->hWnd, &rect);
+	if (ctx->hStatus != NULL) {
+		RECT sRect;
+		GetWindowRect(ctx->hStatus, &sRect);
+		rect.bottom -= (sRect.bottom - sRect.top);
+	}
+	return (rect.bottom > 1) ? rect.bottom : 1;
+}
+
+
 /**
  * Updates the process window controls after a change in the window size.
  *
@@ -841,10 +1250,17 @@ void processWndResize(const tIpcWndCtx * ctx) {
 	RECT rect;
 	GetClientRect(ctx->hWnd, &rect);
 	const int width = rect.right;
-	const int height = rect.bottom;
+	if (ctx->hStatus != NULL) {
+		SendMessageW(ctx->hStatus, WM_SIZE, 0, 0);
+		const int parts[] = {(width * 3) / 8, (width * 3) / 4, -1};
+		SendMessageW(ctx->hStatus, SB_SETPARTS, (WPARAM)ARRAY_SIZE(parts), (LPARAM)parts);
+	}
+	const int height = processClientHeight(ctx);
 	const int sepMid = (int)lroundf((float)height * ctx->sepPos);
-	HDWP hDwp = BeginDeferWindowPos(3);
-	hDwp = DeferWindowPos(hDwp, ctx->hList, NULL, calcPixels(10), calcPixels(10), width - calcPixels(20), sepMid - sepHalf - calcPixels(10), SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOCOPYBITS | SWP_NOREDRAW);
+	const int listTop = calcPixels(10) + calcPixels(SEARCH_HEIGHT) + sepHeight;
+	HDWP hDwp = BeginDeferWindowPos(4);
+	hDwp = DeferWindowPos(hDwp, ctx->hSearch, NULL, calcPixels(10), calcPixels(10), width - calcPixels(20), calcPixels(SEARCH_HEIGHT), SWP_NOZORDER | SWP_NOACTIVATE);
+	hDwp = DeferWindowPos(hDwp, ctx->hList, NULL, calcPixels(10), listTop, width - calcPixels(20), sepMid - sepHalf - listTop, SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOCOPYBITS | SWP_NOREDRAW);
 	hDwp = DeferWindowPos(hDwp, ctx->hSep, NULL, calcPixels(10), sepMid - sepHalf, width - calcPixels(20), sepHeight, SWP_NOZORDER | SWP_NOACTIVATE);
 	hDwp = DeferWindowPos(hDwp, ctx->hInfo, NULL, calcPixels(10), sepMid + sepHalf, width - calcPixels(20), height - (sepMid + sepHalf + calcPixels(10)), SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOCOPYBITS | SWP_NOREDRAW);
 	EndDeferWindowPos(hDwp);
@@ -878,12 +1294,11 @@ LRESULT CALLBACK processSepWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lP
 			POINT pt;
 			GetCursorPos(&pt);
 			ScreenToClient(ctx->hWnd, &pt);
-			RECT rect;
-			GetClientRect(ctx->hWnd, &rect);
+			const int height = processClientHeight(ctx);
 			/* allow at least 70px at the top and bottom */
-			const float minY = calcPixelsF(70.f) / (float)(rect.bottom);
-			const float maxY = 1.0f - (calcPixelsF(70.f) / (float)(rect.bottom));
-			const float mid = (float)(pt.y) / (float)(rect.bottom);
+			const float minY = calcPixelsF(70.f) / (float)height;
+			const float maxY = 1.0f - (calcPixelsF(70.f) / (float)height);
+			const float mid = (float)(pt.y) / (float)height;
 			ctx->sepPos = fmaxf(minY, fminf(maxY, mid));
 			processWndResize(ctx);
 		}
@@ -942,20 +1357,27 @@ LRESULT CALLBACK processWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
 		LPCREATESTRUCTW init = (CREATESTRUCTW *)lParam;
 		const int width = init->cx;
 		ctx->hWnd = hWnd;
+		ctx->hSearch = CreateWindowExW(WS_EX_CLIENTEDGE, WC_EDITW, L"", WS_CHILD | WS_VISIBLE | WS_TABSTOP | ES_AUTOHSCROLL, 0, 0, 0, 0, hWnd, (HMENU)IDC_PROCESS_SEARCH, gInst, NULL);
 		ctx->hList = CreateWindowExW(WS_EX_CLIENTEDGE, WC_LISTVIEWW, NULL, WS_CHILD | WS_VISIBLE | WS_TABSTOP | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS, 0, 0, 0, 0, hWnd, (HMENU)IDC_PROCESS_LIST, gInst, NULL);
 		ctx->hSep = CreateWindowW(WC_STATICW, L"", WS_CHILD | WS_VISIBLE, 0, 0, 0, 0, hWnd, NULL, gInst, NULL);
 		ctx->hInfo = CreateWindowW(WC_EDITW, L"", WS_CHILD | WS_VISIBLE | WS_BORDER | WS_HSCROLL | WS_VSCROLL | WS_TABSTOP | ES_MULTILINE | ES_AUTOVSCROLL | ES_READONLY, 0, 0, 0, 0, hWnd, (HMENU)IDC_PROCESS_INFO, gInst, NULL);
+		ctx->hStatus = CreateWindowW(STATUSCLASSNAMEW, NULL, WS_CHILD | WS_VISIBLE | SBARS_SIZEGRIP | SBARS_TOOLTIPS, 0, 0, 0, 0, hWnd, (HMENU)IDC_PROCESS_STATUS, gInst, NULL);
 		ctx->selList = -1;
 		ctx->sepPos = 0.5f;
-		if ( ! (ctx->hList && ctx->hInfo && ctx->hSep) ) {
+		if ( ! (ctx->hSearch && ctx->hList && ctx->hInfo && ctx->hSep && ctx->hStatus) ) {
 			CloseWindow(hWnd);
 			break;
 		}
 		SetWindowSubclass(ctx->hInfo, processEditSubClassProc, 1, (DWORD_PTR)(ctx->hList));
+		/* lift the default limit of 32767 characters for appended notifications */
+		SendMessageW(ctx->hInfo, EM_SETLIMITTEXT, 0, 0);
 		/* set fonts */
 		SendMessageW(hWnd, WM_SETFONT, (WPARAM)(ctx->hFont), TRUE);
+		SendMessageW(ctx->hSearch, WM_SETFONT, (WPARAM)(ctx->hFont), TRUE);
 		SendMessageW(ctx->hList, WM_SETFONT, (WPARAM)(ctx->hFont), TRUE);
 		SendMessageW(ctx->hInfo, WM_SETFONT, (WPARAM)(ctx->hFont), TRUE);
+		SendMessageW(ctx->hStatus, WM_SETFONT, (WPARAM)(ctx->hFont), TRUE);
+		SendMessageW(ctx->hSearch, EM_SETCUEBANNER, FALSE, (LPARAM)L"Search output of all files (Ctrl+F)");
 		/* set extended list view styles */
 		SendMessageW(ctx->hList, LVM_SETEXTENDEDLISTVIEWSTYLE, 0, LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
 		/* add list view columns */
@@ -965,6 +1387,9 @@ LRESULT CALLBACK processWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
 		} columns[] = {
 			{calcPixels(120), L"File"},   /* PCI_FILE */
 			{calcPixels(100), L"Result"}, /* PCI_RESULT */
+			{calcPixels(60),  L"CPU"},    /* PCI_CPU */
+			{calcPixels(70),  L"Memory"}, /* PCI_MEMORY */
+			{calcPixels(120), L"I/O"},    /* PCI_IO */
 			{-1,  L"Path"}    /* PCI_PATH */
 		};
 		LVCOLUMNW lvc;
@@ -984,29 +1409,80 @@ LRESULT CALLBACK processWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
 		SetWindowLongPtr(ctx->hSep, GWLP_USERDATA, (LONG_PTR)ctx);
 		SetWindowLongPtr(ctx->hSep, GWLP_WNDPROC, (LONG_PTR)processSepWndProc);
 		processWndResize(ctx);
+		processUpdateStatus(ctx);
 		DragAcceptFiles(hWnd, TRUE);
+		/* add on-demand run report to the window menu */
+		HMENU hMenu = GetSystemMenu(hWnd, FALSE);
+		if (hMenu != NULL) {
+			AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
+			AppendMenuW(hMenu, MF_STRING, IDM_PROCESS_REPORT, L"Save run report...\tCtrl+S");
+			AppendMenuW(hMenu, MF_STRING | MF_UNCHECKED, IDM_PROCESS_TIMES, L"Show output line times");
+		}
+		/* refresh the moving rate also while idle */
+		SetTimer(hWnd, PROCESS_STATUS_TIMER, PROCESS_STATUS_INTERVAL, NULL);
 		} break;
+	case WM_TIMER:
+		if (wParam == PROCESS_STATUS_TIMER) {
+			const DWORD logErr = sessionLogGetError(ctx->log);
+			if (logErr != 0) {
+				processNotify(ctx, NULL, L"sessionLog", errStr[ERR_SESSION_LOG], logErr);
+			}
+			const DWORD recErr = recordGetError(ctx->rec);
+			if (recErr != 0) {
+				processNotify(ctx, NULL, L"record", errStr[ERR_RECORD], recErr);
+			}
+			processUpdateStatus(ctx);
+		} else if (wParam == PROCESS_SEARCH_TIMER) {
+			KillTimer(hWnd, PROCESS_SEARCH_TIMER);
+			searchApply(ctx);
+		}
+		break;
+	case WM_COMMAND:
+		if (LOWORD(wParam) == IDC_PROCESS_SEARCH && HIWORD(wParam) == EN_CHANGE) {
+			/* filter the item list once the query stopped changing */
+			SetTimer(hWnd, PROCESS_SEARCH_TIMER, PROCESS_SEARCH_DELAY, NULL);
+		}
+		break;
+	case WM_SYSCOMMAND:
+		if ((wParam & 0xFFF0) == IDM_PROCESS_REPORT) {
+			processSaveReport(ctx);
+			return 0;
+		} else if ((wParam & 0xFFF0) == IDM_PROCESS_TIMES) {
+			ctx->showLineTimes = ! ctx->showLineTimes;
+			CheckMenuItem(GetSystemMenu(hWnd, FALSE), IDM_PROCESS_TIMES, MF_BYCOMMAND | (ctx->showLineTimes ? MF_CHECKED : MF_UNCHECKED));
+			if (ctx->selList >= 0) {
+				processUpdateItem(ctx, (size_t)(ctx->selList));
+			}
+			return 0;
+		}
+		return DefWindowProc(hWnd, msg, wParam, lParam);
 	case WM_NOTIFY: {
 		const NMHDR * nmhdr = (const NMHDR *)lParam;
-		if (nmhdr->idFrom == IDC_PROCESS_LIST) {
+		if (nmhdr->idFrom == IDC_PROCESS_STATUS && nmhdr->code == NM_CLICK) {
+			/* show notification log by clearing the item selection */
+			ListView_SetItemState(ctx->hList, -1, 0, LVIS_SELECTED);
+			processUpdateNotes(ctx);
+		} else if (nmhdr->idFrom == IDC_PROCESS_LIST) {
 			switch (nmhdr->code) {
 			case LVN_ITEMCHANGED: {
 				/* show program output */
-				const int selList = ListView_GetNextItem(ctx->hList, -1, LVNI_SELECTED);
+				const int selList = processRowItem(ctx, ListView_GetNextItem(ctx->hList, -1, LVNI_SELECTED));
 				if (selList != ctx->selList) {
 					ctx->selList = selList;
 					if (selList >= 0) {
 						processUpdateItem(ctx, (size_t)(ctx->selList));
+						searchReveal(ctx);
 					} else {
-						SetWindowTextW(ctx->hInfo, L"");
+						processUpdateNotes(ctx);
 					}
 				}
 				} break;
 			case NM_DBLCLK: {
 				/* open explorer at file path */
 				const LPNMITEMACTIVATE item = (LPNMITEMACTIVATE)lParam;
-				if (item->iItem >= 0 && item->uKeyFlags == 0) {
-					const tProcCtx * i = vec_at(ctx->v, (size_t)(item->iItem));
+				const int index = processRowItem(ctx, item->iItem);
+				if (index >= 0 && item->uKeyFlags == 0) {
+					tProcCtx * i = vec_at(ctx->v, (size_t)index);
 					if (i != NULL) {
 						if ( wFileExists(i->path) ) {
 							/* get parent folder PIDL and relative child PIDL from full file PIDL */
@@ -1024,7 +1500,7 @@ LRESULT CALLBACK processWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
 								ILFree(pidlFile);
 							}
 						} else {
-							showFmtMsg(hWnd, MB_OK | MB_ICONERROR, L"Error (showProcess)", errStr[ERR_FILE_NOT_FOUND], i->path);
+							processNotify(ctx, NULL, L"showProcess", errStr[ERR_FILE_NOT_FOUND], i->path);
 						}
 					}
 				}
@@ -1039,6 +1515,7 @@ LRESULT CALLBACK processWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
 		if (hDrop != NULL) {
 			const UINT count = DragQueryFile(hDrop, 0xFFFFFFFF, NULL, 0);
 			wchar_t buf[MAX_PATH + 1];
+			recordEvent(ctx->rec, RPL_REQUEST, 0, RPS_DROP, 0);
 			for (UINT i = 0; i < count; ++i) {
 				processDragFile(ctx, hDrop, i, buf, ARRAY_SIZE(buf));
 			}
@@ -1054,10 +1531,14 @@ LRESULT CALLBACK processWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
 		processWndResize(ctx);
 		break;
 	case WM_CLOSE:
+		KillTimer(hWnd, PROCESS_STATUS_TIMER);
+		KillTimer(hWnd, PROCESS_SEARCH_TIMER);
 		DestroyWindow(hWnd);
+		ctx->hSearch = NULL;
 		ctx->hList = NULL;
 		ctx->hSep = NULL;
 		ctx->hInfo = NULL;
+		ctx->hStatus = NULL;
 		break;
 	case WM_DESTROY:
 		PostQuitMessage(0);
@@ -1073,50 +1554,39 @@ LRESULT CALLBACK processWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
  * Shows the process window or transmits the request to an existing one.
  *
  * @param[in] c - INI configuration
+ * @param[in] configUrl - INI file with the configuration sections selectable via HTTP
+ * @param[in] report - run report output path or `NULL` (ignored if the request is passed to an existing window)
+ * @param[in] logDir - session log output directory or `NULL` (ignored if the request is passed to an existing window)
+ * @param[in] record - replay trace output path or `NULL` (ignored if the request is passed to an existing window)
+ * @param[in] httpPort - loopback HTTP port or 0 (ignored if the request is passed to an existing window)
+ * @param[in] key - shared agent key or `NULL`; the window runs standalone and accepts signed HTTP requests from any host if set
+ * @param[in] keyLen - length of `key` in bytes
+ * @param[in] agents - agent specifications (`wchar_t *`) to pass all files to or `NULL`; requires `key`
  * @param[in] cmdshow - `ShowWindow` parameter
  * @param[in] argc - number of files to sign
  * @param[in] argv - list of files to sign
  * @return program exit code
  */
-int showProcess(const tIniConfig * c, int cmdshow, int argc, wchar_t ** argv) {
+int showProcess(const tIniConfig * c, const wchar_t * configUrl, const wchar_t * report, const wchar_t * logDir, const wchar_t * record, const unsigned short httpPort, const uint8_t * key, const size_t keyLen, tVector * agents, int cmdshow, int argc, wchar_t ** argv) {
 	int res = EXIT_FAILURE;
 	bool isServer = true;
 	tIpcWndCtx ctx;
 	ZeroMemory(&ctx, sizeof(ctx));
 	ctx.hPipe = INVALID_HANDLE_VALUE;
+	for (size_t k = 0; k < MAX_CHAIN_STEPS; ++k) {
+		ctx.lanes[k].step = k;
+		ctx.lanes[k].hProcRead = INVALID_HANDLE_VALUE;
+	}
 	ctx.waitForClient = true;
+	ctx.http.sock = INVALID_SOCKET;
 	HRESULT hRes = E_HANDLE;
 	/* input value check */
 	if (c == NULL || (argc > 0 && argv == NULL && argv[0] == NULL)) {
 		MessageBoxW(NULL, errStr[ERR_INVALID_ARG], L"Error (showProcess)", MB_OK | MB_ICONERROR);
 		goto onError;
 	}
-	/* COM initialization */
-	hRes = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
-	if (hRes != S_OK) {
-		showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (showProcess)", errStr[ERR_INIT_COM], hRes);
-		goto onError;
-	}
-	/* processing context initialization */
-	ctx.v = vec_create(sizeof(tProcCtx));
-	if (ctx.v == NULL) {
-		MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (showProcess)", MB_OK | MB_ICONERROR);
-		goto onError;
-	}
-	ctx.h = hto_create(
-		sizeof(DATA_BLOB),
-		64,
-		(HashFunctionCloneO)rcIniConfigBaseClone,
-		(HashFunctionDelO)rcIniConfigBaseDelete,
-		(HashFunctionCmpO)rcIniConfigBaseCmp,
-		(HashFunctionHashO)rcIniConfigBaseHash
-	);
-	if (ctx.h == NULL) {
-		MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (showProcess)", MB_OK | MB_ICONERROR);
-		goto onError;
-	}
-	/* IPC setup */
-	for (size_t i = 0; i < 3; ++i) {
+	/* IPC setup (before anything else to keep passing requests to an existing window fast) */
+	for (size_t i = 0; i < 3 && key == NULL; ++i) {
 		/* try to act as IPC server */
 		ctx.hPipe = CreateNamedPipeW(IPC_PIPE_PATH, PIPE_ACCESS_INBOUND | FILE_FLAG_FIRST_PIPE_INSTANCE | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, IPC_MAX_CLIENTS, 0, MAX_CONFIG_STR_LEN, 0, NULL);
 		if (ctx.hPipe == INVALID_HANDLE_VALUE) {
@@ -1139,20 +1609,68 @@ int showProcess(const tIniConfig * c, int cmdshow, int argc, wchar_t ** argv) {
 		/* run as IPC server */
 		break;
 	}
-	if (ctx.hPipe == INVALID_HANDLE_VALUE) {
+	if (key != NULL) {
+		/* agents and coordinators run standalone to allow several of them on one host */
+		ctx.waitForClient = false;
+	} else if (ctx.hPipe == INVALID_HANDLE_VALUE) {
 		showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (showProcess)", errStr[ERR_OPEN_NAMED_PIPE], GetLastError());
 		goto onError;
 	}
 	if ( ! isServer ) {
 		/* act as IPC client and transmit INI configuration to server */
 		if (argc > 0) {
-			if ( ! ipcSendReqToServer(ctx.hPipe, c, argc, argv) ) {
+			if ( ! ipcSendReqToServer(ctx.hPipe, c, configUrl, argc, argv) ) {
 				showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (showProcess)", errStr[ERR_WRITE_NAMED_PIPE], GetLastError());
 				goto onError;
 			}
 		}
 		goto onSuccess;
 	}
+	/* COM initialization */
+	hRes = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+	if (hRes != S_OK) {
+		showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (showProcess)", errStr[ERR_INIT_COM], hRes);
+		goto onError;
+	}
+	/* processing context initialization */
+	ctx.v = vec_create(sizeof(tProcCtx));
+	if (ctx.v == NULL) {
+		MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (showProcess)", MB_OK | MB_ICONERROR);
+		goto onError;
+	}
+	ctx.h = hto_create(
+		sizeof(DATA_BLOB),
+		64,
+		(HashFunctionCloneO)rcIniConfigBaseClone,
+		(HashFunctionDelO)rcIniConfigBaseDelete,
+		(HashFunctionCmpO)rcIniConfigBaseCmp,
+		(HashFunctionHashO)rcIniConfigBaseHash
+	);
+	if (ctx.h == NULL) {
+		MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (showProcess)", MB_OK | MB_ICONERROR);
+		goto onError;
+	}
+	ctx.outputs = hto_create(
+		sizeof(tOutputBlob *),
+		OUTPUT_STORE_SIZE,
+		(HashFunctionCloneO)outputBlobClone,
+		(HashFunctionDelO)outputBlobDelete,
+		(HashFunctionCmpO)outputBlobCmp,
+		(HashFunctionHashO)outputBlobHash
+	);
+	if (ctx.outputs == NULL) {
+		MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (showProcess)", MB_OK | MB_ICONERROR);
+		goto onError;
+	}
+	ctx.search = tgi_create();
+	if (ctx.search == NULL) {
+		MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (showProcess)", MB_OK | MB_ICONERROR);
+		goto onError;
+	}
+	if ( ! (pipePoolInit(&(ctx.pipes)) && pipePoolFill(&(ctx.pipes))) ) {
+		showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (showProcess)", errStr[ERR_CREATE_PIPE], GetLastError());
+		goto onError;
+	}
 	/* load default window font */
 	ctx.hFont = CreateFontW(calcFontSize(85), 0, 0, 0, 0, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, DEFAULT_QUALITY, DEFAULT_PITCH | FF_DONTCARE, L"MS Shell Dlg");
 	if (ctx.hFont == NULL) {
@@ -1176,59 +1694,117 @@ int showProcess(const tIniConfig * c, int cmdshow, int argc, wchar_t ** argv) {
 	};
 	RegisterClassExW(&wc);
 	/* initialize common controls */
-	INITCOMMONCONTROLSEX icex = {sizeof(icex), ICC_LISTVIEW_CLASSES};
+	INITCOMMONCONTROLSEX icex = {sizeof(icex), ICC_LISTVIEW_CLASSES | ICC_BAR_CLASSES};
     InitCommonControlsEx(&icex);
 	/* create configuration environment */
-	ctx.cmdlCfg = rcIniConfigBaseCreate(c->cert);
+	ctx.cmdlCfg = rcIniConfigBaseCreate(c->cert, c->match);
 	ctx.cmdlSignApp = rws_aquire(c->signApp);
 	if (ctx.cmdlCfg == NULL) {
 		MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (showProcess)", MB_OK | MB_ICONERROR);
 		goto onError;
 	}
+	if ( ! iniConfigChain(configUrl, ctx.cmdlCfg, c->chain) ) {
+		showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (INI file)", L"%s: %s", configUrl, errStr[lastErr]);
+		goto onError;
+	}
+	if (report != NULL) {
+		ctx.reportPath = wcsdup(report);
+		if (ctx.reportPath == NULL || ( ! wToFullPath(&(ctx.reportPath), true) )) {
+			MessageBoxW(NULL, errStr[ERR_OUT_OF_MEMORY], L"Error (showProcess)", MB_OK | MB_ICONERROR);
+			goto onError;
+		}
+	}
 	/* create and show window */
-	HWND hWnd = CreateWindowW(wc.lpszClassName, L"Signing process", WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT, calcPixels(640), calcPixels(480), NULL, NULL, gInst, (LPVOID)&ctx);
+	HWND hWnd = CreateWindowW(wc.lpszClassName, L"Signing process", WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT, calcPixels(800), calcPixels(480), NULL, NULL, gInst, (LPVOID)&ctx);
 	ShowWindow(hWnd, cmdshow);
 	UpdateWindow(hWnd);
+	if (logDir != NULL) {
+		/* stream all item output to disk in the background */
+		ctx.log = sessionLogCreate(logDir);
+		if (ctx.log == NULL) {
+			processNotify(&ctx, NULL, L"showProcess", errStr[ERR_SESSION_LOG], GetLastError());
+		}
+	}
+	if (record != NULL) {
+		/* capture request, output and exit timings for `siguwi-replay` */
+		ctx.rec = recordCreate(record);
+		if (ctx.rec == NULL) {
+			processNotify(&ctx, NULL, L"showProcess", errStr[ERR_RECORD], GetLastError());
+		}
+	}
+	if (agents != NULL && vec_size(agents) > 0 && ( ! remoteCreate(&(ctx.remote), agents, key, keyLen) )) {
+		showFmtMsg(hWnd, MB_OK | MB_ICONERROR, L"Error (showProcess)", errStr[ERR_AGENT_START], GetLastError());
+		goto onError;
+	}
 	if (argc > 0) {
-		/* add files to process list */
+		/* add files to process list (errors are shown in the notification log) */
+		recordEvent(ctx.rec, RPL_REQUEST, 0, RPS_COMMAND_LINE, 0);
 		for (int i = 0; i < argc; ++i) {
-			if ( ! processAddFile(&ctx, ctx.cmdlCfg, ctx.cmdlSignApp, argv[i]) ) {
-				goto onError;
-			}
+			processAddFile(&ctx, ctx.cmdlCfg, ctx.cmdlSignApp, argv[i], NULL, NULL);
 		}
 	}
 	/* run as IPC server and show process window */
-	if ( ! ipcListen(&ctx) ) {
-		goto onError;
+	if (key == NULL && ( ! ipcListen(&ctx) )) {
+		/* keep processing the given files without accepting further requests */
+		processNotify(&ctx, NULL, L"showProcess", L"%s", errStr[ERR_IPC_DISABLED]);
+		ctx.waitForClient = false;
+		closeHandlePtr(&(ctx.hPipe), INVALID_HANDLE_VALUE);
+	}
+	if (httpPort != 0 && ( ! httpCreate(&(ctx.http), httpPort, configUrl, key, keyLen) )) {
+		/* keep processing without the HTTP front end */
+		processNotify(&ctx, NULL, L"showProcess", errStr[ERR_HTTP_LISTEN], (unsigned)httpPort, GetLastError());
 	}
 	DWORD waitResult;
+	HANDLE waitHandles[5];
 	MSG msg;
+	trace_setThreadName("gui");
 	for (;;) {
+		DWORD waitCount = 0;
 		if ( ctx.waitForClient ) {
-			waitResult = MsgWaitForMultipleObjectsEx(1, &(ctx.ovClient.hEvent), INFINITE, QS_ALLINPUT, MWMO_ALERTABLE);
-			if (waitResult == WAIT_OBJECT_0) {
-				/* handle new client */
-				DWORD dummy;
-				BOOL ok = GetOverlappedResult(ctx.hPipe, &(ctx.ovClient), &dummy, FALSE);
-				if (ok || GetLastError() == ERROR_PIPE_CONNECTED) {
-					if ( ! (ipcIsValidProcess(ctx.hPipe) && ipcReadAsync(&ctx)) ) {
-						/* wait for next client */
-						DisconnectNamedPipe(ctx.hPipe);
-						if ( ! ipcListen(&ctx) ) {
-							goto onError;
-						}
-					}
-				} else {
+			waitHandles[waitCount++] = ctx.ovClient.hEvent;
+		}
+		if (ctx.http.hAccept != NULL) {
+			waitHandles[waitCount++] = ctx.http.hAccept;
+		}
+		if (ctx.hash.hDone != NULL) {
+			waitHandles[waitCount++] = ctx.hash.hDone;
+		}
+		if (ctx.remote.hDone != NULL) {
+			waitHandles[waitCount++] = ctx.remote.hDone;
+		}
+		if (ctx.archive.hDone != NULL) {
+			waitHandles[waitCount++] = ctx.archive.hDone;
+		}
+		TRACE_BEGIN("gui", "wait");
+		waitResult = MsgWaitForMultipleObjectsEx(waitCount, waitHandles, httpTimeout(&(ctx.http)), QS_ALLINPUT, MWMO_ALERTABLE);
+		TRACE_END("gui", "wait");
+		if (waitResult < (WAIT_OBJECT_0 + waitCount) && waitHandles[waitResult - WAIT_OBJECT_0] == ctx.ovClient.hEvent) {
+			/* handle new client */
+			DWORD dummy;
+			BOOL ok = GetOverlappedResult(ctx.hPipe, &(ctx.ovClient), &dummy, FALSE);
+			if (ok || GetLastError() == ERROR_PIPE_CONNECTED) {
+				if ( ! (ipcIsValidProcess(ctx.hPipe) && ipcReadAsync(&ctx)) ) {
 					/* wait for next client */
-					DisconnectNamedPipe(ctx.hPipe);
-					if ( ! ipcListen(&ctx) ) {
-						goto onError;
-					}
+					ipcRestart(&ctx);
 				}
+			} else {
+				/* wait for next client */
+				ipcRestart(&ctx);
 			}
-		} else {
-			waitResult = MsgWaitForMultipleObjectsEx(0, NULL, INFINITE, QS_ALLINPUT, MWMO_ALERTABLE);
+		} else if (waitResult < (WAIT_OBJECT_0 + waitCount) && waitHandles[waitResult - WAIT_OBJECT_0] == ctx.hash.hDone) {
+			/* handle finished file hashing jobs */
+			hashComplete(&ctx);
+		} else if (waitResult < (WAIT_OBJECT_0 + waitCount) && waitHandles[waitResult - WAIT_OBJECT_0] == ctx.remote.hDone) {
+			/* handle items finished by the agents */
+			remoteComplete(&ctx);
+		} else if (waitResult < (WAIT_OBJECT_0 + waitCount) && waitHandles[waitResult - WAIT_OBJECT_0] == ctx.archive.hDone) {
+			/* handle extracted and rewritten archives */
+			archiveComplete(&ctx);
+		} else if (waitResult < (WAIT_OBJECT_0 + waitCount)) {
+			/* handle new HTTP connections */
+			httpAccept(&ctx);
 		}
+		httpExpire(&ctx);
 		if (waitResult == WAIT_IO_COMPLETION) {
 			continue;
 		}
@@ -1236,15 +1812,48 @@ int showProcess(const tIniConfig * c, int cmdshow, int argc, wchar_t ** argv) {
 			if (msg.message == WM_QUIT) {
 				goto onSuccess;
 			}
+			if (msg.message == WM_KEYDOWN && msg.wParam == 'S' && GetKeyState(VK_CONTROL) < 0) {
+				processSaveReport(&ctx);
+				continue;
+			}
+			if (msg.message == WM_KEYDOWN && msg.wParam == 'F' && GetKeyState(VK_CONTROL) < 0 && ctx.hSearch != NULL) {
+				SetFocus(ctx.hSearch);
+				SendMessageW(ctx.hSearch, EM_SETSEL, 0, -1);
+				continue;
+			}
+			if (msg.message == WM_KEYDOWN && msg.hwnd == ctx.hSearch && msg.hwnd != NULL) {
+				if (msg.wParam == VK_RETURN) {
+					/* filter immediately and move on to the matching items */
+					KillTimer(hWnd, PROCESS_SEARCH_TIMER);
+					searchApply(&ctx);
+					SetFocus(ctx.hList);
+					continue;
+				} else if (msg.wParam == VK_ESCAPE) {
+					SetWindowTextW(ctx.hSearch, L"");
+					continue;
+				}
+			}
 			if ( ! IsDialogMessage(hWnd, &msg) ) {
+				TRACE_BEGIN("gui", "dispatchMessage");
 				TranslateMessage(&msg);
 				DispatchMessage(&msg);
+				TRACE_END("gui", "dispatchMessage");
 			}
 		}
 	}
 onSuccess:
 	res = EXIT_SUCCESS;
+	if (ctx.reportDirty && ctx.reportPath != NULL) {
+		/* interrupted batch */
+		reportWrite(&ctx, ctx.reportPath);
+	}
 onError:
+	remoteDelete(&ctx);
+	httpDelete(&(ctx.http));
+	archiveDelete(&ctx);
+	hashDelete(&ctx);
+	sessionLogDelete(ctx.log);
+	recordDelete(ctx.rec);
 	if (hRes == S_OK) {
 		CoUninitialize();
 	}
@@ -1259,16 +1868,33 @@ onError:
 	wStrDelete(&(ctx.cfg.cert->cardReader));
 	rws_release(&(ctx.cfg.signApp));
 	rcIniConfigBaseDelete(ctx.cfgBase);
+	wStrDelete(&(ctx.cfgUrl));
 	rcIniConfigBaseDelete(ctx.cmdlCfg);
 	rws_release(&(ctx.cmdlSignApp));
+	wStrDelete(&(ctx.reportPath));
+	if (ctx.notes != NULL) {
+		for (size_t i = 0; i < vec_size(ctx.notes); ++i) {
+			free(*((wchar_t **)vec_at(ctx.notes, i)));
+		}
+		vec_delete(ctx.notes);
+	}
 	if (ctx.h != NULL) {
 		hto_traverse(ctx.h, (HashVisitorO)pinBlobDelete, NULL);
 		hto_delete(ctx.h);
 	}
+	scanDelete(&ctx);
 	if (ctx.v != NULL) {
 		vec_traverse(ctx.v, (VectorVisitor)procCtxDelete, NULL);
 		vec_delete(ctx.v);
 	}
-	closeHandlePtr(&(ctx.hProc), INVALID_HANDLE_VALUE);
+	if (ctx.outputs != NULL) {
+		hto_delete(ctx.outputs);
+	}
+	searchDelete(&ctx);
+	for (size_t k = 0; k < MAX_CHAIN_STEPS; ++k) {
+		closeHandlePtr(&(ctx.lanes[k].hProc), NULL);
+		closeHandlePtr(&(ctx.lanes[k].hProcRead), INVALID_HANDLE_VALUE);
+	}
+	pipePoolDelete(&(ctx.pipes));
 	return res;
 }
@@ -0,0 +1,141 @@
+/**
+ * @file siguwi-record.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Records the given write error. Only the first one is reported.
+ *
+ * @param[in,out] rec - recorder
+ * @param[in] err - Win32 error code
+ */
+static void recordSetError(tRecorder * rec, const DWORD err) {
+	if ( rec->failed ) {
+		return;
+	}
+	rec->failed = true;
+	rec->error = (err != 0) ? err : ERROR_WRITE_FAULT;
+}
+
+
+/**
+ * Writes the buffered events to the trace file.
+ *
+ * @param[in,out] rec - recorder
+ */
+static void recordFlush(tRecorder * rec) {
+	size_t pos = 0;
+	while (pos < rec->bufLen && rec->hFile != INVALID_HANDLE_VALUE && ( ! rec->failed )) {
+		DWORD written = 0;
+		if ( ! WriteFile(rec->hFile, rec->buf + pos, (DWORD)(rec->bufLen - pos), &written, NULL) || written == 0 ) {
+			recordSetError(rec, GetLastError());
+			break;
+		}
+		pos += (size_t)written;
+	}
+	rec->bufLen = 0;
+}
+
+
+/**
+ * Creates a new replay trace recorder. The trace file starts with `RPL_MAGIC`
+ * followed by compactly encoded events (see `replay.c`). Events are buffered
+ * and written synchronously once the buffer is full.
+ *
+ * @param[in] path - output file path
+ * @return recorder or `NULL` on error with the error code in `GetLastError()`
+ */
+tRecorder * recordCreate(const wchar_t * path) {
+	if (path == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return NULL;
+	}
+	DWORD err = ERROR_NOT_ENOUGH_MEMORY;
+	tRecorder * rec = calloc(1, sizeof(tRecorder));
+	if (rec == NULL) {
+		SetLastError(err);
+		return NULL;
+	}
+	rec->buf = malloc(RECORD_BUFFER_SIZE);
+	if (rec->buf == NULL) {
+		free(rec);
+		SetLastError(err);
+		return NULL;
+	}
+	rec->hFile = CreateFileW(path, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (rec->hFile == INVALID_HANDLE_VALUE) {
+		err = GetLastError();
+		free(rec->buf);
+		free(rec);
+		SetLastError(err);
+		return NULL;
+	}
+	memcpy(rec->buf, RPL_MAGIC, 8);
+	rec->bufLen = 8;
+	rec->start = reportTicks();
+	return rec;
+}
+
+
+/**
+ * Records a single event with the current time.
+ *
+ * @param[in,out] rec - recorder or `NULL`
+ * @param[in] type - event type
+ * @param[in] item - item index
+ * @param[in] value - first type specific value
+ * @param[in] value2 - second type specific value
+ */
+void recordEvent(tRecorder * rec, const tReplayType type, const size_t item, const uint32_t value, const uint32_t value2) {
+	if (rec == NULL || rec->failed) {
+		return;
+	}
+	const double ms = reportTicksToMs(reportTicks() - rec->start);
+	tReplayEvent ev = {
+		.type = type,
+		.time = (ms > 0.0) ? (uint64_t)(ms * 1000.0) : 0,
+		.item = (item < UINT32_MAX) ? (uint32_t)item : UINT32_MAX,
+		.value = value,
+		.value2 = value2
+	};
+	if ((rec->bufLen + RPL_MAX_EVENT_SIZE) > RECORD_BUFFER_SIZE) {
+		recordFlush(rec);
+	}
+	rec->bufLen += rpl_encode(rec->buf + rec->bufLen, &(rec->last), &ev);
+}
+
+
+/**
+ * Returns and clears the write error. Only the first error is reported.
+ *
+ * @param[in,out] rec - recorder or `NULL`
+ * @return Win32 error code or 0
+ */
+DWORD recordGetError(tRecorder * rec) {
+	if (rec == NULL) {
+		return 0;
+	}
+	const DWORD err = rec->error;
+	rec->error = 0;
+	return err;
+}
+
+
+/**
+ * Writes all buffered events, closes the trace file and frees the recorder.
+ *
+ * @param[in,out] rec - recorder or `NULL`
+ */
+void recordDelete(tRecorder * rec) {
+	if (rec == NULL) {
+		return;
+	}
+	recordFlush(rec);
+	closeHandlePtr(&(rec->hFile), INVALID_HANDLE_VALUE);
+	free(rec->buf);
+	free(rec);
+}
@@ -2,11 +2,83 @@
  * @file siguwi-registry.c
  * @author Daniel Starke
  * @date 2025-08-21
- * @version 2025-09-12
+ * @version 2026-10-18
  */
 #include "siguwi.h"
 
 
+/**
+ * Number of leading `regExts` entries which are signed directly.
+ */
+#define REG_SIGN_EXTS 5
+
+
+/**
+ * File extensions with a shell context menu entry. The first `REG_SIGN_EXTS`
+ * ones are signed directly. The remaining ones are archives whose matching
+ * entries are signed.
+ */
+static const wchar_t * const regExts[] = {
+	L".exe",
+	L".dll",
+	L".ps1",
+	L".msi",
+	L".cab",
+	L".nupkg",
+	L".vsix",
+	L".zip"
+};
+
+
+/**
+ * Checks whether the given path ends with one of the passed file extensions.
+ *
+ * @param[in] path - file path
+ * @param[in] exts - file extensions
+ * @param[in] count - number of file extensions
+ * @return `true` if matching, else `false`
+ */
+static bool regHasExt(const wchar_t * path, const wchar_t * const * exts, const size_t count) {
+	if (path == NULL) {
+		return false;
+	}
+	const wchar_t * ext = wcsrchr(path, L'.');
+	if (ext == NULL || wcschr(ext, L'\\') != NULL || wcschr(ext, L'/') != NULL) {
+		return false;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		if (_wcsicmp(ext, exts[i]) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * Checks whether the given file is signed directly according to its file
+ * extension.
+ *
+ * @param[in] path - file path
+ * @return `true` if signable, else `false`
+ */
+bool regIsSignable(const wchar_t * path) {
+	return regHasExt(path, regExts, REG_SIGN_EXTS);
+}
+
+
+/**
+ * Checks whether the given file is an archive whose signable entries are signed
+ * according to its file extension.
+ *
+ * @param[in] path - file path
+ * @return `true` if an archive, else `false`
+ */
+bool regIsArchive(const wchar_t * path) {
+	return regHasExt(path, regExts + REG_SIGN_EXTS, ARRAY_SIZE(regExts) - REG_SIGN_EXTS);
+}
+
+
 /**
  * Checks whether the current process runs with admin rights.
  *
@@ -83,17 +155,90 @@ void regCloseKeyPtr(HKEY * hKey) {
 
 
 /**
- * Registers the verb for the given file extension in the registry.
+ * Registers the shell drop target COM local server for the given verb. It
+ * receives all selected files of a multi-select context menu invocation at
+ * once (see `shellDropTarget()`).
+ *
+ * @param[in] configUrl - INI file path
+ * @param[in] configGroup - INI section name
+ * @param[in] verb - static context menu verb
+ * @param[in] clsid - class ID string of the drop target
+ * @param[in] useHklm - `true` for local machine, else `false` for current user
+ * @return `true` on success, else `false`
+ */
+bool regRegisterDropTarget(const wchar_t * configUrl, const wchar_t * configGroup, const wchar_t * verb, const wchar_t * clsid, const bool useHklm) {
+	const HKEY hRoot = useHklm ? HKEY_LOCAL_MACHINE : HKEY_CURRENT_USER;
+	wchar_t path[2 * MAX_REG_KEY_NAME];
+	wchar_t * cmd = NULL;
+	tUStrBuf * sb = NULL;
+	HKEY hKey = NULL;
+	bool res = false;
+	snwprintf(path, ARRAY_SIZE(path), L"SOFTWARE\\Classes\\CLSID\\%s", clsid);
+	RegDeleteTreeW(hRoot, path);
+	if (RegCreateKeyExW(hRoot, path, 0, NULL, REG_OPTION_NON_VOLATILE, KEY_ALL_ACCESS, NULL, &hKey, NULL) != ERROR_SUCCESS) {
+		goto onError;
+	}
+	sb = usb_create(MAX_CONFIG_STR_LEN);
+	if (sb == NULL) {
+		goto onError;
+	}
+	if (usb_addFmt(sb, L"siguwi drop target (%s)", verb) <= 0) {
+		goto onError;
+	}
+	cmd = usb_get(sb);
+	if (cmd == NULL) {
+		goto onError;
+	}
+	if (RegSetValueExW(hKey, NULL, 0, REG_SZ, (LPCBYTE)cmd, (DWORD)((wcslen(cmd) + 1) * sizeof(wchar_t))) != ERROR_SUCCESS) {
+		goto onError;
+	}
+	free(cmd);
+	cmd = NULL;
+	/* add local server command-line (COM appends `-Embedding`) */
+	regCloseKeyPtr(&hKey);
+	wcscat_s(path, ARRAY_SIZE(path), L"\\LocalServer32");
+	if (RegCreateKeyExW(hRoot, path, 0, NULL, REG_OPTION_NON_VOLATILE, KEY_ALL_ACCESS, NULL, &hKey, NULL) != ERROR_SUCCESS) {
+		goto onError;
+	}
+	usb_clear(sb);
+	if (usb_addFmt(sb, L"\"%s\" -c \"%s:%s\" -D %s", exePath, configUrl, configGroup, clsid) <= 0) {
+		goto onError;
+	}
+	cmd = usb_get(sb);
+	if (cmd == NULL) {
+		goto onError;
+	}
+	if (RegSetValueExW(hKey, NULL, 0, REG_SZ, (LPCBYTE)cmd, (DWORD)((wcslen(cmd) + 1) * sizeof(wchar_t))) != ERROR_SUCCESS) {
+		goto onError;
+	}
+	res = true;
+onError:
+	if (cmd != NULL) {
+		free(cmd);
+	}
+	if (sb != NULL) {
+		usb_delete(sb);
+	}
+	regCloseKeyPtr(&hKey);
+	return res;
+}
+
+
+/**
+ * Registers the verb for the given file extension in the registry. Explorer
+ * passes a multi-selection at once to the given drop target and falls back to
+ * one invocation per file via the command-line otherwise.
  *
  * @param[in] configUrl - INI file path
  * @param[in] configGroup - INI section name
  * @param[in] ext - file extension
  * @param[in] verb - static context menu verb
  * @param[in] text - display string for the context menu entry
+ * @param[in] clsid - class ID string of the drop target
  * @param[in] useHklm - `true` for local machine, else `false` for current user
  * @return `true` on success, else `false`
  */
-bool regRegister(const wchar_t * configUrl, const wchar_t * configGroup, const wchar_t * ext, const wchar_t * verb, const wchar_t * text, const bool useHklm) {
+bool regRegister(const wchar_t * configUrl, const wchar_t * configGroup, const wchar_t * ext, const wchar_t * verb, const wchar_t * text, const wchar_t * clsid, const bool useHklm) {
 	const HKEY hRoot = useHklm ? HKEY_LOCAL_MACHINE : HKEY_CURRENT_USER;
 	wchar_t path[2 * MAX_REG_KEY_NAME];
 	wchar_t val[MAX_REG_KEY_NAME + 1];
@@ -144,6 +289,20 @@ bool regRegister(const wchar_t * configUrl, const wchar_t * configGroup, const w
 	if (RegSetValueExW(hKey, L"MUIVerb", 0, REG_SZ, (LPCBYTE)text, (DWORD)((wcslen(text) + 1) * sizeof(wchar_t))) != ERROR_SUCCESS) {
 		goto onError;
 	}
+	/* deliver all selected files to a single invocation */
+	if (RegSetValueExW(hKey, L"MultiSelectModel", 0, REG_SZ, (LPCBYTE)L"Player", (DWORD)sizeof(L"Player")) != ERROR_SUCCESS) {
+		goto onError;
+	}
+	regCloseKeyPtr(&hKey);
+	const size_t pathLen = wcslen(path);
+	wcscat_s(path, ARRAY_SIZE(path), L"\\DropTarget");
+	if (RegCreateKeyExW(hRoot, path, 0, NULL, REG_OPTION_NON_VOLATILE, KEY_ALL_ACCESS, NULL, &hKey, NULL) != ERROR_SUCCESS) {
+		goto onError;
+	}
+	if (RegSetValueExW(hKey, L"Clsid", 0, REG_SZ, (LPCBYTE)clsid, (DWORD)((wcslen(clsid) + 1) * sizeof(wchar_t))) != ERROR_SUCCESS) {
+		goto onError;
+	}
+	path[pathLen] = 0;
 	/* add command */
 	regCloseKeyPtr(&hKey);
 	wcscat_s(path, ARRAY_SIZE(path), L"\\command");
@@ -221,6 +380,17 @@ bool regUnregister(const wchar_t * ext, const wchar_t * verb, const bool useHklm
 	regCloseKeyPtr(&hKey);
 	wcscat_s(path, ARRAY_SIZE(path), L"\\shell\\");
 	wcscat_s(path, ARRAY_SIZE(path), verb);
+	/* delete associated drop target */
+	const size_t pathLen = wcslen(path);
+	wcscat_s(path, ARRAY_SIZE(path), L"\\DropTarget");
+	ZeroMemory(val, sizeof(val));
+	valLen = (DWORD)sizeof(val);
+	if (RegGetValueW(hRoot, path, L"Clsid", RRF_RT_REG_SZ, NULL, val, &valLen) == ERROR_SUCCESS && *val == L'{') {
+		wchar_t clsidPath[2 * MAX_REG_KEY_NAME];
+		snwprintf(clsidPath, ARRAY_SIZE(clsidPath), L"SOFTWARE\\Classes\\CLSID\\%s", val);
+		RegDeleteTreeW(hRoot, clsidPath);
+	}
+	path[pathLen] = 0;
 	switch (RegDeleteTreeW(hRoot, path)) {
 	case ERROR_SUCCESS:
 	case ERROR_FILE_NOT_FOUND:
@@ -247,11 +417,6 @@ onError:
  * @return program exit code
  */
 int modRegistry(const bool reg, const wchar_t * configUrl, const wchar_t * configGroup, wchar_t * regEntry) {
-	static const wchar_t * exts[] = {
-		L".exe",
-		L".dll",
-		L".ps1"
-	};
 	if (configUrl == NULL || regEntry == NULL) {
 		MessageBoxW(NULL, errStr[ERR_INVALID_ARG], L"Error (modRegistry)", MB_OK | MB_ICONERROR);
 		return 1;
@@ -272,14 +437,23 @@ int modRegistry(const bool reg, const wchar_t * configUrl, const wchar_t * confi
 			showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (modRegistry)", errStr[ERR_INVALID_REG_VERB], regVerb);
 			return 1;
 		}
-		for (size_t i = 0; i < ARRAY_SIZE(exts); ++i) {
+		/* remove a previous registration including its drop target */
+		for (size_t i = 0; i < ARRAY_SIZE(regExts); ++i) {
+			regUnregister(regExts[i], regVerb, useHklm);
+		}
+		/* create a new drop target class ID shared by all extensions */
+		GUID guid;
+		wchar_t clsid[64];
+		res = SUCCEEDED(CoCreateGuid(&guid)) && StringFromGUID2(&guid, clsid, (int)ARRAY_SIZE(clsid)) > 0;
+		res = res && regRegisterDropTarget(configUrl, configGroup, regVerb, clsid, useHklm);
+		for (size_t i = 0; i < ARRAY_SIZE(regExts); ++i) {
 			/* register until error */
-			res = res && regRegister(configUrl, configGroup, exts[i], regVerb, regText, useHklm);
+			res = res && regRegister(configUrl, configGroup, regExts[i], regVerb, regText, clsid, useHklm);
 		}
 		if ( ! res ) {
 			/* roll back on error */
-			for (size_t i = 0; i < ARRAY_SIZE(exts); ++i) {
-				regUnregister(exts[i], regVerb, useHklm);
+			for (size_t i = 0; i < ARRAY_SIZE(regExts); ++i) {
+				regUnregister(regExts[i], regVerb, useHklm);
 			}
 		}
 	} else {
@@ -288,9 +462,9 @@ int modRegistry(const bool reg, const wchar_t * configUrl, const wchar_t * confi
 			showFmtMsg(NULL, MB_OK | MB_ICONERROR, L"Error (modRegistry)", errStr[ERR_INVALID_REG_VERB], regVerb);
 			return 1;
 		}
-		for (size_t i = 0; i < ARRAY_SIZE(exts); ++i) {
+		for (size_t i = 0; i < ARRAY_SIZE(regExts); ++i) {
 			/* unregister all even on single error */
-			res = regUnregister(exts[i], regVerb, useHklm) && res;
+			res = regUnregister(regExts[i], regVerb, useHklm) && res;
 		}
 	}
 	SHChangeNotify(SHCNE_ASSOCCHANGED, SHCNF_IDLIST, NULL, NULL);
@@ -0,0 +1,1695 @@
+/**
+ * @file siguwi-remote.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Keep-alive HTTP connection of an agent thread to its agent.
+ */
+typedef struct {
+	tRemoteAgent * agent; /**< connected agent */
+	char * buf; /**< receive buffer or `NULL` */
+	size_t size; /**< capacity of `buf` in bytes */
+	unsigned status; /**< HTTP status code of the last response */
+	const char * body; /**< body of the last response within `buf` */
+	size_t bodyLen; /**< length of `body` in bytes */
+	const wchar_t * reason; /**< reason of the last transport failure */
+	bool sent; /**< the last request was sent completely */
+	char session[AGENT_SESSION_LEN + 3]; /**< raw `session` token of the agent or empty if not known yet */
+} tRemoteConn;
+
+
+/**
+ * Status of a single item at the agent.
+ */
+typedef struct {
+	size_t id; /**< item identifier at the agent */
+	const char * path; /**< raw `path` token or `NULL` */
+	size_t pathLen; /**< length of `path` in bytes */
+	bool done; /**< item reached a final state? */
+	tProcState state; /**< processing state */
+	bool hasExitCode; /**< `exitCode` is valid */
+	DWORD exitCode; /**< exit code of the signing application */
+} tRemoteItem;
+
+
+/**
+ * Parsed JSON response of an agent. String values are kept as raw JSON tokens
+ * within the response body including the quotes.
+ */
+typedef struct {
+	const char * session; /**< raw `session` token or `NULL` */
+	size_t sessionLen; /**< length of `session` in bytes */
+	uint64_t seq; /**< item change sequence number */
+	size_t count; /**< number of items at the agent */
+	size_t pending; /**< number of pending or running items at the agent */
+	tVector * items; /**< item states (`tRemoteItem`) or `NULL` */
+	const char * path; /**< raw `path` token or `NULL` */
+	size_t pathLen; /**< length of `path` in bytes */
+} tRemoteStatus;
+
+
+/**
+ * JSON response body parsing context.
+ */
+typedef struct {
+	const char * ptr; /**< current parsing position */
+	const char * end; /**< end of the body */
+} tRemoteJson;
+
+
+/**
+ * Maximum nesting depth of skipped JSON values.
+ */
+#define REMOTE_JSON_DEPTH 8
+
+
+/**
+ * Maximum size of an agent response in bytes.
+ */
+#define REMOTE_MAX_RESPONSE (64*1024*1024)
+
+
+/**
+ * Returns whether the remote pool is shutting down.
+ *
+ * @param[in,out] pool - remote pool
+ * @return `true` if stopping, else `false`
+ */
+static bool remoteStopping(tRemotePool * pool) {
+	EnterCriticalSection(&(pool->lock));
+	const bool stop = pool->stop;
+	LeaveCriticalSection(&(pool->lock));
+	return stop;
+}
+
+
+/**
+ * Waits until the given tick count is reached or the pool shuts down.
+ *
+ * @param[in,out] pool - remote pool
+ * @param[in] until - `GetTickCount64()` value to wait for
+ * @return `true` if stopping, else `false`
+ */
+static bool remoteSleep(tRemotePool * pool, const ULONGLONG until) {
+	EnterCriticalSection(&(pool->lock));
+	for (;;) {
+		const ULONGLONG now = GetTickCount64();
+		if (pool->stop || now >= until) {
+			break;
+		}
+		SleepConditionVariableCS(&(pool->wake), &(pool->lock), (DWORD)(until - now));
+	}
+	const bool stop = pool->stop;
+	LeaveCriticalSection(&(pool->lock));
+	return stop;
+}
+
+
+/**
+ * Closes the connection to the agent.
+ *
+ * @param[in,out] c - agent connection
+ */
+static void remoteDisconnect(tRemoteConn * c) {
+	tRemotePool * pool = c->agent->pool;
+	EnterCriticalSection(&(pool->lock));
+	const SOCKET sock = c->agent->sock;
+	c->agent->sock = INVALID_SOCKET;
+	LeaveCriticalSection(&(pool->lock));
+	if (sock != INVALID_SOCKET) {
+		closesocket(sock);
+	}
+}
+
+
+/**
+ * Connects to the agent. The connection attempt is aborted after
+ * `REMOTE_CONNECT_TIMEOUT` or on shutdown.
+ *
+ * @param[in,out] c - agent connection
+ * @return `true` on success, else `false` with the reason in `c->reason`
+ */
+static bool remoteConnect(tRemoteConn * c) {
+	tRemoteAgent * agent = c->agent;
+	tRemotePool * pool = agent->pool;
+	ADDRINFOW hints;
+	ADDRINFOW * res = NULL;
+	wchar_t port[8];
+	ZeroMemory(&hints, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+	swprintf(port, ARRAY_SIZE(port), L"%u", (unsigned)(agent->port));
+	if (GetAddrInfoW(agent->host, port, &hints, &res) != 0 || res == NULL) {
+		c->reason = L"host not found";
+		return false;
+	}
+	c->reason = L"connection failed";
+	bool connected = false;
+	for (const ADDRINFOW * ai = res; ai != NULL && ( ! connected ); ai = ai->ai_next) {
+		SOCKET sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (sock == INVALID_SOCKET) {
+			continue;
+		}
+		/* register the socket to let a shutdown abort blocking operations */
+		EnterCriticalSection(&(pool->lock));
+		const bool stop = pool->stop;
+		if ( ! stop ) {
+			agent->sock = sock;
+		}
+		LeaveCriticalSection(&(pool->lock));
+		if ( stop ) {
+			closesocket(sock);
+			break;
+		}
+		u_long nonBlocking = 1;
+		ioctlsocket(sock, FIONBIO, &nonBlocking);
+		if (connect(sock, ai->ai_addr, (int)(ai->ai_addrlen)) == 0) {
+			connected = true;
+		} else if (WSAGetLastError() == WSAEWOULDBLOCK) {
+			/* wait in slices to notice a shutdown early */
+			for (DWORD waited = 0; waited < REMOTE_CONNECT_TIMEOUT && ( ! connected ) && ( ! remoteStopping(pool) ); waited += 250) {
+				fd_set writable, failed;
+				FD_ZERO(&writable);
+				FD_ZERO(&failed);
+				FD_SET(sock, &writable);
+				FD_SET(sock, &failed);
+				const struct timeval tv = {0, 250000};
+				const int n = select(0, NULL, &writable, &failed, &tv);
+				if (n < 0 || (n > 0 && FD_ISSET(sock, &failed))) {
+					break;
+				}
+				connected = (n > 0 && FD_ISSET(sock, &writable));
+			}
+		}
+		if ( ! connected ) {
+			remoteDisconnect(c);
+			continue;
+		}
+		nonBlocking = 0;
+		ioctlsocket(sock, FIONBIO, &nonBlocking);
+		BOOL noDelay = TRUE;
+		setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&noDelay, sizeof(noDelay));
+	}
+	FreeAddrInfoW(res);
+	return connected;
+}
+
+
+/**
+ * Sends all given bytes on the connection.
+ *
+ * @param[in] sock - connected socket
+ * @param[in] data - data to send
+ * @param[in] len - length of `data` in bytes
+ * @return `true` on success, else `false`
+ */
+static bool remoteSend(SOCKET sock, const char * data, size_t len) {
+	while (len > 0) {
+		const int chunk = (len > (size_t)INT_MAX) ? INT_MAX : (int)len;
+		const int n = send(sock, data, chunk, 0);
+		if (n <= 0) {
+			return false;
+		}
+		data += n;
+		len -= (size_t)n;
+	}
+	return true;
+}
+
+
+/**
+ * Receives the complete response to the last request. The response needs to
+ * carry the `Content-Length` header field.
+ *
+ * @param[in,out] c - agent connection
+ * @param[in] sock - connected socket
+ * @param[out] auth - receives the `X-Siguwi-Auth` value (`2 * SHA256_SIZE + 1` bytes) or an empty string
+ * @param[out] close - receives whether the agent closes the connection
+ * @return `true` on success, else `false` with the reason in `c->reason`
+ */
+static bool remoteReceive(tRemoteConn * c, SOCKET sock, char * auth, bool * close) {
+	size_t len = 0;
+	size_t headerLen = 0;
+	size_t bodyLen = 0;
+	*auth = 0;
+	*close = false;
+	c->reason = L"connection lost";
+	for (;;) {
+		if ((len + 4096) > c->size) {
+			const size_t size = (c->size > 0) ? c->size * 2 : 65536;
+			char * buf = (size <= (REMOTE_MAX_RESPONSE + 65536)) ? realloc(c->buf, size) : NULL;
+			if (buf == NULL) {
+				c->reason = L"response too large";
+				return false;
+			}
+			c->buf = buf;
+			c->size = size;
+		}
+		const int n = recv(sock, c->buf + len, (int)(c->size - len - 1), 0);
+		if (n <= 0) {
+			if (n < 0 && WSAGetLastError() == WSAETIMEDOUT) {
+				c->reason = L"timeout";
+			}
+			return false;
+		}
+		len += (size_t)n;
+		c->buf[len] = 0;
+		if (headerLen == 0) {
+			const char * end = strstr(c->buf, "\r\n\r\n");
+			if (end == NULL) {
+				if (len > 8192) {
+					c->reason = L"invalid response";
+					return false;
+				}
+				continue;
+			}
+			headerLen = (size_t)(end - c->buf) + 4;
+			if (strncmp(c->buf, "HTTP/1.1 ", 9) != 0 || c->buf[9] < '1' || c->buf[9] > '5') {
+				c->reason = L"invalid response";
+				return false;
+			}
+			c->status = (unsigned)strtoul(c->buf + 9, NULL, 10);
+			bool hasLength = false;
+			for (const char * line = strstr(c->buf, "\r\n") + 2; line < end; line = strstr(line, "\r\n") + 2) {
+				if (_strnicmp(line, "Content-Length:", 15) == 0) {
+					hasLength = true;
+					bodyLen = (size_t)strtoull(line + 15, NULL, 10);
+				} else if (_strnicmp(line, "X-Siguwi-Auth:", 14) == 0) {
+					const char * value = line + 14;
+					for (; *value == ' '; ++value);
+					if (strspn(value, "0123456789abcdef") == (2 * SHA256_SIZE)) {
+						memcpy(auth, value, 2 * SHA256_SIZE);
+						auth[2 * SHA256_SIZE] = 0;
+					}
+				} else if (_strnicmp(line, "Connection:", 11) == 0) {
+					const char * value = line + 11;
+					for (; *value == ' '; ++value);
+					*close = (_strnicmp(value, "close", 5) == 0);
+				}
+			}
+			if (( ! hasLength ) || bodyLen > REMOTE_MAX_RESPONSE) {
+				c->reason = L"invalid response";
+				return false;
+			}
+		}
+		if (len >= (headerLen + bodyLen)) {
+			c->body = c->buf + headerLen;
+			c->bodyLen = bodyLen;
+			return true;
+		}
+	}
+}
+
+
+/**
+ * Sends a signed request to the agent and receives its signed response. The
+ * connection is kept open for the next request.
+ *
+ * @param[in,out] c - agent connection
+ * @param[in] method - HTTP method
+ * @param[in] target - request target
+ * @param[in] type - content type of `body` or `NULL`
+ * @param[in] body - request body or `NULL`
+ * @param[in] bodyLen - length of `body` in bytes
+ * @param[in] timeout - receive timeout in milliseconds
+ * @return `true` if an authentic response was received (see `c->status`), else `false` with the reason in `c->reason`
+ */
+static bool remoteRequest(tRemoteConn * c, const char * method, const char * target, const char * type, const char * body, const size_t bodyLen, const DWORD timeout) {
+	tRemoteAgent * agent = c->agent;
+	tRemotePool * pool = agent->pool;
+	c->sent = false;
+	if (agent->sock == INVALID_SOCKET && ( ! remoteConnect(c) )) {
+		return false;
+	}
+	const SOCKET sock = agent->sock;
+	setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+	setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+	/* sign the request */
+	char nonce[AGENT_NONCE_LEN + 1];
+	char mac[(2 * SHA256_SIZE) + 1];
+	snprintf(nonce, sizeof(nonce), "%016" PRIx64 "%016" PRIx64, httpAuthTime(), (uint64_t)InterlockedIncrement64(&(pool->nonce)));
+	const char * parts[] = {method, target, nonce, body};
+	const size_t lens[] = {strlen(method), strlen(target), AGENT_NONCE_LEN, bodyLen};
+	httpAuthMac(pool->key, pool->keyLen, parts, lens, ARRAY_SIZE(parts), mac);
+	char header[1024];
+	const int headerLen = snprintf(header, sizeof(header),
+		"%s %s HTTP/1.1\r\nHost: %s\r\nX-Siguwi-Auth: %s:%s\r\n%s%s%sContent-Length: %zu\r\n\r\n",
+		method, target, agent->hostHdr, nonce, mac,
+		(type != NULL) ? "Content-Type: " : "", (type != NULL) ? type : "", (type != NULL) ? "\r\n" : "",
+		bodyLen
+	);
+	c->reason = L"connection lost";
+	if (headerLen <= 0 || (size_t)headerLen >= sizeof(header) || ( ! remoteSend(sock, header, (size_t)headerLen) ) || ( ! remoteSend(sock, body, bodyLen) )) {
+		remoteDisconnect(c);
+		return false;
+	}
+	/* the agent may act on the request from now on even if the response gets lost */
+	c->sent = true;
+	/* receive and verify the response */
+	char auth[(2 * SHA256_SIZE) + 1];
+	bool close = false;
+	if ( ! remoteReceive(c, sock, auth, &close) ) {
+		remoteDisconnect(c);
+		return false;
+	}
+	char status[16];
+	snprintf(status, sizeof(status), "%u", c->status);
+	const char * respParts[] = {mac, status, c->body};
+	const size_t respLens[] = {strlen(mac), strlen(status), c->bodyLen};
+	httpAuthMac(pool->key, pool->keyLen, respParts, respLens, ARRAY_SIZE(respParts), mac);
+	if (*auth == 0 || ( ! httpAuthEqual(mac, auth, 2 * SHA256_SIZE) )) {
+		c->reason = (c->status == 401) ? L"authentication failed" : L"invalid response signature";
+		remoteDisconnect(c);
+		return false;
+	}
+	if ( close ) {
+		remoteDisconnect(c);
+	}
+	return true;
+}
+
+
+/**
+ * Skips white-space in the JSON response body.
+ *
+ * @param[in,out] j - JSON parsing context
+ */
+static void remoteJsonSkipWs(tRemoteJson * j) {
+	for (; j->ptr < j->end && (*(j->ptr) == ' ' || *(j->ptr) == '\t' || *(j->ptr) == '\r' || *(j->ptr) == '\n'); ++(j->ptr));
+}
+
+
+/**
+ * Consumes the given character after optional white-space.
+ *
+ * @param[in,out] j - JSON parsing context
+ * @param[in] c - expected character
+ * @return `true` if consumed, else `false`
+ */
+static bool remoteJsonExpect(tRemoteJson * j, const char c) {
+	remoteJsonSkipWs(j);
+	if (j->ptr < j->end && *(j->ptr) == c) {
+		++(j->ptr);
+		return true;
+	}
+	return false;
+}
+
+
+/**
+ * Consumes the given literal after optional white-space.
+ *
+ * @param[in,out] j - JSON parsing context
+ * @param[in] lit - expected literal
+ * @return `true` if consumed, else `false`
+ */
+static bool remoteJsonLiteral(tRemoteJson * j, const char * lit) {
+	remoteJsonSkipWs(j);
+	const size_t len = strlen(lit);
+	if ((size_t)(j->end - j->ptr) >= len && memcmp(j->ptr, lit, len) == 0) {
+		j->ptr += len;
+		return true;
+	}
+	return false;
+}
+
+
+/**
+ * Parses a JSON string token without unescaping it.
+ *
+ * @param[in,out] j - JSON parsing context
+ * @param[out] str - receives the token start including the opening quote
+ * @param[out] len - receives the token length including both quotes
+ * @return `true` on success, else `false`
+ */
+static bool remoteJsonString(tRemoteJson * j, const char ** str, size_t * len) {
+	remoteJsonSkipWs(j);
+	const char * start = j->ptr;
+	if ( ! remoteJsonExpect(j, '"') ) {
+		return false;
+	}
+	while (j->ptr < j->end && *(j->ptr) != '"') {
+		if (*(j->ptr) == '\\') {
+			++(j->ptr);
+		}
+		++(j->ptr);
+	}
+	if (j->ptr >= j->end) {
+		return false;
+	}
+	++(j->ptr);
+	*str = start;
+	*len = (size_t)(j->ptr - start);
+	return true;
+}
+
+
+/**
+ * Parses a non-negative JSON integer.
+ *
+ * @param[in,out] j - JSON parsing context
+ * @param[out] value - receives the parsed value
+ * @return `true` on success, else `false`
+ */
+static bool remoteJsonNum(tRemoteJson * j, uint64_t * value) {
+	remoteJsonSkipWs(j);
+	const char * start = j->ptr;
+	*value = 0;
+	for (; j->ptr < j->end && *(j->ptr) >= '0' && *(j->ptr) <= '9' && (j->ptr - start) < 19; ++(j->ptr)) {
+		*value = (*value * 10) + (uint64_t)(*(j->ptr) - '0');
+	}
+	return j->ptr > start;
+}
+
+
+/**
+ * Skips the next JSON value.
+ *
+ * @param[in,out] j - JSON parsing context
+ * @param[in] depth - remaining nesting depth
+ * @return `true` on success, else `false`
+ */
+static bool remoteJsonSkip(tRemoteJson * j, const unsigned depth) {
+	const char * str;
+	size_t len;
+	uint64_t num;
+	remoteJsonSkipWs(j);
+	if (j->ptr >= j->end || depth == 0) {
+		return false;
+	}
+	switch (*(j->ptr)) {
+	case '"':
+		return remoteJsonString(j, &str, &len);
+	case '{':
+		++(j->ptr);
+		if ( remoteJsonExpect(j, '}') ) {
+			return true;
+		}
+		do {
+			if (( ! remoteJsonString(j, &str, &len) ) || ( ! remoteJsonExpect(j, ':') ) || ( ! remoteJsonSkip(j, depth - 1) )) {
+				return false;
+			}
+		} while ( remoteJsonExpect(j, ',') );
+		return remoteJsonExpect(j, '}');
+	case '[':
+		++(j->ptr);
+		if ( remoteJsonExpect(j, ']') ) {
+			return true;
+		}
+		do {
+			if ( ! remoteJsonSkip(j, depth - 1) ) {
+				return false;
+			}
+		} while ( remoteJsonExpect(j, ',') );
+		return remoteJsonExpect(j, ']');
+	default:
+		break;
+	}
+	return remoteJsonLiteral(j, "true") || remoteJsonLiteral(j, "false") || remoteJsonLiteral(j, "null") || remoteJsonNum(j, &num);
+}
+
+
+/**
+ * Maps the given JSON result string token to the processing state.
+ *
+ * @param[in] str - raw string token including the quotes
+ * @param[in] len - length of `str` in bytes
+ * @return processing state or `PST_FAIL` if unknown
+ */
+static tProcState remoteState(const char * str, const size_t len) {
+	for (size_t i = 0; i < PST_COUNT; ++i) {
+		const wchar_t * name = procStateStr[i];
+		size_t n = 1;
+		for (; n < (len - 1) && name[n - 1] != 0 && (wchar_t)(unsigned char)(str[n]) == name[n - 1]; ++n);
+		if (n == (len - 1) && name[n - 1] == 0) {
+			return (tProcState)i;
+		}
+	}
+	return PST_FAIL;
+}
+
+
+/**
+ * Parses a single item object of a status response.
+ *
+ * @param[in,out] j - JSON parsing context
+ * @param[out] item - receives the item status
+ * @return `true` on success, else `false`
+ */
+static bool remoteParseItem(tRemoteJson * j, tRemoteItem * item) {
+	ZeroMemory(item, sizeof(*item));
+	item->state = PST_FAIL;
+	bool hasId = false;
+	if ( ! remoteJsonExpect(j, '{') ) {
+		return false;
+	}
+	do {
+		const char * key;
+		size_t keyLen;
+		const char * str;
+		size_t len;
+		uint64_t num;
+		if (( ! remoteJsonString(j, &key, &keyLen) ) || ( ! remoteJsonExpect(j, ':') )) {
+			return false;
+		}
+		if (keyLen == 4 && memcmp(key, "\"id\"", 4) == 0) {
+			if (( ! remoteJsonNum(j, &num) ) || num >= (uint64_t)SIZE_MAX) {
+				return false;
+			}
+			item->id = (size_t)num;
+			hasId = true;
+		} else if (keyLen == 6 && memcmp(key, "\"path\"", 6) == 0) {
+			if ( ! remoteJsonString(j, &(item->path), &(item->pathLen)) ) {
+				return false;
+			}
+		} else if (keyLen == 8 && memcmp(key, "\"result\"", 8) == 0) {
+			if ( ! remoteJsonString(j, &str, &len) ) {
+				return false;
+			}
+			item->state = remoteState(str, len);
+		} else if (keyLen == 6 && memcmp(key, "\"done\"", 6) == 0) {
+			if ( remoteJsonLiteral(j, "true") ) {
+				item->done = true;
+			} else if ( ! remoteJsonLiteral(j, "false") ) {
+				return false;
+			}
+		} else if (keyLen == 10 && memcmp(key, "\"exitCode\"", 10) == 0) {
+			if ( remoteJsonNum(j, &num) ) {
+				item->hasExitCode = true;
+				item->exitCode = (DWORD)num;
+			} else if ( ! remoteJsonLiteral(j, "null") ) {
+				return false;
+			}
+		} else if ( ! remoteJsonSkip(j, REMOTE_JSON_DEPTH) ) {
+			return false;
+		}
+	} while ( remoteJsonExpect(j, ',') );
+	return remoteJsonExpect(j, '}') && hasId;
+}
+
+
+/**
+ * Parses the given JSON response object.
+ *
+ * @param[in,out] j - JSON parsing context
+ * @param[out] st - receives the parsed response
+ * @return `true` on success, else `false`
+ */
+static bool remoteParseStatus(tRemoteJson * j, tRemoteStatus * st) {
+	ZeroMemory(st, sizeof(*st));
+	if ( ! remoteJsonExpect(j, '{') ) {
+		return false;
+	}
+	if ( remoteJsonExpect(j, '}') ) {
+		return true;
+	}
+	do {
+		const char * key;
+		size_t keyLen;
+		uint64_t num;
+		if (( ! remoteJsonString(j, &key, &keyLen) ) || ( ! remoteJsonExpect(j, ':') )) {
+			return false;
+		}
+		if (keyLen == 9 && memcmp(key, "\"session\"", 9) == 0) {
+			if ( ! remoteJsonString(j, &(st->session), &(st->sessionLen)) ) {
+				return false;
+			}
+		} else if (keyLen == 5 && memcmp(key, "\"seq\"", 5) == 0) {
+			if ( ! remoteJsonNum(j, &(st->seq)) ) {
+				return false;
+			}
+		} else if (keyLen == 7 && memcmp(key, "\"count\"", 7) == 0) {
+			if ( ! remoteJsonNum(j, &num) ) {
+				return false;
+			}
+			st->count = (size_t)num;
+		} else if (keyLen == 9 && memcmp(key, "\"pending\"", 9) == 0) {
+			if ( ! remoteJsonNum(j, &num) ) {
+				return false;
+			}
+			st->pending = (size_t)num;
+		} else if (keyLen == 6 && memcmp(key, "\"path\"", 6) == 0) {
+			if ( ! remoteJsonString(j, &(st->path), &(st->pathLen)) ) {
+				return false;
+			}
+		} else if (keyLen == 7 && memcmp(key, "\"items\"", 7) == 0 && st->items == NULL) {
+			st->items = vec_create(sizeof(tRemoteItem));
+			if (st->items == NULL || ( ! remoteJsonExpect(j, '[') )) {
+				return false;
+			}
+			if ( ! remoteJsonExpect(j, ']') ) {
+				do {
+					tRemoteItem * item = vec_pushBack(st->items);
+					if (item == NULL || ( ! remoteParseItem(j, item) )) {
+						return false;
+					}
+				} while ( remoteJsonExpect(j, ',') );
+				if ( ! remoteJsonExpect(j, ']') ) {
+					return false;
+				}
+			}
+		} else if ( ! remoteJsonSkip(j, REMOTE_JSON_DEPTH) ) {
+			return false;
+		}
+	} while ( remoteJsonExpect(j, ',') );
+	return remoteJsonExpect(j, '}');
+}
+
+
+/**
+ * Parses the JSON response of the last request.
+ *
+ * @param[in] c - agent connection
+ * @param[out] st - receives the parsed response; free `st->items` with `vec_delete()`
+ * @return `true` on success, else `false`
+ */
+static bool remoteParse(const tRemoteConn * c, tRemoteStatus * st) {
+	tRemoteJson j = {c->body, c->body + c->bodyLen};
+	if ( ! remoteParseStatus(&j, st) ) {
+		vec_delete(st->items);
+		st->items = NULL;
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * Takes over the agent session reported in the given response. Item
+ * identifiers are only valid within the same session. A changed session means
+ * that the agent restarted and lost all items.
+ *
+ * @param[in,out] c - agent connection
+ * @param[in] st - parsed agent response
+ * @param[out] restarted - receives whether the session changed
+ * @return `true` on success, else `false` with the reason in `c->reason`
+ */
+static bool remoteSession(tRemoteConn * c, const tRemoteStatus * st, bool * restarted) {
+	*restarted = false;
+	if (st->session == NULL || st->sessionLen >= sizeof(c->session)) {
+		c->reason = L"invalid response";
+		return false;
+	}
+	if (*(c->session) != 0 && (strlen(c->session) != st->sessionLen || memcmp(c->session, st->session, st->sessionLen) != 0)) {
+		*restarted = true;
+	}
+	memcpy(c->session, st->session, st->sessionLen);
+	c->session[st->sessionLen] = 0;
+	return true;
+}
+
+
+/**
+ * Frees the given job.
+ *
+ * @param[in,out] job - remote job
+ */
+static void remoteFree(tRemoteJob * job) {
+	wStrDelete(&(job->path));
+	if (job->remotePath != NULL) {
+		free(job->remotePath);
+	}
+	if (job->remoteName != NULL) {
+		free(job->remoteName);
+	}
+	if (job->output != NULL) {
+		free(job->output);
+	}
+	free(job);
+}
+
+
+/**
+ * Moves the given job to the list of finished jobs and signals the process
+ * window thread.
+ *
+ * @param[in,out] pool - remote pool
+ * @param[in,out] job - finished job
+ */
+static void remoteFinish(tRemotePool * pool, tRemoteJob * job) {
+	EnterCriticalSection(&(pool->lock));
+	job->next = pool->done;
+	pool->done = job;
+	LeaveCriticalSection(&(pool->lock));
+	SetEvent(pool->hDone);
+}
+
+
+/**
+ * Moves the given jobs to the list of finished jobs as failed and signals the
+ * process window thread.
+ *
+ * @param[in,out] pool - remote pool
+ * @param[in,out] list - jobs linked via `next` or `NULL`
+ * @param[in] reason - reason why the jobs failed
+ */
+static void remoteFail(tRemotePool * pool, tRemoteJob * list, const wchar_t * reason) {
+	if (list == NULL) {
+		return;
+	}
+	EnterCriticalSection(&(pool->lock));
+	while (list != NULL) {
+		tRemoteJob * job = list;
+		list = job->next;
+		job->state = PST_FAIL;
+		job->error = reason;
+		job->next = pool->done;
+		pool->done = job;
+	}
+	LeaveCriticalSection(&(pool->lock));
+	SetEvent(pool->hDone);
+}
+
+
+/**
+ * Passes the given jobs back to the queue. This is only valid for jobs no
+ * agent signs in place anymore. Jobs which were already passed to
+ * `REMOTE_MAX_ATTEMPTS` agents fail instead.
+ *
+ * @param[in,out] pool - remote pool
+ * @param[in,out] list - jobs linked via `next`
+ * @param[in] reason - reason why the agent is unreachable
+ */
+static void remoteRequeue(tRemotePool * pool, tRemoteJob * list, const wchar_t * reason) {
+	bool finished = false;
+	EnterCriticalSection(&(pool->lock));
+	while (list != NULL) {
+		tRemoteJob * job = list;
+		list = job->next;
+		if (job->attempts >= REMOTE_MAX_ATTEMPTS) {
+			job->state = PST_FAIL;
+			job->error = reason;
+			job->next = pool->done;
+			pool->done = job;
+			finished = true;
+			continue;
+		}
+		if (job->remotePath != NULL) {
+			free(job->remotePath);
+			job->remotePath = NULL;
+		}
+		/* files uploaded to the unreachable agent expire in its spool directory (see `AGENT_SPOOL_EXPIRY`) */
+		if (job->remoteName != NULL) {
+			free(job->remoteName);
+			job->remoteName = NULL;
+		}
+		if (job->output != NULL) {
+			free(job->output);
+			job->output = NULL;
+			job->outputLen = 0;
+		}
+		job->state = PST_IDLE;
+		job->hasExitCode = false;
+		job->submitted = 0;
+		job->next = pool->queue;
+		pool->queue = job;
+		if (pool->queueTail == NULL) {
+			pool->queueTail = job;
+		}
+	}
+	LeaveCriticalSection(&(pool->lock));
+	WakeAllConditionVariable(&(pool->wake));
+	if ( finished ) {
+		SetEvent(pool->hDone);
+	}
+}
+
+
+/**
+ * Updates the reachability of the given agent. The process window thread is
+ * signaled on changes.
+ *
+ * @param[in,out] agent - remote agent
+ * @param[in] healthy - agent is reachable?
+ * @param[in] reason - reason why the agent is unreachable
+ */
+static void remoteSetHealth(tRemoteAgent * agent, const bool healthy, const wchar_t * reason) {
+	tRemotePool * pool = agent->pool;
+	EnterCriticalSection(&(pool->lock));
+	const bool changed = (agent->healthy != healthy) || (( ! healthy ) && agent->reason == NULL);
+	agent->healthy = healthy;
+	agent->reason = healthy ? NULL : reason;
+	bool any = false;
+	for (size_t i = 0; i < pool->count && ( ! any ); ++i) {
+		any = pool->agents[i].healthy;
+	}
+	if ( any ) {
+		pool->downSince = 0;
+	} else if (pool->downSince == 0) {
+		pool->downSince = GetTickCount64();
+	}
+	LeaveCriticalSection(&(pool->lock));
+	if ( changed ) {
+		SetEvent(pool->hDone);
+	}
+}
+
+
+/**
+ * Fails all queued jobs once no agent was reachable for
+ * `REMOTE_DOWN_TIMEOUT`.
+ *
+ * @param[in,out] pool - remote pool
+ */
+static void remoteExpire(tRemotePool * pool) {
+	tRemoteJob * list = NULL;
+	EnterCriticalSection(&(pool->lock));
+	if (pool->downSince != 0 && (GetTickCount64() - pool->downSince) >= REMOTE_DOWN_TIMEOUT) {
+		list = pool->queue;
+		pool->queue = NULL;
+		pool->queueTail = NULL;
+	}
+	LeaveCriticalSection(&(pool->lock));
+	remoteFail(pool, list, L"no agent reachable");
+}
+
+
+/**
+ * Uploads the file of the given job to the spool directory of the agent.
+ *
+ * @param[in,out] c - agent connection
+ * @param[in,out] job - remote job
+ * @param[out] st - receives the response to the last chunk with the file path at the agent
+ * @return `true` unless the agent became unreachable; `job->error` is set if the upload failed
+ */
+static bool remoteUpload(tRemoteConn * c, tRemoteJob * job, tRemoteStatus * st) {
+	ZeroMemory(st, sizeof(*st));
+	/* unique name at the agent keeping the file extension for the signing application */
+	char name[128];
+	char * base = wToUtf8(wFileName(job->path));
+	int n = snprintf(name, sizeof(name), "%016" PRIx64 "-", (uint64_t)InterlockedIncrement64(&(c->agent->pool->nonce)));
+	for (const char * ptr = (base != NULL) ? base : ""; *ptr != 0 && n < (int)(sizeof(name) - 1); ++ptr) {
+		const char ch = *ptr;
+		const bool valid = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '.' || ch == '_' || ch == '-';
+		name[n++] = valid ? ch : '_';
+	}
+	name[n] = 0;
+	if (base != NULL) {
+		free(base);
+	}
+	job->remoteName = strdup(name);
+	HANDLE hFile = CreateFileW(job->path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	char * buf = malloc(AGENT_CHUNK_SIZE);
+	if (hFile == INVALID_HANDLE_VALUE || buf == NULL || job->remoteName == NULL) {
+		job->error = (hFile == INVALID_HANDLE_VALUE) ? L"file not readable" : errStr[ERR_OUT_OF_MEMORY];
+		if (hFile != INVALID_HANDLE_VALUE) {
+			CloseHandle(hFile);
+		}
+		if (buf != NULL) {
+			free(buf);
+		}
+		return true;
+	}
+	bool res = true;
+	uint64_t offset = 0;
+	DWORD got;
+	do {
+		char target[256];
+		if ( ! ReadFile(hFile, buf, AGENT_CHUNK_SIZE, &got, NULL) ) {
+			job->error = L"file not readable";
+			break;
+		}
+		snprintf(target, sizeof(target), "/files/%s?offset=%" PRIu64, job->remoteName, offset);
+		if ( ! remoteRequest(c, "PUT", target, "application/octet-stream", buf, (size_t)got, REMOTE_TIMEOUT) ) {
+			res = false;
+			break;
+		}
+		if (c->status != 200) {
+			job->error = (c->status == 413) ? L"file too large for the agent" : L"upload rejected by the agent";
+			break;
+		}
+		offset += (uint64_t)got;
+	} while (got == AGENT_CHUNK_SIZE);
+	CloseHandle(hFile);
+	free(buf);
+	if (res && job->error == NULL && (( ! remoteParse(c, st) ) || st->path == NULL)) {
+		job->error = L"invalid response";
+	}
+	return res;
+}
+
+
+/**
+ * Submits the given job to the agent.
+ *
+ * @param[in,out] c - agent connection
+ * @param[in,out] job - remote job
+ * @param[in,out] seq - item change sequence number of the agent
+ * @param[in,out] pending - number of pending items at the agent
+ * @param[out] restarted - receives whether the agent restarted since the last response
+ * @return `true` unless the agent became unreachable; `job->error` is set if the agent rejected the file
+ */
+static bool remoteSubmit(tRemoteConn * c, tRemoteJob * job, uint64_t * seq, size_t * pending, bool * restarted) {
+	tRemoteStatus st;
+	char * body = NULL;
+	*restarted = false;
+	if ( c->agent->upload ) {
+		if ( ! remoteUpload(c, job, &st) ) {
+			return false;
+		}
+		if (job->error != NULL) {
+			return true;
+		}
+		/* file path at the agent as returned */
+		body = malloc(st.pathLen + 16);
+		if (body != NULL) {
+			snprintf(body, st.pathLen + 16, "{\"files\": [%.*s]}", (int)(st.pathLen), st.path);
+		}
+		vec_delete(st.items);
+	} else {
+		tUStrBuf * sb = usb_create(512);
+		if (sb != NULL) {
+			usb_add(sb, L"{\"files\": [");
+			reportAddJsonStr(sb, job->path);
+			usb_add(sb, L"]}");
+			wchar_t * str = usb_get(sb);
+			usb_delete(sb);
+			body = (str != NULL) ? wToUtf8(str) : NULL;
+			wStrDelete(&str);
+		}
+	}
+	if (body == NULL) {
+		job->error = errStr[ERR_OUT_OF_MEMORY];
+		return true;
+	}
+	const bool res = remoteRequest(c, "POST", "/items", "application/json", body, strlen(body), REMOTE_TIMEOUT);
+	free(body);
+	if ( ! res ) {
+		return false;
+	}
+	if (c->status != 200 || ( ! remoteParse(c, &st) )) {
+		job->error = L"file rejected by the agent";
+		return true;
+	}
+	const tRemoteItem * item = (st.items != NULL && vec_size(st.items) == 1) ? vec_at(st.items, 0) : NULL;
+	if (item == NULL || item->path == NULL) {
+		job->error = L"file rejected by the agent";
+		vec_delete(st.items);
+		return true;
+	}
+	if ( ! remoteSession(c, &st, restarted) ) {
+		vec_delete(st.items);
+		return false;
+	}
+	/* the item path identifies the result of this job at the agent besides its position */
+	job->remotePath = malloc(item->pathLen + 1);
+	if (job->remotePath == NULL) {
+		job->error = errStr[ERR_OUT_OF_MEMORY];
+		vec_delete(st.items);
+		return true;
+	}
+	memcpy(job->remotePath, item->path, item->pathLen);
+	job->remotePath[item->pathLen] = 0;
+	job->remoteId = item->id;
+	job->submitted = reportTicks();
+	*seq = st.seq;
+	*pending = st.pending;
+	vec_delete(st.items);
+	return true;
+}
+
+
+/**
+ * Downloads the signed file of the given job from the agent. The local file is
+ * replaced once the download completed.
+ *
+ * @param[in,out] c - agent connection
+ * @param[in,out] job - remote job
+ * @return `true` unless the agent became unreachable; `job->error` is set if the download failed
+ */
+static bool remoteDownload(tRemoteConn * c, tRemoteJob * job) {
+	const size_t len = wcslen(job->path);
+	wchar_t * part = malloc((len + 13) * sizeof(wchar_t));
+	if (part == NULL) {
+		job->error = errStr[ERR_OUT_OF_MEMORY];
+		return true;
+	}
+	memcpy(part, job->path, len * sizeof(wchar_t));
+	wcscpy_s(part + len, 13, L".siguwi-part");
+	HANDLE hFile = CreateFileW(part, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		job->error = L"signed file not writable";
+		free(part);
+		return true;
+	}
+	bool res = true;
+	uint64_t offset = 0;
+	for (;;) {
+		char target[256];
+		DWORD written = 0;
+		snprintf(target, sizeof(target), "/files/%s?offset=%" PRIu64, job->remoteName, offset);
+		if ( ! remoteRequest(c, "GET", target, NULL, NULL, 0, REMOTE_TIMEOUT) ) {
+			res = false;
+			break;
+		}
+		if (c->status != 200) {
+			job->error = L"signed file not found at the agent";
+			break;
+		}
+		if (c->bodyLen > 0 && ( ! (WriteFile(hFile, c->body, (DWORD)(c->bodyLen), &written, NULL) && (size_t)written == c->bodyLen) )) {
+			job->error = L"signed file not writable";
+			break;
+		}
+		offset += (uint64_t)(c->bodyLen);
+		if (c->bodyLen < AGENT_CHUNK_SIZE) {
+			break;
+		}
+	}
+	CloseHandle(hFile);
+	if (res && job->error == NULL && ( ! MoveFileExW(part, job->path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) )) {
+		job->error = L"signed file not writable";
+	}
+	if ( ! (res && job->error == NULL) ) {
+		DeleteFileW(part);
+	}
+	free(part);
+	return res;
+}
+
+
+/**
+ * Retrieves the result of the given finished job from the agent. Uploaded
+ * files are downloaded if signed successfully and removed from the agent.
+ *
+ * @param[in,out] c - agent connection
+ * @param[in,out] job - remote job
+ * @param[in] item - final item status at the agent
+ * @return `true` unless the agent became unreachable
+ */
+static bool remoteFetch(tRemoteConn * c, tRemoteJob * job, const tRemoteItem * item) {
+	char target[64];
+	job->state = item->state;
+	job->hasExitCode = item->hasExitCode;
+	job->exitCode = item->exitCode;
+	snprintf(target, sizeof(target), "/items/%zu/output", job->remoteId);
+	if ( ! remoteRequest(c, "GET", target, NULL, NULL, 0, REMOTE_TIMEOUT) ) {
+		return false;
+	}
+	/* from a previous attempt interrupted by a connection loss */
+	if (job->output != NULL) {
+		free(job->output);
+		job->output = NULL;
+		job->outputLen = 0;
+	}
+	if (c->status == 200 && c->bodyLen > 0) {
+		job->output = malloc(c->bodyLen);
+		if (job->output != NULL) {
+			memcpy(job->output, c->body, c->bodyLen);
+			job->outputLen = c->bodyLen;
+		}
+	}
+	if (job->remoteName == NULL) {
+		return true;
+	}
+	if (job->state == PST_OK && ( ! remoteDownload(c, job) )) {
+		return false;
+	}
+	if (job->error != NULL) {
+		job->state = PST_FAIL;
+	}
+	/* the result is complete; a failing clean-up only affects the next request */
+	char file[192];
+	snprintf(file, sizeof(file), "/files/%s", job->remoteName);
+	remoteRequest(c, "DELETE", file, NULL, NULL, 0, REMOTE_TIMEOUT);
+	return true;
+}
+
+
+/**
+ * Agent thread. Queued jobs are passed to the agent as long as it has
+ * capacity left. Their progress is tracked with long-poll status requests.
+ * Jobs which were not accepted by an unreachable agent and uploaded files are
+ * passed back to the queue. Files signed in place by an unreachable agent wait
+ * for the same agent to not sign them twice. They fail after
+ * `REMOTE_DOWN_TIMEOUT` or are passed back to the queue once the agent
+ * restarted.
+ *
+ * @param[in,out] param - remote agent
+ * @return always 0
+ */
+static DWORD WINAPI remoteThread(LPVOID param) {
+	tRemoteAgent * agent = (tRemoteAgent *)param;
+	tRemotePool * pool = agent->pool;
+	trace_setThreadName("remote");
+	tRemoteConn conn;
+	ZeroMemory(&conn, sizeof(conn));
+	conn.agent = agent;
+	tRemoteJob * jobs = NULL; /* jobs accepted by the agent */
+	size_t inflight = 0;
+	size_t pending = 0;
+	uint64_t seq = 0;
+	bool healthy = false;
+	bool restarted = false;
+	ULONGLONG retry = 0;
+	ULONGLONG downSince = GetTickCount64();
+	const size_t index = (size_t)(agent - pool->agents);
+	for (;;) {
+		if ( ! healthy ) {
+			/* probe the agent until it is reachable */
+			if ( remoteSleep(pool, retry) ) {
+				break;
+			}
+			retry = GetTickCount64() + REMOTE_RETRY_DELAY;
+			char target[64];
+			tRemoteStatus st;
+			snprintf(target, sizeof(target), "/items?from=%zu", (size_t)SIZE_MAX >> 1);
+			healthy = remoteRequest(&conn, "GET", target, NULL, NULL, 0, REMOTE_TIMEOUT);
+			if (healthy && (conn.status != 200 || ( ! remoteParse(&conn, &st) ))) {
+				conn.reason = L"invalid response";
+				healthy = false;
+			} else if (healthy && ( ! remoteSession(&conn, &st, &restarted) )) {
+				vec_delete(st.items);
+				healthy = false;
+			}
+			remoteSetHealth(agent, healthy, conn.reason);
+			if ( ! healthy ) {
+				remoteDisconnect(&conn);
+				/* give up on the files waiting for this agent or for any agent */
+				if (jobs != NULL && (GetTickCount64() - downSince) >= REMOTE_DOWN_TIMEOUT) {
+					remoteFail(pool, jobs, conn.reason);
+					jobs = NULL;
+					inflight = 0;
+				}
+				remoteExpire(pool);
+				continue;
+			}
+			vec_delete(st.items);
+			seq = st.seq;
+			pending = st.pending;
+			if ( restarted ) {
+				/* the agent lost its items and no longer signs them */
+				remoteRequeue(pool, jobs, L"agent restarted");
+				jobs = NULL;
+				inflight = 0;
+			}
+		}
+		/* take queued jobs while the agent has capacity left */
+		tRemoteJob * taken = NULL;
+		tRemoteJob ** takenTail = &taken;
+		EnterCriticalSection(&(pool->lock));
+		while (( ! pool->stop ) && jobs == NULL && pool->queue == NULL) {
+			SleepConditionVariableCS(&(pool->wake), &(pool->lock), INFINITE);
+		}
+		const bool stop = pool->stop;
+		for (size_t n = 0; ( ! stop ) && pool->queue != NULL && (inflight + n) < REMOTE_AGENT_DEPTH && (pending + n) < REMOTE_AGENT_DEPTH; ++n) {
+			tRemoteJob * job = pool->queue;
+			pool->queue = job->next;
+			if (pool->queue == NULL) {
+				pool->queueTail = NULL;
+			}
+			job->next = NULL;
+			*takenTail = job;
+			takenTail = &(job->next);
+		}
+		LeaveCriticalSection(&(pool->lock));
+		if ( stop ) {
+			break;
+		}
+		/* submit the taken jobs */
+		while (taken != NULL && healthy) {
+			tRemoteJob * job = taken;
+			taken = job->next;
+			job->next = NULL;
+			job->agent = index;
+			++(job->attempts);
+			TRACE_BEGIN("remote", "submit");
+			healthy = remoteSubmit(&conn, job, &seq, &pending, &restarted);
+			TRACE_END("remote", "submit");
+			if ( restarted ) {
+				remoteRequeue(pool, jobs, L"agent restarted");
+				jobs = NULL;
+				inflight = 0;
+			}
+			if (( ! healthy ) && conn.sent && ( ! agent->upload )) {
+				/* the agent may sign the file in place although its response was lost */
+				job->state = PST_FAIL;
+				job->error = conn.reason;
+				remoteFinish(pool, job);
+			} else if ( ! healthy ) {
+				job->next = taken;
+				taken = job;
+			} else if (job->error != NULL) {
+				if (job->state == PST_IDLE) {
+					job->state = PST_FAIL;
+				}
+				remoteFinish(pool, job);
+			} else {
+				job->next = jobs;
+				jobs = job;
+				++inflight;
+			}
+		}
+		/* wait for changes of the submitted jobs or the agent capacity */
+		size_t from = (size_t)SIZE_MAX >> 1;
+		for (const tRemoteJob * job = jobs; job != NULL; job = job->next) {
+			from = (job->remoteId < from) ? job->remoteId : from;
+		}
+		tRemoteStatus st;
+		ZeroMemory(&st, sizeof(st));
+		if ( healthy ) {
+			char target[128];
+			snprintf(target, sizeof(target), "/items?from=%zu&since=%" PRIu64 "&wait=%u", from, seq, (unsigned)REMOTE_POLL_WAIT);
+			healthy = remoteRequest(&conn, "GET", target, NULL, NULL, 0, REMOTE_POLL_WAIT + REMOTE_TIMEOUT);
+			if (healthy && (conn.status != 200 || ( ! remoteParse(&conn, &st) ))) {
+				conn.reason = L"invalid response";
+				healthy = false;
+			} else if (healthy && ( ! remoteSession(&conn, &st, &restarted) )) {
+				healthy = false;
+			}
+		}
+		if (healthy && restarted) {
+			remoteRequeue(pool, jobs, L"agent restarted");
+			jobs = NULL;
+			inflight = 0;
+		}
+		if ( healthy ) {
+			seq = st.seq;
+			pending = st.pending;
+			const size_t count = (st.items != NULL) ? vec_size(st.items) : 0;
+			for (tRemoteJob ** it = &jobs; *it != NULL && healthy; ) {
+				tRemoteJob * job = *it;
+				const tRemoteItem * item = NULL;
+				for (size_t i = 0; i < count && item == NULL; ++i) {
+					const tRemoteItem * candidate = vec_at(st.items, i);
+					item = (candidate->id == job->remoteId) ? candidate : NULL;
+				}
+				/* an item at the same position with another path belongs to someone else */
+				if (item != NULL && (item->path == NULL || item->pathLen != strlen(job->remotePath) || memcmp(item->path, job->remotePath, item->pathLen) != 0)) {
+					item = NULL;
+				} else if (job->remoteId < st.count && (item == NULL || ( ! item->done ))) {
+					it = &(job->next);
+					continue;
+				}
+				*it = job->next;
+				job->next = NULL;
+				--inflight;
+				if (item == NULL) {
+					/* the agent lost the item, e.g. after a restart */
+					remoteRequeue(pool, job, L"agent restarted");
+					continue;
+				}
+				TRACE_BEGIN("remote", "fetch");
+				healthy = remoteFetch(&conn, job, item);
+				TRACE_END("remote", "fetch");
+				if ( healthy ) {
+					remoteFinish(pool, job);
+				} else {
+					job->next = jobs;
+					jobs = job;
+					++inflight;
+				}
+			}
+		}
+		vec_delete(st.items);
+		if ( ! healthy ) {
+			/* pass the jobs which the agent does not sign in place to the others */
+			remoteSetHealth(agent, false, conn.reason);
+			remoteDisconnect(&conn);
+			downSince = GetTickCount64();
+			remoteRequeue(pool, taken, conn.reason);
+			if ( agent->upload ) {
+				remoteRequeue(pool, jobs, conn.reason);
+				jobs = NULL;
+				inflight = 0;
+			}
+			pending = 0;
+		}
+	}
+	/* shutting down */
+	for (tRemoteJob * job = jobs, * next; job != NULL; job = next) {
+		next = job->next;
+		remoteFree(job);
+	}
+	remoteDisconnect(&conn);
+	if (conn.buf != NULL) {
+		free(conn.buf);
+	}
+	return 0;
+}
+
+
+/**
+ * Parses the given agent specification of the form `host:port` or
+ * `host:port,upload`. IPv6 addresses need to be enclosed in brackets.
+ *
+ * @param[in] spec - agent specification
+ * @param[out] host - receives the allocated host name; free with `free()`
+ * @param[out] port - receives the TCP port
+ * @param[out] upload - receives whether the files are uploaded to the agent
+ * @return `true` on success, else `false`
+ */
+bool remoteParseSpec(const wchar_t * spec, wchar_t ** host, unsigned short * port, bool * upload) {
+	if (spec == NULL || host == NULL || port == NULL || upload == NULL) {
+		return false;
+	}
+	*host = NULL;
+	const wchar_t * comma = wcschr(spec, L',');
+	const size_t len = (comma != NULL) ? (size_t)(comma - spec) : wcslen(spec);
+	*upload = (comma != NULL);
+	if (comma != NULL && wcscmp(comma + 1, L"upload") != 0) {
+		return false;
+	}
+	/* split host and port */
+	const wchar_t * hostStart = spec;
+	const wchar_t * hostEnd;
+	const wchar_t * colon;
+	if (*spec == L'[') {
+		hostStart = spec + 1;
+		hostEnd = wmemchr(spec, L']', len);
+		if (hostEnd == NULL || hostEnd[1] != L':') {
+			return false;
+		}
+		colon = hostEnd + 1;
+	} else {
+		colon = wmemchr(spec, L':', len);
+		if (colon == NULL || wmemchr(colon + 1, L':', len - (size_t)(colon + 1 - spec)) != NULL) {
+			return false;
+		}
+		hostEnd = colon;
+	}
+	unsigned long value = 0;
+	const wchar_t * ptr = colon + 1;
+	for (; ptr < (spec + len) && *ptr >= L'0' && *ptr <= L'9' && value <= 65535; ++ptr) {
+		value = (value * 10) + (unsigned long)(*ptr - L'0');
+	}
+	if (hostEnd == hostStart || ptr == (colon + 1) || ptr != (spec + len) || value == 0 || value > 65535) {
+		return false;
+	}
+	const size_t hostLen = (size_t)(hostEnd - hostStart);
+	*host = malloc((hostLen + 1) * sizeof(wchar_t));
+	if (*host == NULL) {
+		return false;
+	}
+	wmemcpy(*host, hostStart, hostLen);
+	(*host)[hostLen] = 0;
+	*port = (unsigned short)value;
+	return true;
+}
+
+
+/**
+ * Creates the remote pool with one thread per given agent. All items are
+ * passed to the agents afterwards.
+ *
+ * @param[in,out] pool - zero initialized remote pool
+ * @param[in] agents - agent specifications (`wchar_t *`), see `remoteParseSpec()`
+ * @param[in] key - shared agent key
+ * @param[in] keyLen - length of `key` in bytes
+ * @return `true` on success, else `false` with the error code in `GetLastError()`
+ * @remarks Call `remoteDelete()` in any case.
+ */
+bool remoteCreate(tRemotePool * pool, tVector * agents, const uint8_t * key, const size_t keyLen) {
+	const size_t count = (agents != NULL) ? vec_size(agents) : 0;
+	if (pool == NULL || count == 0 || count > REMOTE_MAX_AGENTS || key == NULL || keyLen == 0) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return false;
+	}
+	WSADATA wsa;
+	const int err = WSAStartup(MAKEWORD(2, 2), &wsa);
+	if (err != 0) {
+		SetLastError((DWORD)err);
+		return false;
+	}
+	pool->wsaStarted = true;
+	pool->hDone = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (pool->hDone == NULL) {
+		return false;
+	}
+	InitializeCriticalSection(&(pool->lock));
+	InitializeConditionVariable(&(pool->wake));
+	pool->started = true;
+	pool->nonce = (LONG64)((((uint64_t)GetCurrentProcessId()) << 40) ^ (uint64_t)reportTicks());
+	pool->downSince = GetTickCount64();
+	pool->key = malloc(keyLen);
+	pool->agents = calloc(count, sizeof(tRemoteAgent));
+	if (pool->key == NULL || pool->agents == NULL) {
+		SetLastError(ERROR_OUTOFMEMORY);
+		return false;
+	}
+	memcpy(pool->key, key, keyLen);
+	pool->keyLen = keyLen;
+	for (size_t i = 0; i < count; ++i) {
+		const wchar_t * spec = *((wchar_t **)vec_at(agents, i));
+		tRemoteAgent * agent = pool->agents + i;
+		agent->pool = pool;
+		agent->sock = INVALID_SOCKET;
+		agent->noted = true;
+		++(pool->count);
+		if ( ! remoteParseSpec(spec, &(agent->host), &(agent->port), &(agent->upload)) ) {
+			SetLastError(ERROR_INVALID_PARAMETER);
+			return false;
+		}
+		agent->name = wcsdup(spec);
+		if (agent->name != NULL && wcschr(agent->name, L',') != NULL) {
+			*wcschr(agent->name, L',') = 0;
+		}
+		agent->hostHdr = wToUtf8(agent->name);
+		if (agent->name == NULL || agent->hostHdr == NULL) {
+			SetLastError(ERROR_OUTOFMEMORY);
+			return false;
+		}
+	}
+	for (size_t i = 0; i < count; ++i) {
+		pool->agents[i].hThread = CreateThread(NULL, 0, remoteThread, pool->agents + i, 0, NULL);
+		if (pool->agents[i].hThread == NULL) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Passes all pending items of the process list to the remote agents. This
+ * replaces starting the signing application locally.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @return `true` if any item was passed on, else `false`
+ */
+bool remoteDispatch(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ( ! ctx->remote.started )) {
+		return false;
+	}
+	tRemotePool * pool = &(ctx->remote);
+	tRemoteJob * first = NULL;
+	tRemoteJob ** tail = &first;
+	tRemoteJob * last = NULL;
+	const size_t count = vec_size(ctx->v);
+	for (size_t i = pool->next; i < count; ++i) {
+		tProcCtx * item = vec_at(ctx->v, i);
+		if (item->state != PST_IDLE) {
+			continue;
+		}
+		tRemoteJob * job = calloc(1, sizeof(tRemoteJob));
+		if (job != NULL) {
+			job->item = i;
+			job->path = wcsdup(item->path);
+			job->state = PST_IDLE;
+		}
+		if (job == NULL || job->path == NULL) {
+			if (job != NULL) {
+				remoteFree(job);
+			}
+			reportStamp(item, PSG_START);
+			processSetState(ctx, item, PST_FAIL);
+			processNotify(ctx, item, L"remoteDispatch", L"%s", errStr[ERR_OUT_OF_MEMORY]);
+			processUpdateItem(ctx, i);
+			continue;
+		}
+		TRACE_INSTANT("remote", "dispatch", i);
+		reportStamp(item, PSG_START);
+		item->matched = 0;
+		processSetState(ctx, item, PST_RUNNING);
+		processUpdateItem(ctx, i);
+		*tail = job;
+		tail = &(job->next);
+		last = job;
+	}
+	pool->next = count;
+	if (first == NULL) {
+		return false;
+	}
+	EnterCriticalSection(&(pool->lock));
+	if (pool->queueTail != NULL) {
+		pool->queueTail->next = first;
+	} else {
+		pool->queue = first;
+	}
+	pool->queueTail = last;
+	LeaveCriticalSection(&(pool->lock));
+	WakeAllConditionVariable(&(pool->wake));
+	return true;
+}
+
+
+/**
+ * Completes the given finished remote job and frees it. The agent output is
+ * handled like the output of a local signing application.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] job - finished remote job
+ */
+static void remoteJobDone(tIpcWndCtx * ctx, tRemoteJob * job) {
+	tProcCtx * item = (job->item < vec_size(ctx->v)) ? vec_at(ctx->v, job->item) : NULL;
+	if (item == NULL || item->state != PST_RUNNING) {
+		remoteFree(job);
+		return;
+	}
+	if (job->submitted != 0) {
+		item->stamp[PSG_SPAWN] = job->submitted;
+		recordEvent(ctx->rec, RPL_SPAWN, job->item, 0, 0);
+	}
+	if (job->output != NULL && item->output != NULL && job->outputLen <= UINT32_MAX) {
+		const uint8_t * data = (const uint8_t *)(job->output);
+		uint32_t matchState = ACM_START;
+		uint32_t searchState = TGI_START;
+		tUtf8Ctx utf8;
+		size_t outputLen = 0;
+		uint32_t lastChar = 0;
+		ZeroMemory(&utf8, sizeof(utf8));
+		reportStamp(item, PSG_OUTPUT);
+		sessionLogOutput(ctx->log, job->item, data, job->outputLen);
+		recordEvent(ctx->rec, RPL_OUTPUT, job->item, (uint32_t)(job->outputLen), 0);
+		matchOutput(item, &matchState, data, job->outputLen);
+		searchOutput(ctx, job->item, &searchState, data, job->outputLen);
+		engineStampLines(item, outputLen, lastChar, data, job->outputLen);
+		engineDecodeOutput(&utf8, item->output, &outputLen, &lastChar, data, job->outputLen);
+	}
+	const size_t appendFrom = (item->output != NULL) ? usb_len(item->output) : 0;
+	if (job->error != NULL && job->attempts == 0) {
+		processNotify(ctx, item, L"remoteComplete", L"Failed to pass the file to an agent (%s):\n%s", job->error, item->path);
+	} else if (job->error != NULL) {
+		processNotify(ctx, item, L"remoteComplete", errStr[ERR_AGENT_FAILED], ctx->remote.agents[job->agent].name, job->error, item->path);
+	}
+	item->hasExitCode = job->hasExitCode;
+	item->exitCode = job->exitCode;
+	reportStamp(item, PSG_EXIT);
+	const tProcState state = matchApply(item, job->state);
+	/* before the output is stored */
+	searchAppended(ctx, job->item, appendFrom);
+	processSetState(ctx, item, state);
+	processUpdateItem(ctx, job->item);
+	remoteFree(job);
+}
+
+
+/**
+ * Completes all finished remote jobs and reports agent reachability changes.
+ * This is called by the process window thread once `hDone` was signaled.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void remoteComplete(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ( ! ctx->remote.started )) {
+		return;
+	}
+	tRemotePool * pool = &(ctx->remote);
+	EnterCriticalSection(&(pool->lock));
+	tRemoteJob * job = pool->done;
+	pool->done = NULL;
+	LeaveCriticalSection(&(pool->lock));
+	const bool any = (job != NULL);
+	while (job != NULL) {
+		tRemoteJob * next = job->next;
+		remoteJobDone(ctx, job);
+		job = next;
+	}
+	for (size_t i = 0; i < pool->count; ++i) {
+		tRemoteAgent * agent = pool->agents + i;
+		EnterCriticalSection(&(pool->lock));
+		const bool healthy = agent->healthy;
+		const wchar_t * reason = agent->reason;
+		LeaveCriticalSection(&(pool->lock));
+		if (healthy && ( ! agent->noted )) {
+			agent->noted = true;
+			processNotify(ctx, NULL, L"remoteComplete", L"Agent %s is reachable again.", agent->name);
+		} else if (( ! healthy ) && reason != NULL && agent->noted) {
+			agent->noted = false;
+			processNotify(ctx, NULL, L"remoteComplete", errStr[ERR_AGENT_DOWN], agent->name, reason);
+		}
+	}
+	if ( any ) {
+		processUpdateStatus(ctx);
+		searchRefresh(ctx);
+		/* writes the report at batch end */
+		processNext(ctx);
+	}
+}
+
+
+/**
+ * Stops the agent threads. Items which are still being signed by an agent are
+ * left running at the agent but remain unfinished locally.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void remoteDelete(tIpcWndCtx * ctx) {
+	if (ctx == NULL) {
+		return;
+	}
+	tRemotePool * pool = &(ctx->remote);
+	if ( pool->started ) {
+		EnterCriticalSection(&(pool->lock));
+		pool->stop = true;
+		/* abort blocking requests */
+		for (size_t i = 0; i < pool->count; ++i) {
+			if (pool->agents[i].sock != INVALID_SOCKET) {
+				shutdown(pool->agents[i].sock, SD_BOTH);
+			}
+		}
+		LeaveCriticalSection(&(pool->lock));
+		WakeAllConditionVariable(&(pool->wake));
+		for (size_t i = 0; i < pool->count; ++i) {
+			if (pool->agents[i].hThread != NULL) {
+				WaitForSingleObject(pool->agents[i].hThread, INFINITE);
+				CloseHandle(pool->agents[i].hThread);
+				pool->agents[i].hThread = NULL;
+			}
+		}
+		/* the threads are gone; no locking needed anymore */
+		tRemoteJob * lists[2] = {pool->queue, pool->done};
+		pool->queue = NULL;
+		pool->queueTail = NULL;
+		pool->done = NULL;
+		for (size_t i = 0; i < ARRAY_SIZE(lists); ++i) {
+			for (tRemoteJob * job = lists[i], * next; job != NULL; job = next) {
+				next = job->next;
+				remoteFree(job);
+			}
+		}
+		DeleteCriticalSection(&(pool->lock));
+		CloseHandle(pool->hDone);
+		pool->hDone = NULL;
+		pool->started = false;
+	} else if (pool->hDone != NULL) {
+		CloseHandle(pool->hDone);
+		pool->hDone = NULL;
+	}
+	if (pool->agents != NULL) {
+		for (size_t i = 0; i < pool->count; ++i) {
+			wStrDelete(&(pool->agents[i].name));
+			wStrDelete(&(pool->agents[i].host));
+			if (pool->agents[i].hostHdr != NULL) {
+				free(pool->agents[i].hostHdr);
+			}
+		}
+		free(pool->agents);
+		pool->agents = NULL;
+	}
+	pool->count = 0;
+	if (pool->key != NULL) {
+		SecureZeroMemory(pool->key, pool->keyLen);
+		free(pool->key);
+		pool->key = NULL;
+	}
+	if ( pool->wsaStarted ) {
+		WSACleanup();
+		pool->wsaStarted = false;
+	}
+}
@@ -0,0 +1,598 @@
+/**
+ * @file siguwi-report.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Single report metric. It is either derived from two processing stage
+ * timestamps or from a resource usage field.
+ */
+typedef struct {
+	const wchar_t * name; /**< column/field name */
+	tProcStage from; /**< start stage or `PSG_COUNT` for a resource usage metric */
+	tProcStage to; /**< end stage */
+	size_t offset; /**< `uint64_t` field offset within `tProcUsage` */
+	double scale; /**< resource usage field scaling factor */
+	int precision; /**< number of output decimal places */
+} tReportMetric;
+
+
+/**
+ * Aggregated values of a single report metric.
+ */
+typedef struct {
+	size_t count;
+	double min;
+	double max;
+	double sum;
+} tReportAgg;
+
+
+/**
+ * Report metrics. The unit is given by the name suffix.
+ */
+static const tReportMetric reportMetrics[] = {
+	{L"queueWaitMs",         PSG_QUEUED, PSG_START,  0, 0.0, 3},
+	{L"pipeSetupMs",         PSG_START,  PSG_PIPE,   0, 0.0, 3},
+	{L"pinMs",               PSG_PIPE,   PSG_PIN,    0, 0.0, 3},
+	{L"spawnMs",             PSG_PIN,    PSG_SPAWN,  0, 0.0, 3},
+	{L"firstOutputMs",       PSG_SPAWN,  PSG_OUTPUT, 0, 0.0, 3},
+	{L"childRuntimeMs",      PSG_SPAWN,  PSG_EXIT,   0, 0.0, 3},
+	{L"finishMs",            PSG_EXIT,   PSG_DONE,   0, 0.0, 3},
+	{L"totalMs",             PSG_QUEUED, PSG_DONE,   0, 0.0, 3},
+	{L"cpuUserMs",           PSG_COUNT,  PSG_COUNT,  offsetof(tProcUsage, userUs),         0.001, 3},
+	{L"cpuKernelMs",         PSG_COUNT,  PSG_COUNT,  offsetof(tProcUsage, kernelUs),       0.001, 3},
+	{L"peakWorkingSetBytes", PSG_COUNT,  PSG_COUNT,  offsetof(tProcUsage, peakWorkingSet), 1.0,   0},
+	{L"readBytes",           PSG_COUNT,  PSG_COUNT,  offsetof(tProcUsage, readBytes),      1.0,   0},
+	{L"writeBytes",          PSG_COUNT,  PSG_COUNT,  offsetof(tProcUsage, writeBytes),     1.0,   0},
+	{L"readOps",             PSG_COUNT,  PSG_COUNT,  offsetof(tProcUsage, readOps),        1.0,   0},
+	{L"writeOps",            PSG_COUNT,  PSG_COUNT,  offsetof(tProcUsage, writeOps),       1.0,   0}
+};
+
+
+/**
+ * Index of the total duration metric in `reportMetrics`.
+ */
+#define REPORT_TOTAL_METRIC 7
+
+
+/**
+ * Live histograms with their report names.
+ */
+static const struct {
+	const wchar_t * name;
+	size_t offset; /**< `tHistogram` field offset within `tIpcWndCtx` */
+} reportLiveHists[] = {
+	{L"duration",    offsetof(tIpcWndCtx, histDuration)},
+	{L"queueWait",   offsetof(tIpcWndCtx, histQueueWait)},
+	{L"firstOutput", offsetof(tIpcWndCtx, histFirstOutput)}
+};
+
+
+/**
+ * Returns the current high resolution timestamp.
+ *
+ * @return timestamp in performance counter ticks
+ */
+int64_t reportTicks(void) {
+	LARGE_INTEGER now;
+	if ( ! QueryPerformanceCounter(&now) ) {
+		return 0;
+	}
+	return (int64_t)(now.QuadPart);
+}
+
+
+/**
+ * Converts the given number of performance counter ticks to milliseconds.
+ *
+ * @param[in] ticks - performance counter ticks
+ * @return milliseconds
+ */
+double reportTicksToMs(const int64_t ticks) {
+	static double freq = 0.0;
+	if (freq <= 0.0) {
+		LARGE_INTEGER f;
+		if ( ! QueryPerformanceFrequency(&f) || f.QuadPart <= 0 ) {
+			return 0.0;
+		}
+		freq = (double)(f.QuadPart);
+	}
+	return ((double)ticks * 1000.0) / freq;
+}
+
+
+/**
+ * Records the current timestamp for the given processing stage of an item.
+ *
+ * @param[in,out] item - process item
+ * @param[in] stage - reached processing stage
+ */
+void reportStamp(tProcCtx * item, const tProcStage stage) {
+	if (item == NULL || stage >= PSG_COUNT) {
+		return;
+	}
+	item->stamp[stage] = reportTicks();
+}
+
+
+/**
+ * Returns the current time in seconds for the moving rate.
+ *
+ * @return seconds
+ */
+static int64_t reportSeconds(void) {
+	return (int64_t)(reportTicksToMs(reportTicks()) / 1000.0);
+}
+
+
+/**
+ * Returns the duration between two processing stages in microseconds.
+ *
+ * @param[in] item - process item
+ * @param[in] from - start stage
+ * @param[in] to - end stage
+ * @param[out] us - duration in microseconds
+ * @return `true` if both stages were reached, else `false`
+ */
+static bool reportStageUs(const tProcCtx * item, const tProcStage from, const tProcStage to, uint64_t * us) {
+	if (item->stamp[from] == 0 || item->stamp[to] == 0 || item->stamp[to] < item->stamp[from]) {
+		return false;
+	}
+	*us = (uint64_t)llround(reportTicksToMs(item->stamp[to] - item->stamp[from]) * 1000.0);
+	return true;
+}
+
+
+/**
+ * Adds the given finished item to the live statistics. This takes constant
+ * time and memory.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in] item - finished process item
+ */
+void reportLiveAdd(tIpcWndCtx * ctx, const tProcCtx * item) {
+	if (ctx == NULL || item == NULL) {
+		return;
+	}
+	uint64_t us;
+	if ( reportStageUs(item, PSG_START, PSG_DONE, &us) ) {
+		hist_add(&(ctx->histDuration), us);
+	}
+	if ( reportStageUs(item, PSG_QUEUED, PSG_START, &us) ) {
+		hist_add(&(ctx->histQueueWait), us);
+	}
+	if ( reportStageUs(item, PSG_START, PSG_OUTPUT, &us) ) {
+		hist_add(&(ctx->histFirstOutput), us);
+	}
+	rate_add(&(ctx->rate), reportSeconds(), 1);
+}
+
+
+/**
+ * Formats the given duration in a compact human readable form.
+ *
+ * @param[out] buf - output buffer
+ * @param[in] size - size of `buf` in number of characters
+ * @param[in] us - duration in microseconds
+ */
+static void reportFmtDuration(wchar_t * buf, const size_t size, const uint64_t us) {
+	const double ms = (double)us / 1000.0;
+	if (ms < 10.0) {
+		snwprintf(buf, size, L"%.1fms", ms);
+	} else if (ms < 1000.0) {
+		snwprintf(buf, size, L"%.0fms", ms);
+	} else if (ms < 100000.0) {
+		snwprintf(buf, size, L"%.1fs", ms / 1000.0);
+	} else {
+		snwprintf(buf, size, L"%.0fs", ms / 1000.0);
+	}
+	buf[size - 1] = 0;
+}
+
+
+/**
+ * Formats the live statistics for the status bar. These are the moving rate
+ * of finished items and the median and 95th percentile of the processing
+ * duration, queue wait and time to first output (TTFO).
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[out] buf - output buffer
+ * @param[in] size - size of `buf` in number of characters
+ */
+void reportLiveFormat(const tIpcWndCtx * ctx, wchar_t * buf, const size_t size) {
+	if (ctx == NULL || buf == NULL || size < 1) {
+		return;
+	}
+	wchar_t value[ARRAY_SIZE(reportLiveHists)][2][16];
+	for (size_t i = 0; i < ARRAY_SIZE(reportLiveHists); ++i) {
+		const tHistogram * h = (const tHistogram *)((const uint8_t *)ctx + reportLiveHists[i].offset);
+		if (h->count > 0) {
+			reportFmtDuration(value[i][0], ARRAY_SIZE(value[i][0]), hist_quantile(h, 0.50));
+			reportFmtDuration(value[i][1], ARRAY_SIZE(value[i][1]), hist_quantile(h, 0.95));
+		} else {
+			wcscpy(value[i][0], L"-");
+			wcscpy(value[i][1], L"-");
+		}
+	}
+	snwprintf(buf, size, L"%.1f files/min, p50/p95: run %s/%s, wait %s/%s, TTFO %s/%s",
+		rate_perMinute(&(ctx->rate), reportSeconds()),
+		value[0][0], value[0][1], value[1][0], value[1][1], value[2][0], value[2][1]
+	);
+	buf[size - 1] = 0;
+}
+
+
+/**
+ * Calculates the given metric for the passed item.
+ *
+ * @param[in] item - process item
+ * @param[in] m - metric
+ * @param[out] value - metric value
+ * @return `true` if the metric is available, else `false`
+ */
+static bool reportGetMetric(const tProcCtx * item, const tReportMetric * m, double * value) {
+	if (m->from == PSG_COUNT) {
+		if ( ! item->hasUsage ) {
+			return false;
+		}
+		*value = (double)(*(const uint64_t *)((const uint8_t *)&(item->usage) + m->offset)) * m->scale;
+		return true;
+	}
+	const int64_t from = item->stamp[m->from];
+	const int64_t to = item->stamp[m->to];
+	if (from == 0 || to == 0 || to < from) {
+		return false;
+	}
+	*value = reportTicksToMs(to - from);
+	return true;
+}
+
+
+/**
+ * Adds the given string as quoted JSON string.
+ *
+ * @param[in,out] sb - string buffer
+ * @param[in] str - string to add
+ */
+void reportAddJsonStr(tUStrBuf * sb, const wchar_t * str) {
+	usb_addC(sb, L'"');
+	for (; str != NULL && *str != 0; ++str) {
+		switch (*str) {
+		case L'"':  usb_add(sb, L"\\\""); break;
+		case L'\\': usb_add(sb, L"\\\\"); break;
+		case L'\n': usb_add(sb, L"\\n"); break;
+		case L'\r': usb_add(sb, L"\\r"); break;
+		case L'\t': usb_add(sb, L"\\t"); break;
+		default:
+			if (*str < 0x20) {
+				usb_addFmt(sb, L"\\u%04X", (unsigned)(*str));
+			} else {
+				usb_addC(sb, *str);
+			}
+			break;
+		}
+	}
+	usb_addC(sb, L'"');
+}
+
+
+/**
+ * Adds the given string as CSV field. The field is quoted only if needed.
+ *
+ * @param[in,out] sb - string buffer
+ * @param[in] str - string to add
+ */
+static void reportAddCsvStr(tUStrBuf * sb, const wchar_t * str) {
+	if (str == NULL) {
+		return;
+	}
+	if (wcspbrk(str, L",\"\r\n") == NULL) {
+		usb_add(sb, str);
+		return;
+	}
+	usb_addC(sb, L'"');
+	for (; *str != 0; ++str) {
+		if (*str == L'"') {
+			usb_addC(sb, L'"');
+		}
+		usb_addC(sb, *str);
+	}
+	usb_addC(sb, L'"');
+}
+
+
+/**
+ * Adds the output lines of the given item with their start time as JSON array
+ * field. Nothing is added if no line times were recorded.
+ *
+ * @param[in,out] sb - output string buffer
+ * @param[in] item - item
+ */
+static void reportAddJsonLines(tUStrBuf * sb, const tProcCtx * item) {
+	if (item->lineTimes == NULL || vec_size(item->lineTimes) == 0) {
+		return;
+	}
+	wchar_t * str = outputGet(item);
+	if (str == NULL) {
+		return;
+	}
+	const size_t count = vec_size(item->lineTimes);
+	usb_add(sb, L", \"lines\": [");
+	wchar_t * ptr = str;
+	for (size_t line = 0; line < count && *ptr != 0; ++line) {
+		wchar_t * end = wcschr(ptr, L'\n');
+		wchar_t * next = (end != NULL) ? end + 1 : ptr + wcslen(ptr);
+		if (end != NULL) {
+			if (end > ptr && end[-1] == L'\r') {
+				--end;
+			}
+			*end = 0;
+		}
+		usb_addFmt(sb, L"%s{\"atMs\": %.3f, \"text\": ", (line > 0) ? L", " : L"", (double)(*((const uint32_t *)vec_at(item->lineTimes, line))) / 1000.0);
+		reportAddJsonStr(sb, ptr);
+		usb_addC(sb, L'}');
+		ptr = next;
+	}
+	usb_addC(sb, L']');
+	free(str);
+}
+
+
+/**
+ * Aggregates all report metrics over all items.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[out] agg - aggregated values per metric (`ARRAY_SIZE(reportMetrics)` entries)
+ * @param[out] first - earliest queue timestamp
+ * @param[out] last - latest done timestamp
+ */
+static void reportAggregate(const tIpcWndCtx * ctx, tReportAgg * agg, int64_t * first, int64_t * last) {
+	ZeroMemory(agg, ARRAY_SIZE(reportMetrics) * sizeof(*agg));
+	*first = 0;
+	*last = 0;
+	const size_t count = vec_size(ctx->v);
+	for (size_t i = 0; i < count; ++i) {
+		const tProcCtx * item = vec_at(ctx->v, i);
+		if (item == NULL) {
+			continue;
+		}
+		if (item->stamp[PSG_QUEUED] != 0 && (*first == 0 || item->stamp[PSG_QUEUED] < *first)) {
+			*first = item->stamp[PSG_QUEUED];
+		}
+		if (item->stamp[PSG_DONE] > *last) {
+			*last = item->stamp[PSG_DONE];
+		}
+		for (size_t m = 0; m < ARRAY_SIZE(reportMetrics); ++m) {
+			double value;
+			if ( ! reportGetMetric(item, reportMetrics + m, &value) ) {
+				continue;
+			}
+			tReportAgg * a = agg + m;
+			if (a->count == 0 || value < a->min) {
+				a->min = value;
+			}
+			if (a->count == 0 || value > a->max) {
+				a->max = value;
+			}
+			a->sum += value;
+			++(a->count);
+		}
+	}
+}
+
+
+/**
+ * Creates the JSON report.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[in,out] sb - output string buffer
+ */
+static void reportCreateJson(const tIpcWndCtx * ctx, tUStrBuf * sb) {
+	tReportAgg agg[ARRAY_SIZE(reportMetrics)];
+	int64_t first, last;
+	reportAggregate(ctx, agg, &first, &last);
+	SYSTEMTIME st;
+	GetLocalTime(&st);
+	usb_add(sb, L"{\n\t\"application\": ");
+	reportAddJsonStr(sb, L"siguwi " SIGUWI_VERSION);
+	usb_addFmt(sb, L",\n\t\"created\": \"%04u-%02u-%02uT%02u:%02u:%02u\",\n\t\"files\": [",
+		(unsigned)st.wYear, (unsigned)st.wMonth, (unsigned)st.wDay, (unsigned)st.wHour, (unsigned)st.wMinute, (unsigned)st.wSecond
+	);
+	const size_t count = vec_size(ctx->v);
+	for (size_t i = 0; i < count; ++i) {
+		const tProcCtx * item = vec_at(ctx->v, i);
+		if (item == NULL) {
+			continue;
+		}
+		usb_add(sb, (i > 0) ? L",\n\t\t{\"path\": " : L"\n\t\t{\"path\": ");
+		reportAddJsonStr(sb, item->path);
+		usb_add(sb, L", \"result\": ");
+		reportAddJsonStr(sb, procStateStr[item->state]);
+		if ( item->hasExitCode ) {
+			usb_addFmt(sb, L", \"exitCode\": %" PRIu32, (uint32_t)(item->exitCode));
+		} else {
+			usb_add(sb, L", \"exitCode\": null");
+		}
+		usb_add(sb, L", \"matched\": [");
+		for (size_t r = 0; item->matched != 0 && r < item->config->rules->count; ++r) {
+			if ((item->matched & (UINT64_C(1) << r)) != 0) {
+				usb_add(sb, (item->matched & ((UINT64_C(1) << r) - 1)) != 0 ? L", " : L"");
+				reportAddJsonStr(sb, item->config->rules->pattern[r]);
+			}
+		}
+		usb_addC(sb, L']');
+		reportAddJsonLines(sb, item);
+		if (first != 0 && item->stamp[PSG_QUEUED] != 0) {
+			usb_addFmt(sb, L", \"queuedAtMs\": %.3f", reportTicksToMs(item->stamp[PSG_QUEUED] - first));
+		}
+		for (size_t m = 0; m < ARRAY_SIZE(reportMetrics); ++m) {
+			double value;
+			if ( reportGetMetric(item, reportMetrics + m, &value) ) {
+				usb_addFmt(sb, L", \"%s\": %.*f", reportMetrics[m].name, reportMetrics[m].precision, value);
+			} else {
+				usb_addFmt(sb, L", \"%s\": null", reportMetrics[m].name);
+			}
+		}
+		usb_addC(sb, L'}');
+	}
+	const double wallMs = (first != 0 && last > first) ? reportTicksToMs(last - first) : 0.0;
+	const size_t finished = agg[REPORT_TOTAL_METRIC].count;
+	usb_addFmt(sb, L"%s],\n\t\"summary\": {\n\t\t\"files\": %zu,\n\t\t\"states\": {", (count > 0) ? L"\n\t" : L"", count);
+	for (size_t s = 0; s < PST_COUNT; ++s) {
+		usb_add(sb, (s > 0) ? L", " : L"");
+		reportAddJsonStr(sb, procStateStr[s]);
+		usb_addFmt(sb, L": %zu", ctx->stateCount[s]);
+	}
+	usb_addFmt(sb, L"},\n\t\t\"wallMs\": %.3f,\n\t\t\"filesPerMinute\": %.3f,\n\t\t\"metrics\": {",
+		wallMs, (wallMs > 0.0) ? ((double)finished * 60000.0) / wallMs : 0.0
+	);
+	for (size_t m = 0; m < ARRAY_SIZE(reportMetrics); ++m) {
+		const tReportAgg * a = agg + m;
+		const int p = reportMetrics[m].precision;
+		usb_addFmt(sb, L"%s\n\t\t\t\"%s\": ", (m > 0) ? L"," : L"", reportMetrics[m].name);
+		if (a->count > 0) {
+			usb_addFmt(sb, L"{\"count\": %zu, \"min\": %.*f, \"avg\": %.3f, \"max\": %.*f, \"sum\": %.*f}",
+				a->count, p, a->min, a->sum / (double)(a->count), p, a->max, p, a->sum
+			);
+		} else {
+			usb_add(sb, L"{\"count\": 0, \"min\": null, \"avg\": null, \"max\": null, \"sum\": 0}");
+		}
+	}
+	usb_addFmt(sb, L"\n\t\t},\n\t\t\"movingFilesPerMinute\": %.3f,\n\t\t\"livePercentilesMs\": {", rate_perMinute(&(ctx->rate), reportSeconds()));
+	for (size_t i = 0; i < ARRAY_SIZE(reportLiveHists); ++i) {
+		const tHistogram * h = (const tHistogram *)((const uint8_t *)ctx + reportLiveHists[i].offset);
+		usb_addFmt(sb, L"%s\n\t\t\t\"%s\": {\"count\": %" PRIu64, (i > 0) ? L"," : L"", reportLiveHists[i].name, h->count);
+		static const struct {
+			const wchar_t * name;
+			double q;
+		} quantiles[] = {{L"p50", 0.50}, {L"p90", 0.90}, {L"p95", 0.95}, {L"p99", 0.99}, {L"max", 1.0}};
+		for (size_t q = 0; q < ARRAY_SIZE(quantiles); ++q) {
+			if (h->count > 0) {
+				usb_addFmt(sb, L", \"%s\": %.3f", quantiles[q].name, (double)hist_quantile(h, quantiles[q].q) / 1000.0);
+			} else {
+				usb_addFmt(sb, L", \"%s\": null", quantiles[q].name);
+			}
+		}
+		usb_addC(sb, L'}');
+	}
+	usb_add(sb, L"\n\t\t}\n\t}\n}\n");
+}
+
+
+/**
+ * Creates the CSV report. The aggregates are appended as rows with an empty
+ * path and the aggregate name as result.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[in,out] sb - output string buffer
+ */
+static void reportCreateCsv(const tIpcWndCtx * ctx, tUStrBuf * sb) {
+	tReportAgg agg[ARRAY_SIZE(reportMetrics)];
+	int64_t first, last;
+	reportAggregate(ctx, agg, &first, &last);
+	usb_add(sb, L"path,result,exitCode,queuedAtMs");
+	for (size_t m = 0; m < ARRAY_SIZE(reportMetrics); ++m) {
+		usb_addFmt(sb, L",%s", reportMetrics[m].name);
+	}
+	usb_add(sb, L"\r\n");
+	const size_t count = vec_size(ctx->v);
+	for (size_t i = 0; i < count; ++i) {
+		const tProcCtx * item = vec_at(ctx->v, i);
+		if (item == NULL) {
+			continue;
+		}
+		reportAddCsvStr(sb, item->path);
+		usb_addC(sb, L',');
+		reportAddCsvStr(sb, procStateStr[item->state]);
+		usb_addC(sb, L',');
+		if ( item->hasExitCode ) {
+			usb_addFmt(sb, L"%" PRIu32, (uint32_t)(item->exitCode));
+		}
+		usb_addC(sb, L',');
+		if (first != 0 && item->stamp[PSG_QUEUED] != 0) {
+			usb_addFmt(sb, L"%.3f", reportTicksToMs(item->stamp[PSG_QUEUED] - first));
+		}
+		for (size_t m = 0; m < ARRAY_SIZE(reportMetrics); ++m) {
+			double value;
+			usb_addC(sb, L',');
+			if ( reportGetMetric(item, reportMetrics + m, &value) ) {
+				usb_addFmt(sb, L"%.*f", reportMetrics[m].precision, value);
+			}
+		}
+		usb_add(sb, L"\r\n");
+	}
+	static const wchar_t * const aggName[] = {L"count", L"min", L"avg", L"max", L"sum"};
+	for (size_t n = 0; n < ARRAY_SIZE(aggName); ++n) {
+		usb_addFmt(sb, L",%s,,", aggName[n]);
+		for (size_t m = 0; m < ARRAY_SIZE(reportMetrics); ++m) {
+			const tReportAgg * a = agg + m;
+			usb_addC(sb, L',');
+			if (n == 0) {
+				usb_addFmt(sb, L"%zu", a->count);
+			} else if (a->count > 0) {
+				const double value[] = {0.0, a->min, a->sum / (double)(a->count), a->max, a->sum};
+				usb_addFmt(sb, L"%.*f", (n == 2) ? 3 : reportMetrics[m].precision, value[n]);
+			}
+		}
+		usb_add(sb, L"\r\n");
+	}
+}
+
+
+/**
+ * Writes the run report with per file rows and aggregates to the given path.
+ * The format is CSV if the file extension is `.csv`, else JSON.
+ *
+ * @param[in] ctx - Window/IPC context
+ * @param[in] path - output file path
+ * @return `true` on success, else `false`
+ */
+bool reportWrite(const tIpcWndCtx * ctx, const wchar_t * path) {
+	if (ctx == NULL || ctx->v == NULL || path == NULL) {
+		return false;
+	}
+	bool res = false;
+	wchar_t * str = NULL;
+	char * utf8 = NULL;
+	FILE * fp = NULL;
+	tUStrBuf * sb = usb_create(16384);
+	if (sb == NULL) {
+		goto onError;
+	}
+	if (_wcsicmp(PathFindExtensionW(path), L".csv") == 0) {
+		reportCreateCsv(ctx, sb);
+	} else {
+		reportCreateJson(ctx, sb);
+	}
+	str = usb_get(sb);
+	if (str == NULL) {
+		goto onError;
+	}
+	utf8 = wToUtf8(str);
+	if (utf8 == NULL) {
+		goto onError;
+	}
+	fp = _wfopen(path, L"wb");
+	if (fp == NULL) {
+		goto onError;
+	}
+	const size_t len = strlen(utf8);
+	res = (fwrite(utf8, 1, len, fp) == len);
+	res = (fclose(fp) == 0) && res;
+onError:
+	if (utf8 != NULL) {
+		free(utf8);
+	}
+	if (str != NULL) {
+		free(str);
+	}
+	if (sb != NULL) {
+		usb_delete(sb);
+	}
+	return res;
+}
@@ -0,0 +1,841 @@
+/**
+ * @file siguwi-scan.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+#ifndef FSCTL_READ_UNPRIVILEGED_USN_JOURNAL
+#define FSCTL_READ_UNPRIVILEGED_USN_JOURNAL CTL_CODE(FILE_DEVICE_FILE_SYSTEM, 234, METHOD_NEITHER, FILE_ANY_ACCESS)
+#endif
+
+
+/**
+ * FNV-1a 64-bit hash offset basis.
+ */
+#define SCAN_HASH_SEED UINT64_C(0xCBF29CE484222325)
+
+
+/**
+ * Updates the given FNV-1a 64-bit hash with the passed data.
+ *
+ * @param[in] hash - previous hash value or `SCAN_HASH_SEED`
+ * @param[in] data - data to add
+ * @param[in] len - size of `data` in bytes
+ * @return updated hash value
+ */
+static uint64_t scanHash(uint64_t hash, const void * data, const size_t len) {
+	const uint8_t * ptr = (const uint8_t *)data;
+	for (size_t i = 0; i < len; ++i) {
+		hash = (hash ^ ptr[i]) * UINT64_C(0x100000001B3);
+	}
+	return hash;
+}
+
+
+/**
+ * Combines the two given 32-bit halves to a 64-bit value.
+ *
+ * @param[in] high - upper half
+ * @param[in] low - lower half
+ * @return 64-bit value
+ */
+static uint64_t scanU64(const DWORD high, const DWORD low) {
+	return ((uint64_t)high << 32) | (uint64_t)low;
+}
+
+
+/**
+ * Returns the index identifier of the given file. File systems without stable
+ * file identifiers report 0. An identifier is derived from the full path of
+ * the file in this case.
+ *
+ * @param[in] id - file system file identifier or 0
+ * @param[in] dir - path of the parent directory or full path if `nameLen` is 0
+ * @param[in] name - file name or `NULL`
+ * @param[in] nameLen - length of `name` in number of characters
+ * @return index identifier
+ */
+static uint64_t scanFileId(const uint64_t id, const wchar_t * dir, const wchar_t * name, const size_t nameLen) {
+	if (id != 0) {
+		return id;
+	}
+	const size_t dirLen = wcslen(dir);
+	uint64_t hash = scanHash(SCAN_HASH_SEED, dir, dirLen * sizeof(wchar_t));
+	if (nameLen > 0) {
+		if (dirLen > 0 && dir[dirLen - 1] != L'\\') {
+			hash = scanHash(hash, L"\\", sizeof(wchar_t));
+		}
+		hash = scanHash(hash, name, nameLen * sizeof(wchar_t));
+	}
+	return hash | (UINT64_C(1) << 63);
+}
+
+
+/**
+ * Retrieves the file information of the given file or directory.
+ *
+ * @param[in] path - file or directory path
+ * @param[out] info - receives the file information
+ * @return `true` on success, else `false`
+ */
+static bool scanInfo(const wchar_t * path, BY_HANDLE_FILE_INFORMATION * info) {
+	const HANDLE hFile = CreateFileW(path, FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	const BOOL res = GetFileInformationByHandle(hFile, info);
+	const DWORD err = GetLastError();
+	CloseHandle(hFile);
+	SetLastError(err);
+	return res != FALSE;
+}
+
+
+/**
+ * Checks whether the given file name is signable.
+ *
+ * @param[in] name - file name
+ * @param[in] nameLen - length of `name` in number of characters
+ * @return `true` if signable, else `false`
+ */
+static bool scanIsSignable(const wchar_t * name, const size_t nameLen) {
+	wchar_t buf[MAX_PATH + 1];
+	if (nameLen >= ARRAY_SIZE(buf)) {
+		return false;
+	}
+	memcpy(buf, name, nameLen * sizeof(wchar_t));
+	buf[nameLen] = 0;
+	return regIsSignable(buf);
+}
+
+
+/**
+ * Resolves the full path of the given index entry.
+ *
+ * @param[in] t - scanned directory tree
+ * @param[in] e - index entry
+ * @param[out] buf - output buffer
+ * @param[in] len - output buffer size in number of characters
+ * @return `true` on success, else `false` if not resolvable or too long
+ */
+static bool scanFullPath(const tTreeScan * t, const tFileIdxEntry * e, wchar_t * buf, const size_t len) {
+	const size_t rootLen = wcslen(t->path);
+	if ((rootLen + 2) > len) {
+		return false;
+	}
+	memcpy(buf, t->path, rootLen * sizeof(wchar_t));
+	size_t pos = rootLen;
+	if (pos > 0 && buf[pos - 1] != L'\\') {
+		buf[pos++] = L'\\';
+	}
+	return fidx_path(t->idx, e, L'\\', buf + pos, len - pos) > 0;
+}
+
+
+/**
+ * Sets the path of the persistent file identity index of the given directory
+ * tree. It is stored within the local application data directory to keep the
+ * tree itself unchanged.
+ *
+ * @param[in,out] t - scanned directory tree
+ * @return `true` on success, else `false`
+ */
+static bool scanIndexPath(tTreeScan * t) {
+	wchar_t buf[MAX_PATH + 1];
+	wchar_t name[32];
+	/* paths are case insensitive */
+	const size_t len = wcslen(t->path);
+	if (len >= ARRAY_SIZE(buf)) {
+		return false;
+	}
+	memcpy(buf, t->path, (len + 1) * sizeof(wchar_t));
+	CharUpperBuffW(buf, (DWORD)len);
+	const uint64_t hash = scanHash(SCAN_HASH_SEED, buf, len * sizeof(wchar_t));
+	snwprintf(name, ARRAY_SIZE(name), L"%016" PRIX64 L".idx", hash);
+	name[ARRAY_SIZE(name) - 1] = 0;
+	if ( ! wLocalDataPath(name, buf, ARRAY_SIZE(buf)) ) {
+		return false;
+	}
+	t->idxPath = wcsdup(buf);
+	return t->idxPath != NULL;
+}
+
+
+/**
+ * Loads the persistent file identity index of the given directory tree. The
+ * index is left empty if it does not exist or is invalid.
+ *
+ * @param[in,out] t - scanned directory tree
+ */
+static void scanLoad(tTreeScan * t) {
+	const HANDLE hFile = CreateFileW(t->idxPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(hFile, &size) && size.QuadPart > 0 && size.QuadPart < MAXDWORD) {
+		uint8_t * buf = malloc((size_t)(size.QuadPart));
+		DWORD n = 0;
+		if (buf != NULL && ReadFile(hFile, buf, (DWORD)(size.QuadPart), &n, NULL) && n == (DWORD)(size.QuadPart)) {
+			fidx_load(t->idx, buf, (size_t)n);
+		}
+		free(buf);
+	}
+	CloseHandle(hFile);
+}
+
+
+/**
+ * Saves the persistent file identity index of the given directory tree. The
+ * previous index is replaced atomically.
+ *
+ * @param[in] t - scanned directory tree
+ * @return `true` on success, else `false`
+ */
+static bool scanSave(const tTreeScan * t) {
+	wchar_t tmp[MAX_PATH + 1];
+	size_t len = 0;
+	uint8_t * buf = fidx_save(t->idx, &len);
+	if (buf == NULL || len > MAXDWORD) {
+		free(buf);
+		SetLastError(ERROR_OUTOFMEMORY);
+		return false;
+	}
+	snwprintf(tmp, ARRAY_SIZE(tmp), L"%s.tmp", t->idxPath);
+	tmp[MAX_PATH] = 0;
+	const HANDLE hFile = CreateFileW(tmp, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	bool res = false;
+	if (hFile != INVALID_HANDLE_VALUE) {
+		DWORD n = 0;
+		res = WriteFile(hFile, buf, (DWORD)len, &n, NULL) && n == (DWORD)len;
+		CloseHandle(hFile);
+		res = res && MoveFileExW(tmp, t->idxPath, MOVEFILE_REPLACE_EXISTING);
+		if ( ! res ) {
+			const DWORD err = GetLastError();
+			DeleteFileW(tmp);
+			SetLastError(err);
+		}
+	}
+	free(buf);
+	return res;
+}
+
+
+/**
+ * Opens the change journal of the volume with the given path. The privileged
+ * journal access needs admin rights. The unprivileged one is limited to
+ * Windows 10 and newer.
+ *
+ * @param[in] path - path on the volume
+ * @param[out] jd - receives the journal state
+ * @param[out] readCode - receives the control code to read the journal
+ * @return volume handle or `INVALID_HANDLE_VALUE` if not available
+ */
+static HANDLE scanOpenJournal(const wchar_t * path, USN_JOURNAL_DATA * jd, DWORD * readCode) {
+	static const struct {
+		DWORD access;
+		DWORD code;
+	} modes[] = {
+		{GENERIC_READ, FSCTL_READ_USN_JOURNAL},
+		{FILE_READ_ATTRIBUTES, FSCTL_READ_UNPRIVILEGED_USN_JOURNAL}
+	};
+	wchar_t mount[MAX_PATH + 1];
+	wchar_t volume[MAX_PATH + 1];
+	if (( ! GetVolumePathNameW(path, mount, ARRAY_SIZE(mount)) ) || ( ! GetVolumeNameForVolumeMountPointW(mount, volume, ARRAY_SIZE(volume)) )) {
+		return INVALID_HANDLE_VALUE;
+	}
+	/* open the volume instead of its root directory */
+	const size_t len = wcslen(volume);
+	if (len > 0 && volume[len - 1] == L'\\') {
+		volume[len - 1] = 0;
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(modes); ++i) {
+		const HANDLE hVol = CreateFileW(volume, modes[i].access, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+		if (hVol == INVALID_HANDLE_VALUE) {
+			continue;
+		}
+		DWORD n = 0;
+		if ( DeviceIoControl(hVol, FSCTL_QUERY_USN_JOURNAL, NULL, 0, jd, sizeof(*jd), &n, NULL) ) {
+			*readCode = modes[i].code;
+			return hVol;
+		}
+		CloseHandle(hVol);
+	}
+	return INVALID_HANDLE_VALUE;
+}
+
+
+/**
+ * Applies the given change journal record to the file identity index.
+ * Signable files within the tree are marked as candidates. Directories moved
+ * into the tree are added to `dirs` to walk them.
+ *
+ * @param[in,out] t - scanned directory tree
+ * @param[in] r - change journal record
+ * @param[in,out] dirs - directories to walk (`uint64_t`)
+ * @return `true` on success, else `false` on allocation error
+ */
+static bool scanRecord(tTreeScan * t, const USN_RECORD * r, tVector * dirs) {
+	tFileIdx * idx = t->idx;
+	const uint64_t id = (uint64_t)(r->FileReferenceNumber);
+	const uint64_t parent = (uint64_t)(r->ParentFileReferenceNumber);
+	if ((r->Reason & USN_REASON_FILE_DELETE) != 0) {
+		fidx_remove(idx, id);
+		return true;
+	}
+	if ((r->Reason & USN_REASON_RENAME_OLD_NAME) != 0) {
+		/* followed by a record with the new name */
+		return true;
+	}
+	const tFileIdxEntry * p = fidx_get(idx, parent);
+	const bool inTree = parent == idx->root || (p != NULL && (p->flags & FIDX_DIR) != 0);
+	if (( ! inTree ) || (r->FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0) {
+		/* outside the tree or moved out of it */
+		fidx_remove(idx, id);
+		return true;
+	}
+	const wchar_t * name = (const wchar_t *)((const uint8_t *)r + r->FileNameOffset);
+	const size_t nameLen = (size_t)(r->FileNameLength) / sizeof(wchar_t);
+	if ((r->FileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+		const bool known = fidx_get(idx, id) != NULL;
+		if (fidx_put(idx, id, parent, name, nameLen, FIDX_DIR) == NULL) {
+			return false;
+		}
+		if (( ! known ) && (r->Reason & USN_REASON_RENAME_NEW_NAME) != 0) {
+			/* moved into the tree with its content */
+			uint64_t * dir = vec_pushBack(dirs);
+			if (dir == NULL) {
+				return false;
+			}
+			*dir = id;
+		}
+	} else if ( scanIsSignable(name, nameLen) ) {
+		if (fidx_put(idx, id, parent, name, nameLen, FIDX_CANDIDATE) == NULL) {
+			return false;
+		}
+	} else {
+		fidx_remove(idx, id);
+	}
+	return true;
+}
+
+
+/**
+ * Reads the change journal from the last recorded position up to the given
+ * journal state and applies it to the file identity index.
+ *
+ * @param[in,out] t - scanned directory tree
+ * @param[in] hVol - volume handle
+ * @param[in] readCode - control code to read the journal
+ * @param[in] jd - journal state
+ * @param[in,out] dirs - directories to walk (`uint64_t`)
+ * @return `true` on success, else `false` if a full walk is needed
+ */
+static bool scanJournal(tTreeScan * t, HANDLE hVol, const DWORD readCode, const USN_JOURNAL_DATA * jd, tVector * dirs) {
+	READ_USN_JOURNAL_DATA rd;
+	ZeroMemory(&rd, sizeof(rd));
+	rd.StartUsn = (USN)(t->idx->usn);
+	rd.ReasonMask = UINT32_MAX;
+	rd.UsnJournalID = jd->UsnJournalID;
+	uint8_t * buf = malloc(SCAN_JOURNAL_BUFFER_SIZE);
+	if (buf == NULL) {
+		return false;
+	}
+	bool res = true;
+	while (res && rd.StartUsn < jd->NextUsn) {
+		DWORD n = 0;
+		USN next;
+		if (( ! DeviceIoControl(hVol, readCode, &rd, sizeof(rd), buf, SCAN_JOURNAL_BUFFER_SIZE, &n, NULL) ) || n < sizeof(next)) {
+			res = false;
+			break;
+		}
+		memcpy(&next, buf, sizeof(next));
+		for (DWORD pos = sizeof(next); res && (pos + sizeof(USN_RECORD)) <= n; ) {
+			const USN_RECORD * r = (const USN_RECORD *)(buf + pos);
+			/* version 3 records with 128-bit file identifiers are not supported */
+			res = r->MajorVersion == 2 && r->RecordLength >= sizeof(USN_RECORD) && (pos + r->RecordLength) <= n && (r->FileNameOffset + (DWORD)(r->FileNameLength)) <= r->RecordLength;
+			res = res && scanRecord(t, r, dirs);
+			pos += r->RecordLength;
+		}
+		if (next <= rd.StartUsn) {
+			break;
+		}
+		rd.StartUsn = next;
+	}
+	free(buf);
+	return res;
+}
+
+
+/**
+ * Walks the given directory of the tree recursively and updates the file
+ * identity index. Signable files which changed since they were signed are
+ * added to `files`. Inaccessible sub-directories are skipped.
+ *
+ * @param[in,out] t - scanned directory tree
+ * @param[in] dirId - index identifier of the directory to walk
+ * @param[in,out] files - changed files (`uint64_t`)
+ * @return `true` on success, else `false`
+ */
+static bool scanWalk(tTreeScan * t, const uint64_t dirId, tVector * files) {
+	wchar_t path[MAX_PATH + 1];
+	tVector * stack = vec_create(sizeof(uint64_t));
+	uint8_t * buf = malloc(SCAN_DIR_BUFFER_SIZE);
+	uint64_t * top = (stack != NULL) ? vec_pushBack(stack) : NULL;
+	bool res = buf != NULL && top != NULL;
+	if ( res ) {
+		*top = dirId;
+	}
+	while (res && vec_size(stack) > 0) {
+		const uint64_t id = *(const uint64_t *)vec_at(stack, vec_size(stack) - 1);
+		vec_popBack(stack);
+		if (id == t->idx->root) {
+			snwprintf(path, ARRAY_SIZE(path), L"%s", t->path);
+			path[MAX_PATH] = 0;
+		} else if ( ! scanFullPath(t, fidx_get(t->idx, id), path, ARRAY_SIZE(path)) ) {
+			continue;
+		}
+		const HANDLE hDir = CreateFileW(path, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+		if (hDir == INVALID_HANDLE_VALUE) {
+			res = id != t->idx->root;
+			continue;
+		}
+		/* a single call returns the identifiers, sizes and times of many entries */
+		while (res && GetFileInformationByHandleEx(hDir, FileIdBothDirectoryInfo, buf, SCAN_DIR_BUFFER_SIZE)) {
+			for (const FILE_ID_BOTH_DIR_INFO * e = (const FILE_ID_BOTH_DIR_INFO *)buf; res; e = (const FILE_ID_BOTH_DIR_INFO *)((const uint8_t *)e + e->NextEntryOffset)) {
+				const size_t nameLen = (size_t)(e->FileNameLength) / sizeof(wchar_t);
+				const bool isDir = (e->FileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+				const bool isDot = isDir && (nameLen == 1 || nameLen == 2) && e->FileName[0] == L'.' && e->FileName[nameLen - 1] == L'.';
+				if (( ! isDot ) && (e->FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0) {
+					const uint64_t fileId = scanFileId((uint64_t)(e->FileId.QuadPart), path, e->FileName, nameLen);
+					if ( isDir ) {
+						uint64_t * sub = vec_pushBack(stack);
+						res = sub != NULL && fidx_put(t->idx, fileId, id, e->FileName, nameLen, FIDX_DIR) != NULL;
+						if (sub != NULL) {
+							*sub = fileId;
+						}
+					} else if ( scanIsSignable(e->FileName, nameLen) ) {
+						const tFileIdxEntry * f = fidx_put(t->idx, fileId, id, e->FileName, nameLen, 0);
+						res = f != NULL;
+						if (res && (f->flags & FIDX_QUEUED) == 0 && fidx_changed(f, (uint64_t)(e->EndOfFile.QuadPart), (uint64_t)(e->LastWriteTime.QuadPart))) {
+							uint64_t * file = vec_pushBack(files);
+							res = file != NULL;
+							if ( res ) {
+								*file = fileId;
+							}
+						}
+					}
+				}
+				if (e->NextEntryOffset == 0) {
+					break;
+				}
+			}
+		}
+		if (res && GetLastError() != ERROR_NO_MORE_FILES) {
+			res = id != t->idx->root;
+		}
+		CloseHandle(hDir);
+	}
+	free(buf);
+	vec_delete(stack);
+	return res;
+}
+
+
+/**
+ * Collects the signable files which were reported as changed by the change
+ * journal or were not signed successfully before. Entries which can no longer
+ * be resolved are removed.
+ *
+ * @param[in,out] t - scanned directory tree
+ * @param[in,out] files - changed files (`uint64_t`)
+ * @return `true` on success, else `false` on allocation error
+ */
+static bool scanCandidates(tTreeScan * t, tVector * files) {
+	wchar_t path[MAX_PATH + 1];
+	tFileIdx * idx = t->idx;
+	tVector * orphans = vec_create(sizeof(uint64_t));
+	bool res = orphans != NULL;
+	for (size_t i = 0; res && i < idx->capacity; ++i) {
+		tFileIdxEntry * e = idx->slots + i;
+		if (e->id == 0) {
+			continue;
+		}
+		const bool check = (e->flags & FIDX_DIR) == 0 && (e->flags & FIDX_QUEUED) == 0 && (e->flags & (FIDX_CANDIDATE | FIDX_SIGNED)) != FIDX_SIGNED;
+		e->flags &= ~(uint32_t)FIDX_CANDIDATE;
+		WIN32_FILE_ATTRIBUTE_DATA fa;
+		if ( ! scanFullPath(t, e, path, ARRAY_SIZE(path)) ) {
+			uint64_t * orphan = vec_pushBack(orphans);
+			res = orphan != NULL;
+			if ( res ) {
+				*orphan = e->id;
+			}
+		} else if ( check ) {
+			if (( ! GetFileAttributesExW(path, GetFileExInfoStandard, &fa) ) || (fa.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+				continue;
+			}
+			if ( fidx_changed(e, scanU64(fa.nFileSizeHigh, fa.nFileSizeLow), scanU64(fa.ftLastWriteTime.dwHighDateTime, fa.ftLastWriteTime.dwLowDateTime)) ) {
+				uint64_t * file = vec_pushBack(files);
+				res = file != NULL;
+				if ( res ) {
+					*file = e->id;
+				}
+			}
+		}
+	}
+	for (size_t i = 0; res && i < vec_size(orphans); ++i) {
+		fidx_remove(idx, *(const uint64_t *)vec_at(orphans, i));
+	}
+	vec_delete(orphans);
+	return res;
+}
+
+
+/**
+ * Finishes one pending item or scan of the given directory tree. The file
+ * identity index is saved after the last one.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] t - scanned directory tree
+ */
+static void scanDone(tIpcWndCtx * ctx, tTreeScan * t) {
+	if (t->pending == 0 || --(t->pending) > 0) {
+		return;
+	}
+	if ( ! scanSave(t) ) {
+		processNotify(ctx, NULL, L"scanDone", errStr[ERR_SAVE_INDEX], GetLastError(), t->path);
+	}
+	const size_t count = (ctx->trees != NULL) ? vec_size(ctx->trees) : 0;
+	for (size_t i = 0; i < count; ++i) {
+		if (*(tTreeScan **)vec_at(ctx->trees, i) == t) {
+			vec_erase(ctx->trees, i, i);
+			scanRelease(t);
+			break;
+		}
+	}
+}
+
+
+/**
+ * Returns the scanned directory tree with the given root path. A new one is
+ * created and its persistent file identity index loaded if none is pending.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in] path - full root directory path
+ * @return scanned directory tree or `NULL` on error
+ */
+static tTreeScan * scanGetTree(tIpcWndCtx * ctx, const wchar_t * path) {
+	if (ctx->trees == NULL) {
+		ctx->trees = vec_create(sizeof(tTreeScan *));
+		if (ctx->trees == NULL) {
+			return NULL;
+		}
+	}
+	const size_t count = vec_size(ctx->trees);
+	for (size_t i = 0; i < count; ++i) {
+		tTreeScan * t = *(tTreeScan **)vec_at(ctx->trees, i);
+		if (_wcsicmp(t->path, path) == 0) {
+			return t;
+		}
+	}
+	tTreeScan * t = calloc(1, sizeof(tTreeScan));
+	if (t == NULL) {
+		return NULL;
+	}
+	t->refCount = 1;
+	t->path = wcsdup(path);
+	t->idx = fidx_create();
+	tTreeScan ** ptr = NULL;
+	if (t->path == NULL || t->idx == NULL || ( ! scanIndexPath(t) ) || (ptr = vec_pushBack(ctx->trees)) == NULL) {
+		scanRelease(t);
+		return NULL;
+	}
+	*ptr = t;
+	scanLoad(t);
+	return t;
+}
+
+
+/**
+ * Scans the given directory tree and adds all signable files which changed
+ * since they were signed successfully to the internal process list. The
+ * change journal of the volume is used to find these if the persistent file
+ * identity index is up-to-date with it. The whole tree is walked otherwise.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in] c - INI configuration base
+ * @param[in] signApp - code signing application command-line
+ * @param[in] path - path to the directory (can be relative)
+ * @return `true` on success, else `false` after adding a non-modal notification
+ */
+bool scanAddTree(tIpcWndCtx * ctx, tRcIniConfigBase * c, tRcWStr * signApp, const wchar_t * path) {
+	if (ctx == NULL || c == NULL || signApp == NULL || path == NULL) {
+		return false;
+	}
+	TRACE_BEGIN("scan", "scanAddTree");
+	wchar_t buf[MAX_PATH + 1];
+	tVector * files = NULL;
+	tVector * dirs = NULL;
+	wchar_t * root = wcsdup(path);
+	if (root == NULL || ( ! wToFullPath(&root, true) )) {
+		wStrDelete(&root);
+		processNotify(ctx, NULL, L"scanAddTree", L"%s\n%s", errStr[ERR_OUT_OF_MEMORY], path);
+		TRACE_END("scan", "scanAddTree");
+		return false;
+	}
+	/* keep the trailing backslash of volume root directories only */
+	const size_t rootLen = wcslen(root);
+	if (rootLen > 3 && root[rootLen - 1] == L'\\') {
+		root[rootLen - 1] = 0;
+	}
+	tTreeScan * t = scanGetTree(ctx, root);
+	if (t == NULL) {
+		processNotify(ctx, NULL, L"scanAddTree", errStr[ERR_SCAN_TREE], GetLastError(), root);
+		wStrDelete(&root);
+		TRACE_END("scan", "scanAddTree");
+		return false;
+	}
+	wStrDelete(&root);
+	scanAquire(t);
+	++(t->pending);
+	tFileIdx * idx = t->idx;
+	bool res = false;
+	BY_HANDLE_FILE_INFORMATION info;
+	files = vec_create(sizeof(uint64_t));
+	dirs = vec_create(sizeof(uint64_t));
+	if (files == NULL || dirs == NULL || ( ! scanInfo(t->path, &info) )) {
+		goto onError;
+	}
+	const uint64_t volume = (uint64_t)(info.dwVolumeSerialNumber);
+	const uint64_t rootId = scanFileId(scanU64(info.nFileIndexHigh, info.nFileIndexLow), t->path, NULL, 0);
+	if (idx->volume != volume || idx->root != rootId) {
+		/* different or replaced tree */
+		fidx_clear(idx);
+		idx->volume = volume;
+		idx->root = rootId;
+	}
+	USN_JOURNAL_DATA jd;
+	DWORD readCode = 0;
+	const HANDLE hVol = scanOpenJournal(t->path, &jd, &readCode);
+	bool walk = true;
+	if (hVol != INVALID_HANDLE_VALUE) {
+		const uint64_t firstUsn = (uint64_t)(jd.FirstUsn);
+		const uint64_t nextUsn = (uint64_t)(jd.NextUsn);
+		if (idx->count > 0 && idx->journal == (uint64_t)(jd.UsnJournalID) && idx->usn >= firstUsn && idx->usn <= nextUsn) {
+			TRACE_BEGIN("scan", "scanJournal");
+			walk = ! scanJournal(t, hVol, readCode, &jd, dirs);
+			TRACE_END("scan", "scanJournal");
+		}
+		CloseHandle(hVol);
+	}
+	if ( walk ) {
+		TRACE_BEGIN("scan", "scanWalk");
+		++(idx->mark);
+		res = scanWalk(t, idx->root, files);
+		if ( res ) {
+			fidx_sweep(idx);
+		}
+		TRACE_END("scan", "scanWalk");
+	} else {
+		res = true;
+		for (size_t i = 0; res && i < vec_size(dirs); ++i) {
+			res = scanWalk(t, *(const uint64_t *)vec_at(dirs, i), files);
+		}
+		res = res && scanCandidates(t, files);
+	}
+	/* changes after this point are found by the next scan */
+	idx->journal = (res && hVol != INVALID_HANDLE_VALUE) ? (uint64_t)(jd.UsnJournalID) : 0;
+	idx->usn = (res && hVol != INVALID_HANDLE_VALUE) ? (uint64_t)(jd.NextUsn) : 0;
+	if ( ! res ) {
+		goto onError;
+	}
+	const size_t count = vec_size(files);
+	TRACE_INSTANT("scan", "changed", (int64_t)count);
+	if (count == 0) {
+		processNotify(ctx, NULL, L"scanAddTree", errStr[ERR_TREE_UNCHANGED], t->path);
+	}
+	for (size_t i = 0; i < count; ++i) {
+		tFileIdxEntry * e = fidx_get(idx, *(const uint64_t *)vec_at(files, i));
+		if (e == NULL || ( ! scanFullPath(t, e, buf, ARRAY_SIZE(buf)) )) {
+			continue;
+		}
+		e->flags |= FIDX_QUEUED;
+		++(t->pending);
+		tDigestKey key;
+		/* format-aware digests exclude the signature whose size may change if signed again */
+		if ((e->flags & FIDX_DIGEST) != 0 && hashIdentity(buf, &key) && (key.size == e->size || key.algo != HA_FILE_SHA256) && hashRequest(ctx, buf, &key, t, e->id, c, signApp)) {
+			/* possibly only the time changed; signed by `scanHashed()` if the content did too */
+			continue;
+		}
+		if ( ! processAddFile(ctx, c, signApp, buf, NULL, t) ) {
+			/* the item was not added */
+			e = fidx_get(idx, *(const uint64_t *)vec_at(files, i));
+			if (e != NULL) {
+				e->flags &= ~(uint32_t)FIDX_QUEUED;
+			}
+			scanDone(ctx, t);
+		}
+	}
+	vec_delete(files);
+	vec_delete(dirs);
+	scanDone(ctx, t);
+	scanRelease(t);
+	TRACE_END("scan", "scanAddTree");
+	return true;
+onError:
+	processNotify(ctx, NULL, L"scanAddTree", errStr[ERR_SCAN_TREE], GetLastError(), t->path);
+	vec_delete(files);
+	vec_delete(dirs);
+	scanDone(ctx, t);
+	scanRelease(t);
+	TRACE_END("scan", "scanAddTree");
+	return false;
+}
+
+
+/**
+ * Accounts the given finished item of a scanned directory tree. The file
+ * identity index records the size and time of successfully signed files to
+ * skip them as long as they remain unchanged. The index is saved after the
+ * last pending item finished.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] item - finished item
+ */
+void scanItemDone(tIpcWndCtx * ctx, tProcCtx * item) {
+	if (ctx == NULL || item == NULL || item->tree == NULL || item->path == NULL) {
+		return;
+	}
+	tTreeScan * t = item->tree;
+	tFileIdx * idx = t->idx;
+	wchar_t dir[MAX_PATH + 1];
+	BY_HANDLE_FILE_INFORMATION info, dirInfo;
+	const wchar_t * name = wFileName(item->path);
+	const size_t nameLen = wcslen(name);
+	snwprintf(dir, ARRAY_SIZE(dir), L"%s", item->path);
+	dir[MAX_PATH] = 0;
+	PathRemoveFileSpecW(dir);
+	if (scanInfo(item->path, &info) && scanInfo(dir, &dirInfo) && (uint64_t)(info.dwVolumeSerialNumber) == idx->volume) {
+		const uint64_t dirId = (_wcsicmp(dir, t->path) == 0) ? idx->root : scanFileId(scanU64(dirInfo.nFileIndexHigh, dirInfo.nFileIndexLow), dir, NULL, 0);
+		const uint64_t id = scanFileId(scanU64(info.nFileIndexHigh, info.nFileIndexLow), dir, name, nameLen);
+		/* the signing application may have replaced the file with a new one */
+		tFileIdxEntry * e = (item->state == PST_OK) ? fidx_put(idx, id, dirId, name, nameLen, 0) : fidx_get(idx, id);
+		if (e != NULL) {
+			e->flags &= ~(uint32_t)FIDX_QUEUED;
+			if (item->state == PST_OK) {
+				e->flags = (e->flags & ~(uint32_t)FIDX_DIGEST) | FIDX_SIGNED;
+				e->size = scanU64(info.nFileSizeHigh, info.nFileSizeLow);
+				e->time = scanU64(info.ftLastWriteTime.dwHighDateTime, info.ftLastWriteTime.dwLowDateTime);
+				/* record the content digest to tell time only changes apart later */
+				tDigestKey key;
+				if (hashIdentity(item->path, &key) && key.size == e->size && key.mtime == e->time) {
+					++(t->pending);
+					if ( ! hashRequest(ctx, item->path, &key, t, id, NULL, NULL) ) {
+						--(t->pending);
+					}
+				}
+			}
+		}
+	}
+	scanDone(ctx, t);
+}
+
+
+/**
+ * Handles the given finished hashing job of a scanned directory tree. A file
+ * whose content still matches the digest recorded after it was signed only
+ * had its time changed or was signed again and is skipped. It is added to the internal process
+ * list otherwise. The digest of newly signed files is recorded.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in,out] job - finished hashing job; its tree reference is released
+ */
+void scanHashed(tIpcWndCtx * ctx, tHashJob * job) {
+	if (ctx == NULL || job == NULL || job->tree == NULL) {
+		return;
+	}
+	tTreeScan * t = job->tree;
+	tFileIdxEntry * e = fidx_get(t->idx, job->entry);
+	job->tree = NULL;
+	if (job->config != NULL && e != NULL) {
+		/* a matching format-aware digest only counts if the file is still signed */
+		const bool unchanged = job->state == HJS_OK && (e->flags & FIDX_DIGEST) != 0 && memcmp(e->digest, job->digest, FIDX_DIGEST_SIZE) == 0 && (job->isSigned || job->key.algo == HA_FILE_SHA256);
+		if ( unchanged ) {
+			e->size = job->key.size;
+			e->time = job->key.mtime;
+		}
+		if (( ! unchanged ) && job->state != HJS_CANCELLED && processAddFile(ctx, job->config, job->signApp, job->path, NULL, t)) {
+			/* the pending count is passed on to the new item */
+			scanRelease(t);
+			return;
+		}
+		e = fidx_get(t->idx, job->entry);
+		if (e != NULL) {
+			e->flags &= ~(uint32_t)FIDX_QUEUED;
+		}
+	} else if (e != NULL && job->state == HJS_OK && (e->flags & FIDX_SIGNED) != 0 && e->size == job->key.size && e->time == job->key.mtime) {
+		memcpy(e->digest, job->digest, FIDX_DIGEST_SIZE);
+		e->flags |= FIDX_DIGEST;
+	}
+	scanDone(ctx, t);
+	scanRelease(t);
+}
+
+
+/**
+ * Increments the reference counter of the given scanned directory tree.
+ *
+ * @param[in,out] tree - scanned directory tree
+ * @return same scanned directory tree
+ */
+tTreeScan * scanAquire(tTreeScan * tree) {
+	if (tree == NULL) {
+		return NULL;
+	}
+	InterlockedIncrement(&(tree->refCount));
+	return tree;
+}
+
+
+/**
+ * Decrements the reference counter of the given scanned directory tree and
+ * frees it if no longer referenced.
+ *
+ * @param[in,out] tree - scanned directory tree
+ */
+void scanRelease(tTreeScan * tree) {
+	if (tree == NULL) {
+		return;
+	}
+	if (InterlockedDecrement(&(tree->refCount)) == 0) {
+		fidx_delete(tree->idx);
+		wStrDelete(&(tree->idxPath));
+		wStrDelete(&(tree->path));
+		free(tree);
+	}
+}
+
+
+/**
+ * Saves the file identity index of all scanned directory trees with pending
+ * items and releases them. Files which did not finish are checked again by
+ * the next scan.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void scanDelete(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->trees == NULL) {
+		return;
+	}
+	const size_t count = vec_size(ctx->trees);
+	for (size_t i = 0; i < count; ++i) {
+		tTreeScan * t = *(tTreeScan **)vec_at(ctx->trees, i);
+		scanSave(t);
+		scanRelease(t);
+	}
+	vec_delete(ctx->trees);
+	ctx->trees = NULL;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file siguwi-search.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Returns the ASCII lower case variant of the given character.
+ *
+ * @param[in] c - input character
+ * @return folded character
+ */
+static wchar_t searchFold(const wchar_t c) {
+	if (c >= L'A' && c <= L'Z') {
+		return (wchar_t)(c - L'A' + L'a');
+	}
+	return c;
+}
+
+
+/**
+ * Finds the first occurrence of the given query within the passed string.
+ * ASCII letters are compared case insensitive like in the output search index.
+ *
+ * @param[in] str - string to search in
+ * @param[in] query - non-empty query
+ * @return first occurrence or `NULL` if not found
+ */
+static const wchar_t * searchFind(const wchar_t * str, const wchar_t * query) {
+	const wchar_t first = searchFold(*query);
+	for (; *str != 0; ++str) {
+		if (searchFold(*str) != first) {
+			continue;
+		}
+		size_t i = 1;
+		while (query[i] != 0 && searchFold(str[i]) == searchFold(query[i])) {
+			++i;
+		}
+		if (query[i] == 0) {
+			return str;
+		}
+	}
+	return NULL;
+}
+
+
+/**
+ * Adds the next raw output chunk of the given item to the output search index.
+ * A failing index is dropped in favor of searching the output of all items.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in] i - item index
+ * @param[in,out] state - output search indexing state of the item
+ * @param[in] data - output chunk
+ * @param[in] len - length of `data` in bytes
+ */
+void searchOutput(tIpcWndCtx * ctx, const size_t i, uint32_t * state, const uint8_t * data, const size_t len) {
+	if (ctx == NULL || ctx->search == NULL || i >= UINT32_MAX) {
+		return;
+	}
+	if ( ! tgi_add(ctx->search, (uint32_t)i, state, data, len) ) {
+		tgi_delete(ctx->search);
+		ctx->search = NULL;
+		processNotify(ctx, NULL, L"searchOutput", errStr[ERR_OUT_OF_MEMORY]);
+	}
+}
+
+
+/**
+ * Adds the output text appended to the given item by siguwi itself to the
+ * output search index. This covers notes, output rule matches and signing step
+ * headers which are not part of the raw output.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ * @param[in] i - item index
+ * @param[in] from - output length in characters before the text was appended
+ */
+void searchAppended(tIpcWndCtx * ctx, const size_t i, const size_t from) {
+	if (ctx == NULL || ctx->search == NULL || ctx->v == NULL) {
+		return;
+	}
+	tProcCtx * item = vec_at(ctx->v, i);
+	if (item == NULL || item->output == NULL || usb_len(item->output) <= from) {
+		return;
+	}
+	wchar_t * str = usb_get(item->output);
+	char * utf8 = (str != NULL) ? wToUtf8(str + from) : NULL;
+	free(str);
+	if (utf8 == NULL) {
+		/* cannot index it: search the output of all items */
+		tgi_delete(ctx->search);
+		ctx->search = NULL;
+		processNotify(ctx, NULL, L"searchAppended", errStr[ERR_OUT_OF_MEMORY]);
+		return;
+	}
+	/* appended text starts a new line; no trigram spans the raw output */
+	uint32_t state = TGI_START;
+	searchOutput(ctx, i, &state, (const uint8_t *)utf8, strlen(utf8));
+	free(utf8);
+}
+
+
+/**
+ * Filters the process list by the current output search query. The query is
+ * looked up in the output search index first. Only the resulting candidate
+ * items are verified against their output. An empty query shows all items.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void searchApply(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->hSearch == NULL || ctx->v == NULL) {
+		return;
+	}
+	TRACE_BEGIN("search", "searchApply");
+	const int len = GetWindowTextLengthW(ctx->hSearch);
+	wchar_t * query = (len > 0) ? malloc((size_t)(len + 1) * sizeof(wchar_t)) : NULL;
+	if (query != NULL && GetWindowTextW(ctx->hSearch, query, len + 1) <= 0) {
+		wStrDelete(&query);
+	}
+	wStrDelete(&(ctx->searchQuery));
+	ctx->searchHits = 0;
+	const size_t count = vec_size(ctx->v);
+	uint8_t * hits = (query != NULL) ? calloc(count + 1, sizeof(uint8_t)) : NULL;
+	if (hits == NULL) {
+		if (query != NULL) {
+			processNotify(ctx, NULL, L"searchApply", errStr[ERR_OUT_OF_MEMORY]);
+			free(query);
+		}
+		processFilterList(ctx, NULL);
+		processUpdateStatus(ctx);
+		TRACE_END("search", "searchApply");
+		return;
+	}
+	ctx->searchQuery = query;
+	/* collect the candidate items; all items without a usable index */
+	uint32_t * docs = NULL;
+	size_t docCount = count;
+	bool indexed = false;
+	char * utf8 = (ctx->search != NULL) ? wToUtf8(query) : NULL;
+	if (utf8 != NULL) {
+		indexed = tgi_query(ctx->search, (const uint8_t *)utf8, strlen(utf8), &docs, &docCount);
+		free(utf8);
+	}
+	if ( ! indexed ) {
+		docCount = count;
+	}
+	/* verify the candidates */
+	for (size_t n = 0; n < docCount; ++n) {
+		const size_t i = indexed ? (size_t)(docs[n]) : n;
+		wchar_t * str = outputGet(vec_at(ctx->v, i));
+		if (str != NULL && searchFind(str, query) != NULL) {
+			hits[i] = 1;
+			++(ctx->searchHits);
+		}
+		free(str);
+	}
+	free(docs);
+	processFilterList(ctx, hits);
+	free(hits);
+	processUpdateStatus(ctx);
+	TRACE_END("search", "searchApply");
+}
+
+
+/**
+ * Schedules filtering the process list again if an output search query is
+ * active. This includes items which produced matching output in the meantime.
+ *
+ * @param[in] ctx - Window/IPC context
+ */
+void searchRefresh(tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->searchQuery == NULL || ctx->hWnd == NULL) {
+		return;
+	}
+	SetTimer(ctx->hWnd, PROCESS_SEARCH_TIMER, PROCESS_SEARCH_DELAY, NULL);
+}
+
+
+/**
+ * Selects the first occurrence of the active output search query within the
+ * output widget and scrolls to its line.
+ *
+ * @param[in] ctx - Window/IPC context
+ */
+void searchReveal(const tIpcWndCtx * ctx) {
+	if (ctx == NULL || ctx->searchQuery == NULL || ctx->hInfo == NULL || ctx->selList < 0) {
+		return;
+	}
+	const int len = GetWindowTextLengthW(ctx->hInfo);
+	if (len <= 0) {
+		return;
+	}
+	wchar_t * str = malloc((size_t)(len + 1) * sizeof(wchar_t));
+	if (str == NULL) {
+		return;
+	}
+	if (GetWindowTextW(ctx->hInfo, str, len + 1) > 0) {
+		const wchar_t * pos = searchFind(str, ctx->searchQuery);
+		if (pos != NULL) {
+			const size_t start = (size_t)(pos - str);
+			const size_t end = start + wcslen(ctx->searchQuery);
+			SendMessageW(ctx->hInfo, EM_SETSEL, (WPARAM)start, (LPARAM)end);
+			SendMessageW(ctx->hInfo, EM_SCROLLCARET, 0, 0);
+		}
+	}
+	free(str);
+}
+
+
+/**
+ * Deletes the output search index and query.
+ *
+ * @param[in,out] ctx - Window/IPC context
+ */
+void searchDelete(tIpcWndCtx * ctx) {
+	if (ctx == NULL) {
+		return;
+	}
+	tgi_delete(ctx->search);
+	ctx->search = NULL;
+	wStrDelete(&(ctx->searchQuery));
+	ctx->searchHits = 0;
+}
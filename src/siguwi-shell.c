@@ -0,0 +1,476 @@
+/**
+ * @file siguwi-shell.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Shell drop target COM object. Explorer passes the complete selection of a
+ * multi-select context menu invocation via `IDropTarget::Drop()`.
+ */
+typedef struct {
+	IDropTarget iface; /**< must be the first member */
+	LONG refs; /**< reference counter (static object) */
+	tVector * files; /**< received file paths (`wchar_t *`) */
+	HRESULT result; /**< result of the drop or `E_PENDING` */
+} tShellDropTarget;
+
+
+/**
+ * Class factory for the single use shell drop target.
+ */
+typedef struct {
+	IClassFactory iface; /**< must be the first member */
+	tShellDropTarget * target; /**< the only instance */
+} tShellDropFactory;
+
+
+/**
+ * Adds a copy of the given path as absolute path to the file list.
+ *
+ * @param[in,out] files - file list (`wchar_t *`)
+ * @param[in] path - file path
+ * @return `true` on success, else `false`
+ */
+bool shellFilesAdd(tVector * files, const wchar_t * path) {
+	wchar_t * str = wcsdup(path);
+	if (str == NULL || ( ! wToFullPath(&str, true) )) {
+		wStrDelete(&str);
+		return false;
+	}
+	wchar_t ** item = vec_pushBack(files);
+	if (item == NULL) {
+		free(str);
+		return false;
+	}
+	*item = str;
+	return true;
+}
+
+
+/**
+ * `IUnknown::QueryInterface()` of the drop target.
+ */
+static HRESULT STDMETHODCALLTYPE shellDropQueryInterface(IDropTarget * This, REFIID riid, void ** ppvObject) {
+	if (ppvObject == NULL) {
+		return E_POINTER;
+	}
+	if (IsEqualIID(riid, &IID_IUnknown) || IsEqualIID(riid, &IID_IDropTarget)) {
+		*ppvObject = This;
+		This->lpVtbl->AddRef(This);
+		return S_OK;
+	}
+	*ppvObject = NULL;
+	return E_NOINTERFACE;
+}
+
+
+/**
+ * `IUnknown::AddRef()` of the drop target.
+ */
+static ULONG STDMETHODCALLTYPE shellDropAddRef(IDropTarget * This) {
+	tShellDropTarget * self = (tShellDropTarget *)This;
+	return (ULONG)InterlockedIncrement(&(self->refs));
+}
+
+
+/**
+ * `IUnknown::Release()` of the drop target. The object itself is not freed.
+ */
+static ULONG STDMETHODCALLTYPE shellDropRelease(IDropTarget * This) {
+	tShellDropTarget * self = (tShellDropTarget *)This;
+	return (ULONG)InterlockedDecrement(&(self->refs));
+}
+
+
+/**
+ * `IDropTarget::DragEnter()` accepting copy operations only.
+ */
+static HRESULT STDMETHODCALLTYPE shellDropDragEnter(IDropTarget * This, IDataObject * pDataObj, DWORD grfKeyState, POINTL pt, DWORD * pdwEffect) {
+	PCF_UNUSED(This);
+	PCF_UNUSED(pDataObj);
+	PCF_UNUSED(grfKeyState);
+	PCF_UNUSED(pt);
+	if (pdwEffect != NULL) {
+		*pdwEffect &= DROPEFFECT_COPY;
+	}
+	return S_OK;
+}
+
+
+/**
+ * `IDropTarget::DragOver()` accepting copy operations only.
+ */
+static HRESULT STDMETHODCALLTYPE shellDropDragOver(IDropTarget * This, DWORD grfKeyState, POINTL pt, DWORD * pdwEffect) {
+	PCF_UNUSED(This);
+	PCF_UNUSED(grfKeyState);
+	PCF_UNUSED(pt);
+	if (pdwEffect != NULL) {
+		*pdwEffect &= DROPEFFECT_COPY;
+	}
+	return S_OK;
+}
+
+
+/**
+ * `IDropTarget::DragLeave()`.
+ */
+static HRESULT STDMETHODCALLTYPE shellDropDragLeave(IDropTarget * This) {
+	PCF_UNUSED(This);
+	return S_OK;
+}
+
+
+/**
+ * `IDropTarget::Drop()` receiving the selected files. This ends the message
+ * loop of `shellDropTarget()`.
+ */
+static HRESULT STDMETHODCALLTYPE shellDropDrop(IDropTarget * This, IDataObject * pDataObj, DWORD grfKeyState, POINTL pt, DWORD * pdwEffect) {
+	PCF_UNUSED(grfKeyState);
+	PCF_UNUSED(pt);
+	tShellDropTarget * self = (tShellDropTarget *)This;
+	FORMATETC fmt = {CF_HDROP, NULL, DVASPECT_CONTENT, -1, TYMED_HGLOBAL};
+	STGMEDIUM stg;
+	ZeroMemory(&stg, sizeof(stg));
+	HRESULT hRes = (pDataObj != NULL) ? pDataObj->lpVtbl->GetData(pDataObj, &fmt, &stg) : E_INVALIDARG;
+	if ( SUCCEEDED(hRes) ) {
+		const HDROP hDrop = (HDROP)GlobalLock(stg.hGlobal);
+		if (hDrop != NULL) {
+			const UINT count = DragQueryFileW(hDrop, 0xFFFFFFFF, NULL, 0);
+			for (UINT i = 0; i < count && SUCCEEDED(hRes); ++i) {
+				const UINT n = DragQueryFileW(hDrop, i, NULL, 0);
+				wchar_t * path = malloc((n + 1) * sizeof(wchar_t));
+				if (path == NULL || DragQueryFileW(hDrop, i, path, n + 1) != n || ( ! shellFilesAdd(self->files, path) )) {
+					hRes = E_OUTOFMEMORY;
+				}
+				free(path);
+			}
+			GlobalUnlock(stg.hGlobal);
+		} else {
+			hRes = E_UNEXPECTED;
+		}
+		ReleaseStgMedium(&stg);
+	}
+	if (pdwEffect != NULL) {
+		*pdwEffect = SUCCEEDED(hRes) ? DROPEFFECT_COPY : DROPEFFECT_NONE;
+	}
+	self->result = hRes;
+	PostQuitMessage(0);
+	return hRes;
+}
+
+
+/**
+ * `IUnknown::QueryInterface()` of the class factory.
+ */
+static HRESULT STDMETHODCALLTYPE shellFactoryQueryInterface(IClassFactory * This, REFIID riid, void ** ppvObject) {
+	if (ppvObject == NULL) {
+		return E_POINTER;
+	}
+	if (IsEqualIID(riid, &IID_IUnknown) || IsEqualIID(riid, &IID_IClassFactory)) {
+		*ppvObject = This;
+		return S_OK;
+	}
+	*ppvObject = NULL;
+	return E_NOINTERFACE;
+}
+
+
+/**
+ * `IUnknown::AddRef()` of the static class factory.
+ */
+static ULONG STDMETHODCALLTYPE shellFactoryAddRef(IClassFactory * This) {
+	PCF_UNUSED(This);
+	return 2; /* static object */
+}
+
+
+/**
+ * `IUnknown::Release()` of the static class factory.
+ */
+static ULONG STDMETHODCALLTYPE shellFactoryRelease(IClassFactory * This) {
+	PCF_UNUSED(This);
+	return 1; /* static object */
+}
+
+
+/**
+ * `IClassFactory::CreateInstance()` returning the single drop target.
+ */
+static HRESULT STDMETHODCALLTYPE shellFactoryCreateInstance(IClassFactory * This, IUnknown * pUnkOuter, REFIID riid, void ** ppvObject) {
+	tShellDropFactory * self = (tShellDropFactory *)This;
+	if (ppvObject == NULL) {
+		return E_POINTER;
+	}
+	*ppvObject = NULL;
+	if (pUnkOuter != NULL) {
+		return CLASS_E_NOAGGREGATION;
+	}
+	return shellDropQueryInterface(&(self->target->iface), riid, ppvObject);
+}
+
+
+/**
+ * `IClassFactory::LockServer()`. The server lifetime is bound to the drop.
+ */
+static HRESULT STDMETHODCALLTYPE shellFactoryLockServer(IClassFactory * This, BOOL fLock) {
+	PCF_UNUSED(This);
+	PCF_UNUSED(fLock);
+	return S_OK;
+}
+
+
+/**
+ * Runs the shell drop target as single use COM local server until Explorer
+ * passed the selected files or `DROP_TARGET_TIMEOUT` elapsed. This is started
+ * by COM with the command-line registered by `regRegister()`.
+ *
+ * @param[in] clsid - class ID string of the registered drop target
+ * @param[in,out] files - receives the selected files (`wchar_t *`)
+ * @return `true` on success, else `false` with the error code in `GetLastError()`
+ */
+bool shellDropTarget(const wchar_t * clsid, tVector * files) {
+	static IDropTargetVtbl dropVtbl = {
+		shellDropQueryInterface,
+		shellDropAddRef,
+		shellDropRelease,
+		shellDropDragEnter,
+		shellDropDragOver,
+		shellDropDragLeave,
+		shellDropDrop
+	};
+	static IClassFactoryVtbl factoryVtbl = {
+		shellFactoryQueryInterface,
+		shellFactoryAddRef,
+		shellFactoryRelease,
+		shellFactoryCreateInstance,
+		shellFactoryLockServer
+	};
+	if (clsid == NULL || files == NULL) {
+		SetLastError(ERROR_INVALID_PARAMETER);
+		return false;
+	}
+	CLSID id;
+	HRESULT hRes = CLSIDFromString(clsid, &id);
+	if ( FAILED(hRes) ) {
+		SetLastError((DWORD)hRes);
+		return false;
+	}
+	tShellDropTarget target = {{&dropVtbl}, 1, files, E_PENDING};
+	tShellDropFactory factory = {{&factoryVtbl}, &target};
+	hRes = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+	if ( FAILED(hRes) ) {
+		SetLastError((DWORD)hRes);
+		return false;
+	}
+	DWORD cookie = 0;
+	hRes = CoRegisterClassObject(&id, (IUnknown *)&(factory.iface), CLSCTX_LOCAL_SERVER, REGCLS_SINGLEUSE, &cookie);
+	if ( SUCCEEDED(hRes) ) {
+		/* wait for the drop */
+		const UINT_PTR timer = SetTimer(NULL, 0, DROP_TARGET_TIMEOUT, NULL);
+		MSG msg;
+		while (GetMessageW(&msg, NULL, 0, 0) > 0) {
+			if (msg.message == WM_TIMER && msg.hwnd == NULL && msg.wParam == timer) {
+				break;
+			}
+			TranslateMessage(&msg);
+			DispatchMessageW(&msg);
+		}
+		KillTimer(NULL, timer);
+		CoRevokeClassObject(cookie);
+		hRes = (target.result == E_PENDING) ? HRESULT_FROM_WIN32(ERROR_TIMEOUT) : target.result;
+	}
+	CoUninitialize();
+	if ( FAILED(hRes) ) {
+		SetLastError((DWORD)hRes);
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * Builds the request coalescing pipe path for the given configuration.
+ *
+ * @param[out] buf - output buffer
+ * @param[in] size - size of `buf` in number of characters
+ * @param[in] configUrl - INI file path
+ * @param[in] configGroup - INI section name
+ */
+static void shellCoalescePipe(wchar_t * buf, const size_t size, const wchar_t * configUrl, const wchar_t * configGroup) {
+	uint32_t crc = UINT32_MAX;
+	for (const wchar_t * str = configUrl; *str != 0; ++str) {
+		const wchar_t ch = (wchar_t)towlower((wint_t)(*str));
+		crc = crc32Update(crc, &ch, sizeof(ch));
+	}
+	crc = crc32Update(crc, L":", sizeof(wchar_t));
+	crc = crc32Update(crc, configGroup, wcslen(configGroup) * sizeof(wchar_t));
+	snwprintf(buf, size, L"%s%08X", COALESCE_PIPE_PATH, (unsigned)(crc ^ UINT32_MAX));
+	buf[size - 1] = 0;
+}
+
+
+/**
+ * Passes the given files to the collecting invocation.
+ *
+ * @param[in] hPipe - connected coalescing pipe
+ * @param[in] files - file list (`wchar_t *`)
+ * @return `true` on success, else `false`
+ */
+static bool shellCoalesceSend(HANDLE hPipe, tVector * files) {
+	bool res = true;
+	for (size_t i = 0; res && i < vec_size(files); ++i) {
+		const wchar_t * path = *((wchar_t **)vec_at(files, i));
+		const DWORD bytesToWrite = (DWORD)((wcslen(path) + 1) * sizeof(wchar_t));
+		DWORD bytesWritten = 0;
+		res = WriteFile(hPipe, path, bytesToWrite, &bytesWritten, NULL) && bytesWritten >= bytesToWrite;
+	}
+	return res;
+}
+
+
+/**
+ * Reads all files sent by a single coalescing client.
+ *
+ * @param[in] hPipe - connected coalescing pipe
+ * @param[in,out] ov - overlapped structure with event
+ * @param[in,out] files - file list (`wchar_t *`)
+ */
+static void shellCoalesceReceive(HANDLE hPipe, OVERLAPPED * ov, tVector * files) {
+	static wchar_t buf[MAX_CONFIG_STR_LEN];
+	size_t bufLen = 0; /* in characters */
+	for (;;) {
+		DWORD n = 0;
+		ResetEvent(ov->hEvent);
+		if ( ! ReadFile(hPipe, (uint8_t *)buf + (bufLen * sizeof(wchar_t)), (DWORD)((ARRAY_SIZE(buf) - bufLen) * sizeof(wchar_t)), NULL, ov) ) {
+			if (GetLastError() != ERROR_IO_PENDING) {
+				break;
+			}
+			if (WaitForSingleObject(ov->hEvent, COALESCE_MAX_TIME) != WAIT_OBJECT_0) {
+				CancelIo(hPipe);
+				GetOverlappedResult(hPipe, ov, &n, TRUE);
+				break;
+			}
+		}
+		if ( ! GetOverlappedResult(hPipe, ov, &n, FALSE) || n == 0 ) {
+			break;
+		}
+		bufLen += (size_t)(n / sizeof(wchar_t));
+		/* split at null-terminators */
+		size_t start = 0;
+		for (size_t i = 0; i < bufLen; ++i) {
+			if (buf[i] == 0) {
+				if (i > start) {
+					shellFilesAdd(files, buf + start);
+				}
+				start = i + 1;
+			}
+		}
+		if (start == 0 && bufLen >= ARRAY_SIZE(buf)) {
+			break; /* path too long */
+		}
+		memmove(buf, buf + start, (bufLen - start) * sizeof(wchar_t));
+		bufLen -= start;
+	}
+}
+
+
+/**
+ * Merges concurrent invocations with the same configuration into one request.
+ * The first invocation collects the files of all following ones until no new
+ * invocation arrived for `COALESCE_WINDOW` milliseconds or `COALESCE_MAX_TIME`
+ * elapsed. All other invocations pass their files to it and exit without
+ * parsing the configuration. This covers shell integrations which start one
+ * process per selected file. Nothing is merged if a processing window exists.
+ *
+ * @param[in] configUrl - INI file path
+ * @param[in] configGroup - INI section name
+ * @param[in,out] files - file list (`wchar_t *`); receives the merged files
+ * @return `true` if the caller shall process `files`, else `false` if passed on
+ */
+bool shellCoalesce(const wchar_t * configUrl, const wchar_t * configGroup, tVector * files) {
+	if (configUrl == NULL || configGroup == NULL || files == NULL || vec_size(files) == 0) {
+		return true;
+	}
+	if (WaitNamedPipeW(IPC_PIPE_PATH, 1) || GetLastError() == ERROR_SEM_TIMEOUT) {
+		/* an existing processing window queues the files right away */
+		return true;
+	}
+	wchar_t pipeName[128];
+	shellCoalescePipe(pipeName, ARRAY_SIZE(pipeName), configUrl, configGroup);
+	HANDLE hPipe = INVALID_HANDLE_VALUE;
+	for (size_t i = 0; i < 3; ++i) {
+		/* try to collect */
+		hPipe = CreateNamedPipeW(pipeName, PIPE_ACCESS_INBOUND | FILE_FLAG_FIRST_PIPE_INSTANCE | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, 0, MAX_CONFIG_STR_LEN, 0, NULL);
+		if (hPipe != INVALID_HANDLE_VALUE) {
+			break;
+		}
+		/* try to pass the files to the collecting invocation */
+		HANDLE hClient = CreateFileW(pipeName, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+		if (hClient != INVALID_HANDLE_VALUE) {
+			const bool sent = shellCoalesceSend(hClient, files);
+			CloseHandle(hClient);
+			if ( sent ) {
+				return false;
+			}
+		} else if (GetLastError() == ERROR_PIPE_BUSY) {
+			WaitNamedPipeW(pipeName, COALESCE_MAX_TIME);
+		}
+	}
+	if (hPipe == INVALID_HANDLE_VALUE) {
+		return true; /* process the own files only */
+	}
+	/* collect files of concurrent invocations */
+	OVERLAPPED ov;
+	ZeroMemory(&ov, sizeof(ov));
+	ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	const ULONGLONG end = GetTickCount64() + COALESCE_MAX_TIME;
+	while (ov.hEvent != NULL) {
+		const ULONGLONG now = GetTickCount64();
+		if (now >= end) {
+			break;
+		}
+		DWORD n = 0;
+		bool connected = false;
+		ResetEvent(ov.hEvent);
+		if ( ConnectNamedPipe(hPipe, &ov) ) {
+			connected = true;
+		} else if (GetLastError() == ERROR_PIPE_CONNECTED) {
+			connected = true;
+		} else if (GetLastError() == ERROR_IO_PENDING) {
+			const DWORD wait = (DWORD)PCF_MIN((ULONGLONG)COALESCE_WINDOW, end - now);
+			if (WaitForSingleObject(ov.hEvent, wait) != WAIT_OBJECT_0) {
+				/* no further invocation within the coalescing window */
+				CancelIo(hPipe);
+			}
+			connected = GetOverlappedResult(hPipe, &ov, &n, TRUE) != FALSE;
+		}
+		if ( ! connected ) {
+			break;
+		}
+		shellCoalesceReceive(hPipe, &ov, files);
+		DisconnectNamedPipe(hPipe);
+	}
+	closeHandlePtr(&(ov.hEvent), NULL);
+	CloseHandle(hPipe);
+	return true;
+}
+
+
+/**
+ * Frees the given file list and all its paths.
+ *
+ * @param[in,out] files - file list (`wchar_t *`) or `NULL`
+ */
+void shellFilesDelete(tVector * files) {
+	if (files == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < vec_size(files); ++i) {
+		wStrDelete((wchar_t **)vec_at(files, i));
+	}
+	vec_delete(files);
+}
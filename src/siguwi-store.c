@@ -0,0 +1,368 @@
+/**
+ * @file siguwi-store.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#include "siguwi.h"
+
+
+/**
+ * Creates a new compressed output blob from the given normalized output.
+ *
+ * @param[in] str - normalized output
+ * @param[in] len - length of `str` in number of characters
+ * @return new blob with a reference count of 1 or `NULL` on allocation error
+ */
+tOutputBlob * outputBlobCreate(const wchar_t * str, const size_t len) {
+	if (str == NULL) {
+		return NULL;
+	}
+	const size_t rawSize = len * sizeof(wchar_t);
+	const size_t bound = LZ_BOUND(rawSize);
+	uint8_t * buf = malloc(bound);
+	if (buf == NULL) {
+		return NULL;
+	}
+	size_t compLen = 0;
+	if ( ! lz_compress(str, rawSize, buf, bound, &compLen) ) {
+		free(buf);
+		return NULL;
+	}
+	tOutputBlob * res = malloc(sizeof(tOutputBlob) + compLen);
+	if (res != NULL) {
+		res->refCount = 1;
+		res->hash = crc32Update(UINT32_MAX, str, rawSize) ^ UINT32_MAX;
+		res->rawLen = len;
+		res->compLen = compLen;
+		res->failures = 0;
+		memcpy(res->data, buf, compLen);
+	}
+	free(buf);
+	return res;
+}
+
+
+/**
+ * Clones the given output blob. This is compatible with `HashFunctionCloneO`.
+ *
+ * @param[in,out] blob - blob to clone
+ * @return cloned blob
+ */
+tOutputBlob * outputBlobClone(tOutputBlob * blob) {
+	if (blob == NULL) {
+		return NULL;
+	}
+	InterlockedIncrement(&(blob->refCount));
+	return blob;
+}
+
+
+/**
+ * Compares two output blobs. The codec is deterministic. Hence, equal compressed
+ * data implies equal normalized output. This is compatible with
+ * `HashFunctionCmpO`.
+ *
+ * @param[in] lhs - left-hand sided blob
+ * @param[in] rhs - right-hand sided blob
+ * @return 0 if equal, not 0 in every other case
+ */
+int outputBlobCmp(const tOutputBlob * lhs, const tOutputBlob * rhs) {
+	if (lhs == rhs) {
+		return 0;
+	}
+	if (lhs == NULL) {
+		return INT_MAX;
+	}
+	if (rhs == NULL) {
+		return INT_MIN;
+	}
+	if (lhs->hash != rhs->hash) {
+		return (lhs->hash < rhs->hash) ? -1 : 1;
+	}
+	if (lhs->rawLen != rhs->rawLen) {
+		return (lhs->rawLen < rhs->rawLen) ? -1 : 1;
+	}
+	if (lhs->compLen != rhs->compLen) {
+		return (lhs->compLen < rhs->compLen) ? -1 : 1;
+	}
+	return memcmp(lhs->data, rhs->data, lhs->compLen);
+}
+
+
+/**
+ * Calculates the hash value of the given output blob. This is compatible with
+ * `HashFunctionHashO`.
+ *
+ * @param[in] key - output blob
+ * @param[in] limit - hash table size
+ * @return hash value
+ */
+size_t outputBlobHash(const tOutputBlob * key, const size_t limit) {
+	return (size_t)(key->hash) % limit;
+}
+
+
+/**
+ * Releases the given output blob. This is compatible with `HashFunctionDelO`.
+ *
+ * @param[in,out] blob - blob to release
+ */
+void outputBlobDelete(tOutputBlob * blob) {
+	if (blob == NULL) {
+		return;
+	}
+	if (InterlockedDecrement(&(blob->refCount)) == 0) {
+		free(blob);
+	}
+}
+
+
+/**
+ * Replaces all occurrences of the item path and file name with placeholders
+ * in-place. This maps outputs which only differ in the signed file to the same
+ * content.
+ *
+ * @param[in,out] str - output to normalize
+ * @param[in] path - full item path
+ * @return new length of `str` in number of characters
+ */
+static size_t outputNormalize(wchar_t * str, wchar_t * path) {
+	const wchar_t * name = wFileName(path);
+	const size_t pathLen = wcslen(path);
+	const size_t nameLen = (name != path) ? wcslen(name) : 0;
+	wchar_t * out = str;
+	const wchar_t * in = str;
+	while (*in != 0) {
+		if (pathLen > 0 && *in == *path && wcsncmp(in, path, pathLen) == 0) {
+			*out++ = OUTPUT_PATH_PLACEHOLDER;
+			in += pathLen;
+		} else if (nameLen > 0 && *in == *name && wcsncmp(in, name, nameLen) == 0) {
+			*out++ = OUTPUT_NAME_PLACEHOLDER;
+			in += nameLen;
+		} else {
+			*out++ = *in++;
+		}
+	}
+	*out = 0;
+	return (size_t)(out - str);
+}
+
+
+/**
+ * Compresses the output of the given item and moves it to the output store.
+ * Identical normalized outputs are stored only once. The number of failed
+ * items per stored output is kept to group them by their error output.
+ *
+ * @param[in,out] h - output store
+ * @param[in,out] item - finished item
+ * @return `true` on success, else `false` if the output remains uncompressed
+ */
+bool outputStore(tHTableO * h, tProcCtx * item) {
+	if (h == NULL || item == NULL || item->output == NULL || item->blob != NULL || item->path == NULL) {
+		return false;
+	}
+	size_t len = usb_len(item->output);
+	wchar_t * str = malloc((len + 1) * sizeof(wchar_t));
+	if (str == NULL) {
+		return false;
+	}
+	usb_copyToStr(item->output, str);
+	/* outputs with placeholder characters are stored as is to remain reversible */
+	const bool verbatim = (wcschr(str, OUTPUT_PATH_PLACEHOLDER) != NULL || wcschr(str, OUTPUT_NAME_PLACEHOLDER) != NULL);
+	if ( ! verbatim ) {
+		len = outputNormalize(str, item->path);
+	}
+	tOutputBlob * blob = outputBlobCreate(str, len);
+	free(str);
+	if (blob == NULL) {
+		return false;
+	}
+	tOutputBlob ** slot = (tOutputBlob **)hto_addKey(h, blob);
+	if (slot == NULL) {
+		outputBlobDelete(blob);
+		return false;
+	}
+	if (*slot == NULL) {
+		/* new entry -> the table holds its own reference */
+		*slot = blob;
+	} else {
+		/* same output stored before */
+		tOutputBlob * shared = outputBlobClone(*slot);
+		outputBlobDelete(blob);
+		blob = shared;
+	}
+	if (item->state != PST_OK) {
+		++(blob->failures);
+	}
+	item->blob = blob;
+	item->outputVerbatim = verbatim;
+	usb_delete(item->output);
+	item->output = NULL;
+	return true;
+}
+
+
+/**
+ * Releases the stored output reference of the given item. The stored output is
+ * removed from the store with its last item reference.
+ *
+ * @param[in,out] h - output store
+ * @param[in,out] item - item to modify
+ */
+void outputRelease(tHTableO * h, tProcCtx * item) {
+	if (item == NULL || item->blob == NULL) {
+		return;
+	}
+	tOutputBlob * blob = item->blob;
+	item->blob = NULL;
+	if (item->state != PST_OK && blob->failures > 0) {
+		--(blob->failures);
+	}
+	if (h != NULL && blob->refCount <= 2) {
+		/* only referenced by the store and this item */
+		hto_delKey(h, blob);
+	}
+	outputBlobDelete(blob);
+}
+
+
+/**
+ * Returns the output of the given item. Stored outputs are decompressed and
+ * the placeholders are replaced with the item path and file name.
+ *
+ * @param[in] item - item to get the output from
+ * @return newly allocated output string or `NULL` on error or empty uncompressed output
+ */
+wchar_t * outputGet(const tProcCtx * item) {
+	if (item == NULL) {
+		return NULL;
+	}
+	if (item->output != NULL) {
+		return usb_get(item->output);
+	}
+	const tOutputBlob * blob = item->blob;
+	if (blob == NULL) {
+		return NULL;
+	}
+	wchar_t * raw = malloc((blob->rawLen + 1) * sizeof(wchar_t));
+	if (raw == NULL) {
+		return NULL;
+	}
+	size_t rawSize = 0;
+	if ( ! lz_decompress(blob->data, blob->compLen, raw, blob->rawLen * sizeof(wchar_t), &rawSize) || rawSize != (blob->rawLen * sizeof(wchar_t)) ) {
+		free(raw);
+		return NULL;
+	}
+	raw[blob->rawLen] = 0;
+	if ( item->outputVerbatim ) {
+		return raw;
+	}
+	/* restore item path and file name */
+	const wchar_t * name = wFileName(item->path);
+	const size_t pathLen = wcslen(item->path);
+	const size_t nameLen = wcslen(name);
+	size_t len = 0;
+	for (const wchar_t * ptr = raw; *ptr != 0; ++ptr) {
+		switch (*ptr) {
+		case OUTPUT_PATH_PLACEHOLDER: len += pathLen; break;
+		case OUTPUT_NAME_PLACEHOLDER: len += nameLen; break;
+		default: ++len; break;
+		}
+	}
+	wchar_t * res = malloc((len + 1) * sizeof(wchar_t));
+	if (res != NULL) {
+		wchar_t * out = res;
+		for (const wchar_t * ptr = raw; *ptr != 0; ++ptr) {
+			switch (*ptr) {
+			case OUTPUT_PATH_PLACEHOLDER:
+				wmemcpy(out, item->path, pathLen);
+				out += pathLen;
+				break;
+			case OUTPUT_NAME_PLACEHOLDER:
+				wmemcpy(out, name, nameLen);
+				out += nameLen;
+				break;
+			default:
+				*out++ = *ptr;
+				break;
+			}
+		}
+		*out = 0;
+	}
+	free(raw);
+	return res;
+}
+
+
+/**
+ * Prefixes each line of the given item output with its start time in seconds
+ * since the signing application was created. Lines without a recorded time,
+ * like the note about a truncated output, are indented instead.
+ *
+ * @param[in] item - item
+ * @param[in] str - item output as returned by `outputGet()`
+ * @return new output string or `NULL` if no line times are available or on error
+ */
+wchar_t * outputAddLineTimes(const tProcCtx * item, const wchar_t * str) {
+	if (item == NULL || item->lineTimes == NULL || str == NULL) {
+		return NULL;
+	}
+	const size_t count = vec_size(item->lineTimes);
+	tUStrBuf * sb = usb_create(wcslen(str) + (count * 12) + 1);
+	if (sb == NULL) {
+		return NULL;
+	}
+	bool ok = true;
+	size_t line = 0;
+	for (const wchar_t * ptr = str; ok && *ptr != 0; ++line) {
+		const wchar_t * end = wcschr(ptr, L'\n');
+		const size_t len = (end != NULL) ? (size_t)(end - ptr + 1) : wcslen(ptr);
+		if (line < count) {
+			ok = usb_addFmt(sb, L"[%9.3f] %.*s", (double)(*((const uint32_t *)vec_at(item->lineTimes, line))) / 1000000.0, (int)len, ptr) > 0;
+		} else {
+			ok = usb_addFmt(sb, L"            %.*s", (int)len, ptr) > 0;
+		}
+		ptr += len;
+	}
+	wchar_t * res = ok ? usb_get(sb) : NULL;
+	usb_delete(sb);
+	return res;
+}
+
+
+/**
+ * Moves the stored output of the given item back into an uncompressed string
+ * buffer to allow further modifications.
+ *
+ * @param[in,out] h - output store
+ * @param[in,out] item - item to modify
+ * @return `true` on success, else `false`
+ */
+bool outputRestore(tHTableO * h, tProcCtx * item) {
+	if (item == NULL) {
+		return false;
+	}
+	if (item->output != NULL) {
+		return true;
+	}
+	if (item->blob == NULL) {
+		return false;
+	}
+	wchar_t * str = outputGet(item);
+	if (str == NULL) {
+		return false;
+	}
+	tUStrBuf * sb = usb_create(4096);
+	if (sb == NULL || (*str != 0 && usb_add(sb, str) == 0)) {
+		if (sb != NULL) {
+			usb_delete(sb);
+		}
+		free(str);
+		return false;
+	}
+	free(str);
+	outputRelease(h, item);
+	item->output = sb;
+	return true;
+}
@@ -2,7 +2,7 @@
  * @file siguwi.h
  * @author Daniel Starke
  * @date 2025-06-14
- * @version 2025-10-21
+ * @version 2026-10-18
  */
 #ifndef __SIGUWI_H__
 #define __SIGUWI_H__
@@ -12,13 +12,17 @@
 #include <limits.h>
 #include <math.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <wchar.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
 #include <windows.h>
 #include <windowsx.h>
 #include <commctrl.h>
+#include <iphlpapi.h>
 #include <ntsecapi.h>
 #include <objbase.h>
 #include <psapi.h>
@@ -26,16 +30,33 @@
 #include <shlobj.h>
 #include <shlwapi.h>
 #include <wincred.h>
+#include <winioctl.h>
 #include <winnls.h>
 #include <winscard.h>
+#include "acmatch.h"
+#include "crc32.h"
+#include "dcache.h"
+#include "fdigest.h"
+#include "fidx.h"
 #include "getopt.h"
+#include "histogram.h"
 #include "htableo.h"
+#include "ini.h"
+#include "lqueue.h"
+#include "lz.h"
+#include "procusage.h"
 #include "rcwstr.h"
+#include "replay.h"
 #include "resource.h"
+#include "sha256.h"
 #include "target.h"
+#include "trace.h"
+#include "trigram.h"
 #include "ustrbuf.h"
 #include "utf8.h"
 #include "vector.h"
+#include "wpool.h"
+#include "zip.h"
 
 
 #if ! (defined(UNICODE) && defined(_UNICODE))
@@ -82,6 +103,32 @@ extern int __wgetmainargs(int *, wchar_t ***, wchar_t ***, int, int *);
 #define IPC_MAX_CLIENTS 1
 
 
+/**
+ * Request coalescing pipe path prefix. Followed by a hash of the configuration.
+ */
+#define COALESCE_PIPE_PATH IPC_PIPE_PATH L"-merge-"
+
+
+/**
+ * Time in milliseconds without new invocation after which the collected files
+ * of concurrent invocations with the same configuration are processed.
+ */
+#define COALESCE_WINDOW 150
+
+
+/**
+ * Maximum time in milliseconds to collect files of concurrent invocations.
+ */
+#define COALESCE_MAX_TIME 2000
+
+
+/**
+ * Maximum time in milliseconds the shell drop target waits for the selected
+ * files.
+ */
+#define DROP_TARGET_TIMEOUT 30000
+
+
 /**
  * Maximum number of characters for a Windows registry key name.
  *
@@ -104,6 +151,14 @@ extern int __wgetmainargs(int *, wchar_t ***, wchar_t ***, int, int *);
 #define MAX_CONFIG_FILE_LEN (4*1024*1024)
 
 
+/**
+ * Maximum number of signing steps per configuration including the ones added
+ * via its `chain` key.
+ * @see `iniConfigChain()`
+ */
+#define MAX_CHAIN_STEPS 4
+
+
 /**
  * Certificate service provider name.
  */
@@ -122,6 +177,20 @@ extern int __wgetmainargs(int *, wchar_t ***, wchar_t ***, int, int *);
 #define PROCESS_MAX_OUTPUT (1024*1024)
 
 
+/**
+ * Private use characters which replace the item path and file name in stored
+ * outputs. This allows to deduplicate outputs which only differ in these.
+ */
+#define OUTPUT_PATH_PLACEHOLDER L'\xE000'
+#define OUTPUT_NAME_PLACEHOLDER L'\xE001'
+
+
+/**
+ * Number of hash table buckets of the output store.
+ */
+#define OUTPUT_STORE_SIZE 256
+
+
 /**
  * Returns the container base point of the given member pointer.
  *
@@ -133,12 +202,259 @@ extern int __wgetmainargs(int *, wchar_t ***, wchar_t ***, int, int *);
 #define CONTAINER_OF(ptr, type, member) ((type *)((uint8_t *)(ptr) - offsetof(type, member)))
 
 
+/**
+ * Number of pre-created signing application pipe sets.
+ */
+#define PIPE_POOL_SIZE 4
+
+
 /**
  * Number of pixel for the widget separator.
  */
 #define SEP_WIDTH 6
 
 
+/**
+ * Number of pixel for the output search query edit control height.
+ */
+#define SEARCH_HEIGHT 22
+
+
+/**
+ * Timer ID and interval in milliseconds to refresh the live statistics in the
+ * process window status bar.
+ */
+#define PROCESS_STATUS_TIMER 1
+#define PROCESS_STATUS_INTERVAL 1000
+
+
+/**
+ * Timer ID and delay in milliseconds after the last change of the output
+ * search query or finished item before the item list is filtered again.
+ */
+#define PROCESS_SEARCH_TIMER 2
+#define PROCESS_SEARCH_DELAY 250
+
+
+/**
+ * Maximum number of notifications kept in the notification log. The oldest
+ * ones are dropped.
+ */
+#define PROCESS_MAX_NOTES 1000
+
+
+/**
+ * Session log queue size in bytes. Needs to be a power of two. Records are
+ * dropped instead of blocking if the queue is full.
+ */
+#define SESSION_LOG_QUEUE_SIZE (4*1024*1024)
+
+
+/**
+ * Session log write buffer size in bytes. This is also the maximum size of a
+ * single record.
+ */
+#define SESSION_LOG_BUFFER_SIZE (256*1024)
+
+
+/**
+ * Maximum time in milliseconds between two session log file writes.
+ */
+#define SESSION_LOG_FLUSH_INTERVAL 250
+
+
+/**
+ * Maximum size of a single session log file before a new one is started.
+ */
+#define SESSION_LOG_MAX_FILE_SIZE (64*1024*1024)
+
+
+/**
+ * Maximum number of session log files per session. The oldest one is removed
+ * if a new one exceeds this limit.
+ */
+#define SESSION_LOG_MAX_FILES 16
+
+
+/**
+ * Session log file signature at offset 0 and in the file trailer.
+ */
+#define SESSION_LOG_MAGIC "SIGUWIL1"
+#define SESSION_LOG_INDEX_MAGIC "SIGUWIIX"
+
+
+/**
+ * Replay trace recorder write buffer size in bytes.
+ */
+#define RECORD_BUFFER_SIZE (64*1024)
+
+
+/**
+ * Maximum size of a single loopback HTTP request including its header in
+ * bytes. Larger requests are rejected.
+ */
+#define HTTP_MAX_REQUEST (64*1024)
+
+
+/**
+ * Maximum number of concurrent loopback HTTP connections. Further connections
+ * are closed right away.
+ */
+#define HTTP_MAX_CLIENTS 256
+
+
+/**
+ * Maximum time in milliseconds a loopback HTTP status request waits for
+ * changes.
+ */
+#define HTTP_MAX_WAIT 60000
+
+
+/**
+ * Time in milliseconds after which idle loopback HTTP connections are closed.
+ */
+#define HTTP_IDLE_TIMEOUT 30000
+
+
+/**
+ * Minimum length of the shared agent key in bytes.
+ */
+#define AGENT_KEY_MIN 16
+
+
+/**
+ * Maximum length of the shared agent key file in bytes.
+ */
+#define AGENT_KEY_MAX 4096
+
+
+/**
+ * Length of an agent request nonce in characters. It consists of the request
+ * time in milliseconds since 1970 and a unique value, both as 16 hex digits.
+ */
+#define AGENT_NONCE_LEN 32
+
+
+/**
+ * Number of hexadecimal digits of the session identifier an agent process
+ * reports with its item states.
+ */
+#define AGENT_SESSION_LEN 24
+
+
+/**
+ * Maximum deviation in milliseconds of the time of a signed agent request from
+ * the local time.
+ */
+#define AGENT_AUTH_WINDOW 300000
+
+
+/**
+ * Number of remembered agent request nonces to reject replayed requests.
+ */
+#define AGENT_AUTH_NONCES 4096
+
+
+/**
+ * Size of the file chunks uploaded to and downloaded from an agent in bytes.
+ */
+#define AGENT_CHUNK_SIZE (48*1024)
+
+
+/**
+ * Directory within the temporary directory receiving uploaded files.
+ */
+#define AGENT_SPOOL_DIR L"siguwi-agent"
+
+
+/**
+ * Maximum size of a file uploaded to an agent in bytes.
+ */
+#define AGENT_MAX_UPLOAD (UINT64_C(4) << 30)
+
+
+/**
+ * Time in milliseconds after the last change of an uploaded file after which
+ * the agent deletes it. This removes files the coordinator abandoned after
+ * passing their jobs on to another agent.
+ */
+#define AGENT_SPOOL_EXPIRY 86400000
+
+
+/**
+ * Maximum number of remote agents.
+ */
+#define REMOTE_MAX_AGENTS 32
+
+
+/**
+ * Maximum number of files passed to a single agent at a time.
+ */
+#define REMOTE_AGENT_DEPTH 2
+
+
+/**
+ * Maximum number of agents a file is passed to before it fails.
+ */
+#define REMOTE_MAX_ATTEMPTS 3
+
+
+/**
+ * Time in milliseconds before an unreachable agent is tried again.
+ */
+#define REMOTE_RETRY_DELAY 5000
+
+
+/**
+ * Time in milliseconds to wait for the connection to an agent.
+ */
+#define REMOTE_CONNECT_TIMEOUT 5000
+
+
+/**
+ * Time in milliseconds an agent status request waits for changes.
+ */
+#define REMOTE_POLL_WAIT 2000
+
+
+/**
+ * Time in milliseconds after which an agent which does not respond is
+ * considered unreachable.
+ */
+#define REMOTE_TIMEOUT 15000
+
+
+/**
+ * Time in milliseconds after which files waiting for an unreachable agent or
+ * for any agent while none is reachable fail.
+ */
+#define REMOTE_DOWN_TIMEOUT 120000
+
+
+/**
+ * Change journal read buffer size in bytes.
+ */
+#define SCAN_JOURNAL_BUFFER_SIZE (64*1024)
+
+
+/**
+ * Directory enumeration buffer size in bytes.
+ */
+#define SCAN_DIR_BUFFER_SIZE (64*1024)
+
+
+/**
+ * Maximum number of file hashing threads.
+ */
+#define HASH_MAX_THREADS 8
+
+
+/**
+ * Digest cache file name within the local application data directory.
+ */
+#define HASH_CACHE_FILE L"digest.cache"
+
+
 #ifndef CRED_PACK_PROTECTED_CREDENTIALS
 #define CRED_PACK_PROTECTED_CREDENTIALS 0x1
 #endif /* CRED_PACK_PROTECTED_CREDENTIALS */
@@ -179,7 +495,31 @@ typedef enum {
 	ERR_GET_STD_HANDLE,
 	ERR_INVALID_REG_VERB,
 	ERR_INIT_COM,
-	ERR_FILE_NOT_FOUND
+	ERR_FILE_NOT_FOUND,
+	ERR_START_PROCESS,
+	ERR_WAIT_PROCESS,
+	ERR_IPC_DISABLED,
+	ERR_TRACE_DISABLED,
+	ERR_SESSION_LOG,
+	ERR_RECORD,
+	ERR_DROP_TARGET,
+	ERR_READ_ARCHIVE,
+	ERR_ARCHIVE_EMPTY,
+	ERR_ARCHIVE_FAILED,
+	ERR_UPDATE_ARCHIVE,
+	ERR_HTTP_PORT,
+	ERR_HTTP_LISTEN,
+	ERR_SCAN_TREE,
+	ERR_TREE_UNCHANGED,
+	ERR_SAVE_INDEX,
+	ERR_MATCH_RULE,
+	ERR_AGENT_SPEC,
+	ERR_AGENT_KEY,
+	ERR_AGENT_NO_KEY,
+	ERR_AGENT_START,
+	ERR_AGENT_DOWN,
+	ERR_AGENT_FAILED,
+	ERR_CHAIN
 } tErrCode;
 
 
@@ -207,10 +547,67 @@ typedef enum {
 	PST_BROKEN_PIPE,
 	PST_APP_NOT_FOUND,
 	PST_PIN_MISSING,
-	PST_PIN_WRONG
+	PST_PIN_WRONG,
+	PST_CANCELLED, /**< only used by the signing engine API */
+	PST_COUNT /**< number of processing states (not a state) */
 } tProcState;
 
 
+/**
+ * Processing stages with a recorded timestamp per item.
+ *
+ * @remarks The report metrics in `siguwi-report.c` are derived from these.
+ */
+typedef enum {
+	PSG_QUEUED, /**< item was added to the process list */
+	PSG_START, /**< `processStart()` was entered */
+	PSG_PIPE, /**< output and input pipes are set up */
+	PSG_PIN, /**< PIN was retrieved and decrypted */
+	PSG_SPAWN, /**< signing application was created */
+	PSG_OUTPUT, /**< first output byte was received */
+	PSG_EXIT, /**< signing application terminated */
+	PSG_DONE, /**< final processing state was set */
+	PSG_COUNT /**< number of processing stages (not a stage) */
+} tProcStage;
+
+
+/**
+ * Digest algorithms of the file hashing pool. The values are persisted in the
+ * digest cache.
+ */
+typedef enum {
+	HA_FILE_SHA256 = 1, /**< SHA-256 of the whole file content */
+	HA_PE_SHA256, /**< SHA-256 of a PE image without signature */
+	HA_MSI_SHA256, /**< SHA-256 of an MSI package without signature */
+	HA_CAB_SHA256, /**< SHA-256 of a cabinet without signature */
+	HA_PS1_SHA256 /**< SHA-256 of a PowerShell script without signature */
+} tHashAlgo;
+
+
+/**
+ * Possible file hashing job states.
+ */
+typedef enum {
+	HJS_PENDING, /**< queued or being hashed */
+	HJS_OK, /**< `digest` is valid */
+	HJS_FAILED, /**< the file could not be read or changed in the meantime */
+	HJS_CANCELLED /**< the hashing pool was shut down */
+} tHashJobState;
+
+
+/**
+ * Session log record types. All multi-byte values are little endian.
+ */
+typedef enum {
+	SLT_SESSION, /**< session start; payload: UTF-8 application name and version */
+	SLT_ITEM, /**< item was added; payload: UTF-8 file path */
+	SLT_OUTPUT, /**< signing application output chunk; payload: raw output bytes */
+	SLT_STATE, /**< processing state change; payload: `uint32_t` state and exit code or `UINT32_MAX` */
+	SLT_DROPPED, /**< records were dropped as the queue was full; payload: `uint64_t` number of records */
+	SLT_INDEX /**< item index at the end of a file; payload: `tSessionLogIndex` entries */
+} tSessionLogType;
+
+
 /**
  * Possible IPC server states.
  */
@@ -219,6 +616,9 @@ typedef enum {
 	IST_CARD_NAME,
 	IST_CARD_READER,
 	IST_SIGN_APP,
+	IST_MATCH,
+	IST_CONFIG_FILE,
+	IST_CHAIN,
 	IST_FILE
 } tIpcState;
 
@@ -229,6 +629,9 @@ typedef enum {
 typedef enum {
 	PCI_FILE,
 	PCI_RESULT,
+	PCI_CPU,
+	PCI_MEMORY,
+	PCI_IO,
 	PCI_PATH
 } tProcColumnIndex;
 
@@ -272,11 +675,28 @@ typedef struct {
 
 
 /**
- * Reference counted single INI file configuration part related to a certificate.
+ * Compiled signing application output classification rules. Rule `i` uses the
+ * pattern identifier `i` of the matcher.
  */
 typedef struct {
+	tAcMatcher * m; /**< ASCII case insensitive matcher over the UTF-8 encoded patterns */
+	size_t count; /**< number of rules */
+	tProcState state[ACM_MAX_PATTERNS]; /**< item state per rule or `PST_IDLE` to only flag the item */
+	wchar_t * pattern[ACM_MAX_PATTERNS]; /**< pattern per rule */
+} tMatchRules;
+
+
+/**
+ * Reference counted single INI file configuration part related to a certificate.
+ * Chained signing steps follow via `next`.
+ */
+typedef struct tRcIniConfigBase {
 	LONG refCount;
 	tIniConfigBase cert[1];
+	tMatchRules * rules; /**< output classification rules or `NULL` (not compared) */
+	wchar_t * name; /**< INI section of a chained signing step or `NULL` (not compared) */
+	tRcWStr * nextSignApp; /**< code signing application command-line of `next` or `NULL` (not compared) */
+	struct tRcIniConfigBase * next; /**< next signing step or `NULL` (not compared) */
 } tRcIniConfigBase;
 
 
@@ -286,25 +706,119 @@ typedef struct {
 typedef struct {
 	tIniConfigBase cert[1];
 	tRcWStr * signApp;
+	wchar_t * match; /**< output classification rules (`state:pattern`) separated by line feeds or `NULL` */
+	wchar_t * chain; /**< comma separated INI sections of the following signing steps or `NULL` */
 } tIniConfig;
 
 
 /**
- * Single file position.
+ * Reference counted, compressed and normalized output of finished items.
+ * Identical outputs share a single instance.
  */
 typedef struct {
-	size_t row; /**< Line number starting at 1. */
-	size_t col; /**< Column within the line starting at 1. */
-} tFilePos;
+	LONG refCount;
+	uint32_t hash; /**< CRC-32 of the normalized output */
+	size_t rawLen; /**< normalized output length in number of characters */
+	size_t compLen; /**< size of `data` in bytes */
+	size_t failures; /**< number of failed items referencing this output */
+	uint8_t data[]; /**< LZ compressed normalized output */
+} tOutputBlob;
+
+
+/**
+ * Single extracted archive entry.
+ */
+typedef struct {
+	size_t index; /**< entry index within the archive */
+	wchar_t * path; /**< extracted file path */
+} tArchiveEntry;
 
 
 /**
- * Single file position.
+ * Archive whose signable entries are extracted and signed as separate items.
+ * The archive is rewritten once all of them finished.
  */
 typedef struct {
-	wchar_t * ptr;
-	size_t len;
-} tToken;
+	LONG refCount; /**< number of references */
+	wchar_t * path; /**< archive path */
+	wchar_t * tmpDir; /**< directory with the extracted entries */
+	tVector * entries; /**< extracted entries (`tArchiveEntry`) in archive order */
+	size_t pending; /**< number of entry items which did not finish yet */
+	size_t failed; /**< number of entry items which failed */
+} tArchive;
+
+
+/**
+ * Archive job kinds. All of them run on the archive thread.
+ */
+typedef enum {
+	AJK_EXTRACT, /**< extract the signable entries */
+	AJK_REWRITE, /**< write the archive back with the signed entries and remove them */
+	AJK_CLEANUP /**< remove the extracted entries of a failed archive */
+} tArchiveJobKind;
+
+
+/**
+ * Single archive job.
+ */
+typedef struct tArchiveJob {
+	struct tArchiveJob * next; /**< next job in the same list */
+	tArchiveJobKind kind; /**< job kind */
+	tArchive * archive; /**< referenced archive */
+	tRcIniConfigBase * config; /**< INI configuration base to sign the extracted entries with or `NULL` */
+	tRcWStr * signApp; /**< code signing application command-line or `NULL` */
+	bool res; /**< job succeeded? */
+	DWORD err; /**< error code of a failed `AJK_REWRITE` job */
+} tArchiveJob;
+
+
+/**
+ * Thread extracting and rewriting archives. Archives are processed one after
+ * another to keep the disk access sequential. Finished jobs are handled by the
+ * process window thread.
+ */
+typedef struct {
+	bool started; /**< `lock`, `wake`, `hDone` and `hThread` are initialized */
+	CRITICAL_SECTION lock; /**< guards `queue`, `queueTail`, `done` and `stop` */
+	CONDITION_VARIABLE wake; /**< signaled for new jobs and on shutdown */
+	HANDLE hDone; /**< auto-reset event signaled for finished jobs or `NULL` */
+	HANDLE hThread; /**< archive thread or `NULL` */
+	tArchiveJob * queue; /**< first queued job or `NULL` */
+	tArchiveJob * queueTail; /**< last queued job or `NULL` */
+	tArchiveJob * done; /**< finished jobs or `NULL` */
+	bool stop; /**< set to finish the archive thread */
+} tArchivePool;
+
+
+/**
+ * Incrementally scanned directory tree. Only files which changed since they
+ * were signed successfully are added as items. The persistent file identity
+ * index is updated as these finish.
+ */
+typedef struct {
+	LONG refCount; /**< number of references */
+	wchar_t * path; /**< root directory path */
+	wchar_t * idxPath; /**< file identity index path */
+	tFileIdx * idx; /**< file identity index */
+	size_t pending; /**< number of items which did not finish yet */
+} tTreeScan;
+
+
+/**
+ * Single file hashing job of a scanned directory tree.
+ */
+typedef struct tHashJob {
+	tWorkItem item; /**< hashing pool item (first member) */
+	wchar_t * path; /**< file path */
+	tDigestKey key; /**< file state at request time */
+	tHashJobState state; /**< current job state */
+	uint8_t digest[SHA256_SIZE]; /**< file content digest according to `key.algo` */
+	bool isSigned; /**< the file has an embedded signature (format-aware digests only) */
+	tTreeScan * tree; /**< scanned directory tree of the file */
+	uint64_t entry; /**< file identity index entry identifier */
+	tRcIniConfigBase * config; /**< configuration to sign the file with if it changed or `NULL` to record the digest */
+	tRcWStr * signApp; /**< code signing application command-line or `NULL` */
+} tHashJob;
 
 
 /**
@@ -315,11 +829,286 @@ typedef struct {
 	tRcIniConfigBase * config;
 	tRcWStr * signApp;
 	wchar_t * path;
-	tUStrBuf * output;
+	tUStrBuf * output; /**< output while processing or `NULL` if moved to `blob` */
+	tOutputBlob * blob; /**< stored output of finished items or `NULL` */
+	bool outputVerbatim; /**< `blob` holds the output without placeholders */
 	bool pinValid;
+	bool hasExitCode; /**< `exitCode` is valid */
+	DWORD exitCode; /**< exit code of the signing application */
+	bool hasUsage; /**< `usage` is valid */
+	tProcUsage usage; /**< resources consumed by the signing application */
+	int64_t stamp[PSG_COUNT]; /**< `reportTicks()` value per processing stage or 0 if not reached */
+	void * tag; /**< user tag passed to `siguwi_engine_submit()` */
+	tArchive * archive; /**< archive of the extracted entry or `NULL` */
+	tTreeScan * tree; /**< scanned directory tree of the file or `NULL` */
+	uint64_t matched; /**< mask of the output rules in `config->rules` that matched */
+	tVector * lineTimes; /**< start time of each output line since `PSG_SPAWN` in microseconds (`uint32_t`) or `NULL` */
+	size_t step; /**< current signing step within the chain of `config` */
 } tProcCtx;
 
 
+/**
+ * Session log record header. It is followed by `size` bytes of payload.
+ */
+typedef struct {
+	uint32_t size; /**< payload size in bytes */
+	uint16_t type; /**< record type (`tSessionLogType`) */
+	uint16_t reserved; /**< always zero */
+	uint32_t item; /**< item index or `UINT32_MAX` */
+	uint32_t crc; /**< CRC-32 of the payload */
+	int64_t time; /**< UTC time in `FILETIME` units */
+} tSessionLogRecord;
+
+
+/**
+ * Session log index entry.
+ */
+typedef struct {
+	uint32_t item; /**< item index */
+	uint32_t reserved; /**< always zero */
+	uint64_t offset; /**< file offset of the first record of this item within the file */
+} tSessionLogIndex;
+
+
+/**
+ * Session log file trailer. This is only present if the file was closed
+ * properly.
+ */
+typedef struct {
+	uint64_t offset; /**< file offset of the `SLT_INDEX` record */
+	char magic[8]; /**< `SESSION_LOG_INDEX_MAGIC` */
+} tSessionLogTrailer;
+
+
+/**
+ * Asynchronous session log writer context. The process window thread is the
+ * only producer and the writer thread the only consumer of the queue.
+ */
+typedef struct {
+	HANDLE hThread; /**< writer thread */
+	HANDLE hWake; /**< auto-reset event to wake up the writer thread early */
+	atomic_bool stop; /**< set to finish the writer thread after the queue was drained */
+	atomic_uint error; /**< first writer thread error code or 0 */
+	uint8_t * queue; /**< ring buffer with `SESSION_LOG_QUEUE_SIZE` bytes of framed records */
+	atomic_size_t head; /**< total number of bytes added by the producer */
+	atomic_size_t tail; /**< total number of bytes removed by the consumer */
+	uint64_t dropped; /**< number of dropped records not yet logged (producer only) */
+	/* writer thread context */
+	wchar_t * prefix; /**< file path without part number and extension */
+	HANDLE hFile; /**< current log file */
+	unsigned part; /**< current log file number */
+	uint64_t offset; /**< current logical file offset including `buf` */
+	uint8_t * buf; /**< write buffer with `SESSION_LOG_BUFFER_SIZE` bytes */
+	size_t bufLen; /**< bytes in `buf` */
+	ULONGLONG lastFlush; /**< tick count of the last write */
+	bool failed; /**< an error was already reported */
+	tVector * index; /**< item index (`tSessionLogIndex`) of the current file */
+	uint8_t * seen; /**< bit set of items in `index` */
+	size_t seenSize; /**< number of bytes in `seen` */
+} tSessionLog;
+
+
+/**
+ * Replay trace recorder context. Only used by the process window thread.
+ */
+typedef struct {
+	HANDLE hFile; /**< trace file */
+	int64_t start; /**< `reportTicks()` at creation */
+	uint64_t last; /**< time of the last recorded event in microseconds */
+	uint8_t * buf; /**< write buffer with `RECORD_BUFFER_SIZE` bytes */
+	size_t bufLen; /**< bytes in `buf` */
+	DWORD error; /**< first write error code or 0 */
+	bool failed; /**< an error was already reported */
+} tRecorder;
+
+
+/**
+ * Output and input pipes of a signing application.
+ */
+typedef struct {
+	HANDLE hOutRead; /**< overlapped pipe end to read the process output */
+	HANDLE hOutWrite; /**< process end of the output pipe */
+	HANDLE hInRead; /**< process end of the input pipe */
+	HANDLE hInWrite; /**< pipe end to write the process input */
+} tPipeSet;
+
+
+/**
+ * Pool of pre-created signing application pipe sets. Only used by the process
+ * window thread.
+ */
+typedef struct {
+	tPipeSet set[PIPE_POOL_SIZE]; /**< ready pipe sets */
+	size_t count; /**< number of ready pipe sets in `set` */
+	HANDLE hEvent; /**< manual-reset event for the pipe connection */
+	wchar_t prefix[80]; /**< pipe name prefix */
+	unsigned long serial; /**< last used pipe name suffix */
+} tPipePool;
+
+
+/**
+ * Signing process slot of a single signing step. Every step of a configuration
+ * chain runs in its own lane to keep the tokens of all steps busy.
+ */
+typedef struct {
+	size_t step; /**< signing step handled by this lane and its index in `tIpcWndCtx::lanes` */
+	tProcCtx * proc; /**< points into `vec_at(v, vi)` or `NULL` */
+	size_t vi; /**< current item index in `v` */
+	size_t next; /**< first item index which may wait for this lane */
+	HANDLE hProc; /**< current signing process handle or `NULL` */
+	HANDLE hProcRead; /**< pipe handle to read the signing process output */
+	OVERLAPPED ovProcRead; /**< overlapped structure to read from the signing process */
+	uint8_t procBuf[MAX_CONFIG_STR_LEN]; /**< read buffer for signing process output */
+	tUtf8Ctx utf8; /**< parsing context for UTF-8 data from signing process */
+	size_t outputLen; /**< current length in `proc->output` in number of Unicode code points */
+	uint32_t lastChar; /**< most recent Unicode code point added to `proc->output` */
+	uint32_t matchState; /**< output rule matching state of `proc` */
+	uint32_t searchState; /**< output search indexing state of `proc` */
+} tProcLane;
+
+
+/**
+ * Loopback HTTP connection states.
+ */
+typedef enum {
+	HCS_READ, /**< receiving the next request */
+	HCS_WAIT, /**< waiting for item changes (long-poll) */
+	HCS_WRITE, /**< sending the response */
+	HCS_CLOSED /**< closed; freed once the pending operation completed */
+} tHttpConnState;
+
+
+struct tHttpServer;
+
+
+/**
+ * Single loopback HTTP connection. Only used by the process window thread.
+ */
+typedef struct {
+	WSAOVERLAPPED ov; /**< asynchronous receive/send structure */
+	struct tHttpServer * server; /**< owning server */
+	SOCKET sock; /**< client socket */
+	tHttpConnState state; /**< current connection state */
+	bool busy; /**< an asynchronous operation is pending on `ov` */
+	bool keepAlive; /**< keep the connection open after the response? */
+	char * in; /**< receive buffer with `HTTP_MAX_REQUEST` bytes */
+	size_t inLen; /**< bytes in `in` */
+	size_t reqLen; /**< bytes of the request in `in` which is currently handled */
+	char * out; /**< response or `NULL` */
+	size_t outLen; /**< bytes in `out` */
+	size_t outPos; /**< bytes of `out` already sent */
+	size_t waitFrom; /**< first item index of the pending status request */
+	uint64_t waitSeq; /**< change sequence number of the pending status request */
+	ULONGLONG deadline; /**< tick count at which the long-poll or idle connection expires */
+	char reqMac[(2 * SHA256_SIZE) + 1]; /**< hex MAC of the request being answered if signed, else empty */
+} tHttpConn;
+
+
+/**
+ * Loopback HTTP front end of the process window. Only used by the process
+ * window thread.
+ */
+typedef struct tHttpServer {
+	SOCKET sock; /**< listening socket or `INVALID_SOCKET` */
+	WSAEVENT hAccept; /**< signaled on new connections or `NULL` */
+	bool started; /**< `WSAStartup()` succeeded */
+	tVector * conns; /**< open connections (`tHttpConn *`) */
+	size_t closing; /**< closed connections with a pending asynchronous operation */
+	uint64_t seq; /**< item change sequence number */
+	wchar_t session[AGENT_SESSION_LEN + 1]; /**< identifier of this process to let agent clients detect restarts */
+	wchar_t * configUrl; /**< INI file with the selectable configuration sections */
+	uint8_t * key; /**< shared agent key or `NULL` for the loopback only front end */
+	size_t keyLen; /**< length of `key` in bytes */
+	char * nonces; /**< ring of `AGENT_AUTH_NONCES` recently seen request nonces or `NULL` */
+	size_t nonceNext; /**< next ring entry to replace in `nonces` */
+	uint64_t nonceFloor; /**< requests not newer than this time in milliseconds since 1970 are rejected */
+	wchar_t * spoolDir; /**< directory of uploaded files with trailing backslash or `NULL` */
+	unsigned short port; /**< listening TCP port */
+	TOKEN_USER * user; /**< user of this process which needs to own loopback clients without `key` or `NULL` */
+} tHttpServer;
+
+
+/**
+ * Pool of file hashing threads. Digests are looked up in the persistent digest
+ * cache by the process window thread first. Only misses are queued.
+ */
+typedef struct {
+	bool started; /**< `threads` and `hDone` were created */
+	HANDLE hDone; /**< auto-reset event signaled for finished jobs or `NULL` */
+	tWorkPool * threads; /**< hashing threads or `NULL` */
+	tDigestCache * cache; /**< digest cache or `NULL` (process window thread only) */
+	bool cacheOpened; /**< opening `cache` was attempted (process window thread only) */
+} tHashPool;
+
+
+/**
+ * Single file signed by a remote agent. Only the agent thread owning the job
+ * modifies it until it is moved to the list of finished jobs.
+ */
+typedef struct tRemoteJob {
+	struct tRemoteJob * next; /**< next job in the same list */
+	size_t item; /**< item index within the process list */
+	wchar_t * path; /**< local file path */
+	size_t attempts; /**< number of agents the job was passed to */
+	size_t remoteId; /**< item identifier at the agent */
+	char * remotePath; /**< raw JSON `path` token of the item at the agent or `NULL` if not accepted */
+	char * remoteName; /**< uploaded file name at the agent or `NULL` */
+	int64_t submitted; /**< `reportTicks()` value once submitted to the agent or 0 */
+	tProcState state; /**< final processing state */
+	bool hasExitCode; /**< `exitCode` is valid */
+	DWORD exitCode; /**< exit code of the signing application at the agent */
+	char * output; /**< UTF-8 output of the signing application or `NULL` */
+	size_t outputLen; /**< length of `output` in bytes */
+	const wchar_t * error; /**< reason why the job failed locally or `NULL` */
+	size_t agent; /**< index of the last agent the job was passed to */
+} tRemoteJob;
+
+
+struct tRemotePool;
+
+
+/**
+ * Remote siguwi instance signing files on behalf of the process window.
+ */
+typedef struct {
+	struct tRemotePool * pool; /**< owning pool */
+	wchar_t * name; /**< agent address as given (`host:port`) */
+	char * hostHdr; /**< UTF-8 encoded `name` for the `Host` header */
+	wchar_t * host; /**< host name or address */
+	unsigned short port; /**< TCP port */
+	bool upload; /**< upload the files instead of passing their paths? */
+	HANDLE hThread; /**< agent thread or `NULL` */
+	SOCKET sock; /**< current connection or `INVALID_SOCKET` (guarded by `pool->lock`) */
+	bool healthy; /**< agent is reachable (guarded by `pool->lock`) */
+	const wchar_t * reason; /**< reason why the agent is unreachable (guarded by `pool->lock`) */
+	bool noted; /**< `healthy` value last reported to the user (process window thread only) */
+} tRemoteAgent;
+
+
+/**
+ * Pool of remote agents. Each agent is served by its own thread which takes
+ * the queued jobs as long as the agent has capacity left.
+ */
+typedef struct tRemotePool {
+	bool started; /**< `lock`, `wake` and `hDone` are initialized */
+	bool wsaStarted; /**< `WSAStartup()` succeeded */
+	CRITICAL_SECTION lock; /**< guards `queue`, `queueTail`, `done`, `stop` and the agent states */
+	CONDITION_VARIABLE wake; /**< signaled for new jobs and on shutdown */
+	HANDLE hDone; /**< auto-reset event signaled for finished jobs and agent state changes or `NULL` */
+	tRemoteAgent * agents; /**< remote agents */
+	size_t count; /**< number of remote agents */
+	tRemoteJob * queue; /**< first queued job or `NULL` */
+	tRemoteJob * queueTail; /**< last queued job or `NULL` */
+	tRemoteJob * done; /**< finished jobs or `NULL` */
+	bool stop; /**< set to finish the agent threads */
+	uint8_t * key; /**< shared agent key */
+	size_t keyLen; /**< length of `key` in bytes */
+	volatile LONG64 nonce; /**< unique part of the last request nonce */
+	ULONGLONG downSince; /**< `GetTickCount64()` value since no agent is reachable or 0 (guarded by `lock`) */
+	size_t next; /**< first item index not passed to the pool yet (process window thread only) */
+} tRemotePool;
+
+
 /**
  * Process window IPC context and associated handles.
  */
@@ -333,30 +1122,48 @@ typedef struct {
 	size_t bufLen; /**< bytes in `buf` */
 	tIniConfig cfg; /**< used for reading IPC data from the remote application */
 	tRcIniConfigBase * cfgBase; /**< created from `cfg` to assign it to the process items */
+	wchar_t * cfgUrl; /**< INI file of the remote application to resolve the signing chain of `cfgBase` */
 	tIpcState state; /**< current IPC reading state */
 	/* processing context */
 	tVector * v; /**< item (`tProcCtx`) list */
 	tHTableO * h; /**< config (`tRcIniConfigBase`) to pin (`DATA_BLOB`) map */
-	tProcCtx * proc; /**< points into `vec_at(v, vi)` */
-	size_t vi; /**< current item index in `v` */
-	HANDLE hProc; /**< current signing process handle or `NULL` */
-	HANDLE hProcRead; /**< pipe handle to read the signing process output */
-	OVERLAPPED ovProcRead; /**< overlapped structure to read from the signing process */
-	uint8_t procBuf[MAX_CONFIG_STR_LEN]; /**< read buffer for signing process output */
-	tUtf8Ctx utf8; /**< parsing context for UTF-8 data from signing process */
-	size_t outputLen; /**< current length in `proc->output` in number of Unicode code points */
-	uint32_t lastChar; /**< most recent Unicode code point added to `proc->output` */
+	tHTableO * outputs; /**< deduplicated output store (`tOutputBlob` to `tOutputBlob *` map) */
+	tProcLane lanes[MAX_CHAIN_STEPS]; /**< signing process slot per signing step */
+	tPipePool pipes; /**< pre-created pipes for the next signing processes */
+	tTrigramIdx * search; /**< output search index with the item indices as document identifiers or `NULL` */
+	size_t stateCount[PST_COUNT]; /**< number of items per processing state */
 	/* window context */
 	HFONT hFont;
 	HWND hWnd;
 	HWND hList;
+	HWND hSearch; /**< output search query edit control */
 	HWND hSep;
 	HWND hInfo;
+	HWND hStatus; /**< status bar with the processing summary, live statistics and most recent notification */
 	float sepPos;
 	bool sepActive;
 	int selList;
+	bool showLineTimes; /**< prefix the output lines with their start time in the output widget? */
+	wchar_t * searchQuery; /**< output search query filtering the item list or `NULL` */
+	size_t searchHits; /**< number of items matching `searchQuery` */
 	tRcIniConfigBase * cmdlCfg; /**< parsed INI file content passed on command-line */
 	tRcWStr * cmdlSignApp; /**< signing application command-line from command-line INI file */
+	tVector * notes; /**< last `PROCESS_MAX_NOTES` non-modal notifications (`wchar_t *`) shown if no item is selected */
+	size_t noteCount; /**< number of notifications so far */
+	wchar_t lastNote[256]; /**< most recent notification shown in the status bar */
+	wchar_t * reportPath; /**< run report written at batch end or `NULL` */
+	bool reportDirty; /**< items finished since the last report was written? */
+	tHistogram histDuration; /**< live histogram of the processing durations in microseconds */
+	tHistogram histQueueWait; /**< live histogram of the queue wait times in microseconds */
+	tHistogram histFirstOutput; /**< live histogram of the times to first output in microseconds */
+	tRate rate; /**< moving rate of finished items */
+	tSessionLog * log; /**< session log or `NULL` */
+	tRecorder * rec; /**< replay trace recorder or `NULL` */
+	tHttpServer http; /**< loopback HTTP front end */
+	tVector * trees; /**< scanned directory trees with pending items (`tTreeScan *`) or `NULL` */
+	tArchivePool archive; /**< archive extraction and rewrite thread */
+	tHashPool hash; /**< file hashing pool */
+	tRemotePool remote; /**< remote agents signing all items if any */
 } tIpcWndCtx;
 
 
@@ -385,7 +1192,6 @@ extern wchar_t * exeDir;
 extern tErrCode lastErr;
 extern const wchar_t * const errStr[];
 extern wchar_t * const procStateStr[];
-extern const uint32_t crc32Table[];
 
 
 /* string handling (`siguwi-main.c`) */
@@ -396,6 +1202,8 @@ wchar_t * wFileName(wchar_t * path);
 void wToBackslash(wchar_t * path);
 bool wToFullPath(wchar_t ** path, const bool freeOld);
 bool wFileExists(const wchar_t * path);
+bool wDirExists(const wchar_t * path);
+bool wLocalDataPath(const wchar_t * name, wchar_t * buf, const size_t len);
 void wStrDelete(wchar_t ** str);
 #if !defined(_WSTRING_S_DEFINED) && !defined(_MSC_VER)
 errno_t __cdecl wcscat_s(wchar_t * dst, size_t dstSize, const wchar_t * src);
@@ -407,10 +1215,6 @@ errno_t __cdecl wcscpy_s(wchar_t * dst, size_t dstSize, const wchar_t * src);
 wchar_t * siguwi_wcsdup(const wchar_t * str);
 #endif /* not NDEBUG */
 
-/* general utility functions (`siguwi-main.c`) */
-uint32_t crc32Update(uint32_t seed, const void * data, const size_t len);
-int cmpToken(const tToken * const token, const wchar_t * str);
-
 /* GUI utility functions (`siguwi-main.c`) */
 int getDpi(void);
 int calcPixels(const int px);
@@ -439,7 +1243,8 @@ bool iniConfigParse(const wchar_t * file, const wchar_t * section, tIniConfig *
 bool iniConfigGetCardStatus(const tIniConfigBase * c, DWORD * cardStatus);
 bool iniConfigValidatePin(const wchar_t * certProv, const wchar_t * certId, const wchar_t * pin, DWORD len);
 bool iniConfigGetPin(const tIniConfigBase * c, HWND parent, DATA_BLOB * pin);
-tRcIniConfigBase * rcIniConfigBaseCreate(const tIniConfigBase * c);
+bool iniConfigChain(const wchar_t * file, tRcIniConfigBase * c, const wchar_t * chain);
+tRcIniConfigBase * rcIniConfigBaseCreate(const tIniConfigBase * c, const wchar_t * match);
 tRcIniConfigBase * rcIniConfigBaseClone(tRcIniConfigBase * c);
 int rcIniConfigBaseCmp(const tRcIniConfigBase * lhs, const tRcIniConfigBase * rhs);
 size_t rcIniConfigBaseHash(const tRcIniConfigBase * key, const size_t limit);
@@ -449,37 +1254,164 @@ void rcIniConfigBaseDelete(tRcIniConfigBase * c);
 bool regRunningAsAdmin();
 bool regIsValidVerb(const wchar_t * str);
 void regCloseKeyPtr(HKEY * hKey);
-bool regRegister(const wchar_t * configUrl, const wchar_t * configGroup, const wchar_t * ext, const wchar_t * verb, const wchar_t * text, const bool useHklm);
+bool regRegisterDropTarget(const wchar_t * configUrl, const wchar_t * configGroup, const wchar_t * verb, const wchar_t * clsid, const bool useHklm);
+bool regRegister(const wchar_t * configUrl, const wchar_t * configGroup, const wchar_t * ext, const wchar_t * verb, const wchar_t * text, const wchar_t * clsid, const bool useHklm);
 bool regUnregister(const wchar_t * ext, const wchar_t * verb, const bool useHklm);
+bool regIsSignable(const wchar_t * path);
+bool regIsArchive(const wchar_t * path);
 
 /* process window utility functions (`siguwi-process.c`) */
 int pinBlobDelete(const tRcIniConfigBase * key, DATA_BLOB * data, void * param);
 int procCtxDelete(const size_t index, tProcCtx * data, void * param);
-bool ipcSendReqToServer(HANDLE hPipe, const tIniConfig * c, int argc, wchar_t ** argv);
+bool ipcSendReqToServer(HANDLE hPipe, const tIniConfig * c, const wchar_t * configUrl, int argc, wchar_t ** argv);
 bool ipcListen(tIpcWndCtx * ctx);
+void ipcRestart(tIpcWndCtx * ctx);
 bool ipcIsValidProcess(HANDLE hPipe);
 bool ipcReadAsync(tIpcWndCtx * ctx);
 void CALLBACK ipcHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytesTransfered, LPOVERLAPPED lpOverlapped);
-bool processStart(tIpcWndCtx * ctx);
+bool processStart(tIpcWndCtx * ctx, tProcLane * lane);
 bool processNext(tIpcWndCtx * ctx);
-bool processReadAsync(tIpcWndCtx * ctx);
+bool processReadAsync(tProcLane * lane);
 void CALLBACK processHandleReadComplete(DWORD dwErrorCode, DWORD dwNumberOfBytesTransfered, LPOVERLAPPED lpOverlapped);
-bool processFinish(tIpcWndCtx * ctx);
-bool processAddFile(tIpcWndCtx * ctx, tRcIniConfigBase * c, tRcWStr * signApp, const wchar_t * path);
+bool processFinish(tIpcWndCtx * ctx, tProcLane * lane);
+bool processAddFile(tIpcWndCtx * ctx, tRcIniConfigBase * c, tRcWStr * signApp, const wchar_t * path, tArchive * archive, tTreeScan * tree);
 bool processAddItem(const tIpcWndCtx * ctx, const tProcCtx * item);
+int processItemRow(const tIpcWndCtx * ctx, const size_t i);
+void processFilterList(tIpcWndCtx * ctx, const uint8_t * hits);
+void processSetState(tIpcWndCtx * ctx, tProcCtx * item, const tProcState state);
 void processDragFile(tIpcWndCtx * ctx, HDROP hDrop, UINT i, wchar_t * buf, size_t len);
 bool processUpdateItem(const tIpcWndCtx * ctx, const size_t i);
+void processUpdateStatus(const tIpcWndCtx * ctx);
+void processUpdateNotes(const tIpcWndCtx * ctx);
+void processNotify(tIpcWndCtx * ctx, tProcCtx * item, const wchar_t * title, const wchar_t * fmt, ...);
+void processSaveReport(tIpcWndCtx * ctx);
 void processWndResize(const tIpcWndCtx * ctx);
 LRESULT CALLBACK processSepWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 LRESULT CALLBACK processWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+/* run report utility functions (`siguwi-report.c`) */
+int64_t reportTicks(void);
+double reportTicksToMs(const int64_t ticks);
+void reportStamp(tProcCtx * item, const tProcStage stage);
+void reportLiveAdd(tIpcWndCtx * ctx, const tProcCtx * item);
+void reportLiveFormat(const tIpcWndCtx * ctx, wchar_t * buf, const size_t size);
+bool reportWrite(const tIpcWndCtx * ctx, const wchar_t * path);
+void reportAddJsonStr(tUStrBuf * sb, const wchar_t * str);
+
+/* session log utility functions (`siguwi-log.c`) */
+tSessionLog * sessionLogCreate(const wchar_t * dir);
+void sessionLogItem(tSessionLog * log, const size_t item, const wchar_t * path);
+void sessionLogOutput(tSessionLog * log, const size_t item, const void * data, const size_t len);
+void sessionLogState(tSessionLog * log, const size_t item, const tProcCtx * proc);
+DWORD sessionLogGetError(tSessionLog * log);
+void sessionLogDelete(tSessionLog * log);
+
+/* replay trace recorder utility functions (`siguwi-record.c`) */
+tRecorder * recordCreate(const wchar_t * path);
+void recordEvent(tRecorder * rec, const tReplayType type, const size_t item, const uint32_t value, const uint32_t value2);
+DWORD recordGetError(tRecorder * rec);
+void recordDelete(tRecorder * rec);
+
+/* compressed and deduplicated output storage utility functions (`siguwi-store.c`) */
+tOutputBlob * outputBlobCreate(const wchar_t * str, const size_t len);
+tOutputBlob * outputBlobClone(tOutputBlob * blob);
+int outputBlobCmp(const tOutputBlob * lhs, const tOutputBlob * rhs);
+size_t outputBlobHash(const tOutputBlob * key, const size_t limit);
+void outputBlobDelete(tOutputBlob * blob);
+bool outputStore(tHTableO * h, tProcCtx * item);
+void outputRelease(tHTableO * h, tProcCtx * item);
+wchar_t * outputGet(const tProcCtx * item);
+wchar_t * outputAddLineTimes(const tProcCtx * item, const wchar_t * str);
+bool outputRestore(tHTableO * h, tProcCtx * item);
+
+/* signing application pipe utility functions (`siguwi-pipe.c`) */
+bool pipePoolInit(tPipePool * pool);
+bool pipePoolFill(tPipePool * pool);
+bool pipePoolTake(tPipePool * pool, tPipeSet * set);
+void pipeSetClose(tPipeSet * set);
+void pipePoolDelete(tPipePool * pool);
+
+/* shell integration utility functions (`siguwi-shell.c`) */
+bool shellFilesAdd(tVector * files, const wchar_t * path);
+bool shellDropTarget(const wchar_t * clsid, tVector * files);
+bool shellCoalesce(const wchar_t * configUrl, const wchar_t * configGroup, tVector * files);
+void shellFilesDelete(tVector * files);
+
+/* archive entry signing utility functions (`siguwi-archive.c`) */
+bool archiveAddFile(tIpcWndCtx * ctx, tRcIniConfigBase * c, tRcWStr * signApp, const wchar_t * path);
+void archiveItemDone(tIpcWndCtx * ctx, tProcCtx * item);
+tArchive * archiveAquire(tArchive * archive);
+void archiveRelease(tArchive * archive);
+void archiveComplete(tIpcWndCtx * ctx);
+void archiveDelete(tIpcWndCtx * ctx);
+
+/* incremental directory tree scan utility functions (`siguwi-scan.c`) */
+bool scanAddTree(tIpcWndCtx * ctx, tRcIniConfigBase * c, tRcWStr * signApp, const wchar_t * path);
+void scanItemDone(tIpcWndCtx * ctx, tProcCtx * item);
+void scanHashed(tIpcWndCtx * ctx, tHashJob * job);
+tTreeScan * scanAquire(tTreeScan * tree);
+void scanRelease(tTreeScan * tree);
+void scanDelete(tIpcWndCtx * ctx);
+
+/* parallel file hashing utility functions (`siguwi-hash.c`) */
+bool hashIdentity(const wchar_t * path, tDigestKey * key);
+bool hashRequest(tIpcWndCtx * ctx, const wchar_t * path, const tDigestKey * key, tTreeScan * tree, const uint64_t entry, tRcIniConfigBase * c, tRcWStr * signApp);
+void hashComplete(tIpcWndCtx * ctx);
+void hashDelete(tIpcWndCtx * ctx);
+
+/* loopback HTTP front end utility functions (`siguwi-http.c`) */
+bool httpCreate(tHttpServer * server, const unsigned short port, const wchar_t * configUrl, const uint8_t * key, const size_t keyLen);
+void httpAccept(tIpcWndCtx * ctx);
+void httpNotify(tIpcWndCtx * ctx);
+DWORD httpTimeout(const tHttpServer * server);
+void httpExpire(tIpcWndCtx * ctx);
+void httpDelete(tHttpServer * server);
+bool httpKeyLoad(const wchar_t * path, uint8_t ** key, size_t * len);
+uint64_t httpAuthTime(void);
+void httpAuthMac(const uint8_t * key, const size_t keyLen, const char * const * parts, const size_t * lens, const size_t count, char * hex);
+bool httpAuthEqual(const char * lhs, const char * rhs, const size_t len);
+
+/* remote agent utility functions (`siguwi-remote.c`) */
+bool remoteParseSpec(const wchar_t * spec, wchar_t ** host, unsigned short * port, bool * upload);
+bool remoteCreate(tRemotePool * pool, tVector * agents, const uint8_t * key, const size_t keyLen);
+bool remoteDispatch(tIpcWndCtx * ctx);
+void remoteComplete(tIpcWndCtx * ctx);
+void remoteDelete(tIpcWndCtx * ctx);
+
+/* output classification rule utility functions (`siguwi-match.c`) */
+bool matchRuleAdd(wchar_t ** rules, const wchar_t * rule);
+tMatchRules * matchRulesCreate(const wchar_t * rules);
+void matchRulesDelete(tMatchRules * rules);
+void matchOutput(tProcCtx * item, uint32_t * state, const uint8_t * data, const size_t len);
+tProcState matchApply(tProcCtx * item, const tProcState state);
+
+/* session-wide output search utility functions (`siguwi-search.c`) */
+void searchOutput(tIpcWndCtx * ctx, const size_t i, uint32_t * state, const uint8_t * data, const size_t len);
+void searchAppended(tIpcWndCtx * ctx, const size_t i, const size_t from);
+void searchApply(tIpcWndCtx * ctx);
+void searchRefresh(tIpcWndCtx * ctx);
+void searchReveal(const tIpcWndCtx * ctx);
+void searchDelete(tIpcWndCtx * ctx);
+
+/* signing engine utility functions (`siguwi-engine.c`) */
+tProcState engineSpawn(tPipePool * pipes, tHTableO * pins, tProcCtx * proc, HWND parent, const wchar_t * workDir, HANDLE * hProc, HANDLE * hRead);
+bool engineDecodeOutput(tUtf8Ctx * utf8, tUStrBuf * output, size_t * outputLen, uint32_t * lastChr, const uint8_t * data, const size_t len);
+void engineStampLines(tProcCtx * proc, const size_t outputLen, const uint32_t lastChr, const uint8_t * data, const size_t len);
+void engineStampAppended(tProcCtx * proc, const size_t from);
+bool engineReap(HANDLE hProc, tProcCtx * proc);
+tProcState engineLaneStart(tPipePool * pipes, tHTableO * pins, tProcLane * lane, HWND parent, const wchar_t * workDir);
+bool engineLaneRead(tProcLane * lane, LPOVERLAPPED_COMPLETION_ROUTINE onRead);
+bool engineLaneOutput(tProcLane * lane, const size_t len);
+tProcState engineLaneFinish(tProcLane * lane);
+bool engineLaneAdvance(tProcLane * lane);
+
 /* command-line option handlers (`siguwi-main.c`) */
 void showHelp(void);
 void showVersion(void);
 /* `siguwi-config.c` */
 int showConfigs(int cmdshow);
 /* `siguwi-process.c` */
-int showProcess(const tIniConfig * c, int cmdshow, int argc, wchar_t ** argv);
+int showProcess(const tIniConfig * c, const wchar_t * configUrl, const wchar_t * report, const wchar_t * logDir, const wchar_t * record, const unsigned short httpPort, const uint8_t * key, const size_t keyLen, tVector * agents, int cmdshow, int argc, wchar_t ** argv);
 /* `siguwi-registry.c` */
 int modRegistry(const bool reg, const wchar_t * configUrl, const wchar_t * configGroup, wchar_t * regEntry);
 /* `siguwi-translate.c` */
@@ -0,0 +1,317 @@
+/**
+ * @file startbench.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Start latency benchmark. Acts as siguwi IPC server and measures the time
+ * from starting a siguwi client process until it wrote its request to the
+ * named pipe. This covers the loader, the configuration parsing and the IPC
+ * client path which run on each shell context menu invocation.
+ */
+#include "siguwi.h"
+#include "benchutil.h"
+
+
+/**
+ * Configuration group written to `startbench.ini`.
+ */
+#define STARTBENCH_GROUP L"startbench"
+
+
+/**
+ * Benchmark configuration.
+ */
+typedef struct {
+	size_t count; /**< number of measured client starts */
+	size_t warmup; /**< number of unmeasured client starts before */
+	DWORD timeout; /**< timeout per client start in milliseconds */
+	const wchar_t * exe; /**< siguwi executable path or `NULL` */
+} tStartBenchConfig;
+
+
+/**
+ * Waits for the given overlapped operation to complete.
+ *
+ * @param[in] hPipe - pipe handle
+ * @param[in,out] ov - overlapped structure of the pending operation
+ * @param[in] timeout - timeout in milliseconds
+ * @param[out] n - receives the number of transferred bytes
+ * @return `true` on success, else `false`
+ */
+static bool startBenchWait(HANDLE hPipe, OVERLAPPED * ov, const DWORD timeout, DWORD * n) {
+	if (WaitForSingleObject(ov->hEvent, timeout) != WAIT_OBJECT_0) {
+		CancelIo(hPipe);
+		GetOverlappedResult(hPipe, ov, n, TRUE);
+		return false;
+	}
+	return GetOverlappedResult(hPipe, ov, n, FALSE) != FALSE;
+}
+
+
+/**
+ * Outputs the usage help.
+ */
+static void startBenchHelp(void) {
+	printf(
+		"startbench [options]\n"
+		"\n"
+		"Start latency benchmark for siguwi IPC clients. Acts as siguwi IPC server and\n"
+		"measures the time from starting a client until it wrote its request. No other\n"
+		"siguwi instance may run.\n"
+		"\n"
+		"-h, --help\n"
+		"      Print this usage text.\n"
+		"-n, --count <n>\n"
+		"      Number of measured client starts. Default: 50\n"
+		"-t, --timeout <ms>\n"
+		"      Timeout per client start in milliseconds. Default: 10000\n"
+		"-w, --warmup <n>\n"
+		"      Number of unmeasured client starts before. Default: 3\n"
+		"-x, --exe <file>\n"
+		"      siguwi executable. Default: siguwi.exe next to this executable\n"
+	);
+}
+
+
+/**
+ * Parses the given unsigned number.
+ *
+ * @param[in] str - string to parse
+ * @param[out] value - receives the parsed value
+ * @return `true` on success, else `false`
+ */
+static bool startBenchParseSize(const wchar_t * str, size_t * value) {
+	wchar_t * end = NULL;
+	const unsigned long long res = wcstoull(str, &end, 10);
+	if (end == str || *end != 0 || *str == L'-') {
+		return false;
+	}
+	*value = (size_t)res;
+	return true;
+}
+
+
+/**
+ * Main entry point.
+ *
+ * @param[in] argc - number of command-line arguments
+ * @param[in] argv - command-line arguments
+ * @return exit code
+ */
+int wmain(int argc, wchar_t ** argv) {
+	static const struct option longOptions[] = {
+		{L"help",    no_argument,       NULL, L'h'},
+		{L"count",   required_argument, NULL, L'n'},
+		{L"timeout", required_argument, NULL, L't'},
+		{L"warmup",  required_argument, NULL, L'w'},
+		{L"exe",     required_argument, NULL, L'x'},
+		{NULL, 0, NULL, 0}
+	};
+	tStartBenchConfig cfg = {50, 3, 10000, NULL};
+	size_t value;
+	_wputenv(L"POSIXLY_CORRECT=");
+	while (1) {
+		const int res = getopt_long(argc, argv, L":hn:t:w:x:", longOptions, NULL);
+		if (res == -1) break;
+		switch (res) {
+		case L'h':
+			startBenchHelp();
+			return EXIT_SUCCESS;
+		case L'n':
+		case L't':
+		case L'w':
+			if ( ! startBenchParseSize(optarg, &value) ) {
+				fprintf(stderr, "Error: Invalid value \"%ls\" for option -%lc.\n", optarg, (wint_t)res);
+				return EXIT_FAILURE;
+			}
+			switch (res) {
+			case L'n': cfg.count = value; break;
+			case L't': cfg.timeout = (DWORD)value; break;
+			case L'w': cfg.warmup = value; break;
+			default: break;
+			}
+			break;
+		case L'x':
+			cfg.exe = optarg;
+			break;
+		case L':':
+			fprintf(stderr, "Error: Missing argument for option \"%ls\".\n", argv[optind - 1]);
+			return EXIT_FAILURE;
+		default:
+			fprintf(stderr, "Error: Invalid option \"%ls\".\n", argv[optind - 1]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (cfg.count == 0 || cfg.timeout == 0) {
+		fprintf(stderr, "Error: Invalid number of client starts or timeout.\n");
+		return EXIT_FAILURE;
+	}
+
+	int res = EXIT_FAILURE;
+	HANDLE hPipe = INVALID_HANDLE_VALUE;
+	OVERLAPPED ov;
+	double * values[4] = {NULL, NULL, NULL, NULL};
+	static const char * names[4] = {"connectMs", "firstWriteMs", "requestMs", "exitMs"};
+	size_t measured = 0;
+	size_t failed = 0;
+	wchar_t selfPath[MAX_PATH];
+	wchar_t sigPath[MAX_PATH];
+	wchar_t binDir[MAX_PATH];
+	wchar_t iniPath[MAX_PATH];
+	wchar_t cmd[4 * MAX_PATH];
+	ZeroMemory(&ov, sizeof(ov));
+	iniPath[0] = 0;
+
+	/* resolve paths (the configuration needs to be next to the siguwi executable) */
+	const DWORD selfPathLen = GetModuleFileNameW(NULL, selfPath, ARRAY_SIZE(selfPath));
+	if (selfPathLen == 0 || selfPathLen >= ARRAY_SIZE(selfPath)) {
+		fprintf(stderr, "Error: Failed to get the executable path.\n");
+		return EXIT_FAILURE;
+	}
+	if (cfg.exe != NULL) {
+		if (GetFullPathNameW(cfg.exe, ARRAY_SIZE(sigPath), sigPath, NULL) == 0) {
+			fprintf(stderr, "Error: Invalid siguwi executable path \"%ls\".\n", cfg.exe);
+			return EXIT_FAILURE;
+		}
+	} else {
+		snwprintf(binDir, ARRAY_SIZE(binDir), L"%ls", selfPath);
+		PathRemoveFileSpecW(binDir);
+		snwprintf(sigPath, ARRAY_SIZE(sigPath), L"%ls\\siguwi.exe", binDir);
+	}
+	snwprintf(binDir, ARRAY_SIZE(binDir), L"%ls", sigPath);
+	PathRemoveFileSpecW(binDir);
+	const DWORD attr = GetFileAttributesW(sigPath);
+	if (attr == INVALID_FILE_ATTRIBUTES || (attr & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+		fprintf(stderr, "Error: siguwi executable \"%ls\" not found.\n", sigPath);
+		return EXIT_FAILURE;
+	}
+	snwprintf(iniPath, ARRAY_SIZE(iniPath), L"%ls\\startbench.ini", binDir);
+
+	/* act as IPC server */
+	hPipe = CreateNamedPipeW(IPC_PIPE_PATH, PIPE_ACCESS_INBOUND | FILE_FLAG_FIRST_PIPE_INSTANCE | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, 0, MAX_CONFIG_STR_LEN, 0, NULL);
+	if (hPipe == INVALID_HANDLE_VALUE) {
+		fprintf(stderr, "Error: Another siguwi instance is already running.\n");
+		iniPath[0] = 0;
+		goto onError;
+	}
+	ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	for (size_t i = 0; i < ARRAY_SIZE(values); ++i) {
+		values[i] = calloc(cfg.count, sizeof(double));
+		if (values[i] == NULL) {
+			fprintf(stderr, "Error: Out of memory.\n");
+			goto onError;
+		}
+	}
+	if (ov.hEvent == NULL) {
+		fprintf(stderr, "Error: Failed to create event.\n");
+		goto onError;
+	}
+
+	/* write a configuration which is never used for signing */
+	FILE * fp = _wfopen(iniPath, L"wb");
+	if (fp == NULL) {
+		fprintf(stderr, "Error: Failed to write \"%ls\".\n", iniPath);
+		iniPath[0] = 0;
+		goto onError;
+	}
+	fputs(
+		"[startbench]\r\ncertId = startbench\r\ncardName = startbench\r\ncardReader = startbench\r\n"
+		"signApp = 'startbench.exe \"%1\"'\r\n",
+		fp
+	);
+	if (fclose(fp) != 0) {
+		fprintf(stderr, "Error: Failed to write \"%ls\".\n", iniPath);
+		goto onError;
+	}
+	snwprintf(cmd, ARRAY_SIZE(cmd), L"\"%ls\" -c \"%ls:" STARTBENCH_GROUP L"\" -- \"%ls\"", sigPath, iniPath, selfPath);
+
+	/* start clients one after another */
+	printf("Starting %zu + %zu clients of \"%ls\".\n", cfg.warmup, cfg.count, sigPath);
+	for (size_t run = 0; run < (cfg.warmup + cfg.count); ++run) {
+		uint8_t buf[MAX_CONFIG_STR_LEN];
+		double t[4] = {0.0, 0.0, 0.0, 0.0};
+		DWORD n = 0;
+		bool ok = false;
+		ResetEvent(ov.hEvent);
+		if (( ! ConnectNamedPipe(hPipe, &ov) ) && GetLastError() != ERROR_IO_PENDING) {
+			fprintf(stderr, "Error: Failed to listen on the named pipe (0x%08X).\n", (unsigned)GetLastError());
+			goto onError;
+		}
+		STARTUPINFOW si;
+		PROCESS_INFORMATION pi;
+		ZeroMemory(&si, sizeof(si));
+		si.cb          = sizeof(si);
+		si.dwFlags     = STARTF_USESHOWWINDOW;
+		si.wShowWindow = SW_HIDE;
+		const double start = bu_now();
+		if ( ! CreateProcessW(NULL, cmd, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi) ) {
+			fprintf(stderr, "Error: Failed to start \"%ls\" (0x%08X).\n", sigPath, (unsigned)GetLastError());
+			CancelIo(hPipe);
+			goto onError;
+		}
+		CloseHandle(pi.hThread);
+		if ( startBenchWait(hPipe, &ov, cfg.timeout, &n) ) {
+			t[0] = bu_now() - start;
+			/* first write of the request */
+			ResetEvent(ov.hEvent);
+			ok = ReadFile(hPipe, buf, sizeof(buf), NULL, &ov) || GetLastError() == ERROR_IO_PENDING;
+			ok = ok && startBenchWait(hPipe, &ov, cfg.timeout, &n) && n > 0;
+			t[1] = bu_now() - start;
+			/* remaining request until the client closes the pipe */
+			while ( ok ) {
+				ResetEvent(ov.hEvent);
+				if (( ! ReadFile(hPipe, buf, sizeof(buf), NULL, &ov) ) && GetLastError() != ERROR_IO_PENDING) {
+					break;
+				}
+				if ( ! startBenchWait(hPipe, &ov, cfg.timeout, &n) ) {
+					ok = (GetLastError() == ERROR_BROKEN_PIPE);
+					break;
+				}
+			}
+			t[2] = bu_now() - start;
+		}
+		if (WaitForSingleObject(pi.hProcess, cfg.timeout) != WAIT_OBJECT_0) {
+			/* blocked (e.g. by an error message box) */
+			TerminateProcess(pi.hProcess, EXIT_FAILURE);
+			ok = false;
+		}
+		t[3] = bu_now() - start;
+		DWORD exitCode = EXIT_FAILURE;
+		GetExitCodeProcess(pi.hProcess, &exitCode);
+		CloseHandle(pi.hProcess);
+		DisconnectNamedPipe(hPipe);
+		if (( ! ok ) || exitCode != EXIT_SUCCESS) {
+			++failed;
+		} else if (run >= cfg.warmup) {
+			for (size_t i = 0; i < ARRAY_SIZE(values); ++i) {
+				values[i][measured] = t[i];
+			}
+			++measured;
+		}
+	}
+
+	/* output results */
+	printf("\nClients:    %zu measured, %zu failed\n", measured, failed);
+	printf("\nLatency percentiles in ms after process start:\n  %-22s %8s %12s %12s %12s %12s %12s\n", "stage", "count", "p50", "p90", "p95", "p99", "max");
+	for (size_t i = 0; i < ARRAY_SIZE(values); ++i) {
+		bu_printDist(names[i], values[i], measured);
+	}
+	res = (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+onError:
+	if (ov.hEvent != NULL) {
+		CloseHandle(ov.hEvent);
+	}
+	if (hPipe != INVALID_HANDLE_VALUE) {
+		CloseHandle(hPipe);
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(values); ++i) {
+		if (values[i] != NULL) {
+			free(values[i]);
+		}
+	}
+	if (iniPath[0] != 0) {
+		DeleteFileW(iniPath);
+	}
+	return res;
+}
@@ -3,7 +3,7 @@
  * @author Daniel Starke
  * @see ustrbuf.h
  * @date 2017-05-25
- * @version 2025-07-18
+ * @version 2026-10-18
  * @internal This file is never used or compiled directly but only included.
  * @remarks Define STRBUF_UNICODE for the Unicode before including this file.
  * Defaults to ASCII.
@@ -11,7 +11,25 @@
 #ifdef STRBUF_UNICODE
 #include <wchar.h>
 #endif
+#include <limits.h>
+#include "target.h"
+#ifdef PCF_IS_WIN
 #include <windows.h>
+#else /* not PCF_IS_WIN */
+#ifndef STRBUF_SECURE_ZERO
+#define STRBUF_SECURE_ZERO
+/**
+ * Portable replacement for `SecureZeroMemory()`.
+ *
+ * @param[out] ptr - memory to clear
+ * @param[in] len - number of bytes to clear
+ */
+static void SecureZeroMemory(void * ptr, size_t len) {
+	volatile unsigned char * p = (volatile unsigned char *)ptr;
+	while (len-- > 0) *p++ = 0;
+}
+#endif /* STRBUF_SECURE_ZERO */
+#endif /* not PCF_IS_WIN */
 
 
 #ifdef STRBUF_UNICODE
@@ -179,6 +197,29 @@ int TCHAR_FUNC(addFmtVar)(TCHAR_BUF * sb, const CHAR_T * fmt, va_list ap) {
 	CHAR_T * mem;
 	int strLen, resLen;
 	if (sb == NULL || fmt == NULL) return 0;
+#if defined(STRBUF_UNICODE) && defined(PCF_IS_NO_WIN)
+	/* vswprintf() returns no length for a too small buffer -> grow until it fits
+	 * (limited as encoding errors are reported the same way) */
+	strLen = 256;
+	for (;;) {
+		va_list ap2;
+		mem = (CHAR_T *)malloc(sizeof(CHAR_T) * (size_t)strLen);
+		if (mem == NULL) return 0;
+		va_copy(ap2, ap);
+		resLen = TCHAR_STVSNPRINTF(mem, (size_t)strLen, fmt, ap2);
+		va_end(ap2);
+		if (resLen >= 0 && resLen < strLen) break;
+		free(mem);
+		if (strLen >= 0x1000000) return 0;
+		strLen *= 2;
+	}
+	if (resLen <= 0 || TCHAR_FUNC(add)(sb, mem) == 0) {
+		free(mem);
+		return 0;
+	}
+	free(mem);
+	return 1;
+#else /* not (STRBUF_UNICODE and PCF_IS_NO_WIN) */
 	{
 		va_list ap2;
 		va_copy(ap2, ap);
@@ -196,6 +237,7 @@ int TCHAR_FUNC(addFmtVar)(TCHAR_BUF * sb, const CHAR_T * fmt, va_list ap) {
 	}
 	free(mem);
 	return 1;
+#endif /* not (STRBUF_UNICODE and PCF_IS_NO_WIN) */
 }
 
 
@@ -0,0 +1,964 @@
+/**
+ * @file test.c
+ * @author Daniel Starke
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Native tests for the portable file format primitives. The fixtures are read
+ * from the given directory (see `test/`). Temporary files are created in the
+ * temporary directory.
+ */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include "dcache.h"
+#include "fdigest.h"
+#include "lqueue.h"
+#include "target.h"
+#include "zip.h"
+#ifdef PCF_IS_WIN
+#include <windows.h>
+#endif /* PCF_IS_WIN */
+
+
+/**
+ * Default fixture directory.
+ */
+#define TEST_DIR "src/test"
+
+
+/**
+ * Maximum fixture path length including null-terminator.
+ */
+#define TEST_MAX_PATH 1024
+
+
+/**
+ * File name of the digest cache used for the `dcache_*` tests within the
+ * temporary directory.
+ */
+#define TEST_DCACHE_FILE "siguwi-test.cache"
+
+
+/**
+ * Layout of the digest cache file as defined in `dcache.c`. The header and
+ * each hash index slot occupy 64 bytes.
+ */
+#define TEST_DCACHE_COUNT 16
+#define TEST_DCACHE_SLOT_START 64
+#define TEST_DCACHE_SLOT_SIZE 64
+#define TEST_DCACHE_SLOT_LEN 44
+#define TEST_DCACHE_SLOT_OFFSET 48
+
+
+/**
+ * Number of items and signing steps for the `lane_*` tests.
+ */
+#define TEST_LANE_ITEMS 8
+#define TEST_LANE_STEPS 2
+
+
+/**
+ * Fails the current test if the given condition does not hold.
+ *
+ * @param[in] x - condition
+ */
+#define TEST_CHECK(x) \
+	do { \
+		if ( ! (x) ) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #x); \
+			goto onError; \
+		} \
+	} while (0)
+
+
+/**
+ * Single test description.
+ */
+typedef struct {
+	const char * name; /**< test name */
+	bool (* run)(void); /**< returns `true` on success */
+} tTest;
+
+
+/**
+ * Fixture directory.
+ */
+static const char * testDir = TEST_DIR;
+
+
+/**
+ * Digest cache path of the `dcache_*` tests.
+ */
+static tDigestCacheChar testCachePath[TEST_MAX_PATH];
+
+
+/**
+ * Opens the given fixture file.
+ *
+ * @param[in] name - fixture file name
+ * @param[in] mode - `fopen()` mode
+ * @return opened file or `NULL` on error
+ */
+static FILE * testOpen(const char * name, const char * mode) {
+	char path[TEST_MAX_PATH];
+	snprintf(path, sizeof(path), "%s/%s", testDir, name);
+	FILE * fp = fopen(path, mode);
+	if (fp == NULL) {
+		fprintf(stderr, "Error: Failed to open \"%s\".\n", path);
+	}
+	return fp;
+}
+
+
+/**
+ * Reads the whole given stream from its beginning.
+ *
+ * @param[in,out] fp - stream
+ * @param[out] len - receives the number of bytes read
+ * @return allocated data or `NULL` on error
+ */
+static uint8_t * testReadAll(FILE * fp, size_t * len) {
+	if (fseek(fp, 0, SEEK_END) != 0) {
+		return NULL;
+	}
+	const long size = ftell(fp);
+	if (size < 0 || fseek(fp, 0, SEEK_SET) != 0) {
+		return NULL;
+	}
+	uint8_t * data = (uint8_t *)malloc((size_t)size + 1);
+	if (data == NULL || fread(data, 1, (size_t)size, fp) != (size_t)size) {
+		free(data);
+		return NULL;
+	}
+	*len = (size_t)size;
+	return data;
+}
+
+
+/**
+ * Generates the content of the given `zip-*.zip` fixture entry as done by
+ * `test/zip-gen.py`.
+ *
+ * @param[in] name - entry name
+ * @param[in] lines - number of lines
+ * @param[out] len - receives the content length in bytes
+ * @return allocated content or `NULL` on error
+ */
+static uint8_t * testZipContent(const char * name, const size_t lines, size_t * len) {
+	const size_t lineLen = strlen(name) + 15;
+	char * data = (char *)malloc((lines * lineLen) + 1);
+	if (data == NULL) {
+		return NULL;
+	}
+	size_t pos = 0;
+	for (size_t k = 0; k < lines; ++k) {
+		pos += (size_t)sprintf(data + pos, "line %05u of %s\n", (unsigned)k, name);
+	}
+	*len = pos;
+	return (uint8_t *)data;
+}
+
+
+/**
+ * Extracts the given archive entry into memory.
+ *
+ * @param[in,out] z - archive
+ * @param[in] i - entry index
+ * @param[out] len - receives the entry length in bytes
+ * @return allocated entry data or `NULL` on error
+ */
+static uint8_t * testZipExtract(tZip * z, const size_t i, size_t * len) {
+	FILE * fp = tmpfile();
+	if (fp == NULL) {
+		return NULL;
+	}
+	uint8_t * data = zip_extract(z, i, fp) ? testReadAll(fp, len) : NULL;
+	fclose(fp);
+	return data;
+}
+
+
+/**
+ * Checks whether the given archive entry holds the passed content.
+ *
+ * @param[in,out] z - archive
+ * @param[in] i - entry index
+ * @param[in] data - expected content
+ * @param[in] len - length of `data` in bytes
+ * @return `true` if equal, else `false`
+ */
+static bool testZipEqual(tZip * z, const size_t i, const uint8_t * data, const size_t len) {
+	size_t actualLen = 0;
+	uint8_t * actual = testZipExtract(z, i, &actualLen);
+	const bool res = actual != NULL && actualLen == len && memcmp(actual, data, len) == 0;
+	free(actual);
+	return res;
+}
+
+
+/**
+ * Entries of `zip-sample.zip` in archive order.
+ */
+static const struct {
+	const char * name;
+	uint16_t method;
+	size_t lines;
+	bool descriptor;
+	bool zip64;
+} testZipEntries[] = {
+	{"stored.exe", ZIP_STORED, 40, false, false},
+	{"dir/deflate.dll", ZIP_DEFLATED, 3000, false, false},
+	{"descriptor.ps1", ZIP_DEFLATED, 500, true, false},
+	{"zip64.cab", ZIP_DEFLATED, 200, false, true}
+};
+
+
+/**
+ * Number of entries in `zip-sample.zip`.
+ */
+#define TEST_ZIP_ENTRIES (sizeof(testZipEntries) / sizeof(*testZipEntries))
+
+
+/**
+ * Extracts all entries of `zip-sample.zip` and compares them with the
+ * generated content.
+ *
+ * @return `true` on success, else `false`
+ */
+static bool testZipExtractAll(void) {
+	uint8_t * expected = NULL;
+	tZip * z = NULL;
+	bool res = false;
+	FILE * fp = testOpen("zip-sample.zip", "rb");
+	TEST_CHECK(fp != NULL);
+	z = zip_open(fp);
+	TEST_CHECK(z != NULL);
+	TEST_CHECK(z->count == TEST_ZIP_ENTRIES);
+	TEST_CHECK(z->commentLen == 11 && memcmp(z->comment, "siguwi test", 11) == 0);
+	for (size_t i = 0; i < TEST_ZIP_ENTRIES; ++i) {
+		const tZipEntry * e = z->entries + i;
+		size_t len = 0;
+		TEST_CHECK(strcmp(e->name, testZipEntries[i].name) == 0);
+		TEST_CHECK(e->method == testZipEntries[i].method);
+		TEST_CHECK(((e->flags & 0x0008) != 0) == testZipEntries[i].descriptor);
+		TEST_CHECK(e->zip64 == testZipEntries[i].zip64);
+		TEST_CHECK( ! zip_isEncrypted(e) );
+		expected = testZipContent(e->name, testZipEntries[i].lines, &len);
+		TEST_CHECK(expected != NULL);
+		TEST_CHECK(e->size == len);
+		TEST_CHECK(testZipEqual(z, i, expected, len));
+		free(expected);
+		expected = NULL;
+	}
+	res = true;
+onError:
+	free(expected);
+	zip_close(z);
+	if (fp != NULL) {
+		fclose(fp);
+	}
+	return res;
+}
+
+
+/**
+ * Replacement data passed to `testZipReplace()`.
+ */
+typedef struct {
+	FILE * fp[TEST_ZIP_ENTRIES]; /**< replacement per entry or `NULL` */
+} tTestZipReplace;
+
+
+/**
+ * Returns the replacement of the given entry. This is compatible with
+ * `ZipReplaceCallback`.
+ *
+ * @param[in] entry - archive entry (unused)
+ * @param[in] i - entry index
+ * @param[in] param - `tTestZipReplace` context
+ * @return replacement stream or `NULL`
+ */
+static FILE * testZipReplace(const tZipEntry * entry, const size_t i, void * param) {
+	(void)entry;
+	const tTestZipReplace * rw = (const tTestZipReplace *)param;
+	if (i >= TEST_ZIP_ENTRIES || rw->fp[i] == NULL) {
+		return NULL;
+	}
+	rewind(rw->fp[i]);
+	return rw->fp[i];
+}
+
+
+/**
+ * Rewrites `zip-sample.zip` with replaced deflate, data descriptor and ZIP64
+ * entries and checks that all entries of the result hold the expected content.
+ *
+ * @return `true` on success, else `false`
+ */
+static bool testZipRewrite(void) {
+	static const char * const replacement = "signed replacement\n";
+	tTestZipReplace rw;
+	uint8_t * expected = NULL;
+	tZip * z = NULL;
+	tZip * z2 = NULL;
+	FILE * out = NULL;
+	bool res = false;
+	memset(&rw, 0, sizeof(rw));
+	FILE * fp = testOpen("zip-sample.zip", "rb");
+	TEST_CHECK(fp != NULL);
+	z = zip_open(fp);
+	TEST_CHECK(z != NULL);
+	for (size_t i = 1; i < TEST_ZIP_ENTRIES; ++i) {
+		rw.fp[i] = tmpfile();
+		TEST_CHECK(rw.fp[i] != NULL);
+		TEST_CHECK(fprintf(rw.fp[i], "%s%s", testZipEntries[i].name, replacement) > 0);
+	}
+	out = tmpfile();
+	TEST_CHECK(out != NULL);
+	TEST_CHECK(zip_rewrite(z, out, testZipReplace, &rw));
+	z2 = zip_open(out);
+	TEST_CHECK(z2 != NULL);
+	TEST_CHECK(z2->count == TEST_ZIP_ENTRIES);
+	TEST_CHECK(z2->commentLen == z->commentLen && memcmp(z2->comment, z->comment, z->commentLen) == 0);
+	for (size_t i = 0; i < TEST_ZIP_ENTRIES; ++i) {
+		size_t len = 0;
+		TEST_CHECK(strcmp(z2->entries[i].name, testZipEntries[i].name) == 0);
+		if (rw.fp[i] == NULL) {
+			/* copied verbatim */
+			TEST_CHECK(z2->entries[i].method == testZipEntries[i].method);
+			expected = testZipContent(testZipEntries[i].name, testZipEntries[i].lines, &len);
+		} else {
+			TEST_CHECK(z2->entries[i].method == ZIP_STORED);
+			expected = (uint8_t *)malloc(strlen(testZipEntries[i].name) + strlen(replacement) + 1);
+			TEST_CHECK(expected != NULL);
+			len = (size_t)sprintf((char *)expected, "%s%s", testZipEntries[i].name, replacement);
+		}
+		TEST_CHECK(expected != NULL);
+		TEST_CHECK(testZipEqual(z2, i, expected, len));
+		free(expected);
+		expected = NULL;
+	}
+	res = true;
+onError:
+	free(expected);
+	zip_close(z2);
+	zip_close(z);
+	if (out != NULL) {
+		fclose(out);
+	}
+	for (size_t i = 0; i < TEST_ZIP_ENTRIES; ++i) {
+		if (rw.fp[i] != NULL) {
+			fclose(rw.fp[i]);
+		}
+	}
+	if (fp != NULL) {
+		fclose(fp);
+	}
+	return res;
+}
+
+
+/**
+ * Extracts the entry of `zip-bomb.zip` which inflates to far more than its
+ * declared size. Extraction needs to fail without writing more than that.
+ *
+ * @return `true` on success, else `false`
+ */
+static bool testZipLimit(void) {
+	tZip * z = NULL;
+	FILE * out = NULL;
+	bool res = false;
+	FILE * fp = testOpen("zip-bomb.zip", "rb");
+	TEST_CHECK(fp != NULL);
+	z = zip_open(fp);
+	TEST_CHECK(z != NULL);
+	TEST_CHECK(z->count == 1);
+	out = tmpfile();
+	TEST_CHECK(out != NULL);
+	TEST_CHECK( ! zip_extract(z, 0, out) );
+	TEST_CHECK(fseek(out, 0, SEEK_END) == 0);
+	TEST_CHECK(ftell(out) >= 0 && (uint64_t)ftell(out) <= z->entries[0].size);
+	res = true;
+onError:
+	if (out != NULL) {
+		fclose(out);
+	}
+	zip_close(z);
+	if (fp != NULL) {
+		fclose(fp);
+	}
+	return res;
+}
+
+
+/**
+ * Returns the digest cache key of the given test file.
+ *
+ * @param[in] i - file number
+ * @return digest cache key
+ */
+static tDigestKey testDcacheKey(const size_t i) {
+	tDigestKey key;
+	memset(&key, 0, sizeof(key));
+	key.volume = 1;
+	key.id = 1000 + (uint64_t)i;
+	key.size = 4096;
+	key.mtime = UINT64_C(134000000000000000) + (uint64_t)i;
+	key.ctime = key.mtime;
+	key.algo = 1;
+	return key;
+}
+
+
+/**
+ * Creates a new digest cache file in the temporary directory with the digests
+ * of the given number of files.
+ *
+ * @param[in] count - number of files
+ * @return `true` on success, else `false`
+ */
+static bool testDcacheCreate(const size_t count) {
+	uint8_t digest[DCACHE_MAX_DIGEST];
+#ifdef PCF_IS_WIN
+	wchar_t dir[MAX_PATH + 1];
+	const DWORD len = GetTempPathW(MAX_PATH + 1, dir);
+	if (len == 0 || len > MAX_PATH) {
+		return false;
+	}
+	swprintf(testCachePath, TEST_MAX_PATH, L"%ls%ls", dir, L"" TEST_DCACHE_FILE);
+	_wremove(testCachePath);
+#else /* not PCF_IS_WIN */
+	const char * dir = getenv("TMPDIR");
+	snprintf(testCachePath, TEST_MAX_PATH, "%s/%s", (dir != NULL && *dir != 0) ? dir : "/tmp", TEST_DCACHE_FILE);
+	remove(testCachePath);
+#endif /* not PCF_IS_WIN */
+	tDigestCache * cache = dcache_open(testCachePath);
+	bool res = cache != NULL;
+	for (size_t i = 0; res && i < count; ++i) {
+		const tDigestKey key = testDcacheKey(i);
+		memset(digest, (int)(i + 1), sizeof(digest));
+		res = dcache_put(cache, &key, digest, 32);
+	}
+	dcache_close(cache);
+	return res;
+}
+
+
+/**
+ * Removes the digest cache file of the `dcache_*` tests.
+ */
+static void testDcacheRemove(void) {
+#ifdef PCF_IS_WIN
+	_wremove(testCachePath);
+#else /* not PCF_IS_WIN */
+	remove(testCachePath);
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Overwrites a field of the digest cache file of the `dcache_*` tests.
+ *
+ * @param[in] offset - file offset of the field
+ * @param[in] value - new value in native byte order
+ * @param[in] size - field size in bytes (4 or 8)
+ * @return `true` on success, else `false`
+ */
+static bool testDcachePatch(const long offset, const uint64_t value, const size_t size) {
+	const uint32_t value32 = (uint32_t)value;
+#ifdef PCF_IS_WIN
+	FILE * fp = _wfopen(testCachePath, L"r+b");
+#else /* not PCF_IS_WIN */
+	FILE * fp = fopen(testCachePath, "r+b");
+#endif /* not PCF_IS_WIN */
+	if (fp == NULL) {
+		return false;
+	}
+	bool res = fseek(fp, offset, SEEK_SET) == 0;
+	if ( res ) {
+		res = fwrite((size == 4) ? (const void *)&value32 : (const void *)&value, size, 1, fp) == 1;
+	}
+	return (fclose(fp) == 0) && res;
+}
+
+
+/**
+ * Returns the file offset of the given field of a digest cache slot.
+ *
+ * @param[in] i - slot index
+ * @param[in] field - field offset within the slot
+ * @return file offset
+ */
+static long testDcacheSlot(const size_t i, const long field) {
+	return TEST_DCACHE_SLOT_START + ((long)i * TEST_DCACHE_SLOT_SIZE) + field;
+}
+
+
+/**
+ * Returns the index of the first used slot of the digest cache file of the
+ * `dcache_*` tests.
+ *
+ * @return slot index or `DCACHE_MIN_CAPACITY` if none
+ */
+static size_t testDcacheUsedSlot(void) {
+	uint32_t len = 0;
+#ifdef PCF_IS_WIN
+	FILE * fp = _wfopen(testCachePath, L"rb");
+#else /* not PCF_IS_WIN */
+	FILE * fp = fopen(testCachePath, "rb");
+#endif /* not PCF_IS_WIN */
+	size_t i = 0;
+	for (; fp != NULL && i < DCACHE_MIN_CAPACITY; ++i) {
+		if (fseek(fp, testDcacheSlot(i, TEST_DCACHE_SLOT_LEN), SEEK_SET) != 0 || fread(&len, sizeof(len), 1, fp) != 1) {
+			i = DCACHE_MIN_CAPACITY;
+			break;
+		}
+		if (len != 0) {
+			break;
+		}
+	}
+	if (fp != NULL) {
+		fclose(fp);
+	}
+	return (fp != NULL) ? i : DCACHE_MIN_CAPACITY;
+}
+
+
+/**
+ * Reopens the digest cache file of the `dcache_*` tests and checks that it
+ * holds the given number of entries. Each entry is looked up.
+ *
+ * @param[in] count - expected number of entries
+ * @param[in] files - number of files whose digests were added
+ * @return `true` on success, else `false`
+ */
+static bool testDcacheCheck(const size_t count, const size_t files) {
+	uint8_t digest[DCACHE_MAX_DIGEST];
+	tDigestCache * cache = dcache_open(testCachePath);
+	bool res = false;
+	TEST_CHECK(cache != NULL);
+	TEST_CHECK(dcache_count(cache) == count);
+	for (size_t i = 0; i < files; ++i) {
+		const tDigestKey key = testDcacheKey(i);
+		const size_t len = dcache_get(cache, &key, digest, sizeof(digest));
+		TEST_CHECK(len == ((count > 0) ? 32 : 0));
+		TEST_CHECK(len == 0 || digest[0] == (uint8_t)(i + 1));
+	}
+	res = true;
+onError:
+	dcache_close(cache);
+	return res;
+}
+
+
+/**
+ * Reopens an intact digest cache file. All entries need to be kept.
+ *
+ * @return `true` on success, else `false`
+ */
+static bool testDcacheReopen(void) {
+	bool res = false;
+	TEST_CHECK(testDcacheCreate(3));
+	TEST_CHECK(testDcacheCheck(3, 3));
+	res = true;
+onError:
+	testDcacheRemove();
+	return res;
+}
+
+
+/**
+ * Reopens digest cache files with slots referencing values outside the value
+ * area. The offset and length need to be checked without overflowing and the
+ * cache needs to be reinitialized.
+ *
+ * @return `true` on success, else `false`
+ */
+static bool testDcacheCorrupt(void) {
+	static const struct {
+		long field;
+		uint64_t value;
+		size_t size;
+	} patches[] = {
+		{TEST_DCACHE_SLOT_OFFSET, UINT64_MAX - 4, 8},
+		{TEST_DCACHE_SLOT_OFFSET, 1u << 20, 8},
+		{TEST_DCACHE_SLOT_LEN, 1000, 4},
+		{TEST_DCACHE_SLOT_LEN, UINT32_MAX, 4}
+	};
+	bool res = false;
+	for (size_t i = 0; i < (sizeof(patches) / sizeof(*patches)); ++i) {
+		TEST_CHECK(testDcacheCreate(3));
+		const size_t slot = testDcacheUsedSlot();
+		TEST_CHECK(slot < DCACHE_MIN_CAPACITY);
+		TEST_CHECK(testDcachePatch(testDcacheSlot(slot, patches[i].field), patches[i].value, patches[i].size));
+		TEST_CHECK(testDcacheCheck(0, 3));
+	}
+	res = true;
+onError:
+	testDcacheRemove();
+	return res;
+}
+
+
+/**
+ * Reopens a digest cache file whose slots are all used while the header
+ * reports fewer entries. Looking up a missing key would never terminate. The
+ * cache needs to be reinitialized.
+ *
+ * @return `true` on success, else `false`
+ */
+static bool testDcacheFull(void) {
+	bool res = false;
+	TEST_CHECK(testDcacheCreate(3));
+	for (size_t i = 0; i < DCACHE_MIN_CAPACITY; ++i) {
+		TEST_CHECK(testDcachePatch(testDcacheSlot(i, TEST_DCACHE_SLOT_LEN), 32, 4));
+		TEST_CHECK(testDcachePatch(testDcacheSlot(i, TEST_DCACHE_SLOT_OFFSET), 0, 8));
+	}
+	TEST_CHECK(testDcacheCheck(0, 4));
+	/* a count below the number of used slots is rejected as well */
+	TEST_CHECK(testDcacheCreate(3));
+	TEST_CHECK(testDcachePatch(TEST_DCACHE_COUNT, 2, 8));
+	TEST_CHECK(testDcacheCheck(0, 3));
+	res = true;
+onError:
+	testDcacheRemove();
+	return res;
+}
+
+
+/**
+ * Compares the digests of all `fdigest-golden.txt` entries of the given
+ * format with the expected ones. The fixtures are created by
+ * `test/fdigest-gen.py`.
+ *
+ * @param[in] formatName - format name as used in `fdigest-golden.txt`
+ * @param[in] format - file format
+ * @return `true` on success, else `false`
+ */
+static bool testFdigest(const char * formatName, const tFileDigestFormat format) {
+	char line[256], name[128], fmt[16], expected[(2 * SHA256_SIZE) + 1], actual[(2 * SHA256_SIZE) + 1];
+	uint8_t digest[SHA256_SIZE];
+	uint8_t * data = NULL;
+	FILE * file = NULL;
+	size_t count = 0;
+	bool res = false;
+	FILE * fp = testOpen("fdigest-golden.txt", "r");
+	TEST_CHECK(fp != NULL);
+	while (fgets(line, (int)sizeof(line), fp) != NULL) {
+		unsigned isSigned = 0, flags = 0;
+		size_t len = 0;
+		if (line[0] == '#' || sscanf(line, "%127s %15s %u %64s", name, fmt, &isSigned, expected) != 4 || strcmp(fmt, formatName) != 0) {
+			continue;
+		}
+		file = testOpen(name, "rb");
+		TEST_CHECK(file != NULL);
+		data = testReadAll(file, &len);
+		TEST_CHECK(data != NULL);
+		if ( ! fdigest_compute(format, data, len, digest, &flags) ) {
+			fprintf(stderr, "%s: not accepted as %s\n", name, formatName);
+			goto onError;
+		}
+		for (size_t i = 0; i < SHA256_SIZE; ++i) {
+			snprintf(actual + (2 * i), 3, "%02x", (unsigned)digest[i]);
+		}
+		if (strcmp(actual, expected) != 0 || ((flags & FDIGEST_SIGNED) != 0) != (isSigned != 0)) {
+			fprintf(stderr, "%s: got %s %u, expected %s %u\n", name, actual, flags & FDIGEST_SIGNED, expected, isSigned);
+			goto onError;
+		}
+		free(data);
+		data = NULL;
+		fclose(file);
+		file = NULL;
+		++count;
+	}
+	TEST_CHECK(count > 0);
+	res = true;
+onError:
+	free(data);
+	if (file != NULL) {
+		fclose(file);
+	}
+	if (fp != NULL) {
+		fclose(fp);
+	}
+	return res;
+}
+
+
+static bool testFdigestPe(void) {
+	return testFdigest("pe", FDF_PE);
+}
+
+
+static bool testFdigestMsi(void) {
+	return testFdigest("msi", FDF_MSI);
+}
+
+
+static bool testFdigestCab(void) {
+	return testFdigest("cab", FDF_CAB);
+}
+
+
+static bool testFdigestPs1(void) {
+	return testFdigest("ps1", FDF_PS1);
+}
+
+
+static bool testFdigestRaw(void) {
+	return testFdigest("raw", FDF_RAW);
+}
+
+
+/**
+ * Stores the given value in little endian order.
+ *
+ * @param[out] buf - output buffer
+ * @param[in] value - value to store
+ * @param[in] len - number of bytes to store
+ */
+static void testWrLe(uint8_t * buf, uint64_t value, const size_t len) {
+	for (size_t i = 0; i < len; ++i, value >>= 8) {
+		buf[i] = (uint8_t)(value & 0xFF);
+	}
+}
+
+
+/**
+ * Opens an archive whose ZIP64 end of central directory record gives a
+ * central directory offset and size which overflow if added. Opening needs to
+ * fail.
+ *
+ * @return `true` on success, else `false`
+ */
+static bool testZipOverflow(void) {
+	uint8_t data[56 + 20 + 22];
+	uint8_t * end64 = data;
+	uint8_t * locator = data + 56;
+	uint8_t * end = data + 56 + 20;
+	tZip * z = NULL;
+	bool res = false;
+	memset(data, 0, sizeof(data));
+	testWrLe(end64, 0x06064B50, 4);
+	testWrLe(end64 + 4, 56 - 12, 8);
+	testWrLe(end64 + 12, 45, 2);
+	testWrLe(end64 + 14, 45, 2);
+	testWrLe(end64 + 24, 1, 8);
+	testWrLe(end64 + 32, 1, 8);
+	testWrLe(end64 + 40, 64, 8);
+	testWrLe(end64 + 48, UINT64_MAX - 7, 8);
+	testWrLe(locator, 0x07064B50, 4);
+	testWrLe(locator + 16, 1, 4);
+	testWrLe(end, 0x06054B50, 4);
+	testWrLe(end + 8, 0xFFFF, 2);
+	testWrLe(end + 10, 0xFFFF, 2);
+	testWrLe(end + 12, 0xFFFFFFFF, 4);
+	testWrLe(end + 16, 0xFFFFFFFF, 4);
+	FILE * fp = tmpfile();
+	TEST_CHECK(fp != NULL);
+	TEST_CHECK(fwrite(data, 1, sizeof(data), fp) == sizeof(data));
+	TEST_CHECK(fflush(fp) == 0);
+	z = zip_open(fp);
+	TEST_CHECK(z == NULL);
+	res = true;
+onError:
+	zip_close(z);
+	if (fp != NULL) {
+		fclose(fp);
+	}
+	return res;
+}
+
+
+/**
+ * Simulated signing item for the `lane_*` tests.
+ */
+typedef struct {
+	char token[TEST_LANE_STEPS]; /**< token per signing step */
+	size_t step; /**< current signing step */
+	bool running; /**< `true` while a lane signs the item */
+	bool done; /**< `true` once all signing steps finished */
+} tTestLaneItem;
+
+
+/**
+ * Simulated signing lanes for the `lane_*` tests.
+ */
+typedef struct {
+	tTestLaneItem items[TEST_LANE_ITEMS]; /**< signing items */
+	size_t next[TEST_LANE_STEPS]; /**< first item index which may wait for the lane */
+	size_t run[TEST_LANE_STEPS]; /**< item index running in the lane or `SIZE_MAX` */
+	size_t lane; /**< lane which selects an item */
+} tTestLanes;
+
+
+/**
+ * Lane queue check like the one of `processNext`.
+ *
+ * @param[in] i - item index
+ * @param[in,out] param - `tTestLanes`
+ * @return check result
+ */
+static tLaneQueueCheck testLaneCheck(const size_t i, void * param) {
+	const tTestLanes * lanes = (const tTestLanes *)param;
+	const tTestLaneItem * item = lanes->items + i;
+	if (item->running || item->done || item->step != lanes->lane) {
+		return LQ_SKIP;
+	}
+	for (size_t k = 0; k < TEST_LANE_STEPS; ++k) {
+		const size_t other = lanes->run[k];
+		if (k != lanes->lane && other != SIZE_MAX && lanes->items[other].token[k] == item->token[lanes->lane]) {
+			return LQ_WAIT;
+		}
+	}
+	return LQ_TAKE;
+}
+
+
+/**
+ * Signs two interleaved chains whose steps use the same two tokens in
+ * opposite order. Items which wait for a busy token need to be taken once the
+ * token was released.
+ *
+ * @return `true` on success, else `false`
+ */
+static bool testLaneChains(void) {
+	tTestLanes lanes;
+	bool res = false;
+	memset(&lanes, 0, sizeof(lanes));
+	for (size_t i = 0; i < TEST_LANE_ITEMS; ++i) {
+		lanes.items[i].token[0] = (i & 1) ? 'B' : 'A';
+		lanes.items[i].token[1] = (i & 1) ? 'A' : 'B';
+	}
+	size_t done = 0;
+	for (size_t tick = 0; tick < 4 * TEST_LANE_ITEMS && done < TEST_LANE_ITEMS; ++tick) {
+		/* later signing steps first like `processNext` */
+		for (size_t k = TEST_LANE_STEPS; k-- > 0; ) {
+			lanes.lane = k;
+			lanes.run[k] = lq_take(lanes.next + k, TEST_LANE_ITEMS, testLaneCheck, &lanes);
+			if (lanes.run[k] != SIZE_MAX) {
+				lanes.items[lanes.run[k]].running = true;
+			}
+		}
+		TEST_CHECK(lanes.run[0] == SIZE_MAX || lanes.run[1] == SIZE_MAX || lanes.items[lanes.run[0]].token[0] != lanes.items[lanes.run[1]].token[1]);
+		/* finish all running items like `processAdvance` */
+		for (size_t k = 0; k < TEST_LANE_STEPS; ++k) {
+			const size_t i = lanes.run[k];
+			if (i == SIZE_MAX) {
+				continue;
+			}
+			tTestLaneItem * item = lanes.items + i;
+			item->running = false;
+			lanes.run[k] = SIZE_MAX;
+			if (++(item->step) < TEST_LANE_STEPS) {
+				if (i < lanes.next[item->step]) {
+					lanes.next[item->step] = i;
+				}
+			} else {
+				item->done = true;
+				++done;
+			}
+		}
+	}
+	TEST_CHECK(done == TEST_LANE_ITEMS);
+	res = true;
+onError:
+	return res;
+}
+
+
+/**
+ * List of all tests.
+ */
+static const tTest tests[] = {
+	{"zip_extract", testZipExtractAll},
+	{"zip_rewrite", testZipRewrite},
+	{"zip_limit", testZipLimit},
+	{"zip_overflow", testZipOverflow},
+	{"dcache_reopen", testDcacheReopen},
+	{"dcache_corrupt", testDcacheCorrupt},
+	{"dcache_full", testDcacheFull},
+	{"fdigest_pe", testFdigestPe},
+	{"fdigest_msi", testFdigestMsi},
+	{"fdigest_cab", testFdigestCab},
+	{"fdigest_ps1", testFdigestPs1},
+	{"fdigest_raw", testFdigestRaw},
+	{"lane_chains", testLaneChains},
+};
+
+
+/**
+ * Writes the command-line help to standard error.
+ *
+ * @param[in] name - program name
+ */
+static void testHelp(const char * name) {
+	fprintf(stderr,
+		"%s [options]\n"
+		"\n"
+		"Runs the native tests.\n"
+		"\n"
+		"-d, --dir <path>\n"
+		"      Read the fixtures from this directory. Default: %s\n"
+		"-f, --filter <text>\n"
+		"      Run only tests whose name contains this text.\n"
+		"-h, --help\n"
+		"      Print short usage instruction.\n"
+		"\n"
+		"The exit code is 1 if a test failed, 2 on error and 0 otherwise.\n",
+		name,
+		TEST_DIR
+	);
+}
+
+
+/**
+ * Main entry point.
+ *
+ * @param[in] argc - number of command-line arguments
+ * @param[in] argv - command-line arguments
+ * @return 0 on success, 1 on failure, 2 on error
+ */
+int main(int argc, char ** argv) {
+	const char * filter = NULL;
+	for (int i = 1; i < argc; ++i) {
+		const char * arg = argv[i];
+		const char * value = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+			testHelp(argv[0]);
+			return EXIT_SUCCESS;
+		} else if (value == NULL) {
+			fprintf(stderr, "Error: Invalid or incomplete argument \"%s\".\n", arg);
+			return 2;
+		} else if (strcmp(arg, "-d") == 0 || strcmp(arg, "--dir") == 0) {
+			testDir = value;
+		} else if (strcmp(arg, "-f") == 0 || strcmp(arg, "--filter") == 0) {
+			filter = value;
+		} else {
+			fprintf(stderr, "Error: Invalid or incomplete argument \"%s\".\n", arg);
+			return 2;
+		}
+		++i;
+	}
+	size_t failed = 0;
+	size_t count = 0;
+	for (size_t i = 0; i < (sizeof(tests) / sizeof(*tests)); ++i) {
+		const tTest * t = tests + i;
+		if (filter != NULL && strstr(t->name, filter) == NULL) {
+			continue;
+		}
+		const bool ok = t->run();
+		fprintf(stderr, "%-24s %s\n", t->name, ok ? "ok" : "FAILED");
+		failed += ok ? 0 : 1;
+		++count;
+	}
+	fprintf(stderr, "%zu of %zu test%s failed.\n", failed, count, (count != 1) ? "s" : "");
+	return (failed > 0) ? 1 : EXIT_SUCCESS;
+}
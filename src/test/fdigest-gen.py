@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+# Generates the signed and unsigned PE, MSI, cabinet and PowerShell files used
+# by the `fdigest_*` tests of `siguwi-test` and writes their expected digests
+# to `fdigest-golden.txt`. The digests are computed from the written files by
+# the parsers below, which follow the Authenticode rules of each format
+# independently of `fdigest.c`:
+# - PE: headers without checksum and certificate table entry, the section data
+#   in file order and the remaining data without the certificate table.
+# - MSI: the streams of each storage in UTF-16LE name order followed by the
+#   class ID of the storage. The signature streams of the root are skipped.
+# - Cabinet: the file without the signature offset and size of the header
+#   reserve and without the signature.
+# - PowerShell: the text as UTF-16LE up to the line break before the signature
+#   block. Invalid UTF-8 bytes are mapped to U+DC80 to U+DCFF.
+# The signed and unsigned variants of each file need to have the same digest.
+import hashlib
+import struct
+import sys
+
+
+def noise(n, seed):
+	out = bytearray()
+	x = seed
+	while len(out) < n:
+		x ^= (x << 13) & 0xFFFFFFFF
+		x ^= x >> 17
+		x ^= (x << 5) & 0xFFFFFFFF
+		out.append(x & 0xFF)
+	return bytes(out)
+
+
+# PE images
+
+def pe(plus, sections, overlay=b'', cert=b'', checksum=0):
+	optLen = 240 if plus else 224
+	opt = 0x98
+	table = opt + optLen
+	out = bytearray(0x200)
+	out[0:2] = b'MZ'
+	struct.pack_into('<I', out, 0x3C, 0x80)
+	out[0x40:0x80] = noise(0x40, 0x13579BDF)
+	out[0x80:0x84] = b'PE\0\0'
+	struct.pack_into('<HHIIIHH', out, 0x84, 0x8664 if plus else 0x14C, len(sections), 0x5F000000, 0, 0, optLen, 0x22)
+	struct.pack_into('<HBBIII', out, opt, 0x20B if plus else 0x10B, 14, 0, 0x200 * len(sections), 0, 0)
+	struct.pack_into('<I', out, opt + 60, 0x200) # size of headers
+	struct.pack_into('<I', out, opt + 64, checksum)
+	struct.pack_into('<HH', out, opt + 68, 2, 0x8160) # subsystem and DLL characteristics
+	dirs = opt + (112 if plus else 96)
+	struct.pack_into('<I', out, dirs - 4, 16)
+	struct.pack_into('<II', out, dirs + 8, 0x1010, 0x28) # import table
+	for i, (name, data) in enumerate(sections):
+		struct.pack_into('<8sIIIIIIHHI', out, table + (40 * i), name, len(data), 0x1000 * (i + 1), len(data), len(out), 0, 0, 0, 0, 0x60000020)
+		out += data
+	out += overlay
+	if cert:
+		struct.pack_into('<II', out, dirs + 32, len(out), len(cert))
+	return bytes(out + cert)
+
+
+def peDigest(data):
+	pe = struct.unpack_from('<I', data, 0x3C)[0]
+	assert data[pe:pe + 4] == b'PE\0\0'
+	count, optLen = struct.unpack_from('<2xH12xH', data, pe + 4)
+	opt = pe + 24
+	magic = struct.unpack_from('<H', data, opt)[0]
+	dirs = opt + (112 if magic == 0x20B else 96)
+	headers = struct.unpack_from('<I', data, opt + 60)[0]
+	checksum = opt + 64
+	certDir = dirs + 32
+	certOffset, certSize = struct.unpack_from('<II', data, certDir)
+	h = hashlib.sha256()
+	h.update(data[:checksum])
+	h.update(data[checksum + 4:certDir])
+	h.update(data[certDir + 8:headers])
+	sections = []
+	for i in range(count):
+		rawSize, rawPtr = struct.unpack_from('<II', data, opt + optLen + (40 * i) + 16)
+		if rawSize > 0:
+			sections.append((rawPtr, rawSize))
+	hashed = headers
+	for rawPtr, rawSize in sorted(sections):
+		h.update(data[rawPtr:rawPtr + rawSize])
+		hashed += rawSize
+	end = len(data) - certSize
+	if end > hashed:
+		h.update(data[hashed:end])
+	return h.hexdigest(), certSize > 0
+
+
+# MSI packages (OLE compound document version 3)
+
+FREESECT = 0xFFFFFFFF
+ENDOFCHAIN = 0xFFFFFFFE
+FATSECT = 0xFFFFFFFD
+NOSTREAM = 0xFFFFFFFF
+
+
+def msi(root):
+	# root: {'clsid': bytes, 'children': [entry]} with entry either
+	# {'name': str, 'data': bytes} or {'name': str, 'clsid': bytes, 'children': [entry]}
+	sectors = [bytes(512)] # sector 0 holds the FAT
+	fat = [FATSECT]
+	def chain(data):
+		if not data:
+			return ENDOFCHAIN
+		start = len(sectors)
+		n = (len(data) + 511) // 512
+		for i in range(n):
+			sectors.append(data[512 * i:512 * (i + 1)].ljust(512, b'\0'))
+			fat.append(start + i + 1 if i + 1 < n else ENDOFCHAIN)
+		return start
+	entries = []
+	def flatten(node):
+		node['id'] = len(entries)
+		entries.append(node)
+		for child in node.get('children', []):
+			flatten(child)
+	flatten(root)
+	ministream = bytearray()
+	minifat = []
+	large = []
+	for e in entries[1:]:
+		if 'data' not in e:
+			continue
+		if len(e['data']) < 4096:
+			e['start'] = len(ministream) // 64 if e['data'] else ENDOFCHAIN
+			n = (len(e['data']) + 63) // 64
+			for i in range(n):
+				minifat.append(len(minifat) + 1 if i + 1 < n else ENDOFCHAIN)
+			ministream += e['data'].ljust(64 * n, b'\0')
+		else:
+			large.append(e)
+	dirData = bytearray()
+	entryCount = (len(entries) + 3) // 4 * 4
+	def dirEntry(e):
+		if e is None:
+			return struct.pack('<64sHBB3I16sIQQIQ', b'', 0, 0, 0, NOSTREAM, NOSTREAM, NOSTREAM, bytes(16), 0, 0, 0, 0, 0)
+		name = e['name'].encode('utf-16-le')
+		kind = 5 if e is root else (2 if 'data' in e else 1)
+		children = e.get('children', [])
+		# children are linked as right siblings in definition order (not sorted)
+		child = children[0]['id'] if children else NOSTREAM
+		right = NOSTREAM
+		for parent in entries:
+			siblings = parent.get('children', [])
+			if e in siblings and siblings.index(e) + 1 < len(siblings):
+				right = siblings[siblings.index(e) + 1]['id']
+		return struct.pack('<64sHBB3I16sIQQIQ', name, len(name) + 2, kind, 1, NOSTREAM, right, child, e.get('clsid', bytes(16)), 0, 0, 0, e.get('start', ENDOFCHAIN), len(e.get('data', b'')) if e is not root else e['size'])
+	# the layout depends on the mini stream size only
+	root['size'] = len(ministream)
+	dirStart = len(sectors)
+	for i in range((entryCount * 128 + 511) // 512):
+		sectors.append(bytes(512))
+		fat.append(dirStart + i + 1 if (i + 1) * 512 < entryCount * 128 else ENDOFCHAIN)
+	minifatStart = chain(b''.join(struct.pack('<I', v) for v in minifat))
+	root['start'] = chain(bytes(ministream))
+	for e in large:
+		e['start'] = chain(e['data'])
+	for e in entries + [None] * (entryCount - len(entries)):
+		dirData += dirEntry(e)
+	for i in range(len(dirData) // 512):
+		sectors[dirStart + i] = bytes(dirData[512 * i:512 * (i + 1)])
+	assert len(fat) <= 128
+	sectors[0] = b''.join(struct.pack('<I', v) for v in fat).ljust(512, b'\xFF')
+	header = bytearray(512)
+	header[0:8] = b'\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1'
+	struct.pack_into('<HHHHH6xIIIIIIIII', header, 0x18, 0x3E, 3, 0xFFFE, 9, 6, 0, 1, dirStart, 0, 4096, minifatStart, (len(minifat) * 4 + 511) // 512, ENDOFCHAIN, 0)
+	struct.pack_into('<109I', header, 0x4C, 0, *([FREESECT] * 108))
+	return bytes(header) + b''.join(sectors)
+
+
+def msiDigest(data):
+	secSize = 1 << struct.unpack_from('<H', data, 0x1E)[0]
+	major = struct.unpack_from('<H', data, 0x1A)[0]
+	fatCount, dirStart, _, cutoff, minifatStart = struct.unpack_from('<5I', data, 0x2C)
+	difatStart = struct.unpack_from('<I', data, 0x44)[0]
+	def sector(i):
+		return data[secSize * (i + 1):secSize * (i + 2)]
+	fatSectors = list(struct.unpack_from('<109I', data, 0x4C))[:fatCount]
+	while len(fatSectors) < fatCount and difatStart != ENDOFCHAIN:
+		s = struct.unpack('<%uI' % (secSize // 4), sector(difatStart))
+		fatSectors += s[:-1]
+		difatStart = s[-1]
+	fat = []
+	for s in fatSectors[:fatCount]:
+		fat += struct.unpack('<%uI' % (secSize // 4), sector(s))
+	def read(start, table, get):
+		out = bytearray()
+		while start != ENDOFCHAIN:
+			out += get(start)
+			start = table[start]
+		return bytes(out)
+	def readLarge(start):
+		return read(start, fat, sector)
+	dirData = readLarge(dirStart)
+	entries = []
+	for i in range(len(dirData) // 128):
+		name, nameLen, kind, _, left, right, child, clsid, _, _, _, start, size = struct.unpack_from('<64sHBB3I16sIQQIQ', dirData, 128 * i)
+		entries.append({'name': name[:max(nameLen - 2, 0)], 'kind': kind, 'left': left, 'right': right, 'child': child, 'clsid': clsid, 'start': start, 'size': size & 0xFFFFFFFF if major == 3 else size})
+	minifat = list(struct.unpack('<%uI' % (len(readLarge(minifatStart)) // 4), readLarge(minifatStart))) if minifatStart != ENDOFCHAIN else []
+	ministream = readLarge(entries[0]['start'])
+	def stream(e):
+		if e['size'] < cutoff:
+			raw = read(e['start'], minifat, lambda i: ministream[64 * i:64 * (i + 1)])
+		else:
+			raw = readLarge(e['start'])
+		return raw[:e['size']]
+	def children(e):
+		out = []
+		todo = [e['child']]
+		while todo:
+			i = todo.pop()
+			if i == NOSTREAM:
+				continue
+			out.append(entries[i])
+			todo += [entries[i]['left'], entries[i]['right']]
+		return out
+	signature = ('\x05DigitalSignature'.encode('utf-16-le'), '\x05MsiDigitalSignatureEx'.encode('utf-16-le'))
+	h = hashlib.sha256()
+	signed = False
+	def storage(e, depth):
+		nonlocal signed
+		for c in sorted(children(e), key=lambda c: c['name']):
+			if c['kind'] == 2:
+				if depth == 0 and c['name'] in signature:
+					signed = True
+				else:
+					h.update(stream(c))
+			elif c['kind'] == 1:
+				storage(c, depth + 1)
+		h.update(e['clsid'])
+	storage(entries[0], 0)
+	return h.hexdigest(), signed
+
+
+# cabinets
+
+def cab(name, content, sig=None):
+	reserve = b''
+	flags = 0
+	if sig is not None:
+		flags = 0x0004
+		reserve = struct.pack('<HBB', 20, 0, 0) + struct.pack('<III8s', 0x00100000, 0, len(sig), b'')
+	header = 36 + len(reserve)
+	folder = header
+	files = folder + 8
+	fileEntry = struct.pack('<IIHHHH', len(content), 0, 0, 0x5A21, 0x6000, 0x20) + name + b'\0'
+	data = files + len(fileEntry)
+	block = struct.pack('<IHH', 0, len(content), len(content)) + content
+	total = data + len(block)
+	out = bytearray(struct.pack('<4sIIIIIBBHHHHH', b'MSCF', 0, total, 0, files, 0, 3, 1, 1, 1, flags, 0x1234, 0))
+	out += reserve
+	out += struct.pack('<IHH', data, 1, 0)
+	out += fileEntry + block
+	if sig is not None:
+		struct.pack_into('<I', out, 44, len(out))
+		out += sig
+	return bytes(out)
+
+
+def cabDigest(data):
+	flags = struct.unpack_from('<H', data, 30)[0]
+	skip = []
+	signed = False
+	if flags & 0x0004 and struct.unpack_from('<H', data, 36)[0] == 20:
+		sigOffset, sigSize = struct.unpack_from('<II', data, 44)
+		skip.append((44, 52))
+		if sigSize > 0:
+			skip.append((sigOffset, sigOffset + sigSize))
+			signed = True
+	h = hashlib.sha256()
+	pos = 0
+	for start, end in skip:
+		h.update(data[pos:start])
+		pos = end
+	h.update(data[pos:])
+	return h.hexdigest(), signed
+
+
+# PowerShell scripts
+
+SIG_BEGIN = '# SIG # Begin signature block'
+SIG_END = '# SIG # End signature block'
+SIGNATURE = '\r\n' + SIG_BEGIN + '\r\n# MIIFuQYJKoZIhvcNAQcCoIIFqjCCBaYCAQExDzANBglghkgBZQMEAgEFADB5Bgor\r\n# BgEEAYI3AgEEoGswaTA0BgorBgEEAYI3AgEeMCYCAwEAAAQQH8w7YFlLCE63JNLG\r\n' + SIG_END + '\r\n'
+
+
+def ps1Digest(data):
+	if data[:2] == b'\xFF\xFE':
+		text = data[2:].decode('utf-16-le', 'surrogatepass')
+	elif data[:2] == b'\xFE\xFF':
+		text = data[2:].decode('utf-16-be', 'surrogatepass')
+	else:
+		text = (data[3:] if data[:3] == b'\xEF\xBB\xBF' else data).decode('utf-8', 'surrogateescape')
+	signed = False
+	begin = text.rfind(SIG_BEGIN)
+	while begin > 0 and text[begin - 1] != '\n':
+		begin = text.rfind(SIG_BEGIN, 0, begin)
+	if begin >= 0 and ('\n' + SIG_END) in text[begin:]:
+		signed = True
+		text = text[:begin]
+		if text.endswith('\n'):
+			text = text[:-1]
+			if text.endswith('\r'):
+				text = text[:-1]
+	return hashlib.sha256(text.encode('utf-16-le', 'surrogatepass')).hexdigest(), signed
+
+
+def script(lines):
+	return ''.join('Write-Output "%s"\r\n' % line for line in lines)
+
+
+def main(dir):
+	files = []
+	def add(name, format, data, digest):
+		with open(dir + '/' + name, 'wb') as f:
+			f.write(data)
+		files.append((name, format) + digest(data))
+	sections32 = [(b'.text', noise(0x200, 1)), (b'.data', noise(0x200, 2))]
+	add('pe32-unsigned.exe', 'pe', pe(False, sections32, checksum=0), peDigest)
+	add('pe32-signed.exe', 'pe', pe(False, sections32, cert=struct.pack('<IHH', 0x108, 0x200, 2) + noise(0x100, 3), checksum=0x9A41), peDigest)
+	sections64 = [(b'.text', noise(0x400, 4)), (b'.rdata', noise(0x200, 5)), (b'.rsrc', noise(0x200, 6))]
+	add('pe64-unsigned.dll', 'pe', pe(True, sections64, overlay=noise(0x40, 7)), peDigest)
+	add('pe64-signed.dll', 'pe', pe(True, sections64, overlay=noise(0x40, 7), cert=struct.pack('<IHH', 0x88, 0x200, 2) + noise(0x80, 8), checksum=0x1F3C2), peDigest)
+	def package(signed):
+		children = [
+			{'name': '\x05SummaryInformation', 'data': noise(50, 9)},
+			{'name': 'a', 'data': noise(5000, 10)},
+			{'name': 'Sub', 'clsid': noise(16, 11), 'children': [
+				{'name': 'x', 'data': noise(70, 12)},
+				{'name': '\x05DigitalSignature', 'data': noise(30, 13)}
+			]},
+			{'name': 'B', 'data': noise(100, 14)},
+			{'name': '䡀㬿䏲', 'data': noise(20, 15)},
+			{'name': 'Su', 'data': noise(10, 16)},
+			{'name': 'empty', 'data': b''}
+		]
+		if signed:
+			children.insert(2, {'name': '\x05DigitalSignature', 'data': noise(200, 17)})
+			children.append({'name': '\x05MsiDigitalSignatureEx', 'data': noise(32, 18)})
+		return msi({'name': 'Root Entry', 'clsid': bytes.fromhex('84100c000000000000c0000000000046'), 'children': children})
+	add('msi-unsigned.msi', 'msi', package(False), msiDigest)
+	add('msi-signed.msi', 'msi', package(True), msiDigest)
+	content = b''.join(b'line %05u\r\n' % i for i in range(100))
+	add('cab-plain.cab', 'cab', cab(b'setup.inf', content), cabDigest)
+	add('cab-unsigned.cab', 'cab', cab(b'setup.inf', content, sig=b''), cabDigest)
+	add('cab-signed.cab', 'cab', cab(b'setup.inf', content, sig=noise(0x80, 19)), cabDigest)
+	text = script(['Datei signiert äöü €', 'Schlüssel \U0001F511']) + SIG_BEGIN + '\r\n' + script(['Ende'])
+	add('ps1-utf8.ps1', 'ps1', text.encode('utf-8'), ps1Digest)
+	add('ps1-utf8-signed.ps1', 'ps1', b'\xEF\xBB\xBF' + (text + SIGNATURE).encode('utf-8'), ps1Digest)
+	add('ps1-utf16-signed.ps1', 'ps1', b'\xFF\xFE' + (text + SIGNATURE).encode('utf-16-le'), ps1Digest)
+	add('ps1-invalid.ps1', 'ps1', b'Write-Output "\xFF\xC0\xAF\xE2\x82x\xED\xA0\x80"\r\n' + SIGNATURE.encode('utf-8'), ps1Digest)
+	add('raw.bin', 'raw', noise(1000, 20), lambda data: (hashlib.sha256(data).hexdigest(), False))
+	with open(dir + '/fdigest-golden.txt', 'w', newline='\n') as f:
+		f.write('# file format signed sha256 (generated by fdigest-gen.py)\n')
+		for name, format, digest, signed in files:
+			f.write('%s %s %u %s\n' % (name, format, 1 if signed else 0, digest))
+
+
+if __name__ == '__main__':
+	main(sys.argv[1] if len(sys.argv) > 1 else '.')
@@ -0,0 +1,9 @@
+﻿Write-Output "Datei signiert äöü €"
+Write-Output "Schlüssel 🔑"
+# SIG # Begin signature block
+Write-Output "Ende"
+
+# SIG # Begin signature block
+# MIIFuQYJKoZIhvcNAQcCoIIFqjCCBaYCAQExDzANBglghkgBZQMEAgEFADB5Bgor
+# BgEEAYI3AgEEoGswaTA0BgorBgEEAYI3AgEeMCYCAwEAAAQQH8w7YFlLCE63JNLG
+# SIG # End signature block
@@ -0,0 +1,4 @@
+Write-Output "Datei signiert äöü €"
+Write-Output "Schlüssel 🔑"
+# SIG # Begin signature block
+Write-Output "Ende"
@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+# Runs several fake signing agents on loopback ports to test a siguwi
+# coordinator (`--agent 127.0.0.1:<port>`) against agent outages and restarts
+# on a single host. The agents speak the authenticated HTTP/JSON protocol of
+# `siguwi-http.c`. Signing takes `--delay` seconds. Uploaded files get a marker
+# appended; files passed by path are not modified. A file which is signed by
+# two agents at once or which is signed twice is reported and the script exits
+# with 1 once no file was pending for `--idle` seconds.
+import argparse
+import hashlib
+import hmac
+import http.server
+import json
+import os
+import random
+import sys
+import tempfile
+import threading
+import time
+import urllib.parse
+
+
+NONCE_LEN = 32
+AUTH_WINDOW = 300.0
+CHUNK_SIZE = 48 * 1024
+MAX_UPLOAD = 4 << 30
+FINAL = ('success', 'failed')
+
+
+class Monitor:
+	'''Tracks the signing of all agents to detect files signed twice.'''
+
+	def __init__(self, idle):
+		self.lock = threading.Lock()
+		self.idle = idle
+		self.start = None
+		self.last = time.monotonic()
+		self.active = {}
+		self.signed = {}
+		self.errors = []
+
+	def elapsed(self):
+		with self.lock:
+			return (time.monotonic() - self.start) if self.start is not None else -1.0
+
+	def submitted(self):
+		with self.lock:
+			if self.start is None:
+				self.start = time.monotonic()
+			self.last = time.monotonic()
+
+	def begin(self, agent, path):
+		with self.lock:
+			self.last = time.monotonic()
+			others = self.active.setdefault(path, set())
+			if others:
+				self.errors.append('%s signed by agent %u while agent %s signs it' % (path, agent, ', '.join(str(a) for a in sorted(others))))
+			others.add(agent)
+
+	def end(self, agent, path, ok):
+		with self.lock:
+			self.last = time.monotonic()
+			self.active[path].discard(agent)
+			if ok:
+				if path in self.signed:
+					self.errors.append('%s signed twice (agents %u and %u)' % (path, self.signed[path], agent))
+				self.signed[path] = agent
+
+	def finished(self, agents):
+		with self.lock:
+			if self.start is None or (time.monotonic() - self.last) < self.idle:
+				return False
+		return all(a.pending() == 0 for a in agents)
+
+
+class Agent:
+	'''Single fake agent with its own item list and signing thread.'''
+
+	def __init__(self, index, port, key, args, monitor):
+		self.index = index
+		self.port = port
+		self.key = key
+		self.args = args
+		self.monitor = monitor
+		self.cond = threading.Condition()
+		self.spool = tempfile.mkdtemp(prefix='siguwi-agent%u-' % index)
+		self.down = False
+		self.signedCount = 0
+		self.newSession()
+		self.server = http.server.ThreadingHTTPServer(('127.0.0.1', port), self.handler())
+		self.server.daemon_threads = True
+		threading.Thread(target=self.server.serve_forever, daemon=True).start()
+		threading.Thread(target=self.signer, daemon=True).start()
+
+	def newSession(self):
+		# like a new siguwi process: new session, no items
+		self.session = '%016x%08x' % (int(time.time() * 1000), (os.getpid() * 64 + self.index) & 0xFFFFFFFF)
+		self.items = []
+		self.queue = []
+		self.seq = 1
+
+	def restart(self):
+		with self.cond:
+			self.newSession()
+			self.cond.notify_all()
+		print('agent %u: restarted' % self.index, flush=True)
+
+	def setDown(self, down):
+		with self.cond:
+			self.down = down
+			self.cond.notify_all()
+		print('agent %u: %s' % (self.index, 'unreachable' if down else 'reachable'), flush=True)
+
+	def pending(self):
+		with self.cond:
+			return sum(1 for item in self.items if item['result'] not in FINAL)
+
+	def changed(self):
+		self.seq += 1
+		self.cond.notify_all()
+
+	def signer(self):
+		while True:
+			with self.cond:
+				while not self.queue:
+					self.cond.wait()
+				session = self.session
+				item = self.queue.pop(0)
+				item['result'] = 'running'
+				self.changed()
+			self.monitor.begin(self.index, item['path'])
+			until = time.monotonic() + self.args.delay
+			with self.cond:
+				while self.session == session and time.monotonic() < until:
+					self.cond.wait(until - time.monotonic())
+				lost = (self.session != session)
+				ok = (not lost) and random.random() >= self.args.fail
+				if ok and os.path.dirname(item['path']) == self.spool:
+					with open(item['path'], 'ab') as fp:
+						fp.write(b'\nsigned by agent %u\n' % self.index)
+			# a restart aborts the signing like a terminated signing application
+			self.monitor.end(self.index, item['path'], ok)
+			with self.cond:
+				if not lost:
+					item['result'] = 'success' if ok else 'failed'
+					item['exitCode'] = 0 if ok else 1
+					item['output'] = 'agent %u: %s %s\n' % (self.index, 'signed' if ok else 'failed to sign', item['path'])
+					self.signedCount += 1 if ok else 0
+					self.changed()
+
+	def itemsJson(self, first):
+		items = [{'id': i, 'path': self.items[i]['path'], 'result': self.items[i]['result'], 'done': self.items[i]['result'] in FINAL, 'exitCode': self.items[i]['exitCode']} for i in range(first, len(self.items))]
+		pending = sum(1 for item in self.items if item['result'] not in FINAL)
+		return {'session': self.session, 'seq': self.seq, 'count': len(self.items), 'pending': pending, 'items': items}
+
+	def handle(self, method, target, body):
+		'''Returns (status, content type, body) or None to drop the connection.'''
+		url = urllib.parse.urlsplit(target)
+		query = dict(urllib.parse.parse_qsl(url.query))
+		parts = url.path.strip('/').split('/')
+		if parts[0] == 'items' and len(parts) == 1 and method == 'POST':
+			try:
+				files = json.loads(body.decode('utf-8'))['files']
+			except (ValueError, KeyError, TypeError):
+				return 400, 'text/plain', b'Invalid request body.'
+			self.monitor.submitted()
+			with self.cond:
+				first = len(self.items)
+				for path in files:
+					item = {'path': path, 'result': 'pending', 'exitCode': None, 'output': ''}
+					self.items.append(item)
+					self.queue.append(item)
+				self.changed()
+				return 200, 'application/json; charset=utf-8', json.dumps(self.itemsJson(first)).encode()
+		if parts[0] == 'items' and len(parts) == 1 and method == 'GET':
+			first = int(query.get('from', '0'))
+			since = int(query.get('since', '0'))
+			until = time.monotonic() + int(query.get('wait', '0')) / 1000.0
+			with self.cond:
+				session = self.session
+				while self.seq <= since and session == self.session and not self.down and time.monotonic() < until:
+					self.cond.wait(until - time.monotonic())
+				if self.down or session != self.session:
+					return None
+				return 200, 'application/json; charset=utf-8', json.dumps(self.itemsJson(first)).encode()
+		if parts[0] == 'items' and len(parts) == 3 and parts[2] == 'output' and method == 'GET':
+			with self.cond:
+				i = int(parts[1]) if parts[1].isdigit() else len(self.items)
+				if i >= len(self.items):
+					return 404, 'text/plain', b'Item not found.'
+				return 200, 'text/plain; charset=utf-8', self.items[i]['output'].encode()
+		if parts[0] == 'files' and len(parts) == 2 and parts[1] not in ('', '.', '..'):
+			path = os.path.join(self.spool, parts[1])
+			offset = int(query.get('offset', '0'))
+			if method == 'PUT':
+				if offset + len(body) > MAX_UPLOAD:
+					if os.path.exists(path):
+						os.remove(path)
+					return 413, 'text/plain', b'File too large.'
+				if offset != (os.path.getsize(path) if os.path.exists(path) and offset != 0 else 0):
+					return 409, 'text/plain', b'Unexpected upload offset.'
+				with open(path, 'ab' if offset != 0 else 'wb') as fp:
+					fp.write(body)
+				return 200, 'application/json; charset=utf-8', json.dumps({'path': path, 'size': offset + len(body)}).encode()
+			if method == 'GET' and os.path.exists(path):
+				with open(path, 'rb') as fp:
+					fp.seek(offset)
+					return 200, 'application/octet-stream', fp.read(CHUNK_SIZE)
+			if method == 'DELETE' and os.path.exists(path):
+				os.remove(path)
+				return 200, 'application/json; charset=utf-8', b'{}'
+			return 404, 'text/plain', b'File not found.'
+		return 404, 'text/plain', b'Not found.'
+
+	def handler(self):
+		agent = self
+
+		class Handler(http.server.BaseHTTPRequestHandler):
+			protocol_version = 'HTTP/1.1'
+
+			def log_message(self, format, *args):
+				pass
+
+			def serve(self):
+				body = self.rfile.read(int(self.headers.get('Content-Length', '0')))
+				if agent.down:
+					self.close_connection = True
+					return
+				auth = self.headers.get('X-Siguwi-Auth', '')
+				nonce = auth[:NONCE_LEN]
+				mac = hmac.new(agent.key, b'\n'.join([self.command.encode(), self.path.encode(), nonce.encode(), body]), hashlib.sha256).hexdigest()
+				try:
+					fresh = abs(int(nonce[:16], 16) / 1000.0 - time.time()) <= AUTH_WINDOW
+				except ValueError:
+					fresh = False
+				if len(auth) != NONCE_LEN + 65 or auth[NONCE_LEN] != ':' or not fresh or not hmac.compare_digest(mac, auth[NONCE_LEN + 1:]):
+					self.reply(401, 'text/plain', b'Authentication required.', None)
+					self.close_connection = True
+					return
+				res = agent.handle(self.command, self.path, body)
+				if res is None:
+					self.close_connection = True
+					return
+				self.reply(res[0], res[1], res[2], mac)
+
+			def reply(self, status, contentType, body, mac):
+				self.send_response_only(status)
+				self.send_header('Content-Type', contentType)
+				self.send_header('Content-Length', str(len(body)))
+				if mac is not None:
+					sig = hmac.new(agent.key, b'\n'.join([mac.encode(), str(status).encode(), body]), hashlib.sha256).hexdigest()
+					self.send_header('X-Siguwi-Auth', sig)
+				self.end_headers()
+				self.wfile.write(body)
+
+			do_GET = serve
+			do_PUT = serve
+			do_POST = serve
+			do_DELETE = serve
+
+		return Handler
+
+
+def event(spec, fields):
+	values = spec.split(':')
+	if len(values) != fields:
+		raise argparse.ArgumentTypeError('expected %u colon separated values' % fields)
+	return (int(values[0]),) + tuple(float(v) for v in values[1:])
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Fake siguwi signing agents on loopback ports.')
+	parser.add_argument('-k', '--key', required=True, help='shared agent key file as passed to siguwi via --key')
+	parser.add_argument('-p', '--port', type=int, default=18080, help='port of the first agent; the others follow (default: 18080)')
+	parser.add_argument('-n', '--agents', type=int, default=3, help='number of agents (default: 3)')
+	parser.add_argument('-d', '--delay', type=float, default=3.0, help='signing time per file in seconds (default: 3)')
+	parser.add_argument('-f', '--fail', type=float, default=0.0, help='rate of failing signing operations (default: 0)')
+	parser.add_argument('-o', '--outage', action='append', default=[], type=lambda s: event(s, 3), metavar='AGENT:AT:FOR', help='drop all requests to the agent from AT for FOR seconds after the first submit but keep signing')
+	parser.add_argument('-r', '--restart', action='append', default=[], type=lambda s: event(s, 2), metavar='AGENT:AT', help='restart the agent AT seconds after the first submit; its items are lost')
+	parser.add_argument('-i', '--idle', type=float, default=30.0, help='exit once no file was pending for this many seconds (default: 30)')
+	args = parser.parse_args()
+	if any(e[0] < 0 or e[0] >= args.agents for e in args.outage + args.restart):
+		parser.error('unknown agent index')
+	with open(args.key, 'rb') as fp:
+		key = fp.read()
+	monitor = Monitor(args.idle)
+	agents = [Agent(i, args.port + i, key, args, monitor) for i in range(args.agents)]
+	print('agents listening on 127.0.0.1:%u to 127.0.0.1:%u' % (args.port, args.port + args.agents - 1), flush=True)
+	events = sorted([(e[1], 'down', e[0]) for e in args.outage] + [(e[1] + e[2], 'up', e[0]) for e in args.outage] + [(e[1], 'restart', e[0]) for e in args.restart])
+	while not monitor.finished(agents):
+		now = monitor.elapsed()
+		while events and now >= 0 and events[0][0] <= now:
+			at, kind, index = events.pop(0)
+			if kind == 'restart':
+				agents[index].restart()
+			else:
+				agents[index].setDown(kind == 'down')
+		time.sleep(0.1)
+	for agent in agents:
+		print('agent %u: %u files signed' % (agent.index, agent.signedCount))
+	print('%u distinct files signed' % len(monitor.signed))
+	for error in monitor.errors:
+		print('error: ' + error)
+	return 1 if monitor.errors else 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
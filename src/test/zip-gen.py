@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+# Generates the ZIP archives used by the `zip_*` tests of `siguwi-test`.
+# The records are written by hand to cover stored, deflate, data descriptor and
+# ZIP64 entries independently of `zip.c`.
+import struct
+import sys
+import zlib
+
+
+def content(name, lines):
+	return b''.join(b'line %05u of %s\n' % (k, name.encode()) for k in range(lines))
+
+
+def deflate(data):
+	c = zlib.compressobj(9, zlib.DEFLATED, -15)
+	return c.compress(data) + c.flush()
+
+
+def archive(entries, comment=b'', zip64End=False):
+	out = bytearray()
+	central = bytearray()
+	for e in entries:
+		name = e['name'].encode()
+		data = e['data']
+		comp = deflate(data) if e['method'] == 8 else data
+		crc = zlib.crc32(data) & 0xFFFFFFFF
+		size = e.get('size', len(data))
+		flags = 0x08 if e.get('descriptor') else 0
+		offset = len(out)
+		if e.get('zip64'):
+			local = struct.pack('<4s5H3I2H', b'PK\x03\x04', 45, flags, e['method'], 0, 0, crc, 0xFFFFFFFF, 0xFFFFFFFF, len(name), 20)
+			out += local + name + struct.pack('<HHQQ', 1, 16, size, len(comp))
+		elif e.get('descriptor'):
+			out += struct.pack('<4s5H3I2H', b'PK\x03\x04', 20, flags, e['method'], 0, 0, 0, 0, 0, len(name), 0) + name
+		else:
+			out += struct.pack('<4s5H3I2H', b'PK\x03\x04', 20, flags, e['method'], 0, 0, crc, len(comp), size, len(name), 0) + name
+		out += comp
+		if e.get('descriptor'):
+			out += struct.pack('<4s3I', b'PK\x07\x08', crc, len(comp), size)
+		if e.get('zip64'):
+			extra = struct.pack('<HHQQQ', 1, 24, size, len(comp), offset)
+			central += struct.pack('<4s6H3I5H2I', b'PK\x01\x02', 45, 45, flags, e['method'], 0, 0, crc, 0xFFFFFFFF, 0xFFFFFFFF, len(name), len(extra), 0, 0, 0, 0, 0xFFFFFFFF) + name + extra
+		else:
+			central += struct.pack('<4s6H3I5H2I', b'PK\x01\x02', 20, 20, flags, e['method'], 0, 0, crc, len(comp), size, len(name), 0, 0, 0, 0, 0, offset) + name
+	cdirOffset = len(out)
+	out += central
+	if zip64End:
+		end64 = len(out)
+		out += struct.pack('<4sQ2H2I4Q', b'PK\x06\x06', 44, 45, 45, 0, 0, len(entries), len(entries), len(central), cdirOffset)
+		out += struct.pack('<4sIQI', b'PK\x06\x07', 0, end64, 1)
+		out += struct.pack('<4s4H2IH', b'PK\x05\x06', 0, 0, 0xFFFF, 0xFFFF, 0xFFFFFFFF, 0xFFFFFFFF, len(comment)) + comment
+	else:
+		out += struct.pack('<4s4H2IH', b'PK\x05\x06', 0, 0, len(entries), len(entries), len(central), cdirOffset, len(comment)) + comment
+	return bytes(out)
+
+
+def main(dir):
+	sample = [
+		{'name': 'stored.exe', 'method': 0, 'data': content('stored.exe', 40)},
+		{'name': 'dir/deflate.dll', 'method': 8, 'data': content('dir/deflate.dll', 3000)},
+		{'name': 'descriptor.ps1', 'method': 8, 'data': content('descriptor.ps1', 500), 'descriptor': True},
+		{'name': 'zip64.cab', 'method': 8, 'data': content('zip64.cab', 200), 'zip64': True},
+	]
+	with open(dir + '/zip-sample.zip', 'wb') as f:
+		f.write(archive(sample, b'siguwi test', True))
+	bomb = [{'name': 'bomb.exe', 'method': 8, 'data': bytes(1 << 20), 'size': 4096}]
+	with open(dir + '/zip-bomb.zip', 'wb') as f:
+		f.write(archive(bomb))
+
+
+if __name__ == '__main__':
+	main(sys.argv[1] if len(sys.argv) > 1 else '.')
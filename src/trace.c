@@ -0,0 +1,251 @@
+/**
+ * @file trace.c
+ * @author Daniel Starke
+ * @see trace.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* for `syscall()` */
+#endif /* not _WIN32 and not _DEFAULT_SOURCE */
+#include <inttypes.h>
+#include <stdlib.h>
+#include "target.h"
+#include "trace.h"
+#ifdef PCF_IS_WIN
+#include <windows.h>
+#else /* not PCF_IS_WIN */
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif /* not PCF_IS_WIN */
+
+
+/**
+ * Set if trace events are being recorded.
+ */
+atomic_bool traceEnabled = false;
+
+
+/**
+ * List of all registered per-thread buffers.
+ */
+static _Atomic(tTraceBuffer *) traceBuffers = NULL;
+
+
+/**
+ * Trace buffer of the current thread.
+ */
+static _Thread_local tTraceBuffer * traceLocal = NULL;
+
+
+/**
+ * Number of events per thread buffer.
+ */
+static size_t traceCapacity = TRACE_DEFAULT_CAPACITY;
+
+
+/**
+ * Timestamp at `trace_start()`.
+ */
+static int64_t traceStartTs = 0;
+
+
+/**
+ * Returns the current monotonic timestamp.
+ *
+ * @return timestamp in ticks
+ */
+int64_t trace_now(void) {
+#ifdef PCF_IS_WIN
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return (int64_t)(now.QuadPart);
+#else /* not PCF_IS_WIN */
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((int64_t)(now.tv_sec) * INT64_C(1000000000)) + (int64_t)(now.tv_nsec);
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Returns the number of `trace_now()` ticks per second.
+ *
+ * @return ticks per second
+ */
+static double trace_ticksPerSecond(void) {
+#ifdef PCF_IS_WIN
+	LARGE_INTEGER freq;
+	if ( ! QueryPerformanceFrequency(&freq) || freq.QuadPart <= 0 ) {
+		return 1.0;
+	}
+	return (double)(freq.QuadPart);
+#else /* not PCF_IS_WIN */
+	return 1000000000.0;
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Returns the operating system ID of the current thread.
+ *
+ * @return thread ID
+ */
+static uint64_t trace_threadId(void) {
+#ifdef PCF_IS_WIN
+	return (uint64_t)GetCurrentThreadId();
+#else /* not PCF_IS_WIN */
+	return (uint64_t)syscall(SYS_gettid);
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Returns the trace buffer of the current thread. A new one is created and
+ * registered if needed.
+ *
+ * @return trace buffer or `NULL` on allocation error
+ */
+static tTraceBuffer * trace_getBuffer(void) {
+	if (traceLocal != NULL) {
+		return traceLocal;
+	}
+	tTraceBuffer * buf = malloc(sizeof(tTraceBuffer) + (traceCapacity * sizeof(tTraceEvent)));
+	if (buf == NULL) {
+		return NULL;
+	}
+	buf->tid = trace_threadId();
+	buf->threadName = NULL;
+	buf->capacity = traceCapacity;
+	atomic_init(&(buf->head), 0);
+	/* lock-free registration */
+	buf->next = atomic_load_explicit(&traceBuffers, memory_order_relaxed);
+	while ( ! atomic_compare_exchange_weak_explicit(&traceBuffers, &(buf->next), buf, memory_order_release, memory_order_relaxed) );
+	traceLocal = buf;
+	return buf;
+}
+
+
+/**
+ * Starts recording trace events.
+ *
+ * @param[in] capacity - number of events per thread or 0 for `TRACE_DEFAULT_CAPACITY`
+ * @return `true` on success, else `false`
+ */
+bool trace_start(const size_t capacity) {
+	traceCapacity = (capacity > 0) ? capacity : TRACE_DEFAULT_CAPACITY;
+	traceStartTs = trace_now();
+	atomic_store_explicit(&traceEnabled, true, memory_order_release);
+	return trace_getBuffer() != NULL;
+}
+
+
+/**
+ * Records a single trace event in the buffer of the current thread. The oldest
+ * event is overwritten if the buffer is full.
+ *
+ * @param[in] ph - Chrome trace event phase
+ * @param[in] cat - static category string
+ * @param[in] name - static event name string
+ * @param[in] id - asynchronous event ID
+ * @param[in] value - argument value
+ * @remarks Use the `TRACE_*` macros instead of calling this directly.
+ */
+void trace_event(const char ph, const char * cat, const char * name, const uint64_t id, const int64_t value) {
+	if ( ! atomic_load_explicit(&traceEnabled, memory_order_relaxed) ) {
+		return;
+	}
+	tTraceBuffer * buf = trace_getBuffer();
+	if (buf == NULL) {
+		return;
+	}
+	const size_t head = atomic_load_explicit(&(buf->head), memory_order_relaxed);
+	tTraceEvent * ev = buf->events + (head % buf->capacity);
+	ev->ts = trace_now();
+	ev->cat = cat;
+	ev->name = name;
+	ev->id = id;
+	ev->value = value;
+	ev->ph = ph;
+	atomic_store_explicit(&(buf->head), head + 1, memory_order_release);
+}
+
+
+/**
+ * Sets the name of the current thread as shown in the trace viewer.
+ *
+ * @param[in] name - static thread name string
+ */
+void trace_setThreadName(const char * name) {
+	if ( ! atomic_load_explicit(&traceEnabled, memory_order_relaxed) ) {
+		return;
+	}
+	tTraceBuffer * buf = trace_getBuffer();
+	if (buf != NULL) {
+		buf->threadName = name;
+	}
+}
+
+
+/**
+ * Writes all recorded events in Chrome trace event JSON format.
+ *
+ * @param[in,out] fp - output file
+ * @return `true` on success, else `false`
+ * @remarks Events recorded while writing may be incomplete.
+ * @remarks Category, name and thread name strings are written without escaping.
+ */
+bool trace_write(FILE * fp) {
+	if (fp == NULL) {
+		return false;
+	}
+	const double usPerTick = 1000000.0 / trace_ticksPerSecond();
+	int ok = fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"siguwi\"}}");
+	for (tTraceBuffer * buf = atomic_load_explicit(&traceBuffers, memory_order_acquire); buf != NULL && ok > 0; buf = buf->next) {
+		const size_t head = atomic_load_explicit(&(buf->head), memory_order_acquire);
+		const size_t start = (head > buf->capacity) ? (head - buf->capacity) : 0;
+		if (buf->threadName != NULL) {
+			ok = fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu64 ",\"args\":{\"name\":\"%s\"}}", buf->tid, buf->threadName);
+		}
+		for (size_t i = start; i < head && ok > 0; ++i) {
+			const tTraceEvent * ev = buf->events + (i % buf->capacity);
+			ok = fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%" PRIu64,
+				ev->name, ev->cat, ev->ph, (double)(ev->ts - traceStartTs) * usPerTick, buf->tid
+			);
+			switch (ev->ph) {
+			case 'i':
+				ok = (ok > 0) ? fprintf(fp, ",\"s\":\"t\",\"args\":{\"value\":%" PRIi64 "}}", ev->value) : ok;
+				break;
+			case 'b':
+			case 'e':
+				ok = (ok > 0) ? fprintf(fp, ",\"id\":\"0x%" PRIX64 "\"}", ev->id) : ok;
+				break;
+			default:
+				ok = (ok > 0) ? fprintf(fp, "}") : ok;
+				break;
+			}
+		}
+	}
+	if (ok > 0) {
+		ok = fprintf(fp, "\n]}\n");
+	}
+	return ok > 0 && fflush(fp) == 0;
+}
+
+
+/**
+ * Stops recording trace events and frees all buffers.
+ *
+ * @remarks No other thread may record events at this point.
+ */
+void trace_stop(void) {
+	atomic_store_explicit(&traceEnabled, false, memory_order_release);
+	tTraceBuffer * buf = atomic_exchange_explicit(&traceBuffers, NULL, memory_order_acq_rel);
+	while (buf != NULL) {
+		tTraceBuffer * next = buf->next;
+		free(buf);
+		buf = next;
+	}
+	traceLocal = NULL;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file trace.h
+ * @author Daniel Starke
+ * @see trace.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Default number of events per thread ring buffer.
+ */
+#define TRACE_DEFAULT_CAPACITY 65536
+
+
+/**
+ * @def TRACE_BEGIN(cat, name)
+ * Starts a duration event on the current thread.
+ *
+ * @param[in] cat - static category string
+ * @param[in] name - static event name string
+ */
+/**
+ * @def TRACE_END(cat, name)
+ * Ends the duration event started by `TRACE_BEGIN()` on the current thread.
+ *
+ * @param[in] cat - static category string
+ * @param[in] name - static event name string
+ */
+/**
+ * @def TRACE_INSTANT(cat, name, value)
+ * Records an instant event with an integral argument on the current thread.
+ *
+ * @param[in] cat - static category string
+ * @param[in] name - static event name string
+ * @param[in] value - argument value
+ */
+/**
+ * @def TRACE_ASYNC_BEGIN(cat, name, id)
+ * Starts an asynchronous event which may end on a different call stack.
+ *
+ * @param[in] cat - static category string
+ * @param[in] name - static event name string
+ * @param[in] id - event ID to match the end event
+ */
+/**
+ * @def TRACE_ASYNC_END(cat, name, id)
+ * Ends the asynchronous event with the given ID.
+ *
+ * @param[in] cat - static category string
+ * @param[in] name - static event name string
+ * @param[in] id - event ID used in `TRACE_ASYNC_BEGIN()`
+ */
+#ifdef SIGUWI_TRACE
+#define TRACE_EVENT(ph, cat, name, id, value) do { \
+		if ( atomic_load_explicit(&traceEnabled, memory_order_relaxed) ) { \
+			trace_event((ph), (cat), (name), (uint64_t)(id), (int64_t)(value)); \
+		} \
+	} while (0)
+#else /* not SIGUWI_TRACE */
+#define TRACE_EVENT(ph, cat, name, id, value) ((void)0)
+#endif /* not SIGUWI_TRACE */
+#define TRACE_BEGIN(cat, name) TRACE_EVENT('B', cat, name, 0, 0)
+#define TRACE_END(cat, name) TRACE_EVENT('E', cat, name, 0, 0)
+#define TRACE_INSTANT(cat, name, value) TRACE_EVENT('i', cat, name, 0, value)
+#define TRACE_ASYNC_BEGIN(cat, name, id) TRACE_EVENT('b', cat, name, id, 0)
+#define TRACE_ASYNC_END(cat, name, id) TRACE_EVENT('e', cat, name, id, 0)
+
+
+/**
+ * Single trace event.
+ */
+typedef struct {
+	int64_t ts; /**< timestamp in `trace_now()` ticks */
+	const char * cat; /**< static category string */
+	const char * name; /**< static event name string */
+	uint64_t id; /**< asynchronous event ID */
+	int64_t value; /**< argument value */
+	char ph; /**< Chrome trace event phase */
+} tTraceEvent;
+
+
+/**
+ * Per-thread trace event ring buffer. Only the owning thread writes to it.
+ */
+typedef struct tTraceBuffer {
+	struct tTraceBuffer * next; /**< next registered buffer */
+	uint64_t tid; /**< operating system thread ID */
+	const char * threadName; /**< static thread name string or `NULL` */
+	size_t capacity; /**< number of events in `events` */
+	atomic_size_t head; /**< total number of events written */
+	tTraceEvent events[]; /**< event ring buffer */
+} tTraceBuffer;
+
+
+extern atomic_bool traceEnabled;
+
+
+bool trace_start(const size_t capacity);
+int64_t trace_now(void);
+void trace_event(const char ph, const char * cat, const char * name, const uint64_t id, const int64_t value);
+void trace_setThreadName(const char * name);
+bool trace_write(FILE * fp);
+void trace_stop(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __TRACE_H__ */
@@ -0,0 +1,440 @@
+/**
+ * @file trigram.c
+ * @author Daniel Starke
+ * @see trigram.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Trigram index for substring searches over many documents. Each sequence of
+ * three consecutive bytes with ASCII letters folded to lower case forms a
+ * trigram. Byte trigrams keep the index small for mostly ASCII text while any
+ * UTF-8 text is still covered. The posting list of each trigram holds the
+ * variable length encoded deltas between the identifiers of the documents
+ * containing it. Documents are usually added in non-decreasing order which
+ * makes adding a document to a posting list a simple append that is skipped if
+ * the document is already the last entry. Documents completing out of order are
+ * spliced into the posting list instead. A query intersects the posting lists of
+ * all query trigrams starting with the shortest one. The result is a superset
+ * of the documents containing the query which needs to be verified by the
+ * caller.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "trigram.h"
+
+
+/**
+ * Hash table slot key tag. This distinguishes trigram 0 from an empty slot.
+ */
+#define TGI_USED UINT32_C(0x01000000)
+
+
+/**
+ * Initial number of hash table slots.
+ */
+#define TGI_INIT_SLOTS 4096
+
+
+/**
+ * Returns the ASCII lower case variant of the given byte.
+ *
+ * @param[in] b - input byte
+ * @return folded byte
+ */
+static uint32_t tgi_fold(const uint8_t b) {
+	if (b >= 'A' && b <= 'Z') {
+		return (uint32_t)(b - 'A' + 'a');
+	}
+	return b;
+}
+
+
+/**
+ * Returns the hash table slot for the given tagged trigram or the empty slot
+ * where it would be inserted.
+ *
+ * @param[in] idx - trigram index
+ * @param[in] key - tagged trigram
+ * @return hash table slot index
+ */
+static size_t tgi_slot(const tTrigramIdx * idx, const uint32_t key) {
+	const size_t mask = idx->slots - 1;
+	uint32_t h = key * UINT32_C(2654435761);
+	size_t i = (size_t)(h ^ (h >> 16)) & mask;
+	while (idx->slotKey[i] != 0 && idx->slotKey[i] != key) {
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+
+/**
+ * Doubles the number of hash table slots.
+ *
+ * @param[in,out] idx - trigram index
+ * @return `true` on success, else `false`
+ */
+static bool tgi_grow(tTrigramIdx * idx) {
+	const size_t oldSlots = idx->slots;
+	uint32_t * oldKey = idx->slotKey;
+	uint32_t * oldList = idx->slotList;
+	uint32_t * newKey = calloc(oldSlots * 2, sizeof(uint32_t));
+	uint32_t * newList = malloc(oldSlots * 2 * sizeof(uint32_t));
+	if (newKey == NULL || newList == NULL) {
+		free(newKey);
+		free(newList);
+		return false;
+	}
+	idx->slotKey = newKey;
+	idx->slotList = newList;
+	idx->slots = oldSlots * 2;
+	for (size_t i = 0; i < oldSlots; ++i) {
+		if (oldKey[i] != 0) {
+			const size_t j = tgi_slot(idx, oldKey[i]);
+			newKey[j] = oldKey[i];
+			newList[j] = oldList[i];
+		}
+	}
+	free(oldKey);
+	free(oldList);
+	return true;
+}
+
+
+/**
+ * Decodes the next document identifier delta from the given posting list
+ * position.
+ *
+ * @param[in,out] ptr - posting list position
+ * @return decoded delta
+ */
+static uint32_t tgi_getVar(const uint8_t ** ptr) {
+	const uint8_t * p = *ptr;
+	uint32_t res = 0;
+	unsigned shift = 0;
+	for (;;) {
+		const uint8_t b = *p++;
+		res |= (uint32_t)(b & 0x7F) << shift;
+		if ((b & 0x80) == 0) {
+			break;
+		}
+		shift += 7;
+	}
+	*ptr = p;
+	return res;
+}
+
+
+/**
+ * Encodes the given document identifier delta.
+ *
+ * @param[out] ptr - receives up to 5 bytes
+ * @param[in] delta - document identifier delta
+ * @return number of written bytes
+ */
+static uint32_t tgi_putVar(uint8_t * ptr, uint32_t delta) {
+	uint32_t n = 0;
+	while (delta >= 0x80) {
+		ptr[n++] = (uint8_t)((delta & 0x7F) | 0x80);
+		delta >>= 7;
+	}
+	ptr[n++] = (uint8_t)delta;
+	return n;
+}
+
+
+/**
+ * Inserts the given document in front of the last entry of the passed posting
+ * list. The delta of the following entry is re-encoded relative to the
+ * inserted document. This is only needed if documents complete out of order.
+ * The posting list needs to have room for 10 more bytes.
+ *
+ * @param[in,out] list - posting list
+ * @param[in] doc - document identifier less than `list->last`
+ * @return `true` on success, else `false`
+ */
+static bool tgi_insert(tTrigramList * list, const uint32_t doc) {
+	const uint8_t * p = list->data;
+	uint32_t prev = 0;
+	for (uint32_t i = 0; i < list->count; ++i) {
+		const uint8_t * at = p;
+		const uint32_t next = prev + tgi_getVar(&p);
+		if (next == doc) {
+			return true;
+		}
+		if (next > doc) {
+			/* replace the delta at `at` by the two deltas around `doc` */
+			uint8_t buf[10];
+			uint32_t n = tgi_putVar(buf, doc - prev);
+			n += tgi_putVar(buf + n, next - doc);
+			const uint32_t pos = (uint32_t)(at - list->data);
+			const uint32_t old = (uint32_t)(p - at);
+			memmove(list->data + pos + n, list->data + pos + old, list->len - pos - old);
+			memcpy(list->data + pos, buf, n);
+			list->len += n - old;
+			++(list->count);
+			return true;
+		}
+		prev = next;
+	}
+	return true;
+}
+
+
+/**
+ * Adds the given document to the posting list of the passed tagged trigram.
+ *
+ * @param[in,out] idx - trigram index
+ * @param[in] key - tagged trigram
+ * @param[in] doc - document identifier
+ * @return `true` on success, else `false`
+ */
+static bool tgi_post(tTrigramIdx * idx, const uint32_t key, const uint32_t doc) {
+	size_t i = tgi_slot(idx, key);
+	tTrigramList * list;
+	if (idx->slotKey[i] == 0) {
+		/* new trigram */
+		if ((idx->count + 1) * 2 > idx->slots) {
+			if ( ! tgi_grow(idx) ) {
+				return false;
+			}
+			i = tgi_slot(idx, key);
+		}
+		if (idx->count >= idx->capacity) {
+			const size_t capacity = (idx->capacity > 0) ? idx->capacity * 2 : 1024;
+			tTrigramList * lists = realloc(idx->lists, capacity * sizeof(tTrigramList));
+			if (lists == NULL) {
+				return false;
+			}
+			idx->lists = lists;
+			idx->capacity = capacity;
+		}
+		list = idx->lists + idx->count;
+		memset(list, 0, sizeof(*list));
+		list->key = key;
+		idx->slotKey[i] = key;
+		idx->slotList[i] = (uint32_t)(idx->count++);
+	} else {
+		list = idx->lists + idx->slotList[i];
+		if (list->count > 0 && list->last == doc) {
+			return true;
+		}
+	}
+	if ((list->len + 10) > list->cap) {
+		const uint32_t cap = (list->cap > 0) ? list->cap * 2 : 8;
+		uint8_t * data = realloc(list->data, cap);
+		if (data == NULL) {
+			return false;
+		}
+		idx->bytes += (size_t)(cap - list->cap);
+		list->data = data;
+		list->cap = cap;
+	}
+	if (list->count > 0 && doc < list->last) {
+		return tgi_insert(list, doc);
+	}
+	list->len += tgi_putVar(list->data + list->len, doc - list->last);
+	list->last = doc;
+	++(list->count);
+	return true;
+}
+
+
+/**
+ * Orders posting lists by ascending number of documents.
+ *
+ * @param[in] lhs - left-hand side posting list pointer
+ * @param[in] rhs - right-hand side posting list pointer
+ * @return comparison result
+ */
+static int tgi_cmpCount(const void * lhs, const void * rhs) {
+	const tTrigramList * a = *(const tTrigramList * const *)lhs;
+	const tTrigramList * b = *(const tTrigramList * const *)rhs;
+	return (a->count > b->count) - (a->count < b->count);
+}
+
+
+/**
+ * Creates a new empty trigram index.
+ *
+ * @return created trigram index or `NULL` on error
+ */
+tTrigramIdx * tgi_create(void) {
+	tTrigramIdx * idx = calloc(1, sizeof(tTrigramIdx));
+	if (idx == NULL) {
+		return NULL;
+	}
+	idx->slotKey = calloc(TGI_INIT_SLOTS, sizeof(uint32_t));
+	idx->slotList = malloc(TGI_INIT_SLOTS * sizeof(uint32_t));
+	if (idx->slotKey == NULL || idx->slotList == NULL) {
+		tgi_delete(idx);
+		return NULL;
+	}
+	idx->slots = TGI_INIT_SLOTS;
+	return idx;
+}
+
+
+/**
+ * Deletes the given trigram index.
+ *
+ * @param[in,out] idx - trigram index to delete
+ */
+void tgi_delete(tTrigramIdx * idx) {
+	if (idx == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < idx->count; ++i) {
+		free(idx->lists[i].data);
+	}
+	free(idx->lists);
+	free(idx->slotKey);
+	free(idx->slotList);
+	free(idx);
+}
+
+
+/**
+ * Adds the trigrams of the given document chunk to the index. Trigrams
+ * spanning multiple chunks are indexed as long as the same state variable is
+ * passed for each chunk of the document. Adding documents in ascending order is
+ * fastest but not required.
+ *
+ * @param[in,out] idx - trigram index
+ * @param[in] doc - document identifier
+ * @param[in,out] state - feeding state of the document; initially `TGI_START`
+ * @param[in] data - document chunk
+ * @param[in] len - length of `data` in bytes
+ * @return `true` on success, else `false`
+ */
+bool tgi_add(tTrigramIdx * idx, const uint32_t doc, uint32_t * state, const uint8_t * data, const size_t len) {
+	if (idx == NULL || state == NULL || (data == NULL && len > 0) || doc == UINT32_MAX) {
+		return false;
+	}
+	if (doc >= idx->docs) {
+		idx->docs = doc + 1;
+	}
+	uint32_t have = *state >> 16;
+	uint32_t key = *state & 0xFFFF;
+	uint32_t prev = 0;
+	bool res = true;
+	for (size_t i = 0; i < len; ++i) {
+		key = ((key << 8) | tgi_fold(data[i])) & 0xFFFFFF;
+		if (have < 2) {
+			++have;
+			continue;
+		}
+		const uint32_t tagged = key | TGI_USED;
+		if (tagged == prev) {
+			/* runs of the same byte */
+			continue;
+		}
+		prev = tagged;
+		if ( ! tgi_post(idx, tagged, doc) ) {
+			res = false;
+		}
+	}
+	*state = (have << 16) | (key & 0xFFFF);
+	return res;
+}
+
+
+/**
+ * Returns the documents which may contain the given query. Queries shorter
+ * than a trigram return all documents. The caller needs to verify each
+ * returned document.
+ *
+ * @param[in] idx - trigram index
+ * @param[in] query - query bytes
+ * @param[in] len - length of `query` in bytes
+ * @param[out] docs - receives the ascending candidate document identifiers; free with `free()`
+ * @param[out] count - receives the number of candidate documents
+ * @return `true` on success, else `false`
+ */
+bool tgi_query(const tTrigramIdx * idx, const uint8_t * query, const size_t len, uint32_t ** docs, size_t * count) {
+	if (idx == NULL || (query == NULL && len > 0) || docs == NULL || count == NULL) {
+		return false;
+	}
+	*docs = NULL;
+	*count = 0;
+	if (len < 3) {
+		if (idx->docs == 0) {
+			return true;
+		}
+		uint32_t * res = malloc(idx->docs * sizeof(uint32_t));
+		if (res == NULL) {
+			return false;
+		}
+		for (uint32_t i = 0; i < idx->docs; ++i) {
+			res[i] = i;
+		}
+		*docs = res;
+		*count = idx->docs;
+		return true;
+	}
+	/* collect the distinct posting lists of all query trigrams */
+	const tTrigramList ** lists = malloc((len - 2) * sizeof(*lists));
+	if (lists == NULL) {
+		return false;
+	}
+	size_t used = 0;
+	uint32_t key = (tgi_fold(query[0]) << 8) | tgi_fold(query[1]);
+	for (size_t i = 2; i < len; ++i) {
+		key = ((key << 8) | tgi_fold(query[i])) & 0xFFFFFF;
+		const uint32_t tagged = key | TGI_USED;
+		const size_t slot = tgi_slot(idx, tagged);
+		if (idx->slotKey[slot] == 0) {
+			/* unknown trigram */
+			free(lists);
+			return true;
+		}
+		const tTrigramList * list = idx->lists + idx->slotList[slot];
+		bool found = false;
+		for (size_t j = 0; j < used && ( ! found ); ++j) {
+			found = (lists[j] == list);
+		}
+		if ( ! found ) {
+			lists[used++] = list;
+		}
+	}
+	qsort(lists, used, sizeof(*lists), tgi_cmpCount);
+	/* decode the shortest list and intersect it with the others */
+	uint32_t * res = malloc(lists[0]->count * sizeof(uint32_t));
+	if (res == NULL) {
+		free(lists);
+		return false;
+	}
+	size_t n = 0;
+	uint32_t doc = 0;
+	const uint8_t * p = lists[0]->data;
+	for (uint32_t i = 0; i < lists[0]->count; ++i) {
+		doc += tgi_getVar(&p);
+		res[n++] = doc;
+	}
+	for (size_t j = 1; j < used && n > 0; ++j) {
+		const tTrigramList * list = lists[j];
+		size_t k = 0;
+		size_t out = 0;
+		doc = 0;
+		p = list->data;
+		for (uint32_t i = 0; i < list->count && k < n; ++i) {
+			doc += tgi_getVar(&p);
+			while (k < n && res[k] < doc) {
+				++k;
+			}
+			if (k < n && res[k] == doc) {
+				res[out++] = doc;
+				++k;
+			}
+		}
+		n = out;
+	}
+	free(lists);
+	if (n == 0) {
+		free(res);
+		return true;
+	}
+	*docs = res;
+	*count = n;
+	return true;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file trigram.h
+ * @author Daniel Starke
+ * @see trigram.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __TRIGRAM_H__
+#define __TRIGRAM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Initial feeding state of a document. The state can be carried over from one
+ * call of `tgi_add()` to the next to index trigrams across chunk boundaries.
+ */
+#define TGI_START 0
+
+
+/**
+ * Posting list of a single trigram.
+ */
+typedef struct {
+	uint32_t key; /**< folded trigram */
+	uint32_t last; /**< last added document identifier */
+	uint32_t count; /**< number of documents */
+	uint32_t len; /**< number of bytes in `data` */
+	uint32_t cap; /**< capacity of `data` in bytes */
+	uint8_t * data; /**< variable length encoded document identifier deltas */
+} tTrigramList;
+
+
+/**
+ * Incrementally built inverted index from byte trigrams to the documents
+ * containing them. Document identifiers are preferably added in non-decreasing
+ * order.
+ */
+typedef struct {
+	uint32_t * slotKey; /**< hash table slot keys; 0 for empty slots */
+	uint32_t * slotList; /**< hash table slot posting list index */
+	size_t slots; /**< number of hash table slots (power of two) */
+	tTrigramList * lists; /**< posting lists */
+	size_t count; /**< number of posting lists */
+	size_t capacity; /**< capacity of `lists` */
+	uint32_t docs; /**< highest added document identifier plus one */
+	size_t bytes; /**< total number of posting list bytes */
+} tTrigramIdx;
+
+
+tTrigramIdx * tgi_create(void);
+void tgi_delete(tTrigramIdx * idx);
+bool tgi_add(tTrigramIdx * idx, const uint32_t doc, uint32_t * state, const uint8_t * data, const size_t len);
+bool tgi_query(const tTrigramIdx * idx, const uint8_t * query, const size_t len, uint32_t ** docs, size_t * count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __TRIGRAM_H__ */
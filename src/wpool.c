@@ -0,0 +1,291 @@
+/**
+ * @file wpool.c
+ * @author Daniel Starke
+ * @see wpool.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Fixed size pool of worker threads. Items are taken from a FIFO queue and
+ * moved to a list of finished items once processed. The finished items are
+ * collected by the owner of the pool, which is notified through a callback.
+ */
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* for `sysconf(_SC_NPROCESSORS_ONLN)` */
+#endif /* not _WIN32 and not _DEFAULT_SOURCE */
+#include <stdlib.h>
+#include "wpool.h"
+#ifdef PCF_IS_WIN
+#include <windows.h>
+#else /* not PCF_IS_WIN */
+#include <pthread.h>
+#include <unistd.h>
+#endif /* not PCF_IS_WIN */
+
+
+/**
+ * Worker thread pool handle.
+ */
+struct tWorkPool {
+#ifdef PCF_IS_WIN
+	CRITICAL_SECTION lock; /**< guards `queue`, `queueTail`, `done` and `stop` */
+	CONDITION_VARIABLE wake; /**< signaled for new items and on shutdown */
+	HANDLE hThreads[WPOOL_MAX_THREADS]; /**< worker threads */
+#else /* not PCF_IS_WIN */
+	pthread_mutex_t lock; /**< guards `queue`, `queueTail`, `done` and `stop` */
+	pthread_cond_t wake; /**< signaled for new items and on shutdown */
+	pthread_t hThreads[WPOOL_MAX_THREADS]; /**< worker threads */
+#endif /* not PCF_IS_WIN */
+	size_t threads; /**< number of worker threads */
+	WorkPoolRun run; /**< item processing callback */
+	WorkPoolNotify notify; /**< finished item callback or `NULL` */
+	void * param; /**< user defined callback parameter */
+	tWorkItem * queue; /**< first queued item or `NULL` */
+	tWorkItem * queueTail; /**< last queued item or `NULL` */
+	tWorkItem * done; /**< finished items or `NULL` */
+	bool stop; /**< set to finish the worker threads */
+};
+
+
+#ifdef PCF_IS_WIN
+#define wpool_lock(pool) EnterCriticalSection(&((pool)->lock))
+#define wpool_unlock(pool) LeaveCriticalSection(&((pool)->lock))
+#define wpool_wait(pool) SleepConditionVariableCS(&((pool)->wake), &((pool)->lock), INFINITE)
+#define wpool_wakeOne(pool) WakeConditionVariable(&((pool)->wake))
+#define wpool_wakeAll(pool) WakeAllConditionVariable(&((pool)->wake))
+#else /* not PCF_IS_WIN */
+#define wpool_lock(pool) pthread_mutex_lock(&((pool)->lock))
+#define wpool_unlock(pool) pthread_mutex_unlock(&((pool)->lock))
+#define wpool_wait(pool) pthread_cond_wait(&((pool)->wake), &((pool)->lock))
+#define wpool_wakeOne(pool) pthread_cond_signal(&((pool)->wake))
+#define wpool_wakeAll(pool) pthread_cond_broadcast(&((pool)->wake))
+#endif /* not PCF_IS_WIN */
+
+
+/**
+ * Worker thread loop. Items are taken from the queue, processed and moved to
+ * the list of finished items.
+ *
+ * @param[in,out] pool - worker thread pool
+ */
+static void wpool_loop(tWorkPool * pool) {
+	wpool_lock(pool);
+	for (;;) {
+		while (( ! pool->stop ) && pool->queue == NULL) {
+			wpool_wait(pool);
+		}
+		if ( pool->stop ) {
+			break;
+		}
+		tWorkItem * item = pool->queue;
+		pool->queue = item->next;
+		if (pool->queue == NULL) {
+			pool->queueTail = NULL;
+		}
+		wpool_unlock(pool);
+		pool->run(item, pool->param);
+		wpool_lock(pool);
+		item->next = pool->done;
+		pool->done = item;
+		if (pool->notify != NULL) {
+			pool->notify(pool->param);
+		}
+	}
+	wpool_unlock(pool);
+}
+
+
+#ifdef PCF_IS_WIN
+/**
+ * Worker thread entry point.
+ *
+ * @param[in,out] param - worker thread pool
+ * @return always 0
+ */
+static DWORD WINAPI wpool_thread(LPVOID param) {
+	wpool_loop((tWorkPool *)param);
+	return 0;
+}
+#else /* not PCF_IS_WIN */
+/**
+ * Worker thread entry point.
+ *
+ * @param[in,out] param - worker thread pool
+ * @return always `NULL`
+ */
+static void * wpool_thread(void * param) {
+	wpool_loop((tWorkPool *)param);
+	return NULL;
+}
+#endif /* not PCF_IS_WIN */
+
+
+/**
+ * Returns the number of logical processors.
+ *
+ * @return number of logical processors (at least 1)
+ */
+size_t wpool_cpus(void) {
+#ifdef PCF_IS_WIN
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return (si.dwNumberOfProcessors > 0) ? (size_t)(si.dwNumberOfProcessors) : 1;
+#else /* not PCF_IS_WIN */
+	const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	return (cpus > 0) ? (size_t)cpus : 1;
+#endif /* not PCF_IS_WIN */
+}
+
+
+/**
+ * Creates a new worker thread pool. One thread per logical processor is
+ * started up to the given limit.
+ *
+ * @param[in] maxThreads - maximum number of worker threads (1 to `WPOOL_MAX_THREADS`)
+ * @param[in] run - item processing callback
+ * @param[in] notify - finished item callback or `NULL`
+ * @param[in,out] param - user defined callback parameter
+ * @return worker thread pool or `NULL` on error
+ */
+tWorkPool * wpool_create(const size_t maxThreads, WorkPoolRun run, WorkPoolNotify notify, void * param) {
+	if (maxThreads < 1 || maxThreads > WPOOL_MAX_THREADS || run == NULL) {
+		return NULL;
+	}
+	tWorkPool * pool = calloc(1, sizeof(tWorkPool));
+	if (pool == NULL) {
+		return NULL;
+	}
+	pool->run = run;
+	pool->notify = notify;
+	pool->param = param;
+#ifdef PCF_IS_WIN
+	InitializeCriticalSection(&(pool->lock));
+	InitializeConditionVariable(&(pool->wake));
+#else /* not PCF_IS_WIN */
+	if (pthread_mutex_init(&(pool->lock), NULL) != 0) {
+		free(pool);
+		return NULL;
+	}
+	if (pthread_cond_init(&(pool->wake), NULL) != 0) {
+		pthread_mutex_destroy(&(pool->lock));
+		free(pool);
+		return NULL;
+	}
+#endif /* not PCF_IS_WIN */
+	const size_t cpus = wpool_cpus();
+	const size_t count = (cpus < maxThreads) ? cpus : maxThreads;
+	while (pool->threads < count) {
+#ifdef PCF_IS_WIN
+		const HANDLE hThread = CreateThread(NULL, 0, wpool_thread, pool, 0, NULL);
+		if (hThread == NULL) {
+			break;
+		}
+		pool->hThreads[pool->threads] = hThread;
+#else /* not PCF_IS_WIN */
+		if (pthread_create(pool->hThreads + pool->threads, NULL, wpool_thread, pool) != 0) {
+			break;
+		}
+#endif /* not PCF_IS_WIN */
+		++(pool->threads);
+	}
+	if (pool->threads == 0) {
+		wpool_delete(pool);
+		return NULL;
+	}
+	return pool;
+}
+
+
+/**
+ * Adds the given item to the end of the queue.
+ *
+ * @param[in,out] pool - worker thread pool
+ * @param[in,out] item - work item
+ * @return `true` on success, else `false`
+ */
+bool wpool_push(tWorkPool * pool, tWorkItem * item) {
+	if (pool == NULL || item == NULL) {
+		return false;
+	}
+	item->next = NULL;
+	wpool_lock(pool);
+	if (pool->queueTail != NULL) {
+		pool->queueTail->next = item;
+	} else {
+		pool->queue = item;
+	}
+	pool->queueTail = item;
+	wpool_unlock(pool);
+	wpool_wakeOne(pool);
+	return true;
+}
+
+
+/**
+ * Takes all finished items. The most recently finished item comes first.
+ *
+ * @param[in,out] pool - worker thread pool
+ * @return list of finished items or `NULL` if none
+ */
+tWorkItem * wpool_done(tWorkPool * pool) {
+	if (pool == NULL) {
+		return NULL;
+	}
+	wpool_lock(pool);
+	tWorkItem * item = pool->done;
+	pool->done = NULL;
+	wpool_unlock(pool);
+	return item;
+}
+
+
+/**
+ * Returns the number of worker threads.
+ *
+ * @param[in] pool - worker thread pool
+ * @return number of worker threads
+ */
+size_t wpool_threads(const tWorkPool * pool) {
+	return (pool != NULL) ? pool->threads : 0;
+}
+
+
+/**
+ * Stops the worker threads and frees the pool. Items being processed are
+ * finished first. Queued items are not processed anymore.
+ *
+ * @param[in,out] pool - worker thread pool
+ * @return list of the remaining items (queued ones in order followed by the finished ones) or `NULL` if none
+ */
+tWorkItem * wpool_delete(tWorkPool * pool) {
+	if (pool == NULL) {
+		return NULL;
+	}
+	wpool_lock(pool);
+	pool->stop = true;
+	wpool_unlock(pool);
+	wpool_wakeAll(pool);
+#ifdef PCF_IS_WIN
+	if (pool->threads > 0) {
+		WaitForMultipleObjects((DWORD)(pool->threads), pool->hThreads, TRUE, INFINITE);
+	}
+	for (size_t i = 0; i < pool->threads; ++i) {
+		CloseHandle(pool->hThreads[i]);
+	}
+	DeleteCriticalSection(&(pool->lock));
+#else /* not PCF_IS_WIN */
+	for (size_t i = 0; i < pool->threads; ++i) {
+		pthread_join(pool->hThreads[i], NULL);
+	}
+	pthread_cond_destroy(&(pool->wake));
+	pthread_mutex_destroy(&(pool->lock));
+#endif /* not PCF_IS_WIN */
+	/* the threads are gone; no locking needed anymore */
+	tWorkItem * list = pool->queue;
+	if (pool->queueTail != NULL) {
+		pool->queueTail->next = pool->done;
+	} else {
+		list = pool->done;
+	}
+	free(pool);
+	return list;
+}
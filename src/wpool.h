@@ -0,0 +1,73 @@
+/**
+ * @file wpool.h
+ * @author Daniel Starke
+ * @see wpool.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __WPOOL_H__
+#define __WPOOL_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "target.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Maximum number of worker threads per pool.
+ */
+#define WPOOL_MAX_THREADS 64
+
+
+/**
+ * Single work item. It is embedded as first member into the actual job.
+ */
+typedef struct tWorkItem {
+	struct tWorkItem * next; /**< next item in the same list */
+} tWorkItem;
+
+
+/**
+ * Processes the given work item. This is called by a worker thread without
+ * holding the pool lock.
+ *
+ * @param[in,out] item - work item
+ * @param[in,out] param - user defined parameter
+ */
+typedef void (* WorkPoolRun)(tWorkItem * item, void * param);
+
+
+/**
+ * Signals that a work item was moved to the list of finished items. This is
+ * called by a worker thread while holding the pool lock.
+ *
+ * @param[in,out] param - user defined parameter
+ */
+typedef void (* WorkPoolNotify)(void * param);
+
+
+/**
+ * Opaque worker thread pool handle.
+ */
+typedef struct tWorkPool tWorkPool;
+
+
+size_t wpool_cpus(void);
+tWorkPool * wpool_create(const size_t maxThreads, WorkPoolRun run, WorkPoolNotify notify, void * param);
+bool wpool_push(tWorkPool * pool, tWorkItem * item);
+tWorkItem * wpool_done(tWorkPool * pool);
+size_t wpool_threads(const tWorkPool * pool);
+tWorkItem * wpool_delete(tWorkPool * pool);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __WPOOL_H__ */
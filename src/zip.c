@@ -0,0 +1,1009 @@
+/**
+ * @file zip.c
+ * @author Daniel Starke
+ * @see zip.h
+ * @date 2026-10-18
+ * @version 2026-10-18
+ *
+ * Streaming ZIP archive access. Entries are extracted one at a time and
+ * archives are rewritten by copying the compressed data of all unchanged
+ * entries verbatim. Replaced entries are stored uncompressed. ZIP64 archives
+ * are supported. Encrypted entries, multi-volume archives and compression
+ * methods other than stored and deflate are not.
+ */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "crc32.h"
+#include "target.h"
+#include "zip.h"
+
+
+#ifdef PCF_IS_WIN
+#define ZIP_SEEK(fp, off) _fseeki64((fp), (int64_t)(off), SEEK_SET)
+#define ZIP_SEEK_END(fp) _fseeki64((fp), 0, SEEK_END)
+#define ZIP_TELL(fp) _ftelli64(fp)
+#else /* not PCF_IS_WIN */
+#define ZIP_SEEK(fp, off) fseeko((fp), (off_t)(off), SEEK_SET)
+#define ZIP_SEEK_END(fp) fseeko((fp), 0, SEEK_END)
+#define ZIP_TELL(fp) ((int64_t)ftello(fp))
+#endif /* not PCF_IS_WIN */
+
+
+/* record signatures */
+#define ZIP_SIG_LOCAL 0x04034B50
+#define ZIP_SIG_CENTRAL 0x02014B50
+#define ZIP_SIG_DESCRIPTOR 0x08074B50
+#define ZIP_SIG_END 0x06054B50
+#define ZIP_SIG_END64 0x06064B50
+#define ZIP_SIG_LOCATOR64 0x07064B50
+
+/* record sizes without variable length fields */
+#define ZIP_LOCAL_LEN 30
+#define ZIP_CENTRAL_LEN 46
+#define ZIP_END_LEN 22
+#define ZIP_END64_LEN 56
+#define ZIP_LOCATOR64_LEN 20
+
+/* general purpose bit flags */
+#define ZIP_FLAG_ENCRYPTED 0x0001
+#define ZIP_FLAG_DESCRIPTOR 0x0008
+
+/** ZIP64 extended information extra field tag. */
+#define ZIP_EXTRA_ZIP64 0x0001
+
+/** Minimum version needed to extract entries with ZIP64 extended information (4.5). */
+#define ZIP_VERSION_ZIP64 45
+
+/** Value of 32-bit fields which are given in the ZIP64 extra field. */
+#define ZIP_MAX32 UINT32_C(0xFFFFFFFF)
+
+/** Value of 16-bit fields which are given in the ZIP64 end of central directory record. */
+#define ZIP_MAX16 0xFFFF
+
+/** Copy buffer size in bytes. */
+#define ZIP_BUF_SIZE 65536
+
+/** Deflate window size in bytes (power of two). */
+#define ZIP_WINDOW 32768
+
+
+/**
+ * Canonical Huffman decoding table.
+ */
+typedef struct {
+	uint16_t count[16]; /**< number of symbols per code length */
+	uint16_t symbol[288]; /**< symbols ordered by code */
+} tZipHuffman;
+
+
+/**
+ * Streaming inflate context.
+ */
+typedef struct {
+	FILE * in; /**< compressed input */
+	uint64_t left; /**< compressed bytes not yet read from `in` */
+	size_t inPos; /**< read position in `inBuf` */
+	size_t inLen; /**< number of bytes in `inBuf` */
+	uint32_t bitBuf; /**< pending input bits */
+	unsigned bitCnt; /**< number of bits in `bitBuf` */
+	bool error; /**< input ended prematurely or the data is invalid */
+	FILE * out; /**< decompressed output */
+	size_t winPos; /**< write position in `win` */
+	uint64_t total; /**< number of decompressed bytes */
+	uint64_t limit; /**< expected number of decompressed bytes */
+	uint32_t crc; /**< running CRC-32 of the decompressed data */
+	uint8_t inBuf[ZIP_BUF_SIZE];
+	uint8_t win[ZIP_WINDOW]; /**< output ring buffer which is also the back-reference window */
+} tZipInflate;
+
+
+static uint16_t zipRd16(const uint8_t * p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+
+static uint32_t zipRd32(const uint8_t * p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+static uint64_t zipRd64(const uint8_t * p) {
+	return (uint64_t)zipRd32(p) | ((uint64_t)zipRd32(p + 4) << 32);
+}
+
+
+static void zipWr16(uint8_t * p, const uint16_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+}
+
+
+static void zipWr32(uint8_t * p, const uint32_t v) {
+	zipWr16(p, (uint16_t)v);
+	zipWr16(p + 2, (uint16_t)(v >> 16));
+}
+
+
+static void zipWr64(uint8_t * p, const uint64_t v) {
+	zipWr32(p, (uint32_t)v);
+	zipWr32(p + 4, (uint32_t)(v >> 32));
+}
+
+
+/**
+ * Reads exactly the given number of bytes at the given archive offset.
+ *
+ * @param[in] fp - archive stream
+ * @param[in] off - absolute offset
+ * @param[out] buf - output buffer
+ * @param[in] len - number of bytes to read
+ * @return `true` on success, else `false`
+ */
+static bool zipReadAt(FILE * fp, const uint64_t off, void * buf, const size_t len) {
+	return ZIP_SEEK(fp, off) == 0 && fread(buf, 1, len, fp) == len;
+}
+
+
+/**
+ * Copies the given number of bytes between the current stream positions and
+ * optionally updates a running CRC-32.
+ *
+ * @param[in] in - input stream
+ * @param[in] out - output stream
+ * @param[in] len - number of bytes to copy
+ * @param[in,out] crc - running CRC-32 or `NULL`
+ * @return `true` on success, else `false`
+ */
+static bool zipCopy(FILE * in, FILE * out, uint64_t len, uint32_t * crc) {
+	uint8_t * buf = (uint8_t *)malloc(ZIP_BUF_SIZE);
+	if (buf == NULL) {
+		return false;
+	}
+	bool res = true;
+	while (len > 0) {
+		const size_t n = (size_t)PCF_MIN(len, (uint64_t)ZIP_BUF_SIZE);
+		if (fread(buf, 1, n, in) != n || fwrite(buf, 1, n, out) != n) {
+			res = false;
+			break;
+		}
+		if (crc != NULL) {
+			*crc = crc32Update(*crc, buf, n);
+		}
+		len -= n;
+	}
+	free(buf);
+	return res;
+}
+
+
+/**
+ * Looks up the ZIP64 extended information of a central directory record and
+ * replaces the 32-bit placeholder values of the given entry with it.
+ *
+ * @param[in,out] e - entry
+ * @param[in] extra - extra field data
+ * @param[in] len - length of `extra` in bytes
+ * @return `true` on success, else `false` if required values are missing
+ */
+static bool zipParseZip64(tZipEntry * e, const uint8_t * extra, size_t len) {
+	const bool needSize = (e->size == ZIP_MAX32);
+	const bool needCompSize = (e->compSize == ZIP_MAX32);
+	const bool needOffset = (e->localOffset == ZIP_MAX32);
+	if ( ! (needSize || needCompSize || needOffset) ) {
+		return true;
+	}
+	while (len >= 4) {
+		const uint16_t tag = zipRd16(extra);
+		const uint16_t n = zipRd16(extra + 2);
+		if ((size_t)n + 4 > len) {
+			break;
+		}
+		if (tag == ZIP_EXTRA_ZIP64) {
+			const uint8_t * p = extra + 4;
+			size_t avail = n;
+			if ( needSize ) {
+				if (avail < 8) return false;
+				e->size = zipRd64(p);
+				p += 8;
+				avail -= 8;
+			}
+			if ( needCompSize ) {
+				if (avail < 8) return false;
+				e->compSize = zipRd64(p);
+				p += 8;
+				avail -= 8;
+			}
+			if ( needOffset ) {
+				if (avail < 8) return false;
+				e->localOffset = zipRd64(p);
+			}
+			e->zip64 = true;
+			return true;
+		}
+		extra += 4 + n;
+		len -= 4 + (size_t)n;
+	}
+	return false;
+}
+
+
+/**
+ * Opens the given archive by reading its central directory.
+ *
+ * @param[in] fp - seekable binary archive stream (remains owned by the caller)
+ * @return archive handle or `NULL` on error
+ */
+tZip * zip_open(FILE * fp) {
+	if (fp == NULL || ZIP_SEEK_END(fp) != 0) {
+		return NULL;
+	}
+	const int64_t fileSize = ZIP_TELL(fp);
+	if (fileSize < ZIP_END_LEN) {
+		return NULL;
+	}
+	tZip * z = (tZip *)calloc(1, sizeof(tZip));
+	uint8_t * tail = NULL;
+	if (z == NULL) {
+		return NULL;
+	}
+	z->fp = fp;
+	/* find the end of central directory record (followed by up to 64 KiB comment) */
+	const size_t tailLen = (size_t)PCF_MIN(fileSize, (int64_t)(ZIP_END_LEN + ZIP_MAX16));
+	const uint64_t tailStart = (uint64_t)fileSize - tailLen;
+	tail = (uint8_t *)malloc(tailLen);
+	if (tail == NULL || ( ! zipReadAt(fp, tailStart, tail, tailLen) )) {
+		goto onError;
+	}
+	size_t endPos = tailLen - ZIP_END_LEN + 1;
+	do {
+		--endPos;
+		if (zipRd32(tail + endPos) == ZIP_SIG_END && (size_t)zipRd16(tail + endPos + 20) == tailLen - endPos - ZIP_END_LEN) {
+			break;
+		}
+	} while (endPos > 0);
+	const uint8_t * end = tail + endPos;
+	if (zipRd32(end) != ZIP_SIG_END || zipRd16(end + 4) != 0 || zipRd16(end + 6) != 0) {
+		goto onError; /* missing or multi-volume */
+	}
+	uint64_t count = zipRd16(end + 10);
+	uint64_t cdirLen = zipRd32(end + 12);
+	uint64_t cdirOffset = zipRd32(end + 16);
+	z->commentLen = zipRd16(end + 20);
+	if (z->commentLen > 0) {
+		z->comment = (uint8_t *)malloc(z->commentLen);
+		if (z->comment == NULL) {
+			goto onError;
+		}
+		memcpy(z->comment, end + ZIP_END_LEN, z->commentLen);
+	}
+	if (count == ZIP_MAX16 || cdirLen == ZIP_MAX32 || cdirOffset == ZIP_MAX32) {
+		/* ZIP64 end of central directory record */
+		uint8_t rec[ZIP_END64_LEN];
+		const uint64_t endOffset = tailStart + endPos;
+		if (endOffset < ZIP_LOCATOR64_LEN || ( ! zipReadAt(fp, endOffset - ZIP_LOCATOR64_LEN, rec, ZIP_LOCATOR64_LEN) ) || zipRd32(rec) != ZIP_SIG_LOCATOR64) {
+			goto onError;
+		}
+		if ( ! zipReadAt(fp, zipRd64(rec + 8), rec, ZIP_END64_LEN) || zipRd32(rec) != ZIP_SIG_END64) {
+			goto onError;
+		}
+		count = zipRd64(rec + 32);
+		cdirLen = zipRd64(rec + 40);
+		cdirOffset = zipRd64(rec + 48);
+	}
+	free(tail);
+	tail = NULL;
+	/* compared separately as crafted ZIP64 values may overflow their sum */
+	if (cdirLen > SIZE_MAX || count > cdirLen / ZIP_CENTRAL_LEN || cdirOffset > (uint64_t)fileSize || cdirLen > (uint64_t)fileSize - cdirOffset) {
+		goto onError;
+	}
+	/* read and parse the central directory */
+	z->cdirLen = (size_t)cdirLen;
+	z->cdir = (uint8_t *)malloc(z->cdirLen + 1);
+	z->entries = (tZipEntry *)calloc((size_t)count + 1, sizeof(tZipEntry));
+	if (z->cdir == NULL || z->entries == NULL || ( ! zipReadAt(fp, cdirOffset, z->cdir, z->cdirLen) )) {
+		goto onError;
+	}
+	size_t pos = 0;
+	for (z->count = 0; z->count < (size_t)count; ++(z->count)) {
+		tZipEntry * e = z->entries + z->count;
+		const uint8_t * rec = z->cdir + pos;
+		if (pos + ZIP_CENTRAL_LEN > z->cdirLen || zipRd32(rec) != ZIP_SIG_CENTRAL) {
+			goto onError;
+		}
+		const size_t nameLen = zipRd16(rec + 28);
+		const size_t extraLen = zipRd16(rec + 30);
+		const size_t commentLen = zipRd16(rec + 32);
+		e->cdirOffset = pos;
+		e->cdirLen = ZIP_CENTRAL_LEN + nameLen + extraLen + commentLen;
+		if (pos + e->cdirLen > z->cdirLen) {
+			goto onError;
+		}
+		e->flags = zipRd16(rec + 8);
+		e->method = zipRd16(rec + 10);
+		e->crc = zipRd32(rec + 16);
+		e->compSize = zipRd32(rec + 20);
+		e->size = zipRd32(rec + 24);
+		e->localOffset = zipRd32(rec + 42);
+		e->name = (char *)malloc(nameLen + 1);
+		if (e->name == NULL) {
+			goto onError;
+		}
+		memcpy(e->name, rec + ZIP_CENTRAL_LEN, nameLen);
+		e->name[nameLen] = 0;
+		if ( ! zipParseZip64(e, rec + ZIP_CENTRAL_LEN + nameLen, extraLen) ) {
+			++(z->count); /* free the name */
+			goto onError;
+		}
+		pos += e->cdirLen;
+	}
+	return z;
+onError:
+	free(tail);
+	zip_close(z);
+	return NULL;
+}
+
+
+/**
+ * Checks whether the given entry is encrypted. Encrypted entries can only be
+ * copied verbatim.
+ *
+ * @param[in] entry - archive entry
+ * @return `true` if encrypted, else `false`
+ */
+bool zip_isEncrypted(const tZipEntry * entry) {
+	return entry != NULL && (entry->flags & ZIP_FLAG_ENCRYPTED) != 0;
+}
+
+
+/**
+ * Returns the offset of the entry data after the local file header.
+ *
+ * @param[in] z - archive
+ * @param[in] e - entry
+ * @param[out] dataOffset - receives the data offset
+ * @return `true` on success, else `false`
+ */
+static bool zipDataOffset(tZip * z, const tZipEntry * e, uint64_t * dataOffset) {
+	uint8_t hdr[ZIP_LOCAL_LEN];
+	if ( ! zipReadAt(z->fp, e->localOffset, hdr, sizeof(hdr)) || zipRd32(hdr) != ZIP_SIG_LOCAL ) {
+		return false;
+	}
+	*dataOffset = e->localOffset + ZIP_LOCAL_LEN + zipRd16(hdr + 26) + zipRd16(hdr + 28);
+	return true;
+}
+
+
+/**
+ * Returns the next compressed input byte.
+ *
+ * @param[in,out] s - inflate context
+ * @return next byte or 0 with `s->error` set at the end of the input
+ */
+static uint8_t zipInByte(tZipInflate * s) {
+	if (s->inPos >= s->inLen) {
+		const size_t n = (size_t)PCF_MIN(s->left, (uint64_t)sizeof(s->inBuf));
+		if (n == 0 || fread(s->inBuf, 1, n, s->in) != n) {
+			s->error = true;
+			return 0;
+		}
+		s->left -= n;
+		s->inPos = 0;
+		s->inLen = n;
+	}
+	return s->inBuf[s->inPos++];
+}
+
+
+/**
+ * Returns the given number of input bits (least significant bit first).
+ *
+ * @param[in,out] s - inflate context
+ * @param[in] n - number of bits (0..16)
+ * @return bits
+ */
+static unsigned zipBits(tZipInflate * s, const unsigned n) {
+	while (s->bitCnt < n) {
+		s->bitBuf |= (uint32_t)zipInByte(s) << s->bitCnt;
+		s->bitCnt += 8;
+	}
+	const unsigned res = (unsigned)(s->bitBuf & ((UINT32_C(1) << n) - 1));
+	s->bitBuf >>= n;
+	s->bitCnt -= n;
+	return res;
+}
+
+
+/**
+ * Writes the pending window content to the output.
+ *
+ * @param[in,out] s - inflate context
+ */
+static void zipFlush(tZipInflate * s) {
+	if (s->winPos > 0) {
+		if (fwrite(s->win, 1, s->winPos, s->out) != s->winPos) {
+			s->error = true;
+		}
+		s->crc = crc32Update(s->crc, s->win, s->winPos);
+	}
+}
+
+
+/**
+ * Adds a single decompressed byte to the output window. Decompression fails
+ * once more than the expected number of bytes are produced.
+ *
+ * @param[in,out] s - inflate context
+ * @param[in] b - byte
+ */
+static void zipPut(tZipInflate * s, const uint8_t b) {
+	if (s->total >= s->limit) {
+		s->error = true;
+		return;
+	}
+	s->win[s->winPos++] = b;
+	++(s->total);
+	if (s->winPos == ZIP_WINDOW) {
+		zipFlush(s);
+		s->winPos = 0;
+	}
+}
+
+
+/**
+ * Builds a canonical Huffman decoding table from the given code lengths.
+ *
+ * @param[out] h - decoding table
+ * @param[in] length - code length per symbol
+ * @param[in] n - number of symbols
+ * @return `true` on success, else `false` if the code is over-subscribed
+ */
+static bool zipHuffman(tZipHuffman * h, const uint8_t * length, const size_t n) {
+	uint16_t offs[16];
+	memset(h->count, 0, sizeof(h->count));
+	for (size_t i = 0; i < n; ++i) {
+		++(h->count[length[i]]);
+	}
+	int left = 1;
+	for (size_t len = 1; len < 16; ++len) {
+		left <<= 1;
+		left -= h->count[len];
+		if (left < 0) {
+			return false;
+		}
+	}
+	offs[1] = 0;
+	for (size_t len = 1; len < 15; ++len) {
+		offs[len + 1] = (uint16_t)(offs[len] + h->count[len]);
+	}
+	for (size_t i = 0; i < n; ++i) {
+		if (length[i] != 0) {
+			h->symbol[offs[length[i]]++] = (uint16_t)i;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Decodes a single symbol with the given Huffman table.
+ *
+ * @param[in,out] s - inflate context
+ * @param[in] h - decoding table
+ * @return symbol or -1 on error
+ */
+static int zipDecode(tZipInflate * s, const tZipHuffman * h) {
+	int code = 0;
+	int first = 0;
+	int index = 0;
+	for (size_t len = 1; len < 16; ++len) {
+		code |= (int)zipBits(s, 1);
+		const int count = h->count[len];
+		if (code - count < first) {
+			return h->symbol[index + (code - first)];
+		}
+		index += count;
+		first += count;
+		first <<= 1;
+		code <<= 1;
+	}
+	s->error = true;
+	return -1;
+}
+
+
+/**
+ * Decodes the symbols of a compressed block until the end of block symbol.
+ *
+ * @param[in,out] s - inflate context
+ * @param[in] lencode - literal/length table
+ * @param[in] distcode - distance table
+ * @return `true` on success, else `false`
+ */
+static bool zipCodes(tZipInflate * s, const tZipHuffman * lencode, const tZipHuffman * distcode) {
+	static const uint16_t lenBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+	static const uint8_t lenExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+	static const uint16_t distBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+	static const uint8_t distExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+	for (;;) {
+		int sym = zipDecode(s, lencode);
+		if (sym < 0 || s->error) {
+			return false;
+		}
+		if (sym < 256) {
+			zipPut(s, (uint8_t)sym);
+			continue;
+		}
+		if (sym == 256) {
+			return true;
+		}
+		sym -= 257;
+		if (sym >= 29) {
+			return false;
+		}
+		const size_t len = lenBase[sym] + zipBits(s, lenExtra[sym]);
+		sym = zipDecode(s, distcode);
+		if (sym < 0 || sym >= 30) {
+			return false;
+		}
+		const size_t dist = distBase[sym] + zipBits(s, distExtra[sym]);
+		if (dist > s->total || s->error) {
+			return false;
+		}
+		for (size_t i = 0; i < len; ++i) {
+			zipPut(s, s->win[(s->winPos - dist) & (ZIP_WINDOW - 1)]);
+		}
+	}
+}
+
+
+/**
+ * Decompresses a raw deflate stream.
+ *
+ * @param[in,out] s - inflate context
+ * @return `true` on success, else `false`
+ */
+static bool zipInflate(tZipInflate * s) {
+	static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+	tZipHuffman lencode, distcode;
+	uint8_t lengths[320];
+	unsigned last;
+	do {
+		last = zipBits(s, 1);
+		const unsigned type = zipBits(s, 2);
+		if (type == 0) {
+			/* stored block */
+			s->bitBuf = 0;
+			s->bitCnt = 0;
+			const unsigned len = zipBits(s, 16);
+			const unsigned nlen = zipBits(s, 16);
+			if (len != (~nlen & 0xFFFF)) {
+				return false;
+			}
+			for (unsigned i = 0; i < len && ( ! s->error ); ++i) {
+				zipPut(s, zipInByte(s));
+			}
+		} else if (type == 1) {
+			/* fixed Huffman codes */
+			size_t i = 0;
+			for (; i < 144; ++i) lengths[i] = 8;
+			for (; i < 256; ++i) lengths[i] = 9;
+			for (; i < 280; ++i) lengths[i] = 7;
+			for (; i < 288; ++i) lengths[i] = 8;
+			zipHuffman(&lencode, lengths, 288);
+			for (i = 0; i < 30; ++i) lengths[i] = 5;
+			zipHuffman(&distcode, lengths, 30);
+			if ( ! zipCodes(s, &lencode, &distcode) ) {
+				return false;
+			}
+		} else if (type == 2) {
+			/* dynamic Huffman codes */
+			const size_t nlen = zipBits(s, 5) + 257;
+			const size_t ndist = zipBits(s, 5) + 1;
+			const size_t ncode = zipBits(s, 4) + 4;
+			if (nlen > 286 || ndist > 30) {
+				return false;
+			}
+			memset(lengths, 0, sizeof(lengths));
+			for (size_t i = 0; i < ncode; ++i) {
+				lengths[order[i]] = (uint8_t)zipBits(s, 3);
+			}
+			if ( ! zipHuffman(&lencode, lengths, 19) ) {
+				return false;
+			}
+			size_t i = 0;
+			while (i < nlen + ndist) {
+				int sym = zipDecode(s, &lencode);
+				if (sym < 0) {
+					return false;
+				}
+				if (sym < 16) {
+					lengths[i++] = (uint8_t)sym;
+					continue;
+				}
+				uint8_t len = 0;
+				size_t rep;
+				if (sym == 16) {
+					if (i == 0) {
+						return false;
+					}
+					len = lengths[i - 1];
+					rep = 3 + zipBits(s, 2);
+				} else if (sym == 17) {
+					rep = 3 + zipBits(s, 3);
+				} else {
+					rep = 11 + zipBits(s, 7);
+				}
+				if (i + rep > nlen + ndist) {
+					return false;
+				}
+				while (rep-- > 0) {
+					lengths[i++] = len;
+				}
+			}
+			if (lengths[256] == 0 || ( ! zipHuffman(&lencode, lengths, nlen) ) || ( ! zipHuffman(&distcode, lengths + nlen, ndist) )) {
+				return false;
+			}
+			if ( ! zipCodes(s, &lencode, &distcode) ) {
+				return false;
+			}
+		} else {
+			return false;
+		}
+		if ( s->error ) {
+			return false;
+		}
+	} while ( ! last );
+	zipFlush(s);
+	return ! s->error;
+}
+
+
+/**
+ * Extracts the given entry to the passed stream. The CRC-32 and size of the
+ * extracted data are verified. Decompression stops as soon as the entry
+ * exceeds its declared size.
+ *
+ * @param[in,out] z - archive
+ * @param[in] i - entry index
+ * @param[in,out] out - output stream
+ * @return `true` on success, else `false`
+ */
+bool zip_extract(tZip * z, const size_t i, FILE * out) {
+	if (z == NULL || i >= z->count || out == NULL) {
+		return false;
+	}
+	const tZipEntry * e = z->entries + i;
+	uint64_t dataOffset;
+	if (zip_isEncrypted(e) || ( ! zipDataOffset(z, e, &dataOffset) ) || ZIP_SEEK(z->fp, dataOffset) != 0) {
+		return false;
+	}
+	uint32_t crc = ZIP_MAX32;
+	uint64_t size;
+	if (e->method == ZIP_STORED) {
+		if ( ! zipCopy(z->fp, out, e->compSize, &crc) ) {
+			return false;
+		}
+		size = e->compSize;
+	} else if (e->method == ZIP_DEFLATED) {
+		tZipInflate * s = (tZipInflate *)calloc(1, sizeof(tZipInflate));
+		if (s == NULL) {
+			return false;
+		}
+		s->in = z->fp;
+		s->left = e->compSize;
+		s->out = out;
+		s->limit = e->size;
+		s->crc = ZIP_MAX32;
+		const bool ok = zipInflate(s);
+		crc = s->crc;
+		size = s->total;
+		free(s);
+		if ( ! ok ) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+	return (crc ^ ZIP_MAX32) == e->crc && size == e->size;
+}
+
+
+/**
+ * Writes the central directory record of the given entry with the passed
+ * values. ZIP64 extended information is added as needed.
+ *
+ * @param[in] z - archive
+ * @param[in] e - entry with the new values
+ * @param[in,out] out - output stream
+ * @return `true` on success, else `false`
+ */
+static bool zipWriteCentral(const tZip * z, const tZipEntry * e, FILE * out) {
+	const uint8_t * rec = z->cdir + e->cdirOffset;
+	const size_t nameLen = zipRd16(rec + 28);
+	const size_t extraLen = zipRd16(rec + 30);
+	const size_t commentLen = zipRd16(rec + 32);
+	const uint8_t * extra = rec + ZIP_CENTRAL_LEN + nameLen;
+	uint8_t hdr[ZIP_CENTRAL_LEN];
+	uint8_t zip64[28];
+	size_t zip64Len = 4;
+	memcpy(hdr, rec, ZIP_CENTRAL_LEN);
+	zipWr16(hdr + 8, e->flags);
+	zipWr16(hdr + 10, e->method);
+	zipWr32(hdr + 16, e->crc);
+	zipWr32(hdr + 20, (e->compSize >= ZIP_MAX32) ? ZIP_MAX32 : (uint32_t)(e->compSize));
+	zipWr32(hdr + 24, (e->size >= ZIP_MAX32) ? ZIP_MAX32 : (uint32_t)(e->size));
+	zipWr32(hdr + 42, (e->localOffset >= ZIP_MAX32) ? ZIP_MAX32 : (uint32_t)(e->localOffset));
+	if (e->size >= ZIP_MAX32) {
+		zipWr64(zip64 + zip64Len, e->size);
+		zip64Len += 8;
+	}
+	if (e->compSize >= ZIP_MAX32) {
+		zipWr64(zip64 + zip64Len, e->compSize);
+		zip64Len += 8;
+	}
+	if (e->localOffset >= ZIP_MAX32) {
+		zipWr64(zip64 + zip64Len, e->localOffset);
+		zip64Len += 8;
+	}
+	if (zip64Len == 4) {
+		zip64Len = 0;
+	} else {
+		zipWr16(zip64, ZIP_EXTRA_ZIP64);
+		zipWr16(zip64 + 2, (uint16_t)(zip64Len - 4));
+		/* the lower byte holds the version; the upper one the host system */
+		if (hdr[6] < ZIP_VERSION_ZIP64) {
+			hdr[6] = ZIP_VERSION_ZIP64;
+		}
+	}
+	/* the new extra field holds all but the old ZIP64 extended information */
+	size_t newExtraLen = zip64Len;
+	for (size_t pos = 0; pos + 4 <= extraLen; ) {
+		const size_t n = 4 + (size_t)zipRd16(extra + pos + 2);
+		if (zipRd16(extra + pos) != ZIP_EXTRA_ZIP64) {
+			newExtraLen += PCF_MIN(n, extraLen - pos);
+		}
+		pos += n;
+	}
+	if (newExtraLen > ZIP_MAX16) {
+		return false;
+	}
+	zipWr16(hdr + 30, (uint16_t)newExtraLen);
+	if (fwrite(hdr, 1, sizeof(hdr), out) != sizeof(hdr) || fwrite(rec + ZIP_CENTRAL_LEN, 1, nameLen, out) != nameLen) {
+		return false;
+	}
+	if (zip64Len > 0 && fwrite(zip64, 1, zip64Len, out) != zip64Len) {
+		return false;
+	}
+	for (size_t pos = 0; pos + 4 <= extraLen; ) {
+		const size_t n = PCF_MIN(4 + (size_t)zipRd16(extra + pos + 2), extraLen - pos);
+		if (zipRd16(extra + pos) != ZIP_EXTRA_ZIP64 && fwrite(extra + pos, 1, n, out) != n) {
+			return false;
+		}
+		pos += n;
+	}
+	return fwrite(extra + extraLen, 1, commentLen, out) == commentLen;
+}
+
+
+/**
+ * Copies the local file header, data and data descriptor of the given entry
+ * verbatim. Only the version needed to extract is raised if the entry needs
+ * ZIP64 extended information at its new position.
+ *
+ * @param[in,out] z - archive
+ * @param[in] e - entry
+ * @param[in,out] out - output stream
+ * @return `true` on success, else `false`
+ */
+static bool zipCopyEntry(tZip * z, const tZipEntry * e, FILE * out) {
+	uint64_t dataOffset;
+	uint8_t version[2];
+	if ( ! zipDataOffset(z, e, &dataOffset) ) {
+		return false;
+	}
+	uint64_t len = dataOffset - e->localOffset + e->compSize;
+	if ((e->flags & ZIP_FLAG_DESCRIPTOR) != 0) {
+		uint8_t sig[4];
+		if ( ! zipReadAt(z->fp, dataOffset + e->compSize, sig, sizeof(sig)) ) {
+			return false;
+		}
+		len += (uint64_t)(((zipRd32(sig) == ZIP_SIG_DESCRIPTOR) ? 4 : 0) + 4 + (e->zip64 ? 16 : 8));
+	}
+	const int64_t start = ZIP_TELL(out);
+	if (start < 0 || ( ! zipReadAt(z->fp, e->localOffset + 4, version, sizeof(version)) )) {
+		return false;
+	}
+	if ( ! (ZIP_SEEK(z->fp, e->localOffset) == 0 && zipCopy(z->fp, out, len, NULL)) ) {
+		return false;
+	}
+	const bool zip64 = (uint64_t)start >= ZIP_MAX32 || e->size >= ZIP_MAX32 || e->compSize >= ZIP_MAX32;
+	if (( ! zip64 ) || version[0] >= ZIP_VERSION_ZIP64) {
+		return true;
+	}
+	const int64_t endPos = ZIP_TELL(out);
+	version[0] = ZIP_VERSION_ZIP64;
+	return endPos >= 0
+		&& ZIP_SEEK(out, (uint64_t)start + 4) == 0
+		&& fwrite(version, 1, 1, out) == 1
+		&& ZIP_SEEK(out, endPos) == 0;
+}
+
+
+/**
+ * Writes the given replacement data as uncompressed entry.
+ *
+ * @param[in] z - archive
+ * @param[in,out] e - entry which receives the new values
+ * @param[in,out] in - replacement data
+ * @param[in,out] out - output stream
+ * @return `true` on success, else `false`
+ */
+static bool zipStoreEntry(const tZip * z, tZipEntry * e, FILE * in, FILE * out) {
+	const uint8_t * rec = z->cdir + e->cdirOffset;
+	const size_t nameLen = zipRd16(rec + 28);
+	uint8_t hdr[ZIP_LOCAL_LEN];
+	e->flags = (uint16_t)(e->flags & ~(ZIP_FLAG_DESCRIPTOR | ZIP_FLAG_ENCRYPTED));
+	e->method = ZIP_STORED;
+	zipWr32(hdr, ZIP_SIG_LOCAL);
+	memcpy(hdr + 4, rec + 6, 2); /* version needed to extract */
+	if (e->localOffset >= ZIP_MAX32 && hdr[4] < ZIP_VERSION_ZIP64) {
+		hdr[4] = ZIP_VERSION_ZIP64; /* the central directory record refers to it via ZIP64 */
+	}
+	zipWr16(hdr + 6, e->flags);
+	zipWr16(hdr + 8, e->method);
+	memcpy(hdr + 10, rec + 12, 4); /* modification time and date */
+	zipWr32(hdr + 14, 0);
+	zipWr32(hdr + 18, 0);
+	zipWr32(hdr + 22, 0);
+	zipWr16(hdr + 26, (uint16_t)nameLen);
+	zipWr16(hdr + 28, 0);
+	if (fwrite(hdr, 1, sizeof(hdr), out) != sizeof(hdr) || fwrite(rec + ZIP_CENTRAL_LEN, 1, nameLen, out) != nameLen) {
+		return false;
+	}
+	/* copy data and patch CRC-32 and sizes afterwards */
+	if (ZIP_SEEK_END(in) != 0) {
+		return false;
+	}
+	const int64_t size = ZIP_TELL(in);
+	if (size < 0 || (uint64_t)size >= ZIP_MAX32 || ZIP_SEEK(in, 0) != 0) {
+		return false;
+	}
+	uint32_t crc = ZIP_MAX32;
+	if ( ! zipCopy(in, out, (uint64_t)size, &crc) ) {
+		return false;
+	}
+	const int64_t endPos = ZIP_TELL(out);
+	e->crc = crc ^ ZIP_MAX32;
+	e->compSize = (uint64_t)size;
+	e->size = (uint64_t)size;
+	e->zip64 = false;
+	zipWr32(hdr + 14, e->crc);
+	zipWr32(hdr + 18, (uint32_t)size);
+	zipWr32(hdr + 22, (uint32_t)size);
+	return endPos >= 0
+		&& ZIP_SEEK(out, e->localOffset + 14) == 0
+		&& fwrite(hdr + 14, 1, 12, out) == 12
+		&& ZIP_SEEK(out, endPos) == 0;
+}
+
+
+/**
+ * Writes a new archive with the entries of the given one. The compressed data
+ * of all entries is copied verbatim unless the callback returns replacement
+ * data for it.
+ *
+ * @param[in,out] z - archive
+ * @param[in,out] out - seekable binary output stream
+ * @param[in] cb - replacement callback or `NULL` to copy all entries
+ * @param[in] param - user defined callback parameter
+ * @return `true` on success, else `false`
+ */
+bool zip_rewrite(tZip * z, FILE * out, ZipReplaceCallback cb, void * param) {
+	if (z == NULL || out == NULL) {
+		return false;
+	}
+	tZipEntry * newEntries = (tZipEntry *)malloc((z->count + 1) * sizeof(tZipEntry));
+	if (newEntries == NULL) {
+		return false;
+	}
+	bool res = false;
+	for (size_t i = 0; i < z->count; ++i) {
+		tZipEntry * e = newEntries + i;
+		*e = z->entries[i];
+		const int64_t pos = ZIP_TELL(out);
+		if (pos < 0) {
+			goto onError;
+		}
+		e->localOffset = (uint64_t)pos;
+		FILE * rep = (cb != NULL) ? cb(z->entries + i, i, param) : NULL;
+		if (rep != NULL) {
+			if ( ! zipStoreEntry(z, e, rep, out) ) {
+				goto onError;
+			}
+		} else if ( ! zipCopyEntry(z, z->entries + i, out) ) {
+			goto onError;
+		}
+	}
+	/* central directory */
+	const int64_t cdirStart = ZIP_TELL(out);
+	if (cdirStart < 0) {
+		goto onError;
+	}
+	for (size_t i = 0; i < z->count; ++i) {
+		if ( ! zipWriteCentral(z, newEntries + i, out) ) {
+			goto onError;
+		}
+	}
+	const int64_t cdirEnd = ZIP_TELL(out);
+	if (cdirEnd < cdirStart) {
+		goto onError;
+	}
+	const uint64_t cdirLen = (uint64_t)(cdirEnd - cdirStart);
+	uint8_t rec[ZIP_END64_LEN];
+	if (z->count >= ZIP_MAX16 || (uint64_t)cdirStart >= ZIP_MAX32 || cdirLen >= ZIP_MAX32) {
+		/* ZIP64 end of central directory record and locator */
+		zipWr32(rec, ZIP_SIG_END64);
+		zipWr64(rec + 4, ZIP_END64_LEN - 12);
+		zipWr16(rec + 12, ZIP_VERSION_ZIP64);
+		zipWr16(rec + 14, ZIP_VERSION_ZIP64);
+		zipWr32(rec + 16, 0);
+		zipWr32(rec + 20, 0);
+		zipWr64(rec + 24, (uint64_t)z->count);
+		zipWr64(rec + 32, (uint64_t)z->count);
+		zipWr64(rec + 40, cdirLen);
+		zipWr64(rec + 48, (uint64_t)cdirStart);
+		if (fwrite(rec, 1, ZIP_END64_LEN, out) != ZIP_END64_LEN) {
+			goto onError;
+		}
+		zipWr32(rec, ZIP_SIG_LOCATOR64);
+		zipWr32(rec + 4, 0);
+		zipWr64(rec + 8, (uint64_t)cdirEnd);
+		zipWr32(rec + 16, 1);
+		if (fwrite(rec, 1, ZIP_LOCATOR64_LEN, out) != ZIP_LOCATOR64_LEN) {
+			goto onError;
+		}
+	}
+	zipWr32(rec, ZIP_SIG_END);
+	zipWr16(rec + 4, 0);
+	zipWr16(rec + 6, 0);
+	zipWr16(rec + 8, (z->count >= ZIP_MAX16) ? ZIP_MAX16 : (uint16_t)(z->count));
+	zipWr16(rec + 10, (z->count >= ZIP_MAX16) ? ZIP_MAX16 : (uint16_t)(z->count));
+	zipWr32(rec + 12, (cdirLen >= ZIP_MAX32) ? ZIP_MAX32 : (uint32_t)cdirLen);
+	zipWr32(rec + 16, ((uint64_t)cdirStart >= ZIP_MAX32) ? ZIP_MAX32 : (uint32_t)cdirStart);
+	zipWr16(rec + 20, (uint16_t)(z->commentLen));
+	if (fwrite(rec, 1, ZIP_END_LEN, out) != ZIP_END_LEN || (z->commentLen > 0 && fwrite(z->comment, 1, z->commentLen, out) != z->commentLen)) {
+		goto onError;
+	}
+	res = fflush(out) == 0;
+onError:
+	free(newEntries);
+	return res;
+}
+
+
+/**
+ * Frees the given archive handle. The archive stream is not closed.
+ *
+ * @param[in,out] z - archive
+ */
+void zip_close(tZip * z) {
+	if (z == NULL) {
+		return;
+	}
+	if (z->entries != NULL) {
+		for (size_t i = 0; i < z->count; ++i) {
+			free(z->entries[i].name);
+		}
+		free(z->entries);
+	}
+	free(z->cdir);
+	free(z->comment);
+	free(z);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file zip.h
+ * @author Daniel Starke
+ * @see zip.c
+ * @date 2026-10-18
+ * @version 2026-10-18
+ */
+#ifndef __ZIP_H__
+#define __ZIP_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Compression method of uncompressed entries.
+ */
+#define ZIP_STORED 0
+
+
+/**
+ * Compression method of deflate compressed entries.
+ */
+#define ZIP_DEFLATED 8
+
+
+/**
+ * Single archive entry as given in the central directory.
+ */
+typedef struct {
+	char * name; /**< null-terminated entry name as stored in the archive */
+	uint16_t flags; /**< general purpose bit flags */
+	uint16_t method; /**< compression method */
+	uint32_t crc; /**< CRC-32 of the uncompressed data */
+	uint64_t compSize; /**< compressed size in bytes */
+	uint64_t size; /**< uncompressed size in bytes */
+	uint64_t localOffset; /**< local file header offset */
+	bool zip64; /**< sizes are given in the ZIP64 extended information extra field */
+	size_t cdirOffset; /**< central directory record offset within `tZip::cdir` */
+	size_t cdirLen; /**< central directory record length in bytes */
+} tZipEntry;
+
+
+/**
+ * Opened archive. Only the central directory is kept in memory.
+ */
+typedef struct {
+	FILE * fp; /**< archive stream (not owned) */
+	uint8_t * cdir; /**< raw central directory */
+	size_t cdirLen; /**< length of `cdir` in bytes */
+	tZipEntry * entries; /**< entries in central directory order */
+	size_t count; /**< number of entries */
+	uint8_t * comment; /**< archive comment or `NULL` */
+	size_t commentLen; /**< length of `comment` in bytes */
+} tZip;
+
+
+/**
+ * Callback function to pass the replacement data of an entry to `zip_rewrite()`.
+ *
+ * @param[in] entry - archive entry
+ * @param[in] i - entry index
+ * @param[in] param - user defined callback parameter
+ * @return stream with the replacement data or `NULL` to copy the entry verbatim
+ */
+typedef FILE * (* ZipReplaceCallback)(const tZipEntry * entry, const size_t i, void * param);
+
+
+tZip * zip_open(FILE * fp);
+bool zip_isEncrypted(const tZipEntry * entry);
+bool zip_extract(tZip * z, const size_t i, FILE * out);
+bool zip_rewrite(tZip * z, FILE * out, ZipReplaceCallback cb, void * param);
+void zip_close(tZip * z);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* __ZIP_H__ */